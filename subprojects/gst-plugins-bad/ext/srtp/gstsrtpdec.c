@@ -211,6 +211,10 @@ static GstFlowReturn gst_srtp_dec_chain_rtp (GstPad * pad,
     GstObject * parent, GstBuffer * buf);
 static GstFlowReturn gst_srtp_dec_chain_rtcp (GstPad * pad,
     GstObject * parent, GstBuffer * buf);
+static GstFlowReturn gst_srtp_dec_chain_list_rtp (GstPad * pad,
+    GstObject * parent, GstBufferList * buf_list);
+static GstFlowReturn gst_srtp_dec_chain_list_rtcp (GstPad * pad,
+    GstObject * parent, GstBufferList * buf_list);
 
 static GstStateChangeReturn gst_srtp_dec_change_state (GstElement * element,
     GstStateChange transition);
@@ -385,6 +389,8 @@ gst_srtp_dec_init (GstSrtpDec * filter)
       GST_DEBUG_FUNCPTR (gst_srtp_dec_iterate_internal_links_rtp));
   gst_pad_set_chain_function (filter->rtp_sinkpad,
       GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_rtp));
+  gst_pad_set_chain_list_function (filter->rtp_sinkpad,
+      GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_list_rtp));
 
   filter->rtp_srcpad =
       gst_pad_new_from_static_template (&rtp_src_template, "rtp_src");
@@ -408,6 +414,8 @@ gst_srtp_dec_init (GstSrtpDec * filter)
       GST_DEBUG_FUNCPTR (gst_srtp_dec_iterate_internal_links_rtcp));
   gst_pad_set_chain_function (filter->rtcp_sinkpad,
       GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_rtcp));
+  gst_pad_set_chain_list_function (filter->rtcp_sinkpad,
+      GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_list_rtcp));
 
   filter->rtcp_srcpad =
       gst_pad_new_from_static_template (&rtcp_src_template, "rtcp_src");
@@ -1329,20 +1337,21 @@ gst_srtp_dec_push_early_events (GstSrtpDec * filter, GstPad * pad,
  * This function should be called while holding the filter lock
  */
 static gboolean
-gst_srtp_dec_decode_buffer (GstSrtpDec * filter, GstPad * pad, GstBuffer * buf,
-    gboolean is_rtcp, guint32 ssrc)
+gst_srtp_dec_decode_buffer (GstSrtpDec * filter, GstPad * pad,
+    GstBuffer ** buf_ptr, gboolean is_rtcp, guint32 ssrc,
+    GstSrtpDecSsrcStream * stream)
 {
+  GstBuffer *buf;
   GstMapInfo map;
   srtp_err_status_t err;
   gint size;
-  GstSrtpDecSsrcStream *stream;
 
   GST_LOG_OBJECT (pad, "Received %s buffer of size %" G_GSIZE_FORMAT
-      " with SSRC = %u", is_rtcp ? "RTCP" : "RTP", gst_buffer_get_size (buf),
-      ssrc);
+      " with SSRC = %u", is_rtcp ? "RTCP" : "RTP",
+      gst_buffer_get_size (*buf_ptr), ssrc);
   filter->recv_count++;
   /* Change buffer to remove protection */
-  buf = gst_buffer_make_writable (buf);
+  buf = *buf_ptr = gst_buffer_make_writable (*buf_ptr);
 
   gst_buffer_map (buf, &map, GST_MAP_READWRITE);
   size = map.size;
@@ -1353,10 +1362,8 @@ unprotect:
 
   if (is_rtcp) {
 #ifdef HAVE_SRTP2
-    stream = find_stream_by_ssrc (filter, ssrc);
-
     err = srtp_unprotect_rtcp_mki (filter->session, map.data, &size,
-        stream && stream->keys);
+        stream->keys != NULL);
 #else
     err = srtp_unprotect_rtcp (filter->session, map.data, &size);
 #endif
@@ -1366,23 +1373,15 @@ unprotect:
      * sequence number too. */
     if (g_hash_table_contains (filter->streams_roc_changed,
             GUINT_TO_POINTER (ssrc))) {
-      srtp_stream_t stream;
-
-      stream = srtp_get_stream (filter->session, htonl (ssrc));
-
-      if (stream) {
-        guint16 seqnum = 0;
-        GstRTPBuffer rtpbuf = GST_RTP_BUFFER_INIT;
+      srtp_stream_t srtp_stream;
 
-        gst_rtp_buffer_map (buf,
-            GST_MAP_READ | GST_RTP_BUFFER_MAP_FLAG_SKIP_PADDING, &rtpbuf);
-        seqnum = gst_rtp_buffer_get_seq (&rtpbuf);
-        gst_rtp_buffer_unmap (&rtpbuf);
+      srtp_stream = srtp_get_stream (filter->session, htonl (ssrc));
 
+      if (srtp_stream) {
         /* We finally add the RTP sequence number to the current
          * rollover counter. */
-        stream->rtp_rdbx.index &= ~0xFFFF;
-        stream->rtp_rdbx.index |= seqnum;
+        srtp_stream->rtp_rdbx.index &= ~0xFFFF;
+        srtp_stream->rtp_rdbx.index |= GST_READ_UINT16_BE (map.data + 2);
       }
 
       g_hash_table_remove (filter->streams_roc_changed,
@@ -1391,21 +1390,12 @@ unprotect:
 #endif
 
 #ifdef HAVE_SRTP2
-    {
-      stream = find_stream_by_ssrc (filter, ssrc);
-
-      err = srtp_unprotect_mki (filter->session, map.data, &size,
-          stream && stream->keys);
-    }
+    err = srtp_unprotect_mki (filter->session, map.data, &size,
+        stream->keys != NULL);
 #else
     err = srtp_unprotect (filter->session, map.data, &size);
 #endif
   }
-  stream = find_stream_by_ssrc (filter, ssrc);
-  if (stream == NULL) {
-    GST_WARNING_OBJECT (filter, "Could not find matching stream, dropping");
-    goto err;
-  }
   stream->recv_count++;
   /* Signal user depending on type of error */
   switch (err) {
@@ -1460,14 +1450,30 @@ err:
   return FALSE;
 }
 
+/* Returns the source pad for RTP or RTCP packets, after making sure it got
+ * its sticky events */
+static GstPad *
+gst_srtp_dec_get_srcpad (GstSrtpDec * filter, gboolean is_rtcp)
+{
+  if (is_rtcp) {
+    if (!filter->rtcp_has_segment)
+      gst_srtp_dec_push_early_events (filter, filter->rtcp_srcpad,
+          filter->rtp_srcpad, TRUE);
+    return filter->rtcp_srcpad;
+  } else {
+    if (!filter->rtp_has_segment)
+      gst_srtp_dec_push_early_events (filter, filter->rtp_srcpad,
+          filter->rtcp_srcpad, FALSE);
+    return filter->rtp_srcpad;
+  }
+}
+
 static GstFlowReturn
 gst_srtp_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
     gboolean is_rtcp)
 {
   GstSrtpDec *filter = GST_SRTP_DEC (parent);
-  GstPad *otherpad;
   GstSrtpDecSsrcStream *stream = NULL;
-  GstFlowReturn ret = GST_FLOW_OK;
   guint32 ssrc = 0;
 
   GST_OBJECT_LOCK (filter);
@@ -1485,7 +1491,7 @@ gst_srtp_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
     goto push_out;
   }
 
-  if (!gst_srtp_dec_decode_buffer (filter, pad, buf, is_rtcp, ssrc)) {
+  if (!gst_srtp_dec_decode_buffer (filter, pad, &buf, is_rtcp, ssrc, stream)) {
     GST_OBJECT_UNLOCK (filter);
     goto drop_buffer;
   }
@@ -1498,27 +1504,105 @@ gst_srtp_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
 
 push_out:
   /* Push buffer to source pad */
-  if (is_rtcp) {
-    otherpad = filter->rtcp_srcpad;
-    if (!filter->rtcp_has_segment)
-      gst_srtp_dec_push_early_events (filter, filter->rtcp_srcpad,
-          filter->rtp_srcpad, TRUE);
-  } else {
-    otherpad = filter->rtp_srcpad;
-    if (!filter->rtp_has_segment)
-      gst_srtp_dec_push_early_events (filter, filter->rtp_srcpad,
-          filter->rtcp_srcpad, FALSE);
+  return gst_pad_push (gst_srtp_dec_get_srcpad (filter, is_rtcp), buf);
+
+drop_buffer:
+  gst_buffer_unref (buf);
+
+  return GST_FLOW_OK;
+}
+
+typedef struct
+{
+  GstSrtpDec *filter;
+  GstPad *pad;
+  gboolean is_rtcp;
+  /* packets of the other kind, muxed on this pad */
+  GstBufferList *other_list;
+  /* SSRCs of the streams that reached their soft limit */
+  GArray *soft_limit_ssrcs;
+} DecodeBufferItData;
+
+static gboolean
+decode_buffer_it (GstBuffer ** buffer, guint index, gpointer user_data)
+{
+  DecodeBufferItData *data = user_data;
+  GstSrtpDec *filter = data->filter;
+  GstSrtpDecSsrcStream *stream;
+  gboolean is_rtcp = data->is_rtcp;
+  guint32 ssrc = 0;
+
+  if (!(stream = validate_buffer (filter, *buffer, &ssrc, &is_rtcp))) {
+    GST_WARNING_OBJECT (filter, "Invalid buffer, dropping");
+    goto drop_buffer;
   }
-  ret = gst_pad_push (otherpad, buf);
 
-  return ret;
+  if (STREAM_HAS_CRYPTO (stream)) {
+    if (!gst_srtp_dec_decode_buffer (filter, data->pad, buffer, is_rtcp, ssrc,
+            stream))
+      goto drop_buffer;
+
+    if (gst_srtp_get_soft_limit_reached ()) {
+      if (!data->soft_limit_ssrcs)
+        data->soft_limit_ssrcs = g_array_new (FALSE, FALSE, sizeof (guint32));
+      g_array_append_val (data->soft_limit_ssrcs, ssrc);
+    }
+  }
+
+  if (is_rtcp != data->is_rtcp) {
+    if (!data->other_list)
+      data->other_list = gst_buffer_list_new ();
+    gst_buffer_list_add (data->other_list, *buffer);
+    *buffer = NULL;
+  }
+
+  return TRUE;
 
 drop_buffer:
-  /* Drop buffer, except if gst_pad_push returned OK or an error */
+  gst_buffer_unref (*buffer);
+  *buffer = NULL;
 
-  gst_buffer_unref (buf);
+  return TRUE;
+}
 
-  return ret;
+static GstFlowReturn
+gst_srtp_dec_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * buf_list, gboolean is_rtcp)
+{
+  GstSrtpDec *filter = GST_SRTP_DEC (parent);
+  DecodeBufferItData data = { filter, pad, is_rtcp, NULL, NULL };
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint i;
+
+  GST_LOG_OBJECT (pad, "Buffer chain with list of %d",
+      gst_buffer_list_length (buf_list));
+
+  /* Unprotect the packets in the list itself, dropping the ones that fail */
+  buf_list = gst_buffer_list_make_writable (buf_list);
+
+  GST_OBJECT_LOCK (filter);
+  gst_buffer_list_foreach (buf_list, decode_buffer_it, &data);
+  GST_OBJECT_UNLOCK (filter);
+
+  if (data.soft_limit_ssrcs) {
+    for (i = 0; i < data.soft_limit_ssrcs->len; i++)
+      request_key_with_signal (filter,
+          g_array_index (data.soft_limit_ssrcs, guint32, i), SIGNAL_SOFT_LIMIT);
+    g_array_free (data.soft_limit_ssrcs, TRUE);
+  }
+
+  if (data.other_list)
+    ret = gst_pad_push_list (gst_srtp_dec_get_srcpad (filter, !is_rtcp),
+        data.other_list);
+
+  if (gst_buffer_list_length (buf_list) == 0) {
+    gst_buffer_list_unref (buf_list);
+    return ret;
+  }
+
+  /* Push buffer to source pad */
+  return gst_pad_push_list (gst_srtp_dec_get_srcpad (filter, is_rtcp),
+      buf_list);
 }
 
 static GstFlowReturn
@@ -1533,6 +1617,20 @@ gst_srtp_dec_chain_rtcp (GstPad * pad, GstObject * parent, GstBuffer * buf)
   return gst_srtp_dec_chain (pad, parent, buf, TRUE);
 }
 
+static GstFlowReturn
+gst_srtp_dec_chain_list_rtp (GstPad * pad, GstObject * parent,
+    GstBufferList * buf_list)
+{
+  return gst_srtp_dec_chain_list (pad, parent, buf_list, FALSE);
+}
+
+static GstFlowReturn
+gst_srtp_dec_chain_list_rtcp (GstPad * pad, GstObject * parent,
+    GstBufferList * buf_list)
+{
+  return gst_srtp_dec_chain_list (pad, parent, buf_list, TRUE);
+}
+
 static GstStateChangeReturn
 gst_srtp_dec_change_state (GstElement * element, GstStateChange transition)
 {
@@ -133,6 +133,9 @@ GST_DEBUG_CATEGORY_STATIC (gst_srtp_enc_debug);
 #define DEFAULT_REPLAY_WINDOW_SIZE 128
 #define DEFAULT_ALLOW_REPEAT_TX FALSE
 
+/* Room for the authentication tag and MKI after a protected packet */
+#define SRTP_TRAILER_ROOM (SRTP_MAX_TRAILER_LEN + 10)
+
 #define HAS_CRYPTO(filter) (filter->rtp_cipher != GST_SRTP_CIPHER_NULL || \
       filter->rtcp_cipher != GST_SRTP_CIPHER_NULL ||                      \
       filter->rtp_auth != GST_SRTP_AUTH_NULL ||                           \
@@ -161,14 +164,13 @@ enum
   PROP_MKI
 };
 
-typedef struct ProcessBufferItData
+typedef struct ProtectBufferItData
 {
   GstSrtpEnc *filter;
   GstPad *pad;
-  GstBufferList *out_list;
-  GstFlowReturn flowret;
+  srtp_err_status_t err;
   gboolean is_rtcp;
-} ProcessBufferItData;
+} ProtectBufferItData;
 
 /* the capabilities of the inputs and outputs.
  *
@@ -500,6 +502,7 @@ gst_srtp_enc_reset_no_lock (GstSrtpEnc * filter)
     }
 
     g_hash_table_remove_all (filter->ssrcs_set);
+    filter->last_ssrc_valid = FALSE;
   }
 
   filter->first_session = TRUE;
@@ -1123,37 +1126,77 @@ gst_srtp_enc_ensure_ssrc (GstSrtpEnc * filter, GstBuffer * buf)
   }
 }
 
-static GstFlowReturn
-gst_srtp_enc_process_buffer (GstSrtpEnc * filter, GstPad * pad,
+/* Same as gst_srtp_enc_ensure_ssrc() but reads the SSRC from packet data that
+ * is already mapped, and skips the hash table when it did not change */
+static void
+gst_srtp_enc_ensure_ssrc_from_data (GstSrtpEnc * filter, const guint8 * data,
+    gsize size)
+{
+  guint32 ssrc;
+
+  if (size < 12 || (data[0] >> 6) != 2)
+    return;
+
+  ssrc = GST_READ_UINT32_BE (data + 8);
+  if (filter->last_ssrc_valid && filter->last_ssrc == ssrc)
+    return;
+
+  gst_srtp_enc_add_ssrc (filter, ssrc);
+  filter->last_ssrc = ssrc;
+  filter->last_ssrc_valid = TRUE;
+}
+
+/* The buffer can be protected in place if we own it and its single memory
+ * has room for the SRTP trailer after the packet */
+static gboolean
+gst_srtp_enc_can_protect_in_place (GstBuffer * buf)
+{
+  gsize size, offset, maxsize;
+
+  if (!gst_buffer_is_writable (buf) || gst_buffer_n_memory (buf) != 1)
+    return FALSE;
+
+  if (!gst_memory_is_writable (gst_buffer_peek_memory (buf, 0)))
+    return FALSE;
+
+  size = gst_buffer_get_sizes (buf, &offset, &maxsize);
+
+  return maxsize - offset - size >= SRTP_TRAILER_ROOM;
+}
+
+/* Takes ownership of @buf and returns the protected buffer in @outbuf_ptr,
+ * which is @buf itself when it could be protected in place. On error,
+ * @outbuf_ptr is set to %NULL and the caller should report the error once
+ * the lock is released.
+ *
+ * Should be called with the filter locked and a session */
+static srtp_err_status_t
+gst_srtp_enc_protect_buffer_no_lock (GstSrtpEnc * filter, GstPad * pad,
     GstBuffer * buf, gboolean is_rtcp, GstBuffer ** outbuf_ptr)
 {
-  GstFlowReturn ret = GST_FLOW_OK;
-  gint size_max, size;
-  GstBuffer *bufout = NULL;
+  gint size;
+  GstBuffer *bufout;
   GstMapInfo mapout;
   srtp_err_status_t err;
 
-  /* Create a bigger buffer to add protection */
   size = gst_buffer_get_size (buf);
-  size_max = size + SRTP_MAX_TRAILER_LEN + 10;
-  bufout = gst_buffer_new_allocate (NULL, size_max, NULL);
-
-  gst_buffer_map (bufout, &mapout, GST_MAP_READWRITE);
 
-  gst_buffer_extract (buf, 0, mapout.data, size);
-
-  GST_OBJECT_LOCK (filter);
-
-  gst_srtp_init_event_reporter ();
+  if (is_rtcp)
+    gst_srtp_enc_ensure_ssrc (filter, buf);
 
-  if (filter->session == NULL) {
-    /* The rtcp session disappeared (element shutting down) */
-    GST_OBJECT_UNLOCK (filter);
-    ret = GST_FLOW_FLUSHING;
-    goto fail;
+  if (gst_srtp_enc_can_protect_in_place (buf)) {
+    bufout = buf;
+    gst_buffer_set_size (bufout, size + SRTP_TRAILER_ROOM);
+    gst_buffer_map (bufout, &mapout, GST_MAP_READWRITE);
+  } else {
+    /* Create a bigger buffer to add protection */
+    bufout = gst_buffer_new_allocate (NULL, size + SRTP_TRAILER_ROOM, NULL);
+    gst_buffer_map (bufout, &mapout, GST_MAP_READWRITE);
+    gst_buffer_extract (buf, 0, mapout.data, size);
   }
 
-  gst_srtp_enc_ensure_ssrc (filter, buf);
+  if (!is_rtcp)
+    gst_srtp_enc_ensure_ssrc_from_data (filter, mapout.data, size);
 
 #ifdef HAVE_SRTP2
   if (is_rtcp)
@@ -1169,40 +1212,60 @@ gst_srtp_enc_process_buffer (GstSrtpEnc * filter, GstPad * pad,
     err = srtp_protect (filter->session, mapout.data, &size);
 #endif
 
-  GST_OBJECT_UNLOCK (filter);
-
   gst_buffer_unmap (bufout, &mapout);
 
-  if (err == srtp_err_status_ok) {
-    /* Buffer protected */
-    gst_buffer_set_size (bufout, size);
+  if (err != srtp_err_status_ok) {
+    if (bufout != buf)
+      gst_buffer_unref (bufout);
+    gst_buffer_unref (buf);
+    *outbuf_ptr = NULL;
+    return err;
+  }
+
+  /* Buffer protected */
+  gst_buffer_set_size (bufout, size);
+  if (bufout != buf) {
     gst_buffer_copy_into (bufout, buf, GST_BUFFER_COPY_METADATA, 0, -1);
+    gst_buffer_unref (buf);
+  }
 
-    GST_LOG_OBJECT (pad, "Encoding %s buffer of size %d",
-        is_rtcp ? "RTCP" : "RTP", size);
+  GST_LOG_OBJECT (pad, "Encoding %s buffer of size %d%s",
+      is_rtcp ? "RTCP" : "RTP", size, bufout == buf ? " in place" : "");
 
-  } else if (err == srtp_err_status_key_expired) {
+  *outbuf_ptr = bufout;
+  return err;
+}
 
+static GstFlowReturn
+gst_srtp_enc_protect_error (GstSrtpEnc * filter, srtp_err_status_t err)
+{
+  if (err == srtp_err_status_key_expired) {
     GST_ELEMENT_ERROR (GST_ELEMENT_CAST (filter), STREAM, ENCODE,
         ("Key usage limit has been reached"),
         ("Unable to protect buffer (hard key usage limit reached)"));
-    ret = GST_FLOW_ERROR;
-    goto fail;
-
   } else {
     /* srtp_protect failed */
     GST_ELEMENT_ERROR (filter, LIBRARY, FAILED, (NULL),
         ("Unable to protect buffer (protect failed) code %d", err));
-    ret = GST_FLOW_ERROR;
-    goto fail;
   }
 
-  *outbuf_ptr = bufout;
-  return ret;
+  return GST_FLOW_ERROR;
+}
 
-fail:
-  gst_buffer_unref (bufout);
-  return ret;
+static void
+gst_srtp_enc_check_soft_limit (GstSrtpEnc * filter)
+{
+  GST_OBJECT_LOCK (filter);
+
+  if (gst_srtp_get_soft_limit_reached ()) {
+    GST_OBJECT_UNLOCK (filter);
+    g_signal_emit (filter, gst_srtp_enc_signals[SIGNAL_SOFT_LIMIT], 0);
+    GST_OBJECT_LOCK (filter);
+    if (filter->random_key && !filter->key_changed)
+      gst_srtp_enc_replace_random_key (filter);
+  }
+
+  GST_OBJECT_UNLOCK (filter);
 }
 
 static GstFlowReturn
@@ -1213,67 +1276,58 @@ gst_srtp_enc_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
   GstFlowReturn ret = GST_FLOW_OK;
   GstPad *otherpad;
   GstBuffer *bufout = NULL;
+  srtp_err_status_t err;
 
   if ((ret = gst_srtp_enc_check_set_caps (filter, pad, is_rtcp)) != GST_FLOW_OK) {
-    goto out;
+    gst_buffer_unref (buf);
+    return ret;
   }
 
+  otherpad = get_rtp_other_pad (pad);
+
   GST_OBJECT_LOCK (filter);
 
   if (!HAS_CRYPTO (filter)) {
     GST_OBJECT_UNLOCK (filter);
-    otherpad = get_rtp_other_pad (pad);
     return gst_pad_push (otherpad, buf);
   }
 
-  GST_OBJECT_UNLOCK (filter);
+  if (filter->session == NULL) {
+    /* The rtcp session disappeared (element shutting down) */
+    GST_OBJECT_UNLOCK (filter);
+    gst_buffer_unref (buf);
+    return GST_FLOW_FLUSHING;
+  }
 
-  ret = gst_srtp_enc_process_buffer (filter, pad, buf, is_rtcp, &bufout);
-  if (ret != GST_FLOW_OK)
-    goto out;
+  gst_srtp_init_event_reporter ();
 
-  /* Push buffer to source pad */
-  otherpad = get_rtp_other_pad (pad);
-  ret = gst_pad_push (otherpad, bufout);
-  bufout = NULL;
+  err = gst_srtp_enc_protect_buffer_no_lock (filter, pad, buf, is_rtcp,
+      &bufout);
 
-  if (ret != GST_FLOW_OK)
-    goto out;
+  GST_OBJECT_UNLOCK (filter);
 
-  GST_OBJECT_LOCK (filter);
+  if (err != srtp_err_status_ok)
+    return gst_srtp_enc_protect_error (filter, err);
 
-  if (gst_srtp_get_soft_limit_reached ()) {
-    GST_OBJECT_UNLOCK (filter);
-    g_signal_emit (filter, gst_srtp_enc_signals[SIGNAL_SOFT_LIMIT], 0);
-    GST_OBJECT_LOCK (filter);
-    if (filter->random_key && !filter->key_changed)
-      gst_srtp_enc_replace_random_key (filter);
-  }
+  /* Push buffer to source pad */
+  ret = gst_pad_push (otherpad, bufout);
 
-  GST_OBJECT_UNLOCK (filter);
+  if (ret == GST_FLOW_OK)
+    gst_srtp_enc_check_soft_limit (filter);
 
-out:
-  gst_buffer_unref (buf);
   return ret;
 }
 
 static gboolean
-process_buffer_it (GstBuffer ** buffer, guint index, gpointer user_data)
+protect_buffer_it (GstBuffer ** buffer, guint index, gpointer user_data)
 {
-  ProcessBufferItData *data = user_data;
-  GstBuffer *bufout;
-  GstFlowReturn ret;
+  ProtectBufferItData *data = user_data;
 
-  ret = gst_srtp_enc_process_buffer (data->filter, data->pad, *buffer,
-      data->is_rtcp, &bufout);
-  if (ret != GST_FLOW_OK) {
-    data->flowret = ret;
-    return FALSE;
-  }
-
-  gst_buffer_list_add (data->out_list, bufout);
+  /* Replaces *buffer with the protected buffer, or removes it on error */
+  data->err = gst_srtp_enc_protect_buffer_no_lock (data->filter, data->pad,
+      *buffer, data->is_rtcp, buffer);
 
-  return TRUE;
+  return data->err == srtp_err_status_ok;
 }
 
 static GstFlowReturn
@@ -1283,8 +1337,7 @@ gst_srtp_enc_chain_list (GstPad * pad, GstObject * parent,
   GstSrtpEnc *filter = GST_SRTP_ENC (parent);
   GstFlowReturn ret = GST_FLOW_OK;
   GstPad *otherpad;
-  GstBufferList *out_list = NULL;
-  ProcessBufferItData process_data;
+  ProtectBufferItData protect_data;
 
   GST_LOG_OBJECT (pad, "Buffer chain with list of %d",
       gst_buffer_list_length (buf_list));
@@ -1295,56 +1348,57 @@ gst_srtp_enc_chain_list (GstPad * pad, GstObject * parent,
   if ((ret = gst_srtp_enc_check_set_caps (filter, pad, is_rtcp)) != GST_FLOW_OK)
     goto out;
 
+  otherpad = get_rtp_other_pad (pad);
+
   GST_OBJECT_LOCK (filter);
 
   if (!HAS_CRYPTO (filter)) {
     GST_OBJECT_UNLOCK (filter);
-    otherpad = get_rtp_other_pad (pad);
     return gst_pad_push_list (otherpad, buf_list);
   }
 
   GST_OBJECT_UNLOCK (filter);
 
-  out_list = gst_buffer_list_new ();
+  /* Protect the buffers in the list itself, so that the ones we own and have
+   * room for the trailer don't need a new buffer */
+  buf_list = gst_buffer_list_make_writable (buf_list);
 
-  process_data.filter = filter;
-  process_data.pad = pad;
-  process_data.is_rtcp = is_rtcp;
-  process_data.out_list = out_list;
-  process_data.flowret = GST_FLOW_OK;
+  protect_data.filter = filter;
+  protect_data.pad = pad;
+  protect_data.is_rtcp = is_rtcp;
+  protect_data.err = srtp_err_status_ok;
 
-  if (!gst_buffer_list_foreach (buf_list, process_buffer_it, &process_data)) {
-    ret = process_data.flowret;
+  /* libsrtp sessions are not thread-safe, but there is no need to take the
+   * lock for every packet of the list */
+  GST_OBJECT_LOCK (filter);
+
+  if (filter->session == NULL) {
+    /* The rtcp session disappeared (element shutting down) */
+    GST_OBJECT_UNLOCK (filter);
+    ret = GST_FLOW_FLUSHING;
     goto out;
   }
 
-  if (!gst_buffer_list_length (out_list)) {
-    gst_buffer_list_unref (out_list);
-    ret = GST_FLOW_OK;
+  gst_srtp_init_event_reporter ();
+
+  gst_buffer_list_foreach (buf_list, protect_buffer_it, &protect_data);
+
+  GST_OBJECT_UNLOCK (filter);
+
+  if (protect_data.err != srtp_err_status_ok) {
+    ret = gst_srtp_enc_protect_error (filter, protect_data.err);
     goto out;
   }
 
   /* Push buffer to source pad */
-  otherpad = get_rtp_other_pad (pad);
   GST_LOG_OBJECT (pad, "Pushing buffer chain of %d",
       gst_buffer_list_length (buf_list));
-  ret = gst_pad_push_list (otherpad, out_list);
-
-  if (ret != GST_FLOW_OK) {
-    goto out;
-  }
+  ret = gst_pad_push_list (otherpad, buf_list);
 
-  GST_OBJECT_LOCK (filter);
+  if (ret == GST_FLOW_OK)
+    gst_srtp_enc_check_soft_limit (filter);
 
-  if (gst_srtp_get_soft_limit_reached ()) {
-    GST_OBJECT_UNLOCK (filter);
-    g_signal_emit (filter, gst_srtp_enc_signals[SIGNAL_SOFT_LIMIT], 0);
-    GST_OBJECT_LOCK (filter);
-    if (filter->random_key && !filter->key_changed)
-      gst_srtp_enc_replace_random_key (filter);
-  }
-
-  GST_OBJECT_UNLOCK (filter);
+  return ret;
 
 out:
 
@@ -86,6 +86,8 @@ struct _GstSrtpEnc
   gboolean allow_repeat_tx;
 
   GHashTable *ssrcs_set;
+  guint32 last_ssrc;
+  gboolean last_ssrc_valid;
 };
 
 struct _GstSrtpEncClass
@@ -344,10 +344,16 @@ gst_remove_silence_transform_ip (GstBaseTransform * trans, GstBuffer * inbuf)
 
   filter = GST_REMOVE_SILENCE (trans);
 
-  gst_buffer_map (inbuf, &map, GST_MAP_READ);
-  frame_type =
-      vad_update (filter->vad, (gint16 *) map.data, map.size / sizeof (gint16));
-  gst_buffer_unmap (inbuf, &map);
+  /* GAP buffers are silence, no need to look at the samples */
+  if (GST_BUFFER_FLAG_IS_SET (inbuf, GST_BUFFER_FLAG_GAP)) {
+    frame_type = vad_update_silence (filter->vad,
+        gst_buffer_get_size (inbuf) / sizeof (gint16));
+  } else {
+    gst_buffer_map (inbuf, &map, GST_MAP_READ);
+    frame_type = vad_update (filter->vad, (gint16 *) map.data,
+        map.size / sizeof (gint16));
+    gst_buffer_unmap (inbuf, &map);
+  }
 
   if (frame_type == VAD_SILENCE) {
     GST_DEBUG ("Silence detected");
@@ -114,24 +114,12 @@ vad_get_threshold_as_db (struct _vad_s *p)
   return (gint) (10 * log10 (p->threshold / 4294967295.0));
 }
 
-gint
-vad_update (struct _vad_s * p, gint16 * data, gint len)
+static gint
+vad_decide (struct _vad_s *p, gint len)
 {
   guint64 tail;
   gint frame_type;
   gint16 sample;
-  gint i;
-
-  for (i = 0; i < len; i++) {
-    p->vad_power = VAD_POWER_ALPHA * ((data[i] * data[i] >> 14) & 0xFFFF) +
-        (0xFFFF - VAD_POWER_ALPHA) * (p->vad_power >> 16) +
-        ((0xFFFF - VAD_POWER_ALPHA) * (p->vad_power & 0xFFFF) >> 16);
-    /* Update VAD buffer */
-    p->cqueue.base.s[p->cqueue.head.a] = data[i];
-    p->cqueue.head.a = (p->cqueue.head.a + 1) & (p->cqueue.size - 1);
-    if (p->cqueue.head.a == p->cqueue.tail.a)
-      p->cqueue.tail.a = (p->cqueue.tail.a + 1) & (p->cqueue.size - 1);
-  }
 
   tail = p->cqueue.tail.a;
   p->vad_zcr = 0;
@@ -165,3 +153,44 @@ vad_update (struct _vad_s * p, gint16 * data, gint len)
 
   return p->vad_state;
 }
+
+gint
+vad_update (struct _vad_s * p, gint16 * data, gint len)
+{
+  gint i;
+
+  for (i = 0; i < len; i++) {
+    p->vad_power = VAD_POWER_ALPHA * ((data[i] * data[i] >> 14) & 0xFFFF) +
+        (0xFFFF - VAD_POWER_ALPHA) * (p->vad_power >> 16) +
+        ((0xFFFF - VAD_POWER_ALPHA) * (p->vad_power & 0xFFFF) >> 16);
+    /* Update VAD buffer */
+    p->cqueue.base.s[p->cqueue.head.a] = data[i];
+    p->cqueue.head.a = (p->cqueue.head.a + 1) & (p->cqueue.size - 1);
+    if (p->cqueue.head.a == p->cqueue.tail.a)
+      p->cqueue.tail.a = (p->cqueue.tail.a + 1) & (p->cqueue.size - 1);
+  }
+
+  return vad_decide (p, len);
+}
+
+/* Same as vad_update() with @len zero samples, for GAP buffers. The power
+ * only decays and the queue only needs to be filled once */
+gint
+vad_update_silence (struct _vad_s * p, gint len)
+{
+  gint i;
+
+  for (i = 0; i < len && p->vad_power != 0; i++) {
+    p->vad_power = (0xFFFF - VAD_POWER_ALPHA) * (p->vad_power >> 16) +
+        ((0xFFFF - VAD_POWER_ALPHA) * (p->vad_power & 0xFFFF) >> 16);
+  }
+
+  for (i = 0; i < MIN (len, p->cqueue.size); i++) {
+    p->cqueue.base.s[p->cqueue.head.a] = 0;
+    p->cqueue.head.a = (p->cqueue.head.a + 1) & (p->cqueue.size - 1);
+    if (p->cqueue.head.a == p->cqueue.tail.a)
+      p->cqueue.tail.a = (p->cqueue.tail.a + 1) & (p->cqueue.size - 1);
+  }
+
+  return vad_decide (p, len);
+}
@@ -31,6 +31,8 @@ typedef struct _vad_s VADFilter;
 
 gint vad_update(VADFilter *p, gint16 *data, gint len);
 
+gint vad_update_silence(VADFilter *p, gint len);
+
 void vad_set_hysteresis(VADFilter *p, guint64 hysteresis);
 
 guint64 vad_get_hysteresis(VADFilter *p);
@@ -0,0 +1,759 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-rtpsimulcastswitch
+ * @title: rtpsimulcastswitch
+ *
+ * rtpsimulcastswitch forwards the already encoded RTP packets of one of the
+ * layers of a simulcast stream, received on its request sink pads, as a
+ * single continuous RTP stream. This is what a selective forwarding unit
+ * (SFU) does for every receiver: no packet is depayloaded, decoded or
+ * re-encoded.
+ *
+ * The layer to forward is selected with the #GstRtpSimulcastSwitch:active-pad
+ * property. The switch happens at the first packet of the next keyframe of
+ * the new layer, i.e. the first packet of a new frame that is not flagged
+ * with %GST_BUFFER_FLAG_DELTA_UNIT, as set by the payloaders. Until then the
+ * previously selected layer keeps being forwarded.
+ * The SSRC of the outgoing packets is always #GstRtpSimulcastSwitch:ssrc and
+ * their sequence numbers and RTP timestamps are rewritten to continue those
+ * of the previously forwarded layer, so that the receiver sees one stream.
+ *
+ * Only the 12 byte fixed RTP header is rewritten. When the packets are shared
+ * with other branches, e.g. after a tee feeding one rtpsimulcastswitch and
+ * one webrtcbin per receiver, only the header is copied and the payload
+ * memory stays shared.
+ *
+ * ## Building an SFU
+ *
+ * An SFU is assembled from one webrtcbin per peer connection and one
+ * rtpsimulcastswitch per forwarded stream and receiver:
+ *
+ * * The webrtcbin of the sending peer has a recvonly transceiver. Each
+ *   simulcast layer shows up on its own src pad, as decrypted RTP packets.
+ * * Each layer src pad goes into a tee, one per layer, so that the packets of
+ *   a layer are received and decrypted only once.
+ * * For every receiving peer, a request pad of each tee is linked to a sink
+ *   pad of that receiver's rtpsimulcastswitch. The layer is chosen from the
+ *   receiver's bandwidth estimate with the active-pad property.
+ * * The rtpsimulcastswitch src pad is linked to a sink pad of the receiver's
+ *   webrtcbin with a sendonly transceiver. Its caps are the caps of the
+ *   layers, with the SSRC set to the ssrc property.
+ *
+ * |[
+ *                             +-> rtpsimulcastswitch -> webrtcbin (peer 1)
+ * webrtcbin -> tee (layer 0) -+
+ * (sender)  -> tee (layer 1) -+-> rtpsimulcastswitch -> webrtcbin (peer 2)
+ * ]|
+ *
+ * The keyframe requests of a receiver, i.e. the upstream force-key-unit
+ * events its webrtcbin creates from RTCP PLI and FIR, only go to the layer
+ * that receiver forwards. They reach the sending webrtcbin through the tee,
+ * which turns them into RTCP feedback to the sender.
+ *
+ * Each webrtcbin still has its own rtpbin, RTCP session and DTLS/SRTP
+ * transport, so the packets are encrypted once per receiver. Nothing is
+ * decoded and no other element is needed per receiver.
+ *
+ * ## Example pipeline
+ * |[
+ * gst-launch-1.0 rtpsimulcastswitch name=s ! rtpvp8depay ! vp8dec ! autovideosink \
+ *   videotestsrc ! video/x-raw,width=320,height=240 ! vp8enc ! rtpvp8pay ! s.sink_0 \
+ *   videotestsrc ! video/x-raw,width=640,height=480 ! vp8enc ! rtpvp8pay ! s.sink_1
+ * ]| Forward the lower resolution layer, the other one can be selected by
+ * setting the active-pad property to sink_1.
+ *
+ * Since: 1.22
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gst/video/video.h>
+
+#include "gstrtpsimulcastswitch.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_rtp_simulcast_switch_debug);
+#define GST_CAT_DEFAULT gst_rtp_simulcast_switch_debug
+
+/* Size of the fixed RTP header, which holds all the fields we rewrite */
+#define RTP_HEADER_LEN 12
+
+#define DEFAULT_SSRC              G_MAXUINT32
+#define DEFAULT_REQUEST_KEYFRAME  TRUE
+
+enum
+{
+  PROP_0,
+  PROP_ACTIVE_PAD,
+  PROP_SSRC,
+  PROP_REQUEST_KEYFRAME,
+};
+
+#define GST_TYPE_RTP_SIMULCAST_SWITCH_PAD \
+  (gst_rtp_simulcast_switch_pad_get_type())
+#define GST_RTP_SIMULCAST_SWITCH_PAD_CAST(obj) \
+  ((GstRtpSimulcastSwitchPad *) obj)
+
+typedef struct _GstRtpSimulcastSwitchPad GstRtpSimulcastSwitchPad;
+typedef struct _GstRtpSimulcastSwitchPadClass GstRtpSimulcastSwitchPadClass;
+
+/* All fields are protected by the object lock of the element */
+struct _GstRtpSimulcastSwitchPad
+{
+  GstPad parent;
+
+  GstCaps *caps;
+  gint clock_rate;
+  GstSegment segment;
+
+  /* RTP timestamp of the last received packet, to detect frame starts */
+  gboolean have_last;
+  guint32 last_ts;
+
+  /* added to the received seqnum and RTP timestamp when forwarding */
+  guint16 seq_offset;
+  guint32 ts_offset;
+};
+
+struct _GstRtpSimulcastSwitchPadClass
+{
+  GstPadClass parent;
+};
+
+GType gst_rtp_simulcast_switch_pad_get_type (void);
+G_DEFINE_TYPE (GstRtpSimulcastSwitchPad, gst_rtp_simulcast_switch_pad,
+    GST_TYPE_PAD);
+
+static void
+gst_rtp_simulcast_switch_pad_finalize (GObject * object)
+{
+  GstRtpSimulcastSwitchPad *spad = GST_RTP_SIMULCAST_SWITCH_PAD_CAST (object);
+
+  gst_caps_replace (&spad->caps, NULL);
+
+  G_OBJECT_CLASS (gst_rtp_simulcast_switch_pad_parent_class)->finalize
+      (object);
+}
+
+static void
+gst_rtp_simulcast_switch_pad_class_init (GstRtpSimulcastSwitchPadClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  gobject_class->finalize = gst_rtp_simulcast_switch_pad_finalize;
+}
+
+static void
+gst_rtp_simulcast_switch_pad_init (GstRtpSimulcastSwitchPad * spad)
+{
+  gst_segment_init (&spad->segment, GST_FORMAT_UNDEFINED);
+}
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink_%u",
+    GST_PAD_SINK,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS ("application/x-rtp"));
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("application/x-rtp"));
+
+#define gst_rtp_simulcast_switch_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstRtpSimulcastSwitch, gst_rtp_simulcast_switch,
+    GST_TYPE_ELEMENT,
+    GST_DEBUG_CATEGORY_INIT (gst_rtp_simulcast_switch_debug,
+        "rtpsimulcastswitch", 0, "RTP Simulcast Switch"));
+GST_ELEMENT_REGISTER_DEFINE (rtpsimulcastswitch, "rtpsimulcastswitch",
+    GST_RANK_NONE, GST_TYPE_RTP_SIMULCAST_SWITCH);
+
+/* With the object lock */
+static GstCaps *
+get_output_caps (GstRtpSimulcastSwitch * self, GstRtpSimulcastSwitchPad * spad)
+{
+  GstCaps *caps;
+  GstStructure *s;
+
+  if (!spad->caps)
+    return NULL;
+
+  caps = gst_caps_copy (spad->caps);
+  s = gst_caps_get_structure (caps, 0);
+  gst_structure_set (s, "ssrc", G_TYPE_UINT, self->ssrc, NULL);
+  /* the outgoing packets do not start at the offsets of the layer */
+  gst_structure_remove_fields (s, "seqnum-offset", "timestamp-offset", NULL);
+
+  return caps;
+}
+
+/* Rewrites the fixed RTP header of @buffer. Shared memory is copied by
+ * gst_buffer_map_range(), so the header is split off first to not copy the
+ * payload along with it */
+static GstBuffer *
+rewrite_header (GstRtpSimulcastSwitch * self, GstBuffer * buffer,
+    guint16 seq, guint32 ts, guint32 ssrc)
+{
+  GstMemory *mem;
+  GstMapInfo map;
+
+  buffer = gst_buffer_make_writable (buffer);
+
+  mem = gst_buffer_peek_memory (buffer, 0);
+  if (!gst_memory_is_writable (mem) &&
+      gst_memory_get_sizes (mem, NULL, NULL) > RTP_HEADER_LEN) {
+    GstMemory *header, *payload;
+
+    header = gst_memory_share (mem, 0, RTP_HEADER_LEN);
+    payload = gst_memory_share (mem, RTP_HEADER_LEN, -1);
+    gst_buffer_replace_memory (buffer, 0, header);
+    gst_buffer_insert_memory (buffer, 1, payload);
+  }
+
+  if (!gst_buffer_map_range (buffer, 0, 1, &map, GST_MAP_WRITE))
+    goto map_failed;
+
+  if (map.size < RTP_HEADER_LEN) {
+    gst_buffer_unmap (buffer, &map);
+    goto map_failed;
+  }
+
+  GST_WRITE_UINT16_BE (map.data + 2, seq);
+  GST_WRITE_UINT32_BE (map.data + 4, ts);
+  GST_WRITE_UINT32_BE (map.data + 8, ssrc);
+
+  gst_buffer_unmap (buffer, &map);
+
+  return buffer;
+
+  /* ERRORS */
+map_failed:
+  {
+    GST_ELEMENT_ERROR (self, STREAM, FAILED, (NULL),
+        ("Failed to map the RTP header for writing"));
+    gst_buffer_unref (buffer);
+    return NULL;
+  }
+}
+
+static GstFlowReturn
+gst_rtp_simulcast_switch_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  GstRtpSimulcastSwitch *self = GST_RTP_SIMULCAST_SWITCH (parent);
+  GstRtpSimulcastSwitchPad *spad = GST_RTP_SIMULCAST_SWITCH_PAD_CAST (pad);
+  guint8 header[RTP_HEADER_LEN];
+  GstClockTime running_time = GST_CLOCK_TIME_NONE;
+  GstCaps *caps = NULL;
+  GstEvent *segment_event = NULL;
+  gboolean keyframe_start;
+  gboolean switched = FALSE;
+  guint16 seq;
+  guint32 ts, ssrc;
+
+  if (gst_buffer_extract (buffer, 0, header, RTP_HEADER_LEN) != RTP_HEADER_LEN
+      || (header[0] >> 6) != 2) {
+    GST_WARNING_OBJECT (pad, "Dropping invalid RTP packet");
+    gst_buffer_unref (buffer);
+    return GST_FLOW_OK;
+  }
+
+  seq = GST_READ_UINT16_BE (header + 2);
+  ts = GST_READ_UINT32_BE (header + 4);
+
+  GST_OBJECT_LOCK (self);
+
+  if (spad->segment.format == GST_FORMAT_TIME)
+    running_time = gst_segment_to_running_time (&spad->segment,
+        GST_FORMAT_TIME, GST_BUFFER_PTS (buffer));
+
+  /* all packets of a frame have the same RTP timestamp, it is only known
+   * that a new frame starts once a previous packet has been seen. The
+   * receiver can only decode the new layer from a keyframe on, so frames
+   * flagged as delta units never start it and the previous layer keeps
+   * being forwarded meanwhile */
+  keyframe_start = spad->have_last && spad->last_ts != ts &&
+      !GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+  spad->have_last = TRUE;
+  spad->last_ts = ts;
+
+  if (pad == self->pending_pad && keyframe_start) {
+    if (self->have_last) {
+      guint64 delta = 0;
+
+      /* continue the sequence numbers and advance the RTP timestamp by the
+       * time elapsed since the last forwarded packet */
+      spad->seq_offset = self->last_seq + 1 - seq;
+
+      if (GST_CLOCK_TIME_IS_VALID (running_time) &&
+          GST_CLOCK_TIME_IS_VALID (self->last_running_time) &&
+          running_time > self->last_running_time && spad->clock_rate > 0)
+        delta = gst_util_uint64_scale_int (running_time -
+            self->last_running_time, spad->clock_rate, GST_SECOND);
+
+      spad->ts_offset = self->last_ts + MAX (delta, 1) - ts;
+    } else {
+      spad->seq_offset = 0;
+      spad->ts_offset = 0;
+    }
+
+    GST_INFO_OBJECT (self, "Switching to %" GST_PTR_FORMAT
+        " (seqnum offset %u, timestamp offset %u)", pad, spad->seq_offset,
+        spad->ts_offset);
+
+    gst_object_replace ((GstObject **) & self->active_pad, GST_OBJECT (pad));
+    gst_clear_object (&self->pending_pad);
+    self->need_events = TRUE;
+    switched = TRUE;
+  }
+
+  if (pad != self->active_pad) {
+    GST_OBJECT_UNLOCK (self);
+    GST_LOG_OBJECT (pad, "Dropping packet of inactive layer");
+    gst_buffer_unref (buffer);
+    return GST_FLOW_OK;
+  }
+
+  if (self->need_events) {
+    caps = get_output_caps (self, spad);
+    if (spad->segment.format != GST_FORMAT_UNDEFINED)
+      segment_event = gst_event_new_segment (&spad->segment);
+    self->need_events = FALSE;
+  }
+
+  seq += spad->seq_offset;
+  ts += spad->ts_offset;
+  ssrc = self->ssrc;
+
+  self->have_last = TRUE;
+  self->last_seq = seq;
+  self->last_ts = ts;
+  self->last_running_time = running_time;
+
+  GST_OBJECT_UNLOCK (self);
+
+  if (switched)
+    g_object_notify (G_OBJECT (self), "active-pad");
+
+  if (caps) {
+    gst_pad_push_event (self->srcpad, gst_event_new_caps (caps));
+    gst_caps_unref (caps);
+  }
+  if (segment_event)
+    gst_pad_push_event (self->srcpad, segment_event);
+
+  buffer = rewrite_header (self, buffer, seq, ts, ssrc);
+  if (!buffer)
+    return GST_FLOW_ERROR;
+
+  return gst_pad_push (self->srcpad, buffer);
+}
+
+static gboolean
+gst_rtp_simulcast_switch_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstRtpSimulcastSwitch *self = GST_RTP_SIMULCAST_SWITCH (parent);
+  GstRtpSimulcastSwitchPad *spad = GST_RTP_SIMULCAST_SWITCH_PAD_CAST (pad);
+  gboolean active;
+
+  GST_OBJECT_LOCK (self);
+  active = (pad == self->active_pad);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:
+    {
+      GstCaps *caps, *outcaps;
+      GstStructure *s;
+
+      gst_event_parse_caps (event, &caps);
+      s = gst_caps_get_structure (caps, 0);
+      spad->clock_rate = 0;
+      gst_structure_get_int (s, "clock-rate", &spad->clock_rate);
+      gst_caps_replace (&spad->caps, caps);
+      gst_event_unref (event);
+
+      if (!active) {
+        GST_OBJECT_UNLOCK (self);
+        return TRUE;
+      }
+
+      outcaps = get_output_caps (self, spad);
+      GST_OBJECT_UNLOCK (self);
+
+      event = gst_event_new_caps (outcaps);
+      gst_caps_unref (outcaps);
+      return gst_pad_push_event (self->srcpad, event);
+    }
+    case GST_EVENT_SEGMENT:
+      gst_event_copy_segment (event, &spad->segment);
+      break;
+    case GST_EVENT_FLUSH_STOP:
+      gst_segment_init (&spad->segment, GST_FORMAT_UNDEFINED);
+      spad->have_last = FALSE;
+      break;
+    default:
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  /* the output is the stream of the active layer only */
+  if (!active) {
+    gst_event_unref (event);
+    return TRUE;
+  }
+
+  return gst_pad_push_event (self->srcpad, event);
+}
+
+static gboolean
+gst_rtp_simulcast_switch_sink_query (GstPad * pad, GstObject * parent,
+    GstQuery * query)
+{
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CAPS:
+    {
+      GstCaps *filter, *caps;
+
+      /* the SSRC and offsets of the layers do not have to match the ones
+       * negotiated downstream, they are rewritten */
+      gst_query_parse_caps (query, &filter);
+      caps = gst_pad_get_pad_template_caps (pad);
+      if (filter) {
+        GstCaps *tmp = gst_caps_intersect_full (filter, caps,
+            GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref (caps);
+        caps = tmp;
+      }
+      gst_query_set_caps_result (query, caps);
+      gst_caps_unref (caps);
+      return TRUE;
+    }
+    default:
+      return gst_pad_query_default (pad, parent, query);
+  }
+}
+
+static gboolean
+gst_rtp_simulcast_switch_src_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstRtpSimulcastSwitch *self = GST_RTP_SIMULCAST_SWITCH (parent);
+  GstPad *active = NULL;
+
+  /* keyframe requests and other upstream events go to the forwarded layer
+   * only */
+  GST_OBJECT_LOCK (self);
+  if (self->active_pad)
+    active = gst_object_ref (self->active_pad);
+  GST_OBJECT_UNLOCK (self);
+
+  if (!active)
+    return gst_pad_event_default (pad, parent, event);
+
+  if (!gst_pad_push_event (active, event)) {
+    gst_object_unref (active);
+    return FALSE;
+  }
+
+  gst_object_unref (active);
+  return TRUE;
+}
+
+static void
+gst_rtp_simulcast_switch_set_active_pad (GstRtpSimulcastSwitch * self,
+    GstPad * pad)
+{
+  gboolean request_keyframe;
+
+  if (pad && (GST_PAD_PARENT (pad) != GST_ELEMENT_CAST (self) ||
+          GST_PAD_DIRECTION (pad) != GST_PAD_SINK)) {
+    GST_WARNING_OBJECT (self, "%" GST_PTR_FORMAT " is not a sink pad of %"
+        GST_PTR_FORMAT, pad, self);
+    return;
+  }
+
+  GST_OBJECT_LOCK (self);
+  if (pad == self->active_pad) {
+    gst_clear_object (&self->pending_pad);
+    GST_OBJECT_UNLOCK (self);
+    return;
+  }
+
+  if (!self->active_pad || !pad) {
+    /* nothing forwarded yet or to be forwarded anymore, no need to wait for
+     * a frame boundary */
+    gst_clear_object (&self->pending_pad);
+    gst_object_replace ((GstObject **) & self->active_pad, GST_OBJECT (pad));
+    self->need_events = TRUE;
+    GST_OBJECT_UNLOCK (self);
+    return;
+  }
+
+  GST_DEBUG_OBJECT (self, "Switching to %" GST_PTR_FORMAT
+      " at its next keyframe", pad);
+  gst_object_replace ((GstObject **) & self->pending_pad, GST_OBJECT (pad));
+  request_keyframe = self->request_keyframe;
+  GST_OBJECT_UNLOCK (self);
+
+  /* the receiver can only decode the new layer from its next keyframe on */
+  if (request_keyframe)
+    gst_pad_push_event (pad,
+        gst_video_event_new_upstream_force_key_unit (GST_CLOCK_TIME_NONE,
+            TRUE, 0));
+}
+
+static GstPad *
+gst_rtp_simulcast_switch_request_new_pad (GstElement * element,
+    GstPadTemplate * templ, const gchar * name, const GstCaps * caps)
+{
+  GstRtpSimulcastSwitch *self = GST_RTP_SIMULCAST_SWITCH (element);
+  GstPad *pad;
+  gchar *pad_name;
+
+  GST_OBJECT_LOCK (self);
+  if (name)
+    pad_name = g_strdup (name);
+  else
+    pad_name = g_strdup_printf ("sink_%u", self->next_pad_id);
+  self->next_pad_id++;
+  GST_OBJECT_UNLOCK (self);
+
+  pad = g_object_new (GST_TYPE_RTP_SIMULCAST_SWITCH_PAD, "name", pad_name,
+      "direction", templ->direction, "template", templ, NULL);
+  g_free (pad_name);
+
+  gst_pad_set_chain_function (pad,
+      GST_DEBUG_FUNCPTR (gst_rtp_simulcast_switch_chain));
+  gst_pad_set_event_function (pad,
+      GST_DEBUG_FUNCPTR (gst_rtp_simulcast_switch_sink_event));
+  gst_pad_set_query_function (pad,
+      GST_DEBUG_FUNCPTR (gst_rtp_simulcast_switch_sink_query));
+
+  if (!gst_element_add_pad (element, pad)) {
+    gst_object_unref (pad);
+    return NULL;
+  }
+
+  /* the first layer is forwarded until another one is selected */
+  GST_OBJECT_LOCK (self);
+  if (!self->active_pad && !self->pending_pad) {
+    self->active_pad = gst_object_ref (pad);
+    self->need_events = TRUE;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  return pad;
+}
+
+static void
+gst_rtp_simulcast_switch_release_pad (GstElement * element, GstPad * pad)
+{
+  GstRtpSimulcastSwitch *self = GST_RTP_SIMULCAST_SWITCH (element);
+
+  GST_OBJECT_LOCK (self);
+  if (pad == self->active_pad)
+    gst_clear_object (&self->active_pad);
+  if (pad == self->pending_pad)
+    gst_clear_object (&self->pending_pad);
+  GST_OBJECT_UNLOCK (self);
+
+  gst_element_remove_pad (element, pad);
+}
+
+static GstStateChangeReturn
+gst_rtp_simulcast_switch_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstRtpSimulcastSwitch *self = GST_RTP_SIMULCAST_SWITCH (element);
+  GstStateChangeReturn ret;
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      GST_OBJECT_LOCK (self);
+      self->have_last = FALSE;
+      self->last_running_time = GST_CLOCK_TIME_NONE;
+      self->need_events = TRUE;
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      break;
+  }
+
+  return ret;
+}
+
+static void
+gst_rtp_simulcast_switch_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstRtpSimulcastSwitch *self = GST_RTP_SIMULCAST_SWITCH (object);
+
+  switch (prop_id) {
+    case PROP_ACTIVE_PAD:
+      gst_rtp_simulcast_switch_set_active_pad (self,
+          g_value_get_object (value));
+      break;
+    case PROP_SSRC:{
+      guint32 ssrc = g_value_get_uint (value);
+
+      GST_OBJECT_LOCK (self);
+      self->ssrc = (ssrc == DEFAULT_SSRC) ? g_random_int () : ssrc;
+      self->need_events = TRUE;
+      GST_OBJECT_UNLOCK (self);
+      break;
+    }
+    case PROP_REQUEST_KEYFRAME:
+      GST_OBJECT_LOCK (self);
+      self->request_keyframe = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_rtp_simulcast_switch_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstRtpSimulcastSwitch *self = GST_RTP_SIMULCAST_SWITCH (object);
+
+  switch (prop_id) {
+    case PROP_ACTIVE_PAD:
+      GST_OBJECT_LOCK (self);
+      g_value_set_object (value, self->active_pad);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_SSRC:
+      GST_OBJECT_LOCK (self);
+      g_value_set_uint (value, self->ssrc);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_REQUEST_KEYFRAME:
+      GST_OBJECT_LOCK (self);
+      g_value_set_boolean (value, self->request_keyframe);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_rtp_simulcast_switch_dispose (GObject * object)
+{
+  GstRtpSimulcastSwitch *self = GST_RTP_SIMULCAST_SWITCH (object);
+
+  gst_clear_object (&self->active_pad);
+  gst_clear_object (&self->pending_pad);
+
+  G_OBJECT_CLASS (parent_class)->dispose (object);
+}
+
+static void
+gst_rtp_simulcast_switch_class_init (GstRtpSimulcastSwitchClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+  GstElementClass *element_class = (GstElementClass *) klass;
+
+  gobject_class->set_property = gst_rtp_simulcast_switch_set_property;
+  gobject_class->get_property = gst_rtp_simulcast_switch_get_property;
+  gobject_class->dispose = gst_rtp_simulcast_switch_dispose;
+
+  /**
+   * GstRtpSimulcastSwitch:active-pad:
+   *
+   * The sink pad of the layer to forward. A new layer replaces the current
+   * one at its next keyframe, until then the current one is still
+   * forwarded and this property keeps its value.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_ACTIVE_PAD,
+      g_param_spec_object ("active-pad", "Active pad",
+          "The sink pad of the forwarded layer", GST_TYPE_PAD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRtpSimulcastSwitch:ssrc:
+   *
+   * The SSRC of the forwarded packets, whatever layer they come from.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_SSRC,
+      g_param_spec_uint ("ssrc", "SSRC",
+          "The SSRC of the forwarded packets (default == random)", 0,
+          G_MAXUINT32, DEFAULT_SSRC,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRtpSimulcastSwitch:request-keyframe:
+   *
+   * Whether to send an upstream force-key-unit event to a newly selected
+   * layer, so that the receiver can start decoding it soon.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_REQUEST_KEYFRAME,
+      g_param_spec_boolean ("request-keyframe", "Request keyframe",
+          "Request a keyframe from a newly selected layer",
+          DEFAULT_REQUEST_KEYFRAME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  element_class->request_new_pad =
+      GST_DEBUG_FUNCPTR (gst_rtp_simulcast_switch_request_new_pad);
+  element_class->release_pad =
+      GST_DEBUG_FUNCPTR (gst_rtp_simulcast_switch_release_pad);
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (gst_rtp_simulcast_switch_change_state);
+
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+  gst_element_class_add_static_pad_template_with_gtype (element_class,
+      &sink_template, GST_TYPE_RTP_SIMULCAST_SWITCH_PAD);
+
+  gst_element_class_set_static_metadata (element_class,
+      "RTP Simulcast Switch", "Filter/Network/RTP",
+      "Forwards one layer of a simulcast RTP stream as a single stream",
+      "GStreamer developers");
+
+  gst_type_mark_as_plugin_api (GST_TYPE_RTP_SIMULCAST_SWITCH_PAD, 0);
+}
+
+static void
+gst_rtp_simulcast_switch_init (GstRtpSimulcastSwitch * self)
+{
+  self->srcpad = gst_pad_new_from_static_template (&src_template, "src");
+  gst_pad_set_event_function (self->srcpad,
+      GST_DEBUG_FUNCPTR (gst_rtp_simulcast_switch_src_event));
+  gst_pad_use_fixed_caps (self->srcpad);
+  gst_element_add_pad (GST_ELEMENT (self), self->srcpad);
+
+  self->ssrc = g_random_int ();
+  self->request_keyframe = DEFAULT_REQUEST_KEYFRAME;
+  self->last_running_time = GST_CLOCK_TIME_NONE;
+  self->need_events = TRUE;
+}
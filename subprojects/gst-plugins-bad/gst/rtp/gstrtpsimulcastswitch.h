@@ -0,0 +1,75 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_RTP_SIMULCAST_SWITCH_H__
+#define __GST_RTP_SIMULCAST_SWITCH_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+#define GST_TYPE_RTP_SIMULCAST_SWITCH \
+  (gst_rtp_simulcast_switch_get_type())
+#define GST_RTP_SIMULCAST_SWITCH(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_RTP_SIMULCAST_SWITCH, GstRtpSimulcastSwitch))
+#define GST_RTP_SIMULCAST_SWITCH_CAST(obj) \
+  ((GstRtpSimulcastSwitch *) obj)
+#define GST_RTP_SIMULCAST_SWITCH_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST ((klass), GST_TYPE_RTP_SIMULCAST_SWITCH, GstRtpSimulcastSwitchClass))
+#define GST_IS_RTP_SIMULCAST_SWITCH(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_RTP_SIMULCAST_SWITCH))
+#define GST_IS_RTP_SIMULCAST_SWITCH_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_RTP_SIMULCAST_SWITCH))
+
+typedef struct _GstRtpSimulcastSwitch GstRtpSimulcastSwitch;
+typedef struct _GstRtpSimulcastSwitchClass GstRtpSimulcastSwitchClass;
+
+struct _GstRtpSimulcastSwitch
+{
+  GstElement parent;
+
+  GstPad *srcpad;
+
+  /* Properties, protected by the object lock */
+  guint32 ssrc;
+  gboolean request_keyframe;
+
+  /* Protected by the object lock */
+  GstPad *active_pad;
+  GstPad *pending_pad;
+  guint next_pad_id;
+
+  /* Last packet pushed downstream, protected by the object lock */
+  gboolean have_last;
+  guint16 last_seq;
+  guint32 last_ts;
+  GstClockTime last_running_time;
+  /* Whether the caps and segment of the active pad still have to be sent */
+  gboolean need_events;
+};
+
+struct _GstRtpSimulcastSwitchClass
+{
+  GstElementClass parent;
+};
+
+GType gst_rtp_simulcast_switch_get_type (void);
+GST_ELEMENT_REGISTER_DECLARE (rtpsimulcastswitch);
+
+G_END_DECLS
+#endif /* __GST_RTP_SIMULCAST_SWITCH_H__ */
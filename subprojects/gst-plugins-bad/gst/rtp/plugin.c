@@ -4,6 +4,7 @@
 
 #include "gstrtpsink.h"
 #include "gstrtpsrc.h"
+#include "gstrtpsimulcastswitch.h"
 
 
 static gboolean
@@ -13,6 +14,7 @@ plugin_init (GstPlugin * plugin)
 
   ret |= GST_ELEMENT_REGISTER (rtpsrc, plugin);
   ret |= GST_ELEMENT_REGISTER (rtpsink, plugin);
+  ret |= GST_ELEMENT_REGISTER (rtpsimulcastswitch, plugin);
 
   return ret;
 }
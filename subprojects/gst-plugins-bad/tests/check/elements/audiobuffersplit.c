@@ -0,0 +1,153 @@
+/* GStreamer unit test for audiobuffersplit
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+#include <gst/audio/audio.h>
+
+#define RATE 44100
+#define CAPS "audio/x-raw, format=" GST_AUDIO_NE (S16) ", rate=(int)44100, " \
+    "channels=(int)1, layout=interleaved"
+/* not a multiple of the output size so that some outputs span two inputs */
+#define SAMPLES_PER_INPUT 1000
+#define N_INPUTS 5
+
+static GstPadProbeReturn
+count_lists (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  guint *n_lists = user_data;
+
+  *n_lists += 1;
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* Pushes the same input through audiobuffersplit, with or without
+ * output-buffer-list, and returns all output buffers */
+static GList *
+run_split (gboolean output_buffer_list, guint * n_lists)
+{
+  GstHarness *h;
+  GstPad *srcpad;
+  GstBuffer *buf;
+  GList *outputs = NULL;
+  guint i, j;
+
+  h = gst_harness_new ("audiobuffersplit");
+  g_object_set (h->element, "output-buffer-duration", 1, 1000,
+      "output-buffer-list", output_buffer_list, NULL);
+  gst_harness_set_src_caps_str (h, CAPS);
+
+  *n_lists = 0;
+  srcpad = gst_element_get_static_pad (h->element, "src");
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_BUFFER_LIST, count_lists,
+      n_lists, NULL);
+  gst_object_unref (srcpad);
+
+  for (i = 0; i < N_INPUTS; i++) {
+    GstMapInfo map;
+    gint16 *samples;
+
+    buf = gst_buffer_new_allocate (NULL, SAMPLES_PER_INPUT * 2, NULL);
+    fail_unless (gst_buffer_map (buf, &map, GST_MAP_WRITE));
+    samples = (gint16 *) map.data;
+    for (j = 0; j < SAMPLES_PER_INPUT; j++)
+      samples[j] = i * SAMPLES_PER_INPUT + j;
+    gst_buffer_unmap (buf, &map);
+
+    GST_BUFFER_PTS (buf) =
+        gst_util_uint64_scale (i * SAMPLES_PER_INPUT, GST_SECOND, RATE);
+    GST_BUFFER_DURATION (buf) =
+        gst_util_uint64_scale (SAMPLES_PER_INPUT, GST_SECOND, RATE);
+    if (i == 0)
+      GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DISCONT);
+
+    fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  }
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  while ((buf = gst_harness_try_pull (h)))
+    outputs = g_list_append (outputs, buf);
+
+  gst_harness_teardown (h);
+
+  return outputs;
+}
+
+GST_START_TEST (test_output_buffer_list)
+{
+  GList *buffers, *lists, *l, *k;
+  guint n_buffer_lists, n_list_lists, n_samples = 0;
+
+  buffers = run_split (FALSE, &n_buffer_lists);
+  lists = run_split (TRUE, &n_list_lists);
+
+  /* one list per input buffer, plus the remainder drained at EOS */
+  fail_unless_equals_int (n_buffer_lists, 0);
+  fail_unless (n_list_lists >= N_INPUTS);
+  fail_unless (n_list_lists <= N_INPUTS + 1);
+
+  fail_unless_equals_int (g_list_length (buffers), g_list_length (lists));
+  /* 44.1 samples per buffer on average */
+  fail_unless (g_list_length (buffers) >= N_INPUTS * SAMPLES_PER_INPUT / 45);
+
+  for (l = buffers, k = lists; l; l = l->next, k = k->next) {
+    GstBuffer *a = l->data, *b = k->data;
+    GstMapInfo map_a, map_b;
+
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (a), GST_BUFFER_PTS (b));
+    fail_unless_equals_uint64 (GST_BUFFER_DURATION (a),
+        GST_BUFFER_DURATION (b));
+    fail_unless_equals_int (GST_BUFFER_FLAGS (a), GST_BUFFER_FLAGS (b));
+
+    fail_unless (gst_buffer_map (a, &map_a, GST_MAP_READ));
+    fail_unless (gst_buffer_map (b, &map_b, GST_MAP_READ));
+    fail_unless_equals_int (map_a.size, map_b.size);
+    fail_unless (memcmp (map_a.data, map_b.data, map_a.size) == 0);
+    /* the samples come out in order and none is lost */
+    fail_unless_equals_int (((gint16 *) map_a.data)[0], n_samples);
+    n_samples += map_a.size / 2;
+    gst_buffer_unmap (b, &map_b);
+    gst_buffer_unmap (a, &map_a);
+  }
+  fail_unless_equals_int (n_samples, N_INPUTS * SAMPLES_PER_INPUT);
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  g_list_free_full (lists, (GDestroyNotify) gst_buffer_unref);
+}
+
+GST_END_TEST;
+
+static Suite *
+audiobuffersplit_suite (void)
+{
+  Suite *s = suite_create ("audiobuffersplit");
+  TCase *tc_chain;
+
+  tc_chain = tcase_create ("general");
+  tcase_add_test (tc_chain, test_output_buffer_list);
+  suite_add_tcase (s, tc_chain);
+
+  return s;
+}
+
+GST_CHECK_MAIN (audiobuffersplit);
@@ -0,0 +1,194 @@
+/* GStreamer unit tests for removesilence
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+#include <gst/audio/audio.h>
+
+/* the VAD state is private, test it directly */
+#include "../../gst/removesilence/vad_private.c"
+
+#define RATE 8000
+#define CAPS "audio/x-raw, format=" GST_AUDIO_NE (S16) ", rate=(int)8000, " \
+    "channels=(int)1, layout=interleaved"
+/* 20ms */
+#define SAMPLES_PER_BUFFER 160
+
+/* A tone with some noise, well above the default threshold of -60dB */
+static void
+fill_voice (GRand * rand, gint16 * data, gint len)
+{
+  gint i;
+
+  for (i = 0; i < len; i++)
+    data[i] = 8000 * sin (2.0 * G_PI * 440.0 * i / RATE) +
+        g_rand_int_range (rand, -500, 500);
+}
+
+/* vad_update_silence() gives the same decisions and leaves the VAD in the
+ * same state as vad_update() on zeros, whatever the length of the silence
+ * compared to the VAD buffer */
+GST_START_TEST (test_vad_update_silence)
+{
+  static const gint lengths[] = { 1, 80, 160, 255, 256, 257, 1000, 4000 };
+  GRand *rand = g_rand_new_with_seed (42);
+  VADFilter *a, *b;
+  gint16 *voice, *zeros;
+  guint i, n;
+
+  voice = g_new (gint16, 4000);
+  zeros = g_new0 (gint16, 4000);
+  a = vad_new (480, -60);
+  b = vad_new (480, -60);
+
+  for (n = 0; n < 4; n++) {
+    for (i = 0; i < G_N_ELEMENTS (lengths); i++) {
+      gint len = lengths[i];
+
+      fill_voice (rand, voice, len);
+      fail_unless_equals_int (vad_update (a, voice, len),
+          vad_update (b, voice, len));
+
+      fail_unless_equals_int (vad_update (a, zeros, len),
+          vad_update_silence (b, len));
+      fail_unless_equals_uint64 (a->vad_power, b->vad_power);
+      fail_unless_equals_uint64 (a->vad_samples, b->vad_samples);
+      fail_unless_equals_int (a->vad_zcr, b->vad_zcr);
+    }
+  }
+
+  vad_destroy (a);
+  vad_destroy (b);
+  g_free (voice);
+  g_free (zeros);
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+/* Pushes voice, then silence as zeros or as GAP buffers with garbage in
+ * them, then voice again. Returns the PTS of the buffers that are not
+ * removed and the detection messages */
+static void
+run_removesilence (gboolean gap, GArray * out_pts, GList ** messages)
+{
+  GRand *rand = g_rand_new_with_seed (1234);
+  GstHarness *h;
+  GstBus *bus;
+  GstBuffer *buf;
+  GstMessage *msg;
+  guint i;
+
+  h = gst_harness_new ("removesilence");
+  g_object_set (h->element, "remove", TRUE, "silent", FALSE,
+      "minimum-silence-buffers", 3, NULL);
+  bus = gst_bus_new ();
+  gst_element_set_bus (h->element, bus);
+  gst_harness_set_src_caps_str (h, CAPS);
+
+  for (i = 0; i < 30; i++) {
+    GstMapInfo map;
+    gboolean silence = i >= 10 && i < 25;
+
+    buf = gst_buffer_new_allocate (NULL, SAMPLES_PER_BUFFER * 2, NULL);
+    fail_unless (gst_buffer_map (buf, &map, GST_MAP_WRITE));
+    /* the samples of GAP buffers are not looked at */
+    if (!silence || gap)
+      fill_voice (rand, (gint16 *) map.data, SAMPLES_PER_BUFFER);
+    else
+      memset (map.data, 0, map.size);
+    gst_buffer_unmap (buf, &map);
+
+    if (silence && gap)
+      GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_GAP);
+    GST_BUFFER_PTS (buf) = i * 20 * GST_MSECOND;
+    GST_BUFFER_DURATION (buf) = 20 * GST_MSECOND;
+
+    fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  }
+
+  while ((buf = gst_harness_try_pull (h))) {
+    g_array_append_val (out_pts, GST_BUFFER_PTS (buf));
+    gst_buffer_unref (buf);
+  }
+
+  while ((msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT)))
+    *messages = g_list_append (*messages, msg);
+
+  gst_element_set_bus (h->element, NULL);
+  gst_object_unref (bus);
+  gst_harness_teardown (h);
+  g_rand_free (rand);
+}
+
+GST_START_TEST (test_gap_is_silence)
+{
+  GArray *zero_pts, *gap_pts;
+  GList *zero_msgs = NULL, *gap_msgs = NULL, *l, *k;
+  guint i;
+
+  zero_pts = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+  gap_pts = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+  run_removesilence (FALSE, zero_pts, &zero_msgs);
+  run_removesilence (TRUE, gap_pts, &gap_msgs);
+
+  /* some of the silence was removed */
+  fail_unless (zero_pts->len < 30);
+  fail_unless (zero_pts->len > 10);
+  fail_unless_equals_int (gap_pts->len, zero_pts->len);
+  for (i = 0; i < zero_pts->len; i++)
+    fail_unless_equals_uint64 (g_array_index (gap_pts, GstClockTime, i),
+        g_array_index (zero_pts, GstClockTime, i));
+
+  /* silence detected and finished */
+  fail_unless_equals_int (g_list_length (zero_msgs), 2);
+  fail_unless_equals_int (g_list_length (gap_msgs), 2);
+  for (l = zero_msgs, k = gap_msgs; l; l = l->next, k = k->next) {
+    const GstStructure *a = gst_message_get_structure (l->data);
+    const GstStructure *b = gst_message_get_structure (k->data);
+
+    fail_unless (gst_structure_is_equal (a, b),
+        "%" GST_PTR_FORMAT " != %" GST_PTR_FORMAT, a, b);
+  }
+
+  g_list_free_full (zero_msgs, (GDestroyNotify) gst_message_unref);
+  g_list_free_full (gap_msgs, (GDestroyNotify) gst_message_unref);
+  g_array_free (zero_pts, TRUE);
+  g_array_free (gap_pts, TRUE);
+}
+
+GST_END_TEST;
+
+static Suite *
+removesilence_suite (void)
+{
+  Suite *s = suite_create ("removesilence");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_vad_update_silence);
+  tcase_add_test (tc_chain, test_gap_is_silence);
+
+  return s;
+}
+
+GST_CHECK_MAIN (removesilence);
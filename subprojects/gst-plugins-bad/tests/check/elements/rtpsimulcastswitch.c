@@ -0,0 +1,227 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+#include <gst/rtp/gstrtpbuffer.h>
+#include <gst/video/video.h>
+
+#define OUTPUT_SSRC 0x12345678
+#define LAYER_CAPS "application/x-rtp, media=video, clock-rate=90000, " \
+    "encoding-name=VP8, payload=96"
+
+static GstBuffer *
+create_rtp_buffer (guint32 ssrc, guint16 seq, guint32 ts, GstClockTime pts)
+{
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstBuffer *buf;
+
+  buf = gst_rtp_buffer_new_allocate (16, 0, 0);
+  GST_BUFFER_PTS (buf) = pts;
+
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_WRITE, &rtp));
+  gst_rtp_buffer_set_payload_type (&rtp, 96);
+  gst_rtp_buffer_set_ssrc (&rtp, ssrc);
+  gst_rtp_buffer_set_seq (&rtp, seq);
+  gst_rtp_buffer_set_timestamp (&rtp, ts);
+  gst_rtp_buffer_unmap (&rtp);
+
+  return buf;
+}
+
+static GstBuffer *
+create_delta_rtp_buffer (guint32 ssrc, guint16 seq, guint32 ts,
+    GstClockTime pts)
+{
+  GstBuffer *buf = create_rtp_buffer (ssrc, seq, ts, pts);
+
+  GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
+
+  return buf;
+}
+
+static void
+pull_and_check (GstHarness * h, guint16 seq, guint32 ts)
+{
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstBuffer *buf;
+
+  buf = gst_harness_pull (h);
+  fail_unless (buf != NULL);
+
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp));
+  fail_unless_equals_int (gst_rtp_buffer_get_ssrc (&rtp), OUTPUT_SSRC);
+  fail_unless_equals_int (gst_rtp_buffer_get_seq (&rtp), seq);
+  fail_unless_equals_uint64 (gst_rtp_buffer_get_timestamp (&rtp), ts);
+  gst_rtp_buffer_unmap (&rtp);
+
+  gst_buffer_unref (buf);
+}
+
+static gboolean
+got_force_key_unit (GstHarness * h)
+{
+  GstEvent *event;
+  gboolean ret = FALSE;
+
+  while ((event = gst_harness_try_pull_upstream_event (h))) {
+    if (gst_video_event_is_force_key_unit (event))
+      ret = TRUE;
+    gst_event_unref (event);
+  }
+
+  return ret;
+}
+
+GST_START_TEST (test_switch_layers)
+{
+  GstElement *element;
+  GstHarness *h0, *h1;
+  GstPad *pad, *active;
+
+  element = gst_element_factory_make ("rtpsimulcastswitch", NULL);
+  g_object_set (element, "ssrc", OUTPUT_SSRC, NULL);
+
+  h0 = gst_harness_new_with_element (element, "sink_0", "src");
+  h1 = gst_harness_new_with_element (element, "sink_1", NULL);
+  gst_harness_set_src_caps_str (h0, LAYER_CAPS ", ssrc=(uint)1");
+  gst_harness_set_src_caps_str (h1, LAYER_CAPS ", ssrc=(uint)2");
+
+  /* the first layer is forwarded with its own seqnums and timestamps */
+  fail_unless_equals_int (gst_harness_push (h0,
+          create_rtp_buffer (1, 100, 3000, 0)), GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_push (h0,
+          create_rtp_buffer (1, 101, 6000, 33 * GST_MSECOND)), GST_FLOW_OK);
+  pull_and_check (h0, 100, 3000);
+  pull_and_check (h0, 101, 6000);
+
+  /* the other layer is dropped */
+  fail_unless_equals_int (gst_harness_push (h1,
+          create_rtp_buffer (2, 500, 90000, 33 * GST_MSECOND)), GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h0), 0);
+
+  pad = gst_element_get_static_pad (element, "sink_1");
+  g_object_set (element, "active-pad", pad, NULL);
+  fail_unless (got_force_key_unit (h1));
+
+  /* not switched before a frame boundary of the new layer */
+  fail_unless_equals_int (gst_harness_push (h1,
+          create_rtp_buffer (2, 501, 90000, 33 * GST_MSECOND)), GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_push (h0,
+          create_rtp_buffer (1, 102, 9000, 66 * GST_MSECOND)), GST_FLOW_OK);
+  pull_and_check (h0, 102, 9000);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h0), 0);
+
+  /* nor at a delta frame of the new layer, the old one is still forwarded */
+  fail_unless_equals_int (gst_harness_push (h1,
+          create_delta_rtp_buffer (2, 502, 93000, 66 * GST_MSECOND)),
+      GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_push (h1,
+          create_delta_rtp_buffer (2, 503, 93000, 66 * GST_MSECOND)),
+      GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_push (h0,
+          create_rtp_buffer (1, 103, 12000, 100 * GST_MSECOND)), GST_FLOW_OK);
+  pull_and_check (h0, 103, 12000);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h0), 0);
+
+  g_object_get (element, "active-pad", &active, NULL);
+  fail_unless (active != pad);
+  gst_object_unref (active);
+
+  /* keyframe on the new layer, the stream continues where it was */
+  fail_unless_equals_int (gst_harness_push (h1,
+          create_rtp_buffer (2, 504, 96000, 133 * GST_MSECOND)), GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_push (h1,
+          create_rtp_buffer (2, 505, 96000, 133 * GST_MSECOND)), GST_FLOW_OK);
+  pull_and_check (h0, 104, 12000 + 33 * 90);
+  pull_and_check (h0, 105, 12000 + 33 * 90);
+
+  g_object_get (element, "active-pad", &active, NULL);
+  fail_unless (active == pad);
+  gst_object_unref (active);
+  gst_object_unref (pad);
+
+  /* and the previous layer is now dropped */
+  fail_unless_equals_int (gst_harness_push (h0,
+          create_rtp_buffer (1, 104, 15000, 133 * GST_MSECOND)), GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h0), 0);
+
+  gst_harness_teardown (h1);
+  gst_harness_teardown (h0);
+  gst_object_unref (element);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_payload_not_copied)
+{
+  GstHarness *h;
+  GstBuffer *in, *out;
+  GstMapInfo in_map, out_map;
+
+  h = gst_harness_new_with_padnames ("rtpsimulcastswitch", "sink_0", "src");
+  g_object_set (h->element, "ssrc", OUTPUT_SSRC, NULL);
+  gst_harness_set_src_caps_str (h, LAYER_CAPS ", ssrc=(uint)1");
+
+  /* keep a reference, as a tee would for the other receivers */
+  in = create_rtp_buffer (1, 100, 3000, 0);
+  fail_unless_equals_int (gst_harness_push (h, gst_buffer_ref (in)),
+      GST_FLOW_OK);
+
+  out = gst_harness_pull (h);
+  fail_unless (out != in);
+  fail_unless_equals_int (gst_buffer_get_size (out), gst_buffer_get_size (in));
+  fail_unless_equals_int (gst_buffer_n_memory (out), 2);
+
+  /* the original packet is untouched */
+  fail_unless (gst_buffer_map (in, &in_map, GST_MAP_READ));
+  fail_unless_equals_int (GST_READ_UINT32_BE (in_map.data + 8), 1);
+
+  /* and the payload memory is shared */
+  fail_unless (gst_buffer_map_range (out, 1, 1, &out_map, GST_MAP_READ));
+  fail_unless (out_map.data == in_map.data + 12);
+  gst_buffer_unmap (out, &out_map);
+  gst_buffer_unmap (in, &in_map);
+
+  fail_unless (gst_buffer_map_range (out, 0, 1, &out_map, GST_MAP_READ));
+  fail_unless_equals_int (GST_READ_UINT32_BE (out_map.data + 8), OUTPUT_SSRC);
+  gst_buffer_unmap (out, &out_map);
+
+  gst_buffer_unref (out);
+  gst_buffer_unref (in);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+static Suite *
+rtpsimulcastswitch_suite (void)
+{
+  Suite *s = suite_create ("rtpsimulcastswitch");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_switch_layers);
+  tcase_add_test (tc_chain, test_payload_not_copied);
+
+  return s;
+}
+
+GST_CHECK_MAIN (rtpsimulcastswitch);
@@ -249,6 +249,110 @@ GST_START_TEST (test_roc)
 
 GST_END_TEST;
 
+#define LIST_RTP_CAPS \
+    "application/x-rtp, payload=(int)8, ssrc=(uint)1356955624"
+#define LIST_PACKETS 8
+#define LIST_PAYLOAD_SIZE 160
+
+static GstBuffer *
+create_list_rtp_buffer (guint seqnum, gboolean writable)
+{
+  guint8 data[12 + LIST_PAYLOAD_SIZE];
+  GstBuffer *buf;
+
+  data[0] = 0x80;
+  data[1] = 8;
+  GST_WRITE_UINT16_BE (data + 2, seqnum);
+  GST_WRITE_UINT32_BE (data + 4, seqnum * LIST_PAYLOAD_SIZE);
+  GST_WRITE_UINT32_BE (data + 8, 1356955624);
+  memset (data + 12, seqnum, LIST_PAYLOAD_SIZE);
+
+  if (!writable)
+    return gst_buffer_new_memdup (data, sizeof (data));
+
+  /* Leave room for the SRTP trailer so that it can be protected in place */
+  buf = gst_buffer_new_allocate (NULL, sizeof (data) + 64, NULL);
+  gst_buffer_fill (buf, 0, data, sizeof (data));
+  gst_buffer_set_size (buf, sizeof (data));
+
+  return buf;
+}
+
+GST_START_TEST (test_buffer_list)
+{
+  GstHarness *enc_h, *dec_h;
+  GstBufferList *list;
+  GstBuffer *buf;
+  GstCaps *caps;
+  GstMapInfo map;
+  gpointer data[LIST_PACKETS];
+  guint i;
+
+  enc_h = gst_harness_new_with_padnames ("srtpenc", "rtp_sink_0", "rtp_src_0");
+  g_object_set (enc_h->element, "random-key", TRUE, NULL);
+  gst_harness_set_src_caps_str (enc_h, LIST_RTP_CAPS);
+
+  /* Odd packets have no room for the trailer and need to be copied */
+  list = gst_buffer_list_new ();
+  for (i = 0; i < LIST_PACKETS; i++) {
+    buf = create_list_rtp_buffer (i, i % 2 == 0);
+    gst_buffer_map (buf, &map, GST_MAP_READ);
+    data[i] = map.data;
+    gst_buffer_unmap (buf, &map);
+    gst_buffer_list_add (list, buf);
+  }
+  fail_unless_equals_int (gst_pad_push_list (enc_h->srcpad, list),
+      GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (enc_h), LIST_PACKETS);
+
+  dec_h = gst_harness_new_with_padnames ("srtpdec", "rtp_sink", "rtp_src");
+  caps = gst_pad_get_current_caps (enc_h->sinkpad);
+  fail_unless (caps != NULL);
+  gst_harness_set_caps (dec_h, caps, gst_caps_from_string (LIST_RTP_CAPS));
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < LIST_PACKETS; i++) {
+    buf = gst_harness_pull (enc_h);
+    fail_unless (gst_buffer_get_size (buf) > 12 + LIST_PAYLOAD_SIZE);
+    fail_if (gst_buffer_memcmp (buf, 0, "\x80\x08", 2));
+
+    gst_buffer_map (buf, &map, GST_MAP_READ);
+    if (i % 2 == 0)
+      fail_unless (map.data == data[i]);
+    fail_if (map.data[12] == i && map.data[13] == i && map.data[14] == i);
+    gst_buffer_unmap (buf, &map);
+
+    gst_buffer_list_add (list, buf);
+  }
+
+  /* Replay one packet, it must be dropped from the list */
+  gst_buffer_list_insert (list, 2,
+      gst_buffer_copy (gst_buffer_list_get (list, 1)));
+
+  fail_unless_equals_int (gst_pad_push_list (dec_h->srcpad, list),
+      GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (dec_h), LIST_PACKETS);
+
+  for (i = 0; i < LIST_PACKETS; i++) {
+    guint j;
+
+    buf = gst_harness_pull (dec_h);
+    fail_unless_equals_int (gst_buffer_get_size (buf),
+        12 + LIST_PAYLOAD_SIZE);
+    gst_buffer_map (buf, &map, GST_MAP_READ);
+    fail_unless_equals_int (GST_READ_UINT16_BE (map.data + 2), i);
+    for (j = 12; j < map.size; j++)
+      fail_unless_equals_int (map.data[j], i);
+    gst_buffer_unmap (buf, &map);
+    gst_buffer_unref (buf);
+  }
+
+  gst_harness_teardown (dec_h);
+  gst_harness_teardown (enc_h);
+}
+
+GST_END_TEST;
+
 #ifdef HAVE_SRTP2
 
 GST_START_TEST (test_simple_mki)
@@ -395,6 +499,7 @@ srtp_suite (void)
   tcase_add_test (tc_chain, test_play);
   tcase_add_test (tc_chain, test_roc);
   tcase_add_test (tc_chain, test_play_key_error);
+  tcase_add_test (tc_chain, test_buffer_list);
 #ifdef HAVE_SRTP2
   tcase_add_test (tc_chain, test_simple_mki);
   tcase_add_test (tc_chain, test_srtpdec_multiple_mki);
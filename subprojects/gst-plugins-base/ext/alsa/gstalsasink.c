@@ -34,6 +34,14 @@
  *
  * Play an Ogg/Vorbis file and output audio via ALSA.
  *
+ * |[
+ * gst-launch-1.0 -v alsasrc low-latency=true buffer-time=2000 latency-time=500 ! alsasink low-latency=true buffer-time=2000 latency-time=500
+ * ]|
+ *
+ * Loop back the capture device to the playback device with a few
+ * milliseconds of latency. With low-latency, the device is written to
+ * directly through mmap if it supports that.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -437,6 +445,12 @@ set_hwparams (GstAlsaSink * alsa)
 
   /* choose all parameters */
   CHECK (snd_pcm_hw_params_any (alsa->handle, params), no_config);
+  /* not all devices can be mmapped, fall back to read/write for those */
+  if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED &&
+      snd_pcm_hw_params_test_access (alsa->handle, params, alsa->access) < 0) {
+    GST_INFO_OBJECT (alsa, "mmap access not available, using read/write");
+    alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  }
   /* set the interleaved read/write format */
   CHECK (snd_pcm_hw_params_set_access (alsa->handle, params, alsa->access),
       wrong_access);
@@ -725,6 +739,8 @@ set_sw_params:
 static gboolean
 alsasink_parse_spec (GstAlsaSink * alsa, GstAudioRingBufferSpec * spec)
 {
+  gboolean low_latency = FALSE;
+
   /* Initialize our boolean */
   alsa->iec958 = FALSE;
 
@@ -846,7 +862,14 @@ alsasink_parse_spec (GstAlsaSink * alsa, GstAudioRingBufferSpec * spec)
   alsa->channels = GST_AUDIO_INFO_CHANNELS (&spec->info);
   alsa->buffer_time = spec->buffer_time;
   alsa->period_time = spec->latency_time;
-  alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+
+  /* in low latency mode, write straight into the mmapped device buffer to
+   * save a copy and a syscall per period */
+  g_object_get (alsa, "low-latency", &low_latency, NULL);
+  if (low_latency && !alsa->iec958)
+    alsa->access = SND_PCM_ACCESS_MMAP_INTERLEAVED;
+  else
+    alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
 
   if (spec->type == GST_AUDIO_RING_BUFFER_FORMAT_TYPE_RAW && alsa->channels < 9)
     gst_audio_ring_buffer_set_channel_positions (GST_AUDIO_BASE_SINK
@@ -1062,13 +1085,17 @@ gst_alsasink_write (GstAudioSink * asink, gpointer data, guint length)
   GST_ALSA_SINK_LOCK (asink);
   while (cptr > 0) {
     /* start by doing a blocking wait for free space. Set the timeout
-     * to 4 times the period time */
-    err = snd_pcm_wait (alsa->handle, (4 * alsa->period_time / 1000));
+     * to 4 times the period time, but at least 1ms so that sub-millisecond
+     * periods don't end up polling */
+    err = snd_pcm_wait (alsa->handle, MAX (1, 4 * alsa->period_time / 1000));
     if (err < 0) {
       GST_DEBUG_OBJECT (asink, "wait error, %d", err);
     } else {
       GST_DELAY_SINK_LOCK (asink);
-      err = snd_pcm_writei (alsa->handle, ptr, cptr);
+      if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+        err = snd_pcm_mmap_writei (alsa->handle, ptr, cptr);
+      else
+        err = snd_pcm_writei (alsa->handle, ptr, cptr);
       GST_DELAY_SINK_UNLOCK (asink);
     }
 
@@ -87,6 +87,7 @@ GST_ELEMENT_REGISTER_DEFINE_WITH_CODE (opusdec, "opusdec",
 #define DEFAULT_USE_INBAND_FEC FALSE
 #define DEFAULT_APPLY_GAIN TRUE
 #define DEFAULT_PHASE_INVERSION FALSE
+#define DEFAULT_DTX_GAP FALSE
 
 enum
 {
@@ -95,6 +96,7 @@ enum
   PROP_APPLY_GAIN,
   PROP_PHASE_INVERSION,
   PROP_STATS,
+  PROP_DTX_GAP,
 };
 
 
@@ -168,6 +170,7 @@ gst_opus_dec_class_init (GstOpusDecClass * klass)
    *
    * * #guint64 `num-pushed`: the number of packets pushed out.
    * * #guint64 `num-gap`: the number of gap packets received.
+   * * #guint64 `num-dtx`: the number of DTX packets received (Since: 1.22)
    * * #guint64 `plc-num-samples`: the number of samples generated using PLC
    * * #guint64 `plc-duration`: the total duration, in ns, of samples generated using PLC
    * * #guint32 `bandwidth`: decoder last bandpass, in kHz, or 0 if unknown
@@ -183,6 +186,24 @@ gst_opus_dec_class_init (GstOpusDecClass * klass)
           "Various statistics", GST_TYPE_STRUCTURE,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstOpusDec:dtx-gap:
+   *
+   * Output silence flagged as %GST_BUFFER_FLAG_GAP for packets the encoder
+   * sent during discontinuous transmission (DTX), instead of the comfort
+   * noise the decoder generates for them. Downstream elements can skip
+   * processing those, which saves a lot when mixing many mostly silent
+   * streams.
+   *
+   * Only supported for single stream (mono or stereo) Opus.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_DTX_GAP,
+      g_param_spec_boolean ("dtx-gap", "DTX gap",
+          "Output DTX packets as silent GAP buffers", DEFAULT_DTX_GAP,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   GST_DEBUG_CATEGORY_INIT (opusdec_debug, "opusdec", 0,
       "opus decoding element");
 }
@@ -215,6 +236,7 @@ gst_opus_dec_init (GstOpusDec * dec)
   dec->use_inband_fec = FALSE;
   dec->apply_gain = DEFAULT_APPLY_GAIN;
   dec->phase_inversion = DEFAULT_PHASE_INVERSION;
+  dec->dtx_gap = DEFAULT_DTX_GAP;
 
   gst_audio_decoder_set_needs_format (GST_AUDIO_DECODER (dec), TRUE);
   gst_audio_decoder_set_use_default_pad_acceptcaps (GST_AUDIO_DECODER_CAST
@@ -245,6 +267,7 @@ gst_opus_dec_start (GstAudioDecoder * dec)
   GST_OBJECT_LOCK (dec);
   odec->num_pushed = 0;
   odec->num_gap = 0;
+  odec->num_dtx = 0;
   odec->plc_num_samples = 0;
   odec->plc_duration = 0;
   GST_OBJECT_UNLOCK (dec);
@@ -506,6 +529,7 @@ opus_dec_chain_parse_data (GstOpusDec * dec, GstBuffer * buffer)
   GstBuffer *buf;
   GstMapInfo map, omap;
   GstAudioClippingMeta *cmeta = NULL;
+  gboolean dtx;
 
   if (dec->state == NULL) {
     /* If we did not get any headers, default to 2 channels */
@@ -678,6 +702,17 @@ opus_dec_chain_parse_data (GstOpusDec * dec, GstBuffer * buffer)
   if (size > 0)
     dec->last_known_buffer_duration = packet_duration_opus (data, size);
 
+  /* A DTX packet is only the TOC byte with at most one byte of frame data,
+   * which the decoder conceals like a lost packet. With multiple streams
+   * there is no cheap way to tell, as each stream can be in DTX or not */
+  dtx = size > 0 && size <= 2 && dec->n_streams == 1;
+  if (dtx) {
+    GST_LOG_OBJECT (dec, "DTX packet");
+    GST_OBJECT_LOCK (dec);
+    dec->num_dtx++;
+    GST_OBJECT_UNLOCK (dec);
+  }
+
   gst_buffer_map (outbuf, &omap, GST_MAP_WRITE);
   out_data = (gint16 *) omap.data;
 
@@ -736,6 +771,13 @@ opus_dec_chain_parse_data (GstOpusDec * dec, GstBuffer * buffer)
   GST_BUFFER_DURATION (outbuf) = samples * GST_SECOND / dec->sample_rate;
   samples = n;
 
+  /* the decoder still had to run to keep its state for the packets after
+   * the DTX period */
+  if (dtx && dec->dtx_gap) {
+    gst_buffer_memset (outbuf, 0, 0, n * 2 * dec->n_channels);
+    GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
+  }
+
   cmeta = gst_buffer_get_audio_clipping_meta (buf);
 
   g_assert (!cmeta || cmeta->format == GST_FORMAT_DEFAULT);
@@ -1097,6 +1139,7 @@ gst_opus_dec_create_stats (GstOpusDec * self)
   s = gst_structure_new ("application/x-opusdec-stats",
       "num-pushed", G_TYPE_UINT64, self->num_pushed,
       "num-gap", G_TYPE_UINT64, self->num_gap,
+      "num-dtx", G_TYPE_UINT64, self->num_dtx,
       "plc-num-samples", G_TYPE_UINT64, self->plc_num_samples,
       "plc-duration", G_TYPE_UINT64, self->plc_duration,
       "bandwidth", G_TYPE_UINT, get_bandwidth (self),
@@ -1129,6 +1172,9 @@ gst_opus_dec_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_STATS:
       g_value_take_boxed (value, gst_opus_dec_create_stats (dec));
       break;
+    case PROP_DTX_GAP:
+      g_value_set_boolean (value, dec->dtx_gap);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1151,6 +1197,9 @@ gst_opus_dec_set_property (GObject * object, guint prop_id,
     case PROP_PHASE_INVERSION:
       dec->phase_inversion = g_value_get_boolean (value);
       break;
+    case PROP_DTX_GAP:
+      dec->dtx_gap = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -78,9 +78,12 @@ struct _GstOpusDec {
 
   gboolean phase_inversion;
 
+  gboolean dtx_gap;
+
   /* Used to generate the 'stats' property. Protected by object lock */
   guint64 num_pushed;
   guint64 num_gap;
+  guint64 num_dtx;
   guint64 plc_num_samples;
   guint64 plc_duration;
 };
@@ -54,9 +54,19 @@ ensure_debug_category (void)
 
 #define PRECISION_INT 10
 
+/* Number of samples mixed per output channel at once */
+#define MIX_BLOCK_SIZE 64
+
 typedef void (*MixerFunc) (GstAudioChannelMixer * mix, const gpointer src[],
     gpointer dst[], gint samples);
 
+typedef struct
+{
+  gint in;                      /* input channel */
+  gint coef_int;                /* matrix_int[in][out] */
+  gfloat coef;                  /* matrix[in][out] */
+} MixTerm;
+
 struct _GstAudioChannelMixer
 {
   gint in_channels;
@@ -70,6 +80,12 @@ struct _GstAudioChannelMixer
    * this is matrix * (2^10) as integers */
   gint **matrix_int;
 
+  /* non-zero entries of the matrix used for the sample format, ordered by
+   * output and then by input channel. Output channel i is mixed from
+   * terms[terms_offset[i]] up to terms[terms_offset[i + 1]] */
+  MixTerm *terms;
+  gint *terms_offset;
+
   MixerFunc func;
 };
 
@@ -95,6 +111,11 @@ gst_audio_channel_mixer_free (GstAudioChannelMixer * mix)
   g_free (mix->matrix_int);
   mix->matrix_int = NULL;
 
+  g_free (mix->terms);
+  mix->terms = NULL;
+  g_free (mix->terms_offset);
+  mix->terms_offset = NULL;
+
   g_slice_free (GstAudioChannelMixer, mix);
 }
 
@@ -673,6 +694,33 @@ gst_audio_channel_mixer_setup_matrix_int (GstAudioChannelMixer * mix)
   }
 }
 
+/* only call after mix->matrix_int is set up. Zero entries are skipped
+ * by the mix functions, which mostly matters for downmixes and for
+ * selecting a subset of many channels */
+static void
+gst_audio_channel_mixer_setup_terms (GstAudioChannelMixer * mix,
+    gboolean integer)
+{
+  gint i, j, n = 0;
+
+  mix->terms = g_new (MixTerm, mix->in_channels * mix->out_channels);
+  mix->terms_offset = g_new (gint, mix->out_channels + 1);
+
+  for (j = 0; j < mix->out_channels; j++) {
+    mix->terms_offset[j] = n;
+    for (i = 0; i < mix->in_channels; i++) {
+      if (integer ? mix->matrix_int[i][j] == 0 : mix->matrix[i][j] == 0.0f)
+        continue;
+
+      mix->terms[n].in = i;
+      mix->terms[n].coef_int = mix->matrix_int[i][j];
+      mix->terms[n].coef = mix->matrix[i][j];
+      n++;
+    }
+  }
+  mix->terms_offset[j] = n;
+}
+
 static gfloat **
 gst_audio_channel_mixer_setup_matrix (GstAudioChannelMixerFlags flags,
     gint in_channels, GstAudioChannelPosition * in_position,
@@ -725,32 +773,59 @@ _get_out_data_planar_##type (type * out_data[], \
   return &out_data[channel][sample]; \
 }
 
+/* The mix functions work on blocks of MIX_BLOCK_SIZE samples and calculate
+ * one output channel of a block at a time, so that the inner loops run
+ * over samples and can be vectorized by the compiler. Only the non-zero
+ * matrix entries are applied. Each output sample is still the sum of its
+ * terms in order of increasing input channel, like in the straightforward
+ * per-sample matrix multiplication, so the results are identical. */
 #define DEFINE_INTEGER_MIX_FUNC(bits, resbits, inlayout, outlayout) \
 static void \
 gst_audio_channel_mixer_mix_int##bits##_##inlayout##_##outlayout ( \
     GstAudioChannelMixer * mix, const gint##bits * in_data[], \
     gint##bits * out_data[], gint samples) \
 { \
-  gint in, out, n; \
-  gint##resbits res; \
+  gint out, n, n0, len; \
+  gint##resbits res[MIX_BLOCK_SIZE]; \
   gint inchannels, outchannels; \
+  const MixTerm *term, *end; \
   \
   inchannels = mix->in_channels; \
   outchannels = mix->out_channels; \
   \
-  for (n = 0; n < samples; n++) { \
+  for (n0 = 0; n0 < samples; n0 += MIX_BLOCK_SIZE) { \
+    len = MIN (samples - n0, MIX_BLOCK_SIZE); \
+    \
     for (out = 0; out < outchannels; out++) { \
+      term = mix->terms + mix->terms_offset[out]; \
+      end = mix->terms + mix->terms_offset[out + 1]; \
+      \
+      /* a plain copy of one input channel */ \
+      if (end - term == 1 && term->coef_int == (1 << PRECISION_INT)) { \
+        for (n = 0; n < len; n++) \
+          *_get_out_data_##outlayout##_gint##bits (out_data, n0 + n, out, \
+              outchannels) = _get_in_data_##inlayout##_gint##bits (in_data, \
+              n0 + n, term->in, inchannels); \
+        continue; \
+      } \
+      \
       /* convert */ \
-      res = 0; \
-      for (in = 0; in < inchannels; in++) \
-        res += \
-          _get_in_data_##inlayout##_gint##bits (in_data, n, in, inchannels) * \
-          (gint##resbits) mix->matrix_int[in][out]; \
+      for (n = 0; n < len; n++) \
+        res[n] = 0; \
+      for (; term < end; term++) { \
+        gint##resbits coef = term->coef_int; \
+        \
+        for (n = 0; n < len; n++) \
+          res[n] += _get_in_data_##inlayout##_gint##bits (in_data, n0 + n, \
+              term->in, inchannels) * coef; \
+      } \
       \
       /* remove factor from int matrix */ \
-      res = (res + (1 << (PRECISION_INT - 1))) >> PRECISION_INT; \
-      *_get_out_data_##outlayout##_gint##bits (out_data, n, out, outchannels) = \
-          CLAMP (res, G_MININT##bits, G_MAXINT##bits); \
+      for (n = 0; n < len; n++) { \
+        gint##resbits r = (res[n] + (1 << (PRECISION_INT - 1))) >> PRECISION_INT; \
+        *_get_out_data_##outlayout##_gint##bits (out_data, n0 + n, out, \
+            outchannels) = CLAMP (r, G_MININT##bits, G_MAXINT##bits); \
+      } \
     } \
   } \
 }
@@ -761,23 +836,35 @@ gst_audio_channel_mixer_mix_##type##_##inlayout##_##outlayout ( \
     GstAudioChannelMixer * mix, const g##type * in_data[], \
     g##type * out_data[], gint samples) \
 { \
-  gint in, out, n; \
-  g##type res; \
+  gint out, n, n0, len; \
+  g##type res[MIX_BLOCK_SIZE]; \
   gint inchannels, outchannels; \
+  const MixTerm *term, *end; \
   \
   inchannels = mix->in_channels; \
   outchannels = mix->out_channels; \
   \
-  for (n = 0; n < samples; n++) { \
+  for (n0 = 0; n0 < samples; n0 += MIX_BLOCK_SIZE) { \
+    len = MIN (samples - n0, MIX_BLOCK_SIZE); \
+    \
     for (out = 0; out < outchannels; out++) { \
+      term = mix->terms + mix->terms_offset[out]; \
+      end = mix->terms + mix->terms_offset[out + 1]; \
+      \
       /* convert */ \
-      res = 0.0; \
-      for (in = 0; in < inchannels; in++) \
-        res += \
-          _get_in_data_##inlayout##_g##type (in_data, n, in, inchannels) * \
-          mix->matrix[in][out]; \
+      for (n = 0; n < len; n++) \
+        res[n] = 0.0; \
+      for (; term < end; term++) { \
+        gfloat coef = term->coef; \
+        \
+        for (n = 0; n < len; n++) \
+          res[n] += _get_in_data_##inlayout##_g##type (in_data, n0 + n, \
+              term->in, inchannels) * coef; \
+      } \
       \
-      *_get_out_data_##outlayout##_g##type (out_data, n, out, outchannels) = res; \
+      for (n = 0; n < len; n++) \
+        *_get_out_data_##outlayout##_g##type (out_data, n0 + n, out, \
+            outchannels) = res[n]; \
     } \
   } \
 }
@@ -858,6 +945,8 @@ gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
   }
 
   gst_audio_channel_mixer_setup_matrix_int (mix);
+  gst_audio_channel_mixer_setup_terms (mix, format == GST_AUDIO_FORMAT_S16
+      || format == GST_AUDIO_FORMAT_S32);
 
 #ifndef GST_DISABLE_GST_DEBUG
   /* debug */
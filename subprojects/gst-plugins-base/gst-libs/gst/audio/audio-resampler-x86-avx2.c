@@ -0,0 +1,560 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx2.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+
+/* The number of taps is a multiple of 8, which is only half a register for
+ * gint16 and a whole one for gfloat. Taps and history are not necessarily
+ * 32 byte aligned, so unaligned loads are used everywhere. */
+
+static inline __m128
+hadd_ps_256 (__m256 v)
+{
+  __m128 s = _mm_add_ps (_mm256_castps256_ps128 (v),
+      _mm256_extractf128_ps (v, 1));
+
+  s = _mm_add_ps (s, _mm_movehl_ps (s, s));
+  return _mm_add_ss (s, _mm_shuffle_ps (s, s, 0x55));
+}
+
+static inline __m128d
+hadd_pd_256 (__m256d v)
+{
+  __m128d s = _mm_add_pd (_mm256_castpd256_pd128 (v),
+      _mm256_extractf128_pd (v, 1));
+
+  return _mm_add_sd (s, _mm_unpackhi_pd (s, s));
+}
+
+/* Folds the 8 partial sums into 4 so that each lane holds the same taps as
+ * in the SSE2 version, which keeps the integer results identical */
+static inline __m128i
+fold_epi32_256 (__m256i v)
+{
+  return _mm_add_epi32 (_mm256_castsi256_si128 (v),
+      _mm256_extracti128_si256 (v, 1));
+}
+
+static inline gint16
+round_pack_gint16 (__m128i sum)
+{
+  sum = _mm_add_epi32 (sum, _mm_shuffle_epi32 (sum, _MM_SHUFFLE (2, 3, 2, 3)));
+  sum = _mm_add_epi32 (sum, _mm_shuffle_epi32 (sum, _MM_SHUFFLE (1, 1, 1, 1)));
+
+  sum = _mm_add_epi32 (sum, _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  sum = _mm_srai_epi32 (sum, PRECISION_S16);
+  sum = _mm_packs_epi32 (sum, sum);
+  return _mm_extract_epi16 (sum, 0);
+}
+
+static inline void
+inner_product_gint16_full_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256i sum = _mm256_setzero_si256 ();
+  __m128i s;
+
+  for (; i + 16 <= len; i += 16) {
+    sum = _mm256_add_epi32 (sum,
+        _mm256_madd_epi16 (_mm256_loadu_si256 ((__m256i *) (a + i)),
+            _mm256_loadu_si256 ((__m256i *) (b + i))));
+  }
+  s = fold_epi32_256 (sum);
+  if (i < len) {
+    s = _mm_add_epi32 (s,
+        _mm_madd_epi16 (_mm_loadu_si128 ((__m128i *) (a + i)),
+            _mm_loadu_si128 ((__m128i *) (b + i))));
+  }
+
+  *o = round_pack_gint16 (s);
+}
+
+static inline void
+inner_product_gint16_linear_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256i sum[2], t;
+  __m128i s[2], t1, f;
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_si256 ();
+
+  for (; i + 16 <= len; i += 16) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum[0] = _mm256_add_epi32 (sum[0], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    sum[1] = _mm256_add_epi32 (sum[1], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+  }
+  s[0] = fold_epi32_256 (sum[0]);
+  s[1] = fold_epi32_256 (sum[1]);
+  if (i < len) {
+    t1 = _mm_loadu_si128 ((__m128i *) (a + i));
+    s[0] = _mm_add_epi32 (s[0], _mm_madd_epi16 (t1,
+            _mm_loadu_si128 ((__m128i *) (c[0] + i))));
+    s[1] = _mm_add_epi32 (s[1], _mm_madd_epi16 (t1,
+            _mm_loadu_si128 ((__m128i *) (c[1] + i))));
+  }
+
+  f = _mm_set_epi16 (0, 0, 0, 0, 0, icoeff[1], 0, icoeff[0]);
+
+  s[0] = _mm_srai_epi32 (s[0], PRECISION_S16);
+  s[1] = _mm_srai_epi32 (s[1], PRECISION_S16);
+
+  s[0] = _mm_madd_epi16 (s[0], _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0)));
+  s[1] = _mm_madd_epi16 (s[1], _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1)));
+
+  *o = round_pack_gint16 (_mm_add_epi32 (s[0], s[1]));
+}
+
+static inline void
+inner_product_gint16_cubic_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i = 0, j;
+  __m256i sum[4], t;
+  __m128i s[4], t1[4], f;
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride),
+    (gint16 *) ((gint8 *) b + 2 * bstride),
+    (gint16 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_si256 ();
+
+  for (; i + 16 <= len; i += 16) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    for (j = 0; j < 4; j++)
+      sum[j] = _mm256_add_epi32 (sum[j], _mm256_madd_epi16 (t,
+              _mm256_loadu_si256 ((__m256i *) (c[j] + i))));
+  }
+  for (j = 0; j < 4; j++)
+    s[j] = fold_epi32_256 (sum[j]);
+  if (i < len) {
+    t1[0] = _mm_loadu_si128 ((__m128i *) (a + i));
+    for (j = 0; j < 4; j++)
+      s[j] = _mm_add_epi32 (s[j], _mm_madd_epi16 (t1[0],
+              _mm_loadu_si128 ((__m128i *) (c[j] + i))));
+  }
+
+  t1[0] = _mm_unpacklo_epi32 (s[0], s[1]);
+  t1[1] = _mm_unpacklo_epi32 (s[2], s[3]);
+  t1[2] = _mm_unpackhi_epi32 (s[0], s[1]);
+  t1[3] = _mm_unpackhi_epi32 (s[2], s[3]);
+
+  s[0] = _mm_add_epi32 (_mm_unpacklo_epi64 (t1[0], t1[1]),
+      _mm_unpackhi_epi64 (t1[0], t1[1]));
+  s[2] = _mm_add_epi32 (_mm_unpacklo_epi64 (t1[2], t1[3]),
+      _mm_unpackhi_epi64 (t1[2], t1[3]));
+  s[0] = _mm_add_epi32 (s[0], s[2]);
+
+  f = _mm_set_epi16 (0, icoeff[3], 0, icoeff[2], 0, icoeff[1], 0, icoeff[0]);
+
+  s[0] = _mm_srai_epi32 (s[0], PRECISION_S16);
+  s[0] = _mm_madd_epi16 (s[0], f);
+
+  *o = round_pack_gint16 (s[0]);
+}
+
+static inline void
+inner_product_gfloat_full_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[2];
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  for (; i + 16 <= len; i += 16) {
+    sum[0] = _mm256_fmadd_ps (_mm256_loadu_ps (a + i + 0),
+        _mm256_loadu_ps (b + i + 0), sum[0]);
+    sum[1] = _mm256_fmadd_ps (_mm256_loadu_ps (a + i + 8),
+        _mm256_loadu_ps (b + i + 8), sum[1]);
+  }
+  if (i < len)
+    sum[0] = _mm256_fmadd_ps (_mm256_loadu_ps (a + i),
+        _mm256_loadu_ps (b + i), sum[0]);
+
+  _mm_store_ss (o, hadd_ps_256 (_mm256_add_ps (sum[0], sum[1])));
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[2], t;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  for (; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm256_fmadd_ps (_mm256_sub_ps (sum[0], sum[1]),
+      _mm256_broadcast_ss (icoeff), sum[1]);
+
+  _mm_store_ss (o, hadd_ps_256 (sum[0]));
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[4], t;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_ps ();
+
+  for (; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+    sum[2] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[2] + i), sum[2]);
+    sum[3] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm256_mul_ps (sum[0], _mm256_broadcast_ss (icoeff + 0));
+  sum[0] = _mm256_fmadd_ps (sum[1], _mm256_broadcast_ss (icoeff + 1), sum[0]);
+  sum[0] = _mm256_fmadd_ps (sum[2], _mm256_broadcast_ss (icoeff + 2), sum[0]);
+  sum[0] = _mm256_fmadd_ps (sum[3], _mm256_broadcast_ss (icoeff + 3), sum[0]);
+
+  _mm_store_ss (o, hadd_ps_256 (sum[0]));
+}
+
+static inline void
+inner_product_gdouble_full_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum[2];
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (; i < len; i += 8) {
+    sum[0] = _mm256_fmadd_pd (_mm256_loadu_pd (a + i + 0),
+        _mm256_loadu_pd (b + i + 0), sum[0]);
+    sum[1] = _mm256_fmadd_pd (_mm256_loadu_pd (a + i + 4),
+        _mm256_loadu_pd (b + i + 4), sum[1]);
+  }
+
+  _mm_store_sd (o, hadd_pd_256 (_mm256_add_pd (sum[0], sum[1])));
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum[2], t;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm256_fmadd_pd (_mm256_sub_pd (sum[0], sum[1]),
+      _mm256_broadcast_sd (icoeff), sum[1]);
+
+  _mm_store_sd (o, hadd_pd_256 (sum[0]));
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256d sum[4], t;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride),
+    (gdouble *) ((gint8 *) b + 2 * bstride),
+    (gdouble *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_pd ();
+
+  for (; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum[1]);
+    sum[2] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[2] + i), sum[2]);
+    sum[3] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm256_mul_pd (sum[0], _mm256_broadcast_sd (icoeff + 0));
+  sum[0] = _mm256_fmadd_pd (sum[1], _mm256_broadcast_sd (icoeff + 1), sum[0]);
+  sum[0] = _mm256_fmadd_pd (sum[2], _mm256_broadcast_sd (icoeff + 2), sum[0]);
+  sum[0] = _mm256_fmadd_pd (sum[3], _mm256_broadcast_sd (icoeff + 3), sum[0]);
+
+  _mm_store_sd (o, hadd_pd_256 (sum[0]));
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx2);
+
+static inline __m128i
+interpolate_gint16_round (__m128i t1, __m128i t2)
+{
+  t1 = _mm_add_epi32 (t1, _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  t2 = _mm_add_epi32 (t2, _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+
+  t1 = _mm_srai_epi32 (t1, PRECISION_S16);
+  t2 = _mm_srai_epi32 (t2, PRECISION_S16);
+
+  return _mm_packs_epi32 (t1, t2);
+}
+
+static inline __m256i
+interpolate_gint16_round_256 (__m256i t1, __m256i t2)
+{
+  t1 = _mm256_add_epi32 (t1, _mm256_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  t2 = _mm256_add_epi32 (t2, _mm256_set1_epi32 (1 << (PRECISION_S16 - 1)));
+
+  t1 = _mm256_srai_epi32 (t1, PRECISION_S16);
+  t2 = _mm256_srai_epi32 (t2, PRECISION_S16);
+
+  /* unpack and pack both work within 128 bit lanes, so the order of the
+   * samples is preserved */
+  return _mm256_packs_epi32 (t1, t2);
+}
+
+/* A pair of 16 bit coefficients, as multiplied by madd */
+#define COEFF_PAIR(ic,i) \
+    ((gint) (((guint32) (guint16) (ic)[(i) + 1] << 16) | (guint16) (ic)[(i)]))
+
+void
+interpolate_gint16_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i = 0;
+  gint16 *o = op, *a = ap, *ic = icp;
+  __m256i ta, tb, f;
+  __m128i sa, sb;
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) a + 0 * astride),
+    (gint16 *) ((gint8 *) a + 1 * astride)
+  };
+
+  f = _mm256_set1_epi32 (COEFF_PAIR (ic, 0));
+
+  for (; i + 16 <= len; i += 16) {
+    ta = _mm256_loadu_si256 ((__m256i *) (c[0] + i));
+    tb = _mm256_loadu_si256 ((__m256i *) (c[1] + i));
+
+    _mm256_storeu_si256 ((__m256i *) (o + i),
+        interpolate_gint16_round_256 (_mm256_madd_epi16 (_mm256_unpacklo_epi16
+                (ta, tb), f), _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta,
+                    tb), f)));
+  }
+  if (i < len) {
+    sa = _mm_loadu_si128 ((__m128i *) (c[0] + i));
+    sb = _mm_loadu_si128 ((__m128i *) (c[1] + i));
+
+    _mm_storeu_si128 ((__m128i *) (o + i),
+        interpolate_gint16_round (_mm_madd_epi16 (_mm_unpacklo_epi16 (sa, sb),
+                _mm256_castsi256_si128 (f)),
+            _mm_madd_epi16 (_mm_unpackhi_epi16 (sa, sb),
+                _mm256_castsi256_si128 (f))));
+  }
+}
+
+void
+interpolate_gint16_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i = 0;
+  gint16 *o = op, *a = ap, *ic = icp;
+  __m256i ta, tb, tl, th, f[2];
+  __m128i sa, sb, sl, sh;
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) a + 0 * astride),
+    (gint16 *) ((gint8 *) a + 1 * astride),
+    (gint16 *) ((gint8 *) a + 2 * astride),
+    (gint16 *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_set1_epi32 (COEFF_PAIR (ic, 0));
+  f[1] = _mm256_set1_epi32 (COEFF_PAIR (ic, 2));
+
+  for (; i + 16 <= len; i += 16) {
+    ta = _mm256_loadu_si256 ((__m256i *) (c[0] + i));
+    tb = _mm256_loadu_si256 ((__m256i *) (c[1] + i));
+
+    tl = _mm256_madd_epi16 (_mm256_unpacklo_epi16 (ta, tb), f[0]);
+    th = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta, tb), f[0]);
+
+    ta = _mm256_loadu_si256 ((__m256i *) (c[2] + i));
+    tb = _mm256_loadu_si256 ((__m256i *) (c[3] + i));
+
+    tl = _mm256_add_epi32 (tl,
+        _mm256_madd_epi16 (_mm256_unpacklo_epi16 (ta, tb), f[1]));
+    th = _mm256_add_epi32 (th,
+        _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta, tb), f[1]));
+
+    _mm256_storeu_si256 ((__m256i *) (o + i),
+        interpolate_gint16_round_256 (tl, th));
+  }
+  if (i < len) {
+    sa = _mm_loadu_si128 ((__m128i *) (c[0] + i));
+    sb = _mm_loadu_si128 ((__m128i *) (c[1] + i));
+
+    sl = _mm_madd_epi16 (_mm_unpacklo_epi16 (sa, sb),
+        _mm256_castsi256_si128 (f[0]));
+    sh = _mm_madd_epi16 (_mm_unpackhi_epi16 (sa, sb),
+        _mm256_castsi256_si128 (f[0]));
+
+    sa = _mm_loadu_si128 ((__m128i *) (c[2] + i));
+    sb = _mm_loadu_si128 ((__m128i *) (c[3] + i));
+
+    sl = _mm_add_epi32 (sl, _mm_madd_epi16 (_mm_unpacklo_epi16 (sa, sb),
+            _mm256_castsi256_si128 (f[1])));
+    sh = _mm_add_epi32 (sh, _mm_madd_epi16 (_mm_unpackhi_epi16 (sa, sb),
+            _mm256_castsi256_si128 (f[1])));
+
+    _mm_storeu_si128 ((__m128i *) (o + i), interpolate_gint16_round (sl, sh));
+  }
+}
+
+void
+interpolate_gfloat_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[2], t;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm256_broadcast_ss (ic + 0);
+  f[1] = _mm256_broadcast_ss (ic + 1);
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_mul_ps (_mm256_loadu_ps (c[0] + i), f[0]);
+    t = _mm256_fmadd_ps (_mm256_loadu_ps (c[1] + i), f[1], t);
+    _mm256_storeu_ps (o + i, t);
+  }
+}
+
+void
+interpolate_gfloat_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[4], t;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride),
+    (gfloat *) ((gint8 *) a + 2 * astride),
+    (gfloat *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_broadcast_ss (ic + 0);
+  f[1] = _mm256_broadcast_ss (ic + 1);
+  f[2] = _mm256_broadcast_ss (ic + 2);
+  f[3] = _mm256_broadcast_ss (ic + 3);
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_mul_ps (_mm256_loadu_ps (c[0] + i), f[0]);
+    t = _mm256_fmadd_ps (_mm256_loadu_ps (c[1] + i), f[1], t);
+    t = _mm256_fmadd_ps (_mm256_loadu_ps (c[2] + i), f[2], t);
+    t = _mm256_fmadd_ps (_mm256_loadu_ps (c[3] + i), f[3], t);
+    _mm256_storeu_ps (o + i, t);
+  }
+}
+
+void
+interpolate_gdouble_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m256d f[2], t;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm256_broadcast_sd (ic + 0);
+  f[1] = _mm256_broadcast_sd (ic + 1);
+
+  for (i = 0; i < len; i += 4) {
+    t = _mm256_mul_pd (_mm256_loadu_pd (c[0] + i), f[0]);
+    t = _mm256_fmadd_pd (_mm256_loadu_pd (c[1] + i), f[1], t);
+    _mm256_storeu_pd (o + i, t);
+  }
+}
+
+void
+interpolate_gdouble_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m256d f[4], t;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride),
+    (gdouble *) ((gint8 *) a + 2 * astride),
+    (gdouble *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_broadcast_sd (ic + 0);
+  f[1] = _mm256_broadcast_sd (ic + 1);
+  f[2] = _mm256_broadcast_sd (ic + 2);
+  f[3] = _mm256_broadcast_sd (ic + 3);
+
+  for (i = 0; i < len; i += 4) {
+    t = _mm256_mul_pd (_mm256_loadu_pd (c[0] + i), f[0]);
+    t = _mm256_fmadd_pd (_mm256_loadu_pd (c[1] + i), f[1], t);
+    t = _mm256_fmadd_pd (_mm256_loadu_pd (c[2] + i), f[2], t);
+    t = _mm256_fmadd_pd (_mm256_loadu_pd (c[3] + i), f[3], t);
+    _mm256_storeu_pd (o + i, t);
+  }
+}
+
+#endif
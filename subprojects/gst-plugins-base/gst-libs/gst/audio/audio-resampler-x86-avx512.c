@@ -0,0 +1,305 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx512.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined(__AVX512F__)
+#include <immintrin.h>
+
+/* The number of taps is a multiple of 8, so for gfloat there can be half a
+ * register left at the end, which is handled with a masked load */
+#define HALF_MASK ((__mmask16) 0x00ff)
+
+static inline void
+inner_product_gfloat_full_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m512 sum[2];
+
+  sum[0] = sum[1] = _mm512_setzero_ps ();
+
+  for (; i + 32 <= len; i += 32) {
+    sum[0] = _mm512_fmadd_ps (_mm512_loadu_ps (a + i + 0),
+        _mm512_loadu_ps (b + i + 0), sum[0]);
+    sum[1] = _mm512_fmadd_ps (_mm512_loadu_ps (a + i + 16),
+        _mm512_loadu_ps (b + i + 16), sum[1]);
+  }
+  for (; i + 16 <= len; i += 16)
+    sum[0] = _mm512_fmadd_ps (_mm512_loadu_ps (a + i),
+        _mm512_loadu_ps (b + i), sum[0]);
+  if (i < len)
+    sum[1] = _mm512_fmadd_ps (_mm512_maskz_loadu_ps (HALF_MASK, a + i),
+        _mm512_maskz_loadu_ps (HALF_MASK, b + i), sum[1]);
+
+  *o = _mm512_reduce_add_ps (_mm512_add_ps (sum[0], sum[1]));
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m512 sum[2], t;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_ps ();
+
+  for (; i + 16 <= len; i += 16) {
+    t = _mm512_loadu_ps (a + i);
+    sum[0] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[1] + i), sum[1]);
+  }
+  if (i < len) {
+    t = _mm512_maskz_loadu_ps (HALF_MASK, a + i);
+    sum[0] = _mm512_fmadd_ps (t,
+        _mm512_maskz_loadu_ps (HALF_MASK, c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_ps (t,
+        _mm512_maskz_loadu_ps (HALF_MASK, c[1] + i), sum[1]);
+  }
+  sum[0] = _mm512_fmadd_ps (_mm512_sub_ps (sum[0], sum[1]),
+      _mm512_set1_ps (icoeff[0]), sum[1]);
+
+  *o = _mm512_reduce_add_ps (sum[0]);
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0, j;
+  __m512 sum[4], t;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_ps ();
+
+  for (; i + 16 <= len; i += 16) {
+    t = _mm512_loadu_ps (a + i);
+    for (j = 0; j < 4; j++)
+      sum[j] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[j] + i), sum[j]);
+  }
+  if (i < len) {
+    t = _mm512_maskz_loadu_ps (HALF_MASK, a + i);
+    for (j = 0; j < 4; j++)
+      sum[j] = _mm512_fmadd_ps (t,
+          _mm512_maskz_loadu_ps (HALF_MASK, c[j] + i), sum[j]);
+  }
+  sum[0] = _mm512_mul_ps (sum[0], _mm512_set1_ps (icoeff[0]));
+  sum[0] = _mm512_fmadd_ps (sum[1], _mm512_set1_ps (icoeff[1]), sum[0]);
+  sum[0] = _mm512_fmadd_ps (sum[2], _mm512_set1_ps (icoeff[2]), sum[0]);
+  sum[0] = _mm512_fmadd_ps (sum[3], _mm512_set1_ps (icoeff[3]), sum[0]);
+
+  *o = _mm512_reduce_add_ps (sum[0]);
+}
+
+static inline void
+inner_product_gdouble_full_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m512d sum[2];
+
+  sum[0] = sum[1] = _mm512_setzero_pd ();
+
+  for (; i + 16 <= len; i += 16) {
+    sum[0] = _mm512_fmadd_pd (_mm512_loadu_pd (a + i + 0),
+        _mm512_loadu_pd (b + i + 0), sum[0]);
+    sum[1] = _mm512_fmadd_pd (_mm512_loadu_pd (a + i + 8),
+        _mm512_loadu_pd (b + i + 8), sum[1]);
+  }
+  if (i < len)
+    sum[0] = _mm512_fmadd_pd (_mm512_loadu_pd (a + i),
+        _mm512_loadu_pd (b + i), sum[0]);
+
+  *o = _mm512_reduce_add_pd (_mm512_add_pd (sum[0], sum[1]));
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m512d sum[2], t;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_pd ();
+
+  for (; i < len; i += 8) {
+    t = _mm512_loadu_pd (a + i);
+    sum[0] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm512_fmadd_pd (_mm512_sub_pd (sum[0], sum[1]),
+      _mm512_set1_pd (icoeff[0]), sum[1]);
+
+  *o = _mm512_reduce_add_pd (sum[0]);
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m512d sum[4], t;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride),
+    (gdouble *) ((gint8 *) b + 2 * bstride),
+    (gdouble *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_pd ();
+
+  for (; i < len; i += 8) {
+    t = _mm512_loadu_pd (a + i);
+    sum[0] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[1] + i), sum[1]);
+    sum[2] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[2] + i), sum[2]);
+    sum[3] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm512_mul_pd (sum[0], _mm512_set1_pd (icoeff[0]));
+  sum[0] = _mm512_fmadd_pd (sum[1], _mm512_set1_pd (icoeff[1]), sum[0]);
+  sum[0] = _mm512_fmadd_pd (sum[2], _mm512_set1_pd (icoeff[2]), sum[0]);
+  sum[0] = _mm512_fmadd_pd (sum[3], _mm512_set1_pd (icoeff[3]), sum[0]);
+
+  *o = _mm512_reduce_add_pd (sum[0]);
+}
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx512);
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx512);
+
+void
+interpolate_gfloat_linear_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i = 0;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m512 f[2], t;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm512_set1_ps (ic[0]);
+  f[1] = _mm512_set1_ps (ic[1]);
+
+  for (; i + 16 <= len; i += 16) {
+    t = _mm512_mul_ps (_mm512_loadu_ps (c[0] + i), f[0]);
+    t = _mm512_fmadd_ps (_mm512_loadu_ps (c[1] + i), f[1], t);
+    _mm512_storeu_ps (o + i, t);
+  }
+  if (i < len) {
+    t = _mm512_mul_ps (_mm512_maskz_loadu_ps (HALF_MASK, c[0] + i), f[0]);
+    t = _mm512_fmadd_ps (_mm512_maskz_loadu_ps (HALF_MASK, c[1] + i), f[1], t);
+    _mm512_mask_storeu_ps (o + i, HALF_MASK, t);
+  }
+}
+
+void
+interpolate_gfloat_cubic_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i = 0, j;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m512 f[4], t;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride),
+    (gfloat *) ((gint8 *) a + 2 * astride),
+    (gfloat *) ((gint8 *) a + 3 * astride)
+  };
+
+  for (j = 0; j < 4; j++)
+    f[j] = _mm512_set1_ps (ic[j]);
+
+  for (; i + 16 <= len; i += 16) {
+    t = _mm512_mul_ps (_mm512_loadu_ps (c[0] + i), f[0]);
+    for (j = 1; j < 4; j++)
+      t = _mm512_fmadd_ps (_mm512_loadu_ps (c[j] + i), f[j], t);
+    _mm512_storeu_ps (o + i, t);
+  }
+  if (i < len) {
+    t = _mm512_mul_ps (_mm512_maskz_loadu_ps (HALF_MASK, c[0] + i), f[0]);
+    for (j = 1; j < 4; j++)
+      t = _mm512_fmadd_ps (_mm512_maskz_loadu_ps (HALF_MASK, c[j] + i), f[j],
+          t);
+    _mm512_mask_storeu_ps (o + i, HALF_MASK, t);
+  }
+}
+
+void
+interpolate_gdouble_linear_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m512d f[2], t;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm512_set1_pd (ic[0]);
+  f[1] = _mm512_set1_pd (ic[1]);
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm512_mul_pd (_mm512_loadu_pd (c[0] + i), f[0]);
+    t = _mm512_fmadd_pd (_mm512_loadu_pd (c[1] + i), f[1], t);
+    _mm512_storeu_pd (o + i, t);
+  }
+}
+
+void
+interpolate_gdouble_cubic_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i, j;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m512d f[4], t;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride),
+    (gdouble *) ((gint8 *) a + 2 * astride),
+    (gdouble *) ((gint8 *) a + 3 * astride)
+  };
+
+  for (j = 0; j < 4; j++)
+    f[j] = _mm512_set1_pd (ic[j]);
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm512_mul_pd (_mm512_loadu_pd (c[0] + i), f[0]);
+    for (j = 1; j < 4; j++)
+      t = _mm512_fmadd_pd (_mm512_loadu_pd (c[j] + i), f[j], t);
+    _mm512_storeu_pd (o + i, t);
+  }
+}
+
+#endif
@@ -47,6 +47,13 @@
  * All scheduling of samples and timestamps is done in this base class
  * together with #GstAudioBaseSink using a default implementation of a
  * #GstAudioRingBuffer that uses threads.
+ *
+ * For low latency playback, #GstAudioSink:low-latency runs the thread that
+ * writes to the device with real-time priority. Together with a small
+ * #GstAudioBaseSink:latency-time (down to fractions of a millisecond) and
+ * #GstAudioBaseSink:buffer-time this allows for device latencies of a few
+ * milliseconds. How well the thread keeps up can be checked with
+ * #GstAudioSink:stats.
  */
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -99,6 +106,26 @@ struct _GstAudioSinkRingBufferClass
   GstAudioRingBufferClass parent_class;
 };
 
+typedef struct _GstAudioSinkPrivate GstAudioSinkPrivate;
+
+struct _GstAudioSinkPrivate
+{
+  /* with OBJECT_LOCK */
+  gboolean low_latency;
+
+  /* with stats_lock */
+  GMutex stats_lock;
+  gboolean realtime;
+  GstClockTime segment_duration;
+  guint64 segments;
+  GstClockTime last_segment;
+  GstClockTime max_jitter;
+  GstClockTime total_jitter;
+  guint64 n_jitter;
+};
+
+static GstAudioSinkPrivate *gst_audio_sink_get_priv (GstAudioSink * sink);
+
 static void gst_audio_sink_ring_buffer_class_init (GstAudioSinkRingBufferClass *
     klass);
 static void gst_audio_sink_ring_buffer_init (GstAudioSinkRingBuffer *
@@ -191,6 +218,42 @@ gst_audio_sink_ring_buffer_class_init (GstAudioSinkRingBufferClass * klass)
 
 typedef gint (*WriteFunc) (GstAudioSink * sink, gpointer data, guint length);
 
+/* called from the ringbuffer thread after every segment. The jitter is how
+ * far the time between two segments is off from the segment duration, which
+ * is what the device expects when it is fed at the right rate */
+static void
+gst_audio_sink_update_stats (GstAudioSinkPrivate * priv, GstClockTime now)
+{
+  g_mutex_lock (&priv->stats_lock);
+  priv->segments++;
+  if (GST_CLOCK_TIME_IS_VALID (priv->last_segment)) {
+    GstClockTime interval = now - priv->last_segment, jitter;
+
+    if (interval > priv->segment_duration)
+      jitter = interval - priv->segment_duration;
+    else
+      jitter = priv->segment_duration - interval;
+
+    priv->max_jitter = MAX (priv->max_jitter, jitter);
+    priv->total_jitter += jitter;
+    priv->n_jitter++;
+  }
+  priv->last_segment = now;
+  g_mutex_unlock (&priv->stats_lock);
+}
+
+static void
+gst_audio_sink_reset_stats (GstAudioSinkPrivate * priv)
+{
+  g_mutex_lock (&priv->stats_lock);
+  priv->segments = 0;
+  priv->last_segment = GST_CLOCK_TIME_NONE;
+  priv->max_jitter = 0;
+  priv->total_jitter = 0;
+  priv->n_jitter = 0;
+  g_mutex_unlock (&priv->stats_lock);
+}
+
 /* this internal thread does nothing else but write samples to the audio device.
  * It will write each segment in the ringbuffer and will update the play
  * pointer.
@@ -202,13 +265,16 @@ audioringbuffer_thread_func (GstAudioRingBuffer * buf)
   GstAudioSink *sink;
   GstAudioSinkClass *csink;
   GstAudioSinkRingBuffer *abuf = GST_AUDIO_SINK_RING_BUFFER_CAST (buf);
+  GstAudioSinkPrivate *priv;
   WriteFunc writefunc;
   GstMessage *message;
   GValue val = { 0 };
   gpointer handle;
+  gboolean low_latency, realtime = FALSE;
 
   sink = GST_AUDIO_SINK (GST_OBJECT_PARENT (buf));
   csink = GST_AUDIO_SINK_GET_CLASS (sink);
+  priv = gst_audio_sink_get_priv (sink);
 
   GST_DEBUG_OBJECT (sink, "enter thread");
 
@@ -221,9 +287,22 @@ audioringbuffer_thread_func (GstAudioRingBuffer * buf)
   if (writefunc == NULL)
     goto no_function;
 
-  if (G_UNLIKELY (!__gst_audio_set_thread_priority (&handle)))
+  GST_OBJECT_LOCK (sink);
+  low_latency = priv->low_latency;
+  GST_OBJECT_UNLOCK (sink);
+
+  if (low_latency) {
+    realtime = __gst_audio_set_thread_realtime (&handle);
+    if (G_UNLIKELY (!realtime))
+      GST_WARNING_OBJECT (sink, "failed to set real-time thread priority");
+  }
+  if (!realtime && G_UNLIKELY (!__gst_audio_set_thread_priority (&handle)))
     GST_WARNING_OBJECT (sink, "failed to set thread priority");
 
+  g_mutex_lock (&priv->stats_lock);
+  priv->realtime = realtime;
+  g_mutex_unlock (&priv->stats_lock);
+
   message = gst_message_new_stream_status (GST_OBJECT_CAST (buf),
       GST_STREAM_STATUS_TYPE_ENTER, GST_ELEMENT_CAST (sink));
   g_value_init (&val, GST_TYPE_G_THREAD);
@@ -267,7 +346,14 @@ audioringbuffer_thread_func (GstAudioRingBuffer * buf)
 
       /* we wrote one segment */
       gst_audio_ring_buffer_advance (buf, 1);
+
+      gst_audio_sink_update_stats (priv, gst_util_get_timestamp ());
     } else {
+      /* don't count the time we were not running as jitter */
+      g_mutex_lock (&priv->stats_lock);
+      priv->last_segment = GST_CLOCK_TIME_NONE;
+      g_mutex_unlock (&priv->stats_lock);
+
       GST_OBJECT_LOCK (abuf);
       if (!abuf->running)
         goto stop_running;
@@ -399,10 +485,12 @@ gst_audio_sink_ring_buffer_acquire (GstAudioRingBuffer * buf,
 {
   GstAudioSink *sink;
   GstAudioSinkClass *csink;
+  GstAudioSinkPrivate *priv;
   gboolean result = FALSE;
 
   sink = GST_AUDIO_SINK (GST_OBJECT_PARENT (buf));
   csink = GST_AUDIO_SINK_GET_CLASS (sink);
+  priv = gst_audio_sink_get_priv (sink);
 
   if (csink->prepare)
     result = csink->prepare (sink, spec);
@@ -412,6 +500,11 @@ gst_audio_sink_ring_buffer_acquire (GstAudioRingBuffer * buf,
   /* set latency to one more segment as we need some headroom */
   spec->seglatency = spec->segtotal + 1;
 
+  gst_audio_sink_reset_stats (priv);
+  g_mutex_lock (&priv->stats_lock);
+  priv->segment_duration = spec->latency_time * GST_USECOND;
+  g_mutex_unlock (&priv->stats_lock);
+
   buf->size = spec->segtotal * spec->segsize;
 
   buf->memory = g_malloc (buf->size);
@@ -646,9 +739,13 @@ enum
   LAST_SIGNAL
 };
 
+#define DEFAULT_LOW_LATENCY FALSE
+
 enum
 {
   ARG_0,
+  ARG_LOW_LATENCY,
+  ARG_STATS,
 };
 
 #define _do_init \
@@ -657,18 +754,72 @@ enum
         sizeof (GstAudioSinkClassExtension));
 #define gst_audio_sink_parent_class parent_class
 G_DEFINE_TYPE_WITH_CODE (GstAudioSink, gst_audio_sink,
-    GST_TYPE_AUDIO_BASE_SINK, _do_init);
+    GST_TYPE_AUDIO_BASE_SINK, G_ADD_PRIVATE (GstAudioSink) _do_init);
 
 static GstAudioRingBuffer *gst_audio_sink_create_ringbuffer (GstAudioBaseSink *
     sink);
+static void gst_audio_sink_finalize (GObject * object);
+static void gst_audio_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_audio_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
+static GstAudioSinkPrivate *
+gst_audio_sink_get_priv (GstAudioSink * sink)
+{
+  return gst_audio_sink_get_instance_private (sink);
+}
 
 static void
 gst_audio_sink_class_init (GstAudioSinkClass * klass)
 {
+  GObjectClass *gobject_class;
   GstAudioBaseSinkClass *gstaudiobasesink_class;
 
+  gobject_class = (GObjectClass *) klass;
   gstaudiobasesink_class = (GstAudioBaseSinkClass *) klass;
 
+  gobject_class->finalize = gst_audio_sink_finalize;
+  gobject_class->set_property = gst_audio_sink_set_property;
+  gobject_class->get_property = gst_audio_sink_get_property;
+
+  /**
+   * GstAudioSink:low-latency:
+   *
+   * Run the thread that writes to the device with real-time priority
+   * (SCHED_FIFO on POSIX systems, which needs the appropriate privileges).
+   * Falls back to the normal increased priority if that is not possible.
+   * Takes effect the next time the device is prepared.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, ARG_LOW_LATENCY,
+      g_param_spec_boolean ("low-latency", "Low Latency",
+          "Use real-time priority for writing to the device",
+          DEFAULT_LOW_LATENCY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioSink:stats:
+   *
+   * Statistics about the thread that writes to the device, in a
+   * `application/x-audio-sink-stats` structure with these fields:
+   *
+   * * `realtime` (#gboolean): whether the thread runs with real-time priority
+   * * `segment-duration` (#guint64): duration of a segment in nanoseconds
+   * * `segments` (#guint64): segments written since the device was prepared
+   * * `max-jitter` (#guint64): largest difference in nanoseconds between the
+   *   time it took to write a segment and the segment duration
+   * * `average-jitter` (#guint64): average of the above
+   * * `device-delay` (#guint64): nanoseconds of audio written to the device
+   *   but not played yet
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, ARG_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Statistics about writing to the device", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gstaudiobasesink_class->create_ringbuffer =
       GST_DEBUG_FUNCPTR (gst_audio_sink_create_ringbuffer);
 
@@ -681,6 +832,99 @@ gst_audio_sink_class_init (GstAudioSinkClass * klass)
 static void
 gst_audio_sink_init (GstAudioSink * audiosink)
 {
+  GstAudioSinkPrivate *priv = gst_audio_sink_get_priv (audiosink);
+
+  priv->low_latency = DEFAULT_LOW_LATENCY;
+  g_mutex_init (&priv->stats_lock);
+  priv->last_segment = GST_CLOCK_TIME_NONE;
+}
+
+static void
+gst_audio_sink_finalize (GObject * object)
+{
+  GstAudioSinkPrivate *priv = gst_audio_sink_get_priv (GST_AUDIO_SINK (object));
+
+  g_mutex_clear (&priv->stats_lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static GstStructure *
+gst_audio_sink_get_stats (GstAudioSink * sink)
+{
+  GstAudioSinkPrivate *priv = gst_audio_sink_get_priv (sink);
+  GstAudioRingBuffer *ringbuffer;
+  GstClockTime delay = 0;
+  GstStructure *s;
+
+  GST_OBJECT_LOCK (sink);
+  ringbuffer = GST_AUDIO_BASE_SINK (sink)->ringbuffer;
+  if (ringbuffer)
+    gst_object_ref (ringbuffer);
+  GST_OBJECT_UNLOCK (sink);
+
+  if (ringbuffer) {
+    gint rate = GST_AUDIO_INFO_RATE (&ringbuffer->spec.info);
+
+    if (gst_audio_ring_buffer_is_acquired (ringbuffer) && rate > 0)
+      delay = gst_util_uint64_scale_int (gst_audio_ring_buffer_delay
+          (ringbuffer), GST_SECOND, rate);
+    gst_object_unref (ringbuffer);
+  }
+
+  g_mutex_lock (&priv->stats_lock);
+  s = gst_structure_new ("application/x-audio-sink-stats",
+      "realtime", G_TYPE_BOOLEAN, priv->realtime,
+      "segment-duration", G_TYPE_UINT64, priv->segment_duration,
+      "segments", G_TYPE_UINT64, priv->segments,
+      "max-jitter", G_TYPE_UINT64, priv->max_jitter,
+      "average-jitter", G_TYPE_UINT64,
+      priv->n_jitter ? priv->total_jitter / priv->n_jitter : 0,
+      "device-delay", G_TYPE_UINT64, delay, NULL);
+  g_mutex_unlock (&priv->stats_lock);
+
+  return s;
+}
+
+static void
+gst_audio_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstAudioSink *sink = GST_AUDIO_SINK (object);
+  GstAudioSinkPrivate *priv = gst_audio_sink_get_priv (sink);
+
+  switch (prop_id) {
+    case ARG_LOW_LATENCY:
+      GST_OBJECT_LOCK (sink);
+      priv->low_latency = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_audio_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstAudioSink *sink = GST_AUDIO_SINK (object);
+  GstAudioSinkPrivate *priv = gst_audio_sink_get_priv (sink);
+
+  switch (prop_id) {
+    case ARG_LOW_LATENCY:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_boolean (value, priv->low_latency);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case ARG_STATS:
+      g_value_take_boxed (value, gst_audio_sink_get_stats (sink));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
 }
 
 static GstAudioRingBuffer *
@@ -40,6 +40,10 @@
  * All scheduling of samples and timestamps is done in this base class
  * together with #GstAudioBaseSrc using a default implementation of a
  * #GstAudioRingBuffer that uses threads.
+ *
+ * For low latency capture, #GstAudioSrc:low-latency runs the thread that
+ * reads from the device with real-time priority, see #GstAudioSink for
+ * details.
  */
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -90,6 +94,26 @@ struct _GstAudioSrcRingBufferClass
   GstAudioRingBufferClass parent_class;
 };
 
+typedef struct _GstAudioSrcPrivate GstAudioSrcPrivate;
+
+struct _GstAudioSrcPrivate
+{
+  /* with OBJECT_LOCK */
+  gboolean low_latency;
+
+  /* with stats_lock */
+  GMutex stats_lock;
+  gboolean realtime;
+  GstClockTime segment_duration;
+  guint64 segments;
+  GstClockTime last_segment;
+  GstClockTime max_jitter;
+  GstClockTime total_jitter;
+  guint64 n_jitter;
+};
+
+static GstAudioSrcPrivate *gst_audio_src_get_priv (GstAudioSrc * src);
+
 static void gst_audio_src_ring_buffer_class_init (GstAudioSrcRingBufferClass *
     klass);
 static void gst_audio_src_ring_buffer_init (GstAudioSrcRingBuffer * ringbuffer,
@@ -173,6 +197,41 @@ gst_audio_src_ring_buffer_class_init (GstAudioSrcRingBufferClass * klass)
 typedef guint (*ReadFunc)
   (GstAudioSrc * src, gpointer data, guint length, GstClockTime * timestamp);
 
+/* called from the ringbuffer thread after every segment, see
+ * gst_audio_sink_update_stats() */
+static void
+gst_audio_src_update_stats (GstAudioSrcPrivate * priv, GstClockTime now)
+{
+  g_mutex_lock (&priv->stats_lock);
+  priv->segments++;
+  if (GST_CLOCK_TIME_IS_VALID (priv->last_segment)) {
+    GstClockTime interval = now - priv->last_segment, jitter;
+
+    if (interval > priv->segment_duration)
+      jitter = interval - priv->segment_duration;
+    else
+      jitter = priv->segment_duration - interval;
+
+    priv->max_jitter = MAX (priv->max_jitter, jitter);
+    priv->total_jitter += jitter;
+    priv->n_jitter++;
+  }
+  priv->last_segment = now;
+  g_mutex_unlock (&priv->stats_lock);
+}
+
+static void
+gst_audio_src_reset_stats (GstAudioSrcPrivate * priv)
+{
+  g_mutex_lock (&priv->stats_lock);
+  priv->segments = 0;
+  priv->last_segment = GST_CLOCK_TIME_NONE;
+  priv->max_jitter = 0;
+  priv->total_jitter = 0;
+  priv->n_jitter = 0;
+  g_mutex_unlock (&priv->stats_lock);
+}
+
 /* this internal thread does nothing else but read samples from the audio device.
  * It will read each segment in the ringbuffer and will update the play
  * pointer.
@@ -184,22 +243,38 @@ audioringbuffer_thread_func (GstAudioRingBuffer * buf)
   GstAudioSrc *src;
   GstAudioSrcClass *csrc;
   GstAudioSrcRingBuffer *abuf = GST_AUDIO_SRC_RING_BUFFER (buf);
+  GstAudioSrcPrivate *priv;
   ReadFunc readfunc;
   GstMessage *message;
   GValue val = { 0 };
   gpointer handle;
+  gboolean low_latency, realtime = FALSE;
 
   src = GST_AUDIO_SRC (GST_OBJECT_PARENT (buf));
   csrc = GST_AUDIO_SRC_GET_CLASS (src);
+  priv = gst_audio_src_get_priv (src);
 
   GST_DEBUG_OBJECT (src, "enter thread");
 
   if ((readfunc = csrc->read) == NULL)
     goto no_function;
 
-  if (G_UNLIKELY (!__gst_audio_set_thread_priority (&handle)))
+  GST_OBJECT_LOCK (src);
+  low_latency = priv->low_latency;
+  GST_OBJECT_UNLOCK (src);
+
+  if (low_latency) {
+    realtime = __gst_audio_set_thread_realtime (&handle);
+    if (G_UNLIKELY (!realtime))
+      GST_WARNING_OBJECT (src, "failed to set real-time thread priority");
+  }
+  if (!realtime && G_UNLIKELY (!__gst_audio_set_thread_priority (&handle)))
     GST_WARNING_OBJECT (src, "failed to set thread priority");
 
+  g_mutex_lock (&priv->stats_lock);
+  priv->realtime = realtime;
+  g_mutex_unlock (&priv->stats_lock);
+
   message = gst_message_new_stream_status (GST_OBJECT_CAST (buf),
       GST_STREAM_STATUS_TYPE_ENTER, GST_ELEMENT_CAST (src));
   g_value_init (&val, GST_TYPE_G_THREAD);
@@ -239,7 +314,14 @@ audioringbuffer_thread_func (GstAudioRingBuffer * buf)
 
       /* we read one segment */
       gst_audio_ring_buffer_advance (buf, 1);
+
+      gst_audio_src_update_stats (priv, gst_util_get_timestamp ());
     } else {
+      /* don't count the time we were not running as jitter */
+      g_mutex_lock (&priv->stats_lock);
+      priv->last_segment = GST_CLOCK_TIME_NONE;
+      g_mutex_unlock (&priv->stats_lock);
+
       GST_OBJECT_LOCK (abuf);
       if (!abuf->running)
         goto stop_running;
@@ -370,10 +452,12 @@ gst_audio_src_ring_buffer_acquire (GstAudioRingBuffer * buf,
   GstAudioSrc *src;
   GstAudioSrcClass *csrc;
   GstAudioSrcRingBuffer *abuf;
+  GstAudioSrcPrivate *priv;
   gboolean result = FALSE;
 
   src = GST_AUDIO_SRC (GST_OBJECT_PARENT (buf));
   csrc = GST_AUDIO_SRC_GET_CLASS (src);
+  priv = gst_audio_src_get_priv (src);
 
   if (csrc->prepare)
     result = csrc->prepare (src, spec);
@@ -391,6 +475,11 @@ gst_audio_src_ring_buffer_acquire (GstAudioRingBuffer * buf,
     memset (buf->memory, 0, buf->size);
   }
 
+  gst_audio_src_reset_stats (priv);
+  g_mutex_lock (&priv->stats_lock);
+  priv->segment_duration = spec->latency_time * GST_USECOND;
+  g_mutex_unlock (&priv->stats_lock);
+
   abuf = GST_AUDIO_SRC_RING_BUFFER (buf);
   abuf->running = TRUE;
 
@@ -496,27 +585,78 @@ enum
   LAST_SIGNAL
 };
 
+#define DEFAULT_LOW_LATENCY FALSE
+
 enum
 {
   ARG_0,
+  ARG_LOW_LATENCY,
+  ARG_STATS,
 };
 
 #define _do_init \
     GST_DEBUG_CATEGORY_INIT (gst_audio_src_debug, "audiosrc", 0, "audiosrc element");
 #define gst_audio_src_parent_class parent_class
 G_DEFINE_TYPE_WITH_CODE (GstAudioSrc, gst_audio_src,
-    GST_TYPE_AUDIO_BASE_SRC, _do_init);
+    GST_TYPE_AUDIO_BASE_SRC, G_ADD_PRIVATE (GstAudioSrc) _do_init);
 
 static GstAudioRingBuffer *gst_audio_src_create_ringbuffer (GstAudioBaseSrc *
     src);
+static void gst_audio_src_finalize (GObject * object);
+static void gst_audio_src_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_audio_src_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
+static GstAudioSrcPrivate *
+gst_audio_src_get_priv (GstAudioSrc * src)
+{
+  return gst_audio_src_get_instance_private (src);
+}
 
 static void
 gst_audio_src_class_init (GstAudioSrcClass * klass)
 {
+  GObjectClass *gobject_class;
   GstAudioBaseSrcClass *gstaudiobasesrc_class;
 
+  gobject_class = (GObjectClass *) klass;
   gstaudiobasesrc_class = (GstAudioBaseSrcClass *) klass;
 
+  gobject_class->finalize = gst_audio_src_finalize;
+  gobject_class->set_property = gst_audio_src_set_property;
+  gobject_class->get_property = gst_audio_src_get_property;
+
+  /**
+   * GstAudioSrc:low-latency:
+   *
+   * Run the thread that reads from the device with real-time priority
+   * (SCHED_FIFO on POSIX systems, which needs the appropriate privileges).
+   * Falls back to the normal increased priority if that is not possible.
+   * Takes effect the next time the device is prepared.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, ARG_LOW_LATENCY,
+      g_param_spec_boolean ("low-latency", "Low Latency",
+          "Use real-time priority for reading from the device",
+          DEFAULT_LOW_LATENCY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioSrc:stats:
+   *
+   * Statistics about the thread that reads from the device, in a
+   * `application/x-audio-src-stats` structure with the same fields as
+   * #GstAudioSink:stats. `device-delay` is the amount of audio captured by
+   * the device but not read yet.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, ARG_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Statistics about reading from the device", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gstaudiobasesrc_class->create_ringbuffer =
       GST_DEBUG_FUNCPTR (gst_audio_src_create_ringbuffer);
 
@@ -526,6 +666,99 @@ gst_audio_src_class_init (GstAudioSrcClass * klass)
 static void
 gst_audio_src_init (GstAudioSrc * audiosrc)
 {
+  GstAudioSrcPrivate *priv = gst_audio_src_get_priv (audiosrc);
+
+  priv->low_latency = DEFAULT_LOW_LATENCY;
+  g_mutex_init (&priv->stats_lock);
+  priv->last_segment = GST_CLOCK_TIME_NONE;
+}
+
+static void
+gst_audio_src_finalize (GObject * object)
+{
+  GstAudioSrcPrivate *priv = gst_audio_src_get_priv (GST_AUDIO_SRC (object));
+
+  g_mutex_clear (&priv->stats_lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static GstStructure *
+gst_audio_src_get_stats (GstAudioSrc * src)
+{
+  GstAudioSrcPrivate *priv = gst_audio_src_get_priv (src);
+  GstAudioRingBuffer *ringbuffer;
+  GstClockTime delay = 0;
+  GstStructure *s;
+
+  GST_OBJECT_LOCK (src);
+  ringbuffer = GST_AUDIO_BASE_SRC (src)->ringbuffer;
+  if (ringbuffer)
+    gst_object_ref (ringbuffer);
+  GST_OBJECT_UNLOCK (src);
+
+  if (ringbuffer) {
+    gint rate = GST_AUDIO_INFO_RATE (&ringbuffer->spec.info);
+
+    if (gst_audio_ring_buffer_is_acquired (ringbuffer) && rate > 0)
+      delay = gst_util_uint64_scale_int (gst_audio_ring_buffer_delay
+          (ringbuffer), GST_SECOND, rate);
+    gst_object_unref (ringbuffer);
+  }
+
+  g_mutex_lock (&priv->stats_lock);
+  s = gst_structure_new ("application/x-audio-src-stats",
+      "realtime", G_TYPE_BOOLEAN, priv->realtime,
+      "segment-duration", G_TYPE_UINT64, priv->segment_duration,
+      "segments", G_TYPE_UINT64, priv->segments,
+      "max-jitter", G_TYPE_UINT64, priv->max_jitter,
+      "average-jitter", G_TYPE_UINT64,
+      priv->n_jitter ? priv->total_jitter / priv->n_jitter : 0,
+      "device-delay", G_TYPE_UINT64, delay, NULL);
+  g_mutex_unlock (&priv->stats_lock);
+
+  return s;
+}
+
+static void
+gst_audio_src_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstAudioSrc *src = GST_AUDIO_SRC (object);
+  GstAudioSrcPrivate *priv = gst_audio_src_get_priv (src);
+
+  switch (prop_id) {
+    case ARG_LOW_LATENCY:
+      GST_OBJECT_LOCK (src);
+      priv->low_latency = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (src);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_audio_src_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstAudioSrc *src = GST_AUDIO_SRC (object);
+  GstAudioSrcPrivate *priv = gst_audio_src_get_priv (src);
+
+  switch (prop_id) {
+    case ARG_LOW_LATENCY:
+      GST_OBJECT_LOCK (src);
+      g_value_set_boolean (value, priv->low_latency);
+      GST_OBJECT_UNLOCK (src);
+      break;
+    case ARG_STATS:
+      g_value_take_boxed (value, gst_audio_src_get_stats (src));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
 }
 
 static GstAudioRingBuffer *
@@ -27,6 +27,16 @@
 #ifdef G_OS_WIN32
 #include <windows.h>
 #endif
+#ifdef G_OS_UNIX
+#include <string.h>
+#include <unistd.h>
+#if defined (_POSIX_THREAD_PRIORITY_SCHEDULING) && \
+    _POSIX_THREAD_PRIORITY_SCHEDULING > 0
+#include <pthread.h>
+#include <sched.h>
+#define HAVE_THREAD_SCHEDULING 1
+#endif
+#endif
 
 #include "gstaudioutilsprivate.h"
 
@@ -314,9 +324,69 @@ __gst_audio_set_thread_priority (gpointer * handle)
 #endif
 }
 
+#ifdef HAVE_THREAD_SCHEDULING
+/* SCHED_FIFO priority of real-time audio threads, in the same range as what
+ * JACK and PulseAudio use by default */
+#define AUDIO_THREAD_RT_PRIORITY 10
+
+typedef struct
+{
+  gint policy;
+  struct sched_param param;
+} GstAudioThreadScheduling;
+#endif
+
+/*
+ * Switches the thread it's called from to real-time scheduling, so that it
+ * is woken up within microseconds of its device becoming ready. On POSIX
+ * systems this needs the appropriate privileges (e.g. RLIMIT_RTPRIO), on
+ * Windows it is the same as __gst_audio_set_thread_priority.
+ */
+gboolean
+__gst_audio_set_thread_realtime (gpointer * handle)
+{
+#ifdef G_OS_WIN32
+  return __gst_audio_set_thread_priority (handle);
+#elif defined (HAVE_THREAD_SCHEDULING)
+  GstAudioThreadScheduling *prev;
+  struct sched_param param;
+  gint res;
+
+  g_return_val_if_fail (handle != NULL, FALSE);
+
+  *handle = NULL;
+
+  prev = g_new0 (GstAudioThreadScheduling, 1);
+  res = pthread_getschedparam (pthread_self (), &prev->policy, &prev->param);
+  if (res != 0)
+    goto failed;
+
+  memset (&param, 0, sizeof (param));
+  param.sched_priority = CLAMP (AUDIO_THREAD_RT_PRIORITY,
+      sched_get_priority_min (SCHED_FIFO), sched_get_priority_max (SCHED_FIFO));
+  res = pthread_setschedparam (pthread_self (), SCHED_FIFO, &param);
+  if (res != 0)
+    goto failed;
+
+  *handle = prev;
+  return TRUE;
+
+failed:
+  GST_WARNING ("Failed to set real-time thread priority: %s",
+      g_strerror (res));
+  g_free (prev);
+  return FALSE;
+#else
+  g_return_val_if_fail (handle != NULL, FALSE);
+
+  *handle = NULL;
+  return FALSE;
+#endif
+}
+
 /*
  * Restores the priority of the thread that was increased
- * with __gst_audio_set_thread_priority.
+ * with __gst_audio_set_thread_priority or __gst_audio_set_thread_realtime.
  * This function must be called from the same thread that called the
  * __gst_audio_set_thread_priority function.
  * See https://docs.microsoft.com/en-us/windows/win32/api/avrt/nf-avrt-avsetmmthreadcharacteristicsw#remarks
@@ -329,6 +399,18 @@ __gst_audio_restore_thread_priority (gpointer handle)
     return FALSE;
 
   return _gst_audio_avrt_tbl.AvRevertMmThreadCharacteristics ((HANDLE) handle);
+#elif defined (HAVE_THREAD_SCHEDULING)
+  GstAudioThreadScheduling *prev = handle;
+  gint res;
+
+  /* only set for real-time threads */
+  if (!prev)
+    return TRUE;
+
+  res = pthread_setschedparam (pthread_self (), prev->policy, &prev->param);
+  g_free (prev);
+
+  return res == 0;
 #else
   return TRUE;
 #endif
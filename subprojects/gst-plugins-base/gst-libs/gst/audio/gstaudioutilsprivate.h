@@ -45,6 +45,9 @@ gboolean __gst_audio_encoded_audio_convert (GstAudioInfo * fmt, gint64 bytes,
 G_GNUC_INTERNAL
 gboolean __gst_audio_set_thread_priority   (gpointer * handle);
 
+G_GNUC_INTERNAL
+gboolean __gst_audio_set_thread_realtime   (gpointer * handle);
+
 G_GNUC_INTERNAL
 gboolean __gst_audio_restore_thread_priority (gpointer handle);
 
@@ -12,6 +12,155 @@
  fixed or floating point complex numbers.  It also delares the kf_ internal functions.
  */
 
+/* GStreamer: two single precision complex numbers fit into one SSE or NEON
+ * register, so the radix-2 and radix-4 butterflies below handle two values
+ * of k per iteration. The twiddle factors of neighbouring k are fstride
+ * apart and are loaded as separate 64 bit halves. The operations and their
+ * order are the same as in the scalar code, so results do not change. */
+#if defined (__SSE2__) || defined (_M_X64)
+#include <emmintrin.h>
+#define KISS_FFT_F32_SIMD 1
+
+typedef __m128 kf_v4f;
+
+/* loads p[0] and, if @pair, p[stride] */
+static inline kf_v4f
+kf_load (const kiss_fft_f32_cpx * p, size_t stride, gboolean pair)
+{
+  kf_v4f v = _mm_loadl_pi (_mm_setzero_ps (), (const __m64 *) p);
+
+  if (pair)
+    v = _mm_loadh_pi (v, (const __m64 *) (p + stride));
+  return v;
+}
+
+static inline void
+kf_store (kiss_fft_f32_cpx * p, kf_v4f v, gboolean pair)
+{
+  _mm_storel_pi ((__m64 *) p, v);
+  if (pair)
+    _mm_storeh_pi ((__m64 *) (p + 1), v);
+}
+
+#define V_ADD(a, b) _mm_add_ps (a, b)
+#define V_SUB(a, b) _mm_sub_ps (a, b)
+#define V_MUL(a, b) _mm_mul_ps (a, b)
+#define V_SWAP(v) _mm_shuffle_ps (v, v, _MM_SHUFFLE (2, 3, 0, 1))
+#define V_DUP_R(v) _mm_shuffle_ps (v, v, _MM_SHUFFLE (2, 2, 0, 0))
+#define V_DUP_I(v) _mm_shuffle_ps (v, v, _MM_SHUFFLE (3, 3, 1, 1))
+#define V_NEG_R(v) _mm_xor_ps (v, _mm_set_ps (0.0f, -0.0f, 0.0f, -0.0f))
+#define V_NEG_I(v) _mm_xor_ps (v, _mm_set_ps (-0.0f, 0.0f, -0.0f, 0.0f))
+#elif defined (__aarch64__)
+#include <arm_neon.h>
+#define KISS_FFT_F32_SIMD 1
+
+typedef float32x4_t kf_v4f;
+
+static const uint32_t kf_sign_r[4] = { 1U << 31, 0, 1U << 31, 0 };
+static const uint32_t kf_sign_i[4] = { 0, 1U << 31, 0, 1U << 31 };
+
+/* loads p[0] and, if @pair, p[stride] */
+static inline kf_v4f
+kf_load (const kiss_fft_f32_cpx * p, size_t stride, gboolean pair)
+{
+  return vcombine_f32 (vld1_f32 ((const float *) p),
+      pair ? vld1_f32 ((const float *) (p + stride)) : vdup_n_f32 (0.0f));
+}
+
+static inline void
+kf_store (kiss_fft_f32_cpx * p, kf_v4f v, gboolean pair)
+{
+  vst1_f32 ((float *) p, vget_low_f32 (v));
+  if (pair)
+    vst1_f32 ((float *) (p + 1), vget_high_f32 (v));
+}
+
+#define V_ADD(a, b) vaddq_f32 (a, b)
+#define V_SUB(a, b) vsubq_f32 (a, b)
+#define V_MUL(a, b) vmulq_f32 (a, b)
+#define V_SWAP(v) vrev64q_f32 (v)
+#define V_DUP_R(v) vtrn1q_f32 (v, v)
+#define V_DUP_I(v) vtrn2q_f32 (v, v)
+#define V_NEG_R(v) vreinterpretq_f32_u32 (veorq_u32 (vreinterpretq_u32_f32 (v), \
+        vld1q_u32 (kf_sign_r)))
+#define V_NEG_I(v) vreinterpretq_f32_u32 (veorq_u32 (vreinterpretq_u32_f32 (v), \
+        vld1q_u32 (kf_sign_i)))
+#endif
+
+#ifdef KISS_FFT_F32_SIMD
+/* (a.r * b.r - a.i * b.i, a.i * b.r + a.r * b.i) for both complex values */
+static inline kf_v4f
+kf_cmul (kf_v4f a, kf_v4f b)
+{
+  return V_ADD (V_MUL (a, V_DUP_R (b)), V_NEG_R (V_MUL (V_SWAP (a),
+              V_DUP_I (b))));
+}
+
+static void
+kf_bfly2 (kiss_fft_f32_cpx * Fout,
+    const size_t fstride, const kiss_fft_f32_cfg st, int m)
+{
+  kiss_fft_f32_cpx *Fout2 = Fout + m;
+  const kiss_fft_f32_cpx *tw1 = st->twiddles;
+  gboolean pair;
+  kf_v4f f, t;
+
+  do {
+    pair = m > 1;
+    t = kf_cmul (kf_load (Fout2, 1, pair), kf_load (tw1, fstride, pair));
+    tw1 += 2 * fstride;
+    f = kf_load (Fout, 1, pair);
+    kf_store (Fout2, V_SUB (f, t), pair);
+    kf_store (Fout, V_ADD (f, t), pair);
+    Fout2 += 2;
+    Fout += 2;
+  } while (pair && (m -= 2));
+}
+
+static void
+kf_bfly4 (kiss_fft_f32_cpx * Fout,
+    const size_t fstride, const kiss_fft_f32_cfg st, const size_t m)
+{
+  const kiss_fft_f32_cpx *tw1, *tw2, *tw3;
+  size_t k = m;
+  const size_t m2 = 2 * m;
+  const size_t m3 = 3 * m;
+  gboolean pair;
+  kf_v4f f, s0, s1, s2, s3, s4, s5;
+
+  tw3 = tw2 = tw1 = st->twiddles;
+
+  do {
+    pair = k > 1;
+    s0 = kf_cmul (kf_load (&Fout[m], 1, pair), kf_load (tw1, fstride, pair));
+    s1 = kf_cmul (kf_load (&Fout[m2], 1, pair),
+        kf_load (tw2, 2 * fstride, pair));
+    s2 = kf_cmul (kf_load (&Fout[m3], 1, pair),
+        kf_load (tw3, 3 * fstride, pair));
+
+    f = kf_load (Fout, 1, pair);
+    s5 = V_SUB (f, s1);
+    f = V_ADD (f, s1);
+    s3 = V_ADD (s0, s2);
+    s4 = V_SUB (s0, s2);
+    kf_store (&Fout[m2], V_SUB (f, s3), pair);
+    kf_store (Fout, V_ADD (f, s3), pair);
+    tw1 += 2 * fstride;
+    tw2 += 4 * fstride;
+    tw3 += 6 * fstride;
+
+    /* s4 * i for the inverse, s4 * -i for the forward transform */
+    if (st->inverse)
+      s4 = V_NEG_R (V_SWAP (s4));
+    else
+      s4 = V_NEG_I (V_SWAP (s4));
+    kf_store (&Fout[m], V_ADD (s5, s4), pair);
+    kf_store (&Fout[m3], V_SUB (s5, s4), pair);
+    Fout += 2;
+  } while (pair && (k -= 2));
+}
+#else
+
 static void
 kf_bfly2 (kiss_fft_f32_cpx * Fout,
     const size_t fstride, const kiss_fft_f32_cfg st, int m)
@@ -80,6 +229,7 @@ kf_bfly4 (kiss_fft_f32_cpx * Fout,
     ++Fout;
   } while (--k);
 }
+#endif
 
 static void
 kf_bfly3 (kiss_fft_f32_cpx * Fout,
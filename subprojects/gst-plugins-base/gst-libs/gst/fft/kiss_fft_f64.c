@@ -12,6 +12,117 @@
  fixed or floating point complex numbers.  It also delares the kf_ internal functions.
  */
 
+/* GStreamer: one double precision complex number fills exactly one SSE2 or
+ * NEON register, so the radix-2 and radix-4 butterflies below do the work of
+ * C_MUL/C_ADD/C_SUB on both halves at once. The operations and their order
+ * are the same as in the scalar code, so results do not change. */
+#if defined (__SSE2__) || defined (_M_X64)
+#include <emmintrin.h>
+#define KISS_FFT_F64_SIMD 1
+
+typedef __m128d kf_v2d;
+
+#define V_LOAD(p) _mm_loadu_pd ((const double *) (p))
+#define V_STORE(p, v) _mm_storeu_pd ((double *) (p), v)
+#define V_ADD(a, b) _mm_add_pd (a, b)
+#define V_SUB(a, b) _mm_sub_pd (a, b)
+#define V_MUL(a, b) _mm_mul_pd (a, b)
+#define V_SWAP(v) _mm_shuffle_pd (v, v, 1)
+#define V_DUP_R(v) _mm_unpacklo_pd (v, v)
+#define V_DUP_I(v) _mm_unpackhi_pd (v, v)
+#define V_NEG_R(v) _mm_xor_pd (v, _mm_set_pd (0.0, -0.0))
+#define V_NEG_I(v) _mm_xor_pd (v, _mm_set_pd (-0.0, 0.0))
+#elif defined (__aarch64__)
+#include <arm_neon.h>
+#define KISS_FFT_F64_SIMD 1
+
+typedef float64x2_t kf_v2d;
+
+static const uint64_t kf_sign_r[2] = { G_GUINT64_CONSTANT (1) << 63, 0 };
+static const uint64_t kf_sign_i[2] = { 0, G_GUINT64_CONSTANT (1) << 63 };
+
+#define V_LOAD(p) vld1q_f64 ((const double *) (p))
+#define V_STORE(p, v) vst1q_f64 ((double *) (p), v)
+#define V_ADD(a, b) vaddq_f64 (a, b)
+#define V_SUB(a, b) vsubq_f64 (a, b)
+#define V_MUL(a, b) vmulq_f64 (a, b)
+#define V_SWAP(v) vextq_f64 (v, v, 1)
+#define V_DUP_R(v) vdupq_laneq_f64 (v, 0)
+#define V_DUP_I(v) vdupq_laneq_f64 (v, 1)
+#define V_NEG_R(v) vreinterpretq_f64_u64 (veorq_u64 (vreinterpretq_u64_f64 (v), \
+        vld1q_u64 (kf_sign_r)))
+#define V_NEG_I(v) vreinterpretq_f64_u64 (veorq_u64 (vreinterpretq_u64_f64 (v), \
+        vld1q_u64 (kf_sign_i)))
+#endif
+
+#ifdef KISS_FFT_F64_SIMD
+/* (a.r * b.r - a.i * b.i, a.i * b.r + a.r * b.i) */
+static inline kf_v2d
+kf_cmul (kf_v2d a, kf_v2d b)
+{
+  return V_ADD (V_MUL (a, V_DUP_R (b)), V_NEG_R (V_MUL (V_SWAP (a),
+              V_DUP_I (b))));
+}
+
+static void
+kf_bfly2 (kiss_fft_f64_cpx * Fout,
+    const size_t fstride, const kiss_fft_f64_cfg st, int m)
+{
+  kiss_fft_f64_cpx *Fout2 = Fout + m;
+  const kiss_fft_f64_cpx *tw1 = st->twiddles;
+  kf_v2d f, t;
+
+  do {
+    t = kf_cmul (V_LOAD (Fout2), V_LOAD (tw1));
+    tw1 += fstride;
+    f = V_LOAD (Fout);
+    V_STORE (Fout2, V_SUB (f, t));
+    V_STORE (Fout, V_ADD (f, t));
+    ++Fout2;
+    ++Fout;
+  } while (--m);
+}
+
+static void
+kf_bfly4 (kiss_fft_f64_cpx * Fout,
+    const size_t fstride, const kiss_fft_f64_cfg st, const size_t m)
+{
+  const kiss_fft_f64_cpx *tw1, *tw2, *tw3;
+  size_t k = m;
+  const size_t m2 = 2 * m;
+  const size_t m3 = 3 * m;
+  kf_v2d f, s0, s1, s2, s3, s4, s5;
+
+  tw3 = tw2 = tw1 = st->twiddles;
+
+  do {
+    s0 = kf_cmul (V_LOAD (&Fout[m]), V_LOAD (tw1));
+    s1 = kf_cmul (V_LOAD (&Fout[m2]), V_LOAD (tw2));
+    s2 = kf_cmul (V_LOAD (&Fout[m3]), V_LOAD (tw3));
+
+    f = V_LOAD (Fout);
+    s5 = V_SUB (f, s1);
+    f = V_ADD (f, s1);
+    s3 = V_ADD (s0, s2);
+    s4 = V_SUB (s0, s2);
+    V_STORE (&Fout[m2], V_SUB (f, s3));
+    V_STORE (Fout, V_ADD (f, s3));
+    tw1 += fstride;
+    tw2 += fstride * 2;
+    tw3 += fstride * 3;
+
+    /* s4 * i for the inverse, s4 * -i for the forward transform */
+    if (st->inverse)
+      s4 = V_NEG_R (V_SWAP (s4));
+    else
+      s4 = V_NEG_I (V_SWAP (s4));
+    V_STORE (&Fout[m], V_ADD (s5, s4));
+    V_STORE (&Fout[m3], V_SUB (s5, s4));
+    ++Fout;
+  } while (--k);
+}
+#else
+
 static void
 kf_bfly2 (kiss_fft_f64_cpx * Fout,
     const size_t fstride, const kiss_fft_f64_cfg st, int m)
@@ -80,6 +191,7 @@ kf_bfly4 (kiss_fft_f64_cpx * Fout,
     ++Fout;
   } while (--k);
 }
+#endif
 
 static void
 kf_bfly3 (kiss_fft_f64_cpx * Fout,
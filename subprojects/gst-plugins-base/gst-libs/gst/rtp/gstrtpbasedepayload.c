@@ -1180,6 +1180,8 @@ read_rtp_header_extensions (GstRTPBaseDepayload * depayload,
       goto out;
     }
 
+    /* look up all the extensions of the packet in one go */
+    GST_OBJECT_LOCK (depayload);
     while (TRUE) {
       guint8 read_id, read_len;
       GstRTPHeaderExtension *ext = NULL;
@@ -1222,35 +1224,30 @@ read_rtp_header_extensions (GstRTPBaseDepayload * depayload,
         break;
       }
 
-      GST_OBJECT_LOCK (depayload);
       for (i = 0; i < depayload->priv->header_exts->len; i++) {
         ext = g_ptr_array_index (depayload->priv->header_exts, i);
-        if (read_id == gst_rtp_header_extension_get_id (ext)) {
-          gst_object_ref (ext);
+        if (read_id == gst_rtp_header_extension_get_id (ext))
           break;
-        }
         ext = NULL;
       }
 
+      /* the extensions are kept alive by the array while we hold the lock */
       if (ext) {
         if (!gst_rtp_header_extension_read (ext, ext_flags, &pdata[offset],
                 read_len, output)) {
           GST_WARNING_OBJECT (depayload, "RTP header extension (%s) could "
               "not read payloaded data", GST_OBJECT_NAME (ext));
-          gst_object_unref (ext);
-          goto out;
+          break;
         }
 
         if (gst_rtp_header_extension_wants_update_non_rtp_src_caps (ext)) {
           needs_src_caps_update = TRUE;
         }
-
-        gst_object_unref (ext);
       }
-      GST_OBJECT_UNLOCK (depayload);
 
       offset += read_len;
     }
+    GST_OBJECT_UNLOCK (depayload);
   }
 
 out:
@@ -78,6 +78,11 @@ struct _GstRTPBasePayloadPrivate
 
   /* array of GstRTPHeaderExtension's * */
   GPtrArray *header_exts;
+
+  /* packets pushed while handling an input buffer list, they go downstream
+   * together once the whole input list has been payloaded */
+  GstBufferList *pending_list;
+  GstFlowReturn pending_ret;
 };
 
 /* RTPBasePayload signals and args */
@@ -162,6 +167,8 @@ static gboolean gst_rtp_base_payload_query (GstPad * pad, GstObject * parent,
     GstQuery * query);
 static GstFlowReturn gst_rtp_base_payload_chain (GstPad * pad,
     GstObject * parent, GstBuffer * buffer);
+static GstFlowReturn gst_rtp_base_payload_chain_list (GstPad * pad,
+    GstObject * parent, GstBufferList * list);
 
 static void gst_rtp_base_payload_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
@@ -172,6 +179,8 @@ static GstStateChangeReturn gst_rtp_base_payload_change_state (GstElement *
     element, GstStateChange transition);
 
 static gboolean gst_rtp_base_payload_negotiate (GstRTPBasePayload * payload);
+static GstFlowReturn gst_rtp_base_payload_push_pending (GstRTPBasePayload *
+    payload);
 
 static void gst_rtp_base_payload_add_extension (GstRTPBasePayload * payload,
     GstRTPHeaderExtension * ext);
@@ -528,6 +537,8 @@ gst_rtp_base_payload_init (GstRTPBasePayload * rtpbasepayload, gpointer g_class)
   rtpbasepayload->sinkpad = gst_pad_new_from_template (templ, "sink");
   gst_pad_set_chain_function (rtpbasepayload->sinkpad,
       gst_rtp_base_payload_chain);
+  gst_pad_set_chain_list_function (rtpbasepayload->sinkpad,
+      gst_rtp_base_payload_chain_list);
   gst_pad_set_event_function (rtpbasepayload->sinkpad,
       gst_rtp_base_payload_sink_event);
   gst_pad_set_query_function (rtpbasepayload->sinkpad,
@@ -904,6 +915,65 @@ flushing:
   }
 }
 
+typedef struct
+{
+  GstPad *pad;
+  GstObject *parent;
+  GstFlowReturn ret;
+} ChainListData;
+
+static gboolean
+chain_list_buffer (GstBuffer ** buffer, guint idx, gpointer user_data)
+{
+  ChainListData *data = user_data;
+  GstBuffer *buf = *buffer;
+
+  /* removes the buffer from the list, chain takes ownership of it */
+  *buffer = NULL;
+  data->ret = gst_rtp_base_payload_chain (data->pad, data->parent, buf);
+
+  return data->ret == GST_FLOW_OK;
+}
+
+/* Payloads all buffers of @list and pushes the resulting packets downstream
+ * as one list, which lets the header extensions be written and the packets be
+ * processed downstream in batches. */
+static GstFlowReturn
+gst_rtp_base_payload_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  GstRTPBasePayload *rtpbasepayload;
+  GstRTPBasePayloadPrivate *priv;
+  ChainListData data;
+  GstFlowReturn ret, push_ret;
+
+  rtpbasepayload = GST_RTP_BASE_PAYLOAD (parent);
+  priv = rtpbasepayload->priv;
+
+  priv->pending_list =
+      gst_buffer_list_new_sized (gst_buffer_list_length (list));
+  priv->pending_ret = GST_FLOW_OK;
+
+  /* the buffers are taken out of the list, so that the subclass gets the
+   * only reference to them like with the plain chain function */
+  list = gst_buffer_list_make_writable (list);
+  data.pad = pad;
+  data.parent = parent;
+  data.ret = GST_FLOW_OK;
+  gst_buffer_list_foreach (list, chain_list_buffer, &data);
+  gst_buffer_list_unref (list);
+  ret = data.ret;
+
+  push_ret = gst_rtp_base_payload_push_pending (rtpbasepayload);
+  gst_buffer_list_unref (priv->pending_list);
+  priv->pending_list = NULL;
+
+  if (ret == GST_FLOW_OK)
+    ret = push_ret;
+
+  return ret;
+}
+
 /**
  * gst_rtp_base_payload_set_options:
  * @payload: a #GstRTPBasePayload
@@ -1072,6 +1142,9 @@ gst_rtp_base_payload_negotiate (GstRTPBasePayload * payload)
   GstStructure *s, *d;
   gboolean res = TRUE;
 
+  /* packets payloaded with the previous caps go out first */
+  gst_rtp_base_payload_push_pending (payload);
+
   payload->priv->caps_max_ptime = DEFAULT_MAX_PTIME;
   payload->ptime = 0;
 
@@ -1599,17 +1672,25 @@ gst_rtp_base_payload_clear_extensions (GstRTPBasePayload * payload)
   GST_OBJECT_UNLOCK (payload);
 }
 
+/* header extension layout, shared by all the packets of a push */
 typedef struct
 {
   GstRTPBasePayload *payload;
   GstRTPHeaderExtensionFlags flags;
-  GstBuffer *output;
+  gsize allocated_size;
+  gsize hdr_unit_size;
+  guint16 bit_pattern;
+} HeaderExt;
+
+/* header extension state of one packet */
+typedef struct
+{
+  GstRTPBuffer rtp;
   guint8 *data;
   gsize allocated_size;
   gsize written_size;
-  gsize hdr_unit_size;
   gboolean abort;
-} HeaderExt;
+} HeaderExtPacket;
 
 static void
 determine_header_extension_flags_size (GstRTPHeaderExtension * ext,
@@ -1638,25 +1719,80 @@ determine_header_extension_flags_size (GstRTPHeaderExtension * ext,
   hdr->allocated_size += max_size;
 }
 
+/* called with the OBJECT_LOCK */
+static gboolean
+prepare_header_extensions (GstRTPBasePayload * payload, HeaderExt * hdr)
+{
+  hdr->payload = payload;
+  hdr->flags =
+      GST_RTP_HEADER_EXTENSION_ONE_BYTE | GST_RTP_HEADER_EXTENSION_TWO_BYTE;
+  hdr->allocated_size = 0;
+  g_ptr_array_foreach (payload->priv->header_exts,
+      (GFunc) determine_header_extension_flags_size, hdr);
+
+  if (hdr->flags & GST_RTP_HEADER_EXTENSION_ONE_BYTE) {
+    /* prefer the one byte header */
+    hdr->hdr_unit_size = 1;
+    /* TODO: support mixed size writing modes, i.e. RFC8285 */
+    hdr->flags &= ~GST_RTP_HEADER_EXTENSION_TWO_BYTE;
+    hdr->bit_pattern = 0xBEDE;
+  } else if (hdr->flags & GST_RTP_HEADER_EXTENSION_TWO_BYTE) {
+    hdr->hdr_unit_size = 2;
+    hdr->bit_pattern = 0x1000;
+  } else {
+    GST_ERROR_OBJECT (payload,
+        "Cannot add rtp header extensions with mixed header types");
+    return FALSE;
+  }
+
+  hdr->allocated_size += hdr->hdr_unit_size * payload->priv->header_exts->len;
+
+  return TRUE;
+}
+
+/* reserves room for the largest possible extension data in @pkt */
 static void
-write_header_extension (GstRTPHeaderExtension * ext, gpointer user_data)
+start_header_extension (HeaderExt * hdr, HeaderExtPacket * pkt)
 {
-  HeaderExt *hdr = user_data;
-  gsize remaining =
-      hdr->allocated_size - hdr->written_size - hdr->hdr_unit_size;
-  gsize offset = hdr->written_size + hdr->hdr_unit_size;
-  gssize written;
-  guint ext_id;
+  guint wordlen;
 
-  if (hdr->abort)
-    return;
+  wordlen = hdr->allocated_size / 4 + ((hdr->allocated_size % 4) ? 1 : 0);
 
-  written = gst_rtp_header_extension_write (ext,
-      hdr->payload->priv->input_meta_buffer, hdr->flags, hdr->output,
-      &hdr->data[offset], remaining);
+  /* XXX: do we need to add to any existing extension data instead of
+   * overwriting everything? */
+  gst_rtp_buffer_set_extension_data (&pkt->rtp, hdr->bit_pattern, wordlen);
+  gst_rtp_buffer_get_extension_data (&pkt->rtp, NULL, (gpointer) & pkt->data,
+      &wordlen);
+
+  /* from 32-bit words to bytes */
+  pkt->allocated_size = wordlen * 4;
+  pkt->written_size = 0;
+  pkt->abort = FALSE;
+}
+
+/* where the next extension goes in @pkt, or NULL when writing stopped */
+static guint8 *
+next_header_extension (HeaderExt * hdr, HeaderExtPacket * pkt,
+    gsize * remaining)
+{
+  if (pkt->abort)
+    return NULL;
+
+  *remaining = pkt->allocated_size - pkt->written_size - hdr->hdr_unit_size;
+
+  return &pkt->data[pkt->written_size + hdr->hdr_unit_size];
+}
+
+/* writes the element header for @written bytes of data from @ext */
+static void
+write_header_extension (HeaderExt * hdr, HeaderExtPacket * pkt,
+    GstRTPHeaderExtension * ext, guint ext_id, gsize remaining,
+    gssize written)
+{
+  gsize offset = pkt->written_size;
 
   GST_TRACE_OBJECT (hdr->payload, "extension %" GST_PTR_FORMAT " wrote %"
-      G_GSIZE_FORMAT, ext, written);
+      G_GSSIZE_FORMAT, ext, written);
 
   if (written == 0) {
     /* extension wrote no data */
@@ -1673,11 +1809,6 @@ write_header_extension (GstRTPHeaderExtension * ext, gpointer user_data)
     goto error;
   }
 
-  ext_id = gst_rtp_header_extension_get_id (ext);
-
-  /* move to the beginning of the extension header */
-  offset -= hdr->hdr_unit_size;
-
   /* write extension header */
   if (hdr->flags & GST_RTP_HEADER_EXTENSION_ONE_BYTE) {
     if (written > RTP_HEADER_EXT_ONE_BYTE_MAX_SIZE) {
@@ -1686,7 +1817,7 @@ write_header_extension (GstRTPHeaderExtension * ext, gpointer user_data)
       goto error;
     }
 
-    hdr->data[offset] = ((ext_id & 0x0F) << 4) | ((written - 1) & 0x0F);
+    pkt->data[offset] = ((ext_id & 0x0F) << 4) | ((written - 1) & 0x0F);
   } else if (hdr->flags & GST_RTP_HEADER_EXTENSION_TWO_BYTE) {
     if (written > RTP_HEADER_EXT_TWO_BYTE_MAX_SIZE) {
       g_critical ("Amount of data written by %s is larger than allowed with "
@@ -1694,117 +1825,164 @@ write_header_extension (GstRTPHeaderExtension * ext, gpointer user_data)
       goto error;
     }
 
-    hdr->data[offset] = ext_id & 0xFF;
-    hdr->data[offset + 1] = written & 0xFF;
+    pkt->data[offset] = ext_id & 0xFF;
+    pkt->data[offset + 1] = written & 0xFF;
   } else {
     g_critical ("Don't know how to write extension data with flags 0x%x!",
         hdr->flags);
     goto error;
   }
 
-  hdr->written_size += written + hdr->hdr_unit_size;
+  pkt->written_size += written + hdr->hdr_unit_size;
 
   return;
 
 error:
-  hdr->abort = TRUE;
+  pkt->abort = TRUE;
   return;
 }
 
-static gboolean
-set_headers (GstBuffer ** buffer, guint idx, gpointer user_data)
+/* shrinks the extension data of @pkt to what was actually written */
+static void
+finish_header_extension (HeaderExt * hdr, HeaderExtPacket * pkt)
 {
-  HeaderData *data = user_data;
-  HeaderExt hdrext = { NULL, };
-  GstRTPBuffer rtp = { NULL, };
-
-  if (!gst_rtp_buffer_map (*buffer, GST_MAP_READWRITE, &rtp))
-    goto map_failed;
-
-  gst_rtp_buffer_set_ssrc (&rtp, data->ssrc);
-  gst_rtp_buffer_set_payload_type (&rtp, data->pt);
-  gst_rtp_buffer_set_seq (&rtp, data->seqnum);
-  gst_rtp_buffer_set_timestamp (&rtp, data->rtptime);
-
-  GST_OBJECT_LOCK (data->payload);
-  if (data->payload->priv->header_exts->len > 0
-      && data->payload->priv->input_meta_buffer) {
-    guint wordlen;
-    gsize extlen;
-    guint16 bit_pattern;
-
-    /* write header extensions */
-    hdrext.payload = data->payload;
-    hdrext.output = *buffer;
-    /* XXX: pre-calculate these flags and sizes? */
-    hdrext.flags =
-        GST_RTP_HEADER_EXTENSION_ONE_BYTE | GST_RTP_HEADER_EXTENSION_TWO_BYTE;
-    g_ptr_array_foreach (data->payload->priv->header_exts,
-        (GFunc) determine_header_extension_flags_size, &hdrext);
-    hdrext.hdr_unit_size = 0;
-    if (hdrext.flags & GST_RTP_HEADER_EXTENSION_ONE_BYTE) {
-      /* prefer the one byte header */
-      hdrext.hdr_unit_size = 1;
-      /* TODO: support mixed size writing modes, i.e. RFC8285 */
-      hdrext.flags &= ~GST_RTP_HEADER_EXTENSION_TWO_BYTE;
-      bit_pattern = 0xBEDE;
-    } else if (hdrext.flags & GST_RTP_HEADER_EXTENSION_TWO_BYTE) {
-      hdrext.hdr_unit_size = 2;
-      bit_pattern = 0x1000;
-    } else {
-      goto unsupported_flags;
-    }
+  if (pkt->written_size > 0) {
+    guint wordlen =
+        pkt->written_size / 4 + ((pkt->written_size % 4) ? 1 : 0);
 
-    extlen =
-        hdrext.hdr_unit_size * data->payload->priv->header_exts->len +
-        hdrext.allocated_size;
-    wordlen = extlen / 4 + ((extlen % 4) ? 1 : 0);
+    /* zero-fill the hdrext padding bytes */
+    memset (&pkt->data[pkt->written_size], 0,
+        wordlen * 4 - pkt->written_size);
 
-    /* XXX: do we need to add to any existing extension data instead of
-     * overwriting everything? */
-    gst_rtp_buffer_set_extension_data (&rtp, bit_pattern, wordlen);
-    gst_rtp_buffer_get_extension_data (&rtp, NULL, (gpointer) & hdrext.data,
-        &wordlen);
+    gst_rtp_buffer_set_extension_data (&pkt->rtp, hdr->bit_pattern, wordlen);
+  } else {
+    gst_rtp_buffer_remove_extension_data (&pkt->rtp);
+  }
+}
 
-    /* from 32-bit words to bytes */
-    hdrext.allocated_size = wordlen * 4;
+/* Writes all header extensions into @n_packets mapped packets.  When @list is
+ * given, @pkts are its packets in order and every extension is asked to write
+ * into all of them with a single gst_rtp_header_extension_write_list() call.
+ *
+ * called with the OBJECT_LOCK */
+static void
+write_header_extensions (GstRTPBasePayload * payload, GstBufferList * list,
+    HeaderExtPacket * pkts, guint n_packets)
+{
+  GstRTPBasePayloadPrivate *priv = payload->priv;
+  HeaderExt hdr;
+  guint8 **data = NULL;
+  gsize *remaining = NULL;
+  gssize *written = NULL;
+  guint i, j;
+
+  if (!prepare_header_extensions (payload, &hdr))
+    return;
+
+  for (i = 0; i < n_packets; i++)
+    start_header_extension (&hdr, &pkts[i]);
+
+  if (list) {
+    data = g_new (guint8 *, n_packets);
+    remaining = g_new (gsize, n_packets);
+    written = g_new (gssize, n_packets);
+  }
 
-    g_ptr_array_foreach (data->payload->priv->header_exts,
-        (GFunc) write_header_extension, &hdrext);
+  for (j = 0; j < priv->header_exts->len; j++) {
+    GstRTPHeaderExtension *ext = g_ptr_array_index (priv->header_exts, j);
+    guint ext_id = gst_rtp_header_extension_get_id (ext);
 
-    if (hdrext.written_size > 0) {
-      wordlen = hdrext.written_size / 4 + ((hdrext.written_size % 4) ? 1 : 0);
+    if (list) {
+      gboolean any = FALSE;
 
-      /* zero-fill the hdrext padding bytes */
-      memset (&hdrext.data[hdrext.written_size], 0,
-          wordlen * 4 - hdrext.written_size);
+      for (i = 0; i < n_packets; i++) {
+        data[i] = next_header_extension (&hdr, &pkts[i], &remaining[i]);
+        written[i] = 0;
+        any |= data[i] != NULL;
+      }
+      if (!any)
+        break;
+
+      gst_rtp_header_extension_write_list (ext, priv->input_meta_buffer,
+          hdr.flags, list, data, remaining, written);
 
-      gst_rtp_buffer_set_extension_data (&rtp, bit_pattern, wordlen);
+      for (i = 0; i < n_packets; i++) {
+        if (data[i])
+          write_header_extension (&hdr, &pkts[i], ext, ext_id, remaining[i],
+              written[i]);
+      }
     } else {
-      gst_rtp_buffer_remove_extension_data (&rtp);
+      for (i = 0; i < n_packets; i++) {
+        gsize size;
+        guint8 *ptr = next_header_extension (&hdr, &pkts[i], &size);
+
+        if (ptr)
+          write_header_extension (&hdr, &pkts[i], ext, ext_id, size,
+              gst_rtp_header_extension_write (ext, priv->input_meta_buffer,
+                  hdr.flags, pkts[i].rtp.buffer, ptr, size));
+      }
     }
   }
-  GST_OBJECT_UNLOCK (data->payload);
-  gst_rtp_buffer_unmap (&rtp);
 
-  /* increment the seqnum for each buffer */
-  data->seqnum++;
+  for (i = 0; i < n_packets; i++)
+    finish_header_extension (&hdr, &pkts[i]);
 
-  return TRUE;
-  /* ERRORS */
-map_failed:
-  {
-    GST_ERROR ("failed to map buffer %p", *buffer);
-    return FALSE;
+  g_free (data);
+  g_free (remaining);
+  g_free (written);
+}
+
+/* Sets the RTP header fields of @n_packets buffers, taken from @list or from
+ * @buffer, and writes their header extensions.  Stops at the first buffer that
+ * can't be mapped. */
+static void
+set_headers (HeaderData * data, GstBufferList * list, GstBuffer * buffer,
+    guint n_packets)
+{
+  GstRTPBasePayload *payload = data->payload;
+  HeaderExtPacket single = { GST_RTP_BUFFER_INIT, };
+  HeaderExtPacket *pkts = &single;
+  guint i, n_mapped;
+
+  if (n_packets > 1)
+    pkts = g_new0 (HeaderExtPacket, n_packets);
+
+  for (n_mapped = 0; n_mapped < n_packets; n_mapped++) {
+    GstBuffer *buf = list ? gst_buffer_list_get (list, n_mapped) : buffer;
+    GstRTPBuffer *rtp = &pkts[n_mapped].rtp;
+
+    if (!gst_rtp_buffer_map (buf, GST_MAP_READWRITE, rtp)) {
+      GST_ERROR ("failed to map buffer %p", buf);
+      break;
+    }
+
+    gst_rtp_buffer_set_ssrc (rtp, data->ssrc);
+    gst_rtp_buffer_set_payload_type (rtp, data->pt);
+    gst_rtp_buffer_set_seq (rtp, data->seqnum);
+    gst_rtp_buffer_set_timestamp (rtp, data->rtptime);
+
+    /* increment the seqnum for each buffer */
+    data->seqnum++;
   }
 
-unsupported_flags:
-  {
-    GST_OBJECT_UNLOCK (data->payload);
-    gst_rtp_buffer_unmap (&rtp);
-    GST_ERROR ("Cannot add rtp header extensions with mixed header types");
-    return FALSE;
+  /* only hand the list to the extensions when all of its packets are
+   * mapped, the single packet path is used otherwise */
+  if (n_mapped < n_packets)
+    list = NULL;
+
+  if (n_mapped > 0) {
+    GST_OBJECT_LOCK (payload);
+    if (payload->priv->header_exts->len > 0
+        && payload->priv->input_meta_buffer)
+      write_header_extensions (payload, list, pkts, n_mapped);
+    GST_OBJECT_UNLOCK (payload);
   }
+
+  for (i = 0; i < n_mapped; i++)
+    gst_rtp_buffer_unmap (&pkts[i].rtp);
+
+  if (pkts != &single)
+    g_free (pkts);
 }
 
 static gboolean
@@ -1929,13 +2107,15 @@ gst_rtp_base_payload_prepare_push (GstRTPBasePayload * payload,
   /* set ssrc, payload type, seq number, caps and rtptime */
   /* remove unwanted meta */
   if (is_list) {
-    gst_buffer_list_foreach (GST_BUFFER_LIST_CAST (obj), set_headers, &data);
-    gst_buffer_list_foreach (GST_BUFFER_LIST_CAST (obj), filter_meta, NULL);
+    GstBufferList *list = GST_BUFFER_LIST_CAST (obj);
+
+    set_headers (&data, list, NULL, gst_buffer_list_length (list));
+    gst_buffer_list_foreach (list, filter_meta, NULL);
     /* sequence number has increased more if this was a buffer list */
     payload->seqnum = data.seqnum - 1;
   } else {
     GstBuffer *buf = GST_BUFFER_CAST (obj);
-    set_headers (&buf, 0, &data);
+    set_headers (&data, NULL, buf, 1);
     filter_meta (&buf, 0, NULL);
   }
 
@@ -1966,6 +2146,34 @@ no_rate:
   }
 }
 
+/* Pushes the packets collected by chain_list so far, returns the first error
+ * that happened while pushing them. */
+static GstFlowReturn
+gst_rtp_base_payload_push_pending (GstRTPBasePayload * payload)
+{
+  GstRTPBasePayloadPrivate *priv = payload->priv;
+  GstBufferList *list = priv->pending_list;
+
+  if (list == NULL || gst_buffer_list_length (list) == 0)
+    return priv->pending_ret;
+
+  priv->pending_list = gst_buffer_list_new ();
+
+  if (priv->pending_ret != GST_FLOW_OK) {
+    gst_buffer_list_unref (list);
+    return priv->pending_ret;
+  }
+
+  if (G_UNLIKELY (priv->pending_segment)) {
+    gst_pad_push_event (payload->srcpad, priv->pending_segment);
+    priv->pending_segment = FALSE;
+    priv->delay_segment = FALSE;
+  }
+  priv->pending_ret = gst_pad_push_list (payload->srcpad, list);
+
+  return priv->pending_ret;
+}
+
 /**
  * gst_rtp_base_payload_push_list:
  * @payload: a #GstRTPBasePayload
@@ -1986,7 +2194,16 @@ gst_rtp_base_payload_push_list (GstRTPBasePayload * payload,
 
   res = gst_rtp_base_payload_prepare_push (payload, list, TRUE);
 
-  if (G_LIKELY (res == GST_FLOW_OK)) {
+  if (G_LIKELY (res == GST_FLOW_OK) && payload->priv->pending_list) {
+    guint i, len = gst_buffer_list_length (list);
+
+    /* handling an input list, collect the packets */
+    for (i = 0; i < len; i++)
+      gst_buffer_list_add (payload->priv->pending_list,
+          gst_buffer_ref (gst_buffer_list_get (list, i)));
+    gst_buffer_list_unref (list);
+    res = payload->priv->pending_ret;
+  } else if (G_LIKELY (res == GST_FLOW_OK)) {
     if (G_UNLIKELY (payload->priv->pending_segment)) {
       gst_pad_push_event (payload->srcpad, payload->priv->pending_segment);
       payload->priv->pending_segment = FALSE;
@@ -2019,7 +2236,11 @@ gst_rtp_base_payload_push (GstRTPBasePayload * payload, GstBuffer * buffer)
 
   res = gst_rtp_base_payload_prepare_push (payload, buffer, FALSE);
 
-  if (G_LIKELY (res == GST_FLOW_OK)) {
+  if (G_LIKELY (res == GST_FLOW_OK) && payload->priv->pending_list) {
+    /* handling an input list, collect the packet */
+    gst_buffer_list_add (payload->priv->pending_list, buffer);
+    res = payload->priv->pending_ret;
+  } else if (G_LIKELY (res == GST_FLOW_OK)) {
     if (G_UNLIKELY (payload->priv->pending_segment)) {
       gst_pad_push_event (payload->srcpad, payload->priv->pending_segment);
       payload->priv->pending_segment = FALSE;
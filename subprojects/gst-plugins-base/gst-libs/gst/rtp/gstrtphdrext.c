@@ -37,6 +37,11 @@
 static gboolean
 gst_rtp_header_extension_set_caps_from_attributes_default (GstRTPHeaderExtension
     * ext, GstCaps * caps);
+static gboolean
+gst_rtp_header_extension_write_list_default (GstRTPHeaderExtension * ext,
+    const GstBuffer * input_meta, GstRTPHeaderExtensionFlags write_flags,
+    GstBufferList * output, guint8 ** data, const gsize * size,
+    gssize * written);
 
 GST_DEBUG_CATEGORY_STATIC (rtphderext_debug);
 #define GST_CAT_DEFAULT (rtphderext_debug)
@@ -189,6 +194,7 @@ gst_rtp_header_extension_class_init (GstRTPHeaderExtensionClass * klass)
 {
   klass->set_caps_from_attributes =
       gst_rtp_header_extension_set_caps_from_attributes_default;
+  klass->write_list = gst_rtp_header_extension_write_list_default;
 }
 
 static void
@@ -312,6 +318,82 @@ gst_rtp_header_extension_write (GstRTPHeaderExtension * ext,
   return klass->write (ext, input_meta, write_flags, output, data, size);
 }
 
+static gboolean
+gst_rtp_header_extension_write_list_default (GstRTPHeaderExtension * ext,
+    const GstBuffer * input_meta, GstRTPHeaderExtensionFlags write_flags,
+    GstBufferList * output, guint8 ** data, const gsize * size,
+    gssize * written)
+{
+  GstRTPHeaderExtensionClass *klass = GST_RTP_HEADER_EXTENSION_GET_CLASS (ext);
+  gboolean ret = TRUE;
+  guint i, len;
+
+  g_return_val_if_fail (klass->write != NULL, FALSE);
+
+  len = gst_buffer_list_length (output);
+  for (i = 0; i < len; i++) {
+    if (data[i] == NULL)
+      continue;
+
+    written[i] = klass->write (ext, input_meta, write_flags,
+        gst_buffer_list_get (output, i), data[i], size[i]);
+    if (written[i] < 0)
+      ret = FALSE;
+  }
+
+  return ret;
+}
+
+/**
+ * gst_rtp_header_extension_write_list:
+ * @ext: a #GstRTPHeaderExtension
+ * @input_meta: the input #GstBuffer to read information from if necessary
+ * @write_flags: #GstRTPHeaderExtensionFlags for how the extension should
+ *               be written
+ * @output: a #GstBufferList of output RTP packets
+ * @data: (array): for each packet in @output, the location to write the rtp
+ *        header extension into, or %NULL to skip the packet
+ * @size: (array): for each packet in @output, the size of @data
+ * @written: (array) (out caller-allocates): for each packet in @output, the
+ *           size of the data written, < 0 on failure
+ *
+ * Writes the RTP header extension into every packet of @output that has a
+ * non-%NULL entry in @data, as gst_rtp_header_extension_write() does for a
+ * single packet.  Extensions can implement this to do their per-call work
+ * once for a whole list of packets that were payloaded from the same
+ * @input_meta.
+ *
+ * The @data, @size and @written arrays must have as many entries as @output
+ * has packets.  Entries of @written for skipped packets are left untouched.
+ *
+ * Returns: %FALSE if writing failed for any of the packets
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_rtp_header_extension_write_list (GstRTPHeaderExtension * ext,
+    const GstBuffer * input_meta, GstRTPHeaderExtensionFlags write_flags,
+    GstBufferList * output, guint8 ** data, const gsize * size,
+    gssize * written)
+{
+  GstRTPHeaderExtensionPrivate *priv =
+      gst_rtp_header_extension_get_instance_private (ext);
+  GstRTPHeaderExtensionClass *klass;
+
+  g_return_val_if_fail (GST_IS_BUFFER (input_meta), FALSE);
+  g_return_val_if_fail (GST_IS_BUFFER_LIST (output), FALSE);
+  g_return_val_if_fail (data != NULL, FALSE);
+  g_return_val_if_fail (size != NULL, FALSE);
+  g_return_val_if_fail (written != NULL, FALSE);
+  g_return_val_if_fail (GST_IS_RTP_HEADER_EXTENSION (ext), FALSE);
+  g_return_val_if_fail (priv->ext_id <= MAX_RTP_EXT_ID, FALSE);
+  klass = GST_RTP_HEADER_EXTENSION_GET_CLASS (ext);
+  g_return_val_if_fail (klass->write_list != NULL, FALSE);
+
+  return klass->write_list (ext, input_meta, write_flags, output, data, size,
+      written);
+}
+
 /**
  * gst_rtp_header_extension_read:
  * @ext: a #GstRTPHeaderExtension
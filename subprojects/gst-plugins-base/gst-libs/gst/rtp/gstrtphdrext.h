@@ -171,6 +171,9 @@ struct _GstRTPHeaderExtension
  *     an SDP.
  * @set_caps_from_attributes: write the necessary caps field/s for the configured
  *     attributes e.g. as signalled with SDP.
+ * @write_list: write the information for this extension into each packet of a
+ *     #GstBufferList.  The default implementation calls @write for each
+ *     packet.  Since: 1.22
  *
  * Base class for RTP Header extensions.
  *
@@ -209,8 +212,16 @@ struct _GstRTPHeaderExtensionClass
   gboolean              (*set_caps_from_attributes) (GstRTPHeaderExtension * ext,
                                                      GstCaps * caps);
 
+  gboolean              (*write_list)               (GstRTPHeaderExtension * ext,
+                                                     const GstBuffer * input_meta,
+                                                     GstRTPHeaderExtensionFlags write_flags,
+                                                     GstBufferList * output,
+                                                     guint8 ** data,
+                                                     const gsize * size,
+                                                     gssize * written);
+
   /*< private >*/
-  gpointer _gst_reserved[GST_PADDING_LARGE];
+  gpointer _gst_reserved[GST_PADDING_LARGE - 1];
 };
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstRTPHeaderExtension, gst_object_unref)
@@ -246,6 +257,14 @@ gssize              gst_rtp_header_extension_write              (GstRTPHeaderExt
                                                                  guint8 * data,
                                                                  gsize size);
 GST_RTP_API
+gboolean            gst_rtp_header_extension_write_list         (GstRTPHeaderExtension * ext,
+                                                                 const GstBuffer * input_meta,
+                                                                 GstRTPHeaderExtensionFlags write_flags,
+                                                                 GstBufferList * output,
+                                                                 guint8 ** data,
+                                                                 const gsize * size,
+                                                                 gssize * written);
+GST_RTP_API
 gboolean            gst_rtp_header_extension_read               (GstRTPHeaderExtension * ext,
                                                                  GstRTPHeaderExtensionFlags read_flags,
                                                                  const guint8 * data,
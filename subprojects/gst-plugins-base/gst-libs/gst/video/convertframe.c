@@ -315,6 +315,402 @@ link_failed:
   }
 }
 
+static GstCaps *
+copy_caps_without_framerate (const GstCaps * caps)
+{
+  GstCaps *copy;
+  guint i, n;
+
+  copy = gst_caps_new_empty ();
+  n = gst_caps_get_size (caps);
+  for (i = 0; i < n; i++) {
+    GstStructure *s = gst_caps_get_structure (caps, i);
+
+    s = gst_structure_copy (s);
+    gst_structure_remove_field (s, "framerate");
+    gst_caps_append_structure (copy, s);
+  }
+
+  return copy;
+}
+
+static gboolean
+caps_are_system_memory (const GstCaps * caps)
+{
+  GstCapsFeatures *features;
+
+  features = gst_caps_get_features (caps, 0);
+
+  return features == NULL
+      || gst_caps_features_is_equal (features,
+      GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY);
+}
+
+/* Checks if the conversion from @from_caps to @to_caps can be done with a
+ * plain #GstVideoConverter instead of a conversion pipeline, and fills in the
+ * input/output info and the source rectangle to use for it.
+ *
+ * This only handles raw system memory on both sides and output caps that
+ * either fully specify the output size and pixel-aspect-ratio or leave it
+ * completely to the input. Everything else needs the negotiation done by
+ * the conversion pipeline. */
+static gboolean
+convert_frame_direct_prepare (const GstCaps * from_caps,
+    GstVideoCropMeta * cmeta, const GstCaps * to_caps, GstVideoInfo * in_info,
+    GstVideoInfo * out_info, GstVideoRectangle * src_rect)
+{
+  GstStructure *in_s, *s;
+  GstCaps *caps;
+  gboolean has_width, has_height, res;
+
+  if (gst_caps_get_size (from_caps) != 1 || gst_caps_get_size (to_caps) != 1)
+    return FALSE;
+
+  if (!caps_are_raw (from_caps) || !caps_are_raw (to_caps))
+    return FALSE;
+
+  if (!caps_are_system_memory (from_caps) || !caps_are_system_memory (to_caps))
+    return FALSE;
+
+  if (!gst_video_info_from_caps (in_info, from_caps))
+    return FALSE;
+
+  src_rect->x = 0;
+  src_rect->y = 0;
+  src_rect->w = GST_VIDEO_INFO_WIDTH (in_info);
+  src_rect->h = GST_VIDEO_INFO_HEIGHT (in_info);
+  if (cmeta) {
+    if (cmeta->x + cmeta->width > src_rect->w
+        || cmeta->y + cmeta->height > src_rect->h)
+      return FALSE;
+    src_rect->x = cmeta->x;
+    src_rect->y = cmeta->y;
+    src_rect->w = cmeta->width;
+    src_rect->h = cmeta->height;
+  }
+
+  in_s = gst_caps_get_structure (from_caps, 0);
+  s = gst_structure_copy (gst_caps_get_structure (to_caps, 0));
+
+  has_width = gst_structure_has_field (s, "width");
+  has_height = gst_structure_has_field (s, "height");
+  if (has_width != has_height)
+    goto needs_negotiation;
+
+  if (!has_width) {
+    gst_structure_set (s, "width", G_TYPE_INT, src_rect->w,
+        "height", G_TYPE_INT, src_rect->h, NULL);
+  }
+
+  if (!gst_structure_has_field (s, "pixel-aspect-ratio")) {
+    gint width, height;
+
+    /* Only if the size stays the same the input pixel-aspect-ratio is what
+     * the negotiation would have picked */
+    if (!gst_structure_get_int (s, "width", &width)
+        || !gst_structure_get_int (s, "height", &height)
+        || width != src_rect->w || height != src_rect->h)
+      goto needs_negotiation;
+
+    gst_structure_set (s, "pixel-aspect-ratio", GST_TYPE_FRACTION,
+        GST_VIDEO_INFO_PAR_N (in_info), GST_VIDEO_INFO_PAR_D (in_info), NULL);
+  }
+
+  if (!gst_structure_has_field (s, "format"))
+    gst_structure_set_value (s, "format",
+        gst_structure_get_value (in_s, "format"));
+
+  if (!gst_structure_has_field (s, "interlace-mode")
+      && gst_structure_has_field (in_s, "interlace-mode"))
+    gst_structure_set_value (s, "interlace-mode",
+        gst_structure_get_value (in_s, "interlace-mode"));
+
+  caps = gst_caps_new_empty ();
+  gst_caps_append_structure (caps, s);
+
+  if (!gst_caps_is_fixed (caps)) {
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+
+  res = gst_video_info_from_caps (out_info, caps);
+  gst_caps_unref (caps);
+  if (!res)
+    return FALSE;
+
+  if (GST_VIDEO_INFO_INTERLACE_MODE (in_info) !=
+      GST_VIDEO_INFO_INTERLACE_MODE (out_info))
+    return FALSE;
+
+  /* The framerate is passed through unchanged */
+  GST_VIDEO_INFO_FPS_N (out_info) = GST_VIDEO_INFO_FPS_N (in_info);
+  GST_VIDEO_INFO_FPS_D (out_info) = GST_VIDEO_INFO_FPS_D (in_info);
+
+  /* Keep the input colorimetry like videoconvert would if the output caps
+   * don't ask for anything specific */
+  if (!gst_structure_has_field (gst_caps_get_structure (to_caps, 0),
+          "colorimetry")
+      && GST_VIDEO_INFO_IS_YUV (in_info) == GST_VIDEO_INFO_IS_YUV (out_info)
+      && GST_VIDEO_INFO_IS_GRAY (in_info) == GST_VIDEO_INFO_IS_GRAY (out_info))
+    out_info->colorimetry = in_info->colorimetry;
+
+  return TRUE;
+
+needs_negotiation:
+  {
+    gst_structure_free (s);
+    return FALSE;
+  }
+}
+
+/* Creates a converter doing what the videoconvert ! videoscale part of the
+ * conversion pipeline does, including the black borders to keep the DAR */
+static GstVideoConverter *
+convert_frame_direct_create_converter (const GstVideoInfo * in_info,
+    const GstVideoInfo * out_info, const GstVideoRectangle * src_rect)
+{
+  gint from_dar_n, from_dar_d, n, d;
+  gint borders_w = 0, borders_h = 0;
+  GstStructure *config;
+
+  if (gst_util_fraction_multiply (src_rect->w, src_rect->h,
+          GST_VIDEO_INFO_PAR_N (in_info), GST_VIDEO_INFO_PAR_D (in_info),
+          &from_dar_n, &from_dar_d)
+      && gst_util_fraction_multiply (from_dar_n, from_dar_d,
+          GST_VIDEO_INFO_PAR_D (out_info), GST_VIDEO_INFO_PAR_N (out_info),
+          &n, &d)) {
+    gint to_h, to_w;
+
+    to_h = gst_util_uint64_scale_int (GST_VIDEO_INFO_WIDTH (out_info), d, n);
+    if (to_h <= GST_VIDEO_INFO_HEIGHT (out_info)) {
+      borders_h = GST_VIDEO_INFO_HEIGHT (out_info) - to_h;
+    } else {
+      to_w = gst_util_uint64_scale_int (GST_VIDEO_INFO_HEIGHT (out_info), n, d);
+      borders_w = MAX (GST_VIDEO_INFO_WIDTH (out_info) - to_w, 0);
+    }
+  } else {
+    GST_WARNING ("Can't keep DAR!");
+  }
+
+  config = gst_structure_new ("GstVideoConvertSample",
+      GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+      GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_LINEAR,
+      GST_VIDEO_RESAMPLER_OPT_MAX_TAPS, G_TYPE_INT, 2,
+      GST_VIDEO_CONVERTER_OPT_SRC_X, G_TYPE_INT, src_rect->x,
+      GST_VIDEO_CONVERTER_OPT_SRC_Y, G_TYPE_INT, src_rect->y,
+      GST_VIDEO_CONVERTER_OPT_SRC_WIDTH, G_TYPE_INT, src_rect->w,
+      GST_VIDEO_CONVERTER_OPT_SRC_HEIGHT, G_TYPE_INT, src_rect->h,
+      GST_VIDEO_CONVERTER_OPT_DEST_X, G_TYPE_INT, borders_w / 2,
+      GST_VIDEO_CONVERTER_OPT_DEST_Y, G_TYPE_INT, borders_h / 2,
+      GST_VIDEO_CONVERTER_OPT_DEST_WIDTH, G_TYPE_INT,
+      GST_VIDEO_INFO_WIDTH (out_info) - borders_w,
+      GST_VIDEO_CONVERTER_OPT_DEST_HEIGHT, G_TYPE_INT,
+      GST_VIDEO_INFO_HEIGHT (out_info) - borders_h, NULL);
+
+  return gst_video_converter_new ((GstVideoInfo *) in_info,
+      (GstVideoInfo *) out_info, config);
+}
+
+static GstSample *
+convert_frame_direct (GstVideoConverter * convert, GstVideoInfo * in_info,
+    GstVideoInfo * out_info, GstBuffer * buf, GError ** error)
+{
+  GstVideoFrame in_frame, out_frame;
+  GstBuffer *outbuf;
+  GstCaps *caps;
+  GstSample *sample;
+
+  if (!gst_video_frame_map (&in_frame, in_info, buf, GST_MAP_READ))
+    goto map_failed;
+
+  outbuf = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (out_info),
+      NULL);
+  if (!gst_video_frame_map (&out_frame, out_info, outbuf, GST_MAP_WRITE)) {
+    gst_video_frame_unmap (&in_frame);
+    gst_buffer_unref (outbuf);
+    goto map_failed;
+  }
+
+  gst_video_converter_frame (convert, &in_frame, &out_frame);
+
+  gst_video_frame_unmap (&out_frame);
+  gst_video_frame_unmap (&in_frame);
+
+  gst_buffer_copy_into (outbuf, buf, GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+
+  caps = gst_video_info_to_caps (out_info);
+  sample = gst_sample_new (outbuf, caps, NULL, NULL);
+  gst_caps_unref (caps);
+  gst_buffer_unref (outbuf);
+
+  return sample;
+
+  /* ERRORS */
+map_failed:
+  {
+    GST_ERROR ("Could not convert video frame: failed to map buffer");
+    if (error)
+      *error = g_error_new (GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+          "Could not convert video frame: failed to map buffer");
+    return NULL;
+  }
+}
+
+#define DEFAULT_CONVERT_SAMPLE_CACHE_SIZE 4
+
+typedef struct
+{
+  GstVideoInfo in_info;
+  GstVideoInfo out_info;
+  GstVideoRectangle src_rect;
+  GstVideoConverter *convert;
+} GstVideoConvertSampleCacheEntry;
+
+struct _GstVideoConvertSampleCache
+{
+  GMutex lock;
+  /* GstVideoConvertSampleCacheEntry, most recently used first */
+  GQueue entries;
+  guint max_size;
+
+  guint64 hits;
+  guint64 misses;
+};
+
+static void
+convert_sample_cache_entry_free (GstVideoConvertSampleCacheEntry * entry)
+{
+  gst_video_converter_free (entry->convert);
+  g_slice_free (GstVideoConvertSampleCacheEntry, entry);
+}
+
+/* Takes a matching converter out of the cache so that it can be used without
+ * holding the lock. It is put back with convert_sample_cache_put() */
+static GstVideoConverter *
+convert_sample_cache_take (GstVideoConvertSampleCache * cache,
+    const GstVideoInfo * in_info, const GstVideoInfo * out_info,
+    const GstVideoRectangle * src_rect)
+{
+  GstVideoConverter *convert = NULL;
+  GList *l;
+
+  g_mutex_lock (&cache->lock);
+  for (l = cache->entries.head; l; l = l->next) {
+    GstVideoConvertSampleCacheEntry *entry = l->data;
+
+    if (entry->src_rect.x == src_rect->x && entry->src_rect.y == src_rect->y
+        && entry->src_rect.w == src_rect->w && entry->src_rect.h == src_rect->h
+        && gst_video_info_is_equal (&entry->in_info, in_info)
+        && gst_video_info_is_equal (&entry->out_info, out_info)) {
+      g_queue_delete_link (&cache->entries, l);
+      convert = entry->convert;
+      g_slice_free (GstVideoConvertSampleCacheEntry, entry);
+      break;
+    }
+  }
+  if (convert)
+    cache->hits++;
+  else
+    cache->misses++;
+  g_mutex_unlock (&cache->lock);
+
+  return convert;
+}
+
+static void
+convert_sample_cache_put (GstVideoConvertSampleCache * cache,
+    const GstVideoInfo * in_info, const GstVideoInfo * out_info,
+    const GstVideoRectangle * src_rect, GstVideoConverter * convert)
+{
+  GstVideoConvertSampleCacheEntry *entry;
+
+  entry = g_slice_new (GstVideoConvertSampleCacheEntry);
+  entry->in_info = *in_info;
+  entry->out_info = *out_info;
+  entry->src_rect = *src_rect;
+  entry->convert = convert;
+
+  g_mutex_lock (&cache->lock);
+  g_queue_push_head (&cache->entries, entry);
+  while (cache->entries.length > cache->max_size)
+    convert_sample_cache_entry_free (g_queue_pop_tail (&cache->entries));
+  g_mutex_unlock (&cache->lock);
+}
+
+static void
+convert_frame_timeout_error (GError ** error)
+{
+  GST_ERROR ("Could not convert video frame: timeout during conversion");
+  if (error)
+    *error = g_error_new (GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+        "Could not convert video frame: timeout during conversion");
+}
+
+/* Converts @sample without a pipeline if possible, using and filling @cache
+ * if not %NULL. Returns %FALSE if the conversion pipeline is needed, otherwise
+ * @result and @error are set accordingly.
+ *
+ * The conversion itself can't be interrupted, so a conversion that took
+ * longer than @timeout fails afterwards like the pipeline does. */
+static gboolean
+convert_sample_direct (GstVideoConvertSampleCache * cache, GstSample * sample,
+    const GstCaps * to_caps, GstClockTime timeout, GstSample ** result,
+    GError ** error)
+{
+  GstVideoInfo in_info, out_info;
+  GstVideoRectangle src_rect;
+  GstVideoConverter *convert = NULL;
+  GstVideoCropMeta *cmeta;
+  GstBuffer *buf;
+  GstCaps *from_caps;
+  gint64 deadline = -1;
+
+  buf = gst_sample_get_buffer (sample);
+  from_caps = gst_sample_get_caps (sample);
+  cmeta = gst_buffer_get_video_crop_meta (buf);
+
+  if (!convert_frame_direct_prepare (from_caps, cmeta, to_caps, &in_info,
+          &out_info, &src_rect))
+    return FALSE;
+
+  if (!cmeta && gst_video_info_is_equal (&in_info, &out_info)) {
+    GST_DEBUG ("no conversion needed");
+    *result = gst_sample_new (buf, from_caps, NULL, NULL);
+    return TRUE;
+  }
+
+  if (GST_CLOCK_TIME_IS_VALID (timeout))
+    deadline = g_get_monotonic_time () + GST_TIME_AS_USECONDS (timeout);
+
+  if (cache)
+    convert = convert_sample_cache_take (cache, &in_info, &out_info,
+        &src_rect);
+  if (!convert)
+    convert = convert_frame_direct_create_converter (&in_info, &out_info,
+        &src_rect);
+  if (!convert) {
+    GST_DEBUG ("no converter for direct conversion, using a pipeline");
+    return FALSE;
+  }
+
+  GST_DEBUG ("converting buffer %p directly to caps %" GST_PTR_FORMAT, buf,
+      to_caps);
+  *result = convert_frame_direct (convert, &in_info, &out_info, buf, error);
+
+  if (cache)
+    convert_sample_cache_put (cache, &in_info, &out_info, &src_rect, convert);
+  else
+    gst_video_converter_free (convert);
+
+  if (*result && deadline != -1 && g_get_monotonic_time () >= deadline) {
+    gst_sample_unref (*result);
+    *result = NULL;
+    convert_frame_timeout_error (error);
+  }
+
+  return TRUE;
+}
+
 /**
  * gst_video_convert_sample:
  * @sample: a #GstSample
@@ -334,35 +730,26 @@ link_failed:
 GstSample *
 gst_video_convert_sample (GstSample * sample, const GstCaps * to_caps,
     GstClockTime timeout, GError ** error)
+{
+  return gst_video_convert_sample_cache_convert (NULL, sample, to_caps,
+      timeout, error);
+}
+
+static GstSample *
+convert_sample_pipeline (GstSample * sample, GstCaps * to_caps_copy,
+    GstClockTime timeout, GError ** error)
 {
   GstMessage *msg;
   GstBuffer *buf;
   GstSample *result = NULL;
   GError *err = NULL;
   GstBus *bus;
-  GstCaps *from_caps, *to_caps_copy = NULL;
+  GstCaps *from_caps;
   GstFlowReturn ret;
   GstElement *pipeline, *src, *sink;
-  guint i, n;
-
-  g_return_val_if_fail (sample != NULL, NULL);
-  g_return_val_if_fail (to_caps != NULL, NULL);
 
   buf = gst_sample_get_buffer (sample);
-  g_return_val_if_fail (buf != NULL, NULL);
-
   from_caps = gst_sample_get_caps (sample);
-  g_return_val_if_fail (from_caps != NULL, NULL);
-
-  to_caps_copy = gst_caps_new_empty ();
-  n = gst_caps_get_size (to_caps);
-  for (i = 0; i < n; i++) {
-    GstStructure *s = gst_caps_get_structure (to_caps, i);
-
-    s = gst_structure_copy (s);
-    gst_structure_remove_field (s, "framerate");
-    gst_caps_append_structure (to_caps_copy, s);
-  }
 
   pipeline =
       build_convert_frame_pipeline (&src, &sink, from_caps,
@@ -424,16 +811,12 @@ gst_video_convert_sample (GstSample * sample, const GstCaps * to_caps,
     }
     gst_message_unref (msg);
   } else {
-    GST_ERROR ("Could not convert video frame: timeout during conversion");
-    if (error)
-      *error = g_error_new (GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
-          "Could not convert video frame: timeout during conversion");
+    convert_frame_timeout_error (error);
   }
 
   gst_element_set_state (pipeline, GST_STATE_NULL);
   gst_object_unref (bus);
   gst_object_unref (pipeline);
-  gst_caps_unref (to_caps_copy);
 
   return result;
 
@@ -441,8 +824,6 @@ gst_video_convert_sample (GstSample * sample, const GstCaps * to_caps,
 no_pipeline:
 state_change_failed:
   {
-    gst_caps_unref (to_caps_copy);
-
     if (error)
       *error = err;
     else
@@ -452,6 +833,135 @@ state_change_failed:
   }
 }
 
+/**
+ * gst_video_convert_sample_cache_new:
+ * @max_converters: the maximum number of converters to keep around, or 0
+ *   for a default
+ *
+ * Creates a new cache for gst_video_convert_sample_cache_convert().
+ *
+ * The cache keeps the #GstVideoConverter instances used for raw to raw
+ * conversions around, keyed by the input and output caps, so that repeated
+ * conversions of samples with identical caps don't need to set up the
+ * conversion again. It can be used from multiple threads at once.
+ *
+ * Returns: (transfer full): a new #GstVideoConvertSampleCache. Free with
+ *   gst_video_convert_sample_cache_free().
+ *
+ * Since: 1.22
+ */
+GstVideoConvertSampleCache *
+gst_video_convert_sample_cache_new (guint max_converters)
+{
+  GstVideoConvertSampleCache *cache;
+
+  cache = g_slice_new0 (GstVideoConvertSampleCache);
+  g_mutex_init (&cache->lock);
+  g_queue_init (&cache->entries);
+  cache->max_size =
+      max_converters ? max_converters : DEFAULT_CONVERT_SAMPLE_CACHE_SIZE;
+
+  return cache;
+}
+
+/**
+ * gst_video_convert_sample_cache_free:
+ * @cache: a #GstVideoConvertSampleCache
+ *
+ * Frees @cache and all converters it still holds.
+ *
+ * Since: 1.22
+ */
+void
+gst_video_convert_sample_cache_free (GstVideoConvertSampleCache * cache)
+{
+  g_return_if_fail (cache != NULL);
+
+  g_queue_foreach (&cache->entries, (GFunc) convert_sample_cache_entry_free,
+      NULL);
+  g_queue_clear (&cache->entries);
+  g_mutex_clear (&cache->lock);
+  g_slice_free (GstVideoConvertSampleCache, cache);
+}
+
+/**
+ * gst_video_convert_sample_cache_get_stats:
+ * @cache: a #GstVideoConvertSampleCache
+ *
+ * Returns statistics about @cache, with the following fields:
+ *
+ * * "hits" G_TYPE_UINT64: the number of conversions that reused a converter
+ * * "misses" G_TYPE_UINT64: the number of conversions that had to create
+ *   a converter
+ * * "converters" G_TYPE_UINT: the number of converters currently kept
+ *
+ * Returns: (transfer full): a new #GstStructure
+ *
+ * Since: 1.22
+ */
+GstStructure *
+gst_video_convert_sample_cache_get_stats (GstVideoConvertSampleCache * cache)
+{
+  GstStructure *s;
+
+  g_return_val_if_fail (cache != NULL, NULL);
+
+  g_mutex_lock (&cache->lock);
+  s = gst_structure_new ("application/x-gst-video-convert-sample-cache-stats",
+      "hits", G_TYPE_UINT64, cache->hits,
+      "misses", G_TYPE_UINT64, cache->misses,
+      "converters", G_TYPE_UINT, cache->entries.length, NULL);
+  g_mutex_unlock (&cache->lock);
+
+  return s;
+}
+
+/**
+ * gst_video_convert_sample_cache_convert:
+ * @cache: (nullable): a #GstVideoConvertSampleCache
+ * @sample: a #GstSample
+ * @to_caps: the #GstCaps to convert to
+ * @timeout: the maximum amount of time allowed for the processing.
+ * @error: pointer to a #GError. Can be %NULL.
+ *
+ * Like gst_video_convert_sample() but reuses the converters kept in @cache.
+ *
+ * Conversions between raw video in system memory are done directly with a
+ * #GstVideoConverter if the output caps either specify width, height and
+ * pixel-aspect-ratio or leave all of them to the input. Only other
+ * conversions, e.g. to image formats, build a conversion pipeline. A direct
+ * conversion can't be interrupted, it fails once it is done if it took longer
+ * than @timeout.
+ *
+ * Returns: The converted #GstSample, or %NULL if an error happened (in which case @err
+ * will point to the #GError).
+ *
+ * Since: 1.22
+ */
+GstSample *
+gst_video_convert_sample_cache_convert (GstVideoConvertSampleCache * cache,
+    GstSample * sample, const GstCaps * to_caps, GstClockTime timeout,
+    GError ** error)
+{
+  GstSample *result = NULL;
+  GstCaps *to_caps_copy;
+
+  g_return_val_if_fail (sample != NULL, NULL);
+  g_return_val_if_fail (to_caps != NULL, NULL);
+  g_return_val_if_fail (gst_sample_get_buffer (sample) != NULL, NULL);
+  g_return_val_if_fail (gst_sample_get_caps (sample) != NULL, NULL);
+
+  to_caps_copy = copy_caps_without_framerate (to_caps);
+
+  if (!convert_sample_direct (cache, sample, to_caps_copy, timeout, &result,
+          error))
+    result = convert_sample_pipeline (sample, to_caps_copy, timeout, error);
+
+  gst_caps_unref (to_caps_copy);
+
+  return result;
+}
+
 typedef struct
 {
   gint ref_count;
@@ -725,7 +1235,6 @@ gst_video_convert_sample_async (GstSample * sample,
   GstBuffer *buf;
   GstCaps *from_caps, *to_caps_copy = NULL;
   GstElement *pipeline, *src, *sink;
-  guint i, n;
   GSource *source;
   GstVideoConvertSampleContext *ctx;
 
@@ -744,15 +1253,7 @@ gst_video_convert_sample_async (GstSample * sample,
   if (!context)
     context = g_main_context_default ();
 
-  to_caps_copy = gst_caps_new_empty ();
-  n = gst_caps_get_size (to_caps);
-  for (i = 0; i < n; i++) {
-    GstStructure *s = gst_caps_get_structure (to_caps, i);
-
-    s = gst_structure_copy (s);
-    gst_structure_remove_field (s, "framerate");
-    gst_caps_append_structure (to_caps_copy, s);
-  }
+  to_caps_copy = copy_caps_without_framerate (to_caps);
 
   /* There's a reference cycle between the context and the pipeline, which is
    * broken up once the finish() is called on the context. At latest when the
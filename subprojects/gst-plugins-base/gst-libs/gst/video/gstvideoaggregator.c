@@ -2968,6 +2968,10 @@ gst_video_aggregator_sink_query (GstAggregator * agg, GstAggregatorPad * bpad,
  * Subclasses can add their own operation to perform using the returned
  * #GstTaskPool during #GstVideoAggregatorClass::aggregate_frames().
  *
+ * Since 1.22 this is the pool returned by
+ * gst_parallelized_task_runner_get_default_pool(), shared by all aggregators
+ * and other video processing. It must not be cleaned up.
+ *
  * Returns: (transfer full): the #GstTaskPool that can be used by subclasses
  *     for performing concurrent operations
  *
@@ -2990,8 +2994,6 @@ gst_video_aggregator_finalize (GObject * o)
   g_mutex_clear (&vagg->priv->lock);
   g_ptr_array_unref (vagg->priv->supported_formats);
 
-  if (vagg->priv->task_pool)
-    gst_task_pool_cleanup (vagg->priv->task_pool);
   gst_clear_object (&vagg->priv->task_pool);
 
   G_OBJECT_CLASS (gst_video_aggregator_parent_class)->finalize (o);
@@ -3132,8 +3134,5 @@ gst_video_aggregator_init (GstVideoAggregator * vagg,
 
   gst_caps_unref (src_template);
 
-  vagg->priv->task_pool = gst_shared_task_pool_new ();
-  gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (vagg->
-          priv->task_pool), g_get_num_processors ());
-  gst_task_pool_prepare (vagg->priv->task_pool, NULL);
+  vagg->priv->task_pool = gst_parallelized_task_runner_get_default_pool ();
 }
@@ -28,6 +28,16 @@
  * The videofilter will by default enable QoS on the parent GstBaseTransform
  * to implement frame dropping.
  *
+ * Subclasses whose processing of a line only depends on a bounded part of the
+ * frame can implement the #GstVideoFilterClass.transform_frame_slice() and
+ * #GstVideoFilterClass.transform_frame_ip_slice() vmethods instead of the
+ * whole-frame variants. The frame is then split into horizontal slices which
+ * are processed in parallel by up to gst_video_filter_get_n_threads() threads.
+ * By default these threads come from the pool returned by
+ * gst_parallelized_task_runner_get_default_pool(), which is shared by all video
+ * processing in the process. gst_video_filter_set_task_pool() makes it use
+ * the threads of another pool instead.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -43,10 +53,44 @@
 GST_DEBUG_CATEGORY_STATIC (gst_video_filter_debug);
 #define GST_CAT_DEFAULT gst_video_filter_debug
 
+#define DEFAULT_N_THREADS 1
+
+/* Slices smaller than this are not worth the synchronization overhead,
+ * same heuristic as in the video converter */
+#define MIN_LINES_PER_SLICE 200
+
+typedef struct _GstVideoFilterPrivate GstVideoFilterPrivate;
+typedef struct _GstVideoFilterSlice GstVideoFilterSlice;
+
+struct _GstVideoFilterPrivate
+{
+  /* protected by the object lock */
+  guint n_threads;
+  GstTaskPool *task_pool;
+
+  /* only accessed from the streaming thread */
+  GstParallelizedTaskRunner *runner;
+  guint runner_threads;
+  GstTaskPool *runner_pool;
+};
+
+struct _GstVideoFilterSlice
+{
+  GstVideoFilter *filter;
+  GstVideoFrame *in_frame;
+  GstVideoFrame *out_frame;
+  guint start_line;
+  guint end_line;
+  GstFlowReturn ret;
+};
+
 #define gst_video_filter_parent_class parent_class
-G_DEFINE_ABSTRACT_TYPE (GstVideoFilter, gst_video_filter,
+G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GstVideoFilter, gst_video_filter,
     GST_TYPE_BASE_TRANSFORM);
 
+#define GET_PRIV(filter) \
+    ((GstVideoFilterPrivate *) gst_video_filter_get_instance_private (filter))
+
 /* cached quark to avoid contention on the global quark table lock */
 #define META_TAG_VIDEO meta_tag_video_quark
 static GQuark meta_tag_video_quark;
@@ -231,9 +275,11 @@ gst_video_filter_set_caps (GstBaseTransform * trans, GstCaps * incaps,
   if (res) {
     filter->in_info = in_info;
     filter->out_info = out_info;
-    if (fclass->transform_frame == NULL)
+    if (fclass->transform_frame == NULL
+        && fclass->transform_frame_slice == NULL)
       gst_base_transform_set_in_place (trans, TRUE);
-    if (fclass->transform_frame_ip == NULL)
+    if (fclass->transform_frame_ip == NULL
+        && fclass->transform_frame_ip_slice == NULL)
       GST_BASE_TRANSFORM_CLASS (fclass)->transform_ip_on_passthrough = FALSE;
   }
   filter->negotiated = res;
@@ -249,6 +295,106 @@ invalid_caps:
   }
 }
 
+static void
+gst_video_filter_slice_func (gpointer data)
+{
+  GstVideoFilterSlice *slice = data;
+  GstVideoFilter *filter = slice->filter;
+  GstVideoFilterClass *fclass = GST_VIDEO_FILTER_GET_CLASS (filter);
+
+  /* can happen for the last slice after aligning the slice height */
+  if (slice->start_line == slice->end_line)
+    return;
+
+  if (slice->in_frame) {
+    slice->ret = fclass->transform_frame_slice (filter, slice->in_frame,
+        slice->out_frame, slice->start_line, slice->end_line);
+  } else {
+    slice->ret = fclass->transform_frame_ip_slice (filter, slice->out_frame,
+        slice->start_line, slice->end_line);
+  }
+}
+
+/* Splits @out_frame into slices and calls the slice vmethods on them in
+ * parallel */
+static GstFlowReturn
+gst_video_filter_run_slices (GstVideoFilter * filter, GstVideoFrame * in_frame,
+    GstVideoFrame * out_frame)
+{
+  GstVideoFilterPrivate *priv = GET_PRIV (filter);
+  GstVideoFilterSlice *slices;
+  gpointer *slices_p;
+  guint n_threads, n_slices, height, align, lines, i;
+  GstTaskPool *task_pool;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  GST_OBJECT_LOCK (filter);
+  n_threads = priv->n_threads;
+  task_pool = priv->task_pool ? gst_object_ref (priv->task_pool) : NULL;
+  GST_OBJECT_UNLOCK (filter);
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  height = GST_VIDEO_FRAME_HEIGHT (out_frame);
+  align = gst_video_filter_get_line_alignment (&out_frame->info);
+  if (in_frame)
+    align = MAX (align, gst_video_filter_get_line_alignment (&in_frame->info));
+
+  n_slices = MIN (n_threads, height / MIN_LINES_PER_SLICE);
+  if (GST_VIDEO_FORMAT_INFO_IS_TILED (out_frame->info.finfo) ||
+      (in_frame && GST_VIDEO_FORMAT_INFO_IS_TILED (in_frame->info.finfo)))
+    n_slices = 1;
+  n_slices = MAX (n_slices, 1);
+
+  if (n_slices > 1 && (priv->runner_threads != n_slices ||
+          priv->runner_pool != task_pool)) {
+    if (priv->runner)
+      gst_parallelized_task_runner_free (priv->runner);
+    /* without a pool the runner uses the process-wide default pool */
+    priv->runner =
+        gst_parallelized_task_runner_new (n_slices, task_pool, FALSE);
+    priv->runner_threads = n_slices;
+    gst_object_replace ((GstObject **) & priv->runner_pool,
+        (GstObject *) task_pool);
+  }
+  gst_clear_object (&task_pool);
+  /* the runner can't use more threads than a shared pool has */
+  if (n_slices > 1)
+    n_slices = gst_parallelized_task_runner_get_n_threads (priv->runner);
+
+  lines = GST_ROUND_UP_N ((height + n_slices - 1) / n_slices, align);
+
+  slices = g_newa (GstVideoFilterSlice, n_slices);
+  for (i = 0; i < n_slices; i++) {
+    slices[i].filter = filter;
+    slices[i].in_frame = in_frame;
+    slices[i].out_frame = out_frame;
+    slices[i].start_line = MIN (i * lines, height);
+    slices[i].end_line = MIN ((i + 1) * lines, height);
+    slices[i].ret = GST_FLOW_OK;
+  }
+
+  GST_LOG_OBJECT (filter, "processing %u lines in %u slices", height,
+      n_slices);
+
+  if (n_slices > 1) {
+    slices_p = g_newa (gpointer, n_slices);
+    for (i = 0; i < n_slices; i++)
+      slices_p[i] = &slices[i];
+
+    gst_parallelized_task_runner_run (priv->runner,
+        gst_video_filter_slice_func, slices_p);
+  } else {
+    gst_video_filter_slice_func (&slices[0]);
+  }
+
+  for (i = 0; i < n_slices && ret == GST_FLOW_OK; i++)
+    ret = slices[i].ret;
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_video_filter_transform (GstBaseTransform * trans, GstBuffer * inbuf,
     GstBuffer * outbuf)
@@ -261,7 +407,7 @@ gst_video_filter_transform (GstBaseTransform * trans, GstBuffer * inbuf,
     goto unknown_format;
 
   fclass = GST_VIDEO_FILTER_GET_CLASS (filter);
-  if (fclass->transform_frame) {
+  if (fclass->transform_frame || fclass->transform_frame_slice) {
     GstVideoFrame in_frame, out_frame;
 
     if (!gst_video_frame_map (&in_frame, &filter->in_info, inbuf,
@@ -273,7 +419,10 @@ gst_video_filter_transform (GstBaseTransform * trans, GstBuffer * inbuf,
       gst_video_frame_unmap (&in_frame);
       goto invalid_buffer;
     }
-    res = fclass->transform_frame (filter, &in_frame, &out_frame);
+    if (fclass->transform_frame_slice)
+      res = gst_video_filter_run_slices (filter, &in_frame, &out_frame);
+    else
+      res = fclass->transform_frame (filter, &in_frame, &out_frame);
 
     gst_video_frame_unmap (&out_frame);
     gst_video_frame_unmap (&in_frame);
@@ -310,7 +459,7 @@ gst_video_filter_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
     goto unknown_format;
 
   fclass = GST_VIDEO_FILTER_GET_CLASS (filter);
-  if (fclass->transform_frame_ip) {
+  if (fclass->transform_frame_ip || fclass->transform_frame_ip_slice) {
     GstVideoFrame frame;
     GstMapFlags flags;
 
@@ -322,7 +471,10 @@ gst_video_filter_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
     if (!gst_video_frame_map (&frame, &filter->in_info, buf, flags))
       goto invalid_buffer;
 
-    res = fclass->transform_frame_ip (filter, &frame);
+    if (fclass->transform_frame_ip_slice)
+      res = gst_video_filter_run_slices (filter, NULL, &frame);
+    else
+      res = fclass->transform_frame_ip (filter, &frame);
 
     gst_video_frame_unmap (&frame);
   } else {
@@ -364,15 +516,32 @@ gst_video_filter_transform_meta (GstBaseTransform * trans, GstBuffer * outbuf,
       meta, inbuf);
 }
 
+static void
+gst_video_filter_finalize (GObject * object)
+{
+  GstVideoFilterPrivate *priv = GET_PRIV (GST_VIDEO_FILTER_CAST (object));
+
+  if (priv->runner)
+    gst_parallelized_task_runner_free (priv->runner);
+  gst_clear_object (&priv->runner_pool);
+  gst_clear_object (&priv->task_pool);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
 static void
 gst_video_filter_class_init (GstVideoFilterClass * g_class)
 {
+  GObjectClass *gobject_class;
   GstBaseTransformClass *trans_class;
   GstVideoFilterClass *klass;
 
   klass = (GstVideoFilterClass *) g_class;
+  gobject_class = (GObjectClass *) klass;
   trans_class = (GstBaseTransformClass *) klass;
 
+  gobject_class->finalize = gst_video_filter_finalize;
+
   trans_class->set_caps = GST_DEBUG_FUNCPTR (gst_video_filter_set_caps);
   trans_class->propose_allocation =
       GST_DEBUG_FUNCPTR (gst_video_filter_propose_allocation);
@@ -401,6 +570,175 @@ gst_video_filter_init (GstVideoFilter * instance)
   GST_DEBUG_OBJECT (videofilter, "gst_video_filter_init");
 
   videofilter->negotiated = FALSE;
+  GET_PRIV (videofilter)->n_threads = DEFAULT_N_THREADS;
   /* enable QoS */
   gst_base_transform_set_qos_enabled (GST_BASE_TRANSFORM (videofilter), TRUE);
 }
+
+/**
+ * gst_video_filter_set_n_threads:
+ * @filter: a #GstVideoFilter
+ * @n_threads: maximum number of threads, or 0 for the number of processors
+ *
+ * Sets the maximum number of threads used to process a frame when the
+ * subclass implements #GstVideoFilterClass.transform_frame_slice() or
+ * #GstVideoFilterClass.transform_frame_ip_slice(). The default is 1, which
+ * processes the whole frame in the streaming thread.
+ *
+ * Subclasses usually expose this as an "n-threads" property.
+ *
+ * Since: 1.22
+ */
+void
+gst_video_filter_set_n_threads (GstVideoFilter * filter, guint n_threads)
+{
+  g_return_if_fail (GST_IS_VIDEO_FILTER (filter));
+
+  GST_OBJECT_LOCK (filter);
+  GET_PRIV (filter)->n_threads = n_threads;
+  GST_OBJECT_UNLOCK (filter);
+}
+
+/**
+ * gst_video_filter_get_n_threads:
+ * @filter: a #GstVideoFilter
+ *
+ * Returns: the maximum number of threads set with
+ * gst_video_filter_set_n_threads()
+ *
+ * Since: 1.22
+ */
+guint
+gst_video_filter_get_n_threads (GstVideoFilter * filter)
+{
+  guint n_threads;
+
+  g_return_val_if_fail (GST_IS_VIDEO_FILTER (filter), 0);
+
+  GST_OBJECT_LOCK (filter);
+  n_threads = GET_PRIV (filter)->n_threads;
+  GST_OBJECT_UNLOCK (filter);
+
+  return n_threads;
+}
+
+/**
+ * gst_video_filter_set_task_pool:
+ * @filter: a #GstVideoFilter
+ * @pool: (nullable): a prepared #GstTaskPool, or %NULL
+ *
+ * Makes @filter process the slices of a frame on the threads of @pool
+ * instead of the process-wide pool returned by
+ * gst_parallelized_task_runner_get_default_pool(), for example a pool of its
+ * own to opt out of sharing threads with other video processing. If @pool is
+ * a #GstSharedTaskPool, the number of slices is limited to its maximum
+ * number of threads.
+ *
+ * With %NULL, the default, @filter uses the process-wide pool again.
+ *
+ * Since: 1.22
+ */
+void
+gst_video_filter_set_task_pool (GstVideoFilter * filter, GstTaskPool * pool)
+{
+  g_return_if_fail (GST_IS_VIDEO_FILTER (filter));
+  g_return_if_fail (pool == NULL || GST_IS_TASK_POOL (pool));
+
+  GST_OBJECT_LOCK (filter);
+  gst_object_replace ((GstObject **) & GET_PRIV (filter)->task_pool,
+      (GstObject *) pool);
+  GST_OBJECT_UNLOCK (filter);
+}
+
+/**
+ * gst_video_filter_get_task_pool:
+ * @filter: a #GstVideoFilter
+ *
+ * Returns: (transfer full) (nullable): the #GstTaskPool set with
+ * gst_video_filter_set_task_pool(), or %NULL
+ *
+ * Since: 1.22
+ */
+GstTaskPool *
+gst_video_filter_get_task_pool (GstVideoFilter * filter)
+{
+  GstTaskPool *pool = NULL;
+
+  g_return_val_if_fail (GST_IS_VIDEO_FILTER (filter), NULL);
+
+  GST_OBJECT_LOCK (filter);
+  if (GET_PRIV (filter)->task_pool)
+    pool = gst_object_ref (GET_PRIV (filter)->task_pool);
+  GST_OBJECT_UNLOCK (filter);
+
+  return pool;
+}
+
+/**
+ * gst_video_filter_get_line_alignment:
+ * @info: a #GstVideoInfo
+ *
+ * Get the number of consecutive lines that share the same chroma samples in
+ * frames described by @info. The slices passed to
+ * #GstVideoFilterClass.transform_frame_slice() and
+ * #GstVideoFilterClass.transform_frame_ip_slice() always start on a multiple
+ * of it for both frames.
+ *
+ * Returns: the number of lines
+ *
+ * Since: 1.22
+ */
+guint
+gst_video_filter_get_line_alignment (const GstVideoInfo * info)
+{
+  guint i, h_sub = 0;
+
+  g_return_val_if_fail (info != NULL, 1);
+
+  for (i = 0; i < GST_VIDEO_INFO_N_COMPONENTS (info); i++)
+    h_sub = MAX (h_sub, GST_VIDEO_FORMAT_INFO_H_SUB (info->finfo, i));
+
+  return 1 << h_sub;
+}
+
+/**
+ * gst_video_filter_get_frame_slice:
+ * @frame: a mapped #GstVideoFrame
+ * @slice: (out caller-allocates): the #GstVideoFrame to set up
+ * @start_line: the first line of the slice
+ * @end_line: the line after the last line of the slice
+ *
+ * Set up @slice to refer to the lines from @start_line up to, but not
+ * including, @end_line of @frame. @slice has the height of the slice and its
+ * plane data points into @frame, so that functions processing a whole frame
+ * can be used unchanged in #GstVideoFilterClass.transform_frame_slice().
+ *
+ * @slice does not hold a mapping of its own and must not be unmapped.
+ *
+ * Since: 1.22
+ */
+void
+gst_video_filter_get_frame_slice (const GstVideoFrame * frame,
+    GstVideoFrame * slice, guint start_line, guint end_line)
+{
+  const GstVideoFormatInfo *finfo;
+  gint comp[GST_VIDEO_MAX_COMPONENTS];
+  guint i;
+
+  g_return_if_fail (frame != NULL);
+  g_return_if_fail (slice != NULL);
+  g_return_if_fail (start_line <= end_line);
+  g_return_if_fail (end_line <= GST_VIDEO_FRAME_HEIGHT (frame));
+
+  finfo = frame->info.finfo;
+
+  *slice = *frame;
+  GST_VIDEO_INFO_HEIGHT (&slice->info) = end_line - start_line;
+
+  for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (frame); i++) {
+    gst_video_format_info_component (finfo, i, comp);
+    slice->data[i] = (guint8 *) frame->data[i] +
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, comp[0], start_line) *
+        GST_VIDEO_FRAME_PLANE_STRIDE (frame, i);
+  }
+}
@@ -75,13 +75,59 @@ struct _GstVideoFilterClass {
                                        GstVideoFrame *inframe, GstVideoFrame *outframe);
   GstFlowReturn (*transform_frame_ip) (GstVideoFilter *trans, GstVideoFrame *frame);
 
+  /**
+   * GstVideoFilterClass::transform_frame_slice:
+   *
+   * Transform the lines from @start_line up to, but not including, @end_line
+   * of @outframe. When set, this is used instead of transform_frame() and
+   * can be called from multiple threads at once for different slices of the
+   * same frame. Slice boundaries are aligned to the vertical chroma
+   * subsampling of both frames. gst_video_filter_get_frame_slice() returns a
+   * frame covering only the lines of the slice.
+   *
+   * Since: 1.22
+   */
+  GstFlowReturn (*transform_frame_slice)    (GstVideoFilter *filter,
+                                             GstVideoFrame *inframe, GstVideoFrame *outframe,
+                                             guint start_line, guint end_line);
+
+  /**
+   * GstVideoFilterClass::transform_frame_ip_slice:
+   *
+   * Same as transform_frame_slice() for in place transformations. When set,
+   * this is used instead of transform_frame_ip().
+   *
+   * Since: 1.22
+   */
+  GstFlowReturn (*transform_frame_ip_slice) (GstVideoFilter *filter, GstVideoFrame *frame,
+                                             guint start_line, guint end_line);
+
   /*< private >*/
-  gpointer _gst_reserved[GST_PADDING];
+  gpointer _gst_reserved[GST_PADDING - 2];
 };
 
 GST_VIDEO_API
 GType gst_video_filter_get_type (void);
 
+GST_VIDEO_API
+void  gst_video_filter_set_n_threads (GstVideoFilter *filter, guint n_threads);
+
+GST_VIDEO_API
+guint gst_video_filter_get_n_threads (GstVideoFilter *filter);
+
+GST_VIDEO_API
+void  gst_video_filter_set_task_pool (GstVideoFilter *filter, GstTaskPool *pool);
+
+GST_VIDEO_API
+GstTaskPool * gst_video_filter_get_task_pool (GstVideoFilter *filter);
+
+GST_VIDEO_API
+guint gst_video_filter_get_line_alignment (const GstVideoInfo *info);
+
+GST_VIDEO_API
+void  gst_video_filter_get_frame_slice (const GstVideoFrame *frame, GstVideoFrame *slice,
+                                        guint start_line, guint end_line);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstVideoFilter, gst_object_unref)
 
 G_END_DECLS
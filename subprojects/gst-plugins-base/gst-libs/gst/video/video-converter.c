@@ -30,6 +30,7 @@
 #endif
 
 #include "video-converter.h"
+#include "video-task-runner.h"
 
 #include <glib.h>
 #include <string.h>
@@ -116,175 +117,6 @@ ensure_debug_category (void)
 #define ensure_debug_category() /* NOOP */
 #endif /* GST_DISABLE_GST_DEBUG */
 
-typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
-
-typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
-typedef struct _GstParallelizedWorkItem GstParallelizedWorkItem;
-
-struct _GstParallelizedWorkItem
-{
-  GstParallelizedTaskRunner *self;
-  GstParallelizedTaskFunc func;
-  gpointer user_data;
-};
-
-struct _GstParallelizedTaskRunner
-{
-  GstTaskPool *pool;
-  gboolean own_pool;
-  guint n_threads;
-
-  GstQueueArray *tasks;
-  GstQueueArray *work_items;
-
-  GMutex lock;
-
-  gboolean async_tasks;
-};
-
-static void
-gst_parallelized_task_thread_func (gpointer data)
-{
-  GstParallelizedTaskRunner *runner = data;
-  GstParallelizedWorkItem *work_item;
-
-  g_mutex_lock (&runner->lock);
-  work_item = gst_queue_array_pop_head (runner->work_items);
-  g_mutex_unlock (&runner->lock);
-
-  g_assert (work_item != NULL);
-  g_assert (work_item->func != NULL);
-
-
-  work_item->func (work_item->user_data);
-  if (runner->async_tasks)
-    g_free (work_item);
-}
-
-static void
-gst_parallelized_task_runner_join (GstParallelizedTaskRunner * self)
-{
-  gboolean joined = FALSE;
-
-  while (!joined) {
-    g_mutex_lock (&self->lock);
-    if (!(joined = gst_queue_array_is_empty (self->tasks))) {
-      gpointer task = gst_queue_array_pop_head (self->tasks);
-      g_mutex_unlock (&self->lock);
-      gst_task_pool_join (self->pool, task);
-    } else {
-      g_mutex_unlock (&self->lock);
-    }
-  }
-}
-
-static void
-gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
-{
-  gst_parallelized_task_runner_join (self);
-
-  gst_queue_array_free (self->work_items);
-  gst_queue_array_free (self->tasks);
-  if (self->own_pool)
-    gst_task_pool_cleanup (self->pool);
-  gst_object_unref (self->pool);
-  g_mutex_clear (&self->lock);
-  g_free (self);
-}
-
-static GstParallelizedTaskRunner *
-gst_parallelized_task_runner_new (guint n_threads, GstTaskPool * pool,
-    gboolean async_tasks)
-{
-  GstParallelizedTaskRunner *self;
-
-  if (n_threads == 0)
-    n_threads = g_get_num_processors ();
-
-  self = g_new0 (GstParallelizedTaskRunner, 1);
-
-  if (pool) {
-    self->pool = g_object_ref (pool);
-    self->own_pool = FALSE;
-
-    /* No reason to split up the work between more threads than the
-     * pool can spawn */
-    if (GST_IS_SHARED_TASK_POOL (pool))
-      n_threads =
-          MIN (n_threads,
-          gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool)));
-  } else {
-    self->pool = gst_shared_task_pool_new ();
-    self->own_pool = TRUE;
-    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (self->pool),
-        n_threads);
-    gst_task_pool_prepare (self->pool, NULL);
-  }
-
-  self->tasks = gst_queue_array_new (n_threads);
-  self->work_items = gst_queue_array_new (n_threads);
-
-  self->n_threads = n_threads;
-
-  g_mutex_init (&self->lock);
-
-  /* Set when scheduling a job */
-  self->async_tasks = async_tasks;
-
-  return self;
-}
-
-static void
-gst_parallelized_task_runner_finish (GstParallelizedTaskRunner * self)
-{
-  gst_parallelized_task_runner_join (self);
-}
-
-static void
-gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
-    GstParallelizedTaskFunc func, gpointer * task_data)
-{
-  guint n_threads = self->n_threads;
-
-  if (n_threads > 1 || self->async_tasks) {
-    guint i = 0;
-    g_mutex_lock (&self->lock);
-    if (!self->async_tasks) {
-      /* if not async, perform one of the functions in the current thread */
-      i = 1;
-    }
-    for (; i < n_threads; i++) {
-      gpointer task;
-      GstParallelizedWorkItem *work_item;
-
-      if (!self->async_tasks)
-        work_item = g_newa (GstParallelizedWorkItem, 1);
-      else
-        work_item = g_new0 (GstParallelizedWorkItem, 1);
-
-      work_item->self = self;
-      work_item->func = func;
-      work_item->user_data = task_data[i];
-      gst_queue_array_push_tail (self->work_items, work_item);
-
-      task =
-          gst_task_pool_push (self->pool, gst_parallelized_task_thread_func,
-          self, NULL);
-
-      /* The return value of push() is unfortunately nullable, and we can't deal with that */
-      g_assert (task != NULL);
-      gst_queue_array_push_tail (self->tasks, task);
-    }
-    g_mutex_unlock (&self->lock);
-  }
-
-  if (!self->async_tasks) {
-    func (task_data[0]);
-
-    gst_parallelized_task_runner_finish (self);
-  }
-}
-
 typedef struct _GstLineCache GstLineCache;
 
 #define SCALE    (8)
@@ -2124,11 +1956,14 @@ setup_allocators (GstVideoConverter * convert)
   GDestroyNotify notify;
   gint width;
   gint i;
+  guint n_threads;
 
   width = MAX (convert->in_maxwidth, convert->out_maxwidth);
   width += convert->out_x;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
 
-  for (i = 0; i < convert->conversion_runner->n_threads; i++) {
+  for (i = 0; i < n_threads; i++) {
     /* start with using dest lines if we can directly write into it */
     if (convert->identity_pack) {
       alloc_line = get_dest_line;
@@ -2308,6 +2143,8 @@ convert_get_alpha_mode (GstVideoConverter * convert)
  *
  * The optional @pool can be used to spawn threads, this is useful when
  * creating new converters rapidly, for example when updating cropping.
+ * Without @pool, threads are taken from the pool returned by
+ * gst_parallelized_task_runner_get_default_pool().
  *
  * Returns: a #GstVideoConverter or %NULL if conversion is not possible.
  *
@@ -2582,11 +2419,14 @@ clear_matrix_data (MatrixData * data)
 void
 gst_video_converter_free (GstVideoConverter * convert)
 {
-  guint i, j;
+  guint i, j, n_threads;
 
   g_return_if_fail (convert != NULL);
 
-  for (i = 0; i < convert->conversion_runner->n_threads; i++) {
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
+
+  for (i = 0; i < n_threads; i++) {
     if (convert->upsample_p && convert->upsample_p[i])
       gst_video_chroma_resample_free (convert->upsample_p[i]);
     if (convert->upsample_i && convert->upsample_i[i])
@@ -2648,7 +2488,7 @@ gst_video_converter_free (GstVideoConverter * convert)
   g_free (convert->gamma_enc.gamma_table);
 
   if (convert->tmpline) {
-    for (i = 0; i < convert->conversion_runner->n_threads; i++)
+    for (i = 0; i < n_threads; i++)
       g_free (convert->tmpline[i]);
     g_free (convert->tmpline);
   }
@@ -2659,7 +2499,7 @@ gst_video_converter_free (GstVideoConverter * convert)
     gst_structure_free (convert->config);
 
   for (i = 0; i < 4; i++) {
-    for (j = 0; j < convert->conversion_runner->n_threads; j++) {
+    for (j = 0; j < n_threads; j++) {
       if (convert->fv_scaler[i].scaler)
         gst_video_scaler_free (convert->fv_scaler[i].scaler[j]);
       if (convert->fh_scaler[i].scaler)
@@ -2806,7 +2646,8 @@ gst_video_converter_frame_finish (GstVideoConverter * convert)
 {
   g_return_if_fail (convert);
   g_return_if_fail (convert->conversion_runner);
-  g_return_if_fail (convert->conversion_runner->async_tasks);
+  g_return_if_fail (gst_parallelized_task_runner_is_async
+      (convert->conversion_runner));
 
   gst_parallelized_task_runner_finish (convert->conversion_runner);
 }
@@ -3315,7 +3156,8 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
       PACK_FRAME (dest, convert->borderline, i, out_maxwidth);
   }
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (ConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3426,7 +3268,8 @@ convert_I420_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3503,7 +3346,8 @@ convert_I420_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3582,7 +3426,8 @@ convert_I420_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     h2 = GST_ROUND_DOWN_2 (height);
 
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3737,7 +3582,8 @@ convert_I420_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3820,7 +3666,8 @@ convert_YUY2_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3984,7 +3831,8 @@ convert_v210_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4061,7 +3909,8 @@ convert_YUY2_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4168,7 +4017,8 @@ convert_YUY2_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4227,7 +4077,8 @@ convert_YUY2_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4292,7 +4143,8 @@ convert_YUY2_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4416,7 +4268,8 @@ convert_v210_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4491,7 +4344,8 @@ convert_UYVY_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4551,7 +4405,8 @@ convert_UYVY_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4658,7 +4513,8 @@ convert_UYVY_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4711,7 +4567,8 @@ convert_UYVY_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4824,7 +4681,8 @@ convert_v210_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4937,7 +4795,8 @@ convert_v210_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4996,7 +4855,8 @@ convert_UYVY_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5061,7 +4921,8 @@ convert_UYVY_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5117,7 +4978,8 @@ convert_UYVY_GRAY8 (GstVideoConverter * convert, const GstVideoFrame * src,
   s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
   d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5186,7 +5048,8 @@ convert_AYUV_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
 
   /* only for even width/height */
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5246,7 +5109,8 @@ convert_AYUV_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5300,7 +5164,8 @@ convert_AYUV_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5360,7 +5225,8 @@ convert_AYUV_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv += convert->out_x >> 1;
 
   /* only works for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5423,7 +5289,8 @@ convert_AYUV_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5486,7 +5353,8 @@ convert_Y42B_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5550,7 +5418,8 @@ convert_Y42B_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5617,7 +5486,8 @@ convert_Y42B_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d += convert->out_x * 4;
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5735,7 +5605,8 @@ convert_Y42B_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   sv = FRAME_GET_V_LINE (src, convert->in_y);
   sv += convert->in_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5799,7 +5670,8 @@ convert_Y444_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5863,7 +5735,8 @@ convert_Y444_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5929,7 +5802,8 @@ convert_Y444_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += convert->out_x * 4;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5991,7 +5865,8 @@ convert_AYUV_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6048,7 +5923,8 @@ convert_AYUV_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6105,7 +5981,8 @@ convert_AYUV_ABGR (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6162,7 +6039,8 @@ convert_AYUV_RGBA (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6236,7 +6114,8 @@ convert_I420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6312,7 +6191,8 @@ convert_I420_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6398,7 +6278,8 @@ convert_I420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6489,7 +6370,8 @@ convert_A420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6569,7 +6451,8 @@ convert_A420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6779,7 +6662,8 @@ convert_plane_fill (GstVideoConverter * convert,
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -6827,7 +6711,8 @@ convert_plane_h_double (GstVideoConverter * convert,
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -6878,7 +6763,8 @@ convert_plane_h_halve (GstVideoConverter * convert,
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -6931,7 +6817,8 @@ convert_plane_v_double (GstVideoConverter * convert,
   d2 += convert->fout_x[plane];
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -6990,7 +6877,8 @@ convert_plane_v_halve (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7045,7 +6933,8 @@ convert_plane_hv_double (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7103,7 +6992,8 @@ convert_plane_hv_halve (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7177,7 +7067,8 @@ convert_plane_hv (GstVideoConverter * convert,
   sstride = FRAME_GET_PLANE_STRIDE (src, splane);
   dstride = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
   tasks = convert->tasks[plane] =
       g_renew (FScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7389,7 +7280,8 @@ setup_scale (GstVideoConverter * convert)
   const GstVideoFormatInfo *in_finfo, *out_finfo;
   GstVideoFormat in_format, out_format;
   gboolean interlaced;
-  guint n_threads = convert->conversion_runner->n_threads;
+  guint n_threads =
+      gst_parallelized_task_runner_get_n_threads (convert->conversion_runner);
 
   in_info = &convert->in_info;
   out_info = &convert->out_info;
@@ -8240,16 +8132,18 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
         && (transforms[i].alpha_copy || !need_copy)
         && (transforms[i].alpha_set || !need_set)
         && (transforms[i].alpha_mult || !need_mult)) {
-      guint j;
+      guint j, n_threads;
 
       GST_DEBUG ("using fastpath");
       if (transforms[i].needs_color_matrix)
         video_converter_compute_matrix (convert);
       convert->convert = transforms[i].convert;
 
-      convert->tmpline =
-          g_new (guint16 *, convert->conversion_runner->n_threads);
-      for (j = 0; j < convert->conversion_runner->n_threads; j++)
+      n_threads =
+          gst_parallelized_task_runner_get_n_threads
+          (convert->conversion_runner);
+      convert->tmpline = g_new (guint16 *, n_threads);
+      for (j = 0; j < n_threads; j++)
         convert->tmpline[j] = g_malloc0 (sizeof (guint16) * (width + 8) * 4);
 
       if (!transforms[i].keeps_size)
@@ -0,0 +1,467 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+/**
+ * SECTION:gstparallelizedtaskrunner
+ * @title: GstParallelizedTaskRunner
+ * @short_description: Run work in parallel on a shared task pool
+ *
+ * #GstParallelizedTaskRunner splits work into chunks and runs them on the
+ * threads of a #GstTaskPool. Unless a specific pool is given, all runners
+ * share one process-wide #GstSharedTaskPool that is limited to the number of
+ * CPUs, see gst_parallelized_task_runner_get_default_pool(), so that
+ * elements doing video processing don't spawn threads of their own. Users
+ * that need threads of their own, e.g. for latency critical work, can opt out
+ * by passing a pool they created themselves.
+ *
+ * Work is not assigned to threads up front. The chunks of a job are claimed
+ * one after another by whichever thread is free, including the thread that
+ * called gst_parallelized_task_runner_run(),
+ * gst_parallelized_task_runner_parallel_for() or
+ * gst_parallelized_task_runner_finish(). Chunks that are still queued
+ * because all threads of the pool are busy are processed by the calling
+ * thread, so a job always completes even if the pool is saturated.
+ *
+ * Since: 1.22
+ */
+
+#include "video-task-runner.h"
+
+#ifndef GST_DISABLE_GST_DEBUG
+#define GST_CAT_DEFAULT ensure_debug_category()
+static GstDebugCategory *
+ensure_debug_category (void)
+{
+  static gsize cat_gonce = 0;
+
+  if (g_once_init_enter (&cat_gonce)) {
+    gsize cat_done;
+
+    cat_done = (gsize) _gst_debug_category_new ("video-task-runner", 0,
+        "video-task-runner object");
+
+    g_once_init_leave (&cat_gonce, cat_done);
+  }
+
+  return (GstDebugCategory *) cat_gonce;
+}
+#else
+#define ensure_debug_category() /* NOOP */
+#endif /* GST_DISABLE_GST_DEBUG */
+
+typedef struct _GstParallelizedJob GstParallelizedJob;
+
+struct _GstParallelizedJob
+{
+  gint ref_count;
+
+  /* either run() or parallel_for() */
+  GstParallelizedTaskFunc task_func;
+  gpointer *task_data;
+  GstParallelizedForFunc for_func;
+  gpointer user_data;
+
+  guint n_items;
+  guint grain_size;
+  guint n_chunks;
+
+  /* index of the next chunk to claim */
+  gint next_chunk;
+
+  GMutex lock;
+  GCond cond;
+  /* number of chunks that were processed, protected by lock */
+  guint n_done;
+};
+
+struct _GstParallelizedTaskRunner
+{
+  GstTaskPool *pool;
+  guint n_threads;
+  gboolean async_tasks;
+
+  /* jobs scheduled in async mode that were not finished yet */
+  GQueue pending;
+};
+
+static GstParallelizedJob *
+gst_parallelized_job_ref (GstParallelizedJob * job)
+{
+  g_atomic_int_inc (&job->ref_count);
+
+  return job;
+}
+
+static void
+gst_parallelized_job_unref (GstParallelizedJob * job)
+{
+  if (g_atomic_int_dec_and_test (&job->ref_count)) {
+    g_mutex_clear (&job->lock);
+    g_cond_clear (&job->cond);
+    g_free (job);
+  }
+}
+
+/* Claims and processes chunks of @job until none are left */
+static void
+gst_parallelized_job_process (GstParallelizedJob * job)
+{
+  guint chunk, n_processed = 0;
+
+  while ((chunk = g_atomic_int_add (&job->next_chunk, 1)) < job->n_chunks) {
+    guint start = chunk * job->grain_size;
+    guint end = MIN (start + job->grain_size, job->n_items);
+
+    if (job->task_func) {
+      guint i;
+
+      for (i = start; i < end; i++)
+        job->task_func (job->task_data[i]);
+    } else {
+      job->for_func (start, end, job->user_data);
+    }
+    n_processed++;
+  }
+
+  if (n_processed > 0) {
+    g_mutex_lock (&job->lock);
+    job->n_done += n_processed;
+    if (job->n_done == job->n_chunks)
+      g_cond_broadcast (&job->cond);
+    g_mutex_unlock (&job->lock);
+  }
+}
+
+static void
+gst_parallelized_job_wait (GstParallelizedJob * job)
+{
+  /* Help with whatever the pool did not get to yet */
+  gst_parallelized_job_process (job);
+
+  g_mutex_lock (&job->lock);
+  while (job->n_done < job->n_chunks)
+    g_cond_wait (&job->cond, &job->lock);
+  g_mutex_unlock (&job->lock);
+}
+
+static void
+gst_parallelized_task_thread_func (gpointer data)
+{
+  GstParallelizedJob *job = data;
+
+  gst_parallelized_job_process (job);
+  gst_parallelized_job_unref (job);
+}
+
+static void
+gst_parallelized_task_runner_schedule (GstParallelizedTaskRunner * self,
+    GstParallelizedJob * job)
+{
+  guint i, n_helpers;
+
+  n_helpers = MIN (self->n_threads, job->n_chunks);
+  /* if not async, the current thread takes part in processing the job */
+  if (!self->async_tasks)
+    n_helpers--;
+
+  for (i = 0; i < n_helpers; i++) {
+    GError *err = NULL;
+    gpointer handle;
+
+    handle = gst_task_pool_push (self->pool, gst_parallelized_task_thread_func,
+        gst_parallelized_job_ref (job), &err);
+
+    if (err) {
+      /* The chunks are picked up by the thread waiting for the job */
+      GST_WARNING ("Failed to push task: %s", err->message);
+      g_clear_error (&err);
+      gst_parallelized_job_unref (job);
+      break;
+    }
+
+    /* Completion is tracked by the job itself */
+    if (handle)
+      gst_task_pool_dispose_handle (self->pool, handle);
+  }
+
+  if (self->async_tasks) {
+    g_queue_push_tail (&self->pending, job);
+  } else {
+    gst_parallelized_job_wait (job);
+    gst_parallelized_job_unref (job);
+  }
+}
+
+static GstParallelizedJob *
+gst_parallelized_job_new (guint n_items, guint grain_size)
+{
+  GstParallelizedJob *job;
+
+  job = g_new0 (GstParallelizedJob, 1);
+  job->ref_count = 1;
+  job->n_items = n_items;
+  job->grain_size = grain_size;
+  job->n_chunks = (n_items + grain_size - 1) / grain_size;
+  g_mutex_init (&job->lock);
+  g_cond_init (&job->cond);
+
+  return job;
+}
+
+/**
+ * gst_parallelized_task_runner_get_default_pool:
+ *
+ * Gets the process-wide #GstSharedTaskPool that is used by runners created
+ * without a specific pool. It is limited to as many threads as there are
+ * CPUs and must not be cleaned up by the caller.
+ *
+ * Returns: (transfer full): the default #GstTaskPool
+ *
+ * Since: 1.22
+ */
+GstTaskPool *
+gst_parallelized_task_runner_get_default_pool (void)
+{
+  static GstTaskPool *default_pool = NULL;
+
+  if (g_once_init_enter (&default_pool)) {
+    GstTaskPool *pool;
+
+    pool = gst_shared_task_pool_new ();
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (pool),
+        g_get_num_processors ());
+    gst_task_pool_prepare (pool, NULL);
+    /* Lives as long as the process */
+    GST_OBJECT_FLAG_SET (pool, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+
+    g_once_init_leave (&default_pool, pool);
+  }
+
+  return gst_object_ref (default_pool);
+}
+
+/**
+ * gst_parallelized_task_runner_new:
+ * @n_threads: the maximum number of threads to use, or 0 for the number of
+ *   CPUs
+ * @pool: (nullable): a prepared #GstTaskPool, or %NULL for the default pool
+ * @async_tasks: %TRUE if jobs should run in the background until
+ *   gst_parallelized_task_runner_finish() is called
+ *
+ * Creates a new runner. If @pool is a #GstSharedTaskPool, @n_threads is
+ * limited to its maximum number of threads.
+ *
+ * Returns: a new #GstParallelizedTaskRunner. Free with
+ *   gst_parallelized_task_runner_free().
+ *
+ * Since: 1.22
+ */
+GstParallelizedTaskRunner *
+gst_parallelized_task_runner_new (guint n_threads, GstTaskPool * pool,
+    gboolean async_tasks)
+{
+  GstParallelizedTaskRunner *self;
+
+  g_return_val_if_fail (pool == NULL || GST_IS_TASK_POOL (pool), NULL);
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  self = g_new0 (GstParallelizedTaskRunner, 1);
+
+  if (pool)
+    self->pool = gst_object_ref (pool);
+  else
+    self->pool = gst_parallelized_task_runner_get_default_pool ();
+
+  /* No reason to split up the work between more threads than the
+   * pool can spawn */
+  if (GST_IS_SHARED_TASK_POOL (self->pool))
+    n_threads =
+        MIN (n_threads,
+        gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL
+            (self->pool)));
+
+  self->n_threads = MAX (n_threads, 1);
+  self->async_tasks = async_tasks;
+  g_queue_init (&self->pending);
+
+  return self;
+}
+
+/**
+ * gst_parallelized_task_runner_free:
+ * @self: a #GstParallelizedTaskRunner
+ *
+ * Waits for all pending jobs and frees @self.
+ *
+ * Since: 1.22
+ */
+void
+gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
+{
+  g_return_if_fail (self != NULL);
+
+  gst_parallelized_task_runner_finish (self);
+
+  gst_object_unref (self->pool);
+  g_free (self);
+}
+
+/**
+ * gst_parallelized_task_runner_get_n_threads:
+ * @self: a #GstParallelizedTaskRunner
+ *
+ * Gets the number of threads @self splits work between. This is the number
+ * of tasks gst_parallelized_task_runner_run() runs, and can be used to
+ * allocate per-task state.
+ *
+ * Returns: the number of threads
+ *
+ * Since: 1.22
+ */
+guint
+gst_parallelized_task_runner_get_n_threads (GstParallelizedTaskRunner * self)
+{
+  g_return_val_if_fail (self != NULL, 1);
+
+  return self->n_threads;
+}
+
+/**
+ * gst_parallelized_task_runner_is_async:
+ * @self: a #GstParallelizedTaskRunner
+ *
+ * Returns: %TRUE if @self was created with async tasks
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_parallelized_task_runner_is_async (GstParallelizedTaskRunner * self)
+{
+  g_return_val_if_fail (self != NULL, FALSE);
+
+  return self->async_tasks;
+}
+
+/**
+ * gst_parallelized_task_runner_run:
+ * @self: a #GstParallelizedTaskRunner
+ * @func: (scope call): the function to call for each task
+ * @task_data: (array): an array of gst_parallelized_task_runner_get_n_threads()
+ *   task data pointers
+ *
+ * Calls @func once for every element of @task_data, in parallel. Unless @self
+ * was created with async tasks, this returns once all tasks are done.
+ *
+ * Since: 1.22
+ */
+void
+gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
+    GstParallelizedTaskFunc func, gpointer * task_data)
+{
+  GstParallelizedJob *job;
+
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (func != NULL);
+
+  if (self->n_threads == 1 && !self->async_tasks) {
+    func (task_data[0]);
+    return;
+  }
+
+  job = gst_parallelized_job_new (self->n_threads, 1);
+  job->task_func = func;
+  job->task_data = task_data;
+
+  gst_parallelized_task_runner_schedule (self, job);
+}
+
+/**
+ * gst_parallelized_task_runner_parallel_for:
+ * @self: a #GstParallelizedTaskRunner
+ * @n_items: the number of items
+ * @grain_size: the number of items per call of @func, or 0 to split the items
+ *   evenly between all threads
+ * @func: (scope call): the function to call for each range of items
+ * @user_data: user data passed to @func
+ *
+ * Splits the items [0, @n_items) into ranges of @grain_size items and calls
+ * @func for each range, in parallel. Ranges are handed out to threads as they
+ * become free, so a @grain_size smaller than @n_items divided by the number of
+ * threads balances work that takes an uneven amount of time per item.
+ *
+ * Unless @self was created with async tasks, this returns once all items
+ * are done.
+ *
+ * Since: 1.22
+ */
+void
+gst_parallelized_task_runner_parallel_for (GstParallelizedTaskRunner * self,
+    guint n_items, guint grain_size, GstParallelizedForFunc func,
+    gpointer user_data)
+{
+  GstParallelizedJob *job;
+
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (func != NULL);
+
+  if (n_items == 0)
+    return;
+
+  if (grain_size == 0)
+    grain_size = (n_items + self->n_threads - 1) / self->n_threads;
+
+  if (!self->async_tasks && (self->n_threads == 1 || grain_size >= n_items)) {
+    func (0, n_items, user_data);
+    return;
+  }
+
+  job = gst_parallelized_job_new (n_items, grain_size);
+  job->for_func = func;
+  job->user_data = user_data;
+
+  gst_parallelized_task_runner_schedule (self, job);
+}
+
+/**
+ * gst_parallelized_task_runner_finish:
+ * @self: a #GstParallelizedTaskRunner
+ *
+ * Waits for all jobs scheduled on a runner with async tasks. The calling
+ * thread processes the parts of the jobs that did not start yet.
+ *
+ * Since: 1.22
+ */
+void
+gst_parallelized_task_runner_finish (GstParallelizedTaskRunner * self)
+{
+  GstParallelizedJob *job;
+
+  g_return_if_fail (self != NULL);
+
+  while ((job = g_queue_pop_head (&self->pending))) {
+    gst_parallelized_job_wait (job);
+    gst_parallelized_job_unref (job);
+  }
+}
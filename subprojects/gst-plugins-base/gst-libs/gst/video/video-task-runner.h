@@ -0,0 +1,88 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_TASK_RUNNER_H__
+#define __GST_VIDEO_TASK_RUNNER_H__
+
+#include <gst/gst.h>
+#include <gst/video/video-prelude.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GstParallelizedTaskFunc:
+ * @user_data: the task data of one task
+ *
+ * Function called by gst_parallelized_task_runner_run() for each task.
+ *
+ * Since: 1.22
+ */
+typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
+
+/**
+ * GstParallelizedForFunc:
+ * @start: the first item of the range
+ * @end: the item after the last item of the range
+ * @user_data: user data passed to gst_parallelized_task_runner_parallel_for()
+ *
+ * Function called by gst_parallelized_task_runner_parallel_for() for each
+ * range of items [@start, @end).
+ *
+ * Since: 1.22
+ */
+typedef void (*GstParallelizedForFunc) (guint start, guint end,
+    gpointer user_data);
+
+typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
+
+GST_VIDEO_API
+GstTaskPool *               gst_parallelized_task_runner_get_default_pool (void);
+
+GST_VIDEO_API
+GstParallelizedTaskRunner * gst_parallelized_task_runner_new    (guint n_threads,
+                                                                 GstTaskPool * pool,
+                                                                 gboolean async_tasks);
+
+GST_VIDEO_API
+void                        gst_parallelized_task_runner_free   (GstParallelizedTaskRunner * self);
+
+GST_VIDEO_API
+guint                       gst_parallelized_task_runner_get_n_threads (GstParallelizedTaskRunner * self);
+
+GST_VIDEO_API
+gboolean                    gst_parallelized_task_runner_is_async (GstParallelizedTaskRunner * self);
+
+GST_VIDEO_API
+void                        gst_parallelized_task_runner_run    (GstParallelizedTaskRunner * self,
+                                                                 GstParallelizedTaskFunc func,
+                                                                 gpointer * task_data);
+
+GST_VIDEO_API
+void                        gst_parallelized_task_runner_parallel_for (GstParallelizedTaskRunner * self,
+                                                                       guint n_items,
+                                                                       guint grain_size,
+                                                                       GstParallelizedForFunc func,
+                                                                       gpointer user_data);
+
+GST_VIDEO_API
+void                        gst_parallelized_task_runner_finish (GstParallelizedTaskRunner * self);
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_TASK_RUNNER_H__ */
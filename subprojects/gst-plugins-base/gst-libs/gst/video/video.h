@@ -34,6 +34,7 @@ typedef struct _GstVideoAlignment GstVideoAlignment;
 #include <gst/video/video-enumtypes.h>
 #include <gst/video/video-converter.h>
 #include <gst/video/video-scaler.h>
+#include <gst/video/video-task-runner.h>
 #include <gst/video/video-multiview.h>
 
 G_BEGIN_DECLS
@@ -167,6 +168,31 @@ GstSample *   gst_video_convert_sample       (GstSample     * sample,
                                               GstClockTime    timeout,
                                               GError       ** error);
 
+/**
+ * GstVideoConvertSampleCache:
+ *
+ * Opaque cache of converters used by gst_video_convert_sample_cache_convert().
+ *
+ * Since: 1.22
+ */
+typedef struct _GstVideoConvertSampleCache GstVideoConvertSampleCache;
+
+GST_VIDEO_API
+GstVideoConvertSampleCache * gst_video_convert_sample_cache_new     (guint max_converters);
+
+GST_VIDEO_API
+void                         gst_video_convert_sample_cache_free    (GstVideoConvertSampleCache * cache);
+
+GST_VIDEO_API
+GstStructure *               gst_video_convert_sample_cache_get_stats (GstVideoConvertSampleCache * cache);
+
+GST_VIDEO_API
+GstSample *                  gst_video_convert_sample_cache_convert (GstVideoConvertSampleCache * cache,
+                                                                     GstSample                  * sample,
+                                                                     const GstCaps              * to_caps,
+                                                                     GstClockTime                 timeout,
+                                                                     GError                    ** error);
+
 
 GST_VIDEO_API
 gboolean gst_video_orientation_from_tag (GstTagList * taglist,
@@ -830,14 +830,18 @@ gst_audio_convert_transform (GstBaseTransform * base, GstBuffer * inbuf,
   GstFlowReturn ret;
   GstAudioConvert *this = GST_AUDIO_CONVERT (base);
   GstAudioBuffer srcabuf, dstabuf;
-  gboolean inbuf_writable;
+  gboolean inbuf_writable, map_inbuf;
   GstAudioConverterFlags flags;
 
   /* https://bugzilla.gnome.org/show_bug.cgi?id=396835 */
   if (gst_buffer_get_size (inbuf) == 0)
     return GST_FLOW_OK;
 
-  if (inbuf != outbuf) {
+  /* the samples of GAP buffers are not used */
+  map_inbuf = inbuf != outbuf
+      && !GST_BUFFER_FLAG_IS_SET (inbuf, GST_BUFFER_FLAG_GAP);
+
+  if (map_inbuf) {
     inbuf_writable = gst_buffer_is_writable (inbuf)
         && gst_buffer_n_memory (inbuf) == 1
         && gst_memory_is_writable (gst_buffer_peek_memory (inbuf, 0));
@@ -874,7 +878,7 @@ gst_audio_convert_transform (GstBaseTransform * base, GstBuffer * inbuf,
 
 done:
   gst_audio_buffer_unmap (&dstabuf);
-  if (inbuf != outbuf)
+  if (map_inbuf)
     gst_audio_buffer_unmap (&srcabuf);
 
   return ret;
@@ -897,7 +901,7 @@ outmap_error:
   {
     GST_ELEMENT_ERROR (this, STREAM, FORMAT,
         (NULL), ("failed to map output buffer"));
-    if (inbuf != outbuf)
+    if (map_inbuf)
       gst_audio_buffer_unmap (&srcabuf);
     return GST_FLOW_ERROR;
   }
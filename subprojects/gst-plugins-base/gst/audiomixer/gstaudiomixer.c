@@ -49,10 +49,33 @@
  * * "mute": Whether to mute the pad or not (#gboolean)
  * * "volume": The volume of the pad, between 0.0 and 10.0 (#gdouble)
  *
+ * ## Mix-minus outputs
+ *
+ * For conferencing, every participant usually needs to receive the mix of
+ * all other participants but not its own input. Instead of using one
+ * audiomixer per participant, which would sum up all inputs over and over
+ * again, request a "src_%u" pad with the same number as the "sink_%u" pad of
+ * the participant, e.g. "src_3" for "sink_3". The total mix is computed
+ * once and each mix-minus output is produced by subtracting the
+ * contribution of its input, so the cost grows linearly with the number
+ * of participants.
+ *
+ * Mix-minus pads always output the same format as the "src" pad. They are
+ * exact for the floating point formats; with integer formats, samples that
+ * were clipped in the total mix stay clipped in the mix-minus outputs, so
+ * F32 is recommended. Only the "src" pad handles seeks and QoS, the
+ * mix-minus pads follow it.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 audiotestsrc freq=100 ! audiomixer name=mix ! audioconvert ! alsasink audiotestsrc freq=500 ! mix.
  * ]| This pipeline produces two sine waves mixed together.
+ * |[
+ * gst-launch-1.0 audiomixer name=mix ! fakesink \
+ *     audiotestsrc freq=100 ! audio/x-raw,format=F32LE ! mix.sink_0 \
+ *     audiotestsrc freq=500 ! audio/x-raw,format=F32LE ! mix.sink_1 \
+ *     mix.src_0 ! audioconvert ! autoaudiosink
+ * ]| This pipeline plays only the 500Hz sine wave, the mix without sink_0.
  *
  */
 
@@ -60,6 +83,8 @@
 #include "config.h"
 #endif
 
+#include <stdio.h>
+
 #include "gstaudiomixerelements.h"
 #include "gstaudiomixerorc.h"
 
@@ -137,6 +162,17 @@ gst_audiomixer_pad_set_property (GObject * object, guint prop_id,
   }
 }
 
+static void
+gst_audiomixer_pad_dispose (GObject * object)
+{
+  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (object);
+
+  gst_clear_object (&pad->minus_one_pad);
+  gst_clear_buffer (&pad->contribution);
+
+  G_OBJECT_CLASS (gst_audiomixer_pad_parent_class)->dispose (object);
+}
+
 static void
 gst_audiomixer_pad_class_init (GstAudioMixerPadClass * klass)
 {
@@ -144,6 +180,7 @@ gst_audiomixer_pad_class_init (GstAudioMixerPadClass * klass)
 
   gobject_class->set_property = gst_audiomixer_pad_set_property;
   gobject_class->get_property = gst_audiomixer_pad_get_property;
+  gobject_class->dispose = gst_audiomixer_pad_dispose;
 
   g_object_class_install_property (gobject_class, PROP_PAD_VOLUME,
       g_param_spec_double ("volume", "Volume", "Volume of this pad",
@@ -186,6 +223,13 @@ GST_STATIC_PAD_TEMPLATE ("src",
     GST_STATIC_CAPS (CAPS)
     );
 
+static GstStaticPadTemplate gst_audiomixer_minus_one_src_template =
+GST_STATIC_PAD_TEMPLATE ("src_%u",
+    GST_PAD_SRC,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS (CAPS)
+    );
+
 #define SINK_CAPS \
   GST_STATIC_CAPS (GST_AUDIO_CAPS_MAKE (GST_AUDIO_FORMATS_ALL) \
       ", layout=interleaved")
@@ -212,16 +256,39 @@ static gboolean
 gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
     GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
     GstBuffer * outbuf, guint out_offset, guint num_samples);
+static GstFlowReturn gst_audiomixer_finish_buffer (GstAggregator * agg,
+    GstBuffer * buffer);
+static gboolean gst_audiomixer_negotiated_src_caps (GstAggregator * agg,
+    GstCaps * caps);
+static GstFlowReturn gst_audiomixer_flush (GstAggregator * agg);
+static gboolean gst_audiomixer_stop (GstAggregator * agg);
+static GstPadProbeReturn gst_audiomixer_src_event_probe (GstPad * srcpad,
+    GstPadProbeInfo * info, GstAudioMixer * audiomixer);
+
+static void
+gst_audiomixer_finalize (GObject * object)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (object);
 
+  gst_flow_combiner_free (audiomixer->flow_combiner);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
 
 static void
 gst_audiomixer_class_init (GstAudioMixerClass * klass)
 {
+  GObjectClass *gobject_class = (GObjectClass *) klass;
   GstElementClass *gstelement_class = (GstElementClass *) klass;
+  GstAggregatorClass *agg_class = (GstAggregatorClass *) klass;
   GstAudioAggregatorClass *aagg_class = (GstAudioAggregatorClass *) klass;
 
+  gobject_class->finalize = gst_audiomixer_finalize;
+
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &gst_audiomixer_src_template, GST_TYPE_AUDIO_AGGREGATOR_CONVERT_PAD);
+  gst_element_class_add_static_pad_template (gstelement_class,
+      &gst_audiomixer_minus_one_src_template);
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &gst_audiomixer_sink_template, GST_TYPE_AUDIO_MIXER_PAD);
   gst_element_class_set_static_metadata (gstelement_class, "AudioMixer",
@@ -233,6 +300,12 @@ gst_audiomixer_class_init (GstAudioMixerClass * klass)
   gstelement_class->release_pad =
       GST_DEBUG_FUNCPTR (gst_audiomixer_release_pad);
 
+  agg_class->finish_buffer = GST_DEBUG_FUNCPTR (gst_audiomixer_finish_buffer);
+  agg_class->negotiated_src_caps =
+      GST_DEBUG_FUNCPTR (gst_audiomixer_negotiated_src_caps);
+  agg_class->flush = GST_DEBUG_FUNCPTR (gst_audiomixer_flush);
+  agg_class->stop = GST_DEBUG_FUNCPTR (gst_audiomixer_stop);
+
   aagg_class->aggregate_one_buffer = gst_audiomixer_aggregate_one_buffer;
 
   gst_type_mark_as_plugin_api (GST_TYPE_AUDIO_MIXER_PAD, 0);
@@ -241,6 +314,210 @@ gst_audiomixer_class_init (GstAudioMixerClass * klass)
 static void
 gst_audiomixer_init (GstAudioMixer * audiomixer)
 {
+  GstAggregator *agg = GST_AGGREGATOR (audiomixer);
+
+  audiomixer->flow_combiner = gst_flow_combiner_new ();
+  gst_flow_combiner_add_pad (audiomixer->flow_combiner, agg->srcpad);
+
+  /* everything the src pad sends downstream is forwarded to the mix-minus
+   * pads, so they always carry the same segment, caps and EOS */
+  gst_pad_add_probe (agg->srcpad,
+      GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM | GST_PAD_PROBE_TYPE_EVENT_FLUSH,
+      (GstPadProbeCallback) gst_audiomixer_src_event_probe, audiomixer, NULL);
+}
+
+/* Mix-minus pads carry their own stream-id, everything else is shared with
+ * the src pad */
+static GstEvent *
+gst_audiomixer_minus_one_event (GstAudioMixer * audiomixer, GstPad * pad,
+    GstEvent * event)
+{
+  GstEvent *new_event;
+  gchar *stream_id;
+  guint group_id;
+
+  if (GST_EVENT_TYPE (event) != GST_EVENT_STREAM_START)
+    return gst_event_ref (event);
+
+  stream_id = gst_pad_create_stream_id (pad, GST_ELEMENT_CAST (audiomixer),
+      GST_PAD_NAME (pad));
+  new_event = gst_event_new_stream_start (stream_id);
+  g_free (stream_id);
+
+  if (gst_event_parse_group_id (event, &group_id))
+    gst_event_set_group_id (new_event, group_id);
+  gst_event_set_seqnum (new_event, gst_event_get_seqnum (event));
+
+  return new_event;
+}
+
+static GstPadProbeReturn
+gst_audiomixer_src_event_probe (GstPad * srcpad, GstPadProbeInfo * info,
+    GstAudioMixer * audiomixer)
+{
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+  GList *pads = NULL, *l;
+
+  GST_OBJECT_LOCK (audiomixer);
+  for (l = GST_ELEMENT_CAST (audiomixer)->srcpads; l; l = l->next) {
+    if (l->data != srcpad)
+      pads = g_list_prepend (pads, gst_object_ref (l->data));
+  }
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  for (l = pads; l; l = l->next) {
+    GstPad *pad = l->data;
+
+    GST_LOG_OBJECT (pad, "forwarding %" GST_PTR_FORMAT, event);
+    gst_pad_push_event (pad, gst_audiomixer_minus_one_event (audiomixer, pad,
+            event));
+  }
+  g_list_free_full (pads, gst_object_unref);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static gboolean
+gst_audiomixer_minus_one_src_query (GstPad * pad, GstObject * parent,
+    GstQuery * query)
+{
+  GstAggregator *agg = GST_AGGREGATOR (parent);
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CAPS:
+    case GST_QUERY_ACCEPT_CAPS:
+      /* fixed caps, whatever the src pad negotiated */
+      return gst_pad_query_default (pad, parent, query);
+    default:
+      /* latency, position, duration, ... are the same as for the src pad */
+      return gst_pad_query (agg->srcpad, query);
+  }
+}
+
+static gboolean
+gst_audiomixer_minus_one_src_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  gboolean res = TRUE;
+
+  /* Seeks and QoS are handled by the src pad only */
+  if (GST_EVENT_TYPE (event) == GST_EVENT_SEEK)
+    res = FALSE;
+
+  GST_DEBUG_OBJECT (pad, "dropping %" GST_PTR_FORMAT, event);
+  gst_event_unref (event);
+
+  return res;
+}
+
+static gboolean
+copy_sticky_event (GstPad * srcpad, GstEvent ** event, gpointer user_data)
+{
+  GstPad *pad = user_data;
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (GST_PAD_PARENT (pad));
+  GstEvent *new_event;
+
+  new_event = gst_audiomixer_minus_one_event (audiomixer, pad, *event);
+  gst_pad_store_sticky_event (pad, new_event);
+  gst_event_unref (new_event);
+
+  return TRUE;
+}
+
+static GstPad *
+gst_audiomixer_request_minus_one_pad (GstAudioMixer * audiomixer,
+    GstPadTemplate * templ, const gchar * req_name)
+{
+  GstElement *element = GST_ELEMENT_CAST (audiomixer);
+  GstAudioMixerPad *sinkpad;
+  GstPad *pad;
+  gchar *name;
+  guint serial;
+
+  if (req_name == NULL || sscanf (req_name, "src_%u", &serial) != 1) {
+    GST_WARNING_OBJECT (audiomixer, "Mix-minus pads must be requested by "
+        "name, e.g. src_0 for the mix without sink_0");
+    return NULL;
+  }
+
+  name = g_strdup_printf ("sink_%u", serial);
+  sinkpad = (GstAudioMixerPad *) gst_element_get_static_pad (element, name);
+  g_free (name);
+
+  if (sinkpad == NULL) {
+    GST_WARNING_OBJECT (audiomixer, "No sink_%u pad for %s", serial, req_name);
+    return NULL;
+  }
+
+  name = g_strdup_printf ("src_%u", serial);
+  pad = gst_element_get_static_pad (element, name);
+  if (pad != NULL) {
+    GST_WARNING_OBJECT (audiomixer, "Mix-minus pad %s already exists", name);
+    g_free (name);
+    gst_object_unref (pad);
+    gst_object_unref (sinkpad);
+    return NULL;
+  }
+
+  pad = gst_pad_new_from_template (templ, name);
+  g_free (name);
+
+  gst_pad_set_query_function (pad,
+      GST_DEBUG_FUNCPTR (gst_audiomixer_minus_one_src_query));
+  gst_pad_set_event_function (pad,
+      GST_DEBUG_FUNCPTR (gst_audiomixer_minus_one_src_event));
+  gst_pad_use_fixed_caps (pad);
+
+  if (!gst_element_add_pad (element, pad)) {
+    GST_WARNING_OBJECT (audiomixer, "Failed to add mix-minus pad %s",
+        req_name);
+    gst_object_unref (pad);
+    gst_object_unref (sinkpad);
+    return NULL;
+  }
+
+  /* when added while running, start from where the src pad is */
+  gst_pad_sticky_events_foreach (GST_AGGREGATOR (audiomixer)->srcpad,
+      copy_sticky_event, pad);
+
+  GST_OBJECT_LOCK (audiomixer);
+  gst_flow_combiner_add_pad (audiomixer->flow_combiner, pad);
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  GST_OBJECT_LOCK (sinkpad);
+  gst_object_replace ((GstObject **) & sinkpad->minus_one_pad,
+      GST_OBJECT_CAST (pad));
+  GST_OBJECT_UNLOCK (sinkpad);
+  gst_object_unref (sinkpad);
+
+  GST_DEBUG_OBJECT (audiomixer, "Added mix-minus pad %s:%s",
+      GST_DEBUG_PAD_NAME (pad));
+
+  return pad;
+}
+
+static void
+gst_audiomixer_release_minus_one_pad (GstAudioMixer * audiomixer,
+    GstPad * pad)
+{
+  GList *l;
+
+  GST_OBJECT_LOCK (audiomixer);
+  for (l = GST_ELEMENT_CAST (audiomixer)->sinkpads; l; l = l->next) {
+    GstAudioMixerPad *sinkpad = l->data;
+
+    GST_OBJECT_LOCK (sinkpad);
+    if (sinkpad->minus_one_pad == pad) {
+      gst_clear_object (&sinkpad->minus_one_pad);
+      gst_clear_buffer (&sinkpad->contribution);
+    }
+    GST_OBJECT_UNLOCK (sinkpad);
+  }
+  gst_flow_combiner_remove_pad (audiomixer->flow_combiner, pad);
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  gst_pad_set_active (pad, FALSE);
+  gst_element_remove_pad (GST_ELEMENT_CAST (audiomixer), pad);
 }
 
 static GstPad *
@@ -249,6 +526,10 @@ gst_audiomixer_request_new_pad (GstElement * element, GstPadTemplate * templ,
 {
   GstAudioMixerPad *newpad;
 
+  if (templ->direction == GST_PAD_SRC)
+    return gst_audiomixer_request_minus_one_pad (GST_AUDIO_MIXER (element),
+        templ, req_name);
+
   newpad = (GstAudioMixerPad *)
       GST_ELEMENT_CLASS (parent_class)->request_new_pad (element,
       templ, req_name, caps);
@@ -277,6 +558,11 @@ gst_audiomixer_release_pad (GstElement * element, GstPad * pad)
 
   GST_DEBUG_OBJECT (audiomixer, "release pad %s:%s", GST_DEBUG_PAD_NAME (pad));
 
+  if (GST_PAD_IS_SRC (pad)) {
+    gst_audiomixer_release_minus_one_pad (audiomixer, pad);
+    return;
+  }
+
   gst_child_proxy_child_removed (GST_CHILD_PROXY (audiomixer), G_OBJECT (pad),
       GST_OBJECT_NAME (pad));
 
@@ -284,129 +570,165 @@ gst_audiomixer_release_pad (GstElement * element, GstPad * pad)
 }
 
 
-static gboolean
-gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
-    GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
-    GstBuffer * outbuf, guint out_offset, guint num_frames)
+/* Adds @n_samples samples from @in with the volume of @pad to @out.
+ * Must be called with the pad's object lock */
+static void
+gst_audiomixer_mix_samples (GstAudioMixerPad * pad, GstAudioFormat format,
+    gpointer out, gconstpointer in, guint n_samples)
 {
-  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (aaggpad);
-  GstMapInfo inmap;
-  GstMapInfo outmap;
-  gint bpf;
-  GstAggregator *agg = GST_AGGREGATOR (aagg);
-  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
-
-  GST_OBJECT_LOCK (aagg);
-  GST_OBJECT_LOCK (aaggpad);
-
-  if (pad->mute || pad->volume < G_MINDOUBLE) {
-    GST_DEBUG_OBJECT (pad, "Skipping muted pad");
-    GST_OBJECT_UNLOCK (aaggpad);
-    GST_OBJECT_UNLOCK (aagg);
-    return FALSE;
-  }
-
-  bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
-
-  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
-  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
-  GST_LOG_OBJECT (pad, "mixing %u bytes at offset %u from offset %u",
-      num_frames * bpf, out_offset * bpf, in_offset * bpf);
-
-  /* further buffers, need to add them */
   if (pad->volume == 1.0) {
-    switch (srcpad->info.finfo->format) {
+    switch (format) {
       case GST_AUDIO_FORMAT_U8:
-        audiomixer_orc_add_u8 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u8 (out, in, n_samples);
         break;
       case GST_AUDIO_FORMAT_S8:
-        audiomixer_orc_add_s8 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s8 (out, in, n_samples);
         break;
       case GST_AUDIO_FORMAT_U16:
-        audiomixer_orc_add_u16 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u16 (out, in, n_samples);
         break;
       case GST_AUDIO_FORMAT_S16:
-        audiomixer_orc_add_s16 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s16 (out, in, n_samples);
         break;
       case GST_AUDIO_FORMAT_U32:
-        audiomixer_orc_add_u32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u32 (out, in, n_samples);
         break;
       case GST_AUDIO_FORMAT_S32:
-        audiomixer_orc_add_s32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s32 (out, in, n_samples);
         break;
       case GST_AUDIO_FORMAT_F32:
-        audiomixer_orc_add_f32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_f32 (out, in, n_samples);
         break;
       case GST_AUDIO_FORMAT_F64:
-        audiomixer_orc_add_f64 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_f64 (out, in, n_samples);
         break;
       default:
         g_assert_not_reached ();
         break;
     }
   } else {
-    switch (srcpad->info.finfo->format) {
+    switch (format) {
       case GST_AUDIO_FORMAT_U8:
-        audiomixer_orc_add_volume_u8 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i8, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u8 (out, in, pad->volume_i8, n_samples);
         break;
       case GST_AUDIO_FORMAT_S8:
-        audiomixer_orc_add_volume_s8 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i8, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s8 (out, in, pad->volume_i8, n_samples);
         break;
       case GST_AUDIO_FORMAT_U16:
-        audiomixer_orc_add_volume_u16 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i16, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u16 (out, in, pad->volume_i16, n_samples);
         break;
       case GST_AUDIO_FORMAT_S16:
-        audiomixer_orc_add_volume_s16 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i16, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s16 (out, in, pad->volume_i16, n_samples);
         break;
       case GST_AUDIO_FORMAT_U32:
-        audiomixer_orc_add_volume_u32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i32, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u32 (out, in, pad->volume_i32, n_samples);
         break;
       case GST_AUDIO_FORMAT_S32:
-        audiomixer_orc_add_volume_s32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i32, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s32 (out, in, pad->volume_i32, n_samples);
         break;
       case GST_AUDIO_FORMAT_F32:
-        audiomixer_orc_add_volume_f32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_f32 (out, in, pad->volume, n_samples);
         break;
       case GST_AUDIO_FORMAT_F64:
-        audiomixer_orc_add_volume_f64 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_f64 (out, in, pad->volume, n_samples);
         break;
       default:
         g_assert_not_reached ();
         break;
     }
   }
+}
+
+static void
+gst_audiomixer_subtract_samples (GstAudioFormat format, gpointer out,
+    gconstpointer in, guint n_samples)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_U8:
+      audiomixer_orc_sub_u8 (out, in, n_samples);
+      break;
+    case GST_AUDIO_FORMAT_S8:
+      audiomixer_orc_sub_s8 (out, in, n_samples);
+      break;
+    case GST_AUDIO_FORMAT_U16:
+      audiomixer_orc_sub_u16 (out, in, n_samples);
+      break;
+    case GST_AUDIO_FORMAT_S16:
+      audiomixer_orc_sub_s16 (out, in, n_samples);
+      break;
+    case GST_AUDIO_FORMAT_U32:
+      audiomixer_orc_sub_u32 (out, in, n_samples);
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      audiomixer_orc_sub_s32 (out, in, n_samples);
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      audiomixer_orc_sub_f32 (out, in, n_samples);
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      audiomixer_orc_sub_f64 (out, in, n_samples);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+static gboolean
+gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
+    GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
+    GstBuffer * outbuf, guint out_offset, guint num_frames)
+{
+  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (aaggpad);
+  GstMapInfo inmap;
+  GstMapInfo outmap;
+  gint bpf;
+  GstAudioFormat format;
+  guint num_samples;
+  GstAggregator *agg = GST_AGGREGATOR (aagg);
+  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+
+  GST_OBJECT_LOCK (aagg);
+  GST_OBJECT_LOCK (aaggpad);
+
+  if (pad->mute || pad->volume < G_MINDOUBLE) {
+    GST_DEBUG_OBJECT (pad, "Skipping muted pad");
+    GST_OBJECT_UNLOCK (aaggpad);
+    GST_OBJECT_UNLOCK (aagg);
+    return FALSE;
+  }
+
+  bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
+  format = GST_AUDIO_INFO_FORMAT (&srcpad->info);
+  num_samples = num_frames * GST_AUDIO_INFO_CHANNELS (&srcpad->info);
+
+  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
+  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
+  GST_LOG_OBJECT (pad, "mixing %u bytes at offset %u from offset %u",
+      num_frames * bpf, out_offset * bpf, in_offset * bpf);
+
+  /* further buffers, need to add them */
+  gst_audiomixer_mix_samples (pad, format, outmap.data + out_offset * bpf,
+      inmap.data + in_offset * bpf, num_samples);
+
+  /* Keep track of what this pad added to the output buffer, its mix-minus
+   * output is the total minus this */
+  if (pad->minus_one_pad) {
+    GstMapInfo contribmap;
+
+    if (pad->contribution == NULL
+        || gst_buffer_get_size (pad->contribution) != outmap.size) {
+      gst_buffer_replace (&pad->contribution, NULL);
+      pad->contribution = gst_buffer_new_allocate (NULL, outmap.size, NULL);
+      gst_buffer_memset (pad->contribution, 0, 0, outmap.size);
+    }
+
+    gst_buffer_map (pad->contribution, &contribmap, GST_MAP_READWRITE);
+    gst_audiomixer_mix_samples (pad, format, contribmap.data + out_offset * bpf,
+        inmap.data + in_offset * bpf, num_samples);
+    gst_buffer_unmap (pad->contribution, &contribmap);
+  }
+
   gst_buffer_unmap (inbuf, &inmap);
   gst_buffer_unmap (outbuf, &outmap);
 
@@ -416,6 +738,156 @@ gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
   return TRUE;
 }
 
+/* Must be called with the object lock of the pad that @contribution belongs
+ * to */
+static GstBuffer *
+gst_audiomixer_make_minus_one (const GstAudioInfo * info, GstBuffer * mix,
+    GstBuffer * contribution)
+{
+  GstBuffer *outbuf;
+  GstMapInfo outmap, contribmap;
+  gsize size;
+
+  /* this input did not add anything, the total is the mix-minus */
+  if (contribution == NULL)
+    return gst_buffer_ref (mix);
+
+  outbuf = gst_buffer_copy_deep (mix);
+
+  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
+  gst_buffer_map (contribution, &contribmap, GST_MAP_READ);
+
+  /* the last buffer before EOS can be shorter than what was mixed into */
+  size = MIN (outmap.size, contribmap.size);
+  gst_audiomixer_subtract_samples (GST_AUDIO_INFO_FORMAT (info), outmap.data,
+      contribmap.data, size * 8 / GST_AUDIO_INFO_WIDTH (info));
+
+  gst_buffer_unmap (contribution, &contribmap);
+  gst_buffer_unmap (outbuf, &outmap);
+
+  return outbuf;
+}
+
+typedef struct
+{
+  GstPad *pad;
+  GstBuffer *buffer;
+} GstAudioMixerMinusOne;
+
+static GstFlowReturn
+gst_audiomixer_finish_buffer (GstAggregator * agg, GstBuffer * buffer)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (agg);
+  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  GArray *outputs = NULL;
+  GstFlowReturn ret;
+  GList *l;
+  guint i;
+
+  /* Compute all mix-minus outputs before the total goes downstream, it
+   * might get modified there */
+  GST_OBJECT_LOCK (agg);
+  for (l = GST_ELEMENT_CAST (agg)->sinkpads; l; l = l->next) {
+    GstAudioMixerPad *pad = l->data;
+    GstAudioMixerMinusOne output;
+
+    GST_OBJECT_LOCK (pad);
+    if (pad->minus_one_pad) {
+      output.pad = gst_object_ref (pad->minus_one_pad);
+      output.buffer = gst_audiomixer_make_minus_one (&srcpad->info, buffer,
+          pad->contribution);
+
+      if (outputs == NULL)
+        outputs = g_array_new (FALSE, FALSE, sizeof (GstAudioMixerMinusOne));
+      g_array_append_val (outputs, output);
+    }
+    gst_clear_buffer (&pad->contribution);
+    GST_OBJECT_UNLOCK (pad);
+  }
+  GST_OBJECT_UNLOCK (agg);
+
+  ret = GST_AGGREGATOR_CLASS (parent_class)->finish_buffer (agg, buffer);
+
+  if (outputs == NULL)
+    return ret;
+
+  GST_OBJECT_LOCK (audiomixer);
+  ret = gst_flow_combiner_update_pad_flow (audiomixer->flow_combiner,
+      agg->srcpad, ret);
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  for (i = 0; i < outputs->len; i++) {
+    GstAudioMixerMinusOne *output =
+        &g_array_index (outputs, GstAudioMixerMinusOne, i);
+    GstFlowReturn pad_ret;
+
+    pad_ret = gst_pad_push (output->pad, output->buffer);
+    GST_LOG_OBJECT (output->pad, "pushed mix-minus buffer, result = %s",
+        gst_flow_get_name (pad_ret));
+
+    GST_OBJECT_LOCK (audiomixer);
+    ret = gst_flow_combiner_update_pad_flow (audiomixer->flow_combiner,
+        output->pad, pad_ret);
+    GST_OBJECT_UNLOCK (audiomixer);
+
+    gst_object_unref (output->pad);
+  }
+  g_array_free (outputs, TRUE);
+
+  return ret;
+}
+
+static void
+gst_audiomixer_clear_contributions (GstAudioMixer * audiomixer)
+{
+  GList *l;
+
+  GST_OBJECT_LOCK (audiomixer);
+  for (l = GST_ELEMENT_CAST (audiomixer)->sinkpads; l; l = l->next) {
+    GstAudioMixerPad *pad = l->data;
+
+    GST_OBJECT_LOCK (pad);
+    gst_clear_buffer (&pad->contribution);
+    GST_OBJECT_UNLOCK (pad);
+  }
+  gst_flow_combiner_reset (audiomixer->flow_combiner);
+  GST_OBJECT_UNLOCK (audiomixer);
+}
+
+static gboolean
+gst_audiomixer_negotiated_src_caps (GstAggregator * agg, GstCaps * caps)
+{
+  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  GstAudioInfo old_info = srcpad->info;
+
+  if (!GST_AGGREGATOR_CLASS (parent_class)->negotiated_src_caps (agg, caps))
+    return FALSE;
+
+  /* A partially mixed output buffer gets converted to the new format by the
+   * base class, the contributions can't be subtracted from it anymore. The
+   * mix-minus outputs of that one buffer then contain their own input. */
+  if (!gst_audio_info_is_equal (&old_info, &srcpad->info))
+    gst_audiomixer_clear_contributions (GST_AUDIO_MIXER (agg));
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_audiomixer_flush (GstAggregator * agg)
+{
+  gst_audiomixer_clear_contributions (GST_AUDIO_MIXER (agg));
+
+  return GST_AGGREGATOR_CLASS (parent_class)->flush (agg);
+}
+
+static gboolean
+gst_audiomixer_stop (GstAggregator * agg)
+{
+  gst_audiomixer_clear_contributions (GST_AUDIO_MIXER (agg));
+
+  return GST_AGGREGATOR_CLASS (parent_class)->stop (agg);
+}
+
 
 /* GstChildProxy implementation */
 static GObject *
@@ -27,6 +27,7 @@
 #include <gst/gst.h>
 #include <gst/audio/audio.h>
 #include <gst/audio/gstaudioaggregator.h>
+#include <gst/base/gstflowcombiner.h>
 
 G_BEGIN_DECLS
 
@@ -41,6 +42,11 @@ G_DECLARE_FINAL_TYPE (GstAudioMixer, gst_audiomixer, GST, AUDIO_MIXER,
  */
 struct _GstAudioMixer {
   GstAudioAggregator element;
+
+  /*< private >*/
+  /* combines the flow returns of the src pad and the src_%u pads,
+   * protected by the object lock */
+  GstFlowCombiner *flow_combiner;
 };
 
 #define GST_TYPE_AUDIO_MIXER_PAD (gst_audiomixer_pad_get_type())
@@ -55,6 +61,11 @@ struct _GstAudioMixerPad {
   gint volume_i16;
   gint volume_i8;
   gboolean mute;
+
+  /* mix-minus src_%u pad for this input and this input's share of the
+   * output buffer currently being mixed, protected by the object lock */
+  GstPad *minus_one_pad;
+  GstBuffer *contribution;
 };
 
 G_END_DECLS
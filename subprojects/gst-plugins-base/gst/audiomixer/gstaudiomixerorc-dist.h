@@ -88,6 +88,14 @@ void audiomixer_orc_add_u16 (guint16 * ORC_RESTRICT d1, const guint16 * ORC_REST
 void audiomixer_orc_add_u8 (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1, int n);
 void audiomixer_orc_add_f32 (float * ORC_RESTRICT d1, const float * ORC_RESTRICT s1, int n);
 void audiomixer_orc_add_f64 (double * ORC_RESTRICT d1, const double * ORC_RESTRICT s1, int n);
+void audiomixer_orc_sub_s32 (gint32 * ORC_RESTRICT d1, const gint32 * ORC_RESTRICT s1, int n);
+void audiomixer_orc_sub_s16 (gint16 * ORC_RESTRICT d1, const gint16 * ORC_RESTRICT s1, int n);
+void audiomixer_orc_sub_s8 (gint8 * ORC_RESTRICT d1, const gint8 * ORC_RESTRICT s1, int n);
+void audiomixer_orc_sub_u32 (guint32 * ORC_RESTRICT d1, const guint32 * ORC_RESTRICT s1, int n);
+void audiomixer_orc_sub_u16 (guint16 * ORC_RESTRICT d1, const guint16 * ORC_RESTRICT s1, int n);
+void audiomixer_orc_sub_u8 (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1, int n);
+void audiomixer_orc_sub_f32 (float * ORC_RESTRICT d1, const float * ORC_RESTRICT s1, int n);
+void audiomixer_orc_sub_f64 (double * ORC_RESTRICT d1, const double * ORC_RESTRICT s1, int n);
 void audiomixer_orc_volume_u8 (guint8 * ORC_RESTRICT d1, int p1, int n);
 void audiomixer_orc_add_volume_u8 (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1, int p1, int n);
 void audiomixer_orc_add_volume_s8 (gint8 * ORC_RESTRICT d1, const gint8 * ORC_RESTRICT s1, int p1, int n);
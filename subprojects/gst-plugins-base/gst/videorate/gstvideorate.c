@@ -100,6 +100,8 @@ enum
 #define DEFAULT_MAX_RATE        G_MAXINT
 #define DEFAULT_RATE            1.0
 #define DEFAULT_MAX_DUPLICATION_TIME      0
+#define DEFAULT_EMIT_BUFFER_LIST          FALSE
+#define DEFAULT_DROP_UPSTREAM             FALSE
 
 enum
 {
@@ -115,7 +117,9 @@ enum
   PROP_AVERAGE_PERIOD,
   PROP_MAX_RATE,
   PROP_RATE,
-  PROP_MAX_DUPLICATION_TIME
+  PROP_MAX_DUPLICATION_TIME,
+  PROP_EMIT_BUFFER_LIST,
+  PROP_DROP_UPSTREAM
 };
 
 static GstStaticPadTemplate gst_video_rate_src_template =
@@ -295,6 +299,39 @@ gst_video_rate_class_init (GstVideoRateClass * klass)
           0, G_MAXUINT64, DEFAULT_MAX_DUPLICATION_TIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoRate:emit-buffer-list:
+   *
+   * Collect all frames that are produced for a single input frame, e.g.
+   * duplicates when increasing the framerate, and push them downstream
+   * together in a #GstBufferList instead of one by one.
+   *
+   * Duplicates share the memory of the original frame and only carry their
+   * own timestamps and flags.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (object_class, PROP_EMIT_BUFFER_LIST,
+      g_param_spec_boolean ("emit-buffer-list", "Emit buffer list",
+          "Push the frames produced for one input frame as a buffer list",
+          DEFAULT_EMIT_BUFFER_LIST,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoRate:drop-upstream:
+   *
+   * Send QoS events upstream for input frames that are going to be dropped
+   * because of the output framerate, so that upstream elements like video
+   * decoders can skip processing them.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (object_class, PROP_DROP_UPSTREAM,
+      g_param_spec_boolean ("drop-upstream", "Drop upstream",
+          "Send QoS events upstream so that frames that would be dropped "
+          "are not produced in the first place", DEFAULT_DROP_UPSTREAM,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (element_class,
       "Video rate adjuster", "Filter/Effect/Video",
       "Drops/duplicates/adjusts timestamps on video frames to make a perfect stream",
@@ -619,6 +656,11 @@ gst_video_rate_reset (GstVideoRate * videorate)
   videorate->discont = TRUE;
   videorate->average = 0;
   videorate->force_variable_rate = FALSE;
+  GST_OBJECT_LOCK (videorate);
+  videorate->qos_earliest_time = GST_CLOCK_TIME_NONE;
+  videorate->qos_proportion = 1.0;
+  videorate->qos_downstream_earliest = GST_CLOCK_TIME_NONE;
+  GST_OBJECT_UNLOCK (videorate);
   gst_video_rate_swap_prev (videorate, NULL, 0);
 
   gst_segment_init (&videorate->segment, GST_FORMAT_TIME);
@@ -637,6 +679,8 @@ gst_video_rate_init (GstVideoRate * videorate)
   videorate->rate = DEFAULT_RATE;
   videorate->pending_rate = DEFAULT_RATE;
   videorate->max_duplication_time = DEFAULT_MAX_DUPLICATION_TIME;
+  videorate->emit_buffer_list = DEFAULT_EMIT_BUFFER_LIST;
+  videorate->drop_upstream = DEFAULT_DROP_UPSTREAM;
 
   videorate->from_rate_numerator = 0;
   videorate->from_rate_denominator = 0;
@@ -725,6 +769,15 @@ gst_video_rate_push_buffer (GstVideoRate * videorate, GstBuffer * outbuf,
     GST_BUFFER_TIMESTAMP (outbuf) = push_ts - videorate->segment.base;
   }
 
+  /* Collected and pushed as a whole once the input buffer is handled */
+  if (videorate->pending_list) {
+    GST_LOG_OBJECT (videorate,
+        "old is best, dup, queueing buffer outgoing ts %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (push_ts));
+    gst_buffer_list_add (videorate->pending_list, outbuf);
+    return GST_FLOW_OK;
+  }
+
   GST_LOG_OBJECT (videorate,
       "old is best, dup, pushing buffer outgoing ts %" GST_TIME_FORMAT,
       GST_TIME_ARGS (push_ts));
@@ -840,6 +893,9 @@ gst_video_rate_sink_event (GstBaseTransform * trans, GstEvent * event)
       videorate->base_ts = 0;
       videorate->out_frame_count = 0;
       videorate->next_ts = GST_CLOCK_TIME_NONE;
+      GST_OBJECT_LOCK (videorate);
+      videorate->qos_earliest_time = GST_CLOCK_TIME_NONE;
+      GST_OBJECT_UNLOCK (videorate);
 
       /* We just want to update the accumulated stream_time  */
 
@@ -994,7 +1050,7 @@ gst_video_rate_src_event (GstBaseTransform * trans, GstEvent * event)
       GstQOSType type;
       gdouble proportion;
       GstClockTimeDiff diff;
-      GstClockTime timestamp;
+      GstClockTime timestamp, earliest = GST_CLOCK_TIME_NONE;
 
       gst_event_parse_qos (event, &type, &proportion, &diff, &timestamp);
 
@@ -1024,6 +1080,31 @@ gst_video_rate_src_event (GstBaseTransform * trans, GstEvent * event)
         gst_event_unref (event);
         event = gst_event_new_qos (type, proportion, diff, timestamp);
       }
+
+      GST_OBJECT_LOCK (trans);
+      videorate->qos_proportion = proportion;
+      if (GST_CLOCK_TIME_IS_VALID (timestamp))
+        videorate->qos_downstream_earliest =
+            MAX ((GstClockTimeDiff) timestamp + diff, 0);
+      else
+        videorate->qos_downstream_earliest = GST_CLOCK_TIME_NONE;
+
+      /* Upstream only keeps the last QoS event, don't let downstream undo
+       * our own request to skip frames that are going to be dropped */
+      if (videorate->drop_upstream &&
+          GST_CLOCK_TIME_IS_VALID (videorate->qos_earliest_time) &&
+          (!GST_CLOCK_TIME_IS_VALID (videorate->qos_downstream_earliest) ||
+              videorate->qos_downstream_earliest <
+              videorate->qos_earliest_time))
+        earliest = videorate->qos_earliest_time;
+      GST_OBJECT_UNLOCK (trans);
+
+      if (GST_CLOCK_TIME_IS_VALID (earliest)) {
+        GST_LOG_OBJECT (trans, "Combining downstream QoS with our earliest "
+            "time %" GST_TIME_FORMAT, GST_TIME_ARGS (earliest));
+        gst_event_unref (event);
+        event = gst_event_new_qos (type, proportion, 0, earliest);
+      }
       /* Fallthrough */
     }
     default:
@@ -1461,15 +1542,12 @@ done:
 }
 
 static GstFlowReturn
-gst_video_rate_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
+gst_video_rate_process_buffer (GstVideoRate * videorate, GstBuffer * buffer)
 {
-  GstVideoRate *videorate;
   GstFlowReturn res = GST_BASE_TRANSFORM_FLOW_DROPPED;
   GstClockTime intime, in_ts, in_dur, last_ts;
   gboolean skip;
 
-  videorate = GST_VIDEO_RATE (trans);
-
   /* make sure the denominators are not 0 */
   if (videorate->from_rate_denominator == 0 ||
       videorate->to_rate_denominator == 0)
@@ -1775,6 +1853,102 @@ invalid_buffer:
   }
 }
 
+/* Tell upstream that input frames more than half an input frame duration
+ * before the next output timestamp are not going to be used, as the following
+ * input frame will always be closer to it. Only done for the simple forward
+ * playback case where input and output running times match. The proportion
+ * of the last downstream QoS event is kept, and nothing is sent while
+ * downstream already asks upstream to skip more than that. */
+static void
+gst_video_rate_send_upstream_qos (GstVideoRate * videorate)
+{
+  GstClockTime half_dur, earliest, next_pos;
+  gdouble proportion;
+  GstEvent *event;
+
+  if (videorate->segment.rate <= 0.0 || videorate->rate != 1.0 ||
+      videorate->to_rate_numerator == 0 ||
+      videorate->from_rate_numerator == 0 ||
+      !GST_CLOCK_TIME_IS_VALID (videorate->next_ts) ||
+      !GST_CLOCK_TIME_IS_VALID (videorate->last_ts))
+    return;
+
+  half_dur = gst_util_uint64_scale (GST_SECOND,
+      videorate->from_rate_denominator,
+      2 * (guint64) videorate->from_rate_numerator);
+
+  if (videorate->next_ts < videorate->segment.base + half_dur)
+    return;
+
+  next_pos = videorate->next_ts - videorate->segment.base - half_dur;
+
+  /* The next input frame is still going to be used */
+  if (next_pos <= videorate->last_ts)
+    return;
+
+  earliest = gst_segment_to_running_time (&videorate->segment,
+      GST_FORMAT_TIME, next_pos);
+  if (!GST_CLOCK_TIME_IS_VALID (earliest))
+    return;
+
+  GST_OBJECT_LOCK (videorate);
+  if ((GST_CLOCK_TIME_IS_VALID (videorate->qos_earliest_time) &&
+          earliest <= videorate->qos_earliest_time) ||
+      (GST_CLOCK_TIME_IS_VALID (videorate->qos_downstream_earliest) &&
+          earliest <= videorate->qos_downstream_earliest)) {
+    GST_OBJECT_UNLOCK (videorate);
+    return;
+  }
+  videorate->qos_earliest_time = earliest;
+  proportion = videorate->qos_proportion;
+  GST_OBJECT_UNLOCK (videorate);
+
+  GST_LOG_OBJECT (videorate, "Asking upstream to skip frames before %"
+      GST_TIME_FORMAT, GST_TIME_ARGS (earliest));
+
+  event = gst_event_new_qos (GST_QOS_TYPE_THROTTLE, proportion, 0, earliest);
+  gst_pad_push_event (GST_BASE_TRANSFORM_SINK_PAD (videorate), event);
+}
+
+static GstFlowReturn
+gst_video_rate_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
+{
+  GstVideoRate *videorate = GST_VIDEO_RATE (trans);
+  GstBufferList *list;
+  GstFlowReturn res;
+
+  if (!videorate->emit_buffer_list) {
+    res = gst_video_rate_process_buffer (videorate, buffer);
+    goto done;
+  }
+
+  videorate->pending_list = gst_buffer_list_new ();
+  res = gst_video_rate_process_buffer (videorate, buffer);
+  list = videorate->pending_list;
+  videorate->pending_list = NULL;
+
+  if (gst_buffer_list_length (list) > 0) {
+    GstFlowReturn r;
+
+    GST_LOG_OBJECT (videorate, "pushing list of %u buffers",
+        gst_buffer_list_length (list));
+
+    r = gst_pad_push_list (GST_BASE_TRANSFORM_SRC_PAD (videorate), list);
+    if (r != GST_FLOW_OK && (res == GST_FLOW_OK
+            || res == GST_BASE_TRANSFORM_FLOW_DROPPED))
+      res = r;
+  } else {
+    gst_buffer_list_unref (list);
+  }
+
+done:
+  if (videorate->drop_upstream && (res == GST_FLOW_OK
+          || res == GST_BASE_TRANSFORM_FLOW_DROPPED))
+    gst_video_rate_send_upstream_qos (videorate);
+
+  return res;
+}
+
 static gboolean
 gst_video_rate_start (GstBaseTransform * trans)
 {
@@ -1839,6 +2013,12 @@ gst_video_rate_set_property (GObject * object,
     case PROP_MAX_DUPLICATION_TIME:
       videorate->max_duplication_time = g_value_get_uint64 (value);
       break;
+    case PROP_EMIT_BUFFER_LIST:
+      videorate->emit_buffer_list = g_value_get_boolean (value);
+      break;
+    case PROP_DROP_UPSTREAM:
+      videorate->drop_upstream = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1901,6 +2081,12 @@ gst_video_rate_get_property (GObject * object,
     case PROP_MAX_DUPLICATION_TIME:
       g_value_set_uint64 (value, videorate->max_duplication_time);
       break;
+    case PROP_EMIT_BUFFER_LIST:
+      g_value_set_boolean (value, videorate->emit_buffer_list);
+      break;
+    case PROP_DROP_UPSTREAM:
+      g_value_set_boolean (value, videorate->drop_upstream);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
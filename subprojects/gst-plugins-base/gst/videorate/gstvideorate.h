@@ -58,6 +58,15 @@ struct _GstVideoRate
   gboolean force_variable_rate;
   gboolean updating_caps;
   guint64 max_duplication_time;
+  GstBufferList *pending_list;  /* output buffers collected while handling a
+                                 * single input buffer in emit-buffer-list
+                                 * mode */
+  GstClockTime qos_earliest_time;       /* last earliest running time sent
+                                         * upstream in a QoS event */
+  gdouble qos_proportion;       /* proportion of the last downstream QoS
+                                 * event */
+  GstClockTime qos_downstream_earliest; /* earliest running time of the last
+                                         * downstream QoS event */
 
   /* segment handling */
   GstSegment segment;
@@ -73,6 +82,8 @@ struct _GstVideoRate
   int max_rate;
   gdouble rate;
   gdouble pending_rate;
+  gboolean emit_buffer_list;
+  gboolean drop_upstream;
 };
 
 GST_ELEMENT_REGISTER_DECLARE (videorate);
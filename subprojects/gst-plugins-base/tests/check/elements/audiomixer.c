@@ -2220,6 +2220,147 @@ GST_START_TEST (test_qos_message_live)
 
 GST_END_TEST;
 
+static void
+minus_one_handoff_cb (GstElement * fakesink, GstBuffer * buffer, GstPad * pad,
+    GstBuffer ** out)
+{
+  gst_buffer_replace (out, buffer);
+}
+
+static void
+check_float_buffer (GstBuffer * buffer, gfloat expected)
+{
+  GstMapInfo map;
+  gsize i;
+
+  fail_unless (buffer != NULL);
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  fail_unless_equals_int (map.size, 10 * sizeof (gfloat));
+  for (i = 0; i < 10; i++)
+    fail_unless_equals_float (((gfloat *) map.data)[i], expected);
+  gst_buffer_unmap (buffer, &map);
+}
+
+/* Two inputs with different levels, one with a volume, and one mix-minus
+ * output for each of them. Each mix-minus output must only contain the
+ * other input. */
+GST_START_TEST (test_minus_one)
+{
+  GstElement *bin, *audiomixer, *sink, *sinks[2];
+  GstPad *sinkpads[2], *srcpads[2], *pad;
+  GstBuffer *outputs[3] = { NULL, };
+  const gfloat levels[2] = { 1.0, 0.25 };
+  GstStateChangeReturn state_res;
+  GstQuery *drain;
+  GstSegment segment;
+  GstCaps *caps;
+  gint i;
+
+  bin = gst_pipeline_new ("pipeline");
+  audiomixer = gst_element_factory_make ("audiomixer", "audiomixer");
+  g_object_set (audiomixer, "output-buffer-duration", GST_SECOND, NULL);
+  sink = gst_element_factory_make ("fakesink", "sink");
+  g_object_set (sink, "signal-handoffs", TRUE, "async", FALSE, NULL);
+  g_signal_connect (sink, "handoff", (GCallback) minus_one_handoff_cb,
+      &outputs[2]);
+  gst_bin_add_many (GST_BIN (bin), audiomixer, sink, NULL);
+  fail_unless (gst_element_link (audiomixer, sink));
+
+  for (i = 0; i < 2; i++) {
+    sinks[i] = gst_element_factory_make ("fakesink", NULL);
+    g_object_set (sinks[i], "signal-handoffs", TRUE, "async", FALSE, NULL);
+    g_signal_connect (sinks[i], "handoff", (GCallback) minus_one_handoff_cb,
+        &outputs[i]);
+    gst_bin_add (GST_BIN (bin), sinks[i]);
+  }
+
+  state_res = gst_element_set_state (bin, GST_STATE_PLAYING);
+  ck_assert_int_ne (state_res, GST_STATE_CHANGE_FAILURE);
+
+  /* mix-minus pads need an existing input */
+  fail_unless (gst_element_request_pad_simple (audiomixer, "src_0") == NULL);
+
+  for (i = 0; i < 2; i++) {
+    gchar *name;
+
+    sinkpads[i] = gst_element_request_pad_simple (audiomixer, "sink_%u");
+    fail_unless (sinkpads[i] != NULL);
+    name = g_strdup_printf ("sink_%d", i);
+    fail_unless_equals_string (GST_PAD_NAME (sinkpads[i]), name);
+    g_free (name);
+
+    name = g_strdup_printf ("src_%d", i);
+    srcpads[i] = gst_element_request_pad_simple (audiomixer, name);
+    g_free (name);
+    fail_unless (srcpads[i] != NULL);
+
+    pad = gst_element_get_static_pad (sinks[i], "sink");
+    fail_unless_equals_int (gst_pad_link (srcpads[i], pad), GST_PAD_LINK_OK);
+    gst_object_unref (pad);
+  }
+  g_object_set (sinkpads[1], "volume", 0.5, NULL);
+
+  /* only one mix-minus pad per input */
+  fail_unless (gst_element_request_pad_simple (audiomixer, "src_0") == NULL);
+
+  caps = gst_caps_new_simple ("audio/x-raw",
+      "format", G_TYPE_STRING, GST_AUDIO_NE (F32),
+      "layout", G_TYPE_STRING, "interleaved",
+      "rate", G_TYPE_INT, 10, "channels", G_TYPE_INT, 1, NULL);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+
+  for (i = 0; i < 2; i++) {
+    GstBuffer *buffer;
+    GstMapInfo map;
+    gint j;
+
+    gst_pad_send_event (sinkpads[i], gst_event_new_stream_start ("test"));
+    gst_pad_set_caps (sinkpads[i], caps);
+    gst_pad_send_event (sinkpads[i], gst_event_new_segment (&segment));
+
+    buffer = gst_buffer_new_and_alloc (10 * sizeof (gfloat));
+    gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+    for (j = 0; j < 10; j++)
+      ((gfloat *) map.data)[j] = levels[i];
+    gst_buffer_unmap (buffer, &map);
+    GST_BUFFER_PTS (buffer) = 0;
+    GST_BUFFER_DURATION (buffer) = GST_SECOND;
+
+    fail_unless_equals_int (gst_pad_chain (sinkpads[i], buffer), GST_FLOW_OK);
+  }
+  gst_caps_unref (caps);
+
+  drain = gst_query_new_drain ();
+  for (i = 0; i < 2; i++)
+    gst_pad_query (sinkpads[i], drain);
+  gst_query_unref (drain);
+
+  check_float_buffer (outputs[2], 1.0 + 0.5 * 0.25);
+  check_float_buffer (outputs[0], 0.5 * 0.25);
+  check_float_buffer (outputs[1], 1.0);
+
+  pad = gst_element_get_static_pad (sinks[0], "sink");
+  caps = gst_pad_get_current_caps (pad);
+  fail_unless (caps != NULL);
+  gst_caps_unref (caps);
+  gst_object_unref (pad);
+
+  for (i = 0; i < 3; i++)
+    gst_clear_buffer (&outputs[i]);
+
+  for (i = 0; i < 2; i++) {
+    gst_element_release_request_pad (audiomixer, srcpads[i]);
+    gst_object_unref (srcpads[i]);
+    gst_element_release_request_pad (audiomixer, sinkpads[i]);
+    gst_object_unref (sinkpads[i]);
+  }
+
+  gst_element_set_state (bin, GST_STATE_NULL);
+  gst_object_unref (bin);
+}
+
+GST_END_TEST;
+
 static Suite *
 audiomixer_suite (void)
 {
@@ -2252,6 +2393,7 @@ audiomixer_suite (void)
   tcase_add_checked_fixture (tc_chain, test_setup, test_teardown);
   tcase_add_test (tc_chain, test_change_output_caps);
   tcase_add_test (tc_chain, test_change_output_caps_mid_output_buffer);
+  tcase_add_test (tc_chain, test_minus_one);
 
   /* Use a longer timeout */
 #ifdef HAVE_VALGRIND
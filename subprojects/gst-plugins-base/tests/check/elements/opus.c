@@ -488,6 +488,62 @@ GST_START_TEST (test_opus_decode_plc_timestamps_with_fec)
 
 GST_END_TEST;
 
+static GstBuffer *
+decode_dtx_packet (gboolean dtx_gap, guint64 * num_dtx)
+{
+  GstHarness *h = gst_harness_new ("opusdec");
+  GstStructure *stats;
+  GstBuffer *buf;
+  /* SILK narrowband 20ms mono, no frame data */
+  static const guint8 dtx_packet[] = { 0x08 };
+
+  g_object_set (h->element, "dtx-gap", dtx_gap, NULL);
+  gst_harness_set_src_caps_str (h, "audio/x-opus, channel-mapping-family=0, "
+      "channels=1, rate=48000");
+
+  buf = gst_buffer_new_memdup (dtx_packet, sizeof (dtx_packet));
+  GST_BUFFER_PTS (buf) = 0;
+  GST_BUFFER_DURATION (buf) = 20 * GST_MSECOND;
+  fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+
+  fail_unless (buf = gst_harness_pull (h));
+  fail_unless_equals_int (gst_buffer_get_size (buf), 960 * 2);
+
+  g_object_get (h->element, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "num-dtx", num_dtx));
+  gst_structure_free (stats);
+
+  gst_harness_teardown (h);
+
+  return buf;
+}
+
+GST_START_TEST (test_opus_decode_dtx_gap)
+{
+  GstBuffer *buf;
+  GstMapInfo map;
+  guint64 num_dtx = 0;
+  gsize i;
+
+  /* comfort noise by default */
+  buf = decode_dtx_packet (FALSE, &num_dtx);
+  fail_unless_equals_uint64 (num_dtx, 1);
+  fail_if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_GAP));
+  gst_buffer_unref (buf);
+
+  /* silent GAP buffer with dtx-gap */
+  buf = decode_dtx_packet (TRUE, &num_dtx);
+  fail_unless_equals_uint64 (num_dtx, 1);
+  fail_unless (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_GAP));
+  fail_unless (gst_buffer_map (buf, &map, GST_MAP_READ));
+  for (i = 0; i < map.size; i++)
+    fail_unless_equals_int (map.data[i], 0);
+  gst_buffer_unmap (buf, &map);
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
 static Suite *
 opus_suite (void)
 {
@@ -502,6 +558,7 @@ opus_suite (void)
   tcase_add_test (tc_chain, test_opus_encode_properties);
   tcase_add_test (tc_chain, test_opusdec_getcaps);
   tcase_add_test (tc_chain, test_opus_decode_plc_timestamps_with_fec);
+  tcase_add_test (tc_chain, test_opus_decode_dtx_gap);
 
   return s;
 }
@@ -24,6 +24,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 
 /* For ease of programming we use globals to keep refs for our floating
  * src and sink pads we create; otherwise we always have to do get_pad,
@@ -1589,6 +1590,202 @@ GST_START_TEST (test_nopts_in_middle)
 
 GST_END_TEST;
 
+static GstPadProbeReturn
+count_buffer_lists (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  guint *n_lists = user_data;
+
+  *n_lists += 1;
+
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_emit_buffer_list)
+{
+  GstHarness *h;
+  GstBuffer *in[3], *out;
+  GstClockTime expected_ts[] = { 0, 16666666, 33333333, 50000000 };
+  guint n_lists = 0;
+  gint i;
+
+  h = gst_harness_new ("videorate");
+  g_object_set (h->element, "emit-buffer-list", TRUE, NULL);
+  gst_harness_set_src_caps_str (h, VIDEO_CAPS_STRING);
+  gst_harness_set_sink_caps_str (h, "video/x-raw, width = (int) 320, "
+      "height = (int) 240, framerate = (fraction) 60/1, "
+      "format = (string) I420");
+  gst_pad_add_probe (h->sinkpad, GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      count_buffer_lists, &n_lists, NULL);
+
+  for (i = 0; i < 3; i++) {
+    in[i] = gst_buffer_new_and_alloc (4);
+    gst_buffer_memset (in[i], 0, i, 4);
+    GST_BUFFER_PTS (in[i]) = i * 40 * GST_MSECOND;
+    GST_BUFFER_DURATION (in[i]) = 40 * GST_MSECOND;
+    fail_unless_equals_int (gst_harness_push (h, gst_buffer_ref (in[i])),
+        GST_FLOW_OK);
+  }
+
+  /* 2 frames are produced for each of the first 2 input frames, each pair
+   * in a single list */
+  fail_unless_equals_int (n_lists, 2);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 4);
+
+  for (i = 0; i < 4; i++) {
+    out = gst_harness_pull (h);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (out), expected_ts[i]);
+    /* duplicates reference the memory of the input frame */
+    fail_unless (gst_buffer_peek_memory (out, 0) ==
+        gst_buffer_peek_memory (in[i / 2], 0));
+    if (i % 2 == 1)
+      fail_unless (GST_BUFFER_FLAG_IS_SET (out, GST_BUFFER_FLAG_GAP));
+    gst_buffer_unref (out);
+  }
+
+  for (i = 0; i < 3; i++)
+    gst_buffer_unref (in[i]);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_drop_upstream)
+{
+  GstHarness *h;
+  GstEvent *event;
+  GstClockTime timestamp = GST_CLOCK_TIME_NONE;
+  gint i;
+
+  h = gst_harness_new ("videorate");
+  g_object_set (h->element, "drop-upstream", TRUE, NULL);
+  gst_harness_set_src_caps_str (h, "video/x-raw, width = (int) 320, "
+      "height = (int) 240, framerate = (fraction) 60/1, "
+      "format = (string) I420");
+  gst_harness_set_sink_caps_str (h, VIDEO_CAPS_STRING);
+
+  for (i = 0; i < 4; i++) {
+    GstBuffer *buf = gst_buffer_new_and_alloc (4);
+
+    GST_BUFFER_PTS (buf) = gst_util_uint64_scale (i, GST_SECOND, 60);
+    GST_BUFFER_DURATION (buf) = gst_util_uint64_scale (1, GST_SECOND, 60);
+    fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  }
+
+  while ((event = gst_harness_try_pull_upstream_event (h))) {
+    if (GST_EVENT_TYPE (event) == GST_EVENT_QOS) {
+      fail_unless (!GST_CLOCK_TIME_IS_VALID (timestamp));
+      gst_event_parse_qos (event, NULL, NULL, NULL, &timestamp);
+    }
+    gst_event_unref (event);
+  }
+
+  /* The next output frame is at 80ms, the input frame at 66.7ms is further
+   * away from it than the one at 83.3ms and can be skipped upstream */
+  fail_unless_equals_uint64 (timestamp, 80 * GST_MSECOND - GST_SECOND / 120);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+/* Pulls the events sent upstream and returns how many of them were QoS
+ * events, with the values of the last one */
+static guint
+pull_upstream_qos (GstHarness * h, GstQOSType * type, gdouble * proportion,
+    GstClockTimeDiff * diff, GstClockTime * timestamp)
+{
+  GstEvent *event;
+  guint n_qos = 0;
+
+  while ((event = gst_harness_try_pull_upstream_event (h))) {
+    if (GST_EVENT_TYPE (event) == GST_EVENT_QOS) {
+      gst_event_parse_qos (event, type, proportion, diff, timestamp);
+      n_qos++;
+    }
+    gst_event_unref (event);
+  }
+
+  return n_qos;
+}
+
+static void
+push_60fps_buffers (GstHarness * h, gint start, gint end)
+{
+  gint i;
+
+  for (i = start; i < end; i++) {
+    GstBuffer *buf = gst_buffer_new_and_alloc (4);
+
+    GST_BUFFER_PTS (buf) = gst_util_uint64_scale (i, GST_SECOND, 60);
+    GST_BUFFER_DURATION (buf) = gst_util_uint64_scale (1, GST_SECOND, 60);
+    fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  }
+}
+
+/* Upstream only keeps the last QoS event, so the QoS events of downstream
+ * and the ones videorate sends on its own are combined to always ask for
+ * the later of both earliest times */
+GST_START_TEST (test_drop_upstream_downstream_qos)
+{
+  GstHarness *h;
+  GstQOSType type;
+  gdouble proportion;
+  GstClockTimeDiff diff;
+  GstClockTime timestamp, own_earliest;
+
+  h = gst_harness_new ("videorate");
+  g_object_set (h->element, "drop-upstream", TRUE, NULL);
+  gst_harness_set_src_caps_str (h, "video/x-raw, width = (int) 320, "
+      "height = (int) 240, framerate = (fraction) 60/1, "
+      "format = (string) I420");
+  gst_harness_set_sink_caps_str (h, VIDEO_CAPS_STRING);
+
+  push_60fps_buffers (h, 0, 4);
+  fail_unless_equals_int (pull_upstream_qos (h, &type, &proportion, &diff,
+          &own_earliest), 1);
+  fail_unless_equals_uint64 (own_earliest, 80 * GST_MSECOND - GST_SECOND / 120);
+
+  /* Downstream asking for less keeps its type and proportion but not its
+   * earliest time */
+  fail_unless (gst_harness_push_upstream_event (h,
+          gst_event_new_qos (GST_QOS_TYPE_OVERFLOW, 0.5, 0,
+              20 * GST_MSECOND)));
+  fail_unless_equals_int (pull_upstream_qos (h, &type, &proportion, &diff,
+          &timestamp), 1);
+  fail_unless_equals_int (type, GST_QOS_TYPE_OVERFLOW);
+  fail_unless_equals_float (proportion, 0.5);
+  fail_unless_equals_int64 (diff, 0);
+  fail_unless_equals_uint64 (timestamp, own_earliest);
+
+  /* Our own events keep the proportion of downstream */
+  push_60fps_buffers (h, 4, 8);
+  fail_unless (pull_upstream_qos (h, &type, &proportion, &diff,
+          &timestamp) > 0);
+  fail_unless_equals_int (type, GST_QOS_TYPE_THROTTLE);
+  fail_unless_equals_float (proportion, 0.5);
+  fail_unless (timestamp > own_earliest);
+
+  /* Downstream asking for more is passed on as is and not undone by our
+   * own events */
+  fail_unless (gst_harness_push_upstream_event (h,
+          gst_event_new_qos (GST_QOS_TYPE_UNDERFLOW, 2.0, 10 * GST_MSECOND,
+              500 * GST_MSECOND)));
+  fail_unless_equals_int (pull_upstream_qos (h, &type, &proportion, &diff,
+          &timestamp), 1);
+  fail_unless_equals_int (type, GST_QOS_TYPE_UNDERFLOW);
+  fail_unless_equals_float (proportion, 2.0);
+  fail_unless_equals_int64 (diff, 10 * GST_MSECOND);
+  fail_unless_equals_uint64 (timestamp, 500 * GST_MSECOND);
+
+  push_60fps_buffers (h, 8, 12);
+  fail_unless_equals_int (pull_upstream_qos (h, &type, &proportion, &diff,
+          &timestamp), 0);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 videorate_suite (void)
 {
@@ -1615,6 +1812,9 @@ videorate_suite (void)
   tcase_add_loop_test (tc_chain, test_query_position, 0,
       G_N_ELEMENTS (position_tests));
   tcase_add_test (tc_chain, test_nopts_in_middle);
+  tcase_add_test (tc_chain, test_emit_buffer_list);
+  tcase_add_test (tc_chain, test_drop_upstream);
+  tcase_add_test (tc_chain, test_drop_upstream_downstream_qos);
 
   return s;
 }
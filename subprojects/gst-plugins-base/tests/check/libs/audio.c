@@ -1578,6 +1578,202 @@ GST_START_TEST (test_audio_make_raw_caps)
 
 GST_END_TEST;
 
+/* Matrices of the shapes the channel mixer has special handling for */
+enum
+{
+  MIX_IDENTITY_SUBSET,
+  MIX_DOWNMIX_5_1,
+  MIX_RANDOM,
+};
+
+static const gfloat downmix_5_1[6][2] = {
+  {1.0, 0.0}, {0.0, 1.0}, {0.7071, 0.7071}, {0.0, 0.0}, {0.7071, 0.0},
+  {0.0, 0.7071}
+};
+
+#define MIX_SAMPLES 1000
+
+static gfloat **
+make_mix_matrix (gint in_channels, gint out_channels, gint kind, GRand * rand)
+{
+  gfloat **matrix = g_new (gfloat *, in_channels);
+  gint i, j;
+
+  for (i = 0; i < in_channels; i++) {
+    matrix[i] = g_new0 (gfloat, out_channels);
+    for (j = 0; j < out_channels; j++) {
+      switch (kind) {
+        case MIX_IDENTITY_SUBSET:
+          matrix[i][j] = (i == j) ? 1.0 : 0.0;
+          break;
+        case MIX_DOWNMIX_5_1:
+          matrix[i][j] = downmix_5_1[i][j];
+          break;
+        default:
+          /* about a third of the entries are zero */
+          if (g_rand_int_range (rand, 0, 3) != 0)
+            matrix[i][j] = g_rand_double_range (rand, -1.0, 1.0);
+          break;
+      }
+    }
+  }
+
+  return matrix;
+}
+
+/* Mixes with the channel mixer and compares the result bit by bit against
+ * a straightforward per-sample matrix multiplication */
+static void
+check_channel_mixer (GstAudioFormat format, gboolean planar,
+    gint in_channels, gint out_channels, gint kind, GRand * rand)
+{
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  gint bps = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8;
+  GstAudioChannelMixerFlags flags = 0;
+  GstAudioChannelMixer *mix;
+  gfloat **matrix, **mix_matrix;
+  guint8 *in, *out, *expected;
+  gpointer in_ptrs[64], out_ptrs[64];
+  gint i, j, n;
+
+  if (planar)
+    flags = GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN |
+        GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT;
+
+  /* the mixer takes ownership of its matrix */
+  matrix = make_mix_matrix (in_channels, out_channels, kind, rand);
+  mix_matrix = g_new (gfloat *, in_channels);
+  for (i = 0; i < in_channels; i++)
+    mix_matrix[i] = g_memdup2 (matrix[i], out_channels * sizeof (gfloat));
+  mix = gst_audio_channel_mixer_new_with_matrix (flags, format, in_channels,
+      out_channels, mix_matrix);
+  fail_unless (mix != NULL);
+
+  in = g_malloc (MIX_SAMPLES * in_channels * bps);
+  out = g_malloc0 (MIX_SAMPLES * out_channels * bps);
+  expected = g_malloc0 (MIX_SAMPLES * out_channels * bps);
+
+  for (n = 0; n < MIX_SAMPLES * in_channels; n++) {
+    switch (format) {
+      case GST_AUDIO_FORMAT_S16:
+        ((gint16 *) in)[n] = g_rand_int_range (rand, G_MININT16,
+            G_MAXINT16 + 1);
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        ((gint32 *) in)[n] = g_rand_int (rand);
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        ((gfloat *) in)[n] = g_rand_int_range (rand, 0, 10) == 0 ? -0.0 :
+            g_rand_double_range (rand, -1.0, 1.0);
+        break;
+      case GST_AUDIO_FORMAT_F64:
+        ((gdouble *) in)[n] = g_rand_int_range (rand, 0, 10) == 0 ? -0.0 :
+            g_rand_double_range (rand, -1.0, 1.0);
+        break;
+      default:
+        g_assert_not_reached ();
+    }
+  }
+
+  for (i = 0; i < in_channels; i++)
+    in_ptrs[i] = planar ? in + i * MIX_SAMPLES * bps : in;
+  for (j = 0; j < out_channels; j++)
+    out_ptrs[j] = planar ? out + j * MIX_SAMPLES * bps : out;
+
+  gst_audio_channel_mixer_samples (mix, in_ptrs, out_ptrs, MIX_SAMPLES);
+
+#define IN_IDX(n, c) (planar ? (c) * MIX_SAMPLES + (n) : \
+    (n) * in_channels + (c))
+#define OUT_IDX(n, c) (planar ? (c) * MIX_SAMPLES + (n) : \
+    (n) * out_channels + (c))
+  for (n = 0; n < MIX_SAMPLES; n++) {
+    for (j = 0; j < out_channels; j++) {
+      switch (format) {
+        case GST_AUDIO_FORMAT_S16:
+        case GST_AUDIO_FORMAT_S32:{
+          gint64 res = 0;
+
+          for (i = 0; i < in_channels; i++) {
+            /* same rounding as the integer matrix of the mixer */
+            gfloat coef = matrix[i][j] * (gfloat) (1 << 10);
+
+            if (format == GST_AUDIO_FORMAT_S16)
+              res += ((gint16 *) in)[IN_IDX (n, i)] * (gint64) (gint) coef;
+            else
+              res += ((gint32 *) in)[IN_IDX (n, i)] * (gint64) (gint) coef;
+          }
+          res = (res + (1 << 9)) >> 10;
+          if (format == GST_AUDIO_FORMAT_S16)
+            ((gint16 *) expected)[OUT_IDX (n, j)] =
+                CLAMP (res, G_MININT16, G_MAXINT16);
+          else
+            ((gint32 *) expected)[OUT_IDX (n, j)] =
+                CLAMP (res, G_MININT32, G_MAXINT32);
+          break;
+        }
+        case GST_AUDIO_FORMAT_F32:{
+          gfloat res = 0.0;
+
+          for (i = 0; i < in_channels; i++)
+            res += ((gfloat *) in)[IN_IDX (n, i)] * matrix[i][j];
+          ((gfloat *) expected)[OUT_IDX (n, j)] = res;
+          break;
+        }
+        case GST_AUDIO_FORMAT_F64:{
+          gdouble res = 0.0;
+
+          for (i = 0; i < in_channels; i++)
+            res += ((gdouble *) in)[IN_IDX (n, i)] * matrix[i][j];
+          ((gdouble *) expected)[OUT_IDX (n, j)] = res;
+          break;
+        }
+        default:
+          g_assert_not_reached ();
+      }
+    }
+  }
+#undef IN_IDX
+#undef OUT_IDX
+
+  fail_unless (memcmp (out, expected, MIX_SAMPLES * out_channels * bps) == 0,
+      "%s %s %d -> %d channels, matrix %d: output differs",
+      finfo->name, planar ? "planar" : "interleaved", in_channels,
+      out_channels, kind);
+
+  for (i = 0; i < in_channels; i++)
+    g_free (matrix[i]);
+  g_free (matrix);
+  g_free (in);
+  g_free (out);
+  g_free (expected);
+  gst_audio_channel_mixer_free (mix);
+}
+
+GST_START_TEST (test_channel_mixer_exact)
+{
+  static const GstAudioFormat formats[] = {
+    GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S32, GST_AUDIO_FORMAT_F32,
+    GST_AUDIO_FORMAT_F64
+  };
+  GRand *rand = g_rand_new_with_seed (0);
+  guint f;
+  gint planar;
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    for (planar = 0; planar <= 1; planar++) {
+      check_channel_mixer (formats[f], planar, 16, 2, MIX_IDENTITY_SUBSET,
+          rand);
+      check_channel_mixer (formats[f], planar, 6, 2, MIX_DOWNMIX_5_1, rand);
+      check_channel_mixer (formats[f], planar, 16, 16, MIX_RANDOM, rand);
+      check_channel_mixer (formats[f], planar, 5, 3, MIX_RANDOM, rand);
+    }
+  }
+
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
 static Suite *
 audio_suite (void)
 {
@@ -1616,6 +1812,7 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_audio_buffer_and_audio_meta);
   tcase_add_test (tc_chain, test_audio_info_from_caps);
   tcase_add_test (tc_chain, test_audio_make_raw_caps);
+  tcase_add_test (tc_chain, test_channel_mixer_exact);
 
   return s;
 }
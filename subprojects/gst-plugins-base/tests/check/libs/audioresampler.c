@@ -0,0 +1,382 @@
+/* GStreamer
+ *
+ * unit test for the audio resampler
+ *
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/audio/audio.h>
+
+#include <math.h>
+
+/* A second copy of the resampler without orc, so that only the plain C
+ * kernels are used, to compare the SIMD kernels the library picks against */
+#undef HAVE_CONFIG_H
+#undef HAVE_ORC
+#define gst_audio_resampler_options_set_quality \
+    ref_audio_resampler_options_set_quality
+#define gst_audio_resampler_new ref_audio_resampler_new
+#define gst_audio_resampler_reset ref_audio_resampler_reset
+#define gst_audio_resampler_update ref_audio_resampler_update
+#define gst_audio_resampler_free ref_audio_resampler_free
+#define gst_audio_resampler_get_out_frames ref_audio_resampler_get_out_frames
+#define gst_audio_resampler_get_in_frames ref_audio_resampler_get_in_frames
+#define gst_audio_resampler_get_max_latency \
+    ref_audio_resampler_get_max_latency
+#define gst_audio_resampler_resample ref_audio_resampler_resample
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-prototypes"
+#pragma GCC diagnostic ignored "-Wmissing-declarations"
+#endif
+#include "../../../gst-libs/gst/audio/audio-resampler.c"
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+#undef gst_audio_resampler_options_set_quality
+#undef gst_audio_resampler_new
+#undef gst_audio_resampler_reset
+#undef gst_audio_resampler_update
+#undef gst_audio_resampler_free
+#undef gst_audio_resampler_get_out_frames
+#undef gst_audio_resampler_get_in_frames
+#undef gst_audio_resampler_get_max_latency
+#undef gst_audio_resampler_resample
+
+#define IN_RATE 48000
+#define OUT_RATE 44100
+
+static GstAudioResampler *
+make_resampler (GstAudioFormat format, gint channels, guint quality,
+    GstAudioResamplerFilterMode mode,
+    GstAudioResamplerFilterInterpolation interpolation)
+{
+  GstAudioResampler *resampler;
+  GstStructure *options;
+
+  options = gst_structure_new_empty ("options");
+  gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      quality, IN_RATE, OUT_RATE, options);
+  gst_structure_set (options,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_MODE, GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE,
+      mode, GST_AUDIO_RESAMPLER_OPT_FILTER_INTERPOLATION,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_INTERPOLATION, interpolation, NULL);
+
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_FLAG_NONE, format, channels, IN_RATE, OUT_RATE,
+      options);
+  gst_structure_free (options);
+
+  fail_unless (resampler != NULL);
+
+  return resampler;
+}
+
+/* Interleaved sine wave of @freq Hz at half the maximum amplitude */
+static gpointer
+make_sine (GstAudioFormat format, gint channels, gsize frames, gdouble freq)
+{
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  gpointer data = g_malloc (frames * channels * finfo->width / 8);
+  gsize i;
+  gint c;
+
+  for (i = 0; i < frames; i++) {
+    gdouble v = 0.5 * sin (2.0 * G_PI * freq * i / IN_RATE);
+
+    for (c = 0; c < channels; c++) {
+      switch (format) {
+        case GST_AUDIO_FORMAT_S16:
+          ((gint16 *) data)[i * channels + c] = v * G_MAXINT16;
+          break;
+        case GST_AUDIO_FORMAT_S32:
+          ((gint32 *) data)[i * channels + c] = v * G_MAXINT32;
+          break;
+        case GST_AUDIO_FORMAT_F32:
+          ((gfloat *) data)[i * channels + c] = v;
+          break;
+        case GST_AUDIO_FORMAT_F64:
+          ((gdouble *) data)[i * channels + c] = v;
+          break;
+        default:
+          g_assert_not_reached ();
+      }
+    }
+  }
+
+  return data;
+}
+
+static gdouble
+get_sample (GstAudioFormat format, gpointer data, gsize idx)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_S16:
+      return ((gint16 *) data)[idx] / (gdouble) G_MAXINT16;
+    case GST_AUDIO_FORMAT_S32:
+      return ((gint32 *) data)[idx] / (gdouble) G_MAXINT32;
+    case GST_AUDIO_FORMAT_F32:
+      return ((gfloat *) data)[idx];
+    case GST_AUDIO_FORMAT_F64:
+      return ((gdouble *) data)[idx];
+    default:
+      g_assert_not_reached ();
+  }
+  return 0.0;
+}
+
+static const GstAudioFormat formats[] = {
+  GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S32, GST_AUDIO_FORMAT_F32,
+  GST_AUDIO_FORMAT_F64
+};
+
+static const struct
+{
+  GstAudioResamplerFilterMode mode;
+  GstAudioResamplerFilterInterpolation interpolation;
+} filter_modes[] = {
+  {GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE},
+  {GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR},
+  {GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC},
+};
+
+/* Whichever inner product and interpolation kernels the CPU selects, a
+ * resampled sine has to keep its amplitude and all channels must be the
+ * same */
+GST_START_TEST (test_resample_sine)
+{
+  guint f, m, q;
+  gint channels = 3;
+  gsize in_frames = IN_RATE / 4;
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    for (m = 0; m < G_N_ELEMENTS (filter_modes); m++) {
+      for (q = 0; q <= GST_AUDIO_RESAMPLER_QUALITY_MAX; q += 4) {
+        const GstAudioFormatInfo *finfo;
+        GstAudioResampler *resampler;
+        gpointer in, out;
+        gsize out_frames, latency, i;
+        gdouble sum = 0.0, rms;
+        gint c;
+
+        finfo = gst_audio_format_get_info (formats[f]);
+        resampler = make_resampler (formats[f], channels, q,
+            filter_modes[m].mode, filter_modes[m].interpolation);
+
+        in = make_sine (formats[f], channels, in_frames, 1000.0);
+        out_frames = gst_audio_resampler_get_out_frames (resampler, in_frames);
+        out = g_malloc (out_frames * channels * finfo->width / 8);
+
+        gst_audio_resampler_resample (resampler, &in, in_frames, &out,
+            out_frames);
+
+        latency = gst_audio_resampler_get_max_latency (resampler);
+        fail_unless (out_frames > 2 * latency);
+
+        for (i = 2 * latency; i < out_frames; i++) {
+          gdouble v = get_sample (formats[f], out, i * channels);
+
+          for (c = 1; c < channels; c++)
+            fail_unless_equals_float (get_sample (formats[f], out,
+                    i * channels + c), v);
+          sum += v * v;
+        }
+        rms = sqrt (sum / (out_frames - 2 * latency));
+
+        GST_DEBUG ("format %s, mode %u, quality %u: rms %f",
+            finfo->name, m, q, rms);
+        fail_unless (fabs (rms - 0.5 / G_SQRT2) < 0.01,
+            "format %s, mode %u, quality %u: rms %f", finfo->name, m, q, rms);
+
+        g_free (in);
+        g_free (out);
+        gst_audio_resampler_free (resampler);
+      }
+    }
+  }
+}
+
+GST_END_TEST;
+
+/* Random input, so that the whole filter contributes to every sample */
+static gpointer
+make_noise (GstAudioFormat format, gint channels, gsize frames, GRand * rand)
+{
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  gpointer data = g_malloc (frames * channels * finfo->width / 8);
+  gsize i;
+
+  for (i = 0; i < frames * channels; i++) {
+    gdouble v = g_rand_double_range (rand, -0.5, 0.5);
+
+    switch (format) {
+      case GST_AUDIO_FORMAT_S16:
+        ((gint16 *) data)[i] = v * G_MAXINT16;
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        ((gint32 *) data)[i] = v * G_MAXINT32;
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        ((gfloat *) data)[i] = v;
+        break;
+      case GST_AUDIO_FORMAT_F64:
+        ((gdouble *) data)[i] = v;
+        break;
+      default:
+        g_assert_not_reached ();
+    }
+  }
+
+  return data;
+}
+
+/* The kernels only add up the products in a different order and the float
+ * ones use FMA, so they agree with C up to rounding */
+static gdouble
+get_tolerance (GstAudioFormat format)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_S16:
+      return 1.0 / G_MAXINT16;
+    case GST_AUDIO_FORMAT_S32:
+      return 256.0 / G_MAXINT32;
+    case GST_AUDIO_FORMAT_F32:
+      return 1e-5;
+    case GST_AUDIO_FORMAT_F64:
+      return 1e-12;
+    default:
+      g_assert_not_reached ();
+  }
+  return 0.0;
+}
+
+static GstAudioResampler *
+make_ref_resampler (GstAudioFormat format, gint channels, guint quality,
+    GstAudioResamplerFilterMode mode,
+    GstAudioResamplerFilterInterpolation interpolation)
+{
+  GstAudioResampler *resampler;
+  GstStructure *options;
+
+  options = gst_structure_new_empty ("options");
+  ref_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      quality, IN_RATE, OUT_RATE, options);
+  gst_structure_set (options,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_MODE, GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE,
+      mode, GST_AUDIO_RESAMPLER_OPT_FILTER_INTERPOLATION,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_INTERPOLATION, interpolation, NULL);
+
+  resampler = ref_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_FLAG_NONE, format, channels, IN_RATE, OUT_RATE,
+      options);
+  gst_structure_free (options);
+
+  fail_unless (resampler != NULL);
+
+  return resampler;
+}
+
+/* Whatever SSE, AVX or NEON kernels the library selected for this CPU
+ * produce the same output as the plain C kernels */
+GST_START_TEST (test_simd_matches_c)
+{
+  /* odd block sizes, so that the history wraps at different positions */
+  static const gsize blocks[] = { 1000, 37, 480, 1, 2047 };
+  GRand *rand = g_rand_new_with_seed (0x5eed);
+  gint channels = 2;
+  guint f, m, q, b;
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    const GstAudioFormatInfo *finfo = gst_audio_format_get_info (formats[f]);
+    gdouble tolerance = get_tolerance (formats[f]);
+
+    for (m = 0; m < G_N_ELEMENTS (filter_modes); m++) {
+      for (q = 0; q <= GST_AUDIO_RESAMPLER_QUALITY_MAX; q += 2) {
+        GstAudioResampler *resampler, *ref;
+
+        resampler = make_resampler (formats[f], channels, q,
+            filter_modes[m].mode, filter_modes[m].interpolation);
+        ref = make_ref_resampler (formats[f], channels, q,
+            filter_modes[m].mode, filter_modes[m].interpolation);
+
+        for (b = 0; b < G_N_ELEMENTS (blocks); b++) {
+          gsize in_frames = blocks[b], out_frames, i;
+          gpointer in, out, ref_out;
+
+          out_frames =
+              gst_audio_resampler_get_out_frames (resampler, in_frames);
+          fail_unless_equals_int (out_frames,
+              ref_audio_resampler_get_out_frames (ref, in_frames));
+
+          in = make_noise (formats[f], channels, in_frames, rand);
+          out = g_malloc0 (out_frames * channels * finfo->width / 8 + 1);
+          ref_out = g_malloc0 (out_frames * channels * finfo->width / 8 + 1);
+
+          gst_audio_resampler_resample (resampler, &in, in_frames, &out,
+              out_frames);
+          ref_audio_resampler_resample (ref, &in, in_frames, &ref_out,
+              out_frames);
+
+          for (i = 0; i < out_frames * channels; i++) {
+            gdouble v = get_sample (formats[f], out, i);
+            gdouble r = get_sample (formats[f], ref_out, i);
+
+            fail_unless (fabs (v - r) <= tolerance,
+                "format %s, mode %u, quality %u, block %u, sample %"
+                G_GSIZE_FORMAT ": %.15f, C %.15f", finfo->name, m, q, b, i,
+                v, r);
+          }
+
+          g_free (in);
+          g_free (out);
+          g_free (ref_out);
+        }
+
+        gst_audio_resampler_free (resampler);
+        ref_audio_resampler_free (ref);
+      }
+    }
+  }
+
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+static Suite *
+audioresampler_suite (void)
+{
+  Suite *s = suite_create ("audio resampler");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_resample_sine);
+  tcase_add_test (tc_chain, test_simd_matches_c);
+
+  return s;
+}
+
+GST_CHECK_MAIN (audioresampler);
@@ -25,6 +25,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 #include <gst/audio/gstaudiosink.h>
 
 #define GST_TYPE_AUDIO_FOO_SINK           (gst_audio_foo_sink_get_type())
@@ -43,6 +44,8 @@ struct _GstAudioFooSink
   GstAudioSink parent;
 
   guint num_clear_all_call;
+  gint bpf;
+  gint rate;
 };
 
 struct _GstAudioFooSinkClass
@@ -61,6 +64,35 @@ gst_audio_foo_sink_clear_all (GstAudioSink * sink)
   self->num_clear_all_call++;
 }
 
+static gboolean
+gst_audio_foo_sink_prepare (GstAudioSink * sink, GstAudioRingBufferSpec * spec)
+{
+  GstAudioFooSink *self = GST_AUDIO_FOO_SINK (sink);
+
+  self->bpf = GST_AUDIO_INFO_BPF (&spec->info);
+  self->rate = GST_AUDIO_INFO_RATE (&spec->info);
+
+  return TRUE;
+}
+
+static gboolean
+gst_audio_foo_sink_unprepare (GstAudioSink * sink)
+{
+  return TRUE;
+}
+
+/* Blocks for as long as the samples take to play, like a device would */
+static gint
+gst_audio_foo_sink_write (GstAudioSink * sink, gpointer data, guint length)
+{
+  GstAudioFooSink *self = GST_AUDIO_FOO_SINK (sink);
+
+  g_usleep (gst_util_uint64_scale (length / self->bpf, G_USEC_PER_SEC,
+          self->rate));
+
+  return length;
+}
+
 static void
 gst_audio_foo_sink_init (GstAudioFooSink * src)
 {
@@ -77,6 +109,9 @@ gst_audio_foo_sink_class_init (GstAudioFooSinkClass * klass)
       "AudioFooSink", "Sink/Audio",
       "Audio Sink Unit Test element", "Foo Bar <foo@bar.com>");
 
+  audiosink_class->prepare = gst_audio_foo_sink_prepare;
+  audiosink_class->unprepare = gst_audio_foo_sink_unprepare;
+  audiosink_class->write = gst_audio_foo_sink_write;
   audiosink_class->extension->clear_all = gst_audio_foo_sink_clear_all;
 }
 
@@ -107,6 +142,75 @@ GST_START_TEST (test_class_extension)
 
 GST_END_TEST;
 
+GST_START_TEST (test_stats)
+{
+  GstHarness *h;
+  GstElement *foosink;
+  GstStructure *stats;
+  gboolean low_latency = FALSE;
+  guint64 segments = 0, segment_duration = 0, start_segments;
+  guint64 max_jitter, average_jitter;
+  gint64 start, elapsed;
+  gint tries;
+
+  foosink = g_object_new (GST_TYPE_AUDIO_FOO_SINK, "sync", FALSE,
+      "latency-time", (gint64) 1000, "low-latency", TRUE, NULL);
+  g_object_get (foosink, "low-latency", &low_latency, NULL);
+  fail_unless (low_latency);
+
+  g_object_get (foosink, "stats", &stats, NULL);
+  fail_unless (gst_structure_has_name (stats,
+          "application/x-audio-sink-stats"));
+  fail_unless (gst_structure_get_uint64 (stats, "segments", &segments));
+  fail_unless_equals_uint64 (segments, 0);
+  fail_unless (gst_structure_has_field (stats, "realtime"));
+  fail_unless (gst_structure_has_field (stats, "max-jitter"));
+  fail_unless (gst_structure_has_field (stats, "average-jitter"));
+  fail_unless (gst_structure_has_field (stats, "device-delay"));
+  gst_structure_free (stats);
+
+  h = gst_harness_new_with_element (foosink, "sink", NULL);
+  gst_harness_set_src_caps_str (h, "audio/x-raw, format=S16LE, "
+      "layout=interleaved, rate=48000, channels=1");
+
+  /* 100ms of silence in 1ms segments, whether or not the thread actually got
+   * real-time priority */
+  gst_harness_push (h, gst_harness_create_buffer (h, 9600));
+
+  for (tries = 0; tries < 100 && segments == 0; tries++) {
+    g_object_get (foosink, "stats", &stats, NULL);
+    fail_unless (gst_structure_get_uint64 (stats, "segments", &segments));
+    fail_unless (gst_structure_get_uint64 (stats, "segment-duration",
+            &segment_duration));
+    gst_structure_free (stats);
+    g_usleep (G_USEC_PER_SEC / 100);
+  }
+  fail_unless (segments > 0);
+  fail_unless_equals_uint64 (segment_duration, GST_MSECOND);
+
+  /* the thread is paced by the device, one segment per millisecond at
+   * most, and the jitter is measured against that */
+  start_segments = segments;
+  start = g_get_monotonic_time ();
+  g_usleep (200 * 1000);
+  g_object_get (foosink, "stats", &stats, NULL);
+  elapsed = g_get_monotonic_time () - start;
+  fail_unless (gst_structure_get_uint64 (stats, "segments", &segments));
+  fail_unless (gst_structure_get_uint64 (stats, "max-jitter", &max_jitter));
+  fail_unless (gst_structure_get_uint64 (stats, "average-jitter",
+          &average_jitter));
+  gst_structure_free (stats);
+  fail_unless (segments > start_segments);
+  fail_unless (segments - start_segments <= elapsed / 1000 + 2,
+      "%" G_GUINT64_FORMAT " segments in %" G_GINT64_FORMAT "us",
+      segments - start_segments, elapsed);
+  fail_unless (average_jitter <= max_jitter);
+
+  gst_harness_teardown (h);
+  gst_object_unref (foosink);
+}
+
+GST_END_TEST;
 
 static Suite *
 audiosink_suite (void)
@@ -116,6 +220,7 @@ audiosink_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_class_extension);
+  tcase_add_test (tc_chain, test_stats);
 
   return s;
 }
@@ -0,0 +1,198 @@
+/* GStreamer
+ *
+ * unit test for the audiosrc base class
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+#include <gst/audio/gstaudiosrc.h>
+
+#define GST_TYPE_AUDIO_FOO_SRC           (gst_audio_foo_src_get_type())
+#define GST_AUDIO_FOO_SRC(obj)           (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_AUDIO_FOO_SRC,GstAudioFooSrc))
+typedef struct _GstAudioFooSrc GstAudioFooSrc;
+typedef struct _GstAudioFooSrcClass GstAudioFooSrcClass;
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("audio/x-raw, format=S16LE, layout=interleaved, "
+        "rate=48000, channels=1"));
+
+struct _GstAudioFooSrc
+{
+  GstAudioSrc parent;
+
+  gint bpf;
+  gint rate;
+};
+
+struct _GstAudioFooSrcClass
+{
+  GstAudioSrcClass parent_class;
+};
+
+GType gst_audio_foo_src_get_type (void);
+G_DEFINE_TYPE (GstAudioFooSrc, gst_audio_foo_src, GST_TYPE_AUDIO_SRC);
+
+static gboolean
+gst_audio_foo_src_prepare (GstAudioSrc * src, GstAudioRingBufferSpec * spec)
+{
+  GstAudioFooSrc *self = GST_AUDIO_FOO_SRC (src);
+
+  self->bpf = GST_AUDIO_INFO_BPF (&spec->info);
+  self->rate = GST_AUDIO_INFO_RATE (&spec->info);
+
+  return TRUE;
+}
+
+static gboolean
+gst_audio_foo_src_unprepare (GstAudioSrc * src)
+{
+  return TRUE;
+}
+
+/* Blocks until the samples would have been captured, like a device would */
+static guint
+gst_audio_foo_src_read (GstAudioSrc * src, gpointer data, guint length,
+    GstClockTime * timestamp)
+{
+  GstAudioFooSrc *self = GST_AUDIO_FOO_SRC (src);
+
+  g_usleep (gst_util_uint64_scale (length / self->bpf, G_USEC_PER_SEC,
+          self->rate));
+  memset (data, 0, length);
+
+  return length;
+}
+
+static void
+gst_audio_foo_src_init (GstAudioFooSrc * src)
+{
+}
+
+static void
+gst_audio_foo_src_class_init (GstAudioFooSrcClass * klass)
+{
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstAudioSrcClass *audiosrc_class = GST_AUDIO_SRC_CLASS (klass);
+
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+  gst_element_class_set_metadata (element_class,
+      "AudioFooSrc", "Source/Audio",
+      "Audio Source Unit Test element", "Foo Bar <foo@bar.com>");
+
+  audiosrc_class->prepare = gst_audio_foo_src_prepare;
+  audiosrc_class->unprepare = gst_audio_foo_src_unprepare;
+  audiosrc_class->read = gst_audio_foo_src_read;
+}
+
+static GstStructure *
+get_stats (GstElement * src, guint64 * segments)
+{
+  GstStructure *stats;
+
+  g_object_get (src, "stats", &stats, NULL);
+  fail_unless (gst_structure_has_name (stats,
+          "application/x-audio-src-stats"));
+  fail_unless (gst_structure_get_uint64 (stats, "segments", segments));
+
+  return stats;
+}
+
+GST_START_TEST (test_stats)
+{
+  GstHarness *h;
+  GstElement *foosrc;
+  GstStructure *stats;
+  gboolean low_latency = FALSE, realtime;
+  guint64 segments = 0, segment_duration = 0, start_segments;
+  guint64 max_jitter, average_jitter, device_delay;
+  gint64 start, elapsed;
+  gint i;
+
+  foosrc = g_object_new (GST_TYPE_AUDIO_FOO_SRC, "latency-time", (gint64) 1000,
+      "low-latency", TRUE, NULL);
+  g_object_get (foosrc, "low-latency", &low_latency, NULL);
+  fail_unless (low_latency);
+
+  stats = get_stats (foosrc, &segments);
+  fail_unless_equals_uint64 (segments, 0);
+  fail_unless (gst_structure_get_boolean (stats, "realtime", &realtime));
+  fail_unless (gst_structure_has_field (stats, "max-jitter"));
+  fail_unless (gst_structure_has_field (stats, "average-jitter"));
+  fail_unless (gst_structure_has_field (stats, "device-delay"));
+  gst_structure_free (stats);
+
+  h = gst_harness_new_with_element (foosrc, NULL, "src");
+
+  /* whether or not the thread actually got real-time priority, the
+   * captured 1ms segments are pushed */
+  for (i = 0; i < 20; i++)
+    gst_buffer_unref (gst_harness_pull (h));
+
+  stats = get_stats (foosrc, &segments);
+  fail_unless (gst_structure_get_uint64 (stats, "segment-duration",
+          &segment_duration));
+  gst_structure_free (stats);
+  fail_unless (segments >= 20);
+  fail_unless_equals_uint64 (segment_duration, GST_MSECOND);
+
+  /* the thread is paced by the device, one segment per millisecond at
+   * most, and the jitter is measured against that */
+  start_segments = segments;
+  start = g_get_monotonic_time ();
+  g_usleep (200 * 1000);
+  stats = get_stats (foosrc, &segments);
+  elapsed = g_get_monotonic_time () - start;
+  fail_unless (gst_structure_get_uint64 (stats, "max-jitter", &max_jitter));
+  fail_unless (gst_structure_get_uint64 (stats, "average-jitter",
+          &average_jitter));
+  fail_unless (gst_structure_get_uint64 (stats, "device-delay",
+          &device_delay));
+  gst_structure_free (stats);
+  fail_unless (segments > start_segments);
+  fail_unless (segments - start_segments <= elapsed / 1000 + 2,
+      "%" G_GUINT64_FORMAT " segments in %" G_GINT64_FORMAT "us",
+      segments - start_segments, elapsed);
+  fail_unless (average_jitter <= max_jitter);
+  /* no delay() implementation, so nothing is pending in the device */
+  fail_unless_equals_uint64 (device_delay, 0);
+
+  gst_harness_teardown (h);
+  gst_object_unref (foosrc);
+}
+
+GST_END_TEST;
+
+static Suite *
+audiosrc_suite (void)
+{
+  Suite *s = suite_create ("audiosrc");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_stats);
+
+  return s;
+}
+
+GST_CHECK_MAIN (audiosrc)
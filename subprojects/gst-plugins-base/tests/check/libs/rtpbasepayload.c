@@ -50,6 +50,9 @@ typedef struct _GstRtpDummyPayClass GstRtpDummyPayClass;
 struct _GstRtpDummyPay
 {
   GstRTPBasePayload payload;
+
+  /* number of input buffers handed over as the only reference */
+  guint writable_count;
 };
 
 struct _GstRtpDummyPayClass
@@ -113,6 +116,9 @@ gst_rtp_dummy_pay_handle_buffer (GstRTPBasePayload * pay, GstBuffer * buffer)
 
   GST_LOG ("payloading %" GST_PTR_FORMAT, buffer);
 
+  if (gst_buffer_is_writable (buffer))
+    GST_RTP_DUMMY_PAY (pay)->writable_count++;
+
   if (!gst_pad_has_current_caps (GST_RTP_BASE_PAYLOAD_SRCPAD (pay))) {
     if (!gst_rtp_base_payload_set_outcaps (GST_RTP_BASE_PAYLOAD (pay),
             "custom-caps", G_TYPE_UINT, DEFAULT_CLOCK_RATE, NULL)) {
@@ -2310,6 +2316,80 @@ GST_START_TEST (rtp_base_payload_extensions_shrink_ext_data)
 }
 
 GST_END_TEST;
+
+static GstPadProbeReturn
+count_buffer_lists (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  guint *n_lists = user_data;
+
+  *n_lists += 1;
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* push a buffer list to a payloader with a header extension. the packets
+ * payloaded from the list are pushed downstream as one list and each of them
+ * carries the extension data. the input buffers are moved out of the list,
+ * so the subclass gets them writable like from the chain function */
+GST_START_TEST (rtp_base_payload_hdr_ext_buffer_list)
+{
+  GstRTPHeaderExtension *ext;
+  GstBufferList *list;
+  State *state;
+  guint n_lists = 0;
+  guint32 rtptime;
+  guint16 seq;
+  guint i;
+
+  state = create_payloader ("application/x-rtp", &sinktmpl, NULL);
+  ext = rtp_dummy_hdr_ext_new ();
+  GST_RTP_DUMMY_HDR_EXT (ext)->supported_flags =
+      GST_RTP_HEADER_EXTENSION_ONE_BYTE;
+  gst_rtp_header_extension_set_id (ext, 1);
+
+  g_signal_emit_by_name (state->element, "add-extension", ext);
+
+  gst_pad_add_probe (state->sinkpad, GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      count_buffer_lists, &n_lists, NULL);
+
+  set_state (state, GST_STATE_PLAYING);
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 4; i++) {
+    GstBuffer *buf = gst_rtp_buffer_new_allocate (0, 0, 0);
+
+    GST_BUFFER_PTS (buf) = i * GST_SECOND;
+    gst_buffer_list_add (list, buf);
+  }
+  fail_unless_equals_int (gst_pad_push_list (state->srcpad, list),
+      GST_FLOW_OK);
+
+  set_state (state, GST_STATE_NULL);
+
+  fail_unless_equals_int (n_lists, 1);
+  fail_unless_equals_int (GST_RTP_DUMMY_PAY (state->element)->writable_count,
+      4);
+  validate_buffers_received (4);
+
+  get_buffer_field (0, "rtptime", &rtptime, "seq", &seq, NULL);
+  for (i = 0; i < 4; i++) {
+    validate_buffer (i, "pts", i * GST_SECOND,
+        "rtptime", rtptime + i * DEFAULT_CLOCK_RATE, "seq", seq + i,
+        "ext-data", (guint) 0xBEDE, (gsize) 4, NULL);
+  }
+
+  validate_events_received (3);
+
+  validate_normal_start_events (0);
+
+  fail_unless_equals_int (GST_RTP_DUMMY_HDR_EXT (ext)->write_count, 4);
+  gst_object_unref (ext);
+
+  destroy_payloader (state);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtp_basepayloading_suite (void)
 {
@@ -2358,6 +2438,7 @@ rtp_basepayloading_suite (void)
   tcase_add_test (tc_chain, rtp_base_payload_caps_request_ignored);
   tcase_add_test (tc_chain, rtp_base_payload_extensions_in_output_caps);
   tcase_add_test (tc_chain, rtp_base_payload_extensions_shrink_ext_data);
+  tcase_add_test (tc_chain, rtp_base_payload_hdr_ext_buffer_list);
 
   return s;
 }
@@ -1084,6 +1084,116 @@ GST_START_TEST (test_convert_frame)
 
 GST_END_TEST;
 
+GST_START_TEST (test_convert_frame_cache)
+{
+  GstVideoConvertSampleCache *cache;
+  GstVideoInfo vinfo, out_info;
+  GstCaps *from_caps, *to_caps;
+  GstBuffer *from_buffer;
+  GstSample *from_sample, *to_sample;
+  GstStructure *stats;
+  GError *error = NULL;
+  guint64 hits, misses;
+  guint converters;
+  gint i;
+
+  gst_debug_set_threshold_for_name ("default", GST_LEVEL_NONE);
+
+  from_buffer = gst_buffer_new_and_alloc (640 * 480 * 4);
+  gst_buffer_memset (from_buffer, 0, 0x80, 640 * 480 * 4);
+  GST_BUFFER_PTS (from_buffer) = 5 * GST_SECOND;
+
+  gst_video_info_init (&vinfo);
+  fail_unless (gst_video_info_set_format (&vinfo, GST_VIDEO_FORMAT_xRGB, 640,
+          480));
+  vinfo.fps_n = 25;
+  vinfo.fps_d = 1;
+  from_caps = gst_video_info_to_caps (&vinfo);
+  from_sample = gst_sample_new (from_buffer, from_caps, NULL, NULL);
+
+  cache = gst_video_convert_sample_cache_new (0);
+
+  /* fully specified raw output, converted without a pipeline and with the
+   * converter reused the second time */
+  to_caps = gst_caps_from_string ("video/x-raw, format=(string)I420, "
+      "width=(int)160, height=(int)160, pixel-aspect-ratio=(fraction)1/1");
+  for (i = 0; i < 2; i++) {
+    to_sample = gst_video_convert_sample_cache_convert (cache, from_sample,
+        to_caps, GST_CLOCK_TIME_NONE, &error);
+    fail_unless (to_sample != NULL);
+    fail_unless (error == NULL);
+    fail_unless (gst_video_info_from_caps (&out_info,
+            gst_sample_get_caps (to_sample)));
+    fail_unless_equals_int (GST_VIDEO_INFO_FORMAT (&out_info),
+        GST_VIDEO_FORMAT_I420);
+    fail_unless_equals_int (GST_VIDEO_INFO_WIDTH (&out_info), 160);
+    fail_unless_equals_int (GST_VIDEO_INFO_HEIGHT (&out_info), 160);
+    fail_unless_equals_int (gst_buffer_get_size (gst_sample_get_buffer
+            (to_sample)), GST_VIDEO_INFO_SIZE (&out_info));
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (gst_sample_get_buffer
+            (to_sample)), 5 * GST_SECOND);
+    gst_sample_unref (to_sample);
+
+    stats = gst_video_convert_sample_cache_get_stats (cache);
+    fail_unless (gst_structure_get (stats, "hits", G_TYPE_UINT64, &hits,
+            "misses", G_TYPE_UINT64, &misses, "converters", G_TYPE_UINT,
+            &converters, NULL));
+    gst_structure_free (stats);
+    fail_unless_equals_uint64 (hits, i);
+    fail_unless_equals_uint64 (misses, 1);
+    fail_unless_equals_int (converters, 1);
+  }
+
+  /* the direct conversion honours the timeout too, the cached converter is
+   * still used and kept */
+  to_sample = gst_video_convert_sample_cache_convert (cache, from_sample,
+      to_caps, 0, &error);
+  fail_unless (to_sample == NULL);
+  fail_unless (error != NULL);
+  g_clear_error (&error);
+  gst_caps_unref (to_caps);
+
+  /* size taken from the input */
+  to_caps = gst_caps_from_string ("video/x-raw, format=(string)NV12");
+  to_sample = gst_video_convert_sample_cache_convert (cache, from_sample,
+      to_caps, GST_CLOCK_TIME_NONE, &error);
+  fail_unless (to_sample != NULL);
+  fail_unless (error == NULL);
+  fail_unless (gst_video_info_from_caps (&out_info,
+          gst_sample_get_caps (to_sample)));
+  fail_unless_equals_int (GST_VIDEO_INFO_FORMAT (&out_info),
+      GST_VIDEO_FORMAT_NV12);
+  fail_unless_equals_int (GST_VIDEO_INFO_WIDTH (&out_info), 640);
+  fail_unless_equals_int (GST_VIDEO_INFO_HEIGHT (&out_info), 480);
+  gst_sample_unref (to_sample);
+  gst_caps_unref (to_caps);
+
+  /* identical caps return the input buffer */
+  to_sample = gst_video_convert_sample_cache_convert (cache, from_sample,
+      from_caps, GST_CLOCK_TIME_NONE, &error);
+  fail_unless (to_sample != NULL);
+  fail_unless (gst_sample_get_buffer (to_sample) == from_buffer);
+  gst_sample_unref (to_sample);
+
+  /* one more converter, nothing is cached for identical caps */
+  stats = gst_video_convert_sample_cache_get_stats (cache);
+  fail_unless (gst_structure_get (stats, "hits", G_TYPE_UINT64, &hits,
+          "misses", G_TYPE_UINT64, &misses, "converters", G_TYPE_UINT,
+          &converters, NULL));
+  gst_structure_free (stats);
+  fail_unless_equals_uint64 (hits, 2);
+  fail_unless_equals_uint64 (misses, 2);
+  fail_unless_equals_int (converters, 2);
+
+  gst_video_convert_sample_cache_free (cache);
+
+  gst_buffer_unref (from_buffer);
+  gst_caps_unref (from_caps);
+  gst_sample_unref (from_sample);
+}
+
+GST_END_TEST;
+
 typedef struct
 {
   GMainLoop *loop;
@@ -2872,6 +2982,116 @@ GST_START_TEST (test_video_convert_multithreading)
 
 GST_END_TEST;
 
+static void
+count_items (guint start, guint end, gpointer user_data)
+{
+  gint *counts = user_data;
+  guint i;
+
+  fail_unless (start < end);
+  for (i = start; i < end; i++)
+    g_atomic_int_inc (&counts[i]);
+}
+
+static void
+count_task (gpointer user_data)
+{
+  g_atomic_int_inc ((gint *) user_data);
+}
+
+static void
+check_parallel_for (GstParallelizedTaskRunner * runner, guint n_items,
+    guint grain_size)
+{
+  gint *counts = g_new0 (gint, n_items);
+  guint i;
+
+  gst_parallelized_task_runner_parallel_for (runner, n_items, grain_size,
+      count_items, counts);
+  if (gst_parallelized_task_runner_is_async (runner))
+    gst_parallelized_task_runner_finish (runner);
+
+  for (i = 0; i < n_items; i++)
+    fail_unless_equals_int (counts[i], 1);
+
+  g_free (counts);
+}
+
+GST_START_TEST (test_parallelized_task_runner)
+{
+  GstParallelizedTaskRunner *runner;
+  GstTaskPool *pool;
+  gint counts[4] = { 0, };
+  gpointer task_data[4];
+  gint *jobs[16];
+  guint i;
+
+  /* Default pool */
+  runner = gst_parallelized_task_runner_new (4, NULL, FALSE);
+  fail_unless (gst_parallelized_task_runner_get_n_threads (runner) >= 1);
+  fail_unless (gst_parallelized_task_runner_get_n_threads (runner) <= 4);
+  check_parallel_for (runner, 1, 0);
+  check_parallel_for (runner, 1000, 0);
+  check_parallel_for (runner, 1000, 1);
+  check_parallel_for (runner, 1000, 7);
+  check_parallel_for (runner, 1000, 5000);
+
+  for (i = 0; i < gst_parallelized_task_runner_get_n_threads (runner); i++)
+    task_data[i] = &counts[i];
+  gst_parallelized_task_runner_run (runner, count_task, task_data);
+  for (i = 0; i < gst_parallelized_task_runner_get_n_threads (runner); i++)
+    fail_unless_equals_int (counts[i], 1);
+  gst_parallelized_task_runner_free (runner);
+
+  /* Async tasks are done by finish() at the latest */
+  runner = gst_parallelized_task_runner_new (4, NULL, TRUE);
+  check_parallel_for (runner, 1000, 3);
+  gst_parallelized_task_runner_free (runner);
+
+  /* Without a pool, runners use the process-wide pool, which is limited to
+   * the CPUs */
+  pool = gst_parallelized_task_runner_get_default_pool ();
+  runner = gst_parallelized_task_runner_new (0, NULL, FALSE);
+  fail_unless_equals_int (gst_parallelized_task_runner_get_n_threads (runner),
+      gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool)));
+  check_parallel_for (runner, 1000, 7);
+  gst_parallelized_task_runner_free (runner);
+  gst_object_unref (pool);
+
+  /* A pool with a single thread that is saturated still completes all work
+   * because the calling thread takes part */
+  pool = gst_shared_task_pool_new ();
+  gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (pool), 1);
+  gst_task_pool_prepare (pool, NULL);
+  runner = gst_parallelized_task_runner_new (4, pool, FALSE);
+  fail_unless_equals_int (gst_parallelized_task_runner_get_n_threads (runner),
+      1);
+  check_parallel_for (runner, 1000, 10);
+  gst_parallelized_task_runner_free (runner);
+
+  /* Several pending async jobs */
+  runner = gst_parallelized_task_runner_new (1, pool, TRUE);
+  for (i = 0; i < G_N_ELEMENTS (jobs); i++) {
+    jobs[i] = g_new0 (gint, 100);
+    gst_parallelized_task_runner_parallel_for (runner, 100, 1, count_items,
+        jobs[i]);
+  }
+  gst_parallelized_task_runner_finish (runner);
+  for (i = 0; i < G_N_ELEMENTS (jobs); i++) {
+    guint j;
+
+    for (j = 0; j < 100; j++)
+      fail_unless_equals_int (jobs[i][j], 1);
+    g_free (jobs[i]);
+  }
+  gst_parallelized_task_runner_free (runner);
+
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_transfer)
 {
   gint i, j;
@@ -4065,6 +4285,7 @@ video_suite (void)
   tcase_add_test (tc_chain, test_parse_colorimetry);
   tcase_add_test (tc_chain, test_events);
   tcase_add_test (tc_chain, test_convert_frame);
+  tcase_add_test (tc_chain, test_convert_frame_cache);
   tcase_add_test (tc_chain, test_convert_frame_async);
   tcase_add_test (tc_chain, test_convert_frame_async_error);
   tcase_add_test (tc_chain, test_video_size_from_caps);
@@ -4084,6 +4305,7 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_size_convert);
   tcase_add_test (tc_chain, test_video_convert);
   tcase_add_test (tc_chain, test_video_convert_multithreading);
+  tcase_add_test (tc_chain, test_parallelized_task_runner);
   tcase_add_test (tc_chain, test_video_transfer);
   tcase_add_test (tc_chain, test_overlay_blend);
   tcase_add_test (tc_chain, test_video_center_rect);
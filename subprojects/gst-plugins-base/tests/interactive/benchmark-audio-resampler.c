@@ -0,0 +1,192 @@
+/* GStreamer audio resampler benchmark
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+#include <math.h>
+
+#define IN_RATE 48000
+#define OUT_RATE 44100
+#define BLOCK_FRAMES 1024
+
+#define DEFAULT_DURATION 0.5
+
+static const GstAudioFormat formats[] = {
+  GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S32, GST_AUDIO_FORMAT_F32,
+  GST_AUDIO_FORMAT_F64
+};
+
+static const struct
+{
+  GstAudioResamplerFilterMode mode;
+  GstAudioResamplerFilterInterpolation interpolation;
+  const gchar *name;
+} filter_modes[] = {
+  {GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE, "full"},
+  {GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR, "linear"},
+  {GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+      GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC, "cubic"},
+};
+
+static GstAudioResampler *
+make_resampler (GstAudioFormat format, gint channels, guint quality,
+    GstAudioResamplerFilterMode mode,
+    GstAudioResamplerFilterInterpolation interpolation)
+{
+  GstAudioResampler *resampler;
+  GstStructure *options;
+
+  options = gst_structure_new_empty ("options");
+  gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      quality, IN_RATE, OUT_RATE, options);
+  gst_structure_set (options,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_MODE, GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE,
+      mode, GST_AUDIO_RESAMPLER_OPT_FILTER_INTERPOLATION,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_INTERPOLATION, interpolation, NULL);
+
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_FLAG_NONE, format, channels, IN_RATE, OUT_RATE,
+      options);
+  gst_structure_free (options);
+
+  return resampler;
+}
+
+/* Interleaved 1kHz sine wave at half the maximum amplitude */
+static gpointer
+make_sine (GstAudioFormat format, gint channels, gsize frames)
+{
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  gpointer data = g_malloc (frames * channels * finfo->width / 8);
+  gsize i;
+  gint c;
+
+  for (i = 0; i < frames; i++) {
+    gdouble v = 0.5 * sin (2.0 * G_PI * 1000.0 * i / IN_RATE);
+
+    for (c = 0; c < channels; c++) {
+      switch (format) {
+        case GST_AUDIO_FORMAT_S16:
+          ((gint16 *) data)[i * channels + c] = v * G_MAXINT16;
+          break;
+        case GST_AUDIO_FORMAT_S32:
+          ((gint32 *) data)[i * channels + c] = v * G_MAXINT32;
+          break;
+        case GST_AUDIO_FORMAT_F32:
+          ((gfloat *) data)[i * channels + c] = v;
+          break;
+        case GST_AUDIO_FORMAT_F64:
+          ((gdouble *) data)[i * channels + c] = v;
+          break;
+        default:
+          g_assert_not_reached ();
+      }
+    }
+  }
+
+  return data;
+}
+
+static void
+do_benchmark (GstAudioFormat format, gint channels, guint mode,
+    gdouble max_duration)
+{
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  GTimer *timer;
+  gpointer in, out;
+  guint q;
+
+  timer = g_timer_new ();
+  in = make_sine (format, channels, BLOCK_FRAMES);
+  out = g_malloc ((BLOCK_FRAMES + 16) * channels * finfo->width / 8);
+
+  for (q = 0; q <= GST_AUDIO_RESAMPLER_QUALITY_MAX; q++) {
+    GstAudioResampler *resampler;
+    gdouble elapsed;
+    gsize total = 0;
+
+    resampler = make_resampler (format, channels, q, filter_modes[mode].mode,
+        filter_modes[mode].interpolation);
+
+    g_timer_start (timer);
+    while (TRUE) {
+      gsize out_frames =
+          gst_audio_resampler_get_out_frames (resampler, BLOCK_FRAMES);
+
+      gst_audio_resampler_resample (resampler, &in, BLOCK_FRAMES, &out,
+          out_frames);
+      total += BLOCK_FRAMES;
+
+      elapsed = g_timer_elapsed (timer, NULL);
+      if (elapsed >= max_duration)
+        break;
+    }
+
+    gst_println ("%8.1f Msamples/s %s, %d channels, %s, quality %2u",
+        total * channels / elapsed / 1e6, finfo->name, channels,
+        filter_modes[mode].name, q);
+
+    gst_audio_resampler_free (resampler);
+  }
+
+  g_free (in);
+  g_free (out);
+  g_timer_destroy (timer);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gint channels = 2;
+  gdouble max_dur = DEFAULT_DURATION;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"channels", 'c', 0, G_OPTION_ARG_INT, &channels, "Channels", NULL},
+    {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &max_dur,
+        "Benchmark duration for each run (in seconds)", NULL},
+    {NULL}
+  };
+  guint f, m;
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    for (m = 0; m < G_N_ELEMENTS (filter_modes); m++)
+      do_benchmark (formats[f], channels, m, max_dur);
+  }
+
+  return 0;
+}
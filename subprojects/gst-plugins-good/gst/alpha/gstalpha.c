@@ -109,6 +109,7 @@ enum
 #define DEFAULT_BLACK_SENSITIVITY 100
 #define DEFAULT_WHITE_SENSITIVITY 100
 #define DEFAULT_PREFER_PASSTHROUGH FALSE
+#define DEFAULT_N_THREADS 1
 
 enum
 {
@@ -122,7 +123,8 @@ enum
   PROP_NOISE_LEVEL,
   PROP_BLACK_SENSITIVITY,
   PROP_WHITE_SENSITIVITY,
-  PROP_PREFER_PASSTHROUGH
+  PROP_PREFER_PASSTHROUGH,
+  PROP_N_THREADS
 };
 
 static GstStaticPadTemplate gst_alpha_src_template =
@@ -166,8 +168,9 @@ static void gst_alpha_before_transform (GstBaseTransform * btrans,
 static gboolean gst_alpha_set_info (GstVideoFilter * filter,
     GstCaps * incaps, GstVideoInfo * in_info, GstCaps * outcaps,
     GstVideoInfo * out_info);
-static GstFlowReturn gst_alpha_transform_frame (GstVideoFilter * filter,
-    GstVideoFrame * in_frame, GstVideoFrame * out_frame);
+static GstFlowReturn gst_alpha_transform_frame_slice (GstVideoFilter * filter,
+    GstVideoFrame * in_frame, GstVideoFrame * out_frame, guint start_line,
+    guint end_line);
 
 static void gst_alpha_init_params_full (GstAlpha * alpha,
     const GstVideoFormatInfo * in_info, const GstVideoFormatInfo * out_info);
@@ -268,6 +271,20 @@ gst_alpha_class_init (GstAlphaClass * klass)
           DEFAULT_PREFER_PASSTHROUGH,
           G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAlpha:n-threads:
+   *
+   * Maximum number of threads used to process each frame in slices. 0 uses
+   * the number of CPUs.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use (0 = number of CPUs)", 0,
+          G_MAXUINT, DEFAULT_N_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class, "Alpha filter",
       "Filter/Effect/Video",
       "Adds an alpha channel to video - uniform or via chroma-keying",
@@ -285,8 +302,8 @@ gst_alpha_class_init (GstAlphaClass * klass)
   btrans_class->transform_caps = GST_DEBUG_FUNCPTR (gst_alpha_transform_caps);
 
   vfilter_class->set_info = GST_DEBUG_FUNCPTR (gst_alpha_set_info);
-  vfilter_class->transform_frame =
-      GST_DEBUG_FUNCPTR (gst_alpha_transform_frame);
+  vfilter_class->transform_frame_slice =
+      GST_DEBUG_FUNCPTR (gst_alpha_transform_frame_slice);
 
   gst_type_mark_as_plugin_api (GST_TYPE_ALPHA_METHOD, 0);
 }
@@ -324,6 +341,13 @@ gst_alpha_set_property (GObject * object, guint prop_id,
   GstAlpha *alpha = GST_ALPHA (object);
   gboolean reconfigure = FALSE;
 
+  /* the thread count is stored in the base class */
+  if (prop_id == PROP_N_THREADS) {
+    gst_video_filter_set_n_threads (GST_VIDEO_FILTER (alpha),
+        g_value_get_uint (value));
+    return;
+  }
+
   GST_ALPHA_LOCK (alpha);
   switch (prop_id) {
     case PROP_METHOD:{
@@ -428,6 +452,10 @@ gst_alpha_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_PREFER_PASSTHROUGH:
       g_value_set_boolean (value, alpha->prefer_passthrough);
       break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value,
+          gst_video_filter_get_n_threads (GST_VIDEO_FILTER (alpha)));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -624,9 +652,9 @@ chroma_keying_yuv (gint a, gint * y, gint * u,
 
 static void
 gst_alpha_set_argb_ayuv (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
-  gint s_alpha = CLAMP ((gint) (alpha->alpha * 256), 0, 256);
+  gint s_alpha = CLAMP ((gint) (params->alpha * 256), 0, 256);
   const guint8 *src;
   guint8 *dest;
   gint width, height;
@@ -647,7 +675,7 @@ gst_alpha_set_argb_ayuv (const GstVideoFrame * in_frame,
   o[3] = GST_VIDEO_FRAME_COMP_POFFSET (in_frame, 2);
 
   memcpy (matrix,
-      alpha->out_sdtv ? cog_rgb_to_ycbcr_matrix_8bit_sdtv :
+      params->out_sdtv ? cog_rgb_to_ycbcr_matrix_8bit_sdtv :
       cog_rgb_to_ycbcr_matrix_8bit_hdtv, 12 * sizeof (gint));
 
   for (i = 0; i < height; i++) {
@@ -670,7 +698,7 @@ gst_alpha_set_argb_ayuv (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_chroma_key_argb_ayuv (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
@@ -679,14 +707,14 @@ gst_alpha_chroma_key_argb_ayuv (const GstVideoFrame * in_frame,
   gint a, y, u, v;
   gint r, g, b;
   gint smin, smax;
-  gint pa = CLAMP ((gint) (alpha->alpha * 256), 0, 256);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
+  gint pa = CLAMP ((gint) (params->alpha * 256), 0, 256);
+  gint8 cb = params->cb, cr = params->cr;
+  gint8 kg = params->kg;
+  guint8 accept_angle_tg = params->accept_angle_tg;
+  guint8 accept_angle_ctg = params->accept_angle_ctg;
+  guint8 one_over_kc = params->one_over_kc;
+  guint8 kfgy_scale = params->kfgy_scale;
+  guint noise_level2 = params->noise_level2;
   gint matrix[12];
   gint o[4];
 
@@ -701,11 +729,11 @@ gst_alpha_chroma_key_argb_ayuv (const GstVideoFrame * in_frame,
   o[2] = GST_VIDEO_FRAME_COMP_POFFSET (in_frame, 1);
   o[3] = GST_VIDEO_FRAME_COMP_POFFSET (in_frame, 2);
 
-  smin = 128 - alpha->black_sensitivity;
-  smax = 128 + alpha->white_sensitivity;
+  smin = 128 - params->black_sensitivity;
+  smax = 128 + params->white_sensitivity;
 
   memcpy (matrix,
-      alpha->out_sdtv ? cog_rgb_to_ycbcr_matrix_8bit_sdtv :
+      params->out_sdtv ? cog_rgb_to_ycbcr_matrix_8bit_sdtv :
       cog_rgb_to_ycbcr_matrix_8bit_hdtv, 12 * sizeof (gint));
 
   for (i = 0; i < height; i++) {
@@ -739,12 +767,12 @@ gst_alpha_chroma_key_argb_ayuv (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_set_argb_argb (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
   gint width, height;
-  gint s_alpha = CLAMP ((gint) (alpha->alpha * 256), 0, 256);
+  gint s_alpha = CLAMP ((gint) (params->alpha * 256), 0, 256);
   gint i, j;
   gint p[4], o[4];
 
@@ -780,7 +808,7 @@ gst_alpha_set_argb_argb (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_chroma_key_argb_argb (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
@@ -789,14 +817,14 @@ gst_alpha_chroma_key_argb_argb (const GstVideoFrame * in_frame,
   gint a, y, u, v;
   gint r, g, b;
   gint smin, smax;
-  gint pa = CLAMP ((gint) (alpha->alpha * 256), 0, 256);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
+  gint pa = CLAMP ((gint) (params->alpha * 256), 0, 256);
+  gint8 cb = params->cb, cr = params->cr;
+  gint8 kg = params->kg;
+  guint8 accept_angle_tg = params->accept_angle_tg;
+  guint8 accept_angle_ctg = params->accept_angle_ctg;
+  guint8 one_over_kc = params->one_over_kc;
+  guint8 kfgy_scale = params->kfgy_scale;
+  guint noise_level2 = params->noise_level2;
   gint matrix[12], matrix2[12];
   gint p[4], o[4];
 
@@ -816,8 +844,8 @@ gst_alpha_chroma_key_argb_argb (const GstVideoFrame * in_frame,
   o[2] = GST_VIDEO_FRAME_COMP_POFFSET (in_frame, 1);
   o[3] = GST_VIDEO_FRAME_COMP_POFFSET (in_frame, 2);
 
-  smin = 128 - alpha->black_sensitivity;
-  smax = 128 + alpha->white_sensitivity;
+  smin = 128 - params->black_sensitivity;
+  smax = 128 + params->white_sensitivity;
 
   memcpy (matrix, cog_rgb_to_ycbcr_matrix_8bit_sdtv, 12 * sizeof (gint));
   memcpy (matrix2, cog_ycbcr_to_rgb_matrix_8bit_sdtv, 12 * sizeof (gint));
@@ -857,12 +885,12 @@ gst_alpha_chroma_key_argb_argb (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_set_ayuv_argb (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
   gint width, height;
-  gint s_alpha = CLAMP ((gint) (alpha->alpha * 256), 0, 256);
+  gint s_alpha = CLAMP ((gint) (params->alpha * 256), 0, 256);
   gint y, x;
   gint matrix[12];
   gint r, g, b;
@@ -880,7 +908,7 @@ gst_alpha_set_ayuv_argb (const GstVideoFrame * in_frame,
   p[3] = GST_VIDEO_FRAME_COMP_POFFSET (out_frame, 2);
 
   memcpy (matrix,
-      alpha->in_sdtv ? cog_ycbcr_to_rgb_matrix_8bit_sdtv :
+      params->in_sdtv ? cog_ycbcr_to_rgb_matrix_8bit_sdtv :
       cog_ycbcr_to_rgb_matrix_8bit_hdtv, 12 * sizeof (gint));
 
   for (y = 0; y < height; y++) {
@@ -903,7 +931,7 @@ gst_alpha_set_ayuv_argb (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_chroma_key_ayuv_argb (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
@@ -912,14 +940,14 @@ gst_alpha_chroma_key_ayuv_argb (const GstVideoFrame * in_frame,
   gint a, y, u, v;
   gint r, g, b;
   gint smin, smax;
-  gint pa = CLAMP ((gint) (alpha->alpha * 256), 0, 256);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
+  gint pa = CLAMP ((gint) (params->alpha * 256), 0, 256);
+  gint8 cb = params->cb, cr = params->cr;
+  gint8 kg = params->kg;
+  guint8 accept_angle_tg = params->accept_angle_tg;
+  guint8 accept_angle_ctg = params->accept_angle_ctg;
+  guint8 one_over_kc = params->one_over_kc;
+  guint8 kfgy_scale = params->kfgy_scale;
+  guint noise_level2 = params->noise_level2;
   gint matrix[12];
   gint p[4];
 
@@ -934,11 +962,11 @@ gst_alpha_chroma_key_ayuv_argb (const GstVideoFrame * in_frame,
   p[2] = GST_VIDEO_FRAME_COMP_POFFSET (out_frame, 1);
   p[3] = GST_VIDEO_FRAME_COMP_POFFSET (out_frame, 2);
 
-  smin = 128 - alpha->black_sensitivity;
-  smax = 128 + alpha->white_sensitivity;
+  smin = 128 - params->black_sensitivity;
+  smax = 128 + params->white_sensitivity;
 
   memcpy (matrix,
-      alpha->in_sdtv ? cog_ycbcr_to_rgb_matrix_8bit_sdtv :
+      params->in_sdtv ? cog_ycbcr_to_rgb_matrix_8bit_sdtv :
       cog_ycbcr_to_rgb_matrix_8bit_hdtv, 12 * sizeof (gint));
 
   for (i = 0; i < height; i++) {
@@ -972,12 +1000,12 @@ gst_alpha_chroma_key_ayuv_argb (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_set_ayuv_ayuv (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
   gint width, height;
-  gint s_alpha = CLAMP ((gint) (alpha->alpha * 256), 0, 256);
+  gint s_alpha = CLAMP ((gint) (params->alpha * 256), 0, 256);
   gint y, x;
 
   src = GST_VIDEO_FRAME_PLANE_DATA (in_frame, 0);
@@ -986,7 +1014,7 @@ gst_alpha_set_ayuv_ayuv (const GstVideoFrame * in_frame,
   width = GST_VIDEO_FRAME_WIDTH (in_frame);
   height = GST_VIDEO_FRAME_HEIGHT (in_frame);
 
-  if (alpha->in_sdtv == alpha->out_sdtv) {
+  if (params->in_sdtv == params->out_sdtv) {
     for (y = 0; y < height; y++) {
       for (x = 0; x < width; x++) {
         dest[0] = (src[0] * s_alpha) >> 8;
@@ -1002,7 +1030,7 @@ gst_alpha_set_ayuv_ayuv (const GstVideoFrame * in_frame,
     gint matrix[12];
 
     memcpy (matrix,
-        alpha->out_sdtv ? cog_ycbcr_hdtv_to_ycbcr_sdtv_matrix_8bit :
+        params->out_sdtv ? cog_ycbcr_hdtv_to_ycbcr_sdtv_matrix_8bit :
         cog_ycbcr_sdtv_to_ycbcr_hdtv_matrix_8bit, 12 * sizeof (gint));
 
     for (y = 0; y < height; y++) {
@@ -1021,7 +1049,7 @@ gst_alpha_set_ayuv_ayuv (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_chroma_key_ayuv_ayuv (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
@@ -1029,14 +1057,14 @@ gst_alpha_chroma_key_ayuv_ayuv (const GstVideoFrame * in_frame,
   gint i, j;
   gint a, y, u, v;
   gint smin, smax;
-  gint pa = CLAMP ((gint) (alpha->alpha * 256), 0, 256);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
+  gint pa = CLAMP ((gint) (params->alpha * 256), 0, 256);
+  gint8 cb = params->cb, cr = params->cr;
+  gint8 kg = params->kg;
+  guint8 accept_angle_tg = params->accept_angle_tg;
+  guint8 accept_angle_ctg = params->accept_angle_ctg;
+  guint8 one_over_kc = params->one_over_kc;
+  guint8 kfgy_scale = params->kfgy_scale;
+  guint noise_level2 = params->noise_level2;
 
   src = GST_VIDEO_FRAME_PLANE_DATA (in_frame, 0);
   dest = GST_VIDEO_FRAME_PLANE_DATA (out_frame, 0);
@@ -1044,10 +1072,10 @@ gst_alpha_chroma_key_ayuv_ayuv (const GstVideoFrame * in_frame,
   width = GST_VIDEO_FRAME_WIDTH (in_frame);
   height = GST_VIDEO_FRAME_HEIGHT (in_frame);
 
-  smin = 128 - alpha->black_sensitivity;
-  smax = 128 + alpha->white_sensitivity;
+  smin = 128 - params->black_sensitivity;
+  smax = 128 + params->white_sensitivity;
 
-  if (alpha->in_sdtv == alpha->out_sdtv) {
+  if (params->in_sdtv == params->out_sdtv) {
     for (i = 0; i < height; i++) {
       for (j = 0; j < width; j++) {
         a = (src[0] * pa) >> 8;
@@ -1075,7 +1103,7 @@ gst_alpha_chroma_key_ayuv_ayuv (const GstVideoFrame * in_frame,
     gint matrix[12];
 
     memcpy (matrix,
-        alpha->out_sdtv ? cog_ycbcr_hdtv_to_ycbcr_sdtv_matrix_8bit :
+        params->out_sdtv ? cog_ycbcr_hdtv_to_ycbcr_sdtv_matrix_8bit :
         cog_ycbcr_sdtv_to_ycbcr_hdtv_matrix_8bit, 12 * sizeof (gint));
 
     for (i = 0; i < height; i++) {
@@ -1106,12 +1134,12 @@ gst_alpha_chroma_key_ayuv_ayuv (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_set_rgb_ayuv (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
   gint width, height;
-  gint s_alpha = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
+  gint s_alpha = CLAMP ((gint) (params->alpha * 255), 0, 255);
   gint i, j;
   gint matrix[12];
   gint y, u, v;
@@ -1130,7 +1158,7 @@ gst_alpha_set_rgb_ayuv (const GstVideoFrame * in_frame,
   o[2] = GST_VIDEO_FRAME_COMP_POFFSET (in_frame, 2);
 
   memcpy (matrix,
-      alpha->out_sdtv ? cog_rgb_to_ycbcr_matrix_8bit_sdtv :
+      params->out_sdtv ? cog_rgb_to_ycbcr_matrix_8bit_sdtv :
       cog_rgb_to_ycbcr_matrix_8bit_hdtv, 12 * sizeof (gint));
 
   for (i = 0; i < height; i++) {
@@ -1153,7 +1181,7 @@ gst_alpha_set_rgb_ayuv (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_chroma_key_rgb_ayuv (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
@@ -1162,14 +1190,14 @@ gst_alpha_chroma_key_rgb_ayuv (const GstVideoFrame * in_frame,
   gint a, y, u, v;
   gint r, g, b;
   gint smin, smax;
-  gint pa = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
+  gint pa = CLAMP ((gint) (params->alpha * 255), 0, 255);
+  gint8 cb = params->cb, cr = params->cr;
+  gint8 kg = params->kg;
+  guint8 accept_angle_tg = params->accept_angle_tg;
+  guint8 accept_angle_ctg = params->accept_angle_ctg;
+  guint8 one_over_kc = params->one_over_kc;
+  guint8 kfgy_scale = params->kfgy_scale;
+  guint noise_level2 = params->noise_level2;
   gint matrix[12];
   gint o[3];
   gint bpp;
@@ -1186,11 +1214,11 @@ gst_alpha_chroma_key_rgb_ayuv (const GstVideoFrame * in_frame,
   o[1] = GST_VIDEO_FRAME_COMP_POFFSET (in_frame, 1);
   o[2] = GST_VIDEO_FRAME_COMP_POFFSET (in_frame, 2);
 
-  smin = 128 - alpha->black_sensitivity;
-  smax = 128 + alpha->white_sensitivity;
+  smin = 128 - params->black_sensitivity;
+  smax = 128 + params->white_sensitivity;
 
   memcpy (matrix,
-      alpha->out_sdtv ? cog_rgb_to_ycbcr_matrix_8bit_sdtv :
+      params->out_sdtv ? cog_rgb_to_ycbcr_matrix_8bit_sdtv :
       cog_rgb_to_ycbcr_matrix_8bit_hdtv, 12 * sizeof (gint));
 
   for (i = 0; i < height; i++) {
@@ -1224,12 +1252,12 @@ gst_alpha_chroma_key_rgb_ayuv (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_set_rgb_argb (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
   gint width, height;
-  gint s_alpha = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
+  gint s_alpha = CLAMP ((gint) (params->alpha * 255), 0, 255);
   gint i, j;
   gint p[4], o[3];
   gint bpp;
@@ -1267,7 +1295,7 @@ gst_alpha_set_rgb_argb (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_chroma_key_rgb_argb (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
@@ -1276,14 +1304,14 @@ gst_alpha_chroma_key_rgb_argb (const GstVideoFrame * in_frame,
   gint a, y, u, v;
   gint r, g, b;
   gint smin, smax;
-  gint pa = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
+  gint pa = CLAMP ((gint) (params->alpha * 255), 0, 255);
+  gint8 cb = params->cb, cr = params->cr;
+  gint8 kg = params->kg;
+  guint8 accept_angle_tg = params->accept_angle_tg;
+  guint8 accept_angle_ctg = params->accept_angle_ctg;
+  guint8 one_over_kc = params->one_over_kc;
+  guint8 kfgy_scale = params->kfgy_scale;
+  guint noise_level2 = params->noise_level2;
   gint matrix[12], matrix2[12];
   gint p[4], o[3];
   gint bpp;
@@ -1305,8 +1333,8 @@ gst_alpha_chroma_key_rgb_argb (const GstVideoFrame * in_frame,
   p[2] = GST_VIDEO_FRAME_COMP_POFFSET (out_frame, 1);
   p[3] = GST_VIDEO_FRAME_COMP_POFFSET (out_frame, 2);
 
-  smin = 128 - alpha->black_sensitivity;
-  smax = 128 + alpha->white_sensitivity;
+  smin = 128 - params->black_sensitivity;
+  smax = 128 + params->white_sensitivity;
 
   memcpy (matrix, cog_rgb_to_ycbcr_matrix_8bit_sdtv, 12 * sizeof (gint));
   memcpy (matrix2, cog_ycbcr_to_rgb_matrix_8bit_sdtv, 12 * sizeof (gint));
@@ -1346,11 +1374,11 @@ gst_alpha_chroma_key_rgb_argb (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_set_planar_yuv_ayuv (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   guint8 *dest;
   gint width, height;
-  gint b_alpha = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
+  gint b_alpha = CLAMP ((gint) (params->alpha * 255), 0, 255);
   const guint8 *srcY, *srcY_tmp;
   const guint8 *srcU, *srcU_tmp;
   const guint8 *srcV, *srcV_tmp;
@@ -1391,7 +1419,7 @@ gst_alpha_set_planar_yuv_ayuv (const GstVideoFrame * in_frame,
       return;
   }
 
-  if (alpha->in_sdtv == alpha->out_sdtv) {
+  if (params->in_sdtv == params->out_sdtv) {
     for (i = 0; i < height; i++) {
       for (j = 0; j < width; j++) {
         dest[0] = b_alpha;
@@ -1421,7 +1449,7 @@ gst_alpha_set_planar_yuv_ayuv (const GstVideoFrame * in_frame,
     gint a, y, u, v;
 
     memcpy (matrix,
-        alpha->out_sdtv ? cog_ycbcr_hdtv_to_ycbcr_sdtv_matrix_8bit :
+        params->out_sdtv ? cog_ycbcr_hdtv_to_ycbcr_sdtv_matrix_8bit :
         cog_ycbcr_sdtv_to_ycbcr_hdtv_matrix_8bit, 12 * sizeof (gint));
 
     for (i = 0; i < height; i++) {
@@ -1458,11 +1486,11 @@ gst_alpha_set_planar_yuv_ayuv (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_chroma_key_planar_yuv_ayuv (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   guint8 *dest;
   gint width, height;
-  gint b_alpha = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
+  gint b_alpha = CLAMP ((gint) (params->alpha * 255), 0, 255);
   const guint8 *srcY, *srcY_tmp;
   const guint8 *srcU, *srcU_tmp;
   const guint8 *srcV, *srcV_tmp;
@@ -1470,15 +1498,15 @@ gst_alpha_chroma_key_planar_yuv_ayuv (const GstVideoFrame * in_frame,
   gint a, y, u, v;
   gint y_stride, uv_stride;
   gint v_subs, h_subs;
-  gint smin = 128 - alpha->black_sensitivity;
-  gint smax = 128 + alpha->white_sensitivity;
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
+  gint smin = 128 - params->black_sensitivity;
+  gint smax = 128 + params->white_sensitivity;
+  gint8 cb = params->cb, cr = params->cr;
+  gint8 kg = params->kg;
+  guint8 accept_angle_tg = params->accept_angle_tg;
+  guint8 accept_angle_ctg = params->accept_angle_ctg;
+  guint8 one_over_kc = params->one_over_kc;
+  guint8 kfgy_scale = params->kfgy_scale;
+  guint noise_level2 = params->noise_level2;
 
   dest = GST_VIDEO_FRAME_PLANE_DATA (out_frame, 0);
 
@@ -1513,7 +1541,7 @@ gst_alpha_chroma_key_planar_yuv_ayuv (const GstVideoFrame * in_frame,
       return;
   }
 
-  if (alpha->in_sdtv == alpha->out_sdtv) {
+  if (params->in_sdtv == params->out_sdtv) {
     for (i = 0; i < height; i++) {
       for (j = 0; j < width; j++) {
         a = b_alpha;
@@ -1554,7 +1582,7 @@ gst_alpha_chroma_key_planar_yuv_ayuv (const GstVideoFrame * in_frame,
     gint matrix[12];
 
     memcpy (matrix,
-        alpha->out_sdtv ? cog_ycbcr_hdtv_to_ycbcr_sdtv_matrix_8bit :
+        params->out_sdtv ? cog_ycbcr_hdtv_to_ycbcr_sdtv_matrix_8bit :
         cog_ycbcr_sdtv_to_ycbcr_hdtv_matrix_8bit, 12 * sizeof (gint));
 
     for (i = 0; i < height; i++) {
@@ -1595,11 +1623,11 @@ gst_alpha_chroma_key_planar_yuv_ayuv (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_set_planar_yuv_argb (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   guint8 *dest;
   gint width, height;
-  gint b_alpha = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
+  gint b_alpha = CLAMP ((gint) (params->alpha * 255), 0, 255);
   const guint8 *srcY, *srcY_tmp;
   const guint8 *srcU, *srcU_tmp;
   const guint8 *srcV, *srcV_tmp;
@@ -1650,7 +1678,7 @@ gst_alpha_set_planar_yuv_argb (const GstVideoFrame * in_frame,
   }
 
   memcpy (matrix,
-      alpha->in_sdtv ? cog_ycbcr_to_rgb_matrix_8bit_sdtv :
+      params->in_sdtv ? cog_ycbcr_to_rgb_matrix_8bit_sdtv :
       cog_ycbcr_to_rgb_matrix_8bit_hdtv, 12 * sizeof (gint));
 
   for (i = 0; i < height; i++) {
@@ -1689,11 +1717,11 @@ gst_alpha_set_planar_yuv_argb (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_chroma_key_planar_yuv_argb (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   guint8 *dest;
   gint width, height;
-  gint b_alpha = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
+  gint b_alpha = CLAMP ((gint) (params->alpha * 255), 0, 255);
   const guint8 *srcY, *srcY_tmp;
   const guint8 *srcU, *srcU_tmp;
   const guint8 *srcV, *srcV_tmp;
@@ -1702,15 +1730,15 @@ gst_alpha_chroma_key_planar_yuv_argb (const GstVideoFrame * in_frame,
   gint r, g, b;
   gint y_stride, uv_stride;
   gint v_subs, h_subs;
-  gint smin = 128 - alpha->black_sensitivity;
-  gint smax = 128 + alpha->white_sensitivity;
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
+  gint smin = 128 - params->black_sensitivity;
+  gint smax = 128 + params->white_sensitivity;
+  gint8 cb = params->cb, cr = params->cr;
+  gint8 kg = params->kg;
+  guint8 accept_angle_tg = params->accept_angle_tg;
+  guint8 accept_angle_ctg = params->accept_angle_ctg;
+  guint8 one_over_kc = params->one_over_kc;
+  guint8 kfgy_scale = params->kfgy_scale;
+  guint noise_level2 = params->noise_level2;
   gint matrix[12];
   gint p[4];
 
@@ -1753,7 +1781,7 @@ gst_alpha_chroma_key_planar_yuv_argb (const GstVideoFrame * in_frame,
   }
 
   memcpy (matrix,
-      alpha->in_sdtv ? cog_ycbcr_to_rgb_matrix_8bit_sdtv :
+      params->in_sdtv ? cog_ycbcr_to_rgb_matrix_8bit_sdtv :
       cog_ycbcr_to_rgb_matrix_8bit_hdtv, 12 * sizeof (gint));
 
   for (i = 0; i < height; i++) {
@@ -1799,12 +1827,12 @@ gst_alpha_chroma_key_planar_yuv_argb (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_set_packed_422_ayuv (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
   gint width, height;
-  gint s_alpha = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
+  gint s_alpha = CLAMP ((gint) (params->alpha * 255), 0, 255);
   gint i, j;
   gint y, u, v;
   gint p[4];                    /* Y U Y V */
@@ -1824,11 +1852,11 @@ gst_alpha_set_packed_422_ayuv (const GstVideoFrame * in_frame,
   p[1] = GST_VIDEO_FRAME_COMP_POFFSET (in_frame, 1);
   p[3] = GST_VIDEO_FRAME_COMP_POFFSET (in_frame, 2);
 
-  if (alpha->in_sdtv != alpha->out_sdtv) {
+  if (params->in_sdtv != params->out_sdtv) {
     gint matrix[12];
 
     memcpy (matrix,
-        alpha->in_sdtv ? cog_ycbcr_sdtv_to_ycbcr_hdtv_matrix_8bit :
+        params->in_sdtv ? cog_ycbcr_sdtv_to_ycbcr_hdtv_matrix_8bit :
         cog_ycbcr_hdtv_to_ycbcr_sdtv_matrix_8bit, 12 * sizeof (gint));
 
     for (i = 0; i < height; i++) {
@@ -1921,7 +1949,7 @@ gst_alpha_set_packed_422_ayuv (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_chroma_key_packed_422_ayuv (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
@@ -1929,14 +1957,14 @@ gst_alpha_chroma_key_packed_422_ayuv (const GstVideoFrame * in_frame,
   gint i, j;
   gint a, y, u, v;
   gint smin, smax;
-  gint pa = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
+  gint pa = CLAMP ((gint) (params->alpha * 255), 0, 255);
+  gint8 cb = params->cb, cr = params->cr;
+  gint8 kg = params->kg;
+  guint8 accept_angle_tg = params->accept_angle_tg;
+  guint8 accept_angle_ctg = params->accept_angle_ctg;
+  guint8 one_over_kc = params->one_over_kc;
+  guint8 kfgy_scale = params->kfgy_scale;
+  guint noise_level2 = params->noise_level2;
   gint p[4];                    /* Y U Y V */
   gint src_stride;
   const guint8 *src_tmp;
@@ -1954,14 +1982,14 @@ gst_alpha_chroma_key_packed_422_ayuv (const GstVideoFrame * in_frame,
   p[1] = GST_VIDEO_FRAME_COMP_POFFSET (in_frame, 1);
   p[3] = GST_VIDEO_FRAME_COMP_POFFSET (in_frame, 2);
 
-  smin = 128 - alpha->black_sensitivity;
-  smax = 128 + alpha->white_sensitivity;
+  smin = 128 - params->black_sensitivity;
+  smax = 128 + params->white_sensitivity;
 
-  if (alpha->in_sdtv != alpha->out_sdtv) {
+  if (params->in_sdtv != params->out_sdtv) {
     gint matrix[12];
 
     memcpy (matrix,
-        alpha->in_sdtv ? cog_ycbcr_sdtv_to_ycbcr_hdtv_matrix_8bit :
+        params->in_sdtv ? cog_ycbcr_sdtv_to_ycbcr_hdtv_matrix_8bit :
         cog_ycbcr_hdtv_to_ycbcr_sdtv_matrix_8bit, 12 * sizeof (gint));
 
     for (i = 0; i < height; i++) {
@@ -2076,12 +2104,12 @@ gst_alpha_chroma_key_packed_422_ayuv (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_set_packed_422_argb (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
   gint width, height;
-  gint s_alpha = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
+  gint s_alpha = CLAMP ((gint) (params->alpha * 255), 0, 255);
   gint i, j;
   gint p[4], o[4];
   gint src_stride;
@@ -2108,7 +2136,7 @@ gst_alpha_set_packed_422_argb (const GstVideoFrame * in_frame,
   p[3] = GST_VIDEO_FRAME_COMP_POFFSET (out_frame, 2);
 
   memcpy (matrix,
-      alpha->in_sdtv ? cog_ycbcr_to_rgb_matrix_8bit_sdtv :
+      params->in_sdtv ? cog_ycbcr_to_rgb_matrix_8bit_sdtv :
       cog_ycbcr_to_rgb_matrix_8bit_hdtv, 12 * sizeof (gint));
 
   for (i = 0; i < height; i++) {
@@ -2156,7 +2184,7 @@ gst_alpha_set_packed_422_argb (const GstVideoFrame * in_frame,
 
 static void
 gst_alpha_chroma_key_packed_422_argb (const GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame, GstAlpha * alpha)
+    GstVideoFrame * out_frame, const GstAlphaParams * params)
 {
   const guint8 *src;
   guint8 *dest;
@@ -2165,14 +2193,14 @@ gst_alpha_chroma_key_packed_422_argb (const GstVideoFrame * in_frame,
   gint a, y, u, v;
   gint r, g, b;
   gint smin, smax;
-  gint pa = CLAMP ((gint) (alpha->alpha * 255), 0, 255);
-  gint8 cb = alpha->cb, cr = alpha->cr;
-  gint8 kg = alpha->kg;
-  guint8 accept_angle_tg = alpha->accept_angle_tg;
-  guint8 accept_angle_ctg = alpha->accept_angle_ctg;
-  guint8 one_over_kc = alpha->one_over_kc;
-  guint8 kfgy_scale = alpha->kfgy_scale;
-  guint noise_level2 = alpha->noise_level2;
+  gint pa = CLAMP ((gint) (params->alpha * 255), 0, 255);
+  gint8 cb = params->cb, cr = params->cr;
+  gint8 kg = params->kg;
+  guint8 accept_angle_tg = params->accept_angle_tg;
+  guint8 accept_angle_ctg = params->accept_angle_ctg;
+  guint8 one_over_kc = params->one_over_kc;
+  guint8 kfgy_scale = params->kfgy_scale;
+  guint noise_level2 = params->noise_level2;
   gint p[4], o[4];
   gint src_stride;
   const guint8 *src_tmp;
@@ -2197,11 +2225,11 @@ gst_alpha_chroma_key_packed_422_argb (const GstVideoFrame * in_frame,
   p[3] = GST_VIDEO_FRAME_COMP_POFFSET (out_frame, 2);
 
   memcpy (matrix,
-      alpha->in_sdtv ? cog_ycbcr_to_rgb_matrix_8bit_sdtv :
+      params->in_sdtv ? cog_ycbcr_to_rgb_matrix_8bit_sdtv :
       cog_ycbcr_to_rgb_matrix_8bit_hdtv, 12 * sizeof (gint));
 
-  smin = 128 - alpha->black_sensitivity;
-  smax = 128 + alpha->white_sensitivity;
+  smin = 128 - params->black_sensitivity;
+  smax = 128 + params->white_sensitivity;
 
   for (i = 0; i < height; i++) {
     src_tmp = src;
@@ -2576,22 +2604,44 @@ gst_alpha_before_transform (GstBaseTransform * btrans, GstBuffer * buf)
   GST_LOG ("Got stream time of %" GST_TIME_FORMAT, GST_TIME_ARGS (timestamp));
   if (GST_CLOCK_TIME_IS_VALID (timestamp))
     gst_object_sync_values (GST_OBJECT (alpha), timestamp);
+
+  /* the slices of the frame all use this copy and don't need the lock */
+  GST_ALPHA_LOCK (alpha);
+  alpha->frame_params.process = alpha->process;
+  alpha->frame_params.in_sdtv = alpha->in_sdtv;
+  alpha->frame_params.out_sdtv = alpha->out_sdtv;
+  alpha->frame_params.alpha = alpha->alpha;
+  alpha->frame_params.black_sensitivity = alpha->black_sensitivity;
+  alpha->frame_params.white_sensitivity = alpha->white_sensitivity;
+  alpha->frame_params.cb = alpha->cb;
+  alpha->frame_params.cr = alpha->cr;
+  alpha->frame_params.kg = alpha->kg;
+  alpha->frame_params.accept_angle_tg = alpha->accept_angle_tg;
+  alpha->frame_params.accept_angle_ctg = alpha->accept_angle_ctg;
+  alpha->frame_params.one_over_kc = alpha->one_over_kc;
+  alpha->frame_params.kfgy_scale = alpha->kfgy_scale;
+  alpha->frame_params.noise_level2 = alpha->noise_level2;
+  GST_ALPHA_UNLOCK (alpha);
 }
 
 static GstFlowReturn
-gst_alpha_transform_frame (GstVideoFilter * filter, GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame)
+gst_alpha_transform_frame_slice (GstVideoFilter * filter,
+    GstVideoFrame * in_frame, GstVideoFrame * out_frame, guint start_line,
+    guint end_line)
 {
   GstAlpha *alpha = GST_ALPHA (filter);
+  const GstAlphaParams *params = &alpha->frame_params;
+  GstVideoFrame in_slice, out_slice;
 
-  GST_ALPHA_LOCK (alpha);
-
-  if (G_UNLIKELY (!alpha->process))
+  if (G_UNLIKELY (!params->process))
     goto not_negotiated;
 
-  alpha->process (in_frame, out_frame, alpha);
+  /* input and output have the same size */
+  gst_video_filter_get_frame_slice (in_frame, &in_slice, start_line, end_line);
+  gst_video_filter_get_frame_slice (out_frame, &out_slice, start_line,
+      end_line);
 
-  GST_ALPHA_UNLOCK (alpha);
+  params->process (&in_slice, &out_slice, params);
 
   return GST_FLOW_OK;
 
@@ -2599,7 +2649,6 @@ gst_alpha_transform_frame (GstVideoFilter * filter, GstVideoFrame * in_frame,
 not_negotiated:
   {
     GST_ERROR_OBJECT (alpha, "Not negotiated yet");
-    GST_ALPHA_UNLOCK (alpha);
     return GST_FLOW_NOT_NEGOTIATED;
   }
 }
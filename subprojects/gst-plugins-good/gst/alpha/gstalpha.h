@@ -52,6 +52,27 @@ GstAlphaMethod;
 GST_DEBUG_CATEGORY_STATIC (gst_alpha_debug);
 #define GST_CAT_DEFAULT gst_alpha_debug
 
+typedef struct _GstAlphaParams GstAlphaParams;
+
+/* What the processing functions read, see GstAlpha.frame_params */
+struct _GstAlphaParams
+{
+  void (*process) (const GstVideoFrame *in_frame, GstVideoFrame *out_frame, const GstAlphaParams *params);
+
+  gboolean in_sdtv, out_sdtv;
+  gdouble alpha;
+  guint black_sensitivity;
+  guint white_sensitivity;
+
+  gint8 cb, cr;
+  gint8 kg;
+  guint8 accept_angle_tg;
+  guint8 accept_angle_ctg;
+  guint8 one_over_kc;
+  guint8 kfgy_scale;
+  guint noise_level2;
+};
+
 struct _GstAlpha
 {
   GstVideoFilter parent;
@@ -80,7 +101,7 @@ struct _GstAlpha
   gboolean prefer_passthrough;
 
   /* processing function */
-  void (*process) (const GstVideoFrame *in_frame, GstVideoFrame *out_frame, GstAlpha *alpha);
+  void (*process) (const GstVideoFrame *in_frame, GstVideoFrame *out_frame, const GstAlphaParams *params);
 
   /* precalculated values for chroma keying */
   gint8 cb, cr;
@@ -90,6 +111,10 @@ struct _GstAlpha
   guint8 one_over_kc;
   guint8 kfgy_scale;
   guint noise_level2;
+
+  /* copied from the above before each frame, only accessed from the
+   * streaming thread */
+  GstAlphaParams frame_params;
 };
 
 GST_ELEMENT_REGISTER_DECLARE (alpha);
@@ -50,11 +50,13 @@ enum
 {
   PROP_0 = 0,
   PROP_LOW_LATENCY,
-  PROP_DRAIN_ON_CHANGES
+  PROP_DRAIN_ON_CHANGES,
+  PROP_PARTITION_LENGTH
 };
 
 #define DEFAULT_LOW_LATENCY FALSE
 #define DEFAULT_DRAIN_ON_CHANGES TRUE
+#define DEFAULT_PARTITION_LENGTH 0
 
 #define gst_audio_fx_base_fir_filter_parent_class parent_class
 G_DEFINE_TYPE (GstAudioFXBaseFIRFilter, gst_audio_fx_base_fir_filter,
@@ -224,7 +226,45 @@ DEFINE_PROCESS_FUNC_FIXED_CHANNELS (64, 2, double);
  *   (  N log N  )
  * O ( --------- ) compared to O (M) for the direct calculation.
  *   ( N - M + 1 )
+ *
+ * The latency of this is N - M + 1 samples, which gets large for long
+ * kernels. If a partition length B is set, the kernel is instead split
+ * into P = M / B partitions h_p of length B and the input into blocks
+ * x_k of length B (uniformly partitioned overlap-save). Every pass then
+ * transforms the last two input blocks with an FFT of length N = 2 * B
+ * and calculates
+ *
+ * y = IFFT (\sum_{p=0}^{P-1} FFT(x_{k-p}) * FFT(h_p))
+ *
+ * of which the last B samples are output. The spectra of the last P
+ * input blocks are kept in a frequency domain delay line, so each pass
+ * costs one FFT, one IFFT and P complex multiplications per bin, and
+ * the latency is B samples independent of the kernel length.
+ *
+ * Both modes share the code below. The unpartitioned mode is the special
+ * case of a single partition with an overlap of M - 1 samples.
  */
+
+/* acc = x * h or, if accumulate is set, acc += x * h */
+static inline void
+complex_multiply (GstFFTF64Complex * acc, const GstFFTF64Complex * x,
+    const GstFFTF64Complex * h, guint len, gboolean accumulate)
+{
+  guint i;
+
+  if (accumulate) {
+    for (i = 0; i < len; i++) {
+      acc[i].r += x[i].r * h[i].r - x[i].i * h[i].i;
+      acc[i].i += x[i].r * h[i].i + x[i].i * h[i].r;
+    }
+  } else {
+    for (i = 0; i < len; i++) {
+      acc[i].r = x[i].r * h[i].r - x[i].i * h[i].i;
+      acc[i].i = x[i].r * h[i].i + x[i].i * h[i].r;
+    }
+  }
+}
+
 #define DEFINE_FFT_PROCESS_FUNC(width,ctype) \
 static guint \
 process_fft_##width (GstAudioFXBaseFIRFilter * self, const g##ctype * src, \
@@ -244,20 +284,22 @@ process_fft_##channels##_##width (GstAudioFXBaseFIRFilter * self, const g##ctype
 
 #define FFT_CONVOLUTION_BODY(channels) G_STMT_START { \
   gint i, j; \
-  guint pass; \
-  guint kernel_length = self->kernel_length; \
+  guint p, pass; \
+  guint overlap = self->block_overlap; \
   guint block_length = self->block_length; \
   guint buffer_length = self->buffer_length; \
-  guint real_buffer_length = buffer_length + kernel_length - 1; \
+  guint real_buffer_length = buffer_length + overlap; \
   guint buffer_fill = self->buffer_fill; \
+  guint n_partitions = self->n_partitions; \
+  guint fdl_position = self->fdl_position; \
   GstFFTF64 *fft = self->fft; \
   GstFFTF64 *ifft = self->ifft; \
   GstFFTF64Complex *frequency_response = self->frequency_response; \
   GstFFTF64Complex *fft_buffer = self->fft_buffer; \
   guint frequency_response_length = self->frequency_response_length; \
   gdouble *buffer = self->buffer; \
+  GstFFTF64Complex *fdl, *spectrum; \
   guint generated = 0; \
-  gdouble re, im; \
   \
   if (!fft_buffer) \
     self->fft_buffer = fft_buffer = \
@@ -266,30 +308,37 @@ process_fft_##channels##_##width (GstAudioFXBaseFIRFilter * self, const g##ctype
   /* Buffer contains the time domain samples of input data for one chunk \
    * plus some more space for the inverse FFT below. \
    * \
-   * The samples are put at offset kernel_length, the inverse FFT \
-   * overwrites everything from offset 0 to length-kernel_length+1, keeping \
-   * the last kernel_length-1 samples for copying to the next processing \
+   * The samples are put at offset overlap, the inverse FFT \
+   * overwrites everything from offset 0 to length-overlap, keeping \
+   * the last overlap samples for copying to the next processing \
    * step. \
+   * \
+   * It is followed by the frequency domain delay line, the spectra of \
+   * the last n_partitions input blocks of every channel. \
    */ \
   if (!buffer) { \
     self->buffer_length = buffer_length = block_length; \
-    real_buffer_length = buffer_length + kernel_length - 1; \
+    real_buffer_length = buffer_length + overlap; \
     \
-    self->buffer = buffer = g_new0 (gdouble, real_buffer_length * channels); \
+    self->buffer = buffer = g_new0 (gdouble, (real_buffer_length + \
+            2 * frequency_response_length * n_partitions) * channels); \
     \
-    /* Beginning has kernel_length-1 zeroes at the beginning */ \
-    self->buffer_fill = buffer_fill = kernel_length - 1; \
+    /* Beginning has overlap zeroes at the beginning */ \
+    self->buffer_fill = buffer_fill = overlap; \
+    self->fdl_position = fdl_position = 0; \
   } \
   \
   g_assert (self->buffer_length == block_length); \
   \
+  fdl = (GstFFTF64Complex *) (buffer + real_buffer_length * channels); \
+  \
   while (input_samples) { \
     pass = MIN (buffer_length - buffer_fill, input_samples); \
     \
     /* Deinterleave channels */ \
     for (i = 0; i < pass; i++) { \
       for (j = 0; j < channels; j++) { \
-        buffer[real_buffer_length * j + buffer_fill + kernel_length - 1 + i] = \
+        buffer[real_buffer_length * j + buffer_fill + overlap + i] = \
             src[i * channels + j]; \
       } \
     } \
@@ -302,49 +351,49 @@ process_fft_##channels##_##width (GstAudioFXBaseFIRFilter * self, const g##ctype
       break; \
     \
     for (j = 0; j < channels; j++) { \
-      /* Calculate FFT of input block */ \
-      gst_fft_f64_fft (fft, \
-          buffer + real_buffer_length * j + kernel_length - 1, fft_buffer); \
+      spectrum = fdl + frequency_response_length * n_partitions * j; \
+      \
+      /* Calculate FFT of input block into the delay line */ \
+      gst_fft_f64_fft (fft, buffer + real_buffer_length * j + overlap, \
+          spectrum + frequency_response_length * fdl_position); \
       \
-      /* Complex multiplication of input and filter spectrum */ \
-      for (i = 0; i < frequency_response_length; i++) { \
-	re = fft_buffer[i].r; \
-	im = fft_buffer[i].i; \
-        \
-        fft_buffer[i].r = \
-            re * frequency_response[i].r - \
-            im * frequency_response[i].i; \
-        fft_buffer[i].i = \
-            re * frequency_response[i].i + \
-            im * frequency_response[i].r; \
+      /* Complex multiplication of input and filter spectrum, where \
+       * partition p of the filter applies to the input of p passes ago */ \
+      for (p = 0; p < n_partitions; p++) { \
+        complex_multiply (fft_buffer, spectrum + frequency_response_length * \
+            ((fdl_position + n_partitions - p) % n_partitions), \
+            frequency_response + frequency_response_length * p, \
+            frequency_response_length, p > 0); \
       } \
       \
       /* Calculate inverse FFT of the result */ \
       gst_fft_f64_inverse_fft (ifft, fft_buffer, \
           buffer + real_buffer_length * j); \
       \
-      /* Copy all except the first kernel_length-1 samples to the output */ \
-      for (i = 0; i < buffer_length - kernel_length + 1; i++) { \
+      /* Copy all except the first overlap samples to the output */ \
+      for (i = 0; i < buffer_length - overlap; i++) { \
         dst[i * channels + j] = \
-            buffer[real_buffer_length * j + kernel_length - 1 + i]; \
+            buffer[real_buffer_length * j + overlap + i]; \
       } \
       \
-      /* Copy the last kernel_length-1 samples to the beginning for the next block */ \
-      for (i = 0; i < kernel_length - 1; i++) { \
-        buffer[real_buffer_length * j + kernel_length - 1 + i] = \
+      /* Copy the last overlap samples to the beginning for the next block */ \
+      for (i = 0; i < overlap; i++) { \
+        buffer[real_buffer_length * j + overlap + i] = \
             buffer[real_buffer_length * j + buffer_length + i]; \
       } \
     } \
     \
-    generated += buffer_length - kernel_length + 1; \
-    dst += channels * (buffer_length - kernel_length + 1); \
+    generated += buffer_length - overlap; \
+    dst += channels * (buffer_length - overlap); \
+    fdl_position = (fdl_position + 1) % n_partitions; \
     \
-    /* The the first kernel_length-1 samples are there already */ \
-    buffer_fill = kernel_length - 1; \
+    /* The the first overlap samples are there already */ \
+    buffer_fill = overlap; \
   } \
   \
-  /* Write back cached buffer_fill value */ \
+  /* Write back cached buffer_fill and delay line position */ \
   self->buffer_fill = buffer_fill; \
+  self->fdl_position = fdl_position; \
   \
   return generated; \
 } G_STMT_END
@@ -378,27 +427,52 @@ static void
 
   if (self->kernel && self->kernel_length >= FFT_THRESHOLD
       && !self->low_latency) {
-    guint block_length, i;
+    guint block_length, partition_length, i, p;
     gdouble *kernel_tmp, *kernel = self->kernel;
 
-    /* We process 4 * kernel_length samples per pass in FFT mode */
-    block_length = 4 * self->kernel_length;
-    block_length = gst_fft_next_fast_length (block_length);
+    if (self->partition_length > 0) {
+      /* In partitioned mode we process one partition length of samples
+       * per pass, with an FFT of twice that length */
+      block_length = gst_fft_next_fast_length (2 * self->partition_length);
+      partition_length = block_length / 2;
+      self->block_overlap = partition_length;
+    } else {
+      /* We process 4 * kernel_length samples per pass in FFT mode */
+      block_length = 4 * self->kernel_length;
+      block_length = gst_fft_next_fast_length (block_length);
+      partition_length = self->kernel_length;
+      self->block_overlap = self->kernel_length - 1;
+    }
     self->block_length = block_length;
+    self->n_partitions =
+        (self->kernel_length + partition_length - 1) / partition_length;
 
-    kernel_tmp = g_new0 (gdouble, block_length);
-    memcpy (kernel_tmp, kernel, self->kernel_length * sizeof (gdouble));
+    GST_DEBUG_OBJECT (self, "FFT length %u, %u partitions of length %u",
+        block_length, self->n_partitions, partition_length);
+
+    kernel_tmp = g_new (gdouble, block_length);
 
     self->fft = gst_fft_f64_new (block_length, FALSE);
     self->ifft = gst_fft_f64_new (block_length, TRUE);
     self->frequency_response_length = block_length / 2 + 1;
     self->frequency_response =
-        g_new (GstFFTF64Complex, self->frequency_response_length);
-    gst_fft_f64_fft (self->fft, kernel_tmp, self->frequency_response);
+        g_new (GstFFTF64Complex,
+        self->frequency_response_length * self->n_partitions);
+    for (p = 0; p < self->n_partitions; p++) {
+      guint offset = p * partition_length;
+
+      memset (kernel_tmp, 0, block_length * sizeof (gdouble));
+      memcpy (kernel_tmp, kernel + offset,
+          MIN (partition_length,
+              self->kernel_length - offset) * sizeof (gdouble));
+      gst_fft_f64_fft (self->fft, kernel_tmp,
+          self->frequency_response + self->frequency_response_length * p);
+    }
     g_free (kernel_tmp);
 
     /* Normalize to make sure IFFT(FFT(x)) == x */
-    for (i = 0; i < self->frequency_response_length; i++) {
+    for (i = 0; i < self->frequency_response_length * self->n_partitions;
+        i++) {
       self->frequency_response[i].r /= block_length;
       self->frequency_response[i].i /= block_length;
     }
@@ -502,6 +576,27 @@ gst_audio_fx_base_fir_filter_set_property (GObject * object, guint prop_id,
       g_mutex_unlock (&self->lock);
       break;
     }
+    case PROP_PARTITION_LENGTH:{
+      guint partition_length;
+
+      if (GST_STATE (self) >= GST_STATE_PAUSED) {
+        g_warning ("Changing the \"partition-length\" property "
+            "is only allowed in states < PAUSED");
+        return;
+      }
+
+      g_mutex_lock (&self->lock);
+      partition_length = g_value_get_uint (value);
+
+      if (self->partition_length != partition_length) {
+        self->partition_length = partition_length;
+        gst_audio_fx_base_fir_filter_calculate_frequency_response (self);
+        gst_audio_fx_base_fir_filter_select_process_function (self,
+            GST_AUDIO_FILTER_FORMAT (self), GST_AUDIO_FILTER_CHANNELS (self));
+      }
+      g_mutex_unlock (&self->lock);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -521,6 +616,9 @@ gst_audio_fx_base_fir_filter_get_property (GObject * object, guint prop_id,
     case PROP_DRAIN_ON_CHANGES:
       g_value_set_boolean (value, self->drain_on_changes);
       break;
+    case PROP_PARTITION_LENGTH:
+      g_value_set_uint (value, self->partition_length);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -569,6 +667,28 @@ gst_audio_fx_base_fir_filter_class_init (GstAudioFXBaseFIRFilterClass * klass)
           DEFAULT_DRAIN_ON_CHANGES,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioFXBaseFIRFilter:partition-length:
+   *
+   * Split long filter kernels into partitions of (at least) this many
+   * samples and convolve them with a uniformly partitioned FFT
+   * convolution. The latency is then the partition length instead of a
+   * multiple of the kernel length, while the processing cost stays close
+   * to that of the default FFT mode. 0 disables partitioning.
+   *
+   * Has no effect in low-latency mode or for kernels that are processed
+   * in the time domain.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_PARTITION_LENGTH,
+      g_param_spec_uint ("partition-length", "Partition length",
+          "Length of the filter kernel partitions for low latency FFT "
+          "convolution, 0 to disable. "
+          "Can only be changed in states < PAUSED!", 0, 65536,
+          DEFAULT_PARTITION_LENGTH,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   caps = gst_caps_from_string (ALLOWED_CAPS);
   gst_audio_filter_class_add_pad_templates (GST_AUDIO_FILTER_CLASS (klass),
       caps);
@@ -602,6 +722,7 @@ gst_audio_fx_base_fir_filter_init (GstAudioFXBaseFIRFilter * self)
 
   self->low_latency = DEFAULT_LOW_LATENCY;
   self->drain_on_changes = DEFAULT_DRAIN_ON_CHANGES;
+  self->partition_length = DEFAULT_PARTITION_LENGTH;
 
   g_mutex_init (&self->lock);
 }
@@ -777,7 +898,7 @@ gst_audio_fx_base_fir_filter_transform_size (GstBaseTransform * base,
   bpf = GST_AUDIO_INFO_BPF (&info);
 
   size /= bpf;
-  blocklen = self->block_length - self->kernel_length + 1;
+  blocklen = self->block_length - self->block_overlap;
   *othersize = ((size + blocklen - 1) / blocklen) * blocklen;
   *othersize *= bpf;
 
@@ -973,7 +1094,7 @@ gst_audio_fx_base_fir_filter_query (GstBaseTransform * trans,
             GST_TIME_ARGS (min), GST_TIME_ARGS (max));
 
         if (self->fft && !self->low_latency)
-          latency = self->block_length - self->kernel_length + 1;
+          latency = self->block_length - self->block_overlap;
         else
           latency = self->latency;
 
@@ -1030,7 +1151,7 @@ gst_audio_fx_base_fir_filter_set_kernel (GstAudioFXBaseFIRFilter * self,
     gdouble * kernel, guint kernel_length, guint64 latency,
     const GstAudioInfo * info)
 {
-  gboolean latency_changed;
+  gboolean latency_changed, partitions_changed;
   GstAudioFormat format;
   gint channels;
 
@@ -1045,9 +1166,15 @@ gst_audio_fx_base_fir_filter_set_kernel (GstAudioFXBaseFIRFilter * self,
       || (!self->low_latency && self->kernel_length >= FFT_THRESHOLD
           && kernel_length < FFT_THRESHOLD));
 
+  /* In partitioned mode the size of the frequency domain delay line in the
+   * buffer depends on the kernel length */
+  partitions_changed = (self->partition_length > 0
+      && self->kernel_length != kernel_length);
+
   /* FIXME: If the latency changes, the buffer size changes too and we
    * have to drain in any case until this is fixed in the future */
-  if (self->buffer && (!self->drain_on_changes || latency_changed)) {
+  if (self->buffer && (!self->drain_on_changes || latency_changed
+          || partitions_changed)) {
     gst_audio_fx_base_fir_filter_push_residue (self);
     self->start_ts = GST_CLOCK_TIME_NONE;
     self->start_off = GST_BUFFER_OFFSET_NONE;
@@ -1057,7 +1184,7 @@ gst_audio_fx_base_fir_filter_set_kernel (GstAudioFXBaseFIRFilter * self,
   }
 
   g_free (self->kernel);
-  if (!self->drain_on_changes || latency_changed) {
+  if (!self->drain_on_changes || latency_changed || partitions_changed) {
     g_free (self->buffer);
     self->buffer = NULL;
     self->buffer_fill = 0;
@@ -64,6 +64,8 @@ struct _GstAudioFXBaseFIRFilter {
 
   gboolean drain_on_changes;    /* If the filter should be drained when
                                  * coefficients change */
+  guint partition_length;       /* partition length for uniformly
+                                 * partitioned FFT convolution, 0 = off */
 
   /* < private > */
   GstAudioFXBaseFIRFilterProcessFunc process;
@@ -75,10 +77,13 @@ struct _GstAudioFXBaseFIRFilter {
   /* FFT convolution specific data */
   GstFFTF64 *fft;
   GstFFTF64 *ifft;
-  GstFFTF64Complex *frequency_response;  /* filter kernel -- frequency domain */
-  guint frequency_response_length;       /* length of filter kernel -- frequency domain */
+  GstFFTF64Complex *frequency_response;  /* filter kernel -- frequency domain, one spectrum per partition */
+  guint frequency_response_length;       /* length of one kernel partition -- frequency domain */
   GstFFTF64Complex *fft_buffer;          /* FFT buffer, has the length of the frequency response */
   guint block_length;                    /* Length of the processing blocks -- time domain */
+  guint block_overlap;                   /* Input samples kept from the previous block */
+  guint n_partitions;                    /* Number of kernel partitions */
+  guint fdl_position;                    /* Newest spectrum in the frequency domain delay line */
 
   GstClockTime start_ts;        /* start timestamp after a discont */
   guint64 start_off;            /* start offset after a discont */
@@ -54,6 +54,9 @@ gst_audio_fx_base_iir_filter_transform_ip (GstBaseTransform * base,
     GstBuffer * buf);
 static gboolean gst_audio_fx_base_iir_filter_stop (GstBaseTransform * base);
 
+static void free_history (GstAudioFXBaseIIRFilter * filter);
+static void alloc_history (GstAudioFXBaseIIRFilter * filter);
+
 static void process_64 (GstAudioFXBaseIIRFilter * filter,
     gdouble * data, guint num_samples);
 static void process_32 (GstAudioFXBaseIIRFilter * filter,
@@ -76,19 +79,7 @@ gst_audio_fx_base_iir_filter_finalize (GObject * object)
     filter->b = NULL;
   }
 
-  if (filter->channels) {
-    GstAudioFXBaseIIRFilterChannelCtx *ctx;
-    guint i;
-
-    for (i = 0; i < filter->nchannels; i++) {
-      ctx = &filter->channels[i];
-      g_free (ctx->x);
-      g_free (ctx->y);
-    }
-
-    g_free (filter->channels);
-    filter->channels = NULL;
-  }
+  free_history (filter);
   g_mutex_clear (&filter->lock);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -131,7 +122,8 @@ gst_audio_fx_base_iir_filter_init (GstAudioFXBaseIIRFilter * filter)
   filter->na = 0;
   filter->b = NULL;
   filter->nb = 0;
-  filter->channels = NULL;
+  filter->x = NULL;
+  filter->y = NULL;
   filter->nchannels = 0;
 
   g_mutex_init (&filter->lock);
@@ -180,12 +172,32 @@ gst_audio_fx_base_iir_filter_calculate_gain (gdouble * a, guint na, gdouble * b,
   return (sqrt (gain_r * gain_r + gain_i * gain_i));
 }
 
+/* The history of input and output values is kept as nb and na rows of one
+ * value per channel. The rows are used as ring buffers that all channels
+ * advance together, so that all channels of a frame are filtered in parallel
+ * with the same coefficient. */
+static void
+free_history (GstAudioFXBaseIIRFilter * filter)
+{
+  g_free (filter->x);
+  filter->x = NULL;
+  g_free (filter->y);
+  filter->y = NULL;
+  filter->x_pos = filter->y_pos = 0;
+}
+
+static void
+alloc_history (GstAudioFXBaseIIRFilter * filter)
+{
+  filter->x = g_new0 (gdouble, filter->nb * filter->nchannels);
+  filter->y = g_new0 (gdouble, filter->na * filter->nchannels);
+  filter->x_pos = filter->y_pos = 0;
+}
+
 void
 gst_audio_fx_base_iir_filter_set_coefficients (GstAudioFXBaseIIRFilter * filter,
     gdouble * a, guint na, gdouble * b, guint nb)
 {
-  guint i;
-
   g_return_if_fail (GST_IS_AUDIO_FX_BASE_IIR_FILTER (filter));
 
   g_mutex_lock (&filter->lock);
@@ -195,27 +207,7 @@ gst_audio_fx_base_iir_filter_set_coefficients (GstAudioFXBaseIIRFilter * filter,
 
   filter->a = filter->b = NULL;
 
-  if (filter->channels) {
-    GstAudioFXBaseIIRFilterChannelCtx *ctx;
-    gboolean free = (na != filter->na || nb != filter->nb);
-
-    for (i = 0; i < filter->nchannels; i++) {
-      ctx = &filter->channels[i];
-
-      if (free)
-        g_free (ctx->x);
-      else
-        memset (ctx->x, 0, filter->nb * sizeof (gdouble));
-
-      if (free)
-        g_free (ctx->y);
-      else
-        memset (ctx->y, 0, filter->na * sizeof (gdouble));
-    }
-
-    g_free (filter->channels);
-    filter->channels = NULL;
-  }
+  free_history (filter);
 
   filter->na = na;
   filter->nb = nb;
@@ -223,18 +215,8 @@ gst_audio_fx_base_iir_filter_set_coefficients (GstAudioFXBaseIIRFilter * filter,
   filter->a = a;
   filter->b = b;
 
-  if (filter->nchannels && !filter->channels) {
-    GstAudioFXBaseIIRFilterChannelCtx *ctx;
-
-    filter->channels =
-        g_new0 (GstAudioFXBaseIIRFilterChannelCtx, filter->nchannels);
-    for (i = 0; i < filter->nchannels; i++) {
-      ctx = &filter->channels[i];
-
-      ctx->x = g_new0 (gdouble, filter->nb);
-      ctx->y = g_new0 (gdouble, filter->na);
-    }
-  }
+  if (filter->nchannels)
+    alloc_history (filter);
 
   g_mutex_unlock (&filter->lock);
 }
@@ -267,68 +249,110 @@ gst_audio_fx_base_iir_filter_setup (GstAudioFilter * base,
   channels = GST_AUDIO_INFO_CHANNELS (info);
 
   if (channels != filter->nchannels) {
-    guint i;
-    GstAudioFXBaseIIRFilterChannelCtx *ctx;
-
-    if (filter->channels) {
-      for (i = 0; i < filter->nchannels; i++) {
-        ctx = &filter->channels[i];
-
-        g_free (ctx->x);
-        g_free (ctx->y);
-      }
-      g_free (filter->channels);
-    }
-
-    filter->channels = g_new0 (GstAudioFXBaseIIRFilterChannelCtx, channels);
-    for (i = 0; i < channels; i++) {
-      ctx = &filter->channels[i];
-
-      ctx->x = g_new0 (gdouble, filter->nb);
-      ctx->y = g_new0 (gdouble, filter->na);
-    }
+    free_history (filter);
     filter->nchannels = channels;
+    alloc_history (filter);
   }
   g_mutex_unlock (&filter->lock);
 
   return ret;
 }
 
-static inline gdouble
-process (GstAudioFXBaseIIRFilter * filter,
-    GstAudioFXBaseIIRFilterChannelCtx * ctx, gdouble x0)
+#if defined (__SSE2__) || defined (_M_X64)
+#include <emmintrin.h>
+#define IIR_SIMD 1
+typedef __m128d v2df;
+#define VD_LOAD(p) _mm_loadu_pd (p)
+#define VD_STORE(p,v) _mm_storeu_pd (p, v)
+#define VD_SET1(d) _mm_set1_pd (d)
+#define VD_ADD(a,b) _mm_add_pd (a, b)
+#define VD_MUL(a,b) _mm_mul_pd (a, b)
+#define VD_DIV(a,b) _mm_div_pd (a, b)
+#elif defined (__aarch64__)
+#include <arm_neon.h>
+#define IIR_SIMD 1
+typedef float64x2_t v2df;
+#define VD_LOAD(p) vld1q_f64 (p)
+#define VD_STORE(p,v) vst1q_f64 (p, v)
+#define VD_SET1(d) vdupq_n_f64 (d)
+#define VD_ADD(a,b) vaddq_f64 (a, b)
+#define VD_MUL(a,b) vmulq_f64 (a, b)
+#define VD_DIV(a,b) vdivq_f64 (a, b)
+#endif
+
+/* val[c] += k * row[c] for all channels */
+static inline void
+accumulate (gdouble * val, const gdouble * row, gdouble k, guint channels)
+{
+  guint c = 0;
+
+#ifdef IIR_SIMD
+  v2df vk = VD_SET1 (k);
+
+  for (; c + 4 <= channels; c += 4) {
+    VD_STORE (val + c, VD_ADD (VD_LOAD (val + c),
+            VD_MUL (vk, VD_LOAD (row + c))));
+    VD_STORE (val + c + 2, VD_ADD (VD_LOAD (val + c + 2),
+            VD_MUL (vk, VD_LOAD (row + c + 2))));
+  }
+  for (; c + 2 <= channels; c += 2)
+    VD_STORE (val + c, VD_ADD (VD_LOAD (val + c),
+            VD_MUL (vk, VD_LOAD (row + c))));
+#endif
+  for (; c < channels; c++)
+    val[c] += k * row[c];
+}
+
+/* Filters one frame whose input values are already stored in the current
+ * input history row. The output values are stored in the next output
+ * history row, which is returned. */
+static inline gdouble *
+process (GstAudioFXBaseIIRFilter * filter)
 {
-  gdouble val = filter->b[0] * x0;
+  guint channels = filter->nchannels;
+  gdouble *x0 = filter->x + filter->x_pos * channels;
+  gdouble *val;
+  guint c;
   gint i, j;
 
-  for (i = 1, j = ctx->x_pos; i < filter->nb; i++) {
-    val += filter->b[i] * ctx->x[j];
-    j--;
+  /* The next output row holds the oldest output value, which is not needed
+   * anymore, and is used to accumulate the new ones */
+  j = filter->y_pos + 1;
+  if (j >= filter->na)
+    j = 0;
+  val = filter->y + j * channels;
+  for (c = 0; c < channels; c++)
+    val[c] = filter->b[0] * x0[c];
+
+  for (i = 1, j = filter->x_pos - 1; i < filter->nb; i++) {
     if (j < 0)
       j = filter->nb - 1;
+    accumulate (val, filter->x + j * channels, filter->b[i], channels);
+    j--;
   }
 
-  for (i = 1, j = ctx->y_pos; i < filter->na; i++) {
-    val -= filter->a[i] * ctx->y[j];
-    j--;
+  for (i = 1, j = filter->y_pos; i < filter->na; i++) {
     if (j < 0)
       j = filter->na - 1;
+    accumulate (val, filter->y + j * channels, -filter->a[i], channels);
+    j--;
   }
-  val /= filter->a[0];
 
-  if (ctx->x) {
-    ctx->x_pos++;
-    if (ctx->x_pos >= filter->nb)
-      ctx->x_pos = 0;
-    ctx->x[ctx->x_pos] = x0;
-  }
-  if (ctx->y) {
-    ctx->y_pos++;
-    if (ctx->y_pos >= filter->na)
-      ctx->y_pos = 0;
+  c = 0;
+#ifdef IIR_SIMD
+  {
+    v2df a0 = VD_SET1 (filter->a[0]);
 
-    ctx->y[ctx->y_pos] = val;
+    for (; c + 2 <= channels; c += 2)
+      VD_STORE (val + c, VD_DIV (VD_LOAD (val + c), a0));
   }
+#endif
+  for (; c < channels; c++)
+    val[c] /= filter->a[0];
+
+  filter->y_pos++;
+  if (filter->y_pos >= filter->na)
+    filter->y_pos = 0;
 
   return val;
 }
@@ -339,13 +363,19 @@ process_##width (GstAudioFXBaseIIRFilter * filter, \
     g##ctype * data, guint num_samples) \
 { \
   gint i, j, channels = filter->nchannels; \
-  gdouble val; \
+  gdouble *x, *val; \
   \
   for (i = 0; i < num_samples / channels; i++) { \
-    for (j = 0; j < channels; j++) { \
-      val = process (filter, &filter->channels[j], *data); \
-      *data++ = val; \
-    } \
+    filter->x_pos++; \
+    if (filter->x_pos >= filter->nb) \
+      filter->x_pos = 0; \
+    x = filter->x + filter->x_pos * channels; \
+    for (j = 0; j < channels; j++) \
+      x[j] = data[j]; \
+    \
+    val = process (filter); \
+    for (j = 0; j < channels; j++) \
+      *data++ = val[j]; \
   } \
 }
 
@@ -397,21 +427,10 @@ static gboolean
 gst_audio_fx_base_iir_filter_stop (GstBaseTransform * base)
 {
   GstAudioFXBaseIIRFilter *filter = GST_AUDIO_FX_BASE_IIR_FILTER (base);
-  guint channels = filter->nchannels;
-  GstAudioFXBaseIIRFilterChannelCtx *ctx;
-  guint i;
 
   /* Reset the history of input and output values if
    * already existing */
-  if (channels && filter->channels) {
-    for (i = 0; i < channels; i++) {
-      ctx = &filter->channels[i];
-      g_free (ctx->x);
-      g_free (ctx->y);
-    }
-    g_free (filter->channels);
-  }
-  filter->channels = NULL;
+  free_history (filter);
   filter->nchannels = 0;
 
   return TRUE;
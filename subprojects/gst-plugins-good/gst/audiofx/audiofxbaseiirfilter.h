@@ -39,14 +39,6 @@ typedef struct _GstAudioFXBaseIIRFilterClass GstAudioFXBaseIIRFilterClass;
 
 typedef void (*GstAudioFXBaseIIRFilterProcessFunc) (GstAudioFXBaseIIRFilter *, guint8 *, guint);
 
-typedef struct
-{
-  gdouble *x;
-  gint x_pos;
-  gdouble *y;
-  gint y_pos;
-} GstAudioFXBaseIIRFilterChannelCtx;
-
 struct _GstAudioFXBaseIIRFilter
 {
   GstAudioFilter audiofilter;
@@ -58,9 +50,14 @@ struct _GstAudioFXBaseIIRFilter
   guint na;
   gdouble *b;
   guint nb;
-  GstAudioFXBaseIIRFilterChannelCtx *channels;
   guint nchannels;
 
+  /* history, nb and na rows of nchannels values */
+  gdouble *x;
+  gint x_pos;
+  gdouble *y;
+  gint y_pos;
+
   GMutex lock;
 };
 
@@ -53,7 +53,8 @@
  * for the best overlap position.  Scaletempo uses a statistical cross
  * correlation (roughly a dot-product).  Scaletempo consumes most of its CPU
  * cycles here. One can use the #GstScaletempo:search propery to tune how far
- * the algorithm looks.
+ * the algorithm looks, and #GstScaletempo:fast-search to trade some accuracy
+ * of the search for a much lower CPU usage.
  *
  */
 
@@ -88,6 +89,7 @@ enum
   PROP_STRIDE,
   PROP_OVERLAP,
   PROP_SEARCH,
+  PROP_FAST_SEARCH,
 };
 
 #define SUPPORTED_CAPS \
@@ -115,6 +117,90 @@ G_DEFINE_TYPE_WITH_CODE (GstScaletempo, gst_scaletempo,
 GST_ELEMENT_REGISTER_DEFINE (scaletempo, "scaletempo",
     GST_RANK_NONE, GST_TYPE_SCALETEMPO);
 
+/* The correlation is a plain dot product over interleaved samples, so it
+ * is vectorized independently of the number of channels */
+#if defined (__SSE2__) || defined (_M_X64)
+#include <emmintrin.h>
+#define SCALETEMPO_SIMD 1
+typedef __m128 v4sf;
+typedef __m128d v2df;
+#define VF_LOAD(p) _mm_loadu_ps (p)
+#define VF_STORE(p,v) _mm_storeu_ps (p, v)
+#define VF_SET1(f) _mm_set1_ps (f)
+#define VF_ADD(a,b) _mm_add_ps (a, b)
+#define VF_MUL(a,b) _mm_mul_ps (a, b)
+#define VD_LOAD(p) _mm_loadu_pd (p)
+#define VD_STORE(p,v) _mm_storeu_pd (p, v)
+#define VD_SET1(d) _mm_set1_pd (d)
+#define VD_ADD(a,b) _mm_add_pd (a, b)
+#define VD_MUL(a,b) _mm_mul_pd (a, b)
+#elif defined (__aarch64__)
+#include <arm_neon.h>
+#define SCALETEMPO_SIMD 1
+typedef float32x4_t v4sf;
+typedef float64x2_t v2df;
+#define VF_LOAD(p) vld1q_f32 (p)
+#define VF_STORE(p,v) vst1q_f32 (p, v)
+#define VF_SET1(f) vdupq_n_f32 (f)
+#define VF_ADD(a,b) vaddq_f32 (a, b)
+#define VF_MUL(a,b) vmulq_f32 (a, b)
+#define VD_LOAD(p) vld1q_f64 (p)
+#define VD_STORE(p,v) vst1q_f64 (p, v)
+#define VD_SET1(d) vdupq_n_f64 (d)
+#define VD_ADD(a,b) vaddq_f64 (a, b)
+#define VD_MUL(a,b) vmulq_f64 (a, b)
+#endif
+
+static inline gfloat
+dot_product_float (const gfloat * a, const gfloat * b, guint n)
+{
+  gfloat corr = 0;
+  guint i = 0;
+
+#ifdef SCALETEMPO_SIMD
+  {
+    v4sf s0 = VF_SET1 (0.0f), s1 = VF_SET1 (0.0f);
+    gfloat s[4];
+
+    for (; i + 8 <= n; i += 8) {
+      s0 = VF_ADD (s0, VF_MUL (VF_LOAD (a + i), VF_LOAD (b + i)));
+      s1 = VF_ADD (s1, VF_MUL (VF_LOAD (a + i + 4), VF_LOAD (b + i + 4)));
+    }
+    VF_STORE (s, VF_ADD (s0, s1));
+    corr = (s[0] + s[1]) + (s[2] + s[3]);
+  }
+#endif
+  for (; i < n; i++)
+    corr += a[i] * b[i];
+
+  return corr;
+}
+
+static inline gdouble
+dot_product_double (const gdouble * a, const gdouble * b, guint n)
+{
+  gdouble corr = 0;
+  guint i = 0;
+
+#ifdef SCALETEMPO_SIMD
+  {
+    v2df s0 = VD_SET1 (0.0), s1 = VD_SET1 (0.0);
+    gdouble s[2];
+
+    for (; i + 4 <= n; i += 4) {
+      s0 = VD_ADD (s0, VD_MUL (VD_LOAD (a + i), VD_LOAD (b + i)));
+      s1 = VD_ADD (s1, VD_MUL (VD_LOAD (a + i + 2), VD_LOAD (b + i + 2)));
+    }
+    VD_STORE (s, VD_ADD (s0, s1));
+    corr = s[0] + s[1];
+  }
+#endif
+  for (; i < n; i++)
+    corr += a[i] * b[i];
+
+  return corr;
+}
+
 #define CREATE_BEST_OVERLAP_OFFSET_FLOAT_FUNC(type) \
 static guint \
 best_overlap_offset_##type (GstScaletempo * st) \
@@ -122,6 +208,7 @@ best_overlap_offset_##type (GstScaletempo * st) \
   g##type *pw, *po, *ppc, *search_start; \
   g##type best_corr = G_MININT; \
   guint best_off = 0; \
+  guint n = st->samples_overlap - st->samples_per_frame; \
   gint i, off; \
   \
   pw = st->table_window; \
@@ -134,12 +221,7 @@ best_overlap_offset_##type (GstScaletempo * st) \
   \
   search_start = (g##type *) st->buf_queue + st->samples_per_frame; \
   for (off = 0; off < st->frames_search; off++) { \
-    g##type corr = 0; \
-    g##type *ps = search_start; \
-    ppc = st->buf_pre_corr; \
-    for (i = st->samples_per_frame; i < st->samples_overlap; i++) { \
-      corr += *ppc++ * *ps++; \
-    } \
+    g##type corr = dot_product_##type (st->buf_pre_corr, search_start, n); \
     if (corr > best_corr) { \
       best_corr = corr; \
       best_off = off; \
@@ -198,6 +280,88 @@ best_overlap_offset_s16 (GstScaletempo * st)
   return best_off * st->bytes_per_frame;
 }
 
+/* Sums the channels of @frames frames into a mono float signal */
+static void
+downmix_frames (GstScaletempo * st, gconstpointer src, gfloat * dst,
+    guint frames)
+{
+  guint i, c, channels = st->samples_per_frame;
+
+  if (st->format == GST_AUDIO_FORMAT_S16) {
+    const gint16 *p = src;
+    for (i = 0; i < frames; i++) {
+      gint32 sum = 0;
+      for (c = 0; c < channels; c++)
+        sum += *p++;
+      dst[i] = sum;
+    }
+  } else if (st->format == GST_AUDIO_FORMAT_F32) {
+    const gfloat *p = src;
+    for (i = 0; i < frames; i++) {
+      gfloat sum = 0;
+      for (c = 0; c < channels; c++)
+        sum += *p++;
+      dst[i] = sum;
+    }
+  } else {
+    const gdouble *p = src;
+    for (i = 0; i < frames; i++) {
+      gdouble sum = 0;
+      for (c = 0; c < channels; c++)
+        sum += *p++;
+      dst[i] = sum;
+    }
+  }
+}
+
+/* Fast search: the overlap and the search window are downmixed to mono once
+ * per stride, so the correlation cost no longer grows with the number of
+ * channels. Every frames_search_step-th offset is then tried and only the
+ * neighbourhood of the best one is searched at full resolution. */
+static guint
+best_overlap_offset_fast (GstScaletempo * st)
+{
+  gfloat *ppc = st->buf_pre_corr, *pw = st->table_window;
+  gfloat best_corr = -G_MAXFLOAT;
+  guint n = st->samples_overlap / st->samples_per_frame - 1;
+  guint step = st->frames_search_step;
+  guint best_off = 0, coarse_off, off, end;
+  guint i;
+
+  downmix_frames (st, (gint8 *) st->buf_overlap + st->bytes_per_frame, ppc,
+      n);
+  for (i = 0; i < n; i++)
+    ppc[i] *= pw[i];
+
+  downmix_frames (st, st->buf_queue + st->bytes_per_frame, st->buf_search,
+      st->frames_search + n - 1);
+
+  for (off = 0; off < st->frames_search; off += step) {
+    gfloat corr = dot_product_float (ppc, st->buf_search + off, n);
+    if (corr > best_corr) {
+      best_corr = corr;
+      best_off = off;
+    }
+  }
+
+  coarse_off = best_off;
+  off = coarse_off >= step ? coarse_off - step + 1 : 0;
+  end = MIN (coarse_off + step, st->frames_search);
+  for (; off < end; off++) {
+    gfloat corr;
+
+    if (off == coarse_off)
+      continue;
+    corr = dot_product_float (ppc, st->buf_search + off, n);
+    if (corr > best_corr) {
+      best_corr = corr;
+      best_off = off;
+    }
+  }
+
+  return best_off * st->bytes_per_frame;
+}
+
 #define CREATE_OUTPUT_OVERLAP_FLOAT_FUNC(type) \
 static void \
 output_overlap_##type (GstScaletempo * st, gpointer buf_out, guint bytes_off) \
@@ -341,6 +505,22 @@ reinit_buffers (GstScaletempo * st)
       (frames_overlap <= 1) ? 0 : st->ms_search * st->sample_rate / 1000.0;
   if (st->frames_search < 1) {  /* if no search */
     st->best_overlap_offset = NULL;
+  } else if (st->fast_search) {
+    /* mono float window and pre-correlation, see best_overlap_offset_fast() */
+    guint bytes_pre_corr = (frames_overlap - 1) * sizeof (gfloat);
+    gfloat *pw;
+
+    st->buf_pre_corr = g_realloc (st->buf_pre_corr, bytes_pre_corr);
+    st->table_window = g_realloc (st->table_window, bytes_pre_corr);
+    pw = st->table_window;
+    for (i = 1; i < frames_overlap; i++)
+      *pw++ = i * (gfloat) (frames_overlap - i);
+
+    st->buf_search = g_realloc (st->buf_search,
+        (st->frames_search + frames_overlap) * sizeof (gfloat));
+    /* coarse resolution of 1/8 ms */
+    st->frames_search_step = MAX (st->sample_rate / 8000, 1);
+    st->best_overlap_offset = best_overlap_offset_fast;
   } else {
     /* S16 uses gint32 buffer, floats/doubles use their respective type */
     guint bytes_pre_corr =
@@ -416,13 +596,14 @@ reinit_buffers (GstScaletempo * st)
   st->frames_stride_scaled = st->bytes_stride_scaled / st->bytes_per_frame;
 
   GST_DEBUG
-      ("%.3f scale, %.3f stride_in, %i stride_out, %i standing, %i overlap, %i search, %i queue, %s mode",
+      ("%.3f scale, %.3f stride_in, %i stride_out, %i standing, %i overlap, %i search, %i queue, %s mode%s",
       st->scale, st->frames_stride_scaled,
       (gint) (st->bytes_stride / st->bytes_per_frame),
       (gint) (st->bytes_standing / st->bytes_per_frame),
       (gint) (st->bytes_overlap / st->bytes_per_frame), st->frames_search,
       (gint) (st->bytes_queue_max / st->bytes_per_frame),
-      gst_audio_format_to_string (st->format));
+      gst_audio_format_to_string (st->format),
+      st->fast_search ? ", fast search" : "");
 
   st->reinit_buffers = FALSE;
 }
@@ -736,6 +917,8 @@ gst_scaletempo_stop (GstBaseTransform * trans)
   scaletempo->buf_pre_corr = NULL;
   g_free (scaletempo->table_window);
   scaletempo->table_window = NULL;
+  g_free (scaletempo->buf_search);
+  scaletempo->buf_search = NULL;
   scaletempo->reinit_buffers = TRUE;
 
   return TRUE;
@@ -832,6 +1015,9 @@ gst_scaletempo_get_property (GObject * object,
     case PROP_SEARCH:
       g_value_set_uint (value, scaletempo->ms_search);
       break;
+    case PROP_FAST_SEARCH:
+      g_value_set_boolean (value, scaletempo->fast_search);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -869,6 +1055,14 @@ gst_scaletempo_set_property (GObject * object,
       }
       break;
     }
+    case PROP_FAST_SEARCH:{
+      gboolean new_value = g_value_get_boolean (value);
+      if (scaletempo->fast_search != new_value) {
+        scaletempo->fast_search = new_value;
+        scaletempo->reinit_buffers = TRUE;
+      }
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -904,6 +1098,23 @@ gst_scaletempo_class_init (GstScaletempoClass * klass)
           "Length in milliseconds to search for best overlap position", 0, 500,
           14, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstScaletempo:fast-search:
+   *
+   * Search for the best overlap position on a mono downmix of the input,
+   * first at a coarse resolution of 1/8 ms and then at full resolution
+   * around the best coarse position. This is several times cheaper than the
+   * exhaustive search, in particular for more than two channels, at the cost
+   * of occasionally picking a slightly worse position.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_FAST_SEARCH,
+      g_param_spec_boolean ("fast-search", "Fast Search",
+          "Search for the best overlap position on a mono downmix and at a "
+          "coarse resolution first", FALSE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &src_template);
   gst_element_class_add_static_pad_template (gstelement_class, &sink_template);
   gst_element_class_set_static_metadata (gstelement_class, "Scaletempo",
@@ -931,6 +1142,7 @@ gst_scaletempo_init (GstScaletempo * scaletempo)
   scaletempo->ms_stride = 30;
   scaletempo->percent_overlap = .2;
   scaletempo->ms_search = 14;
+  scaletempo->fast_search = FALSE;
 
   /* uninitialized */
   scaletempo->scale = 0;
@@ -47,6 +47,7 @@ struct _GstScaletempo
   guint ms_stride;
   gdouble percent_overlap;
   guint ms_search;
+  gboolean fast_search;
 
   /* caps */
   GstAudioFormat format;
@@ -78,6 +79,8 @@ struct _GstScaletempo
   guint frames_search;
   gpointer buf_pre_corr;
   gpointer table_window;
+  gfloat *buf_search;
+  guint frames_search_step;
   guint (*best_overlap_offset) (GstScaletempo * scaletempo);
 
   /* gstreamer */
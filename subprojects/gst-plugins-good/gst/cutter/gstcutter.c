@@ -296,13 +296,19 @@ gst_cutter_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   bpf = GST_AUDIO_INFO_BPF (&filter->info);
   rate = GST_AUDIO_INFO_RATE (&filter->info);
 
+  GST_LOG_OBJECT (filter, "length of prerec buffer: %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (filter->pre_run_length));
+
+  /* GAP buffers are silence, no need to look at the samples */
+  if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_GAP)) {
+    in_size = gst_buffer_get_size (buf);
+    goto calculated;
+  }
+
   gst_buffer_map (buf, &map, GST_MAP_READ);
   in_data = (gint16 *) map.data;
   in_size = map.size;
 
-  GST_LOG_OBJECT (filter, "length of prerec buffer: %" GST_TIME_FORMAT,
-      GST_TIME_ARGS (filter->pre_run_length));
-
   /* calculate mean square value on buffer */
   switch (GST_AUDIO_INFO_FORMAT (&filter->info)) {
     case GST_AUDIO_FORMAT_S16:
@@ -323,6 +329,7 @@ gst_cutter_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
 
   gst_buffer_unmap (buf, &map);
 
+calculated:
   filter->silent_prev = filter->silent;
 
   duration = gst_util_uint64_scale (in_size / bpf, GST_SECOND, rate);
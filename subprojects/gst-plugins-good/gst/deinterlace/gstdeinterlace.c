@@ -60,6 +60,7 @@ GST_DEBUG_CATEGORY_STATIC (deinterlace_debug);
 #define DEFAULT_LOCKING         GST_DEINTERLACE_LOCKING_NONE
 #define DEFAULT_IGNORE_OBSCURE  TRUE
 #define DEFAULT_DROP_ORPHANS    TRUE
+#define DEFAULT_N_THREADS       1
 
 enum
 {
@@ -70,7 +71,8 @@ enum
   PROP_FIELD_LAYOUT,
   PROP_LOCKING,
   PROP_IGNORE_OBSCURE,
-  PROP_DROP_ORPHANS
+  PROP_DROP_ORPHANS,
+  PROP_N_THREADS
 };
 
 /* P is progressive, meaning the top and bottom fields belong to
@@ -282,9 +284,16 @@ gst_deinterlace_locking_get_type (void)
   return deinterlace_locking_type;
 }
 
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+#define DEINTERLACE_VIDEO_FORMATS \
+    "{ AYUV, ARGB, ABGR, RGBA, BGRA, Y444, xRGB, xBGR, RGBx, BGRx, RGB, " \
+    "BGR, YUY2, YVYU, UYVY, Y42B, I420, YV12, Y41B, NV12, NV21, " \
+    "P010_10LE, P016_LE, I420_10LE, I422_10LE, Y444_10LE }"
+#else
 #define DEINTERLACE_VIDEO_FORMATS \
     "{ AYUV, ARGB, ABGR, RGBA, BGRA, Y444, xRGB, xBGR, RGBx, BGRx, RGB, " \
     "BGR, YUY2, YVYU, UYVY, Y42B, I420, YV12, Y41B, NV12, NV21 }"
+#endif
 
 #define DEINTERLACE_CAPS GST_VIDEO_CAPS_MAKE(DEINTERLACE_VIDEO_FORMATS)
 
@@ -451,6 +460,7 @@ gst_deinterlace_set_method (GstDeinterlace * self, GstDeinterlaceMethods method)
   GST_OBJECT_LOCK (self);
   self->method = g_object_new (method_type, "name", "method", NULL);
   gst_object_set_parent (GST_OBJECT (self->method), GST_OBJECT (self));
+  gst_deinterlace_method_set_n_threads (self->method, self->n_threads);
   GST_OBJECT_UNLOCK (self);
 
 #if 0
@@ -635,6 +645,20 @@ gst_deinterlace_class_init (GstDeinterlaceClass * klass)
           "active locking mode.", DEFAULT_DROP_ORPHANS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDeinterlace:n-threads:
+   *
+   * Maximum number of threads used by the line based deinterlacing methods
+   * to process each field in slices. 0 uses the number of CPUs.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use (0 = number of CPUs)", 0,
+          G_MAXUINT, DEFAULT_N_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   element_class->change_state =
       GST_DEBUG_FUNCPTR (gst_deinterlace_change_state);
 
@@ -697,6 +721,7 @@ gst_deinterlace_init (GstDeinterlace * self)
 
   self->mode = DEFAULT_MODE;
   self->user_set_method_id = DEFAULT_METHOD;
+  self->n_threads = DEFAULT_N_THREADS;
   gst_video_info_init (&self->vinfo);
   gst_video_info_init (&self->vinfo_out);
   gst_deinterlace_set_method (self, self->user_set_method_id);
@@ -946,6 +971,13 @@ gst_deinterlace_set_property (GObject * object, guint prop_id,
     case PROP_DROP_ORPHANS:
       self->drop_orphans = g_value_get_boolean (value);
       break;
+    case PROP_N_THREADS:
+      GST_OBJECT_LOCK (self);
+      self->n_threads = g_value_get_uint (value);
+      if (self->method)
+        gst_deinterlace_method_set_n_threads (self->method, self->n_threads);
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (self, prop_id, pspec);
   }
@@ -982,6 +1014,9 @@ gst_deinterlace_get_property (GObject * object, guint prop_id,
     case PROP_DROP_ORPHANS:
       g_value_set_boolean (value, self->drop_orphans);
       break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, self->n_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (self, prop_id, pspec);
   }
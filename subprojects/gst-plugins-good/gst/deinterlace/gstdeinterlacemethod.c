@@ -89,6 +89,15 @@ gst_deinterlace_method_supported_impl (GstDeinterlaceMethodClass * klass,
       return (klass->deinterlace_frame_rgb != NULL);
     case GST_VIDEO_FORMAT_BGR:
       return (klass->deinterlace_frame_bgr != NULL);
+    case GST_VIDEO_FORMAT_P010_10LE:
+    case GST_VIDEO_FORMAT_P016_LE:
+      return (klass->deinterlace_frame_p010 != NULL);
+    case GST_VIDEO_FORMAT_I420_10LE:
+      return (klass->deinterlace_frame_i420_10 != NULL);
+    case GST_VIDEO_FORMAT_I422_10LE:
+      return (klass->deinterlace_frame_i422_10 != NULL);
+    case GST_VIDEO_FORMAT_Y444_10LE:
+      return (klass->deinterlace_frame_y444_10 != NULL);
     default:
       return FALSE;
   }
@@ -171,6 +180,19 @@ gst_deinterlace_method_setup_impl (GstDeinterlaceMethod * self,
     case GST_VIDEO_FORMAT_BGR:
       self->deinterlace_frame = klass->deinterlace_frame_bgr;
       break;
+    case GST_VIDEO_FORMAT_P010_10LE:
+    case GST_VIDEO_FORMAT_P016_LE:
+      self->deinterlace_frame = klass->deinterlace_frame_p010;
+      break;
+    case GST_VIDEO_FORMAT_I420_10LE:
+      self->deinterlace_frame = klass->deinterlace_frame_i420_10;
+      break;
+    case GST_VIDEO_FORMAT_I422_10LE:
+      self->deinterlace_frame = klass->deinterlace_frame_i422_10;
+      break;
+    case GST_VIDEO_FORMAT_Y444_10LE:
+      self->deinterlace_frame = klass->deinterlace_frame_y444_10;
+      break;
     default:
       self->deinterlace_frame = NULL;
       break;
@@ -188,6 +210,7 @@ static void
 gst_deinterlace_method_init (GstDeinterlaceMethod * self)
 {
   self->vinfo = NULL;
+  self->n_threads = 1;
 }
 
 void
@@ -216,6 +239,16 @@ gst_deinterlace_method_get_latency (GstDeinterlaceMethod * self)
   return klass->latency;
 }
 
+void
+gst_deinterlace_method_set_n_threads (GstDeinterlaceMethod * self,
+    guint n_threads)
+{
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  g_atomic_int_set (&self->n_threads, n_threads);
+}
+
 G_DEFINE_ABSTRACT_TYPE (GstDeinterlaceSimpleMethod,
     gst_deinterlace_simple_method, GST_TYPE_DEINTERLACE_METHOD);
 
@@ -287,6 +320,21 @@ gst_deinterlace_simple_method_supported (GstDeinterlaceMethodClass * mklass,
           && klass->copy_scanline_planar_u != NULL &&
           klass->interpolate_scanline_planar_v != NULL
           && klass->copy_scanline_planar_v != NULL);
+    case GST_VIDEO_FORMAT_P010_10LE:
+    case GST_VIDEO_FORMAT_P016_LE:
+      return (klass->interpolate_scanline_p010 != NULL
+          && klass->copy_scanline_p010 != NULL
+          && klass->interpolate_scanline_planar_y_16 != NULL
+          && klass->copy_scanline_planar_y_16 != NULL);
+    case GST_VIDEO_FORMAT_I420_10LE:
+    case GST_VIDEO_FORMAT_I422_10LE:
+    case GST_VIDEO_FORMAT_Y444_10LE:
+      return (klass->interpolate_scanline_planar_y_16 != NULL
+          && klass->copy_scanline_planar_y_16 != NULL &&
+          klass->interpolate_scanline_planar_u_16 != NULL
+          && klass->copy_scanline_planar_u_16 != NULL &&
+          klass->interpolate_scanline_planar_v_16 != NULL
+          && klass->copy_scanline_planar_v_16 != NULL);
     default:
       return FALSE;
   }
@@ -374,6 +422,135 @@ get_line (LinesGetter * lg, gint field_offset, guint plane, gint line,
   return data;
 }
 
+typedef void (*LinesFunc) (gpointer data, gint start, gint end);
+
+typedef struct
+{
+  LinesFunc func;
+  gpointer data;
+} LinesJob;
+
+/* Don't split frames into slices of less lines than this */
+#define MIN_LINES_PER_SLICE 16
+
+static void
+gst_deinterlace_simple_method_run_slice (guint start, guint end,
+    gpointer user_data)
+{
+  LinesJob *job = user_data;
+
+  job->func (job->data, start, end);
+}
+
+/* Calls @func for all @height lines of a plane. All lines only depend on the
+ * history and not on other output lines, so they are split into slices that
+ * are processed in parallel if the method may use multiple threads. */
+static void
+gst_deinterlace_simple_method_process_lines (GstDeinterlaceSimpleMethod *
+    self, gint height, LinesFunc func, gpointer data)
+{
+  GstDeinterlaceMethod *method = GST_DEINTERLACE_METHOD (self);
+  LinesJob job;
+  guint n_threads, n_slices;
+
+  n_threads = g_atomic_int_get (&method->n_threads);
+  n_slices = MIN (n_threads, height / MIN_LINES_PER_SLICE);
+
+  if (n_slices <= 1) {
+    func (data, 0, height);
+    return;
+  }
+
+  if (self->runner_threads != n_threads) {
+    if (self->runner)
+      gst_parallelized_task_runner_free (self->runner);
+    self->runner = gst_parallelized_task_runner_new (n_threads, NULL, FALSE);
+    self->runner_threads = n_threads;
+  }
+
+  /* the runner can't use more threads than the shared pool has */
+  n_slices = MIN (n_slices,
+      gst_parallelized_task_runner_get_n_threads (self->runner));
+
+  job.func = func;
+  job.data = data;
+  gst_parallelized_task_runner_parallel_for (self->runner, height,
+      (height + n_slices - 1) / n_slices,
+      gst_deinterlace_simple_method_run_slice, &job);
+}
+
+typedef struct
+{
+  GstDeinterlaceSimpleMethod *self;
+  GstVideoFrame *dest;
+  LinesGetter *lg;
+  guint cur_field_flags;
+  gint plane;
+  gint frame_width;
+  GstDeinterlaceSimpleMethodFunction copy_scanline;
+  GstDeinterlaceSimpleMethodFunction interpolate_scanline;
+} PlaneLines;
+
+static void
+gst_deinterlace_simple_method_deinterlace_lines (PlaneLines * pl, gint start,
+    gint end)
+{
+  GstDeinterlaceScanlineData scanlines;
+  LinesGetter *lg = pl->lg;
+  gint plane = pl->plane;
+  gint i;
+
+#define LINE(x,i) (((guint8*)GST_VIDEO_FRAME_PLANE_DATA((x),plane)) + i * \
+    GST_VIDEO_FRAME_PLANE_STRIDE((x),plane))
+
+  for (i = start; i < end; i++) {
+    memset (&scanlines, 0, sizeof (scanlines));
+    scanlines.bottom_field = (pl->cur_field_flags == PICTURE_INTERLACED_BOTTOM);
+
+    if (!((i & 1) ^ scanlines.bottom_field)) {
+      /* copying */
+      scanlines.tp = get_line (lg, -1, plane, i, -1);
+      scanlines.bp = get_line (lg, -1, plane, i, 1);
+
+      scanlines.tt0 = get_line (lg, 0, plane, i, -2);
+      scanlines.m0 = get_line (lg, 0, plane, i, 0);
+      scanlines.bb0 = get_line (lg, 0, plane, i, 2);
+
+      scanlines.t1 = get_line (lg, 1, plane, i, -1);
+      scanlines.b1 = get_line (lg, 1, plane, i, 1);
+
+      scanlines.tt2 = get_line (lg, 2, plane, i, -2);
+      scanlines.m2 = get_line (lg, 2, plane, i, 0);
+      scanlines.bb2 = get_line (lg, 2, plane, i, 2);
+
+      pl->copy_scanline (pl->self, LINE (pl->dest, i), &scanlines,
+          pl->frame_width);
+    } else {
+      /* interpolating */
+      scanlines.tp2 = get_line (lg, -2, plane, i, -1);
+      scanlines.bp2 = get_line (lg, -2, plane, i, 1);
+
+      scanlines.ttp = get_line (lg, -1, plane, i, -2);
+      scanlines.mp = get_line (lg, -1, plane, i, 0);
+      scanlines.bbp = get_line (lg, -1, plane, i, 2);
+
+      scanlines.t0 = get_line (lg, 0, plane, i, -1);
+      scanlines.b0 = get_line (lg, 0, plane, i, 1);
+
+      scanlines.tt1 = get_line (lg, 1, plane, i, -2);
+      scanlines.m1 = get_line (lg, 1, plane, i, 0);
+      scanlines.bb1 = get_line (lg, 1, plane, i, 2);
+
+      scanlines.t2 = get_line (lg, 2, plane, i, -1);
+      scanlines.b2 = get_line (lg, 2, plane, i, 1);
+
+      pl->interpolate_scanline (pl->self, LINE (pl->dest, i), &scanlines,
+          pl->frame_width);
+    }
+#undef LINE
+  }
+}
+
 static void
 gst_deinterlace_simple_method_deinterlace_frame_packed (GstDeinterlaceMethod *
     method, const GstDeinterlaceField * history, guint history_count,
@@ -383,12 +560,11 @@ gst_deinterlace_simple_method_deinterlace_frame_packed (GstDeinterlaceMethod *
 #ifndef G_DISABLE_ASSERT
   GstDeinterlaceMethodClass *dm_class = GST_DEINTERLACE_METHOD_GET_CLASS (self);
 #endif
-  GstDeinterlaceScanlineData scanlines;
   guint cur_field_flags;
-  gint i;
   gint frame_height, frame_width;
   LinesGetter lg = { history, history_count, cur_field_idx };
   GstVideoFrame *framep, *frame0, *frame1, *frame2;
+  PlaneLines pl;
 
   g_assert (self->interpolate_scanline_packed != NULL);
   g_assert (self->copy_scanline_packed != NULL);
@@ -418,55 +594,17 @@ gst_deinterlace_simple_method_deinterlace_frame_packed (GstDeinterlaceMethod *
   if (frame2)
     frame_width = MIN (frame_width, GST_VIDEO_FRAME_PLANE_STRIDE (frame2, 0));
 
-#define LINE(x,i) (((guint8*)GST_VIDEO_FRAME_PLANE_DATA((x),0)) + i * \
-    GST_VIDEO_FRAME_PLANE_STRIDE((x),0))
-
-  for (i = 0; i < frame_height; i++) {
-    memset (&scanlines, 0, sizeof (scanlines));
-    scanlines.bottom_field = (cur_field_flags == PICTURE_INTERLACED_BOTTOM);
-
-    if (!((i & 1) ^ scanlines.bottom_field)) {
-      /* copying */
-      scanlines.tp = get_line (&lg, -1, 0, i, -1);
-      scanlines.bp = get_line (&lg, -1, 0, i, 1);
-
-      scanlines.tt0 = get_line (&lg, 0, 0, i, -2);
-      scanlines.m0 = get_line (&lg, 0, 0, i, 0);
-      scanlines.bb0 = get_line (&lg, 0, 0, i, 2);
-
-      scanlines.t1 = get_line (&lg, 1, 0, i, -1);
-      scanlines.b1 = get_line (&lg, 1, 0, i, 1);
-
-      scanlines.tt2 = get_line (&lg, 2, 0, i, -2);
-      scanlines.m2 = get_line (&lg, 2, 0, i, 0);
-      scanlines.bb2 = get_line (&lg, 2, 0, i, 2);
-
-      self->copy_scanline_packed (self, LINE (outframe, i), &scanlines,
-          frame_width);
-    } else {
-      /* interpolating */
-      scanlines.tp2 = get_line (&lg, -2, 0, i, -1);
-      scanlines.bp2 = get_line (&lg, -2, 0, i, 1);
-
-      scanlines.ttp = get_line (&lg, -1, 0, i, -2);
-      scanlines.mp = get_line (&lg, -1, 0, i, 0);
-      scanlines.bbp = get_line (&lg, -1, 0, i, 2);
-
-      scanlines.t0 = get_line (&lg, 0, 0, i, -1);
-      scanlines.b0 = get_line (&lg, 0, 0, i, 1);
-
-      scanlines.tt1 = get_line (&lg, 1, 0, i, -2);
-      scanlines.m1 = get_line (&lg, 1, 0, i, 0);
-      scanlines.bb1 = get_line (&lg, 1, 0, i, 2);
-
-      scanlines.t2 = get_line (&lg, 2, 0, i, -1);
-      scanlines.b2 = get_line (&lg, 2, 0, i, 1);
-
-      self->interpolate_scanline_packed (self, LINE (outframe, i), &scanlines,
-          frame_width);
-    }
-#undef LINE
-  }
+  pl.self = self;
+  pl.dest = outframe;
+  pl.lg = &lg;
+  pl.cur_field_flags = cur_field_flags;
+  pl.plane = 0;
+  pl.frame_width = frame_width;
+  pl.copy_scanline = self->copy_scanline_packed;
+  pl.interpolate_scanline = self->interpolate_scanline_packed;
+
+  gst_deinterlace_simple_method_process_lines (self, frame_height,
+      (LinesFunc) gst_deinterlace_simple_method_deinterlace_lines, &pl);
 }
 
 static void
@@ -525,64 +663,26 @@ static void
     GstDeinterlaceSimpleMethodFunction copy_scanline,
     GstDeinterlaceSimpleMethodFunction interpolate_scanline)
 {
-  GstDeinterlaceScanlineData scanlines;
-  gint i;
-  gint frame_height, frame_width;
+  PlaneLines pl;
+  gint frame_height;
 
   frame_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, plane);
-  frame_width = GST_VIDEO_FRAME_COMP_WIDTH (dest, plane) *
-      GST_VIDEO_FRAME_COMP_PSTRIDE (dest, plane);
 
   g_assert (interpolate_scanline != NULL);
   g_assert (copy_scanline != NULL);
 
-#define LINE(x,i) (((guint8*)GST_VIDEO_FRAME_PLANE_DATA((x),plane)) + i * \
-    GST_VIDEO_FRAME_PLANE_STRIDE((x),plane))
-
-  for (i = 0; i < frame_height; i++) {
-    memset (&scanlines, 0, sizeof (scanlines));
-    scanlines.bottom_field = (cur_field_flags == PICTURE_INTERLACED_BOTTOM);
-
-    if (!((i & 1) ^ scanlines.bottom_field)) {
-      /* copying */
-      scanlines.tp = get_line (lg, -1, plane, i, -1);
-      scanlines.bp = get_line (lg, -1, plane, i, 1);
-
-      scanlines.tt0 = get_line (lg, 0, plane, i, -2);
-      scanlines.m0 = get_line (lg, 0, plane, i, 0);
-      scanlines.bb0 = get_line (lg, 0, plane, i, 2);
-
-      scanlines.t1 = get_line (lg, 1, plane, i, -1);
-      scanlines.b1 = get_line (lg, 1, plane, i, 1);
-
-      scanlines.tt2 = get_line (lg, 2, plane, i, -2);
-      scanlines.m2 = get_line (lg, 2, plane, i, 0);
-      scanlines.bb2 = get_line (lg, 2, plane, i, 2);
-
-      copy_scanline (self, LINE (dest, i), &scanlines, frame_width);
-    } else {
-      /* interpolating */
-      scanlines.tp2 = get_line (lg, -2, plane, i, -1);
-      scanlines.bp2 = get_line (lg, -2, plane, i, 1);
-
-      scanlines.ttp = get_line (lg, -1, plane, i, -2);
-      scanlines.mp = get_line (lg, -1, plane, i, 0);
-      scanlines.bbp = get_line (lg, -1, plane, i, 2);
-
-      scanlines.t0 = get_line (lg, 0, plane, i, -1);
-      scanlines.b0 = get_line (lg, 0, plane, i, 1);
-
-      scanlines.tt1 = get_line (lg, 1, plane, i, -2);
-      scanlines.m1 = get_line (lg, 1, plane, i, 0);
-      scanlines.bb1 = get_line (lg, 1, plane, i, 2);
-
-      scanlines.t2 = get_line (lg, 2, plane, i, -1);
-      scanlines.b2 = get_line (lg, 2, plane, i, 1);
+  pl.self = self;
+  pl.dest = dest;
+  pl.lg = lg;
+  pl.cur_field_flags = cur_field_flags;
+  pl.plane = plane;
+  pl.frame_width = GST_VIDEO_FRAME_COMP_WIDTH (dest, plane) *
+      GST_VIDEO_FRAME_COMP_PSTRIDE (dest, plane);
+  pl.copy_scanline = copy_scanline;
+  pl.interpolate_scanline = interpolate_scanline;
 
-      interpolate_scanline (self, LINE (dest, i), &scanlines, frame_width);
-    }
-#undef LINE
-  }
+  gst_deinterlace_simple_method_process_lines (self, frame_height,
+      (LinesFunc) gst_deinterlace_simple_method_deinterlace_lines, &pl);
 }
 
 static void
@@ -743,17 +843,53 @@ gst_deinterlace_simple_method_setup (GstDeinterlaceMethod * method,
           klass->interpolate_scanline_planar_v;
       self->copy_scanline_planar[2] = klass->copy_scanline_planar_v;
       break;
+    case GST_VIDEO_FORMAT_P010_10LE:
+    case GST_VIDEO_FORMAT_P016_LE:
+      self->interpolate_scanline_packed = klass->interpolate_scanline_p010;
+      self->copy_scanline_packed = klass->copy_scanline_p010;
+      self->interpolate_scanline_planar[0] =
+          klass->interpolate_scanline_planar_y_16;
+      self->copy_scanline_planar[0] = klass->copy_scanline_planar_y_16;
+      break;
+    case GST_VIDEO_FORMAT_I420_10LE:
+    case GST_VIDEO_FORMAT_I422_10LE:
+    case GST_VIDEO_FORMAT_Y444_10LE:
+      self->interpolate_scanline_planar[0] =
+          klass->interpolate_scanline_planar_y_16;
+      self->copy_scanline_planar[0] = klass->copy_scanline_planar_y_16;
+      self->interpolate_scanline_planar[1] =
+          klass->interpolate_scanline_planar_u_16;
+      self->copy_scanline_planar[1] = klass->copy_scanline_planar_u_16;
+      self->interpolate_scanline_planar[2] =
+          klass->interpolate_scanline_planar_v_16;
+      self->copy_scanline_planar[2] = klass->copy_scanline_planar_v_16;
+      break;
     default:
       break;
   }
 }
 
+static void
+gst_deinterlace_simple_method_finalize (GObject * object)
+{
+  GstDeinterlaceSimpleMethod *self = GST_DEINTERLACE_SIMPLE_METHOD (object);
+
+  if (self->runner)
+    gst_parallelized_task_runner_free (self->runner);
+
+  G_OBJECT_CLASS (gst_deinterlace_simple_method_parent_class)->finalize
+      (object);
+}
+
 static void
 gst_deinterlace_simple_method_class_init (GstDeinterlaceSimpleMethodClass
     * klass)
 {
+  GObjectClass *gobject_class = (GObjectClass *) klass;
   GstDeinterlaceMethodClass *dm_class = (GstDeinterlaceMethodClass *) klass;
 
+  gobject_class->finalize = gst_deinterlace_simple_method_finalize;
+
   dm_class->deinterlace_frame_ayuv =
       gst_deinterlace_simple_method_deinterlace_frame_packed;
   dm_class->deinterlace_frame_yuy2 =
@@ -788,6 +924,14 @@ gst_deinterlace_simple_method_class_init (GstDeinterlaceSimpleMethodClass
       gst_deinterlace_simple_method_deinterlace_frame_nv12;
   dm_class->deinterlace_frame_nv21 =
       gst_deinterlace_simple_method_deinterlace_frame_nv12;
+  dm_class->deinterlace_frame_p010 =
+      gst_deinterlace_simple_method_deinterlace_frame_nv12;
+  dm_class->deinterlace_frame_i420_10 =
+      gst_deinterlace_simple_method_deinterlace_frame_planar;
+  dm_class->deinterlace_frame_i422_10 =
+      gst_deinterlace_simple_method_deinterlace_frame_planar;
+  dm_class->deinterlace_frame_y444_10 =
+      gst_deinterlace_simple_method_deinterlace_frame_planar;
   dm_class->fields_required = 2;
   dm_class->setup = gst_deinterlace_simple_method_setup;
   dm_class->supported = gst_deinterlace_simple_method_supported;
@@ -71,6 +71,10 @@ struct _GstDeinterlaceMethod {
 
   GstVideoInfo *vinfo;
 
+  /* Maximum number of threads the method may use per frame, 0 for the
+   * number of CPUs. Set by the element. */
+  guint n_threads;
+
   GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame;
 };
 
@@ -100,6 +104,10 @@ struct _GstDeinterlaceMethodClass {
   GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_bgra;
   GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_rgb;
   GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_bgr;
+  GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_p010;
+  GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_i420_10;
+  GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_i422_10;
+  GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_y444_10;
 
   const gchar *name;
   const gchar *nick;
@@ -113,6 +121,7 @@ void gst_deinterlace_method_deinterlace_frame (GstDeinterlaceMethod * self, cons
     int cur_field_idx);
 gint gst_deinterlace_method_get_fields_required (GstDeinterlaceMethod * self);
 gint gst_deinterlace_method_get_latency (GstDeinterlaceMethod * self);
+void gst_deinterlace_method_set_n_threads (GstDeinterlaceMethod * self, guint n_threads);
 
 #define GST_TYPE_DEINTERLACE_SIMPLE_METHOD		(gst_deinterlace_simple_method_get_type ())
 #define GST_IS_DEINTERLACE_SIMPLE_METHOD(obj)		(G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_DEINTERLACE_SIMPLE_METHOD))
@@ -173,6 +182,10 @@ struct _GstDeinterlaceSimpleMethod {
 
   GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar[3];
   GstDeinterlaceSimpleMethodFunction copy_scanline_planar[3];
+
+  /* For processing slices of lines in parallel */
+  GstParallelizedTaskRunner *runner;
+  guint runner_threads;
 };
 
 struct _GstDeinterlaceSimpleMethodClass {
@@ -213,6 +226,19 @@ struct _GstDeinterlaceSimpleMethodClass {
   GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar_u;
   GstDeinterlaceSimpleMethodFunction copy_scanline_planar_v;
   GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar_v;
+
+  /* 16 bit semi-planar formats, the Y plane uses the 16 bit planar
+   * functions. Not set by default. */
+  GstDeinterlaceSimpleMethodFunction interpolate_scanline_p010;
+  GstDeinterlaceSimpleMethodFunction copy_scanline_p010;
+
+  /* 16 bit planar formats. Not set by default. */
+  GstDeinterlaceSimpleMethodFunction copy_scanline_planar_y_16;
+  GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar_y_16;
+  GstDeinterlaceSimpleMethodFunction copy_scanline_planar_u_16;
+  GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar_u_16;
+  GstDeinterlaceSimpleMethodFunction copy_scanline_planar_v_16;
+  GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar_v_16;
 };
 
 GType gst_deinterlace_simple_method_get_type (void);
@@ -0,0 +1,196 @@
+/*
+ * GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include "yadif.h"
+
+#if defined (HAVE_NEON)
+#include <arm_neon.h>
+
+/* 8 bit samples are processed as 16 bit and 16 bit samples as 32 bit
+ * integers so that all intermediate values of the filter fit, which keeps the
+ * output identical to the C version. */
+
+static inline int16x8_t
+load_8 (const guint8 * p)
+{
+  return vreinterpretq_s16_u16 (vmovl_u8 (vld1_u8 (p)));
+}
+
+static inline void
+store_8 (guint8 * p, int16x8_t v)
+{
+  vst1_u8 (p, vqmovun_s16 (v));
+}
+
+static inline int32x4_t
+load_16 (const guint16 * p)
+{
+  return vreinterpretq_s32_u32 (vmovl_u16 (vld1_u16 (p)));
+}
+
+static inline void
+store_16 (guint16 * p, int32x4_t v)
+{
+  vst1_u16 (p, vqmovun_s32 (v));
+}
+
+/* Same as the FILTER macro in yadif.c for @lanes samples at once. The spatial
+ * checks are evaluated for all lanes and only applied to the lanes where the
+ * previous check in the chain succeeded. */
+#define FILTER_LINE(type, vtype, mtype, lanes, colors) \
+  type *sdst = dst; \
+  const type *stzero = tzero, *sbzero = bzero, *smone = mone, *smp = mp; \
+  const type *sttwo = ttwo, *sbtwo = btwo, *stptwo = tptwo, *sbptwo = bptwo; \
+  const type *sttone = ttone, *sttp = ttp, *sbbone = bbone, *sbbp = bbp; \
+  int x; \
+  \
+  for (x = start; x + lanes <= end; x += lanes) { \
+    vtype c = LOAD (stzero + x); \
+    vtype e = LOAD (sbzero + x); \
+    vtype vm1 = LOAD (smone + x); \
+    vtype vmp = LOAD (smp + x); \
+    vtype d = V_HALF (V_ADD (vm1, vmp)); \
+    vtype td0 = V_ABS (V_SUB (vm1, vmp)); \
+    vtype td1 = V_HALF (V_ADD (V_ABS (V_SUB (LOAD (sttwo + x), c)), \
+            V_ABS (V_SUB (LOAD (sbtwo + x), e)))); \
+    vtype td2 = V_HALF (V_ADD (V_ABS (V_SUB (LOAD (stptwo + x), c)), \
+            V_ABS (V_SUB (LOAD (sbptwo + x), e)))); \
+    vtype diff = V_MAX (V_MAX (V_HALF (td0), td1), td2); \
+    vtype pred = V_HALF (V_ADD (c, e)); \
+    vtype score, s; \
+    mtype mask; \
+    \
+    score = V_ADD (V_ADD (V_ABS (V_SUB (LOAD (stzero + x - colors), \
+                LOAD (sbzero + x - colors))), V_ABS (V_SUB (c, e))), \
+        V_ABS (V_SUB (LOAD (stzero + x + colors), \
+                LOAD (sbzero + x + colors)))); \
+    \
+    s = SCORE (-colors, colors); \
+    mask = V_CMPGT (score, s); \
+    score = V_BSL (mask, s, score); \
+    pred = V_BSL (mask, PRED (-colors), pred); \
+    s = SCORE (-2 * colors, colors); \
+    mask = V_AND (mask, V_CMPGT (score, s)); \
+    score = V_BSL (mask, s, score); \
+    pred = V_BSL (mask, PRED (-2 * colors), pred); \
+    \
+    s = SCORE (colors, colors); \
+    mask = V_CMPGT (score, s); \
+    score = V_BSL (mask, s, score); \
+    pred = V_BSL (mask, PRED (colors), pred); \
+    s = SCORE (2 * colors, colors); \
+    mask = V_AND (mask, V_CMPGT (score, s)); \
+    pred = V_BSL (mask, PRED (2 * colors), pred); \
+    \
+    if (!(mode & 2)) { \
+      vtype b = V_HALF (V_ADD (LOAD (sttone + x), LOAD (sttp + x))); \
+      vtype f = V_HALF (V_ADD (LOAD (sbbone + x), LOAD (sbbp + x))); \
+      vtype dc = V_SUB (d, c), de = V_SUB (d, e); \
+      vtype bc = V_SUB (b, c), fe = V_SUB (f, e); \
+      vtype max = V_MAX (V_MAX (de, dc), V_MIN (bc, fe)); \
+      vtype min = V_MIN (V_MIN (de, dc), V_MAX (bc, fe)); \
+      \
+      diff = V_MAX (V_MAX (diff, min), V_NEG (max)); \
+    } \
+    \
+    pred = V_MAX (V_MIN (pred, V_ADD (d, diff)), V_SUB (d, diff)); \
+    STORE (sdst + x, pred); \
+  } \
+  \
+  return x;
+
+#define SCORE(j, colors) \
+  V_ADD (V_ADD ( \
+      V_ABS (V_SUB (LOAD (stzero + x - colors + (j)), \
+              LOAD (sbzero + x - colors - (j)))), \
+      V_ABS (V_SUB (LOAD (stzero + x + (j)), LOAD (sbzero + x - (j))))), \
+      V_ABS (V_SUB (LOAD (stzero + x + colors + (j)), \
+              LOAD (sbzero + x + colors - (j)))))
+
+#define PRED(j) \
+  V_HALF (V_ADD (LOAD (stzero + x + (j)), LOAD (sbzero + x - (j))))
+
+/* 8 bit samples */
+#define LOAD(p) load_8 (p)
+#define STORE(p,v) store_8 (p, v)
+#define V_ADD(a,b) vaddq_s16 (a, b)
+#define V_SUB(a,b) vsubq_s16 (a, b)
+#define V_HALF(a) vshrq_n_s16 (a, 1)
+#define V_ABS(a) vabsq_s16 (a)
+#define V_NEG(a) vnegq_s16 (a)
+#define V_MIN(a,b) vminq_s16 (a, b)
+#define V_MAX(a,b) vmaxq_s16 (a, b)
+#define V_CMPGT(a,b) vcgtq_s16 (a, b)
+#define V_AND(a,b) vandq_u16 (a, b)
+#define V_BSL(m,a,b) vbslq_s16 (m, a, b)
+
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_8_c1_neon)
+{
+  FILTER_LINE (guint8, int16x8_t, uint16x8_t, 8, 1)
+}
+
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_8_c2_neon)
+{
+  FILTER_LINE (guint8, int16x8_t, uint16x8_t, 8, 2)
+}
+
+#undef LOAD
+#undef STORE
+#undef V_ADD
+#undef V_SUB
+#undef V_HALF
+#undef V_ABS
+#undef V_NEG
+#undef V_MIN
+#undef V_MAX
+#undef V_CMPGT
+#undef V_AND
+#undef V_BSL
+
+/* 16 bit samples */
+#define LOAD(p) load_16 (p)
+#define STORE(p,v) store_16 (p, v)
+#define V_ADD(a,b) vaddq_s32 (a, b)
+#define V_SUB(a,b) vsubq_s32 (a, b)
+#define V_HALF(a) vshrq_n_s32 (a, 1)
+#define V_ABS(a) vabsq_s32 (a)
+#define V_NEG(a) vnegq_s32 (a)
+#define V_MIN(a,b) vminq_s32 (a, b)
+#define V_MAX(a,b) vmaxq_s32 (a, b)
+#define V_CMPGT(a,b) vcgtq_s32 (a, b)
+#define V_AND(a,b) vandq_u32 (a, b)
+#define V_BSL(m,a,b) vbslq_s32 (m, a, b)
+
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_16_c1_neon)
+{
+  FILTER_LINE (guint16, int32x4_t, uint32x4_t, 4, 1)
+}
+
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_16_c2_neon)
+{
+  FILTER_LINE (guint16, int32x4_t, uint32x4_t, 4, 2)
+}
+
+#endif /* HAVE_NEON */
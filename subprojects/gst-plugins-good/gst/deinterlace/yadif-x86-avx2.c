@@ -0,0 +1,190 @@
+/*
+ * GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include "yadif.h"
+
+#if defined (HAVE_AVX2) && defined (__AVX2__)
+#include <immintrin.h>
+
+/* 8 bit samples are processed as 16 bit and 16 bit samples as 32 bit
+ * integers so that all intermediate values of the filter fit, which keeps the
+ * output identical to the C version. */
+
+static inline __m256i
+load_8 (const guint8 * p)
+{
+  return _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) p));
+}
+
+static inline void
+store_8 (guint8 * p, __m256i v)
+{
+  v = _mm256_packus_epi16 (v, v);
+  v = _mm256_permute4x64_epi64 (v, 0xd8);
+  _mm_storeu_si128 ((__m128i *) p, _mm256_castsi256_si128 (v));
+}
+
+static inline __m256i
+load_16 (const guint16 * p)
+{
+  return _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *) p));
+}
+
+static inline void
+store_16 (guint16 * p, __m256i v)
+{
+  v = _mm256_packus_epi32 (v, v);
+  v = _mm256_permute4x64_epi64 (v, 0xd8);
+  _mm_storeu_si128 ((__m128i *) p, _mm256_castsi256_si128 (v));
+}
+
+/* Same as the FILTER macro in yadif.c for @lanes samples at once. The spatial
+ * checks are evaluated for all lanes and only applied to the lanes where the
+ * previous check in the chain succeeded. */
+#define FILTER_LINE(type, lanes, colors) \
+  type *sdst = dst; \
+  const type *stzero = tzero, *sbzero = bzero, *smone = mone, *smp = mp; \
+  const type *sttwo = ttwo, *sbtwo = btwo, *stptwo = tptwo, *sbptwo = bptwo; \
+  const type *sttone = ttone, *sttp = ttp, *sbbone = bbone, *sbbp = bbp; \
+  int x; \
+  \
+  for (x = start; x + lanes <= end; x += lanes) { \
+    __m256i c = LOAD (stzero + x); \
+    __m256i e = LOAD (sbzero + x); \
+    __m256i vm1 = LOAD (smone + x); \
+    __m256i vmp = LOAD (smp + x); \
+    __m256i d = V_HALF (V_ADD (vm1, vmp)); \
+    __m256i td0 = V_ABS (V_SUB (vm1, vmp)); \
+    __m256i td1 = V_HALF (V_ADD (V_ABS (V_SUB (LOAD (sttwo + x), c)), \
+            V_ABS (V_SUB (LOAD (sbtwo + x), e)))); \
+    __m256i td2 = V_HALF (V_ADD (V_ABS (V_SUB (LOAD (stptwo + x), c)), \
+            V_ABS (V_SUB (LOAD (sbptwo + x), e)))); \
+    __m256i diff = V_MAX (V_MAX (V_HALF (td0), td1), td2); \
+    __m256i pred = V_HALF (V_ADD (c, e)); \
+    __m256i score, s, mask; \
+    \
+    score = V_ADD (V_ADD (V_ABS (V_SUB (LOAD (stzero + x - colors), \
+                LOAD (sbzero + x - colors))), V_ABS (V_SUB (c, e))), \
+        V_ABS (V_SUB (LOAD (stzero + x + colors), \
+                LOAD (sbzero + x + colors)))); \
+    \
+    s = SCORE (-colors, colors); \
+    mask = V_CMPGT (score, s); \
+    score = _mm256_blendv_epi8 (score, s, mask); \
+    pred = _mm256_blendv_epi8 (pred, PRED (-colors), mask); \
+    s = SCORE (-2 * colors, colors); \
+    mask = _mm256_and_si256 (mask, V_CMPGT (score, s)); \
+    score = _mm256_blendv_epi8 (score, s, mask); \
+    pred = _mm256_blendv_epi8 (pred, PRED (-2 * colors), mask); \
+    \
+    s = SCORE (colors, colors); \
+    mask = V_CMPGT (score, s); \
+    score = _mm256_blendv_epi8 (score, s, mask); \
+    pred = _mm256_blendv_epi8 (pred, PRED (colors), mask); \
+    s = SCORE (2 * colors, colors); \
+    mask = _mm256_and_si256 (mask, V_CMPGT (score, s)); \
+    pred = _mm256_blendv_epi8 (pred, PRED (2 * colors), mask); \
+    \
+    if (!(mode & 2)) { \
+      __m256i b = V_HALF (V_ADD (LOAD (sttone + x), LOAD (sttp + x))); \
+      __m256i f = V_HALF (V_ADD (LOAD (sbbone + x), LOAD (sbbp + x))); \
+      __m256i dc = V_SUB (d, c), de = V_SUB (d, e); \
+      __m256i bc = V_SUB (b, c), fe = V_SUB (f, e); \
+      __m256i max = V_MAX (V_MAX (de, dc), V_MIN (bc, fe)); \
+      __m256i min = V_MIN (V_MIN (de, dc), V_MAX (bc, fe)); \
+      \
+      diff = V_MAX (V_MAX (diff, min), V_SUB (_mm256_setzero_si256 (), max)); \
+    } \
+    \
+    pred = V_MAX (V_MIN (pred, V_ADD (d, diff)), V_SUB (d, diff)); \
+    STORE (sdst + x, pred); \
+  } \
+  \
+  return x;
+
+#define SCORE(j, colors) \
+  V_ADD (V_ADD ( \
+      V_ABS (V_SUB (LOAD (stzero + x - colors + (j)), \
+              LOAD (sbzero + x - colors - (j)))), \
+      V_ABS (V_SUB (LOAD (stzero + x + (j)), LOAD (sbzero + x - (j))))), \
+      V_ABS (V_SUB (LOAD (stzero + x + colors + (j)), \
+              LOAD (sbzero + x + colors - (j)))))
+
+#define PRED(j) \
+  V_HALF (V_ADD (LOAD (stzero + x + (j)), LOAD (sbzero + x - (j))))
+
+/* 8 bit samples */
+#define LOAD(p) load_8 (p)
+#define STORE(p,v) store_8 (p, v)
+#define V_ADD(a,b) _mm256_add_epi16 (a, b)
+#define V_SUB(a,b) _mm256_sub_epi16 (a, b)
+#define V_HALF(a) _mm256_srai_epi16 (a, 1)
+#define V_ABS(a) _mm256_abs_epi16 (a)
+#define V_MIN(a,b) _mm256_min_epi16 (a, b)
+#define V_MAX(a,b) _mm256_max_epi16 (a, b)
+#define V_CMPGT(a,b) _mm256_cmpgt_epi16 (a, b)
+
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_8_c1_avx2)
+{
+  FILTER_LINE (guint8, 16, 1)
+}
+
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_8_c2_avx2)
+{
+  FILTER_LINE (guint8, 16, 2)
+}
+
+#undef LOAD
+#undef STORE
+#undef V_ADD
+#undef V_SUB
+#undef V_HALF
+#undef V_ABS
+#undef V_MIN
+#undef V_MAX
+#undef V_CMPGT
+
+/* 16 bit samples */
+#define LOAD(p) load_16 (p)
+#define STORE(p,v) store_16 (p, v)
+#define V_ADD(a,b) _mm256_add_epi32 (a, b)
+#define V_SUB(a,b) _mm256_sub_epi32 (a, b)
+#define V_HALF(a) _mm256_srai_epi32 (a, 1)
+#define V_ABS(a) _mm256_abs_epi32 (a)
+#define V_MIN(a,b) _mm256_min_epi32 (a, b)
+#define V_MAX(a,b) _mm256_max_epi32 (a, b)
+#define V_CMPGT(a,b) _mm256_cmpgt_epi32 (a, b)
+
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_16_c1_avx2)
+{
+  FILTER_LINE (guint16, 8, 1)
+}
+
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_16_c2_avx2)
+{
+  FILTER_LINE (guint16, 8, 2)
+}
+
+#endif /* HAVE_AVX2 && __AVX2__ */
@@ -96,6 +96,14 @@ static void
 filter_scanline_yadif_packed_3 (GstDeinterlaceSimpleMethod * self,
     guint8 * out, const GstDeinterlaceScanlineData * scanlines, guint size);
 
+static void
+filter_scanline_yadif_planar_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * scanlines, guint size);
+
+static void
+filter_scanline_yadif_semiplanar_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * scanlines, guint size);
+
 static void
 filter_line_c_planar_mode0 (void *ORC_RESTRICT dst,
     const void *ORC_RESTRICT tzero, const void *ORC_RESTRICT bzero,
@@ -130,6 +138,11 @@ static void (*filter_mode0) (void *ORC_RESTRICT dst,
     const void *ORC_RESTRICT ttone, const void *ORC_RESTRICT ttp,
     const void *ORC_RESTRICT bbone, const void *ORC_RESTRICT bbp, int w);
 
+/* Optional SIMD versions of filter_line_c(), NULL if not available */
+static GstYadifFilterLineFunc filter_line_8_c1;
+static GstYadifFilterLineFunc filter_line_8_c2;
+static GstYadifFilterLineFunc filter_line_16_c1;
+static GstYadifFilterLineFunc filter_line_16_c2;
 
 static void
 copy_scanline (GstDeinterlaceSimpleMethod * self, guint8 * out,
@@ -166,6 +179,10 @@ static void
   dism_class->copy_scanline_bgr = copy_scanline;
   dism_class->copy_scanline_nv12 = copy_scanline;
   dism_class->copy_scanline_nv21 = copy_scanline;
+  dism_class->copy_scanline_p010 = copy_scanline;
+  dism_class->copy_scanline_planar_y_16 = copy_scanline;
+  dism_class->copy_scanline_planar_u_16 = copy_scanline;
+  dism_class->copy_scanline_planar_v_16 = copy_scanline;
 
   dism_class->interpolate_scanline_planar_y = filter_scanline_yadif_planar;
   dism_class->interpolate_scanline_planar_u = filter_scanline_yadif_planar;
@@ -182,6 +199,13 @@ static void
   dism_class->interpolate_scanline_bgr = filter_scanline_yadif_packed_3;
   dism_class->interpolate_scanline_nv12 = filter_scanline_yadif_semiplanar;
   dism_class->interpolate_scanline_nv21 = filter_scanline_yadif_semiplanar;
+  dism_class->interpolate_scanline_p010 = filter_scanline_yadif_semiplanar_16;
+  dism_class->interpolate_scanline_planar_y_16 =
+      filter_scanline_yadif_planar_16;
+  dism_class->interpolate_scanline_planar_u_16 =
+      filter_scanline_yadif_planar_16;
+  dism_class->interpolate_scanline_planar_v_16 =
+      filter_scanline_yadif_planar_16;
 }
 
 #define FFABS(a) ABS(a)
@@ -343,6 +367,98 @@ filter_edges (guint8 * sdst, const guint8 * stzero, const guint8 * sbzero,
       FILTER (w - border, w, 0)
 }
 
+ALWAYS_INLINE static void
+filter_line_c_16 (guint16 * sdst, const guint16 * stzero,
+    const guint16 * sbzero, const guint16 * smone, const guint16 * smp,
+    const guint16 * sttwo, const guint16 * sbtwo, const guint16 * stptwo,
+    const guint16 * sbptwo, const guint16 * sttone, const guint16 * sttp,
+    const guint16 * sbbone, const guint16 * sbbp, int w, int colors,
+    int start, int end, int mode)
+{
+  int x;
+  const int y_alternates_every = 0;
+
+  FILTER (start, end, 1)
+}
+
+ALWAYS_INLINE static void
+filter_edges_16 (guint16 * sdst, const guint16 * stzero,
+    const guint16 * sbzero, const guint16 * smone, const guint16 * smp,
+    const guint16 * sttwo, const guint16 * sbtwo, const guint16 * stptwo,
+    const guint16 * sbptwo, const guint16 * sttone, const guint16 * sttp,
+    const guint16 * sbbone, const guint16 * sbbp, int w, int colors, int mode)
+{
+  int x;
+  const int y_alternates_every = 0;
+  const int bpp = 2;
+  const int edge = colors * (MAX_ALIGN / bpp);
+  const int border = 3 * colors;
+
+  FILTER (0, border, 0)
+      FILTER (w - edge, w - border, 1)
+      FILTER (w - border, w, 0)
+}
+
+ALWAYS_INLINE static void
+filter_scanline_yadif_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * s_orig, guint size,
+    int colors)
+{
+  guint16 *dst = (guint16 *) out;
+  const int bpp = 2;
+  int w = size / bpp;
+  int edge = colors * MAX_ALIGN / bpp;
+  int x = colors * 3;
+  GstDeinterlaceScanlineData s = *s_orig;
+  GstYadifFilterLineFunc filter_line_simd =
+      colors == 1 ? filter_line_16_c1 : filter_line_16_c2;
+
+  int mode = (s.tt1 == NULL || s.bb1 == NULL || s.ttp == NULL
+      || s.bbp == NULL) ? 2 : 0;
+
+  /* When starting up, some data might not yet be available, so use the current frame */
+  if (s.m1 == NULL)
+    s.m1 = s.mp;
+  if (s.tt1 == NULL)
+    s.tt1 = s.ttp;
+  if (s.bb1 == NULL)
+    s.bb1 = s.bbp;
+  if (s.t2 == NULL)
+    s.t2 = s.tp2;
+  if (s.b2 == NULL)
+    s.b2 = s.bp2;
+
+  filter_edges_16 (dst, (const guint16 *) s.t0, (const guint16 *) s.b0,
+      (const guint16 *) s.m1, (const guint16 *) s.mp, (const guint16 *) s.t2,
+      (const guint16 *) s.b2, (const guint16 *) s.tp2,
+      (const guint16 *) s.bp2, (const guint16 *) s.tt1,
+      (const guint16 *) s.ttp, (const guint16 *) s.bb1,
+      (const guint16 *) s.bbp, w, colors, mode);
+  if (filter_line_simd)
+    x = filter_line_simd (dst, s.t0, s.b0, s.m1, s.mp, s.t2, s.b2, s.tp2,
+        s.bp2, s.tt1, s.ttp, s.bb1, s.bbp, x, w - edge, mode);
+  filter_line_c_16 (dst, (const guint16 *) s.t0, (const guint16 *) s.b0,
+      (const guint16 *) s.m1, (const guint16 *) s.mp, (const guint16 *) s.t2,
+      (const guint16 *) s.b2, (const guint16 *) s.tp2,
+      (const guint16 *) s.bp2, (const guint16 *) s.tt1,
+      (const guint16 *) s.ttp, (const guint16 *) s.bb1,
+      (const guint16 *) s.bbp, w, colors, x, w - edge, mode);
+}
+
+static void
+filter_scanline_yadif_planar_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * s_orig, guint size)
+{
+  filter_scanline_yadif_16 (self, out, s_orig, size, 1);
+}
+
+static void
+filter_scanline_yadif_semiplanar_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * s_orig, guint size)
+{
+  filter_scanline_yadif_16 (self, out, s_orig, size, 2);
+}
+
 static void
 filter_scanline_yadif_semiplanar (GstDeinterlaceSimpleMethod * self,
     guint8 * out, const GstDeinterlaceScanlineData * s_orig, guint size)
@@ -384,9 +500,10 @@ filter_scanline_yadif (GstDeinterlaceSimpleMethod * self,
     int colors, int y_alternates_every)
 {
   guint8 *dst = out;
-  const int bpp = 1;            // Hard code 8-bit atm
+  const int bpp = 1;
   int w = size / bpp;
   int edge = colors * MAX_ALIGN / bpp;
+  int x = colors * 3;
   GstDeinterlaceScanlineData s = *s_orig;
 
   int mode = (s.tt1 == NULL || s.bb1 == NULL || s.ttp == NULL
@@ -406,9 +523,11 @@ filter_scanline_yadif (GstDeinterlaceSimpleMethod * self,
 
   filter_edges (dst, s.t0, s.b0, s.m1, s.mp, s.t2, s.b2, s.tp2, s.bp2, s.tt1,
       s.ttp, s.bb1, s.bbp, w, colors, y_alternates_every, mode, bpp);
+  if (colors == 2 && y_alternates_every == 0 && filter_line_8_c2)
+    x = filter_line_8_c2 (dst, s.t0, s.b0, s.m1, s.mp, s.t2, s.b2, s.tp2,
+        s.bp2, s.tt1, s.ttp, s.bb1, s.bbp, x, w - edge, mode);
   filter_line_c (dst, s.t0, s.b0, s.m1, s.mp, s.t2, s.b2, s.tp2, s.bp2, s.tt1,
-      s.ttp, s.bb1, s.bbp, w, colors, y_alternates_every, colors * 3, w - edge,
-      mode);
+      s.ttp, s.bb1, s.bbp, w, colors, y_alternates_every, x, w - edge, mode);
 }
 
 ALWAYS_INLINE static void
@@ -438,7 +557,13 @@ filter_scanline_yadif_planar (GstDeinterlaceSimpleMethod * self,
 
   filter_edges (dst, s.t0, s.b0, s.m1, s.mp, s.t2, s.b2, s.tp2, s.bp2, s.tt1,
       s.ttp, s.bb1, s.bbp, w, 1, 0, mode, bpp);
-  if (mode == 0)
+  if (filter_line_8_c1) {
+    int x = filter_line_8_c1 (dst, s.t0, s.b0, s.m1, s.mp, s.t2, s.b2, s.tp2,
+        s.bp2, s.tt1, s.ttp, s.bb1, s.bbp, 3, w - edge, mode);
+
+    filter_line_c (dst, s.t0, s.b0, s.m1, s.mp, s.t2, s.b2, s.tp2, s.bp2,
+        s.tt1, s.ttp, s.bb1, s.bbp, w, 1, 0, x, w - edge, mode);
+  } else if (mode == 0)
     filter_mode0 (dst, (void *) s.t0, (void *) s.b0, (void *) s.m1,
         (void *) s.mp, (void *) s.t2, (void *) s.b2, (void *) s.tp2,
         (void *) s.bp2, (void *) s.tt1, (void *) s.ttp, (void *) s.bb1,
@@ -478,4 +603,20 @@ gst_deinterlace_method_yadif_init (GstDeinterlaceMethodYadif * self)
     filter_mode2 = filter_line_c_planar_mode2;
   }
 #endif
+
+#if defined HAVE_AVX2 && (defined __GNUC__ || defined __clang__)
+  if (__builtin_cpu_supports ("avx2")) {
+    GST_DEBUG ("AVX2 optimization enabled");
+    filter_line_8_c1 = gst_yadif_filter_line_8_c1_avx2;
+    filter_line_8_c2 = gst_yadif_filter_line_8_c2_avx2;
+    filter_line_16_c1 = gst_yadif_filter_line_16_c1_avx2;
+    filter_line_16_c2 = gst_yadif_filter_line_16_c2_avx2;
+  }
+#elif defined HAVE_NEON
+  GST_DEBUG ("NEON optimization enabled");
+  filter_line_8_c1 = gst_yadif_filter_line_8_c1_neon;
+  filter_line_8_c2 = gst_yadif_filter_line_8_c2_neon;
+  filter_line_16_c1 = gst_yadif_filter_line_16_c1_neon;
+  filter_line_16_c2 = gst_yadif_filter_line_16_c2_neon;
+#endif
 }
@@ -45,4 +45,35 @@ gst_yadif_filter_line_mode2_ssse3 (void *dst, const void *tzero, const void *bze
     const void *mone, const void *mp, const void *ttwo, const void *btwo, const void *tptwo, const void *bptwo,
     const void *ttone, const void *ttp, const void *bbone, const void *bbp, int w);
 
+/* SIMD versions of the main filter loop. They filter from @start on in whole
+ * vectors, never going past @end, and return the position up to which the
+ * line was filtered. The _8 variants work on 8 bit and the _16 variants on
+ * 16 bit samples, _c1 on planes with one and _c2 on planes with two
+ * interleaved components. */
+typedef int (*GstYadifFilterLineFunc) (void *dst, const void *tzero,
+    const void *bzero, const void *mone, const void *mp, const void *ttwo,
+    const void *btwo, const void *tptwo, const void *bptwo, const void *ttone,
+    const void *ttp, const void *bbone, const void *bbp, int start, int end,
+    int mode);
+
+#define YADIF_DECLARE_FILTER_LINE(name) \
+int \
+name (void *dst, const void *tzero, const void *bzero, \
+    const void *mone, const void *mp, const void *ttwo, const void *btwo, const void *tptwo, const void *bptwo, \
+    const void *ttone, const void *ttp, const void *bbone, const void *bbp, int start, int end, int mode)
+
+#ifdef HAVE_AVX2
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_8_c1_avx2);
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_8_c2_avx2);
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_16_c1_avx2);
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_16_c2_avx2);
+#endif
+
+#ifdef HAVE_NEON
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_8_c1_neon);
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_8_c2_neon);
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_16_c1_neon);
+YADIF_DECLARE_FILTER_LINE (gst_yadif_filter_line_16_c2_neon);
+#endif
+
 #endif
@@ -40,6 +40,15 @@ GST_DEBUG_CATEGORY (equalizer_debug);
 #define BANDS_LOCK(equ) g_mutex_lock(&equ->bands_lock)
 #define BANDS_UNLOCK(equ) g_mutex_unlock(&equ->bands_lock)
 
+/* size of a block of channels that is processed in parallel */
+#define EQ_BLOCK_BYTES 32
+
+enum
+{
+  PROP_0,
+  PROP_SINGLE_PRECISION
+};
+
 static void gst_iir_equalizer_child_proxy_interface_init (gpointer g_iface,
     gpointer iface_data);
 
@@ -50,6 +59,9 @@ static gboolean gst_iir_equalizer_setup (GstAudioFilter * filter,
 static GstFlowReturn gst_iir_equalizer_transform_ip (GstBaseTransform * btrans,
     GstBuffer * buf);
 static void set_passthrough (GstIirEqualizer * equ);
+static gboolean select_process_func (GstIirEqualizer * equ,
+    GstAudioFormat format);
+static void alloc_history (GstIirEqualizer * equ, const GstAudioInfo * info);
 
 #define ALLOWED_CAPS \
     "audio/x-raw,"                                                \
@@ -355,6 +367,55 @@ gst_iir_equalizer_child_proxy_interface_init (gpointer g_iface,
 
 /* equalizer implementation */
 
+static void
+gst_iir_equalizer_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstIirEqualizer *equ = GST_IIR_EQUALIZER (object);
+
+  switch (prop_id) {
+    case PROP_SINGLE_PRECISION:{
+      gboolean single_precision = g_value_get_boolean (value);
+      GstAudioFormat format;
+
+      /* the history layout depends on the precision */
+      GST_BASE_TRANSFORM_LOCK (equ);
+      BANDS_LOCK (equ);
+      if (equ->single_precision != single_precision) {
+        equ->single_precision = single_precision;
+        format = GST_AUDIO_FILTER_FORMAT (equ);
+        if (format != GST_AUDIO_FORMAT_UNKNOWN
+            && select_process_func (equ, format))
+          alloc_history (equ, GST_AUDIO_FILTER_INFO (equ));
+      }
+      BANDS_UNLOCK (equ);
+      GST_BASE_TRANSFORM_UNLOCK (equ);
+      break;
+    }
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_iir_equalizer_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstIirEqualizer *equ = GST_IIR_EQUALIZER (object);
+
+  switch (prop_id) {
+    case PROP_SINGLE_PRECISION:
+      BANDS_LOCK (equ);
+      g_value_set_boolean (value, equ->single_precision);
+      BANDS_UNLOCK (equ);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 static void
 gst_iir_equalizer_class_init (GstIirEqualizerClass * klass)
 {
@@ -363,8 +424,26 @@ gst_iir_equalizer_class_init (GstIirEqualizerClass * klass)
   GObjectClass *gobject_class = (GObjectClass *) klass;
   GstCaps *caps;
 
+  gobject_class->set_property = gst_iir_equalizer_set_property;
+  gobject_class->get_property = gst_iir_equalizer_get_property;
   gobject_class->finalize = gst_iir_equalizer_finalize;
   audio_filter_class->setup = gst_iir_equalizer_setup;
+
+  /**
+   * GstIirEqualizer:single-precision:
+   *
+   * Filter 16 bit integer and 32 bit float audio in single instead of double
+   * precision. This processes twice as many channels in parallel but is less
+   * accurate, in particular for bands at very low frequencies. 64 bit float
+   * audio is always filtered in double precision.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_SINGLE_PRECISION,
+      g_param_spec_boolean ("single-precision", "Single Precision",
+          "Filter in single instead of double precision", FALSE,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
   btrans_class->transform_ip = gst_iir_equalizer_transform_ip;
   btrans_class->transform_ip_on_passthrough = FALSE;
 
@@ -620,10 +699,13 @@ update_coefficients (GstIirEqualizer * equ)
 static void
 alloc_history (GstIirEqualizer * equ, const GstAudioInfo * info)
 {
+  guint block = EQ_BLOCK_BYTES / MAX (equ->history_size, 1);
+
   /* free + alloc = no memcpy */
   g_free (equ->history);
   equ->history =
-      g_malloc0 (equ->history_size * GST_AUDIO_INFO_CHANNELS (info) *
+      g_malloc0 (equ->history_size * 4 *
+      GST_ROUND_UP_N (GST_AUDIO_INFO_CHANNELS (info), block) *
       equ->freq_band_count);
 }
 
@@ -717,108 +799,262 @@ gst_iir_equalizer_compute_frequencies (GstIirEqualizer * equ, guint new_count)
 
 /* start of code that is type specific */
 
-#define CREATE_OPTIMIZED_FUNCTIONS_INT(TYPE,BIG_TYPE,MIN_VAL,MAX_VAL)   \
-typedef struct {                                                        \
-  BIG_TYPE x1, x2;          /* history of input values for a filter */  \
-  BIG_TYPE y1, y2;          /* history of output values for a filter */ \
-} SecondOrderHistory ## TYPE;                                           \
-                                                                        \
-static inline BIG_TYPE                                                  \
-one_step_ ## TYPE (GstIirEqualizerBand *filter,                         \
-    SecondOrderHistory ## TYPE *history, BIG_TYPE input)                \
+/* The bands are run as a cascade over blocks of EQ_BLOCK_BYTES worth of
+ * channels that are filtered in parallel SIMD lanes. A block is
+ * deinterleaved into a scratch buffer of up to EQ_CHUNK_FRAMES frames and
+ * then filtered one band at a time so that the history of a band stays in
+ * registers for the whole chunk.
+ *
+ * The history of every band is stored as four rows (x1, x2, y1, y2) with one
+ * value per channel, rounded up to a whole block. */
+#define EQ_CHUNK_FRAMES 64
+
+#if defined (__SSE2__) || defined (_M_X64)
+#include <emmintrin.h>
+#define EQ_SIMD 1
+typedef __m128 v4sf;
+typedef __m128d v2df;
+#define VF_LOAD(p) _mm_loadu_ps (p)
+#define VF_STORE(p,v) _mm_storeu_ps (p, v)
+#define VF_SET1(f) _mm_set1_ps (f)
+#define VF_ADD(a,b) _mm_add_ps (a, b)
+#define VF_MUL(a,b) _mm_mul_ps (a, b)
+#define VD_LOAD(p) _mm_loadu_pd (p)
+#define VD_STORE(p,v) _mm_storeu_pd (p, v)
+#define VD_SET1(d) _mm_set1_pd (d)
+#define VD_ADD(a,b) _mm_add_pd (a, b)
+#define VD_MUL(a,b) _mm_mul_pd (a, b)
+#elif defined (__aarch64__)
+#include <arm_neon.h>
+#define EQ_SIMD 1
+typedef float32x4_t v4sf;
+typedef float64x2_t v2df;
+#define VF_LOAD(p) vld1q_f32 (p)
+#define VF_STORE(p,v) vst1q_f32 (p, v)
+#define VF_SET1(f) vdupq_n_f32 (f)
+#define VF_ADD(a,b) vaddq_f32 (a, b)
+#define VF_MUL(a,b) vmulq_f32 (a, b)
+#define VD_LOAD(p) vld1q_f64 (p)
+#define VD_STORE(p,v) vst1q_f64 (p, v)
+#define VD_SET1(d) vdupq_n_f64 (d)
+#define VD_ADD(a,b) vaddq_f64 (a, b)
+#define VD_MUL(a,b) vmulq_f64 (a, b)
+#endif
+
+#ifdef EQ_SIMD
+/* A block is two vectors, which also gives two independent dependency
+ * chains per band */
+#define CREATE_CASCADE_FUNC(ctype,vtype,V)                              \
+static void                                                             \
+cascade_block_ ## ctype (GstIirEqualizer *equ, g ## ctype *s,           \
+    guint frames, g ## ctype *history, guint stride)                    \
 {                                                                       \
-  /* calculate output */                                                \
-  BIG_TYPE output = filter->a0 * input +                                \
-      filter->a1 * history->x1 + filter->a2 * history->x2 +             \
-      filter->b1 * history->y1 + filter->b2 * history->y2;              \
-  /* update history */                                                  \
-  history->y2 = history->y1;                                            \
-  history->y1 = output;                                                 \
-  history->x2 = history->x1;                                            \
-  history->x1 = input;                                                  \
+  const guint w = sizeof (vtype) / sizeof (g ## ctype);                 \
+  guint f, i, nf = equ->freq_band_count;                                \
+                                                                        \
+  for (f = 0; f < nf; f++) {                                            \
+    GstIirEqualizerBand *filter = equ->bands[f];                        \
+    g ## ctype *h = history + 4 * f * stride;                           \
+    vtype a0 = V ## _SET1 ((g ## ctype) filter->a0);                    \
+    vtype a1 = V ## _SET1 ((g ## ctype) filter->a1);                    \
+    vtype a2 = V ## _SET1 ((g ## ctype) filter->a2);                    \
+    vtype b1 = V ## _SET1 ((g ## ctype) filter->b1);                    \
+    vtype b2 = V ## _SET1 ((g ## ctype) filter->b2);                    \
+    vtype x1a = V ## _LOAD (h), x1b = V ## _LOAD (h + w);               \
+    vtype x2a = V ## _LOAD (h + stride);                                \
+    vtype x2b = V ## _LOAD (h + stride + w);                            \
+    vtype y1a = V ## _LOAD (h + 2 * stride);                            \
+    vtype y1b = V ## _LOAD (h + 2 * stride + w);                        \
+    vtype y2a = V ## _LOAD (h + 3 * stride);                            \
+    vtype y2b = V ## _LOAD (h + 3 * stride + w);                        \
                                                                         \
-  return output;                                                        \
-}                                                                       \
+    for (i = 0; i < frames; i++) {                                      \
+      g ## ctype *p = s + 2 * w * i;                                    \
+      vtype ina = V ## _LOAD (p), inb = V ## _LOAD (p + w);             \
+      vtype outa, outb;                                                 \
                                                                         \
-static const guint                                                      \
-history_size_ ## TYPE = sizeof (SecondOrderHistory ## TYPE);            \
+      outa = V ## _ADD (V ## _ADD (V ## _ADD (V ## _ADD (               \
+                      V ## _MUL (a0, ina), V ## _MUL (a1, x1a)),        \
+                  V ## _MUL (a2, x2a)), V ## _MUL (b1, y1a)),           \
+          V ## _MUL (b2, y2a));                                         \
+      outb = V ## _ADD (V ## _ADD (V ## _ADD (V ## _ADD (               \
+                      V ## _MUL (a0, inb), V ## _MUL (a1, x1b)),        \
+                  V ## _MUL (a2, x2b)), V ## _MUL (b1, y1b)),           \
+          V ## _MUL (b2, y2b));                                         \
+      x2a = x1a;                                                        \
+      x2b = x1b;                                                        \
+      x1a = ina;                                                        \
+      x1b = inb;                                                        \
+      y2a = y1a;                                                        \
+      y2b = y1b;                                                        \
+      y1a = outa;                                                       \
+      y1b = outb;                                                       \
+      V ## _STORE (p, outa);                                            \
+      V ## _STORE (p + w, outb);                                        \
+    }                                                                   \
                                                                         \
+    V ## _STORE (h, x1a);                                               \
+    V ## _STORE (h + w, x1b);                                           \
+    V ## _STORE (h + stride, x2a);                                      \
+    V ## _STORE (h + stride + w, x2b);                                  \
+    V ## _STORE (h + 2 * stride, y1a);                                  \
+    V ## _STORE (h + 2 * stride + w, y1b);                              \
+    V ## _STORE (h + 3 * stride, y2a);                                  \
+    V ## _STORE (h + 3 * stride + w, y2b);                              \
+  }                                                                     \
+}
+
+CREATE_CASCADE_FUNC (float, v4sf, VF);
+CREATE_CASCADE_FUNC (double, v2df, VD);
+#else
+#define CREATE_CASCADE_FUNC(ctype)                                      \
 static void                                                             \
-gst_iir_equ_process_ ## TYPE (GstIirEqualizer *equ, guint8 *data,       \
-guint size, guint channels)                                             \
+cascade_block_ ## ctype (GstIirEqualizer *equ, g ## ctype *s,           \
+    guint frames, g ## ctype *history, guint stride)                    \
 {                                                                       \
-  guint frames = size / channels / sizeof (TYPE);                       \
-  guint i, c, f, nf = equ->freq_band_count;                             \
-  BIG_TYPE cur;                                                         \
-  GstIirEqualizerBand **filters = equ->bands;                           \
+  const guint block = EQ_BLOCK_BYTES / sizeof (g ## ctype);             \
+  guint f, i, l, nf = equ->freq_band_count;                             \
+                                                                        \
+  for (f = 0; f < nf; f++) {                                            \
+    GstIirEqualizerBand *filter = equ->bands[f];                        \
+    g ## ctype a0 = filter->a0, a1 = filter->a1, a2 = filter->a2;       \
+    g ## ctype b1 = filter->b1, b2 = filter->b2;                        \
+    g ## ctype *h = history + 4 * f * stride;                           \
                                                                         \
-  for (i = 0; i < frames; i++) {                                        \
-    SecondOrderHistory ## TYPE *history = equ->history;                 \
-    for (c = 0; c < channels; c++) {                                    \
-      cur = *((TYPE *) data);                                           \
-      for (f = 0; f < nf; f++) {                                        \
-        cur = one_step_ ## TYPE (filters[f], history, cur);             \
-        history++;                                                      \
+    for (l = 0; l < block; l++) {                                       \
+      g ## ctype x1 = h[l], x2 = h[stride + l];                         \
+      g ## ctype y1 = h[2 * stride + l], y2 = h[3 * stride + l];        \
+                                                                        \
+      for (i = 0; i < frames; i++) {                                    \
+        g ## ctype in = s[i * block + l];                               \
+        g ## ctype out = a0 * in + a1 * x1 + a2 * x2 + b1 * y1 +        \
+            b2 * y2;                                                    \
+        x2 = x1;                                                        \
+        x1 = in;                                                        \
+        y2 = y1;                                                        \
+        y1 = out;                                                       \
+        s[i * block + l] = out;                                         \
       }                                                                 \
-      cur = CLAMP (cur, MIN_VAL, MAX_VAL);                              \
-      *((TYPE *) data) = (TYPE) floor (cur);                            \
-      data += sizeof (TYPE);                                            \
+      h[l] = x1;                                                        \
+      h[stride + l] = x2;                                               \
+      h[2 * stride + l] = y1;                                           \
+      h[3 * stride + l] = y2;                                           \
     }                                                                   \
   }                                                                     \
 }
 
-#define CREATE_OPTIMIZED_FUNCTIONS(TYPE)                                \
-typedef struct {                                                        \
-  TYPE x1, x2;          /* history of input values for a filter */  \
-  TYPE y1, y2;          /* history of output values for a filter */ \
-} SecondOrderHistory ## TYPE;                                           \
-                                                                        \
-static inline TYPE                                                      \
-one_step_ ## TYPE (GstIirEqualizerBand *filter,                         \
-    SecondOrderHistory ## TYPE *history, TYPE input)                    \
+CREATE_CASCADE_FUNC (float);
+CREATE_CASCADE_FUNC (double);
+#endif
+
+#define CREATE_OPTIMIZED_FUNCTIONS_INT(TYPE,ctype,MIN_VAL,MAX_VAL)      \
+static void                                                             \
+gst_iir_equ_process_ ## TYPE ## _ ## ctype (GstIirEqualizer *equ,       \
+    guint8 *data, guint size, guint channels)                           \
 {                                                                       \
-  /* calculate output */                                                \
-  TYPE output = filter->a0 * input + filter->a1 * history->x1 +         \
-      filter->a2 * history->x2 + filter->b1 * history->y1 +             \
-      filter->b2 * history->y2;                                         \
-  /* update history */                                                  \
-  history->y2 = history->y1;                                            \
-  history->y1 = output;                                                 \
-  history->x2 = history->x1;                                            \
-  history->x1 = input;                                                  \
-                                                                        \
-  return output;                                                        \
-}                                                                       \
+  const guint block = EQ_BLOCK_BYTES / sizeof (g ## ctype);             \
+  guint frames = size / channels / sizeof (TYPE);                       \
+  guint stride = GST_ROUND_UP_N (channels, block);                      \
+  guint c, i, l, n, pos, len;                                           \
+  g ## ctype s[EQ_CHUNK_FRAMES * EQ_BLOCK_BYTES / sizeof (g ## ctype)]; \
                                                                         \
-static const guint                                                      \
-history_size_ ## TYPE = sizeof (SecondOrderHistory ## TYPE);            \
+  for (c = 0; c < channels; c += block) {                               \
+    n = MIN (block, channels - c);                                      \
+    for (pos = 0; pos < frames; pos += len) {                           \
+      TYPE *p = (TYPE *) data + pos * channels + c;                     \
                                                                         \
+      len = MIN (EQ_CHUNK_FRAMES, frames - pos);                        \
+      for (i = 0; i < len; i++) {                                       \
+        for (l = 0; l < n; l++)                                         \
+          s[i * block + l] = p[i * channels + l];                       \
+        for (; l < block; l++)                                          \
+          s[i * block + l] = 0;                                         \
+      }                                                                 \
+      cascade_block_ ## ctype (equ, s, len,                             \
+          (g ## ctype *) equ->history + c, stride);                     \
+      for (i = 0; i < len; i++) {                                       \
+        for (l = 0; l < n; l++) {                                       \
+          g ## ctype cur = s[i * block + l];                            \
+          cur = CLAMP (cur, MIN_VAL, MAX_VAL);                          \
+          p[i * channels + l] = (TYPE) floor (cur);                     \
+        }                                                               \
+      }                                                                 \
+    }                                                                   \
+  }                                                                     \
+}
+
+#define CREATE_OPTIMIZED_FUNCTIONS(TYPE,ctype)                          \
 static void                                                             \
-gst_iir_equ_process_ ## TYPE (GstIirEqualizer *equ, guint8 *data,       \
-guint size, guint channels)                                             \
+gst_iir_equ_process_ ## TYPE ## _ ## ctype (GstIirEqualizer *equ,       \
+    guint8 *data, guint size, guint channels)                           \
 {                                                                       \
+  const guint block = EQ_BLOCK_BYTES / sizeof (g ## ctype);             \
   guint frames = size / channels / sizeof (TYPE);                       \
-  guint i, c, f, nf = equ->freq_band_count;                             \
-  TYPE cur;                                                             \
-  GstIirEqualizerBand **filters = equ->bands;                           \
+  guint stride = GST_ROUND_UP_N (channels, block);                      \
+  guint c, i, l, n, pos, len;                                           \
+  g ## ctype s[EQ_CHUNK_FRAMES * EQ_BLOCK_BYTES / sizeof (g ## ctype)]; \
+                                                                        \
+  for (c = 0; c < channels; c += block) {                               \
+    n = MIN (block, channels - c);                                      \
+    for (pos = 0; pos < frames; pos += len) {                           \
+      TYPE *p = (TYPE *) data + pos * channels + c;                     \
                                                                         \
-  for (i = 0; i < frames; i++) {                                        \
-    SecondOrderHistory ## TYPE *history = equ->history;                 \
-    for (c = 0; c < channels; c++) {                                    \
-      cur = *((TYPE *) data);                                           \
-      for (f = 0; f < nf; f++) {                                        \
-        cur = one_step_ ## TYPE (filters[f], history, cur);             \
-        history++;                                                      \
+      len = MIN (EQ_CHUNK_FRAMES, frames - pos);                        \
+      for (i = 0; i < len; i++) {                                       \
+        for (l = 0; l < n; l++)                                         \
+          s[i * block + l] = p[i * channels + l];                       \
+        for (; l < block; l++)                                          \
+          s[i * block + l] = 0;                                         \
+      }                                                                 \
+      cascade_block_ ## ctype (equ, s, len,                             \
+          (g ## ctype *) equ->history + c, stride);                     \
+      for (i = 0; i < len; i++) {                                       \
+        for (l = 0; l < n; l++)                                         \
+          p[i * channels + l] = (TYPE) s[i * block + l];                \
       }                                                                 \
-      *((TYPE *) data) = (TYPE) cur;                                    \
-      data += sizeof (TYPE);                                            \
     }                                                                   \
   }                                                                     \
 }
 
-CREATE_OPTIMIZED_FUNCTIONS_INT (gint16, gfloat, -32768.0, 32767.0);
-CREATE_OPTIMIZED_FUNCTIONS (gfloat);
-CREATE_OPTIMIZED_FUNCTIONS (gdouble);
+CREATE_OPTIMIZED_FUNCTIONS_INT (gint16, double, -32768.0, 32767.0);
+CREATE_OPTIMIZED_FUNCTIONS_INT (gint16, float, -32768.0f, 32767.0f);
+CREATE_OPTIMIZED_FUNCTIONS (gfloat, double);
+CREATE_OPTIMIZED_FUNCTIONS (gfloat, float);
+CREATE_OPTIMIZED_FUNCTIONS (gdouble, double);
+
+/* Must be called with transform lock! */
+static gboolean
+select_process_func (GstIirEqualizer * equ, GstAudioFormat format)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_S16:
+      if (equ->single_precision) {
+        equ->history_size = sizeof (gfloat);
+        equ->process = gst_iir_equ_process_gint16_float;
+      } else {
+        equ->history_size = sizeof (gdouble);
+        equ->process = gst_iir_equ_process_gint16_double;
+      }
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      if (equ->single_precision) {
+        equ->history_size = sizeof (gfloat);
+        equ->process = gst_iir_equ_process_gfloat_float;
+      } else {
+        equ->history_size = sizeof (gdouble);
+        equ->process = gst_iir_equ_process_gfloat_double;
+      }
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      equ->history_size = sizeof (gdouble);
+      equ->process = gst_iir_equ_process_gdouble_double;
+      break;
+    default:
+      return FALSE;
+  }
+
+  return TRUE;
+}
 
 static GstFlowReturn
 gst_iir_equalizer_transform_ip (GstBaseTransform * btrans, GstBuffer * buf)
@@ -872,22 +1108,8 @@ gst_iir_equalizer_setup (GstAudioFilter * audio, const GstAudioInfo * info)
 {
   GstIirEqualizer *equ = GST_IIR_EQUALIZER (audio);
 
-  switch (GST_AUDIO_INFO_FORMAT (info)) {
-    case GST_AUDIO_FORMAT_S16:
-      equ->history_size = history_size_gint16;
-      equ->process = gst_iir_equ_process_gint16;
-      break;
-    case GST_AUDIO_FORMAT_F32:
-      equ->history_size = history_size_gfloat;
-      equ->process = gst_iir_equ_process_gfloat;
-      break;
-    case GST_AUDIO_FORMAT_F64:
-      equ->history_size = history_size_gdouble;
-      equ->process = gst_iir_equ_process_gdouble;
-      break;
-    default:
-      return FALSE;
-  }
+  if (!select_process_func (equ, GST_AUDIO_INFO_FORMAT (info)))
+    return FALSE;
 
   alloc_history (equ, info);
   return TRUE;
@@ -64,6 +64,7 @@ struct _GstIirEqualizer
   /* for each band and channel */
   gpointer history;
   guint history_size;
+  gboolean single_precision;
 
   gboolean need_new_coefficients;
 
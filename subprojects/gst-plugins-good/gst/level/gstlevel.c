@@ -43,6 +43,26 @@
  * * #GValueArray of #gdouble `rms`: the Root Mean Square (or average power) level in dB
  *   for each channel
  *
+ * If #GstLevel:mode is one of the loudness modes, the element instead measures
+ * the loudness as specified by EBU R128 and ITU-R BS.1770 and the message is
+ * named `loudness` with these fields:
+ *
+ * * #GstClockTime `timestamp`, `stream-time`, `running-time` and `duration`
+ *   as above.
+ * * #GValueArray of #gdouble `momentary`: the loudness of the last 400ms in
+ *   LUFS for each programme
+ * * #GValueArray of #gdouble `short-term`: the loudness of the last 3s in LUFS
+ *   for each programme
+ * * #GValueArray of #gdouble `integrated`: the gated loudness since the
+ *   element was started in LUFS for each programme
+ * * #GValueArray of #gdouble `true-peak`: the highest sample peak of the signal
+ *   upsampled 4x since the last message in dBTP for each channel
+ *
+ * All channels form one programme in the `loudness` mode, with the surround
+ * channels weighted and the LFE channels ignored. In the `channel-loudness`
+ * mode each channel is measured as a separate mono programme, which is useful
+ * to monitor a large number of unrelated channels with a single element.
+ *
  * ## Example application
  *
  * {{ tests/examples/level/level-example.c }}
@@ -100,8 +120,28 @@ enum
   PROP_PEAK_TTL,
   PROP_PEAK_FALLOFF,
   PROP_AUDIO_LEVEL_META,
+  PROP_MODE,
 };
 
+GType
+gst_level_mode_get_type (void)
+{
+  static GType level_mode_type = 0;
+  static const GEnumValue level_mode[] = {
+    {GST_LEVEL_MODE_LEVEL, "RMS, peak and decaying peak level", "level"},
+    {GST_LEVEL_MODE_LOUDNESS, "EBU R128 loudness of all channels",
+        "loudness"},
+    {GST_LEVEL_MODE_CHANNEL_LOUDNESS, "EBU R128 loudness of each channel",
+        "channel-loudness"},
+    {0, NULL, NULL},
+  };
+
+  if (!level_mode_type) {
+    level_mode_type = g_enum_register_static ("GstLevelMode", level_mode);
+  }
+  return level_mode_type;
+}
+
 #define gst_level_parent_class parent_class
 G_DEFINE_TYPE (GstLevel, gst_level, GST_TYPE_BASE_TRANSFORM);
 GST_ELEMENT_REGISTER_DEFINE (level, "level", GST_RANK_NONE, GST_TYPE_LEVEL);
@@ -184,6 +224,18 @@ gst_level_class_init (GstLevelClass * klass)
       g_param_spec_boolean ("audio-level-meta", "Audio Level Meta",
           "Set GstAudioLevelMeta on buffers", FALSE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstLevel:mode:
+   *
+   * Whether to post messages with the RMS and peak levels or with the EBU
+   * R128 loudness.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MODE,
+      g_param_spec_enum ("mode", "Mode", "What to measure",
+          GST_TYPE_LEVEL_MODE, GST_LEVEL_MODE_LEVEL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   GST_DEBUG_CATEGORY_INIT (level_debug, "level", 0, "Level calculation");
 
@@ -200,6 +252,8 @@ gst_level_class_init (GstLevelClass * klass)
   trans_class->start = GST_DEBUG_FUNCPTR (gst_level_start);
   trans_class->transform_ip = GST_DEBUG_FUNCPTR (gst_level_transform_ip);
   trans_class->sink_event = GST_DEBUG_FUNCPTR (gst_level_sink_event);
+
+  gst_type_mark_as_plugin_api (GST_TYPE_LEVEL_MODE, 0);
 }
 
 static void
@@ -229,8 +283,10 @@ gst_level_init (GstLevel * filter)
   filter->decay_peak_falloff = 10.0;    /* dB falloff (/sec) */
 
   filter->post_messages = TRUE;
+  filter->mode = GST_LEVEL_MODE_LEVEL;
 
   filter->process = NULL;
+  filter->loudness = NULL;
 
   gst_base_transform_set_gap_aware (GST_BASE_TRANSFORM (filter), TRUE);
   configure_passthrough (filter, filter->audio_level_meta);
@@ -255,9 +311,28 @@ gst_level_finalize (GObject * obj)
   filter->decay_peak_base = NULL;
   filter->decay_peak_age = NULL;
 
+  if (filter->loudness)
+    gst_loudness_free (filter->loudness);
+  filter->loudness = NULL;
+
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
 
+/* called with object lock */
+static void
+gst_level_setup_loudness (GstLevel * filter)
+{
+  if (filter->loudness)
+    gst_loudness_free (filter->loudness);
+  filter->loudness = NULL;
+
+  if (filter->mode != GST_LEVEL_MODE_LEVEL &&
+      GST_AUDIO_INFO_FORMAT (&filter->info) != GST_AUDIO_FORMAT_UNKNOWN) {
+    filter->loudness = gst_loudness_new (&filter->info,
+        filter->mode == GST_LEVEL_MODE_CHANNEL_LOUDNESS);
+  }
+}
+
 static void
 gst_level_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -291,6 +366,12 @@ gst_level_set_property (GObject * object, guint prop_id,
       configure_passthrough (filter, g_value_get_boolean (value));
       GST_OBJECT_LOCK (filter);
       break;
+    case PROP_MODE:
+      if (filter->mode != g_value_get_enum (value)) {
+        filter->mode = g_value_get_enum (value);
+        gst_level_setup_loudness (filter);
+      }
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -325,6 +406,9 @@ gst_level_get_property (GObject * object, guint prop_id,
     case PROP_AUDIO_LEVEL_META:
       g_value_set_boolean (value, filter->audio_level_meta);
       break;
+    case PROP_MODE:
+      g_value_set_enum (value, filter->mode);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -503,6 +587,7 @@ gst_level_set_caps (GstBaseTransform * trans, GstCaps * in, GstCaps * out)
   }
 
   gst_level_recalc_interval_frames (filter);
+  gst_level_setup_loudness (filter);
 
   GST_OBJECT_UNLOCK (filter);
   return TRUE;
@@ -516,6 +601,11 @@ gst_level_start (GstBaseTransform * trans)
   filter->num_frames = 0;
   filter->message_ts = GST_CLOCK_TIME_NONE;
 
+  GST_OBJECT_LOCK (filter);
+  if (filter->loudness)
+    gst_loudness_reset (filter->loudness);
+  GST_OBJECT_UNLOCK (filter);
+
   return TRUE;
 }
 
@@ -588,6 +678,80 @@ gst_level_message_append_channel (GstMessage * m, gdouble rms, gdouble peak,
   g_value_unset (&v);
 }
 
+static void
+gst_level_value_array_append (GValueArray * arr, gdouble d)
+{
+  GValue v = G_VALUE_INIT;
+
+  g_value_init (&v, G_TYPE_DOUBLE);
+  g_value_set_double (&v, d);
+  g_value_array_append (arr, &v);       /* copies by value */
+  g_value_unset (&v);
+}
+
+static void
+gst_level_structure_take_array (GstStructure * s, const gchar * field,
+    GValueArray * arr)
+{
+  GValue v = G_VALUE_INIT;
+
+  g_value_init (&v, G_TYPE_VALUE_ARRAY);
+  g_value_take_boxed (&v, arr);
+  gst_structure_take_value (s, field, &v);
+}
+
+/* called with object lock */
+static GstMessage *
+gst_level_loudness_message_new (GstLevel * level, GstClockTime timestamp,
+    GstClockTime duration)
+{
+  GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (level);
+  GstLoudness *loudness = level->loudness;
+  guint i, n_programmes, channels;
+  GValueArray *momentary, *short_term, *integrated, *true_peak;
+  GstClockTime running_time, stream_time;
+  GstStructure *s;
+
+  running_time = gst_segment_to_running_time (&trans->segment, GST_FORMAT_TIME,
+      timestamp);
+  stream_time = gst_segment_to_stream_time (&trans->segment, GST_FORMAT_TIME,
+      timestamp);
+
+  s = gst_structure_new ("loudness",
+      "timestamp", G_TYPE_UINT64, timestamp,
+      "stream-time", G_TYPE_UINT64, stream_time,
+      "running-time", G_TYPE_UINT64, running_time,
+      "duration", G_TYPE_UINT64, duration, NULL);
+
+  n_programmes = gst_loudness_get_n_programmes (loudness);
+  momentary = g_value_array_new (n_programmes);
+  short_term = g_value_array_new (n_programmes);
+  integrated = g_value_array_new (n_programmes);
+  for (i = 0; i < n_programmes; i++) {
+    gst_level_value_array_append (momentary,
+        gst_loudness_get_momentary (loudness, i));
+    gst_level_value_array_append (short_term,
+        gst_loudness_get_short_term (loudness, i));
+    gst_level_value_array_append (integrated,
+        gst_loudness_get_integrated (loudness, i));
+  }
+
+  channels = GST_AUDIO_INFO_CHANNELS (&level->info);
+  true_peak = g_value_array_new (channels);
+  for (i = 0; i < channels; i++) {
+    gdouble peak = gst_loudness_take_true_peak (loudness, i);
+
+    gst_level_value_array_append (true_peak, 20 * log10 (peak + EPSILON));
+  }
+
+  gst_level_structure_take_array (s, "momentary", momentary);
+  gst_level_structure_take_array (s, "short-term", short_term);
+  gst_level_structure_take_array (s, "integrated", integrated);
+  gst_level_structure_take_array (s, "true-peak", true_peak);
+
+  return gst_message_new_element (GST_OBJECT (level), s);
+}
+
 static void
 gst_level_rtp_audio_level_meta (GstLevel * self, GstBuffer * buffer,
     guint8 level)
@@ -606,6 +770,83 @@ gst_level_rtp_audio_level_meta (GstLevel * self, GstBuffer * buffer,
   }
 }
 
+/* called with object lock, updates the RMS and the peaks of all channels
+ * with one block of interleaved samples and returns the cumulative square of
+ * all of them */
+static gdouble
+gst_level_process_block (GstLevel * filter, guint8 * in_data,
+    guint block_int_size, gboolean gap, GstClockTime age)
+{
+  GstClockTimeDiff falloff_time;
+  gdouble CS, CS_tot = 0;
+  gint channels, bps;
+  guint i;
+
+  channels = GST_AUDIO_INFO_CHANNELS (&filter->info);
+  bps = GST_AUDIO_INFO_BPS (&filter->info);
+
+  for (i = 0; i < channels; ++i) {
+    if (!gap) {
+      filter->process (in_data + (bps * i), block_int_size, channels, &CS,
+          &filter->peak[i]);
+      CS_tot += CS;
+      GST_LOG_OBJECT (filter,
+          "[%d]: cumulative squares %lf, over %d samples/%d channels",
+          i, CS, block_int_size, channels);
+      filter->CS[i] += CS;
+    } else {
+      filter->peak[i] = 0.0;
+    }
+
+    filter->decay_peak_age[i] += age;
+    GST_LOG_OBJECT (filter,
+        "[%d]: peak %f, last peak %f, decay peak %f, age %" GST_TIME_FORMAT,
+        i, filter->peak[i], filter->last_peak[i], filter->decay_peak[i],
+        GST_TIME_ARGS (filter->decay_peak_age[i]));
+
+    /* update running peak */
+    if (filter->peak[i] > filter->last_peak[i])
+      filter->last_peak[i] = filter->peak[i];
+
+    /* make decay peak fall off if too old */
+    falloff_time =
+        GST_CLOCK_DIFF (gst_gdouble_to_guint64 (filter->decay_peak_ttl),
+        filter->decay_peak_age[i]);
+    if (falloff_time > 0) {
+      gdouble falloff_dB;
+      gdouble falloff;
+      gdouble length;         /* length of falloff time in seconds */
+
+      length = (gdouble) falloff_time / (gdouble) GST_SECOND;
+      falloff_dB = filter->decay_peak_falloff * length;
+      falloff = pow (10, falloff_dB / -20.0);
+
+      GST_LOG_OBJECT (filter,
+          "falloff: current %f, base %f, interval %" GST_TIME_FORMAT
+          ", dB falloff %f, factor %e",
+          filter->decay_peak[i], filter->decay_peak_base[i],
+          GST_TIME_ARGS (falloff_time), falloff_dB, falloff);
+      filter->decay_peak[i] = filter->decay_peak_base[i] * falloff;
+      GST_LOG_OBJECT (filter,
+          "peak is %" GST_TIME_FORMAT " old, decayed with factor %e to %f",
+          GST_TIME_ARGS (filter->decay_peak_age[i]), falloff,
+          filter->decay_peak[i]);
+    } else {
+      GST_LOG_OBJECT (filter, "peak not old enough, not decaying");
+    }
+
+    /* if the peak of this run is higher, the decay peak gets reset */
+    if (filter->peak[i] >= filter->decay_peak[i]) {
+      GST_LOG_OBJECT (filter, "new peak, %f", filter->peak[i]);
+      filter->decay_peak[i] = filter->peak[i];
+      filter->decay_peak_base[i] = filter->peak[i];
+      filter->decay_peak_age[i] = G_GINT64_CONSTANT (0);
+    }
+  }
+
+  return CS_tot;
+}
+
 static GstFlowReturn
 gst_level_transform_ip (GstBaseTransform * trans, GstBuffer * in)
 {
@@ -620,11 +861,12 @@ gst_level_transform_ip (GstBaseTransform * trans, GstBuffer * in)
                                  * ie. total count for all channels combined */
   guint block_size, block_int_size;     /* we subdivide buffers to not skip message
                                          * intervals */
-  GstClockTimeDiff falloff_time;
   gint channels, rate, bps;
   gdouble CS_tot = 0;           /* Total Cumulative Square on all samples */
+  gboolean gap;
 
   filter = GST_LEVEL (trans);
+  gap = GST_BUFFER_FLAG_IS_SET (in, GST_BUFFER_FLAG_GAP);
 
   channels = GST_AUDIO_INFO_CHANNELS (&filter->info);
   bps = GST_AUDIO_INFO_BPS (&filter->info);
@@ -657,63 +899,25 @@ gst_level_transform_ip (GstBaseTransform * trans, GstBuffer * in)
     block_size = MIN (block_size, num_frames);
     block_int_size = block_size * channels;
 
-    for (i = 0; i < channels; ++i) {
-      if (!GST_BUFFER_FLAG_IS_SET (in, GST_BUFFER_FLAG_GAP)) {
-        filter->process (in_data + (bps * i), block_int_size, channels, &CS,
-            &filter->peak[i]);
-        CS_tot += CS;
-        GST_LOG_OBJECT (filter,
-            "[%d]: cumulative squares %lf, over %d samples/%d channels",
-            i, CS, block_int_size, channels);
-        filter->CS[i] += CS;
-      } else {
-        filter->peak[i] = 0.0;
-      }
-
-      filter->decay_peak_age[i] += GST_FRAMES_TO_CLOCK_TIME (num_frames, rate);
-      GST_LOG_OBJECT (filter,
-          "[%d]: peak %f, last peak %f, decay peak %f, age %" GST_TIME_FORMAT,
-          i, filter->peak[i], filter->last_peak[i], filter->decay_peak[i],
-          GST_TIME_ARGS (filter->decay_peak_age[i]));
-
-      /* update running peak */
-      if (filter->peak[i] > filter->last_peak[i])
-        filter->last_peak[i] = filter->peak[i];
-
-      /* make decay peak fall off if too old */
-      falloff_time =
-          GST_CLOCK_DIFF (gst_gdouble_to_guint64 (filter->decay_peak_ttl),
-          filter->decay_peak_age[i]);
-      if (falloff_time > 0) {
-        gdouble falloff_dB;
-        gdouble falloff;
-        gdouble length;         /* length of falloff time in seconds */
-
-        length = (gdouble) falloff_time / (gdouble) GST_SECOND;
-        falloff_dB = filter->decay_peak_falloff * length;
-        falloff = pow (10, falloff_dB / -20.0);
-
-        GST_LOG_OBJECT (filter,
-            "falloff: current %f, base %f, interval %" GST_TIME_FORMAT
-            ", dB falloff %f, factor %e",
-            filter->decay_peak[i], filter->decay_peak_base[i],
-            GST_TIME_ARGS (falloff_time), falloff_dB, falloff);
-        filter->decay_peak[i] = filter->decay_peak_base[i] * falloff;
-        GST_LOG_OBJECT (filter,
-            "peak is %" GST_TIME_FORMAT " old, decayed with factor %e to %f",
-            GST_TIME_ARGS (filter->decay_peak_age[i]), falloff,
-            filter->decay_peak[i]);
-      } else {
-        GST_LOG_OBJECT (filter, "peak not old enough, not decaying");
-      }
-
-      /* if the peak of this run is higher, the decay peak gets reset */
-      if (filter->peak[i] >= filter->decay_peak[i]) {
-        GST_LOG_OBJECT (filter, "new peak, %f", filter->peak[i]);
-        filter->decay_peak[i] = filter->peak[i];
-        filter->decay_peak_base[i] = filter->peak[i];
-        filter->decay_peak_age[i] = G_GINT64_CONSTANT (0);
+    if (filter->loudness) {
+      /* gap buffers are measured as silence */
+      gst_loudness_process (filter->loudness, gap ? NULL : in_data,
+          block_size);
+
+      /* no RMS or peak levels are posted in the loudness modes, only the
+       * audio level meta needs the cumulative squares */
+      if (filter->audio_level_meta && !gap) {
+        for (i = 0; i < channels; ++i) {
+          gdouble peak;
+
+          filter->process (in_data + (bps * i), block_int_size, channels, &CS,
+              &peak);
+          CS_tot += CS;
+        }
       }
+    } else {
+      CS_tot += gst_level_process_block (filter, in_data, block_int_size,
+          gap, GST_FRAMES_TO_CLOCK_TIME (num_frames, rate));
     }
     in_data += block_size * bps * channels;
 
@@ -751,7 +955,19 @@ gst_level_post_message (GstLevel * filter)
   rate = GST_AUDIO_INFO_RATE (&filter->info);
   duration = GST_FRAMES_TO_CLOCK_TIME (frames, rate);
 
-  if (filter->post_messages) {
+  if (filter->post_messages && filter->loudness) {
+    GstMessage *m =
+        gst_level_loudness_message_new (filter, filter->message_ts, duration);
+
+    for (i = 0; i < channels; ++i) {
+      filter->CS[i] = 0.0;
+      filter->last_peak[i] = 0.0;
+    }
+
+    GST_OBJECT_UNLOCK (filter);
+    gst_element_post_message (GST_ELEMENT (filter), m);
+    GST_OBJECT_LOCK (filter);
+  } else if (filter->post_messages) {
     GstMessage *m =
         gst_level_message_new (filter, filter->message_ts, duration);
 
@@ -28,6 +28,8 @@
 #include <gst/base/gstbasetransform.h>
 #include <gst/audio/audio.h>
 
+#include "gstloudness.h"
+
 G_BEGIN_DECLS
 
 
@@ -44,10 +46,30 @@ G_BEGIN_DECLS
 #define GST_IS_LEVEL_CLASS(klass) \
   (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_LEVEL))
 
+#define GST_TYPE_LEVEL_MODE (gst_level_mode_get_type())
+
 
 typedef struct _GstLevel GstLevel;
 typedef struct _GstLevelClass GstLevelClass;
 
+/**
+ * GstLevelMode:
+ * @GST_LEVEL_MODE_LEVEL: RMS, peak and decaying peak level per channel
+ * @GST_LEVEL_MODE_LOUDNESS: EBU R128 loudness of all channels as one
+ *     programme
+ * @GST_LEVEL_MODE_CHANNEL_LOUDNESS: EBU R128 loudness of each channel as a
+ *     separate programme
+ *
+ * What the level element measures.
+ *
+ * Since: 1.22
+ */
+typedef enum {
+  GST_LEVEL_MODE_LEVEL,
+  GST_LEVEL_MODE_LOUDNESS,
+  GST_LEVEL_MODE_CHANNEL_LOUDNESS
+} GstLevelMode;
+
 /**
  * GstLevel:
  *
@@ -62,6 +84,7 @@ struct _GstLevel {
   gdouble decay_peak_ttl;       /* time to live for peak in nanoseconds */
   gdouble decay_peak_falloff;   /* falloff in dB/sec */
   gboolean audio_level_meta; /* whether or not generate GstAudioLevelMeta */
+  GstLevelMode mode;            /* what to measure */
 
   GstAudioInfo info;
   gint num_frames;              /* frame count (1 sample per channel)
@@ -78,6 +101,8 @@ struct _GstLevel {
   GstClockTime *decay_peak_age; /* age of last peak */
 
   void (*process)(gpointer, guint, guint, gdouble*, gdouble*);
+
+  GstLoudness *loudness;        /* loudness meter in the loudness modes */
 };
 
 struct _GstLevelClass {
@@ -85,6 +110,7 @@ struct _GstLevelClass {
 };
 
 GType gst_level_get_type (void);
+GType gst_level_mode_get_type (void);
 
 GST_ELEMENT_REGISTER_DECLARE (level);
 
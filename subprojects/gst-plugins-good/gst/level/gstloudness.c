@@ -0,0 +1,773 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include "gstloudness.h"
+
+/* The upsampler works on four floats per vector, the K-weighting filters
+ * on two doubles per vector */
+#if defined (__SSE2__) || defined (_M_X64)
+#include <emmintrin.h>
+#define LOUDNESS_SIMD 1
+typedef __m128 v4sf;
+typedef __m128d v2df;
+#define VF_LOAD(p) _mm_loadu_ps (p)
+#define VF_STORE(p,v) _mm_storeu_ps (p, v)
+#define VF_SET1(f) _mm_set1_ps (f)
+#define VF_ADD(a,b) _mm_add_ps (a, b)
+#define VF_MUL(a,b) _mm_mul_ps (a, b)
+#define VF_MAX(a,b) _mm_max_ps (a, b)
+#define VF_ABS(a) _mm_andnot_ps (_mm_set1_ps (-0.0f), a)
+#define VD_LOAD(p) _mm_loadu_pd (p)
+#define VD_LOAD_F(p) \
+    _mm_cvtps_pd (_mm_castpd_ps (_mm_load_sd ((const double *) (p))))
+#define VD_STORE(p,v) _mm_storeu_pd (p, v)
+#define VD_SET1(d) _mm_set1_pd (d)
+#define VD_ADD(a,b) _mm_add_pd (a, b)
+#define VD_SUB(a,b) _mm_sub_pd (a, b)
+#define VD_MUL(a,b) _mm_mul_pd (a, b)
+#elif defined (__aarch64__)
+#include <arm_neon.h>
+#define LOUDNESS_SIMD 1
+typedef float32x4_t v4sf;
+typedef float64x2_t v2df;
+#define VF_LOAD(p) vld1q_f32 (p)
+#define VF_STORE(p,v) vst1q_f32 (p, v)
+#define VF_SET1(f) vdupq_n_f32 (f)
+#define VF_ADD(a,b) vaddq_f32 (a, b)
+#define VF_MUL(a,b) vmulq_f32 (a, b)
+#define VF_MAX(a,b) vmaxq_f32 (a, b)
+#define VF_ABS(a) vabsq_f32 (a)
+#define VD_LOAD(p) vld1q_f64 (p)
+#define VD_LOAD_F(p) vcvt_f64_f32 (vld1_f32 (p))
+#define VD_STORE(p,v) vst1q_f64 (p, v)
+#define VD_SET1(d) vdupq_n_f64 (d)
+#define VD_ADD(a,b) vaddq_f64 (a, b)
+#define VD_SUB(a,b) vsubq_f64 (a, b)
+#define VD_MUL(a,b) vmulq_f64 (a, b)
+#endif
+
+#define EPSILON 1e-35
+
+/* Loudness is measured on 100ms sub-blocks: a momentary gating block is 4 of
+ * them (400ms, 75% overlap), the short-term window 30 (3s) */
+#define SUBBLOCKS_MOMENTARY 4
+#define SUBBLOCKS_SHORT_TERM 30
+
+/* Gating blocks for the integrated loudness are kept in a histogram of 0.1 LU
+ * bins from the absolute gate up to +30 LUFS, so memory does not grow with
+ * the stream duration. Each bin also sums the energy of its blocks so only
+ * the position of the relative gate is quantized. */
+#define ABSOLUTE_GATE -70.0
+#define RELATIVE_GATE -10.0
+#define BINS_PER_LU 10
+#define N_BINS (100 * BINS_PER_LU)
+
+/* True-peak is measured on the signal upsampled 4x with the interpolation
+ * filter from ITU-R BS.1770-4 Annex 2 */
+#define TP_PHASES 4
+#define TP_TAPS 12
+#define TP_HISTORY (TP_TAPS - 1)
+
+/* Input is converted to float in chunks of this many frames. Single
+ * precision is plenty for metering, the filters still run in double */
+#define CHUNK_FRAMES 256
+
+/* Channels are filtered in groups of this size, which keeps the state of a
+ * group in registers and lets the compiler vectorize over the group */
+#define CHANNEL_TILE 8
+
+static const gfloat tp_coefs[TP_PHASES][TP_TAPS] = {
+  {0.0017089843750, 0.0109863281250, -0.0196533203125, 0.0332031250000,
+      -0.0594482421875, 0.1373291015625, 0.9721679687500, -0.1022949218750,
+      0.0476074218750, -0.0266113281250, 0.0148925781250, -0.0083007812500},
+  {-0.0291748046875, 0.0292968750000, -0.0517578125000, 0.0891113281250,
+      -0.1665039062500, 0.4650878906250, 0.7797851562500, -0.2003173828125,
+      0.1015625000000, -0.0582275390625, 0.0330810546875, -0.0189208984375},
+  {-0.0189208984375, 0.0330810546875, -0.0582275390625, 0.1015625000000,
+      -0.2003173828125, 0.7797851562500, 0.4650878906250, -0.1665039062500,
+      0.0891113281250, -0.0517578125000, 0.0292968750000, -0.0291748046875},
+  {-0.0083007812500, 0.0148925781250, -0.0266113281250, 0.0476074218750,
+      -0.1022949218750, 0.9721679687500, 0.1373291015625, -0.0594482421875,
+      0.0332031250000, -0.0196533203125, 0.0109863281250, 0.0017089843750}
+};
+
+typedef void (*GstLoudnessConvertFunc) (gconstpointer in, gfloat * out,
+    guint samples);
+
+/* All per-channel state is kept as separate arrays indexed by channel so that
+ * the inner loops, which run over a group of channels of one frame, have no
+ * dependencies between iterations and can be vectorized by the compiler. */
+struct _GstLoudness
+{
+  guint channels;
+  guint bpf;
+  gboolean per_channel;
+  guint n_programmes;
+  GstLoudnessConvertFunc convert;
+
+  /* K-weighting: pre-filter shelf followed by the RLB high-pass, both as
+   * transposed direct form II biquads */
+  gdouble b[2][3];
+  gdouble a[2][3];
+  gdouble *z[4];                /* filter state, per channel */
+  gdouble *weights;             /* channel weight for the programme sum */
+
+  gfloat *frames;               /* TP_HISTORY + CHUNK_FRAMES input frames */
+  gfloat *true_peak;            /* linear true-peak since last taken */
+
+  gdouble *sum;                 /* per channel sum of squares of the current
+                                 * sub-block */
+  guint subblock_frames;
+  guint subblock_fill;
+
+  gdouble *subblocks;           /* mean square of the last sub-blocks, per
+                                 * programme */
+  guint subblock_pos;
+  guint n_subblocks;
+
+  guint64 *hist_count;          /* gating block histogram, per programme */
+  gdouble *hist_energy;
+};
+
+#define DEFINE_CONVERT(TYPE, SCALE)                                     \
+static void                                                             \
+convert_##TYPE (gconstpointer in, gfloat * out, guint samples)          \
+{                                                                       \
+  const TYPE *src = in;                                                 \
+  guint i;                                                              \
+                                                                        \
+  for (i = 0; i < samples; i++)                                         \
+    out[i] = src[i] * (SCALE);                                          \
+}
+
+DEFINE_CONVERT (gint8, 1.0f / 128.0f);
+DEFINE_CONVERT (gint16, 1.0f / 32768.0f);
+DEFINE_CONVERT (gint32, 1.0f / 2147483648.0f);
+DEFINE_CONVERT (gfloat, 1.0f);
+DEFINE_CONVERT (gdouble, 1.0f);
+
+static inline gdouble
+energy_to_lufs (gdouble energy)
+{
+  return -0.691 + 10.0 * log10 (energy + EPSILON);
+}
+
+/* Bilinear transform of the analog K-weighting prototypes, so that sample
+ * rates other than 48kHz get the same response as the tabulated
+ * coefficients in BS.1770 */
+static void
+setup_k_weighting (GstLoudness * loudness, gint rate)
+{
+  gdouble f0, gain, q, k, vh, vb, a0;
+
+  f0 = 1681.974450955533;
+  gain = 3.999843853973347;
+  q = 0.7071752369554196;
+  k = tan (G_PI * f0 / rate);
+  vh = pow (10.0, gain / 20.0);
+  vb = pow (vh, 0.4996667741545416);
+  a0 = 1.0 + k / q + k * k;
+
+  loudness->b[0][0] = (vh + vb * k / q + k * k) / a0;
+  loudness->b[0][1] = 2.0 * (k * k - vh) / a0;
+  loudness->b[0][2] = (vh - vb * k / q + k * k) / a0;
+  loudness->a[0][0] = 1.0;
+  loudness->a[0][1] = 2.0 * (k * k - 1.0) / a0;
+  loudness->a[0][2] = (1.0 - k / q + k * k) / a0;
+
+  f0 = 38.13547087602444;
+  q = 0.5003270373238773;
+  k = tan (G_PI * f0 / rate);
+  a0 = 1.0 + k / q + k * k;
+
+  loudness->b[1][0] = 1.0;
+  loudness->b[1][1] = -2.0;
+  loudness->b[1][2] = 1.0;
+  loudness->a[1][0] = 1.0;
+  loudness->a[1][1] = 2.0 * (k * k - 1.0) / a0;
+  loudness->a[1][2] = (1.0 - k / q + k * k) / a0;
+}
+
+static gdouble
+channel_weight (GstAudioChannelPosition position)
+{
+  switch (position) {
+    case GST_AUDIO_CHANNEL_POSITION_LFE1:
+    case GST_AUDIO_CHANNEL_POSITION_LFE2:
+      return 0.0;
+    case GST_AUDIO_CHANNEL_POSITION_REAR_LEFT:
+    case GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT:
+    case GST_AUDIO_CHANNEL_POSITION_SIDE_LEFT:
+    case GST_AUDIO_CHANNEL_POSITION_SIDE_RIGHT:
+    case GST_AUDIO_CHANNEL_POSITION_SURROUND_LEFT:
+    case GST_AUDIO_CHANNEL_POSITION_SURROUND_RIGHT:
+      return 1.41;
+    default:
+      return 1.0;
+  }
+}
+
+/* gst_loudness_new:
+ * @info: the #GstAudioInfo of the measured stream
+ * @per_channel: whether each channel is a separate programme
+ *
+ * Allocates all state needed to measure a stream of @info, no further
+ * allocations happen while processing.
+ *
+ * Returns: a new #GstLoudness or %NULL if the format is not supported
+ */
+GstLoudness *
+gst_loudness_new (const GstAudioInfo * info, gboolean per_channel)
+{
+  GstLoudness *loudness;
+  GstLoudnessConvertFunc convert;
+  guint i, channels;
+
+  switch (GST_AUDIO_INFO_FORMAT (info)) {
+    case GST_AUDIO_FORMAT_S8:
+      convert = convert_gint8;
+      break;
+    case GST_AUDIO_FORMAT_S16:
+      convert = convert_gint16;
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      convert = convert_gint32;
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      convert = convert_gfloat;
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      convert = convert_gdouble;
+      break;
+    default:
+      return NULL;
+  }
+
+  channels = GST_AUDIO_INFO_CHANNELS (info);
+
+  loudness = g_new0 (GstLoudness, 1);
+  loudness->channels = channels;
+  loudness->bpf = GST_AUDIO_INFO_BPF (info);
+  loudness->per_channel = per_channel;
+  loudness->n_programmes = per_channel ? channels : 1;
+  loudness->convert = convert;
+
+  setup_k_weighting (loudness, GST_AUDIO_INFO_RATE (info));
+  for (i = 0; i < 4; i++)
+    loudness->z[i] = g_new (gdouble, channels);
+
+  loudness->weights = g_new (gdouble, channels);
+  for (i = 0; i < channels; i++) {
+    if (per_channel || GST_AUDIO_INFO_IS_UNPOSITIONED (info))
+      loudness->weights[i] = 1.0;
+    else
+      loudness->weights[i] = channel_weight (info->position[i]);
+  }
+
+  loudness->frames = g_new (gfloat, (TP_HISTORY + CHUNK_FRAMES) * channels);
+  loudness->true_peak = g_new (gfloat, channels);
+  loudness->sum = g_new (gdouble, channels);
+
+  loudness->subblock_frames = MAX (GST_AUDIO_INFO_RATE (info) / 10, 1);
+  loudness->subblocks =
+      g_new (gdouble, loudness->n_programmes * SUBBLOCKS_SHORT_TERM);
+  loudness->hist_count = g_new (guint64, loudness->n_programmes * N_BINS);
+  loudness->hist_energy = g_new (gdouble, loudness->n_programmes * N_BINS);
+
+  gst_loudness_reset (loudness);
+
+  return loudness;
+}
+
+void
+gst_loudness_free (GstLoudness * loudness)
+{
+  guint i;
+
+  for (i = 0; i < 4; i++)
+    g_free (loudness->z[i]);
+  g_free (loudness->weights);
+  g_free (loudness->frames);
+  g_free (loudness->true_peak);
+  g_free (loudness->sum);
+  g_free (loudness->subblocks);
+  g_free (loudness->hist_count);
+  g_free (loudness->hist_energy);
+  g_free (loudness);
+}
+
+/* gst_loudness_reset:
+ * @loudness: a #GstLoudness
+ *
+ * Forgets everything measured so far, including the integrated loudness.
+ */
+void
+gst_loudness_reset (GstLoudness * loudness)
+{
+  guint i, channels = loudness->channels;
+  guint n_programmes = loudness->n_programmes;
+
+  for (i = 0; i < 4; i++)
+    memset (loudness->z[i], 0, channels * sizeof (gdouble));
+  memset (loudness->frames, 0, TP_HISTORY * channels * sizeof (gfloat));
+  memset (loudness->true_peak, 0, channels * sizeof (gfloat));
+  memset (loudness->sum, 0, channels * sizeof (gdouble));
+  memset (loudness->subblocks, 0,
+      n_programmes * SUBBLOCKS_SHORT_TERM * sizeof (gdouble));
+  memset (loudness->hist_count, 0, n_programmes * N_BINS * sizeof (guint64));
+  memset (loudness->hist_energy, 0, n_programmes * N_BINS * sizeof (gdouble));
+
+  loudness->subblock_fill = 0;
+  loudness->subblock_pos = 0;
+  loudness->n_subblocks = 0;
+}
+
+/* 4x upsampling of the last @frames frames of the @width channels at
+ * @x, keeping the highest absolute value per channel. All phases are
+ * computed from one pass over the taps. */
+static inline void
+process_true_peak_tile (const gfloat * x, guint stride, guint frames,
+    gfloat * peak, guint width)
+{
+  guint n, p, k, c;
+
+  for (n = 0; n < frames; n++) {
+    const gfloat *xn = x + (n + TP_HISTORY) * stride;
+    gfloat acc[TP_PHASES][CHANNEL_TILE] = { {0.0f,}, };
+
+    for (k = 0; k < TP_TAPS; k++) {
+      const gfloat *xk = xn - k * stride;
+
+      for (p = 0; p < TP_PHASES; p++) {
+        for (c = 0; c < width; c++)
+          acc[p][c] += tp_coefs[p][k] * xk[c];
+      }
+    }
+    for (p = 0; p < TP_PHASES; p++) {
+      for (c = 0; c < width; c++) {
+        gfloat v = fabsf (acc[p][c]);
+
+        peak[c] = MAX (peak[c], v);
+      }
+    }
+  }
+}
+
+#ifdef LOUDNESS_SIMD
+/* same for CHANNEL_TILE channels, two vectors of four */
+static void
+process_true_peak_simd (const gfloat * x, guint stride, guint frames,
+    gfloat * peak)
+{
+  v4sf peak0 = VF_LOAD (peak), peak1 = VF_LOAD (peak + 4);
+  guint n, k;
+
+  for (n = 0; n < frames; n++) {
+    const gfloat *xn = x + (n + TP_HISTORY) * stride;
+    v4sf a00, a01, a10, a11, a20, a21, a30, a31;
+
+    a00 = a01 = a10 = a11 = a20 = a21 = a30 = a31 = VF_SET1 (0.0f);
+    for (k = 0; k < TP_TAPS; k++) {
+      const gfloat *xk = xn - k * stride;
+      v4sf x0 = VF_LOAD (xk), x1 = VF_LOAD (xk + 4), h;
+
+      h = VF_SET1 (tp_coefs[0][k]);
+      a00 = VF_ADD (a00, VF_MUL (h, x0));
+      a01 = VF_ADD (a01, VF_MUL (h, x1));
+      h = VF_SET1 (tp_coefs[1][k]);
+      a10 = VF_ADD (a10, VF_MUL (h, x0));
+      a11 = VF_ADD (a11, VF_MUL (h, x1));
+      h = VF_SET1 (tp_coefs[2][k]);
+      a20 = VF_ADD (a20, VF_MUL (h, x0));
+      a21 = VF_ADD (a21, VF_MUL (h, x1));
+      h = VF_SET1 (tp_coefs[3][k]);
+      a30 = VF_ADD (a30, VF_MUL (h, x0));
+      a31 = VF_ADD (a31, VF_MUL (h, x1));
+    }
+    peak0 = VF_MAX (peak0, VF_MAX (VF_MAX (VF_ABS (a00), VF_ABS (a10)),
+            VF_MAX (VF_ABS (a20), VF_ABS (a30))));
+    peak1 = VF_MAX (peak1, VF_MAX (VF_MAX (VF_ABS (a01), VF_ABS (a11)),
+            VF_MAX (VF_ABS (a21), VF_ABS (a31))));
+  }
+
+  VF_STORE (peak, peak0);
+  VF_STORE (peak + 4, peak1);
+}
+#endif
+
+static void
+process_true_peak (GstLoudness * loudness, guint frames)
+{
+  guint c = 0, channels = loudness->channels;
+
+#ifdef LOUDNESS_SIMD
+  for (; c + CHANNEL_TILE <= channels; c += CHANNEL_TILE)
+    process_true_peak_simd (loudness->frames + c, channels, frames,
+        loudness->true_peak + c);
+#else
+  for (; c + CHANNEL_TILE <= channels; c += CHANNEL_TILE)
+    process_true_peak_tile (loudness->frames + c, channels, frames,
+        loudness->true_peak + c, CHANNEL_TILE);
+#endif
+  if (c < channels)
+    process_true_peak_tile (loudness->frames + c, channels, frames,
+        loudness->true_peak + c, channels - c);
+}
+
+/* K-weights @frames frames of the @width channels at @x and adds their
+ * squares to the current sub-block */
+static inline void
+process_k_weighting_tile (GstLoudness * loudness, const gfloat * x,
+    guint stride, guint frames, guint c0, guint width)
+{
+  const gdouble pb0 = loudness->b[0][0], pb1 = loudness->b[0][1];
+  const gdouble pb2 = loudness->b[0][2], pa1 = loudness->a[0][1];
+  const gdouble pa2 = loudness->a[0][2];
+  const gdouble rb0 = loudness->b[1][0], rb1 = loudness->b[1][1];
+  const gdouble rb2 = loudness->b[1][2], ra1 = loudness->a[1][1];
+  const gdouble ra2 = loudness->a[1][2];
+  gdouble z0[CHANNEL_TILE], z1[CHANNEL_TILE], z2[CHANNEL_TILE];
+  gdouble z3[CHANNEL_TILE], sum[CHANNEL_TILE];
+  guint n, c;
+
+  for (c = 0; c < width; c++) {
+    z0[c] = loudness->z[0][c0 + c];
+    z1[c] = loudness->z[1][c0 + c];
+    z2[c] = loudness->z[2][c0 + c];
+    z3[c] = loudness->z[3][c0 + c];
+    sum[c] = loudness->sum[c0 + c];
+  }
+
+  x += c0;
+  for (n = 0; n < frames; n++) {
+    for (c = 0; c < width; c++) {
+      gdouble in = x[c], y;
+
+      y = pb0 * in + z0[c];
+      z0[c] = pb1 * in - pa1 * y + z1[c];
+      z1[c] = pb2 * in - pa2 * y;
+
+      in = y;
+      y = rb0 * in + z2[c];
+      z2[c] = rb1 * in - ra1 * y + z3[c];
+      z3[c] = rb2 * in - ra2 * y;
+
+      sum[c] += y * y;
+    }
+    x += stride;
+  }
+
+  for (c = 0; c < width; c++) {
+    loudness->z[0][c0 + c] = z0[c];
+    loudness->z[1][c0 + c] = z1[c];
+    loudness->z[2][c0 + c] = z2[c];
+    loudness->z[3][c0 + c] = z3[c];
+    loudness->sum[c0 + c] = sum[c];
+  }
+}
+
+#ifdef LOUDNESS_SIMD
+/* same for four channels, two vectors of two */
+static void
+process_k_weighting_simd (GstLoudness * loudness, const gfloat * x,
+    guint stride, guint frames, guint c0)
+{
+  const v2df pb0 = VD_SET1 (loudness->b[0][0]);
+  const v2df pb1 = VD_SET1 (loudness->b[0][1]);
+  const v2df pb2 = VD_SET1 (loudness->b[0][2]);
+  const v2df pa1 = VD_SET1 (loudness->a[0][1]);
+  const v2df pa2 = VD_SET1 (loudness->a[0][2]);
+  const v2df rb0 = VD_SET1 (loudness->b[1][0]);
+  const v2df rb1 = VD_SET1 (loudness->b[1][1]);
+  const v2df rb2 = VD_SET1 (loudness->b[1][2]);
+  const v2df ra1 = VD_SET1 (loudness->a[1][1]);
+  const v2df ra2 = VD_SET1 (loudness->a[1][2]);
+  gdouble **z = loudness->z;
+  v2df z0[2], z1[2], z2[2], z3[2], sum[2];
+  guint n, i;
+
+  for (i = 0; i < 2; i++) {
+    z0[i] = VD_LOAD (z[0] + c0 + 2 * i);
+    z1[i] = VD_LOAD (z[1] + c0 + 2 * i);
+    z2[i] = VD_LOAD (z[2] + c0 + 2 * i);
+    z3[i] = VD_LOAD (z[3] + c0 + 2 * i);
+    sum[i] = VD_LOAD (loudness->sum + c0 + 2 * i);
+  }
+
+  x += c0;
+  for (n = 0; n < frames; n++) {
+    for (i = 0; i < 2; i++) {
+      v2df in = VD_LOAD_F (x + 2 * i), y;
+
+      y = VD_ADD (VD_MUL (pb0, in), z0[i]);
+      z0[i] = VD_ADD (VD_SUB (VD_MUL (pb1, in), VD_MUL (pa1, y)), z1[i]);
+      z1[i] = VD_SUB (VD_MUL (pb2, in), VD_MUL (pa2, y));
+
+      in = y;
+      y = VD_ADD (VD_MUL (rb0, in), z2[i]);
+      z2[i] = VD_ADD (VD_SUB (VD_MUL (rb1, in), VD_MUL (ra1, y)), z3[i]);
+      z3[i] = VD_SUB (VD_MUL (rb2, in), VD_MUL (ra2, y));
+
+      sum[i] = VD_ADD (sum[i], VD_MUL (y, y));
+    }
+    x += stride;
+  }
+
+  for (i = 0; i < 2; i++) {
+    VD_STORE (z[0] + c0 + 2 * i, z0[i]);
+    VD_STORE (z[1] + c0 + 2 * i, z1[i]);
+    VD_STORE (z[2] + c0 + 2 * i, z2[i]);
+    VD_STORE (z[3] + c0 + 2 * i, z3[i]);
+    VD_STORE (loudness->sum + c0 + 2 * i, sum[i]);
+  }
+}
+#endif
+
+static void
+process_k_weighting (GstLoudness * loudness, const gfloat * x, guint frames)
+{
+  guint c = 0, i, channels = loudness->channels;
+
+#ifdef LOUDNESS_SIMD
+  for (; c + 4 <= channels; c += 4)
+    process_k_weighting_simd (loudness, x, channels, frames, c);
+#endif
+  for (; c + CHANNEL_TILE <= channels; c += CHANNEL_TILE)
+    process_k_weighting_tile (loudness, x, channels, frames, c, CHANNEL_TILE);
+  if (c < channels)
+    process_k_weighting_tile (loudness, x, channels, frames, c, channels - c);
+
+  /* don't let the filter state decay into denormals on silence */
+  for (i = 0; i < 4; i++) {
+    for (c = 0; c < channels; c++) {
+      if (fabs (loudness->z[i][c]) < DBL_MIN)
+        loudness->z[i][c] = 0.0;
+    }
+  }
+}
+
+/* mean square over the last @count sub-blocks of @programme */
+static gdouble
+mean_energy (GstLoudness * loudness, guint programme, guint count)
+{
+  const gdouble *subblocks =
+      loudness->subblocks + programme * SUBBLOCKS_SHORT_TERM;
+  guint i, pos = loudness->subblock_pos;
+  gdouble energy = 0.0;
+
+  count = MIN (count, loudness->n_subblocks);
+  if (count == 0)
+    return 0.0;
+
+  for (i = 0; i < count; i++) {
+    pos = (pos + SUBBLOCKS_SHORT_TERM - 1) % SUBBLOCKS_SHORT_TERM;
+    energy += subblocks[pos];
+  }
+
+  return energy / count;
+}
+
+static void
+finish_subblock (GstLoudness * loudness)
+{
+  guint channels = loudness->channels;
+  guint pos = loudness->subblock_pos;
+  gdouble norm = 1.0 / loudness->subblock_frames;
+  guint c, p;
+
+  if (loudness->per_channel) {
+    for (c = 0; c < channels; c++)
+      loudness->subblocks[c * SUBBLOCKS_SHORT_TERM + pos] =
+          loudness->sum[c] * norm;
+  } else {
+    gdouble energy = 0.0;
+
+    for (c = 0; c < channels; c++)
+      energy += loudness->weights[c] * loudness->sum[c];
+    loudness->subblocks[pos] = energy * norm;
+  }
+  memset (loudness->sum, 0, channels * sizeof (gdouble));
+
+  loudness->subblock_fill = 0;
+  loudness->subblock_pos = (pos + 1) % SUBBLOCKS_SHORT_TERM;
+  loudness->n_subblocks = MIN (loudness->n_subblocks + 1, SUBBLOCKS_SHORT_TERM);
+
+  if (loudness->n_subblocks < SUBBLOCKS_MOMENTARY)
+    return;
+
+  /* a new gating block is complete */
+  for (p = 0; p < loudness->n_programmes; p++) {
+    gdouble energy = mean_energy (loudness, p, SUBBLOCKS_MOMENTARY);
+    gdouble lufs = energy_to_lufs (energy);
+    guint bin;
+
+    if (lufs < ABSOLUTE_GATE)
+      continue;
+
+    bin = MIN ((lufs - ABSOLUTE_GATE) * BINS_PER_LU, N_BINS - 1);
+    loudness->hist_count[p * N_BINS + bin]++;
+    loudness->hist_energy[p * N_BINS + bin] += energy;
+  }
+}
+
+/* gst_loudness_process:
+ * @loudness: a #GstLoudness
+ * @data: (allow-none): interleaved samples or %NULL for silence
+ * @frames: the number of frames in @data
+ *
+ * Measures @frames more frames of the stream.
+ */
+void
+gst_loudness_process (GstLoudness * loudness, gconstpointer data,
+    guint frames)
+{
+  const guint8 *in = data;
+  guint channels = loudness->channels;
+  gfloat *x = loudness->frames + TP_HISTORY * channels;
+
+  while (frames > 0) {
+    guint chunk = MIN (frames, CHUNK_FRAMES);
+    guint done = 0;
+
+    if (in) {
+      loudness->convert (in, x, chunk * channels);
+      in += chunk * loudness->bpf;
+    } else {
+      memset (x, 0, chunk * channels * sizeof (gfloat));
+    }
+
+    process_true_peak (loudness, chunk);
+
+    while (done < chunk) {
+      guint len = MIN (chunk - done,
+          loudness->subblock_frames - loudness->subblock_fill);
+
+      process_k_weighting (loudness, x + done * channels, len);
+      done += len;
+      loudness->subblock_fill += len;
+
+      if (loudness->subblock_fill == loudness->subblock_frames)
+        finish_subblock (loudness);
+    }
+
+    /* keep the last frames as history for the upsampler */
+    memmove (loudness->frames, loudness->frames + chunk * channels,
+        TP_HISTORY * channels * sizeof (gfloat));
+    frames -= chunk;
+  }
+}
+
+guint
+gst_loudness_get_n_programmes (GstLoudness * loudness)
+{
+  return loudness->n_programmes;
+}
+
+/* gst_loudness_get_momentary:
+ * @loudness: a #GstLoudness
+ * @programme: the programme index
+ *
+ * Returns: the loudness of the last 400ms in LUFS
+ */
+gdouble
+gst_loudness_get_momentary (GstLoudness * loudness, guint programme)
+{
+  return energy_to_lufs (mean_energy (loudness, programme,
+          SUBBLOCKS_MOMENTARY));
+}
+
+/* gst_loudness_get_short_term:
+ * @loudness: a #GstLoudness
+ * @programme: the programme index
+ *
+ * Returns: the loudness of the last 3s in LUFS
+ */
+gdouble
+gst_loudness_get_short_term (GstLoudness * loudness, guint programme)
+{
+  return energy_to_lufs (mean_energy (loudness, programme,
+          SUBBLOCKS_SHORT_TERM));
+}
+
+/* gst_loudness_get_integrated:
+ * @loudness: a #GstLoudness
+ * @programme: the programme index
+ *
+ * Returns: the gated loudness since the last reset in LUFS
+ */
+gdouble
+gst_loudness_get_integrated (GstLoudness * loudness, guint programme)
+{
+  const guint64 *count = loudness->hist_count + programme * N_BINS;
+  const gdouble *energy = loudness->hist_energy + programme * N_BINS;
+  gdouble total = 0.0, threshold;
+  guint64 n = 0;
+  guint i, start = 0;
+
+  for (i = 0; i < N_BINS; i++) {
+    n += count[i];
+    total += energy[i];
+  }
+  if (n == 0)
+    return energy_to_lufs (0.0);
+
+  /* blocks in the bins whose centre is below the relative gate are
+   * dropped */
+  threshold = energy_to_lufs (total / n) + RELATIVE_GATE;
+  if (threshold > ABSOLUTE_GATE) {
+    start = MIN ((threshold - ABSOLUTE_GATE) * BINS_PER_LU, N_BINS - 1);
+    if (threshold > ABSOLUTE_GATE + (start + 0.5) / BINS_PER_LU)
+      start++;
+  }
+
+  n = 0;
+  total = 0.0;
+  for (i = start; i < N_BINS; i++) {
+    n += count[i];
+    total += energy[i];
+  }
+  if (n == 0)
+    return energy_to_lufs (0.0);
+
+  return energy_to_lufs (total / n);
+}
+
+/* gst_loudness_take_true_peak:
+ * @loudness: a #GstLoudness
+ * @channel: the channel index
+ *
+ * Returns: the linear true-peak of @channel since it was last taken
+ */
+gdouble
+gst_loudness_take_true_peak (GstLoudness * loudness, guint channel)
+{
+  gdouble peak = loudness->true_peak[channel];
+
+  loudness->true_peak[channel] = 0.0f;
+
+  return peak;
+}
@@ -0,0 +1,54 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_LOUDNESS_H__
+#define __GST_LOUDNESS_H__
+
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+G_BEGIN_DECLS
+
+/* ITU-R BS.1770-4 / EBU R128 loudness meter. A meter either measures all
+ * channels as one programme or each channel as a separate mono programme. */
+typedef struct _GstLoudness GstLoudness;
+
+GstLoudness * gst_loudness_new             (const GstAudioInfo * info,
+                                            gboolean per_channel);
+void          gst_loudness_free            (GstLoudness * loudness);
+void          gst_loudness_reset           (GstLoudness * loudness);
+
+void          gst_loudness_process         (GstLoudness * loudness,
+                                            gconstpointer data, guint frames);
+
+guint         gst_loudness_get_n_programmes (GstLoudness * loudness);
+
+gdouble       gst_loudness_get_momentary   (GstLoudness * loudness,
+                                            guint programme);
+gdouble       gst_loudness_get_short_term  (GstLoudness * loudness,
+                                            guint programme);
+gdouble       gst_loudness_get_integrated  (GstLoudness * loudness,
+                                            guint programme);
+
+gdouble       gst_loudness_take_true_peak  (GstLoudness * loudness,
+                                            guint channel);
+
+G_END_DECLS
+
+#endif /* __GST_LOUDNESS_H__ */
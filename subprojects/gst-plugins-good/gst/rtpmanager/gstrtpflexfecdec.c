@@ -0,0 +1,863 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-rtpflexfecdec
+ * @see_also: #element-rtpflexfecenc, #element-rtpst2022-1-fecdec
+ *
+ * This element takes as input a media stream and one or more streams of
+ * repair packets as described in RFC 8627: RTP Payload Format for Flexible
+ * Forward Error Correction (FEC), and makes use of the repair packets to
+ * recover media packets that may have gotten lost.
+ *
+ * Repair packets with a flexible mask (R=0 F=0) are supported, as well as
+ * the Reed-Solomon repair packets produced by #element-rtpflexfecenc.
+ * Recovered packets are pushed as soon as they are reconstructed, and can
+ * in turn complete other repair packets.
+ *
+ * ## Example pipeline
+ *
+ * ``` shell
+ * gst-launch-1.0 \
+ *   rtpbin latency=500 fec-decoders='fec,0="rtpflexfecdec";' name=rtp \
+ *   udpsrc address=127.0.0.1 port=5002 caps="application/x-rtp, payload=96" ! queue ! rtp.recv_fec_sink_0_0 \
+ *   udpsrc address=127.0.0.1 port=5000 caps="application/x-rtp, media=video, clock-rate=90000, encoding-name=mp2t, payload=33" ! \
+ *     queue ! netsim drop-probability=0.05 ! rtp.recv_rtp_sink_0 \
+ *   rtp. ! decodebin ! videoconvert ! queue ! autovideosink
+ * ```
+ *
+ * Since: 1.22
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/base/base.h>
+#include <gst/rtp/gstrtpbuffer.h>
+
+#include "gstrtpflexfecdec.h"
+#include "rtpfec.h"
+
+#if !GLIB_CHECK_VERSION(2, 60, 0)
+#define g_queue_clear_full queue_clear_full
+static void
+queue_clear_full (GQueue * queue, GDestroyNotify free_func)
+{
+  gpointer data;
+
+  while ((data = g_queue_pop_head (queue)) != NULL)
+    free_func (data);
+}
+#endif
+
+GST_DEBUG_CATEGORY_STATIC (gst_rtp_flexfec_dec_debug);
+#define GST_CAT_DEFAULT gst_rtp_flexfec_dec_debug
+
+/* Number of media packets kept around for recovery, indexed by seqnum */
+#define STORAGE_SIZE 1024
+/* Repair packets that can't be used yet are dropped past this number */
+#define MAX_PENDING_REPAIRS 256
+/* Longest flexible mask of RFC 8627 section 4.2.2.1 */
+#define MAX_MASK_BITS 110
+
+enum
+{
+  PROP_0,
+  PROP_RECOVERED,
+};
+
+typedef struct
+{
+  guint16 seq;
+  guint32 ssrc;
+  GstBuffer *buffer;
+} MediaSlot;
+
+typedef struct
+{
+  /* The protected SSRC */
+  guint32 ssrc;
+  guint16 seq_base;
+  gboolean rs;
+
+  /* Parity: offsets from seq_base of the protected packets.
+   * Reed-Solomon: number of packets in the block and index of the repair */
+  guint64 mask[2];
+  guint n_protected;
+  guint index;
+
+  /* The repair FEC bit string, the bit string header without R and F
+   * followed by the repair payload */
+  guint8 *data;
+  gsize len;
+
+  /* Used up or useless, to be removed from the queue */
+  gboolean done;
+} RepairItem;
+
+struct _GstRtpFlexFecDecClass
+{
+  GstElementClass class;
+};
+
+struct _GstRtpFlexFecDec
+{
+  GstElement element;
+
+  GstPad *srcpad;
+  GstPad *sinkpad;
+  GList *fec_sinkpads;
+
+  /* All the following fields are protected by the OBJECT_LOCK */
+  MediaSlot *packets;
+  GQueue repairs;
+  GstClockTime max_arrival_time;
+  guint recovered;
+};
+
+#define RTP_CAPS "application/x-rtp"
+
+static GstStaticPadTemplate fec_sink_template =
+GST_STATIC_PAD_TEMPLATE ("fec_%u",
+    GST_PAD_SINK,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS (RTP_CAPS));
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (RTP_CAPS));
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (RTP_CAPS));
+
+#define gst_rtp_flexfec_dec_parent_class parent_class
+G_DEFINE_TYPE (GstRtpFlexFecDec, gst_rtp_flexfec_dec, GST_TYPE_ELEMENT);
+GST_ELEMENT_REGISTER_DEFINE (rtpflexfecdec, "rtpflexfecdec",
+    GST_RANK_NONE, GST_TYPE_RTP_FLEXFEC_DEC);
+
+static void
+free_repair (RepairItem * repair)
+{
+  g_free (repair->data);
+  g_free (repair);
+}
+
+static GstBuffer *
+lookup_media_packet (GstRtpFlexFecDec * dec, guint32 ssrc, guint16 seq)
+{
+  MediaSlot *slot = &dec->packets[seq % STORAGE_SIZE];
+
+  if (slot->buffer && slot->seq == seq && slot->ssrc == ssrc)
+    return slot->buffer;
+
+  return NULL;
+}
+
+/* Takes ownership of @buffer */
+static void
+store_media_packet (GstRtpFlexFecDec * dec, guint32 ssrc, guint16 seq,
+    GstBuffer * buffer)
+{
+  MediaSlot *slot = &dec->packets[seq % STORAGE_SIZE];
+
+  if (slot->buffer)
+    gst_buffer_unref (slot->buffer);
+
+  slot->seq = seq;
+  slot->ssrc = ssrc;
+  slot->buffer = buffer;
+}
+
+static gboolean
+repair_protects (RepairItem * repair, guint32 ssrc, guint16 seq)
+{
+  guint offset = (guint16) (seq - repair->seq_base);
+
+  if (repair->ssrc != ssrc)
+    return FALSE;
+
+  if (repair->rs)
+    return offset < repair->n_protected;
+
+  return offset < MAX_MASK_BITS
+      && ((repair->mask[offset / 64] >> (offset % 64)) & 1);
+}
+
+static RepairItem *
+parse_repair (GstRtpFlexFecDec * dec, GstPad * pad, GstRTPBuffer * rtp)
+{
+  RepairItem *repair;
+  guint8 *payload = gst_rtp_buffer_get_payload (rtp);
+  guint len = gst_rtp_buffer_get_payload_len (rtp);
+  guint header_len;
+
+  if (gst_rtp_buffer_get_csrc_count (rtp) < 1) {
+    GST_WARNING_OBJECT (pad, "Repair packet without protected SSRC");
+    return NULL;
+  }
+
+  if (len < RTP_FEC_BITSTRING_HEADER_LEN + 4) {
+    GST_WARNING_OBJECT (pad, "Repair packet too short (payload len: %u)", len);
+    return NULL;
+  }
+
+  repair = g_new0 (RepairItem, 1);
+  repair->ssrc = gst_rtp_buffer_get_csrc (rtp, 0);
+  repair->seq_base = GST_READ_UINT16_BE (payload +
+      RTP_FEC_BITSTRING_HEADER_LEN);
+
+  switch (payload[0] >> 6) {
+    case 0:{
+      GstBitReader bits;
+      guint n_bits = MAX_MASK_BITS;
+      guint8 bit;
+      guint i;
+
+      gst_bit_reader_init (&bits, payload + RTP_FEC_BITSTRING_HEADER_LEN + 2,
+          len - RTP_FEC_BITSTRING_HEADER_LEN - 2);
+
+      for (i = 0; i < n_bits; i++) {
+        if (i == 0 || i == 15) {
+          if (!gst_bit_reader_get_bits_uint8 (&bits, &bit, 1))
+            goto invalid;
+          if (bit)
+            n_bits = i == 0 ? 15 : 46;
+        }
+
+        if (!gst_bit_reader_get_bits_uint8 (&bits, &bit, 1))
+          goto invalid;
+
+        if (bit) {
+          repair->mask[i / 64] |= G_GUINT64_CONSTANT (1) << (i % 64);
+          repair->n_protected++;
+        }
+      }
+
+      header_len = RTP_FEC_BITSTRING_HEADER_LEN + 2 + (n_bits + 2) / 8;
+      break;
+    }
+    case 3:
+      repair->rs = TRUE;
+      repair->n_protected = payload[RTP_FEC_BITSTRING_HEADER_LEN + 2];
+      repair->index = payload[RTP_FEC_BITSTRING_HEADER_LEN + 3];
+      header_len = RTP_FEC_RS_HEADER_LEN;
+
+      if (repair->n_protected == 0
+          || repair->n_protected > RTP_FEC_RS_MAX_SOURCES
+          || repair->index >= RTP_FEC_RS_MAX_REPAIRS)
+        goto invalid;
+      break;
+    default:
+      GST_DEBUG_OBJECT (pad, "Repair packets with fixed L/D masks or "
+          "retransmissions are not supported");
+      free_repair (repair);
+      return NULL;
+  }
+
+  if (len < header_len)
+    goto invalid;
+
+  repair->len = RTP_FEC_BITSTRING_HEADER_LEN + len - header_len;
+  repair->data = g_malloc (repair->len);
+  memcpy (repair->data, payload, RTP_FEC_BITSTRING_HEADER_LEN);
+  if (repair->rs)
+    repair->data[0] = payload[RTP_FEC_BITSTRING_HEADER_LEN + 4];
+  else
+    repair->data[0] &= 0x3f;
+  memcpy (repair->data + RTP_FEC_BITSTRING_HEADER_LEN, payload + header_len,
+      len - header_len);
+
+  GST_TRACE_OBJECT (pad, "Handling %s repair packet, SN base %u, SSRC %08x",
+      repair->rs ? "Reed-Solomon" : "parity", repair->seq_base, repair->ssrc);
+
+  return repair;
+
+invalid:
+  GST_WARNING_OBJECT (pad, "Failed to parse repair packet (payload len: %u)",
+      len);
+  GST_MEMDUMP_OBJECT (pad, "Invalid payload", payload, len);
+  free_repair (repair);
+  return NULL;
+}
+
+/* Adds @coeff times the FEC bit string of @buffer to @bitstring */
+static void
+add_media_packet (guint8 * bitstring, gsize len, GstBuffer * buffer,
+    guint8 coeff)
+{
+  guint8 header[RTP_FEC_BITSTRING_HEADER_LEN];
+  GstMapInfo map;
+
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+
+  rtp_fec_bitstring_header (map.data, map.size, header);
+  rtp_fec_gf256_mul_add (bitstring, header, coeff,
+      RTP_FEC_BITSTRING_HEADER_LEN);
+  rtp_fec_gf256_mul_add (bitstring + RTP_FEC_BITSTRING_HEADER_LEN,
+      map.data + 12, coeff, MIN (map.size - 12,
+          len - RTP_FEC_BITSTRING_HEADER_LEN));
+
+  gst_buffer_unmap (buffer, &map);
+}
+
+static void
+recover_packet (GstRtpFlexFecDec * dec, guint32 ssrc, guint16 seq,
+    const guint8 * bitstring, gsize len, GstBufferList ** recovered)
+{
+  guint16 length = GST_READ_UINT16_BE (bitstring + 2);
+  GstBuffer *buffer;
+  guint8 *data;
+
+  if (length > len - RTP_FEC_BITSTRING_HEADER_LEN) {
+    GST_WARNING_OBJECT (dec, "Recovered length %u exceeds repair payload "
+        "length %" G_GSIZE_FORMAT, length, len - RTP_FEC_BITSTRING_HEADER_LEN);
+    return;
+  }
+
+  data = g_malloc (12 + length);
+  data[0] = 0x80 | (bitstring[0] & 0x3f);
+  data[1] = bitstring[1];
+  GST_WRITE_UINT16_BE (data + 2, seq);
+  memcpy (data + 4, bitstring + 4, 4);
+  GST_WRITE_UINT32_BE (data + 8, ssrc);
+  memcpy (data + 12, bitstring + RTP_FEC_BITSTRING_HEADER_LEN, length);
+
+  buffer = gst_buffer_new_wrapped (data, 12 + length);
+  GST_BUFFER_DTS (buffer) = dec->max_arrival_time;
+
+  GST_DEBUG_OBJECT (dec, "Recovered packet with seqnum %u, SSRC %08x and "
+      "timestamp %u", seq, ssrc, GST_READ_UINT32_BE (data + 4));
+
+  store_media_packet (dec, ssrc, seq, gst_buffer_ref (buffer));
+  dec->recovered++;
+
+  if (!*recovered)
+    *recovered = gst_buffer_list_new ();
+  gst_buffer_list_add (*recovered, buffer);
+}
+
+/* Returns TRUE if a packet was recovered */
+static gboolean
+recover_parity (GstRtpFlexFecDec * dec, RepairItem * repair,
+    GstBufferList ** recovered)
+{
+  guint n_missing = 0;
+  guint16 missing_seq = 0;
+  guint8 *bitstring;
+  guint i;
+
+  for (i = 0; i < MAX_MASK_BITS; i++) {
+    guint16 seq = repair->seq_base + i;
+
+    if (!((repair->mask[i / 64] >> (i % 64)) & 1))
+      continue;
+
+    if (!lookup_media_packet (dec, repair->ssrc, seq)) {
+      missing_seq = seq;
+      if (++n_missing > 1)
+        return FALSE;
+    }
+  }
+
+  repair->done = TRUE;
+
+  if (n_missing == 0) {
+    GST_LOG_OBJECT (dec, "All media packets present, discarding repair "
+        "packet with SN base %u", repair->seq_base);
+    return FALSE;
+  }
+
+  bitstring = g_memdup2 (repair->data, repair->len);
+
+  for (i = 0; i < MAX_MASK_BITS; i++) {
+    GstBuffer *buffer;
+
+    if (!((repair->mask[i / 64] >> (i % 64)) & 1))
+      continue;
+
+    if ((buffer = lookup_media_packet (dec, repair->ssrc,
+                repair->seq_base + i)))
+      add_media_packet (bitstring, repair->len, buffer, 1);
+  }
+
+  recover_packet (dec, repair->ssrc, missing_seq, bitstring, repair->len,
+      recovered);
+  g_free (bitstring);
+
+  return TRUE;
+}
+
+/* Returns TRUE if packets were recovered */
+static gboolean
+recover_reed_solomon (GstRtpFlexFecDec * dec, RepairItem * repair,
+    GstBufferList ** recovered)
+{
+  RepairItem *block[RTP_FEC_RS_MAX_REPAIRS];
+  guint8 missing[RTP_FEC_RS_MAX_REPAIRS];
+  guint8 matrix[RTP_FEC_RS_MAX_REPAIRS * RTP_FEC_RS_MAX_REPAIRS];
+  guint n_repairs = 0, n_missing = 0;
+  guint8 *syndromes, *bitstring;
+  gsize len = 0;
+  guint i, r, c;
+  GList *l;
+
+  /* Gather the repair packets received for the block */
+  for (l = dec->repairs.head; l; l = l->next) {
+    RepairItem *other = l->data;
+
+    if (other->done || !other->rs || other->ssrc != repair->ssrc
+        || other->seq_base != repair->seq_base
+        || other->n_protected != repair->n_protected)
+      continue;
+
+    for (r = 0; r < n_repairs && block[r]->index != other->index; r++);
+    if (r == n_repairs)
+      block[n_repairs++] = other;
+  }
+
+  for (i = 0; i < repair->n_protected; i++) {
+    if (!lookup_media_packet (dec, repair->ssrc, repair->seq_base + i)) {
+      if (n_missing == n_repairs)
+        return FALSE;
+      missing[n_missing++] = i;
+    }
+  }
+
+  for (r = 0; r < n_repairs; r++)
+    block[r]->done = TRUE;
+
+  if (n_missing == 0) {
+    GST_LOG_OBJECT (dec, "All media packets present, discarding repair "
+        "packets with SN base %u", repair->seq_base);
+    return FALSE;
+  }
+
+  for (r = 0; r < n_missing; r++) {
+    len = MAX (len, block[r]->len);
+    for (c = 0; c < n_missing; c++)
+      matrix[r * n_missing + c] =
+          rtp_fec_rs_coefficient (block[r]->index, missing[c]);
+  }
+
+  if (!rtp_fec_gf256_invert_matrix (matrix, n_missing)) {
+    GST_WARNING_OBJECT (dec, "Can't invert Reed-Solomon coefficients");
+    return FALSE;
+  }
+
+  /* Remove the received packets from the repair packets, which leaves a
+   * combination of the missing packets only */
+  syndromes = g_malloc0 (n_missing * len);
+  for (r = 0; r < n_missing; r++)
+    memcpy (syndromes + r * len, block[r]->data, block[r]->len);
+
+  for (i = 0; i < repair->n_protected; i++) {
+    GstBuffer *buffer = lookup_media_packet (dec, repair->ssrc,
+        repair->seq_base + i);
+
+    if (!buffer)
+      continue;
+
+    for (r = 0; r < n_missing; r++)
+      add_media_packet (syndromes + r * len, len, buffer,
+          rtp_fec_rs_coefficient (block[r]->index, i));
+  }
+
+  bitstring = g_malloc (len);
+  for (c = 0; c < n_missing; c++) {
+    memset (bitstring, 0, len);
+    for (r = 0; r < n_missing; r++)
+      rtp_fec_gf256_mul_add (bitstring, syndromes + r * len,
+          matrix[c * n_missing + r], len);
+
+    recover_packet (dec, repair->ssrc, repair->seq_base + missing[c],
+        bitstring, len, recovered);
+  }
+
+  g_free (bitstring);
+  g_free (syndromes);
+
+  return TRUE;
+}
+
+static gboolean
+check_repair (GstRtpFlexFecDec * dec, RepairItem * repair,
+    GstBufferList ** recovered)
+{
+  if (repair->rs)
+    return recover_reed_solomon (dec, repair, recovered);
+
+  return recover_parity (dec, repair, recovered);
+}
+
+static void
+remove_done_repairs (GstRtpFlexFecDec * dec)
+{
+  GList *l, *next;
+
+  for (l = dec->repairs.head; l; l = next) {
+    RepairItem *repair = l->data;
+
+    next = l->next;
+    if (repair->done) {
+      free_repair (repair);
+      g_queue_delete_link (&dec->repairs, l);
+    }
+  }
+}
+
+/* Recovered packets can complete other repair packets, go over them
+ * until no more packets can be recovered */
+static void
+check_all_repairs (GstRtpFlexFecDec * dec, GstBufferList ** recovered)
+{
+  gboolean progress;
+
+  do {
+    GList *l;
+
+    progress = FALSE;
+    for (l = dec->repairs.head; l; l = l->next) {
+      RepairItem *repair = l->data;
+
+      if (!repair->done && check_repair (dec, repair, recovered))
+        progress = TRUE;
+    }
+
+    remove_done_repairs (dec);
+  } while (progress);
+}
+
+static GstFlowReturn
+gst_rtp_flexfec_dec_sink_chain_fec (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  GstRtpFlexFecDec *dec = GST_RTP_FLEXFEC_DEC_CAST (parent);
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstBufferList *recovered = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+  RepairItem *repair = NULL;
+
+  if (!gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp)) {
+    GST_WARNING_OBJECT (pad, "Chained FEC buffer isn't valid RTP");
+    goto done;
+  }
+
+  GST_OBJECT_LOCK (dec);
+
+  repair = parse_repair (dec, pad, &rtp);
+  gst_rtp_buffer_unmap (&rtp);
+
+  if (repair) {
+    g_queue_push_tail (&dec->repairs, repair);
+
+    if (check_repair (dec, repair, &recovered))
+      check_all_repairs (dec, &recovered);
+    remove_done_repairs (dec);
+
+    while (g_queue_get_length (&dec->repairs) > MAX_PENDING_REPAIRS)
+      free_repair (g_queue_pop_head (&dec->repairs));
+  }
+
+  GST_OBJECT_UNLOCK (dec);
+
+  if (recovered)
+    ret = gst_pad_push_list (dec->srcpad, recovered);
+
+done:
+  gst_buffer_unref (buffer);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_rtp_flexfec_dec_sink_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  GstRtpFlexFecDec *dec = GST_RTP_FLEXFEC_DEC_CAST (parent);
+  GstBufferList *recovered = NULL;
+  GstFlowReturn ret;
+  GstMapInfo map;
+
+  if (!gst_buffer_map (buffer, &map, GST_MAP_READ))
+    goto push;
+
+  if (map.size < 12 || (map.data[0] >> 6) != 2) {
+    GST_WARNING_OBJECT (pad, "Chained buffer isn't valid RTP");
+    gst_buffer_unmap (buffer, &map);
+    goto push;
+  }
+
+  GST_OBJECT_LOCK (dec);
+  dec->max_arrival_time =
+      MAX (dec->max_arrival_time, GST_BUFFER_DTS_OR_PTS (buffer));
+
+  store_media_packet (dec, GST_READ_UINT32_BE (map.data + 8),
+      GST_READ_UINT16_BE (map.data + 2), gst_buffer_ref (buffer));
+
+  if (!g_queue_is_empty (&dec->repairs)) {
+    guint32 ssrc = GST_READ_UINT32_BE (map.data + 8);
+    guint16 seq = GST_READ_UINT16_BE (map.data + 2);
+    gboolean progress = FALSE;
+    GList *l;
+
+    /* Only the repair packets protecting this one can have changed */
+    for (l = dec->repairs.head; l; l = l->next) {
+      RepairItem *repair = l->data;
+
+      if (!repair->done && repair_protects (repair, ssrc, seq)
+          && check_repair (dec, repair, &recovered))
+        progress = TRUE;
+    }
+
+    if (progress)
+      check_all_repairs (dec, &recovered);
+    remove_done_repairs (dec);
+  }
+  GST_OBJECT_UNLOCK (dec);
+
+  gst_buffer_unmap (buffer, &map);
+
+push:
+  ret = gst_pad_push (dec->srcpad, buffer);
+
+  if (recovered) {
+    if (ret == GST_FLOW_OK)
+      ret = gst_pad_push_list (dec->srcpad, recovered);
+    else
+      gst_buffer_list_unref (recovered);
+  }
+
+  return ret;
+}
+
+/* Takes the object lock */
+static void
+gst_rtp_flexfec_dec_reset (GstRtpFlexFecDec * dec, gboolean allocate)
+{
+  guint i;
+
+  GST_OBJECT_LOCK (dec);
+
+  if (dec->packets) {
+    for (i = 0; i < STORAGE_SIZE; i++) {
+      if (dec->packets[i].buffer)
+        gst_buffer_unref (dec->packets[i].buffer);
+    }
+    g_free (dec->packets);
+    dec->packets = NULL;
+  }
+
+  g_queue_clear_full (&dec->repairs, (GDestroyNotify) free_repair);
+
+  if (allocate)
+    dec->packets = g_new0 (MediaSlot, STORAGE_SIZE);
+
+  dec->max_arrival_time = 0;
+
+  GST_OBJECT_UNLOCK (dec);
+}
+
+static GstStateChangeReturn
+gst_rtp_flexfec_dec_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstStateChangeReturn ret;
+  GstRtpFlexFecDec *dec = GST_RTP_FLEXFEC_DEC_CAST (element);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      gst_rtp_flexfec_dec_reset (dec, TRUE);
+      break;
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_rtp_flexfec_dec_reset (dec, FALSE);
+      break;
+    default:
+      break;
+  }
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  return ret;
+}
+
+static void
+gst_rtp_flexfec_dec_finalize (GObject * object)
+{
+  GstRtpFlexFecDec *dec = GST_RTP_FLEXFEC_DEC_CAST (object);
+
+  gst_rtp_flexfec_dec_reset (dec, FALSE);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_rtp_flexfec_dec_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstRtpFlexFecDec *dec = GST_RTP_FLEXFEC_DEC_CAST (object);
+
+  switch (prop_id) {
+    case PROP_RECOVERED:
+      GST_OBJECT_LOCK (dec);
+      g_value_set_uint (value, dec->recovered);
+      GST_OBJECT_UNLOCK (dec);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static gboolean
+gst_rtp_flexfec_dec_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstRtpFlexFecDec *dec = GST_RTP_FLEXFEC_DEC_CAST (parent);
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP)
+    gst_rtp_flexfec_dec_reset (dec, TRUE);
+
+  return gst_pad_event_default (pad, parent, event);
+}
+
+static GstIterator *
+gst_rtp_flexfec_dec_iterate_linked_pads (GstPad * pad, GstObject * parent)
+{
+  GstRtpFlexFecDec *dec = GST_RTP_FLEXFEC_DEC_CAST (parent);
+  GstPad *otherpad = NULL;
+  GstIterator *it = NULL;
+  GValue val = { 0, };
+
+  if (pad == dec->srcpad)
+    otherpad = dec->sinkpad;
+  else if (pad == dec->sinkpad)
+    otherpad = dec->srcpad;
+
+  if (otherpad) {
+    g_value_init (&val, GST_TYPE_PAD);
+    g_value_set_object (&val, otherpad);
+    it = gst_iterator_new_single (GST_TYPE_PAD, &val);
+    g_value_unset (&val);
+  }
+
+  return it;
+}
+
+static GstPad *
+gst_rtp_flexfec_dec_request_new_pad (GstElement * element,
+    GstPadTemplate * templ, const gchar * name, const GstCaps * caps)
+{
+  GstRtpFlexFecDec *dec = GST_RTP_FLEXFEC_DEC_CAST (element);
+  GstPad *sinkpad;
+
+  GST_DEBUG_OBJECT (element, "requesting pad");
+
+  sinkpad = gst_pad_new_from_template (templ, name);
+  gst_pad_set_chain_function (sinkpad,
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_dec_sink_chain_fec));
+  gst_pad_set_iterate_internal_links_function (sinkpad,
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_dec_iterate_linked_pads));
+  gst_element_add_pad (GST_ELEMENT (dec), sinkpad);
+
+  gst_pad_set_active (sinkpad, TRUE);
+  dec->fec_sinkpads = g_list_prepend (dec->fec_sinkpads, sinkpad);
+
+  GST_DEBUG_OBJECT (element, "requested pad %s:%s",
+      GST_DEBUG_PAD_NAME (sinkpad));
+
+  return sinkpad;
+}
+
+static void
+gst_rtp_flexfec_dec_release_pad (GstElement * element, GstPad * pad)
+{
+  GstRtpFlexFecDec *dec = GST_RTP_FLEXFEC_DEC_CAST (element);
+
+  GST_DEBUG_OBJECT (element, "releasing pad %s:%s", GST_DEBUG_PAD_NAME (pad));
+
+  dec->fec_sinkpads = g_list_remove (dec->fec_sinkpads, pad);
+
+  gst_pad_set_active (pad, FALSE);
+  gst_element_remove_pad (GST_ELEMENT_CAST (dec), pad);
+}
+
+static void
+gst_rtp_flexfec_dec_class_init (GstRtpFlexFecDecClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *gstelement_class = GST_ELEMENT_CLASS (klass);
+
+  gobject_class->get_property =
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_dec_get_property);
+  gobject_class->finalize = GST_DEBUG_FUNCPTR (gst_rtp_flexfec_dec_finalize);
+
+  g_object_class_install_property (gobject_class, PROP_RECOVERED,
+      g_param_spec_uint ("recovered", "Recovered",
+          "The number of recovered packets", 0, G_MAXUINT, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  gstelement_class->change_state =
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_dec_change_state);
+  gstelement_class->request_new_pad =
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_dec_request_new_pad);
+  gstelement_class->release_pad =
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_dec_release_pad);
+
+  gst_element_class_set_static_metadata (gstelement_class,
+      "RTP FlexFEC decoder", "Codec/Decoder/Network/RTP",
+      "Recovers lost RTP packets from repair packets as described by RFC 8627",
+      "GStreamer developers <gstreamer-devel@lists.freedesktop.org>");
+
+  gst_element_class_add_static_pad_template (gstelement_class, &sink_template);
+  gst_element_class_add_static_pad_template (gstelement_class,
+      &fec_sink_template);
+  gst_element_class_add_static_pad_template (gstelement_class, &src_template);
+
+  GST_DEBUG_CATEGORY_INIT (gst_rtp_flexfec_dec_debug,
+      "rtpflexfecdec", 0, "RTP FlexFEC decoder element");
+}
+
+static void
+gst_rtp_flexfec_dec_init (GstRtpFlexFecDec * dec)
+{
+  dec->srcpad = gst_pad_new_from_static_template (&src_template, "src");
+  GST_PAD_SET_PROXY_CAPS (dec->srcpad);
+  gst_pad_use_fixed_caps (dec->srcpad);
+  gst_pad_set_iterate_internal_links_function (dec->srcpad,
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_dec_iterate_linked_pads));
+  gst_element_add_pad (GST_ELEMENT (dec), dec->srcpad);
+
+  dec->sinkpad = gst_pad_new_from_static_template (&sink_template, "sink");
+  GST_PAD_SET_PROXY_CAPS (dec->sinkpad);
+  gst_pad_set_chain_function (dec->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_dec_sink_chain));
+  gst_pad_set_event_function (dec->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_dec_sink_event));
+  gst_pad_set_iterate_internal_links_function (dec->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_dec_iterate_linked_pads));
+  gst_element_add_pad (GST_ELEMENT (dec), dec->sinkpad);
+
+  g_queue_init (&dec->repairs);
+}
@@ -0,0 +1,793 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-rtpflexfecenc
+ * @see_also: #element-rtpflexfecdec, #element-rtpst2022-1-fecenc
+ *
+ * This element protects a media stream with repair packets as described in
+ * RFC 8627: RTP Payload Format for Flexible Forward Error Correction (FEC).
+ *
+ * The media packets are arranged in blocks of #GstRtpFlexFecEnc:columns
+ * packets times #GstRtpFlexFecEnc:rows packets. In the default "xor" mode,
+ * a repair packet is sent for each row of the block, and one for each
+ * column if #GstRtpFlexFecEnc:rows is not 0. The repair packets use the
+ * flexible mask format, so any FlexFEC receiver can make use of them.
+ *
+ * In "reed-solomon" mode, #GstRtpFlexFecEnc:repair-packets repair packets
+ * are sent for each block, and any combination of as many lost packets in
+ * the block can be recovered, which copes with loss bursts much better than
+ * parity. RFC 8627 only defines parity repair packets, the Reed-Solomon
+ * ones are signalled with the otherwise reserved R=1 F=1 header bits and
+ * can only be used by #element-rtpflexfecdec.
+ *
+ * The repair packets are pushed on the fec_0 pad, after the media packet
+ * that completed them.
+ *
+ * ## Example pipeline
+ *
+ * ``` shell
+ * gst-launch-1.0 \
+ *   rtpbin name=rtp fec-encoders='fec,0="rtpflexfecenc\ columns\=10\ rows\=4\ mode\=reed-solomon\ repair-packets\=4";' \
+ *   uridecodebin uri=file:///path/to/video/file ! x264enc key-int-max=60 tune=zerolatency ! \
+ *     queue ! mpegtsmux ! rtpmp2tpay ssrc=0 ! rtp.send_rtp_sink_0 \
+ *   rtp.send_rtp_src_0 ! udpsink host=127.0.0.1 port=5000 \
+ *   rtp.send_fec_src_0_0 ! udpsink host=127.0.0.1 port=5002 async=false
+ * ```
+ *
+ * Since: 1.22
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/base/base.h>
+#include <gst/rtp/gstrtpbuffer.h>
+
+#include "gstrtpflexfecenc.h"
+#include "rtpfec.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_rtp_flexfec_enc_debug);
+#define GST_CAT_DEFAULT gst_rtp_flexfec_enc_debug
+
+typedef enum
+{
+  GST_RTP_FLEXFEC_MODE_XOR,
+  GST_RTP_FLEXFEC_MODE_REED_SOLOMON,
+} GstRtpFlexFecMode;
+
+#define GST_TYPE_RTP_FLEXFEC_MODE (gst_rtp_flexfec_mode_get_type ())
+static GType
+gst_rtp_flexfec_mode_get_type (void)
+{
+  static GType mode_type = 0;
+  static const GEnumValue modes[] = {
+    {GST_RTP_FLEXFEC_MODE_XOR, "Row and column parity (RFC 8627)", "xor"},
+    {GST_RTP_FLEXFEC_MODE_REED_SOLOMON,
+        "Reed-Solomon over the whole block", "reed-solomon"},
+    {0, NULL, NULL},
+  };
+
+  if (!mode_type)
+    mode_type = g_enum_register_static ("GstRtpFlexFecMode", modes);
+
+  return mode_type;
+}
+
+enum
+{
+  PROP_0,
+  PROP_COLUMNS,
+  PROP_ROWS,
+  PROP_PT,
+  PROP_SSRC,
+  PROP_MODE,
+  PROP_REPAIR_PACKETS,
+};
+
+#define DEFAULT_COLUMNS 10
+#define DEFAULT_ROWS 0
+#define DEFAULT_PT 96
+#define DEFAULT_SSRC G_MAXUINT
+#define DEFAULT_MODE GST_RTP_FLEXFEC_MODE_XOR
+#define DEFAULT_REPAIR_PACKETS 2
+
+/* Longest flexible mask of RFC 8627 section 4.2.2.1 */
+#define MAX_MASK_BITS 110
+
+typedef struct
+{
+  /* FEC bit strings of the protected packets combined, allocation is
+   * kept from one block to the next */
+  guint8 *data;
+  gsize len;
+  gsize alloc;
+
+  guint16 seq_base;
+  guint n_packets;
+
+  /* Offsets from seq_base of the protected packets */
+  guint64 mask[2];
+  guint max_offset;
+} Repair;
+
+struct _GstRtpFlexFecEncClass
+{
+  GstElementClass class;
+};
+
+struct _GstRtpFlexFecEnc
+{
+  GstElement element;
+
+  GstPad *srcpad;
+  GstPad *sinkpad;
+
+  /* Does not participate in the flow return of the element */
+  GstPad *fec_srcpad;
+
+  /* Properties, only settable in state < PAUSED */
+  guint l;
+  guint d;
+  gint pt;
+  guint ssrc;
+  GstRtpFlexFecMode mode;
+  guint n_repairs;
+
+  /* The following fields are only accessed on state change or from the
+   * streaming thread */
+  gboolean events_pushed;
+  guint32 current_ssrc;
+  guint16 seq;
+
+  gboolean last_media_seqnum_set;
+  guint16 last_media_seqnum;
+  guint32 last_media_timestamp;
+  guint32 media_ssrc;
+
+  /* Position of the next media packet in the current block */
+  guint position;
+
+  Repair row;
+  /* enc->l column repairs */
+  Repair *columns;
+  /* enc->n_repairs Reed-Solomon repairs */
+  Repair *rs;
+};
+
+#define RTP_CAPS "application/x-rtp"
+
+static GstStaticPadTemplate fec_src_template =
+GST_STATIC_PAD_TEMPLATE ("fec_%u",
+    GST_PAD_SRC,
+    GST_PAD_SOMETIMES,
+    GST_STATIC_CAPS (RTP_CAPS));
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (RTP_CAPS));
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (RTP_CAPS));
+
+#define gst_rtp_flexfec_enc_parent_class parent_class
+G_DEFINE_TYPE (GstRtpFlexFecEnc, gst_rtp_flexfec_enc, GST_TYPE_ELEMENT);
+GST_ELEMENT_REGISTER_DEFINE (rtpflexfecenc, "rtpflexfecenc",
+    GST_RANK_NONE, GST_TYPE_RTP_FLEXFEC_ENC);
+
+static void
+repair_add (Repair * repair, guint16 seq, const guint8 * header,
+    const guint8 * body, gsize body_len, guint8 coeff)
+{
+  gsize len = RTP_FEC_BITSTRING_HEADER_LEN + body_len;
+  guint offset;
+
+  if (repair->n_packets == 0) {
+    repair->seq_base = seq;
+    repair->len = 0;
+    repair->max_offset = 0;
+    memset (repair->mask, 0, sizeof (repair->mask));
+  }
+
+  if (repair->alloc < len) {
+    repair->data = g_realloc (repair->data, len);
+    repair->alloc = len;
+  }
+
+  /* Shorter bit strings are padded with zeroes */
+  if (repair->len < len) {
+    memset (repair->data + repair->len, 0, len - repair->len);
+    repair->len = len;
+  }
+
+  rtp_fec_gf256_mul_add (repair->data, header, coeff,
+      RTP_FEC_BITSTRING_HEADER_LEN);
+  rtp_fec_gf256_mul_add (repair->data + RTP_FEC_BITSTRING_HEADER_LEN, body,
+      coeff, body_len);
+
+  offset = (guint16) (seq - repair->seq_base);
+  if (offset < MAX_MASK_BITS) {
+    repair->mask[offset / 64] |= G_GUINT64_CONSTANT (1) << (offset % 64);
+    repair->max_offset = MAX (repair->max_offset, offset);
+  }
+
+  repair->n_packets++;
+}
+
+static void
+repair_clear (Repair * repair)
+{
+  g_free (repair->data);
+  memset (repair, 0, sizeof (Repair));
+}
+
+/* Writes the flexible mask with its k bits, @n_bits is 15, 46 or 110 */
+static void
+write_mask (const Repair * repair, guint8 * data, guint n_bits)
+{
+  GstBitWriter bits;
+  guint i;
+
+  gst_bit_writer_init_with_data (&bits, data, (n_bits + 2) / 8, FALSE);
+
+  for (i = 0; i < n_bits; i++) {
+    if (i == 0)
+      gst_bit_writer_put_bits_uint8 (&bits, n_bits == 15, 1);   /* k */
+    else if (i == 15)
+      gst_bit_writer_put_bits_uint8 (&bits, n_bits == 46, 1);   /* k */
+
+    gst_bit_writer_put_bits_uint8 (&bits,
+        (repair->mask[i / 64] >> (i % 64)) & 1, 1);
+  }
+
+  gst_bit_writer_reset (&bits);
+}
+
+static GstBufferList *
+queue_repair_packet (GstRtpFlexFecEnc * enc, GstBufferList * list,
+    Repair * repair, gboolean rs, guint index, GstBuffer * media)
+{
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  gsize body_len = repair->len - RTP_FEC_BITSTRING_HEADER_LEN;
+  guint header_len, n_bits = 0;
+  GstBuffer *buffer;
+  guint8 *data;
+
+  if (rs) {
+    header_len = RTP_FEC_RS_HEADER_LEN;
+  } else {
+    if (repair->max_offset < 15)
+      n_bits = 15;
+    else if (repair->max_offset < 46)
+      n_bits = 46;
+    else
+      n_bits = MAX_MASK_BITS;
+
+    /* bit string header, SN base, mask and k bits */
+    header_len = RTP_FEC_BITSTRING_HEADER_LEN + 2 + (n_bits + 2) / 8;
+  }
+
+  buffer = gst_rtp_buffer_new_allocate (header_len + body_len, 0, 1);
+
+  gst_rtp_buffer_map (buffer, GST_MAP_WRITE, &rtp);
+  gst_rtp_buffer_set_payload_type (&rtp, enc->pt);
+  gst_rtp_buffer_set_seq (&rtp, enc->seq++);
+  gst_rtp_buffer_set_timestamp (&rtp, enc->last_media_timestamp);
+  gst_rtp_buffer_set_ssrc (&rtp, enc->current_ssrc);
+  /* The protected SSRC */
+  gst_rtp_buffer_set_csrc (&rtp, 0, enc->media_ssrc);
+
+  data = gst_rtp_buffer_get_payload (&rtp);
+  memcpy (data, repair->data, RTP_FEC_BITSTRING_HEADER_LEN);
+  /* The version bits of the bit string are replaced with R and F */
+  data[0] = (data[0] & 0x3f) | (rs ? 0xc0 : 0x00);
+  GST_WRITE_UINT16_BE (data + RTP_FEC_BITSTRING_HEADER_LEN, repair->seq_base);
+
+  if (rs) {
+    data[RTP_FEC_BITSTRING_HEADER_LEN + 2] = repair->n_packets;
+    data[RTP_FEC_BITSTRING_HEADER_LEN + 3] = index;
+    /* Reed-Solomon combines the whole first byte of the protected packets,
+     * unlike with XOR its top bits can not be restored from R and F */
+    data[RTP_FEC_BITSTRING_HEADER_LEN + 4] = repair->data[0];
+  } else {
+    write_mask (repair, data + RTP_FEC_BITSTRING_HEADER_LEN + 2, n_bits);
+  }
+
+  memcpy (data + header_len, repair->data + RTP_FEC_BITSTRING_HEADER_LEN,
+      body_len);
+
+  gst_rtp_buffer_unmap (&rtp);
+
+  GST_BUFFER_PTS (buffer) = GST_BUFFER_PTS (media);
+  GST_BUFFER_DTS (buffer) = GST_BUFFER_DTS (media);
+
+  GST_LOG_OBJECT (enc, "Queueing %s repair packet %u, seq base: %u, "
+      "%u packets", rs ? "Reed-Solomon" : "parity", index, repair->seq_base,
+      repair->n_packets);
+
+  repair->n_packets = 0;
+
+  if (!list)
+    list = gst_buffer_list_new ();
+  gst_buffer_list_add (list, buffer);
+
+  return list;
+}
+
+static void
+gst_rtp_flexfec_enc_reset_block (GstRtpFlexFecEnc * enc)
+{
+  guint i;
+
+  enc->row.n_packets = 0;
+
+  if (enc->columns) {
+    for (i = 0; i < enc->l; i++)
+      enc->columns[i].n_packets = 0;
+  }
+
+  if (enc->rs) {
+    for (i = 0; i < enc->n_repairs; i++)
+      enc->rs[i].n_packets = 0;
+  }
+
+  enc->position = 0;
+}
+
+static void
+push_initial_events (GstRtpFlexFecEnc * enc)
+{
+  GstStructure *s;
+  gchar *stream_id;
+  GstCaps *caps, *media_caps;
+  GstSegment segment;
+  gint clock_rate;
+
+  stream_id =
+      gst_pad_create_stream_id (enc->fec_srcpad, GST_ELEMENT (enc), "fec");
+  gst_pad_push_event (enc->fec_srcpad, gst_event_new_stream_start (stream_id));
+  g_free (stream_id);
+
+  caps = gst_caps_new_simple ("application/x-rtp",
+      "media", G_TYPE_STRING, "application",
+      "encoding-name", G_TYPE_STRING, "FLEXFEC",
+      "payload", G_TYPE_INT, enc->pt,
+      "ssrc", G_TYPE_UINT, enc->current_ssrc, NULL);
+
+  media_caps = gst_pad_get_current_caps (enc->sinkpad);
+  if (media_caps) {
+    s = gst_caps_get_structure (media_caps, 0);
+    if (gst_structure_get_int (s, "clock-rate", &clock_rate))
+      gst_caps_set_simple (caps, "clock-rate", G_TYPE_INT, clock_rate, NULL);
+    gst_caps_unref (media_caps);
+  }
+
+  gst_pad_push_event (enc->fec_srcpad, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (enc->fec_srcpad, gst_event_new_segment (&segment));
+}
+
+static GstFlowReturn
+gst_rtp_flexfec_enc_sink_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  GstRtpFlexFecEnc *enc = GST_RTP_FLEXFEC_ENC_CAST (parent);
+  guint8 header[RTP_FEC_BITSTRING_HEADER_LEN];
+  GstBufferList *repairs = NULL;
+  GstFlowReturn ret;
+  GstMapInfo map;
+  const guint8 *body;
+  gsize body_len;
+  guint16 seq;
+  guint32 ssrc;
+  guint row, column, i;
+
+  if (!gst_buffer_map (buffer, &map, GST_MAP_READ))
+    goto push;
+
+  if (map.size < 12 || (map.data[0] >> 6) != 2) {
+    GST_WARNING_OBJECT (enc, "Chained buffer isn't valid RTP, not protected");
+    gst_buffer_unmap (buffer, &map);
+    goto push;
+  }
+
+  seq = GST_READ_UINT16_BE (map.data + 2);
+  ssrc = GST_READ_UINT32_BE (map.data + 8);
+
+  if (enc->last_media_seqnum_set && (enc->media_ssrc != ssrc
+          || (guint16) (enc->last_media_seqnum + 1) != seq)) {
+    GST_WARNING_OBJECT (enc, "Discontinuity (seq %u after %u, ssrc %08x "
+        "after %08x), restarting FEC block", seq, enc->last_media_seqnum,
+        ssrc, enc->media_ssrc);
+    gst_rtp_flexfec_enc_reset_block (enc);
+  }
+
+  if (!enc->events_pushed) {
+    push_initial_events (enc);
+    enc->events_pushed = TRUE;
+  }
+
+  enc->last_media_seqnum = seq;
+  enc->last_media_seqnum_set = TRUE;
+  enc->last_media_timestamp = GST_READ_UINT32_BE (map.data + 4);
+  enc->media_ssrc = ssrc;
+
+  rtp_fec_bitstring_header (map.data, map.size, header);
+  body = map.data + 12;
+  body_len = map.size - 12;
+
+  row = enc->position / enc->l;
+  column = enc->position % enc->l;
+
+  if (enc->mode == GST_RTP_FLEXFEC_MODE_XOR) {
+    repair_add (&enc->row, seq, header, body, body_len, 1);
+    if (column == enc->l - 1)
+      repairs = queue_repair_packet (enc, repairs, &enc->row, FALSE, 0, buffer);
+
+    if (enc->d) {
+      Repair *repair = &enc->columns[column];
+
+      repair_add (repair, seq, header, body, body_len, 1);
+      if (row == enc->d - 1)
+        repairs = queue_repair_packet (enc, repairs, repair, FALSE, 0, buffer);
+    }
+  } else {
+    for (i = 0; i < enc->n_repairs; i++)
+      repair_add (&enc->rs[i], seq, header, body, body_len,
+          rtp_fec_rs_coefficient (i, enc->position));
+
+    if (enc->position == enc->l * MAX (enc->d, 1) - 1) {
+      for (i = 0; i < enc->n_repairs; i++)
+        repairs = queue_repair_packet (enc, repairs, &enc->rs[i], TRUE, i,
+            buffer);
+    }
+  }
+
+  enc->position = (enc->position + 1) % (enc->l * MAX (enc->d, 1));
+
+  gst_buffer_unmap (buffer, &map);
+
+push:
+  ret = gst_pad_push (enc->srcpad, buffer);
+
+  if (repairs) {
+    GstFlowReturn fec_ret = gst_pad_push_list (enc->fec_srcpad, repairs);
+
+    if (fec_ret != GST_FLOW_OK && fec_ret != GST_FLOW_FLUSHING)
+      GST_WARNING_OBJECT (enc->fec_srcpad,
+          "Failed to push repair packets: %s", gst_flow_get_name (fec_ret));
+  }
+
+  return ret;
+}
+
+static GstIterator *
+gst_rtp_flexfec_enc_iterate_linked_pads (GstPad * pad, GstObject * parent)
+{
+  GstRtpFlexFecEnc *enc = GST_RTP_FLEXFEC_ENC_CAST (parent);
+  GstPad *otherpad = NULL;
+  GstIterator *it = NULL;
+  GValue val = { 0, };
+
+  if (pad == enc->srcpad)
+    otherpad = enc->sinkpad;
+  else if (pad == enc->sinkpad)
+    otherpad = enc->srcpad;
+
+  if (otherpad) {
+    g_value_init (&val, GST_TYPE_PAD);
+    g_value_set_object (&val, otherpad);
+    it = gst_iterator_new_single (GST_TYPE_PAD, &val);
+    g_value_unset (&val);
+  }
+
+  return it;
+}
+
+static gboolean
+gst_rtp_flexfec_enc_check_settings (GstRtpFlexFecEnc * enc)
+{
+  guint block_size = enc->l * MAX (enc->d, 1);
+
+  if (enc->mode == GST_RTP_FLEXFEC_MODE_XOR) {
+    /* The offsets of the protected packets must fit in the mask */
+    if (enc->l > MAX_MASK_BITS || (enc->d && (enc->d - 1) * enc->l >=
+            MAX_MASK_BITS)) {
+      GST_ELEMENT_ERROR (enc, LIBRARY, SETTINGS, (NULL),
+          ("%u columns and %u rows exceed the %u packets a FlexFEC mask "
+              "can protect", enc->l, enc->d, MAX_MASK_BITS));
+      return FALSE;
+    }
+  } else if (block_size > RTP_FEC_RS_MAX_SOURCES) {
+    GST_ELEMENT_ERROR (enc, LIBRARY, SETTINGS, (NULL),
+        ("Reed-Solomon blocks are limited to %u packets, %u requested",
+            RTP_FEC_RS_MAX_SOURCES, block_size));
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static void
+gst_rtp_flexfec_enc_reset (GstRtpFlexFecEnc * enc, gboolean allocate)
+{
+  guint i;
+
+  repair_clear (&enc->row);
+
+  if (enc->columns) {
+    for (i = 0; i < enc->l; i++)
+      repair_clear (&enc->columns[i]);
+    g_free (enc->columns);
+    enc->columns = NULL;
+  }
+
+  if (enc->rs) {
+    for (i = 0; i < enc->n_repairs; i++)
+      repair_clear (&enc->rs[i]);
+    g_free (enc->rs);
+    enc->rs = NULL;
+  }
+
+  if (enc->fec_srcpad) {
+    gst_element_remove_pad (GST_ELEMENT (enc), enc->fec_srcpad);
+    enc->fec_srcpad = NULL;
+  }
+
+  if (allocate) {
+    if (enc->mode == GST_RTP_FLEXFEC_MODE_XOR)
+      enc->columns = g_new0 (Repair, enc->l);
+    else
+      enc->rs = g_new0 (Repair, enc->n_repairs);
+
+    enc->current_ssrc = enc->ssrc == G_MAXUINT ? g_random_int () : enc->ssrc;
+    enc->seq = g_random_int_range (0, G_MAXUINT16);
+
+    enc->fec_srcpad =
+        gst_pad_new_from_static_template (&fec_src_template, "fec_0");
+    gst_pad_set_active (enc->fec_srcpad, TRUE);
+    gst_pad_set_iterate_internal_links_function (enc->fec_srcpad,
+        GST_DEBUG_FUNCPTR (gst_rtp_flexfec_enc_iterate_linked_pads));
+    gst_element_add_pad (GST_ELEMENT (enc), enc->fec_srcpad);
+
+    gst_element_no_more_pads (GST_ELEMENT (enc));
+  }
+
+  enc->events_pushed = FALSE;
+  enc->last_media_seqnum_set = FALSE;
+  enc->position = 0;
+}
+
+static GstStateChangeReturn
+gst_rtp_flexfec_enc_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstStateChangeReturn ret;
+  GstRtpFlexFecEnc *enc = GST_RTP_FLEXFEC_ENC_CAST (element);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      if (!gst_rtp_flexfec_enc_check_settings (enc))
+        return GST_STATE_CHANGE_FAILURE;
+      gst_rtp_flexfec_enc_reset (enc, TRUE);
+      break;
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_rtp_flexfec_enc_reset (enc, FALSE);
+      break;
+    default:
+      break;
+  }
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  return ret;
+}
+
+static void
+gst_rtp_flexfec_enc_finalize (GObject * object)
+{
+  GstRtpFlexFecEnc *enc = GST_RTP_FLEXFEC_ENC_CAST (object);
+
+  gst_rtp_flexfec_enc_reset (enc, FALSE);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_rtp_flexfec_enc_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstRtpFlexFecEnc *enc = GST_RTP_FLEXFEC_ENC_CAST (object);
+
+  if (GST_STATE (enc) > GST_STATE_READY) {
+    GST_ERROR_OBJECT (enc,
+        "rtpflexfecenc properties can't be changed in PLAYING or PAUSED state");
+    return;
+  }
+
+  switch (prop_id) {
+    case PROP_COLUMNS:
+      enc->l = g_value_get_uint (value);
+      break;
+    case PROP_ROWS:
+      enc->d = g_value_get_uint (value);
+      break;
+    case PROP_PT:
+      enc->pt = g_value_get_int (value);
+      break;
+    case PROP_SSRC:
+      enc->ssrc = g_value_get_uint (value);
+      break;
+    case PROP_MODE:
+      enc->mode = g_value_get_enum (value);
+      break;
+    case PROP_REPAIR_PACKETS:
+      enc->n_repairs = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_rtp_flexfec_enc_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstRtpFlexFecEnc *enc = GST_RTP_FLEXFEC_ENC_CAST (object);
+
+  switch (prop_id) {
+    case PROP_COLUMNS:
+      g_value_set_uint (value, enc->l);
+      break;
+    case PROP_ROWS:
+      g_value_set_uint (value, enc->d);
+      break;
+    case PROP_PT:
+      g_value_set_int (value, enc->pt);
+      break;
+    case PROP_SSRC:
+      g_value_set_uint (value, enc->ssrc);
+      break;
+    case PROP_MODE:
+      g_value_set_enum (value, enc->mode);
+      break;
+    case PROP_REPAIR_PACKETS:
+      g_value_set_uint (value, enc->n_repairs);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static gboolean
+gst_rtp_flexfec_enc_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstRtpFlexFecEnc *enc = GST_RTP_FLEXFEC_ENC_CAST (parent);
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP) {
+    gst_rtp_flexfec_enc_reset_block (enc);
+    enc->last_media_seqnum_set = FALSE;
+  }
+
+  return gst_pad_event_default (pad, parent, event);
+}
+
+static void
+gst_rtp_flexfec_enc_class_init (GstRtpFlexFecEncClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *gstelement_class = GST_ELEMENT_CLASS (klass);
+
+  gobject_class->set_property =
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_enc_set_property);
+  gobject_class->get_property =
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_enc_get_property);
+  gobject_class->finalize = GST_DEBUG_FUNCPTR (gst_rtp_flexfec_enc_finalize);
+
+  g_object_class_install_property (gobject_class, PROP_COLUMNS,
+      g_param_spec_uint ("columns", "Columns",
+          "Number of consecutive packets protected by a row repair packet", 1,
+          RTP_FEC_RS_MAX_SOURCES, DEFAULT_COLUMNS,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  g_object_class_install_property (gobject_class, PROP_ROWS,
+      g_param_spec_uint ("rows", "Rows",
+          "Number of rows in a block, 0=row repair packets only", 0,
+          RTP_FEC_RS_MAX_SOURCES, DEFAULT_ROWS,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  g_object_class_install_property (gobject_class, PROP_PT,
+      g_param_spec_int ("pt", "Payload Type",
+          "The payload type of FEC packets", 96, 127, DEFAULT_PT,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  g_object_class_install_property (gobject_class, PROP_SSRC,
+      g_param_spec_uint ("ssrc", "SSRC",
+          "The SSRC of FEC packets (-1 == random)", 0, G_MAXUINT,
+          DEFAULT_SSRC,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  g_object_class_install_property (gobject_class, PROP_MODE,
+      g_param_spec_enum ("mode", "Mode",
+          "How repair packets are computed", GST_TYPE_RTP_FLEXFEC_MODE,
+          DEFAULT_MODE,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  g_object_class_install_property (gobject_class, PROP_REPAIR_PACKETS,
+      g_param_spec_uint ("repair-packets", "Repair packets",
+          "Number of repair packets per block in reed-solomon mode", 1,
+          RTP_FEC_RS_MAX_REPAIRS, DEFAULT_REPAIR_PACKETS,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  gstelement_class->change_state =
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_enc_change_state);
+
+  gst_element_class_set_static_metadata (gstelement_class,
+      "RTP FlexFEC encoder", "Codec/Encoder/Network/RTP",
+      "Encodes RTP FEC repair packets as described by RFC 8627",
+      "GStreamer developers <gstreamer-devel@lists.freedesktop.org>");
+
+  gst_element_class_add_static_pad_template (gstelement_class, &sink_template);
+  gst_element_class_add_static_pad_template (gstelement_class,
+      &fec_src_template);
+  gst_element_class_add_static_pad_template (gstelement_class, &src_template);
+
+  GST_DEBUG_CATEGORY_INIT (gst_rtp_flexfec_enc_debug,
+      "rtpflexfecenc", 0, "RTP FlexFEC encoder element");
+
+  gst_type_mark_as_plugin_api (GST_TYPE_RTP_FLEXFEC_MODE, 0);
+}
+
+static void
+gst_rtp_flexfec_enc_init (GstRtpFlexFecEnc * enc)
+{
+  enc->srcpad = gst_pad_new_from_static_template (&src_template, "src");
+  gst_pad_use_fixed_caps (enc->srcpad);
+  GST_PAD_SET_PROXY_CAPS (enc->srcpad);
+  gst_pad_set_iterate_internal_links_function (enc->srcpad,
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_enc_iterate_linked_pads));
+  gst_element_add_pad (GST_ELEMENT (enc), enc->srcpad);
+
+  enc->sinkpad = gst_pad_new_from_static_template (&sink_template, "sink");
+  GST_PAD_SET_PROXY_CAPS (enc->sinkpad);
+  gst_pad_set_chain_function (enc->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_enc_sink_chain));
+  gst_pad_set_event_function (enc->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_enc_sink_event));
+  gst_pad_set_iterate_internal_links_function (enc->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_rtp_flexfec_enc_iterate_linked_pads));
+  gst_element_add_pad (GST_ELEMENT (enc), enc->sinkpad);
+}
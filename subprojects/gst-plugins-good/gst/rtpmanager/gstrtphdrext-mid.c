@@ -33,6 +33,7 @@
 #include <gst/rtp/gstrtpbuffer.h>
 
 #include "gstrtphdrext-mid.h"
+#include "gstrtputils.h"
 
 GST_DEBUG_CATEGORY_STATIC (rtphdrext_mid_debug);
 #define GST_CAT_DEFAULT (rtphdrext_mid_debug)
@@ -130,6 +131,18 @@ out:
   return len;
 }
 
+static gboolean
+gst_rtp_header_extension_mid_write_list (GstRTPHeaderExtension * ext,
+    const GstBuffer * input_meta, GstRTPHeaderExtensionFlags write_flags,
+    GstBufferList * output, guint8 ** data, const gsize * size,
+    gssize * written)
+{
+  GstRTPHeaderExtensionMid *self = GST_RTP_HEADER_EXTENSION_MID (ext);
+
+  return gst_rtp_utils_write_string_hdrext_list (ext, &self->mid,
+      write_flags, output, data, size, written);
+}
+
 static gboolean
 gst_rtp_header_extension_mid_read (GstRTPHeaderExtension * ext,
     GstRTPHeaderExtensionFlags read_flags, const guint8 * data, gsize size,
@@ -300,6 +313,7 @@ gst_rtp_header_extension_mid_class_init (GstRTPHeaderExtensionMidClass * klass)
       gst_rtp_header_extension_mid_get_supported_flags;
   rtp_hdr_class->get_max_size = gst_rtp_header_extension_mid_get_max_size;
   rtp_hdr_class->write = gst_rtp_header_extension_mid_write;
+  rtp_hdr_class->write_list = gst_rtp_header_extension_mid_write_list;
   rtp_hdr_class->read = gst_rtp_header_extension_mid_read;
   rtp_hdr_class->set_caps_from_attributes =
       gst_rtp_header_extension_mid_set_caps_from_attributes;
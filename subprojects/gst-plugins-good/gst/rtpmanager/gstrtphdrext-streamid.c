@@ -33,6 +33,7 @@
 #include <gst/rtp/gstrtpbuffer.h>
 
 #include "gstrtphdrext-streamid.h"
+#include "gstrtputils.h"
 
 GST_DEBUG_CATEGORY_STATIC (rtphdrext_stream_id_debug);
 #define GST_CAT_DEFAULT (rtphdrext_stream_id_debug)
@@ -134,6 +135,19 @@ out:
   return len;
 }
 
+static gboolean
+gst_rtp_header_extension_stream_id_write_list (GstRTPHeaderExtension * ext,
+    const GstBuffer * input_meta, GstRTPHeaderExtensionFlags write_flags,
+    GstBufferList * output, guint8 ** data, const gsize * size,
+    gssize * written)
+{
+  GstRTPHeaderExtensionStreamId *self =
+      GST_RTP_HEADER_EXTENSION_STREAM_ID (ext);
+
+  return gst_rtp_utils_write_string_hdrext_list (ext, &self->rid,
+      write_flags, output, data, size, written);
+}
+
 static gboolean
 gst_rtp_header_extension_stream_id_read (GstRTPHeaderExtension * ext,
     GstRTPHeaderExtensionFlags read_flags, const guint8 * data, gsize size,
@@ -280,6 +294,7 @@ static void
       gst_rtp_header_extension_stream_id_get_supported_flags;
   rtp_hdr_class->get_max_size = gst_rtp_header_extension_stream_id_get_max_size;
   rtp_hdr_class->write = gst_rtp_header_extension_stream_id_write;
+  rtp_hdr_class->write_list = gst_rtp_header_extension_stream_id_write_list;
   rtp_hdr_class->read = gst_rtp_header_extension_stream_id_read;
 
   gst_element_class_set_static_metadata (gstelement_class,
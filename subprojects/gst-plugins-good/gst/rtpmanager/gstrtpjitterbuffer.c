@@ -3460,7 +3460,7 @@ gst_rtp_jitter_buffer_chain (GstPad * pad, GstObject * parent,
               new_drop_message (jitterbuffer, old_item->seqnum, old_item->pts,
               REASON_DROP_ON_LATENCY);
         }
-        rtp_jitter_buffer_free_item (old_item);
+        rtp_jitter_buffer_release_item (priv->jbuf, old_item);
       }
       /* we might have removed some head buffers, signal the pushing thread to
        * see if it can push now */
@@ -3835,7 +3835,7 @@ pop_and_push_next (GstRtpJitterBuffer * jitterbuffer, guint seqnum)
   JBUF_UNLOCK (priv);
 
   item->data = NULL;
-  rtp_jitter_buffer_free_item (item);
+  rtp_jitter_buffer_release_item (priv->jbuf, item);
 
   if (msg)
     gst_element_post_message (GST_ELEMENT_CAST (jitterbuffer), msg);
@@ -3955,7 +3955,7 @@ handle_next_buffer (GstRtpJitterBuffer * jitterbuffer)
       GST_DEBUG_OBJECT (jitterbuffer, "Old packet #%d, next #%d dropping",
           seqnum, next_seqnum);
       item = rtp_jitter_buffer_pop (priv->jbuf, NULL);
-      rtp_jitter_buffer_free_item (item);
+      rtp_jitter_buffer_release_item (priv->jbuf, item);
       result = GST_FLOW_OK;
     } else {
       /* the chain function has scheduled timers to request retransmission or
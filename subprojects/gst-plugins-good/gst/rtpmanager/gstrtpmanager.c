@@ -23,6 +23,7 @@
 
 #include "gstrtpbin.h"
 #include "gstrtpjitterbuffer.h"
+#include "gstrtpmultijitterbuffer.h"
 #include "gstrtpptdemux.h"
 #include "gstrtpsession.h"
 #include "gstrtprtxqueue.h"
@@ -32,6 +33,8 @@
 #include "gstrtpdtmfmux.h"
 #include "gstrtpmux.h"
 #include "gstrtpfunnel.h"
+#include "gstrtpflexfecdec.h"
+#include "gstrtpflexfecenc.h"
 #include "gstrtpst2022-1-fecdec.h"
 #include "gstrtpst2022-1-fecenc.h"
 #include "gstrtphdrext-twcc.h"
@@ -48,6 +51,7 @@ plugin_init (GstPlugin * plugin)
 
   ret |= GST_ELEMENT_REGISTER (rtpbin, plugin);
   ret |= GST_ELEMENT_REGISTER (rtpjitterbuffer, plugin);
+  ret |= GST_ELEMENT_REGISTER (rtpmultijitterbuffer, plugin);
   ret |= GST_ELEMENT_REGISTER (rtpptdemux, plugin);
   ret |= GST_ELEMENT_REGISTER (rtpsession, plugin);
   ret |= GST_ELEMENT_REGISTER (rtprtxqueue, plugin);
@@ -57,6 +61,8 @@ plugin_init (GstPlugin * plugin)
   ret |= GST_ELEMENT_REGISTER (rtpmux, plugin);
   ret |= GST_ELEMENT_REGISTER (rtpdtmfmux, plugin);
   ret |= GST_ELEMENT_REGISTER (rtpfunnel, plugin);
+  ret |= GST_ELEMENT_REGISTER (rtpflexfecdec, plugin);
+  ret |= GST_ELEMENT_REGISTER (rtpflexfecenc, plugin);
   ret |= GST_ELEMENT_REGISTER (rtpst2022_1_fecdec, plugin);
   ret |= GST_ELEMENT_REGISTER (rtpst2022_1_fecenc, plugin);
   ret |= GST_ELEMENT_REGISTER (rtphdrexttwcc, plugin);
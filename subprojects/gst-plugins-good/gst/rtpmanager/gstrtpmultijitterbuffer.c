@@ -0,0 +1,1478 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-rtpmultijitterbuffer
+ * @title: rtpmultijitterbuffer
+ * @see_also: rtpjitterbuffer, rtpssrcdemux
+ *
+ * rtpmultijitterbuffer demuxes RTP packets on their SSRC and reorders, removes
+ * duplicates and waits for missing packets of every SSRC, like an
+ * rtpssrcdemux followed by one rtpjitterbuffer per SSRC would do.
+ *
+ * Instead of a timer thread and a streaming thread per SSRC, all SSRCs share
+ * a single timer thread that waits for the earliest deadline of any SSRC and
+ * a pool of #GstRtpMultiJitterBuffer:output-threads threads that push the
+ * packets that are ready. This keeps the number of threads constant when
+ * receiving thousands of SSRCs, for example in a selective forwarding unit.
+ *
+ * For each SSRC that is detected, a new pad will be created and the
+ * #GstRtpMultiJitterBuffer::new-ssrc-pad signal will be emitted. Packets that
+ * are ready at the same time are pushed downstream as a #GstBufferList.
+ *
+ * The clock-rate of a payload type is taken from the caps on the sink pad or,
+ * when it is not there, from the #GstRtpMultiJitterBuffer::request-pt-map
+ * signal. Packets that are not received within
+ * #GstRtpMultiJitterBuffer:latency are considered lost and, if
+ * #GstRtpMultiJitterBuffer:do-lost is set, a GstRTPPacketLost event is pushed
+ * in their place.
+ *
+ * Unlike rtpjitterbuffer, this element does not request retransmissions.
+ *
+ * ## Example pipelines
+ * |[
+ * gst-launch-1.0 udpsrc caps="application/x-rtp,clock-rate=90000" ! rtpmultijitterbuffer ! fakesink
+ * ]| Receives RTP packets of any number of SSRCs and pushes the packets of the
+ * first detected SSRC to fakesink.
+ *
+ * Since: 1.22
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/rtp/gstrtpbuffer.h>
+
+#include "gstrtpmultijitterbuffer.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_rtp_multi_jitter_buffer_debug);
+#define GST_CAT_DEFAULT gst_rtp_multi_jitter_buffer_debug
+
+static GstStaticPadTemplate gst_rtp_multi_jitter_buffer_sink_template =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("application/x-rtp")
+    );
+
+static GstStaticPadTemplate gst_rtp_multi_jitter_buffer_src_template =
+GST_STATIC_PAD_TEMPLATE ("src_%u",
+    GST_PAD_SRC,
+    GST_PAD_SOMETIMES,
+    GST_STATIC_CAPS ("application/x-rtp")
+    );
+
+#define LOCK(obj)   (g_mutex_lock (&(obj)->lock))
+#define UNLOCK(obj) (g_mutex_unlock (&(obj)->lock))
+
+/* same limits as rtpsource uses to detect a restarted sender */
+#define RTP_MAX_DROPOUT  3000
+#define RTP_MAX_MISORDER 100
+
+/* the timer seqnum 65535 is reserved for EOS timers in RtpTimerQueue */
+#define MAX_STREAM_ID 65534
+
+#define DEFAULT_LATENCY_MS      200
+#define DEFAULT_MODE            RTP_JITTER_BUFFER_MODE_SLAVE
+#define DEFAULT_OUTPUT_THREADS  0
+#define DEFAULT_MAX_STREAMS     (MAX_STREAM_ID + 1)
+#define DEFAULT_DO_LOST         FALSE
+
+enum
+{
+  PROP_0,
+  PROP_LATENCY,
+  PROP_MODE,
+  PROP_OUTPUT_THREADS,
+  PROP_MAX_STREAMS,
+  PROP_DO_LOST,
+  PROP_STATS
+};
+
+enum
+{
+  SIGNAL_REQUEST_PT_MAP,
+  SIGNAL_NEW_SSRC_PAD,
+  SIGNAL_REMOVED_SSRC_PAD,
+  SIGNAL_CLEAR_SSRC,
+  LAST_SIGNAL
+};
+
+static guint gst_rtp_multi_jitter_buffer_signals[LAST_SIGNAL] = { 0 };
+
+struct _GstRtpMultiStream
+{
+  gint refcount;
+
+  guint32 ssrc;
+  /* key of the deadline timer of this stream */
+  guint16 id;
+  GstPad *srcpad;
+  RTPJitterBuffer *jbuf;
+
+  gint last_pt;
+  gint clock_rate;
+  /* next seqnum to push and next seqnum expected from the network */
+  gint next_seqnum;
+  gint next_in_seqnum;
+  GstClockTime last_pts;
+
+  /* GstBuffer and GstEvent ready to be pushed by the output threads */
+  GQueue pending;
+  gboolean scheduled;
+  gboolean removed;
+  GstFlowReturn srcresult;
+
+  guint64 num_pushed;
+  guint64 num_lost;
+  guint64 num_late;
+  guint64 num_duplicates;
+};
+
+#define gst_rtp_multi_jitter_buffer_parent_class parent_class
+G_DEFINE_TYPE (GstRtpMultiJitterBuffer, gst_rtp_multi_jitter_buffer,
+    GST_TYPE_ELEMENT);
+GST_ELEMENT_REGISTER_DEFINE (rtpmultijitterbuffer, "rtpmultijitterbuffer",
+    GST_RANK_NONE, GST_TYPE_RTP_MULTI_JITTER_BUFFER);
+
+static void gst_rtp_multi_jitter_buffer_finalize (GObject * object);
+static void gst_rtp_multi_jitter_buffer_set_property (GObject * object,
+    guint prop_id, const GValue * value, GParamSpec * pspec);
+static void gst_rtp_multi_jitter_buffer_get_property (GObject * object,
+    guint prop_id, GValue * value, GParamSpec * pspec);
+
+static GstStateChangeReturn gst_rtp_multi_jitter_buffer_change_state (GstElement
+    * element, GstStateChange transition);
+static void gst_rtp_multi_jitter_buffer_clear_ssrc (GstRtpMultiJitterBuffer *
+    self, guint32 ssrc);
+
+static GstFlowReturn gst_rtp_multi_jitter_buffer_chain (GstPad * pad,
+    GstObject * parent, GstBuffer * buffer);
+static gboolean gst_rtp_multi_jitter_buffer_sink_event (GstPad * pad,
+    GstObject * parent, GstEvent * event);
+static gboolean gst_rtp_multi_jitter_buffer_src_event (GstPad * pad,
+    GstObject * parent, GstEvent * event);
+static gboolean gst_rtp_multi_jitter_buffer_src_query (GstPad * pad,
+    GstObject * parent, GstQuery * query);
+
+static GstRtpMultiStream *
+stream_ref (GstRtpMultiStream * stream)
+{
+  g_atomic_int_inc (&stream->refcount);
+  return stream;
+}
+
+static void
+stream_unref (GstRtpMultiStream * stream)
+{
+  if (!g_atomic_int_dec_and_test (&stream->refcount))
+    return;
+
+  g_queue_clear_full (&stream->pending, (GDestroyNotify) gst_mini_object_unref);
+  rtp_jitter_buffer_flush (stream->jbuf, NULL, NULL);
+  g_object_unref (stream->jbuf);
+  gst_object_unref (stream->srcpad);
+  g_free (stream);
+}
+
+static void
+stream_reset (GstRtpMultiStream * stream)
+{
+  stream->next_seqnum = -1;
+  stream->next_in_seqnum = -1;
+  stream->last_pts = GST_CLOCK_TIME_NONE;
+  stream->srcresult = GST_FLOW_OK;
+  rtp_jitter_buffer_reset_skew (stream->jbuf);
+}
+
+static GstClockTime
+get_current_running_time (GstRtpMultiJitterBuffer * self)
+{
+  GstClock *clock = gst_element_get_clock (GST_ELEMENT_CAST (self));
+  GstClockTime running_time = GST_CLOCK_TIME_NONE;
+
+  if (clock) {
+    GstClockTime base_time = gst_element_get_base_time (GST_ELEMENT_CAST (self));
+    GstClockTime clock_time = gst_clock_get_time (clock);
+
+    if (clock_time > base_time)
+      running_time = clock_time - base_time;
+    else
+      running_time = 0;
+
+    gst_object_unref (clock);
+  }
+
+  return running_time;
+}
+
+/* Must be called with the lock held. Wakes up the timer thread when a
+ * deadline at @timeout is earlier than what it is waiting for. */
+static void
+wakeup_timer_thread (GstRtpMultiJitterBuffer * self, GstClockTime timeout)
+{
+  if (self->clock_id == NULL) {
+    g_cond_signal (&self->cond);
+  } else if (timeout < self->timer_timeout) {
+    GST_LOG_OBJECT (self, "unschedule timer waiting for %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (self->timer_timeout));
+    gst_clock_id_unschedule (self->clock_id);
+  }
+}
+
+static void
+unschedule_stream_timer (GstRtpMultiJitterBuffer * self,
+    GstRtpMultiStream * stream)
+{
+  RtpTimer *timer;
+
+  if ((timer = rtp_timer_queue_find (self->timers, stream->id))) {
+    rtp_timer_queue_unschedule (self->timers, timer);
+    rtp_timer_free (timer);
+  }
+}
+
+static void
+set_stream_timer (GstRtpMultiJitterBuffer * self, GstRtpMultiStream * stream,
+    GstClockTime timeout)
+{
+  rtp_timer_queue_set_deadline (self->timers, stream->id, timeout, 0);
+  wakeup_timer_thread (self, timeout);
+}
+
+/* Must be called with the lock held */
+static void
+schedule_stream (GstRtpMultiJitterBuffer * self, GstRtpMultiStream * stream)
+{
+  if (stream->scheduled || stream->removed || self->output_pool == NULL ||
+      g_queue_is_empty (&stream->pending))
+    return;
+
+  stream->scheduled = TRUE;
+  self->n_scheduled++;
+  g_thread_pool_push (self->output_pool, stream_ref (stream), NULL);
+}
+
+static void
+queue_lost_event (GstRtpMultiJitterBuffer * self, GstRtpMultiStream * stream,
+    GstClockTime next_pts, gint gap)
+{
+  GstClockTime timestamp = GST_CLOCK_TIME_NONE;
+  GstClockTime duration = GST_CLOCK_TIME_NONE;
+  GstEvent *event;
+
+  /* spread the missing packets evenly between the packets around them */
+  if (GST_CLOCK_TIME_IS_VALID (stream->last_pts) &&
+      GST_CLOCK_TIME_IS_VALID (next_pts) && next_pts > stream->last_pts) {
+    duration = (next_pts - stream->last_pts) / (gap + 1);
+    timestamp = gst_segment_position_from_running_time (&self->segment,
+        GST_FORMAT_TIME, stream->last_pts + duration);
+    duration *= gap;
+  }
+
+  event = gst_event_new_custom (GST_EVENT_CUSTOM_DOWNSTREAM,
+      gst_structure_new ("GstRTPPacketLost",
+          "seqnum", G_TYPE_UINT, (guint) stream->next_seqnum,
+          "timestamp", G_TYPE_UINT64, timestamp,
+          "duration", G_TYPE_UINT64, duration,
+          "retry", G_TYPE_UINT, 0, NULL));
+  g_queue_push_tail (&stream->pending, event);
+}
+
+/* Moves all packets of @stream that can be pushed at running time @now to its
+ * pending queue and (re)arms the timer of the stream for the first packet
+ * that has to wait. When @now is GST_CLOCK_TIME_NONE all packets are moved.
+ * Must be called with the lock held. */
+static void
+stream_collect (GstRtpMultiJitterBuffer * self, GstRtpMultiStream * stream,
+    GstClockTime now)
+{
+  RTPJitterBufferItem *item;
+
+  while ((item = rtp_jitter_buffer_peek (stream->jbuf))) {
+    GstBuffer *buffer;
+    gboolean discont = FALSE;
+    gint gap = 0;
+
+    if (stream->next_seqnum != -1)
+      gap = gst_rtp_buffer_compare_seqnum (stream->next_seqnum, item->seqnum);
+
+    if (stream->next_seqnum == -1 || gap > 0) {
+      GstClockTime deadline = item->pts + self->latency_ns;
+
+      /* the first packet and the packet after a gap wait for the packets that
+       * might still arrive before them */
+      if (GST_CLOCK_TIME_IS_VALID (now) && now < deadline) {
+        GST_LOG_OBJECT (self, "SSRC %08x: #%u waits until %" GST_TIME_FORMAT,
+            stream->ssrc, item->seqnum, GST_TIME_ARGS (deadline));
+        set_stream_timer (self, stream, deadline);
+        goto done;
+      }
+
+      discont = TRUE;
+      if (gap > 0) {
+        GST_DEBUG_OBJECT (self, "SSRC %08x: %d packets lost before #%u",
+            stream->ssrc, gap, item->seqnum);
+        stream->num_lost += gap;
+        self->num_lost += gap;
+        if (self->do_lost)
+          queue_lost_event (self, stream, item->pts, gap);
+      }
+    }
+
+    item = rtp_jitter_buffer_pop (stream->jbuf, NULL);
+    buffer = gst_buffer_make_writable (item->data);
+    item->data = NULL;
+
+    GST_BUFFER_PTS (buffer) =
+        gst_segment_position_from_running_time (&self->segment,
+        GST_FORMAT_TIME, item->pts);
+    GST_BUFFER_DTS (buffer) =
+        gst_segment_position_from_running_time (&self->segment,
+        GST_FORMAT_TIME, item->dts);
+    if (discont)
+      GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DISCONT);
+
+    stream->next_seqnum = (item->seqnum + 1) & 0xffff;
+    stream->last_pts = item->pts;
+    rtp_jitter_buffer_release_item (stream->jbuf, item);
+
+    g_queue_push_tail (&stream->pending, buffer);
+    stream->num_pushed++;
+    self->num_pushed++;
+  }
+
+  /* nothing left to wait for */
+  unschedule_stream_timer (self, stream);
+
+done:
+  schedule_stream (self, stream);
+}
+
+static GstFlowReturn
+push_items (GstRtpMultiJitterBuffer * self, GstRtpMultiStream * stream,
+    GQueue * items)
+{
+  GstBufferList *list = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstMiniObject *obj;
+
+  while ((obj = g_queue_pop_head (items))) {
+    if (GST_IS_BUFFER (obj)) {
+      if (list == NULL)
+        list = gst_buffer_list_new_sized (g_queue_get_length (items) + 1);
+      gst_buffer_list_add (list, GST_BUFFER_CAST (obj));
+      continue;
+    }
+
+    /* keep the order of buffers and serialized events */
+    if (list) {
+      ret = gst_pad_push_list (stream->srcpad, list);
+      list = NULL;
+    }
+    gst_pad_push_event (stream->srcpad, GST_EVENT_CAST (obj));
+  }
+
+  if (list)
+    ret = gst_pad_push_list (stream->srcpad, list);
+
+  return ret;
+}
+
+/* runs in one of the output threads. A stream is scheduled at most once at a
+ * time, so its packets are pushed in order. */
+static void
+push_stream_func (GstRtpMultiStream * stream, GstRtpMultiJitterBuffer * self)
+{
+  LOCK (self);
+  while (!self->flushing && !stream->removed &&
+      !g_queue_is_empty (&stream->pending)) {
+    GQueue items = stream->pending;
+    GstFlowReturn ret;
+
+    g_queue_init (&stream->pending);
+    UNLOCK (self);
+
+    ret = push_items (self, stream, &items);
+
+    LOCK (self);
+    if (ret != GST_FLOW_OK)
+      GST_DEBUG_OBJECT (self, "SSRC %08x: push returned %s", stream->ssrc,
+          gst_flow_get_name (ret));
+    stream->srcresult = ret;
+  }
+  stream->scheduled = FALSE;
+  self->n_scheduled--;
+  g_cond_broadcast (&self->output_cond);
+  UNLOCK (self);
+
+  stream_unref (stream);
+}
+
+static gpointer
+timer_thread_func (GstRtpMultiJitterBuffer * self)
+{
+  GstClockTime now;
+
+  LOCK (self);
+  while (self->timer_running) {
+    RtpTimer *timer;
+
+    /* don't produce data in paused */
+    while (self->blocked) {
+      g_cond_wait (&self->cond, &self->lock);
+      if (!self->timer_running)
+        goto stopping;
+    }
+
+    now = get_current_running_time (self);
+
+    while ((timer = rtp_timer_queue_pop_until (self->timers, now))) {
+      GstRtpMultiStream *stream = NULL;
+
+      if (timer->seqnum < self->slots->len)
+        stream = g_ptr_array_index (self->slots, timer->seqnum);
+      rtp_timer_free (timer);
+
+      if (stream)
+        stream_collect (self, stream, now);
+    }
+
+    timer = rtp_timer_queue_peek_earliest (self->timers);
+    if (timer) {
+      GstClock *clock;
+      GstClockID id;
+
+      GST_OBJECT_LOCK (self);
+      clock = GST_ELEMENT_CLOCK (self);
+      if (!clock) {
+        /* let's just push if there is no clock, now is NONE next time */
+        GST_OBJECT_UNLOCK (self);
+        continue;
+      }
+
+      id = self->clock_id = gst_clock_new_single_shot_id (clock,
+          timer->timeout + GST_ELEMENT_CAST (self)->base_time);
+      self->timer_timeout = timer->timeout;
+      GST_OBJECT_UNLOCK (self);
+
+      GST_LOG_OBJECT (self, "waiting for timer of stream %u at %"
+          GST_TIME_FORMAT, timer->seqnum, GST_TIME_ARGS (timer->timeout));
+
+      UNLOCK (self);
+      gst_clock_id_wait (id, NULL);
+      LOCK (self);
+
+      gst_clock_id_unref (id);
+      self->clock_id = NULL;
+    } else {
+      /* no timers, wait for activity */
+      g_cond_wait (&self->cond, &self->lock);
+    }
+  }
+stopping:
+  UNLOCK (self);
+
+  GST_DEBUG_OBJECT (self, "timer thread stopped");
+
+  return NULL;
+}
+
+static GstEvent *
+add_ssrc_and_ref (GstEvent * event, guint32 ssrc)
+{
+  /* Set the ssrc on the output caps */
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:
+    {
+      GstCaps *caps;
+      GstCaps *newcaps;
+      GstStructure *s;
+
+      gst_event_parse_caps (event, &caps);
+      newcaps = gst_caps_copy (caps);
+
+      s = gst_caps_get_structure (newcaps, 0);
+      gst_structure_set (s, "ssrc", G_TYPE_UINT, ssrc, NULL);
+      event = gst_event_new_caps (newcaps);
+      gst_caps_unref (newcaps);
+      break;
+    }
+    default:
+      gst_event_ref (event);
+      break;
+  }
+
+  return event;
+}
+
+static gboolean
+forward_sticky_events (GstPad * pad, GstEvent ** event, gpointer user_data)
+{
+  GstRtpMultiStream *stream = user_data;
+
+  gst_pad_push_event (stream->srcpad, add_ssrc_and_ref (*event, stream->ssrc));
+
+  return TRUE;
+}
+
+/* called from the streaming thread without the lock, returns a new reference
+ * to the stream */
+static GstRtpMultiStream *
+create_stream (GstRtpMultiJitterBuffer * self, guint32 ssrc)
+{
+  GstElementClass *klass = GST_ELEMENT_GET_CLASS (self);
+  GstRtpMultiStream *stream;
+  GstPadTemplate *templ;
+  gchar *padname;
+  guint16 id;
+
+  LOCK (self);
+  if (g_hash_table_size (self->ssrcs) >= self->max_streams) {
+    UNLOCK (self);
+    GST_WARNING_OBJECT (self, "Ignoring SSRC %08x, max streams %u reached",
+        ssrc, self->max_streams);
+    return NULL;
+  }
+
+  if (self->free_ids->len > 0) {
+    id = g_array_index (self->free_ids, guint16, self->free_ids->len - 1);
+    g_array_set_size (self->free_ids, self->free_ids->len - 1);
+  } else {
+    id = self->slots->len;
+    g_ptr_array_add (self->slots, NULL);
+  }
+
+  stream = g_new0 (GstRtpMultiStream, 1);
+  stream->refcount = 1;
+  stream->ssrc = ssrc;
+  stream->id = id;
+  stream->last_pt = -1;
+  stream->clock_rate = -1;
+  stream->jbuf = rtp_jitter_buffer_new ();
+  rtp_jitter_buffer_set_mode (stream->jbuf, self->mode);
+  rtp_jitter_buffer_set_delay (stream->jbuf, self->latency_ns);
+  g_queue_init (&stream->pending);
+  stream_reset (stream);
+  UNLOCK (self);
+
+  GST_DEBUG_OBJECT (self, "creating stream %u for SSRC %08x", id, ssrc);
+
+  templ = gst_element_class_get_pad_template (klass, "src_%u");
+  padname = g_strdup_printf ("src_%u", ssrc);
+  stream->srcpad = gst_pad_new_from_template (templ, padname);
+  g_free (padname);
+
+  /* the stream can go away before the pad, only keep the ssrc on the pad */
+  gst_pad_set_element_private (stream->srcpad, GUINT_TO_POINTER (ssrc));
+  gst_pad_set_event_function (stream->srcpad,
+      gst_rtp_multi_jitter_buffer_src_event);
+  gst_pad_set_query_function (stream->srcpad,
+      gst_rtp_multi_jitter_buffer_src_query);
+  gst_pad_use_fixed_caps (stream->srcpad);
+  gst_pad_set_active (stream->srcpad, TRUE);
+
+  gst_pad_sticky_events_foreach (self->sinkpad, forward_sticky_events, stream);
+  gst_element_add_pad (GST_ELEMENT_CAST (self), gst_object_ref (stream->srcpad));
+
+  LOCK (self);
+  g_hash_table_insert (self->ssrcs, GUINT_TO_POINTER (ssrc), stream);
+  g_ptr_array_index (self->slots, id) = stream;
+  stream_ref (stream);
+  UNLOCK (self);
+
+  g_signal_emit (self, gst_rtp_multi_jitter_buffer_signals[SIGNAL_NEW_SSRC_PAD],
+      0, ssrc, stream->srcpad);
+
+  return stream;
+}
+
+/* Must be called with the lock held, the reference of the ssrc table is
+ * passed to the caller */
+static void
+remove_stream_locked (GstRtpMultiJitterBuffer * self,
+    GstRtpMultiStream * stream)
+{
+  g_hash_table_remove (self->ssrcs, GUINT_TO_POINTER (stream->ssrc));
+  g_ptr_array_index (self->slots, stream->id) = NULL;
+  g_array_append_val (self->free_ids, stream->id);
+
+  unschedule_stream_timer (self, stream);
+  stream->removed = TRUE;
+  g_queue_clear_full (&stream->pending, (GDestroyNotify) gst_mini_object_unref);
+}
+
+static void
+release_stream (GstRtpMultiJitterBuffer * self, GstRtpMultiStream * stream)
+{
+  gst_pad_set_active (stream->srcpad, FALSE);
+
+  g_signal_emit (self,
+      gst_rtp_multi_jitter_buffer_signals[SIGNAL_REMOVED_SSRC_PAD], 0,
+      stream->ssrc, stream->srcpad);
+
+  gst_element_remove_pad (GST_ELEMENT_CAST (self), stream->srcpad);
+  stream_unref (stream);
+}
+
+static void
+remove_all_streams (GstRtpMultiJitterBuffer * self)
+{
+  GList *streams, *walk;
+
+  LOCK (self);
+  streams = g_hash_table_get_values (self->ssrcs);
+  for (walk = streams; walk; walk = walk->next)
+    remove_stream_locked (self, walk->data);
+  g_ptr_array_set_size (self->slots, 0);
+  g_array_set_size (self->free_ids, 0);
+  UNLOCK (self);
+
+  for (walk = streams; walk; walk = walk->next)
+    release_stream (self, walk->data);
+  g_list_free (streams);
+}
+
+static gint
+parse_clock_rate (GstRtpMultiJitterBuffer * self, GstCaps * caps, guint pt)
+{
+  GstStructure *s;
+  gint payload, clock_rate;
+
+  if (caps == NULL || gst_caps_is_empty (caps))
+    return -1;
+
+  s = gst_caps_get_structure (caps, 0);
+  if (gst_structure_get_int (s, "payload", &payload) && payload != pt)
+    return -1;
+
+  if (!gst_structure_get_int (s, "clock-rate", &clock_rate) || clock_rate <= 0)
+    return -1;
+
+  return clock_rate;
+}
+
+/* called without the lock */
+static gint
+get_clock_rate (GstRtpMultiJitterBuffer * self, guint32 ssrc, guint pt)
+{
+  GstCaps *caps;
+  gint clock_rate;
+
+  /* Try to get the clock-rate from the caps first if we can. If there are no
+   * caps we must fire the signal to get the clock-rate. */
+  caps = gst_pad_get_current_caps (self->sinkpad);
+  clock_rate = parse_clock_rate (self, caps, pt);
+  gst_clear_caps (&caps);
+
+  if (clock_rate == -1) {
+    g_signal_emit (self,
+        gst_rtp_multi_jitter_buffer_signals[SIGNAL_REQUEST_PT_MAP], 0, ssrc, pt,
+        &caps);
+    clock_rate = parse_clock_rate (self, caps, pt);
+    gst_clear_caps (&caps);
+  }
+
+  GST_DEBUG_OBJECT (self, "SSRC %08x: clock-rate of pt %u is %d", ssrc, pt,
+      clock_rate);
+
+  return clock_rate;
+}
+
+static GstFlowReturn
+gst_rtp_multi_jitter_buffer_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  GstRtpMultiJitterBuffer *self = GST_RTP_MULTI_JITTER_BUFFER_CAST (parent);
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstRtpMultiStream *stream;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstClockTime now, dts, pts, ntp_time;
+  gboolean estimated_dts = FALSE, duplicate;
+  guint32 ssrc, rtptime;
+  guint16 seqnum;
+  guint8 pt;
+  gint gap;
+
+  if (G_UNLIKELY (!gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp)))
+    goto invalid_buffer;
+
+  ssrc = gst_rtp_buffer_get_ssrc (&rtp);
+  pt = gst_rtp_buffer_get_payload_type (&rtp);
+  seqnum = gst_rtp_buffer_get_seq (&rtp);
+  rtptime = gst_rtp_buffer_get_timestamp (&rtp);
+  gst_rtp_buffer_unmap (&rtp);
+
+  LOCK (self);
+  if (G_UNLIKELY (self->flushing))
+    goto flushing;
+
+  stream = g_hash_table_lookup (self->ssrcs, GUINT_TO_POINTER (ssrc));
+  if (G_LIKELY (stream != NULL)) {
+    stream_ref (stream);
+  } else {
+    UNLOCK (self);
+    if (!(stream = create_stream (self, ssrc)))
+      goto dropped;
+    LOCK (self);
+    if (G_UNLIKELY (self->flushing || stream->removed))
+      goto flushing_stream;
+  }
+
+  if (G_UNLIKELY (stream->last_pt != pt)) {
+    gint clock_rate;
+
+    GST_DEBUG_OBJECT (self, "SSRC %08x: pt changed from %d to %u", ssrc,
+        stream->last_pt, pt);
+
+    UNLOCK (self);
+    clock_rate = get_clock_rate (self, ssrc, pt);
+    LOCK (self);
+    if (G_UNLIKELY (self->flushing || stream->removed))
+      goto flushing_stream;
+
+    stream->last_pt = pt;
+    stream->clock_rate = clock_rate;
+    if (clock_rate > 0)
+      rtp_jitter_buffer_set_clock_rate (stream->jbuf, clock_rate);
+  }
+
+  if (G_UNLIKELY (stream->clock_rate <= 0))
+    goto no_clock_rate;
+
+  /* restarted senders and huge jumps start over from the new seqnum */
+  if (stream->next_in_seqnum != -1) {
+    gap = gst_rtp_buffer_compare_seqnum (stream->next_in_seqnum, seqnum);
+    if (G_UNLIKELY (gap > RTP_MAX_DROPOUT || gap < -RTP_MAX_MISORDER)) {
+      GST_DEBUG_OBJECT (self, "SSRC %08x: seqnum jumped by %d, resetting",
+          ssrc, gap);
+      stream_collect (self, stream, GST_CLOCK_TIME_NONE);
+      stream_reset (stream);
+    }
+  }
+
+  if (stream->next_seqnum != -1 &&
+      gst_rtp_buffer_compare_seqnum (stream->next_seqnum, seqnum) < 0)
+    goto too_late;
+
+  now = get_current_running_time (self);
+
+  /* make sure we have a DTS, in running time */
+  dts = GST_BUFFER_DTS (buffer);
+  if (dts == -1)
+    dts = GST_BUFFER_PTS (buffer);
+  if (dts == -1) {
+    dts = GST_CLOCK_TIME_IS_VALID (now) ? now : 0;
+    estimated_dts = (stream->next_in_seqnum != -1);
+  } else {
+    dts = gst_segment_to_running_time (&self->segment, GST_FORMAT_TIME, dts);
+  }
+
+  gap = 0;
+  if (stream->next_in_seqnum != -1)
+    gap = gst_rtp_buffer_compare_seqnum (stream->next_in_seqnum, seqnum);
+
+  pts = rtp_jitter_buffer_calculate_pts (stream->jbuf, dts, estimated_dts,
+      rtptime, gst_element_get_base_time (GST_ELEMENT_CAST (self)), gap, FALSE,
+      &ntp_time);
+  if (G_UNLIKELY (pts == GST_CLOCK_TIME_NONE))
+    goto invalid_pts;
+
+  if (gap >= 0)
+    stream->next_in_seqnum = (seqnum + 1) & 0xffff;
+
+  rtp_jitter_buffer_append_buffer (stream->jbuf, buffer, dts, pts, seqnum,
+      rtptime, &duplicate, NULL);
+  if (G_UNLIKELY (duplicate)) {
+    GST_LOG_OBJECT (self, "SSRC %08x: duplicate packet #%u", ssrc, seqnum);
+    stream->num_duplicates++;
+    self->num_duplicates++;
+  } else if (self->blocked) {
+    /* collected by the timer thread when going to PLAYING */
+    set_stream_timer (self, stream, 0);
+  } else {
+    stream_collect (self, stream, now);
+  }
+
+  if (stream->srcresult != GST_FLOW_NOT_LINKED)
+    ret = stream->srcresult;
+
+done:
+  UNLOCK (self);
+  stream_unref (stream);
+
+  return ret;
+
+  /* ERRORS */
+invalid_buffer:
+  {
+    /* this is not fatal but should be filtered earlier */
+    GST_ELEMENT_WARNING (self, STREAM, DECODE, (NULL),
+        ("Received invalid RTP payload, dropping"));
+    gst_buffer_unref (buffer);
+    return GST_FLOW_OK;
+  }
+flushing:
+  {
+    UNLOCK (self);
+    gst_buffer_unref (buffer);
+    return GST_FLOW_FLUSHING;
+  }
+dropped:
+  {
+    gst_buffer_unref (buffer);
+    return GST_FLOW_OK;
+  }
+flushing_stream:
+  {
+    gst_buffer_unref (buffer);
+    ret = self->flushing ? GST_FLOW_FLUSHING : GST_FLOW_OK;
+    goto done;
+  }
+no_clock_rate:
+  {
+    GST_WARNING_OBJECT (self, "SSRC %08x: no clock-rate for pt %u, dropping",
+        ssrc, pt);
+    gst_buffer_unref (buffer);
+    goto done;
+  }
+too_late:
+  {
+    GST_LOG_OBJECT (self, "SSRC %08x: packet #%u too late, expected #%d",
+        ssrc, seqnum, stream->next_seqnum);
+    stream->num_late++;
+    self->num_late++;
+    gst_buffer_unref (buffer);
+    goto done;
+  }
+invalid_pts:
+  {
+    GST_DEBUG_OBJECT (self, "SSRC %08x: no valid timestamp for #%u, dropping",
+        ssrc, seqnum);
+    gst_buffer_unref (buffer);
+    goto done;
+  }
+}
+
+/* Must be called with the lock held */
+static void
+queue_event_locked (GstRtpMultiJitterBuffer * self, GstEvent * event)
+{
+  GHashTableIter iter;
+  GstRtpMultiStream *stream;
+
+  g_hash_table_iter_init (&iter, self->ssrcs);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & stream)) {
+    g_queue_push_tail (&stream->pending, add_ssrc_and_ref (event,
+            stream->ssrc));
+    schedule_stream (self, stream);
+  }
+}
+
+static gboolean
+gst_rtp_multi_jitter_buffer_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstRtpMultiJitterBuffer *self = GST_RTP_MULTI_JITTER_BUFFER_CAST (parent);
+  GHashTableIter iter;
+  GstRtpMultiStream *stream;
+
+  GST_DEBUG_OBJECT (self, "received %s", GST_EVENT_TYPE_NAME (event));
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_FLUSH_START:
+      LOCK (self);
+      self->flushing = TRUE;
+      rtp_timer_queue_remove_all (self->timers);
+      if (self->clock_id)
+        gst_clock_id_unschedule (self->clock_id);
+      g_hash_table_iter_init (&iter, self->ssrcs);
+      while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & stream)) {
+        g_queue_clear_full (&stream->pending,
+            (GDestroyNotify) gst_mini_object_unref);
+        rtp_jitter_buffer_flush (stream->jbuf, NULL, NULL);
+      }
+      UNLOCK (self);
+      return gst_pad_event_default (pad, parent, event);
+    case GST_EVENT_FLUSH_STOP:
+      LOCK (self);
+      /* the output threads stop as soon as they see the flushing flag */
+      while (self->n_scheduled > 0)
+        g_cond_wait (&self->output_cond, &self->lock);
+      g_hash_table_iter_init (&iter, self->ssrcs);
+      while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & stream))
+        stream_reset (stream);
+      gst_segment_init (&self->segment, GST_FORMAT_TIME);
+      self->flushing = FALSE;
+      UNLOCK (self);
+      return gst_pad_event_default (pad, parent, event);
+    case GST_EVENT_EOS:
+      LOCK (self);
+      /* push out everything, there is nothing left to wait for */
+      g_hash_table_iter_init (&iter, self->ssrcs);
+      while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & stream))
+        stream_collect (self, stream, GST_CLOCK_TIME_NONE);
+      queue_event_locked (self, event);
+      UNLOCK (self);
+      gst_event_unref (event);
+      return TRUE;
+    case GST_EVENT_SEGMENT:
+    {
+      const GstSegment *segment;
+
+      gst_event_parse_segment (event, &segment);
+      if (segment->format != GST_FORMAT_TIME) {
+        GST_ELEMENT_ERROR (self, STREAM, FORMAT, (NULL),
+            ("Received non TIME segment"));
+        gst_event_unref (event);
+        return FALSE;
+      }
+
+      LOCK (self);
+      gst_segment_copy_into (segment, &self->segment);
+      queue_event_locked (self, event);
+      UNLOCK (self);
+      gst_event_unref (event);
+      return TRUE;
+    }
+    case GST_EVENT_CAPS:
+      LOCK (self);
+      /* look up the clock-rate again with the next packet */
+      g_hash_table_iter_init (&iter, self->ssrcs);
+      while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & stream))
+        stream->last_pt = -1;
+      queue_event_locked (self, event);
+      UNLOCK (self);
+      gst_event_unref (event);
+      return TRUE;
+    default:
+      if (GST_EVENT_IS_SERIALIZED (event)) {
+        LOCK (self);
+        queue_event_locked (self, event);
+        UNLOCK (self);
+        gst_event_unref (event);
+        return TRUE;
+      }
+      return gst_pad_event_default (pad, parent, event);
+  }
+}
+
+static gboolean
+gst_rtp_multi_jitter_buffer_src_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstRtpMultiJitterBuffer *self = GST_RTP_MULTI_JITTER_BUFFER_CAST (parent);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CUSTOM_UPSTREAM:
+    {
+      GstStructure *s;
+
+      /* let upstream know which SSRC this event is about */
+      event = gst_event_make_writable (event);
+      s = gst_event_writable_structure (event);
+      if (!gst_structure_has_field (s, "ssrc"))
+        gst_structure_set (s, "ssrc", G_TYPE_UINT,
+            GPOINTER_TO_UINT (gst_pad_get_element_private (pad)), NULL);
+      return gst_pad_push_event (self->sinkpad, event);
+    }
+    default:
+      return gst_pad_event_default (pad, parent, event);
+  }
+}
+
+static gboolean
+gst_rtp_multi_jitter_buffer_src_query (GstPad * pad, GstObject * parent,
+    GstQuery * query)
+{
+  GstRtpMultiJitterBuffer *self = GST_RTP_MULTI_JITTER_BUFFER_CAST (parent);
+  gboolean res;
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_LATENCY:
+    {
+      GstClockTime min_latency, max_latency, our_latency;
+      gboolean us_live;
+
+      if ((res = gst_pad_peer_query (self->sinkpad, query))) {
+        gst_query_parse_latency (query, &us_live, &min_latency, &max_latency);
+
+        LOCK (self);
+        our_latency = self->latency_ns;
+        UNLOCK (self);
+
+        min_latency += our_latency;
+        if (max_latency != GST_CLOCK_TIME_NONE)
+          max_latency += our_latency;
+
+        GST_DEBUG_OBJECT (self, "reporting latency min %" GST_TIME_FORMAT
+            " max %" GST_TIME_FORMAT, GST_TIME_ARGS (min_latency),
+            GST_TIME_ARGS (max_latency));
+
+        gst_query_set_latency (query, TRUE, min_latency, max_latency);
+      }
+      break;
+    }
+    default:
+      res = gst_pad_query_default (pad, parent, query);
+      break;
+  }
+
+  return res;
+}
+
+static void
+gst_rtp_multi_jitter_buffer_clear_ssrc (GstRtpMultiJitterBuffer * self,
+    guint32 ssrc)
+{
+  GstRtpMultiStream *stream;
+
+  LOCK (self);
+  stream = g_hash_table_lookup (self->ssrcs, GUINT_TO_POINTER (ssrc));
+  if (stream == NULL) {
+    UNLOCK (self);
+    GST_DEBUG_OBJECT (self, "unknown SSRC %08x", ssrc);
+    return;
+  }
+  remove_stream_locked (self, stream);
+  UNLOCK (self);
+
+  GST_DEBUG_OBJECT (self, "clearing SSRC %08x", ssrc);
+  release_stream (self, stream);
+}
+
+static GstStructure *
+gst_rtp_multi_jitter_buffer_create_stats (GstRtpMultiJitterBuffer * self)
+{
+  GstStructure *s;
+
+  LOCK (self);
+  s = gst_structure_new ("application/x-rtp-multi-jitterbuffer-stats",
+      "num-streams", G_TYPE_UINT, g_hash_table_size (self->ssrcs),
+      "num-pushed", G_TYPE_UINT64, self->num_pushed,
+      "num-lost", G_TYPE_UINT64, self->num_lost,
+      "num-late", G_TYPE_UINT64, self->num_late,
+      "num-duplicates", G_TYPE_UINT64, self->num_duplicates, NULL);
+  UNLOCK (self);
+
+  return s;
+}
+
+static GstStateChangeReturn
+gst_rtp_multi_jitter_buffer_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstRtpMultiJitterBuffer *self = GST_RTP_MULTI_JITTER_BUFFER (element);
+  GstStateChangeReturn ret;
+
+  switch (transition) {
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+    {
+      guint threads = self->output_threads;
+
+      if (threads == 0)
+        threads = g_get_num_processors ();
+
+      LOCK (self);
+      gst_segment_init (&self->segment, GST_FORMAT_TIME);
+      self->num_pushed = self->num_lost = 0;
+      self->num_late = self->num_duplicates = 0;
+      self->flushing = FALSE;
+      /* block until we go to PLAYING */
+      self->blocked = TRUE;
+      self->timer_running = TRUE;
+      self->output_pool = g_thread_pool_new ((GFunc) push_stream_func, self,
+          threads, FALSE, NULL);
+      self->timer_thread = g_thread_new ("multijbuf-timer",
+          (GThreadFunc) timer_thread_func, self);
+      UNLOCK (self);
+      break;
+    }
+    case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
+      LOCK (self);
+      /* unblock to allow streaming in PLAYING */
+      self->blocked = FALSE;
+      g_cond_signal (&self->cond);
+      UNLOCK (self);
+      break;
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      LOCK (self);
+      self->flushing = TRUE;
+      self->timer_running = FALSE;
+      if (self->clock_id)
+        gst_clock_id_unschedule (self->clock_id);
+      g_cond_signal (&self->cond);
+      UNLOCK (self);
+      g_thread_join (self->timer_thread);
+      self->timer_thread = NULL;
+      break;
+    default:
+      break;
+  }
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      /* we are a live element because we sync to the clock, which we can only
+       * do in the PLAYING state */
+      if (ret != GST_STATE_CHANGE_FAILURE)
+        ret = GST_STATE_CHANGE_NO_PREROLL;
+      break;
+    case GST_STATE_CHANGE_PLAYING_TO_PAUSED:
+      LOCK (self);
+      /* block to stop streaming when PAUSED */
+      self->blocked = TRUE;
+      if (self->clock_id)
+        gst_clock_id_unschedule (self->clock_id);
+      UNLOCK (self);
+      if (ret != GST_STATE_CHANGE_FAILURE)
+        ret = GST_STATE_CHANGE_NO_PREROLL;
+      break;
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      /* the pads are inactive now, wait for the output threads to finish */
+      g_thread_pool_free (self->output_pool, FALSE, TRUE);
+      self->output_pool = NULL;
+      self->n_scheduled = 0;
+      rtp_timer_queue_remove_all (self->timers);
+      remove_all_streams (self);
+      break;
+    default:
+      break;
+  }
+
+  return ret;
+}
+
+static void
+gst_rtp_multi_jitter_buffer_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstRtpMultiJitterBuffer *self = GST_RTP_MULTI_JITTER_BUFFER (object);
+  GHashTableIter iter;
+  GstRtpMultiStream *stream;
+
+  switch (prop_id) {
+    case PROP_LATENCY:
+    {
+      guint new_latency, old_latency;
+
+      new_latency = g_value_get_uint (value);
+
+      LOCK (self);
+      old_latency = self->latency_ms;
+      self->latency_ms = new_latency;
+      self->latency_ns = self->latency_ms * GST_MSECOND;
+      g_hash_table_iter_init (&iter, self->ssrcs);
+      while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & stream))
+        rtp_jitter_buffer_set_delay (stream->jbuf, self->latency_ns);
+      UNLOCK (self);
+
+      /* post message if latency changed, this will inform the parent pipeline
+       * that a latency reconfiguration is possible/needed. */
+      if (new_latency != old_latency) {
+        gst_element_post_message (GST_ELEMENT_CAST (self),
+            gst_message_new_latency (GST_OBJECT_CAST (self)));
+      }
+      break;
+    }
+    case PROP_MODE:
+      LOCK (self);
+      self->mode = g_value_get_enum (value);
+      g_hash_table_iter_init (&iter, self->ssrcs);
+      while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & stream))
+        rtp_jitter_buffer_set_mode (stream->jbuf, self->mode);
+      UNLOCK (self);
+      break;
+    case PROP_OUTPUT_THREADS:
+      LOCK (self);
+      self->output_threads = g_value_get_uint (value);
+      UNLOCK (self);
+      break;
+    case PROP_MAX_STREAMS:
+      LOCK (self);
+      self->max_streams = g_value_get_uint (value);
+      UNLOCK (self);
+      break;
+    case PROP_DO_LOST:
+      LOCK (self);
+      self->do_lost = g_value_get_boolean (value);
+      UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_rtp_multi_jitter_buffer_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstRtpMultiJitterBuffer *self = GST_RTP_MULTI_JITTER_BUFFER (object);
+
+  switch (prop_id) {
+    case PROP_LATENCY:
+      LOCK (self);
+      g_value_set_uint (value, self->latency_ms);
+      UNLOCK (self);
+      break;
+    case PROP_MODE:
+      LOCK (self);
+      g_value_set_enum (value, self->mode);
+      UNLOCK (self);
+      break;
+    case PROP_OUTPUT_THREADS:
+      LOCK (self);
+      g_value_set_uint (value, self->output_threads);
+      UNLOCK (self);
+      break;
+    case PROP_MAX_STREAMS:
+      LOCK (self);
+      g_value_set_uint (value, self->max_streams);
+      UNLOCK (self);
+      break;
+    case PROP_DO_LOST:
+      LOCK (self);
+      g_value_set_boolean (value, self->do_lost);
+      UNLOCK (self);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value,
+          gst_rtp_multi_jitter_buffer_create_stats (self));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_rtp_multi_jitter_buffer_class_init (GstRtpMultiJitterBufferClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+  GstElementClass *gstelement_class = (GstElementClass *) klass;
+
+  gobject_class->finalize = gst_rtp_multi_jitter_buffer_finalize;
+  gobject_class->set_property = gst_rtp_multi_jitter_buffer_set_property;
+  gobject_class->get_property = gst_rtp_multi_jitter_buffer_get_property;
+
+  /**
+   * GstRtpMultiJitterBuffer:latency:
+   *
+   * The maximum latency of the jitterbuffer of each SSRC. Packets will be
+   * kept in the buffer for at most this time.
+   */
+  g_object_class_install_property (gobject_class, PROP_LATENCY,
+      g_param_spec_uint ("latency", "Buffer latency in ms",
+          "Amount of ms to buffer", 0, G_MAXUINT, DEFAULT_LATENCY_MS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRtpMultiJitterBuffer:mode:
+   *
+   * Control the buffering and timestamping mode used by the jitterbuffer of
+   * each SSRC.
+   */
+  g_object_class_install_property (gobject_class, PROP_MODE,
+      g_param_spec_enum ("mode", "Mode",
+          "Control the buffering algorithm in use", RTP_TYPE_JITTER_BUFFER_MODE,
+          DEFAULT_MODE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRtpMultiJitterBuffer:output-threads:
+   *
+   * The maximum number of threads that push packets downstream, shared by
+   * all SSRCs. 0 uses one thread per CPU.
+   */
+  g_object_class_install_property (gobject_class, PROP_OUTPUT_THREADS,
+      g_param_spec_uint ("output-threads", "Output Threads",
+          "Maximum number of threads pushing packets downstream "
+          "(0 = number of CPUs)", 0, G_MAXINT, DEFAULT_OUTPUT_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstRtpMultiJitterBuffer:max-streams:
+   *
+   * The maximum number of SSRCs, packets of further SSRCs are dropped.
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_STREAMS,
+      g_param_spec_uint ("max-streams", "Max Streams",
+          "The maximum number of streams allowed",
+          0, DEFAULT_MAX_STREAMS, DEFAULT_MAX_STREAMS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRtpMultiJitterBuffer:do-lost:
+   *
+   * Send out a GstRTPPacketLost event downstream when a packet is considered
+   * lost.
+   */
+  g_object_class_install_property (gobject_class, PROP_DO_LOST,
+      g_param_spec_boolean ("do-lost", "Do Lost",
+          "Send an event downstream when a packet is lost", DEFAULT_DO_LOST,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRtpMultiJitterBuffer:stats:
+   *
+   * Various statistics summed over all SSRCs. This property returns a
+   * GstStructure with name application/x-rtp-multi-jitterbuffer-stats with
+   * the following fields:
+   *
+   * * #guint `num-streams`: the number of SSRCs.
+   * * #guint64 `num-pushed`: the number of packets pushed out.
+   * * #guint64 `num-lost`: the number of packets considered lost.
+   * * #guint64 `num-late`: the number of packets arriving too late.
+   * * #guint64 `num-duplicates`: the number of duplicate packets.
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Various statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRtpMultiJitterBuffer::request-pt-map:
+   * @buffer: the object which received the signal
+   * @ssrc: the SSRC
+   * @pt: the pt
+   *
+   * Request the payload type as #GstCaps for @pt of @ssrc.
+   */
+  gst_rtp_multi_jitter_buffer_signals[SIGNAL_REQUEST_PT_MAP] =
+      g_signal_new ("request-pt-map", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, G_STRUCT_OFFSET (GstRtpMultiJitterBufferClass,
+          request_pt_map), NULL, NULL, NULL, GST_TYPE_CAPS, 2, G_TYPE_UINT,
+      G_TYPE_UINT);
+
+  /**
+   * GstRtpMultiJitterBuffer::new-ssrc-pad:
+   * @buffer: the object which received the signal
+   * @ssrc: the SSRC of the pad
+   * @pad: the new pad.
+   *
+   * Emitted when a new SSRC pad has been created.
+   */
+  gst_rtp_multi_jitter_buffer_signals[SIGNAL_NEW_SSRC_PAD] =
+      g_signal_new ("new-ssrc-pad",
+      G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
+      G_STRUCT_OFFSET (GstRtpMultiJitterBufferClass, new_ssrc_pad),
+      NULL, NULL, NULL, G_TYPE_NONE, 2, G_TYPE_UINT, GST_TYPE_PAD);
+
+  /**
+   * GstRtpMultiJitterBuffer::removed-ssrc-pad:
+   * @buffer: the object which received the signal
+   * @ssrc: the SSRC of the pad
+   * @pad: the removed pad.
+   *
+   * Emitted when a SSRC pad has been removed.
+   */
+  gst_rtp_multi_jitter_buffer_signals[SIGNAL_REMOVED_SSRC_PAD] =
+      g_signal_new ("removed-ssrc-pad",
+      G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
+      G_STRUCT_OFFSET (GstRtpMultiJitterBufferClass, removed_ssrc_pad),
+      NULL, NULL, NULL, G_TYPE_NONE, 2, G_TYPE_UINT, GST_TYPE_PAD);
+
+  /**
+   * GstRtpMultiJitterBuffer::clear-ssrc:
+   * @buffer: the object which received the signal
+   * @ssrc: the SSRC of the pad
+   *
+   * Action signal to drop the packets and remove the pad of SSRC.
+   */
+  gst_rtp_multi_jitter_buffer_signals[SIGNAL_CLEAR_SSRC] =
+      g_signal_new ("clear-ssrc",
+      G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstRtpMultiJitterBufferClass, clear_ssrc),
+      NULL, NULL, NULL, G_TYPE_NONE, 1, G_TYPE_UINT);
+
+  gstelement_class->change_state =
+      GST_DEBUG_FUNCPTR (gst_rtp_multi_jitter_buffer_change_state);
+  klass->clear_ssrc = GST_DEBUG_FUNCPTR (gst_rtp_multi_jitter_buffer_clear_ssrc);
+
+  gst_element_class_add_static_pad_template (gstelement_class,
+      &gst_rtp_multi_jitter_buffer_sink_template);
+  gst_element_class_add_static_pad_template (gstelement_class,
+      &gst_rtp_multi_jitter_buffer_src_template);
+
+  gst_element_class_set_static_metadata (gstelement_class,
+      "RTP multi-SSRC jitter buffer", "Filter/Network/RTP",
+      "Demuxes RTP packets on SSRC and reorders and removes duplicates "
+      "of all SSRCs with shared threads",
+      "GStreamer developers <gstreamer-devel@lists.freedesktop.org>");
+
+  GST_DEBUG_CATEGORY_INIT (gst_rtp_multi_jitter_buffer_debug,
+      "rtpmultijitterbuffer", 0, "RTP multi-SSRC jitter buffer");
+
+  GST_DEBUG_REGISTER_FUNCPTR (gst_rtp_multi_jitter_buffer_chain);
+  GST_DEBUG_REGISTER_FUNCPTR (gst_rtp_multi_jitter_buffer_sink_event);
+  GST_DEBUG_REGISTER_FUNCPTR (gst_rtp_multi_jitter_buffer_src_event);
+  GST_DEBUG_REGISTER_FUNCPTR (gst_rtp_multi_jitter_buffer_src_query);
+}
+
+static void
+gst_rtp_multi_jitter_buffer_init (GstRtpMultiJitterBuffer * self)
+{
+  GstElementClass *klass = GST_ELEMENT_GET_CLASS (self);
+
+  self->sinkpad =
+      gst_pad_new_from_template (gst_element_class_get_pad_template (klass,
+          "sink"), "sink");
+  gst_pad_set_chain_function (self->sinkpad,
+      gst_rtp_multi_jitter_buffer_chain);
+  gst_pad_set_event_function (self->sinkpad,
+      gst_rtp_multi_jitter_buffer_sink_event);
+  gst_element_add_pad (GST_ELEMENT_CAST (self), self->sinkpad);
+
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->cond);
+  g_cond_init (&self->output_cond);
+
+  self->ssrcs = g_hash_table_new (NULL, NULL);
+  self->slots = g_ptr_array_new ();
+  self->free_ids = g_array_new (FALSE, FALSE, sizeof (guint16));
+  self->timers = rtp_timer_queue_new ();
+  gst_segment_init (&self->segment, GST_FORMAT_TIME);
+
+  self->latency_ms = DEFAULT_LATENCY_MS;
+  self->latency_ns = self->latency_ms * GST_MSECOND;
+  self->mode = DEFAULT_MODE;
+  self->output_threads = DEFAULT_OUTPUT_THREADS;
+  self->max_streams = DEFAULT_MAX_STREAMS;
+  self->do_lost = DEFAULT_DO_LOST;
+}
+
+static void
+gst_rtp_multi_jitter_buffer_finalize (GObject * object)
+{
+  GstRtpMultiJitterBuffer *self = GST_RTP_MULTI_JITTER_BUFFER (object);
+
+  g_hash_table_unref (self->ssrcs);
+  g_ptr_array_unref (self->slots);
+  g_array_unref (self->free_ids);
+  g_object_unref (self->timers);
+
+  g_mutex_clear (&self->lock);
+  g_cond_clear (&self->cond);
+  g_cond_clear (&self->output_cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
@@ -0,0 +1,103 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_RTP_MULTI_JITTER_BUFFER_H__
+#define __GST_RTP_MULTI_JITTER_BUFFER_H__
+
+#include <gst/gst.h>
+
+#include "rtpjitterbuffer.h"
+#include "rtptimerqueue.h"
+
+#define GST_TYPE_RTP_MULTI_JITTER_BUFFER            (gst_rtp_multi_jitter_buffer_get_type())
+#define GST_RTP_MULTI_JITTER_BUFFER(obj)            (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_RTP_MULTI_JITTER_BUFFER,GstRtpMultiJitterBuffer))
+#define GST_RTP_MULTI_JITTER_BUFFER_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_RTP_MULTI_JITTER_BUFFER,GstRtpMultiJitterBufferClass))
+#define GST_IS_RTP_MULTI_JITTER_BUFFER(obj)         (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_RTP_MULTI_JITTER_BUFFER))
+#define GST_IS_RTP_MULTI_JITTER_BUFFER_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_RTP_MULTI_JITTER_BUFFER))
+#define GST_RTP_MULTI_JITTER_BUFFER_CAST(obj)       ((GstRtpMultiJitterBuffer *)(obj))
+
+typedef struct _GstRtpMultiJitterBuffer GstRtpMultiJitterBuffer;
+typedef struct _GstRtpMultiJitterBufferClass GstRtpMultiJitterBufferClass;
+typedef struct _GstRtpMultiStream GstRtpMultiStream;
+
+struct _GstRtpMultiJitterBuffer
+{
+  GstElement parent;
+
+  GstPad *sinkpad;
+
+  /* protects everything below */
+  GMutex lock;
+  GCond cond;
+
+  /* ssrc -> GstRtpMultiStream, and the same streams indexed by the id that
+   * keys their timer in @timers */
+  GHashTable *ssrcs;
+  GPtrArray *slots;
+  GArray *free_ids;
+
+  /* one deadline timer per stream with pending packets */
+  RtpTimerQueue *timers;
+  GThread *timer_thread;
+  GstClockID clock_id;
+  GstClockTime timer_timeout;
+  gboolean timer_running;
+  gboolean blocked;
+
+  /* pushes the pending output of the streams */
+  GThreadPool *output_pool;
+  guint n_scheduled;
+  GCond output_cond;
+
+  gboolean flushing;
+  GstSegment segment;
+
+  /* properties */
+  guint latency_ms;
+  GstClockTime latency_ns;
+  RTPJitterBufferMode mode;
+  guint output_threads;
+  guint max_streams;
+  gboolean do_lost;
+
+  /* stats */
+  guint64 num_pushed;
+  guint64 num_lost;
+  guint64 num_late;
+  guint64 num_duplicates;
+};
+
+struct _GstRtpMultiJitterBufferClass
+{
+  GstElementClass parent_class;
+
+  /* signals */
+  GstCaps * (*request_pt_map)   (GstRtpMultiJitterBuffer *jbuf, guint ssrc, guint pt);
+  void      (*new_ssrc_pad)     (GstRtpMultiJitterBuffer *jbuf, guint32 ssrc, GstPad *pad);
+  void      (*removed_ssrc_pad) (GstRtpMultiJitterBuffer *jbuf, guint32 ssrc, GstPad *pad);
+
+  /* actions */
+  void      (*clear_ssrc)       (GstRtpMultiJitterBuffer *jbuf, guint32 ssrc);
+};
+
+GType gst_rtp_multi_jitter_buffer_get_type (void);
+
+GST_ELEMENT_REGISTER_DECLARE (rtpmultijitterbuffer);
+
+#endif /* __GST_RTP_MULTI_JITTER_BUFFER_H__ */
@@ -19,6 +19,8 @@
 
 #include "gstrtputils.h"
 
+#include <string.h>
+
 guint8
 gst_rtp_get_extmap_id_for_attribute (const GstStructure * s,
     const gchar * ext_name)
@@ -42,3 +44,45 @@ gst_rtp_get_extmap_id_for_attribute (const GstStructure * s,
   }
   return extmap_id;
 }
+
+/* Writes the string at @str, which is protected by the object lock of @ext,
+ * into all packets of @output. All the packets of a list get the same string,
+ * so it is copied under a single lock. */
+gboolean
+gst_rtp_utils_write_string_hdrext_list (GstRTPHeaderExtension * ext,
+    gchar ** str, GstRTPHeaderExtensionFlags write_flags,
+    GstBufferList * output, guint8 ** data, const gsize * size,
+    gssize * written)
+{
+  GstRTPHeaderExtensionClass *klass = GST_RTP_HEADER_EXTENSION_GET_CLASS (ext);
+  gsize max_size = klass->get_max_size (ext, NULL);
+  guint i, n = gst_buffer_list_length (output);
+  gsize len = 0;
+
+  g_return_val_if_fail (write_flags & klass->get_supported_flags (ext), FALSE);
+  for (i = 0; i < n; i++)
+    g_return_val_if_fail (data[i] == NULL || size[i] >= max_size, FALSE);
+
+  GST_OBJECT_LOCK (ext);
+  if (*str)
+    len = strlen (*str);
+  if ((write_flags & GST_RTP_HEADER_EXTENSION_TWO_BYTE) == 0 && len > 16) {
+    GST_DEBUG_OBJECT (ext, "cannot write a value of size %" G_GSIZE_FORMAT
+        " without using the two byte extension format", len);
+    len = 0;
+  }
+  if (len > 0)
+    GST_LOG_OBJECT (ext, "writing \'%s\' into %u packets", *str, n);
+
+  for (i = 0; i < n; i++) {
+    if (data[i] == NULL)
+      continue;
+
+    if (len > 0)
+      memcpy (data[i], *str, len);
+    written[i] = len;
+  }
+  GST_OBJECT_UNLOCK (ext);
+
+  return TRUE;
+}
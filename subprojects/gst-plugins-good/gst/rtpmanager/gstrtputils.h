@@ -21,6 +21,7 @@
 #define __GST_RTP_UTILS_H__
 
 #include <gst/gst.h>
+#include <gst/rtp/gstrtphdrext.h>
 
 G_BEGIN_DECLS
 
@@ -29,6 +30,12 @@ G_BEGIN_DECLS
 G_GNUC_INTERNAL guint8
 gst_rtp_get_extmap_id_for_attribute (const GstStructure * s, const gchar * ext_name);
 
+G_GNUC_INTERNAL gboolean
+gst_rtp_utils_write_string_hdrext_list (GstRTPHeaderExtension * ext,
+    gchar ** str, GstRTPHeaderExtensionFlags write_flags,
+    GstBufferList * output, guint8 ** data, const gsize * size,
+    gssize * written);
+
 G_END_DECLS
 
 #endif /* __GST_RTP_UTILS_H__ */
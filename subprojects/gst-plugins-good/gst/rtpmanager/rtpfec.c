@@ -0,0 +1,365 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "rtpfec.h"
+
+/* Kernels shared by the FEC elements: XOR parity and multiply-accumulate in
+ * GF(2^8) with the 0x11d polynomial, which is what Reed-Solomon repair
+ * packets are made of.
+ *
+ * The GF(2^8) multiplication by a constant is done with two 16 entry table
+ * lookups, one per nibble, when the CPU has a byte shuffle (SSSE3, NEON).
+ * Plain SSE2 multiplies by doubling the source once per bit of the
+ * constant. */
+#if defined (__SSSE3__)
+#include <tmmintrin.h>
+#define RTP_FEC_SSE2 1
+#define RTP_FEC_SHUFFLE 1
+#elif defined (__SSE2__) || defined (_M_X64)
+#include <emmintrin.h>
+#define RTP_FEC_SSE2 1
+#elif defined (__aarch64__)
+#include <arm_neon.h>
+#define RTP_FEC_NEON 1
+#define RTP_FEC_SHUFFLE 1
+#endif
+
+#define GF_POLYNOMIAL 0x11d
+
+static guint8 gf_exp[2 * 255];
+static guint8 gf_log[256];
+
+static void
+rtp_fec_init_tables (void)
+{
+  static gsize initialized = 0;
+
+  if (g_once_init_enter (&initialized)) {
+    guint i, x = 1;
+
+    for (i = 0; i < 255; i++) {
+      gf_exp[i] = x;
+      gf_log[x] = i;
+      x <<= 1;
+      if (x & 0x100)
+        x ^= GF_POLYNOMIAL;
+    }
+    for (i = 255; i < 2 * 255; i++)
+      gf_exp[i] = gf_exp[i - 255];
+
+    g_once_init_leave (&initialized, 1);
+  }
+}
+
+/**
+ * rtp_fec_bitstring_header:
+ * @packet: RTP packet data of at least 12 bytes
+ * @size: size of @packet
+ * @header: the header part of the FEC bit string
+ *
+ * Fills @header with the first two bytes of the RTP header, the length of
+ * the packet after the fixed RTP header and the RTP timestamp.
+ */
+void
+rtp_fec_bitstring_header (const guint8 * packet, gsize size,
+    guint8 header[RTP_FEC_BITSTRING_HEADER_LEN])
+{
+  header[0] = packet[0];
+  header[1] = packet[1];
+  GST_WRITE_UINT16_BE (header + 2, size - 12);
+  memcpy (header + 4, packet + 4, 4);
+}
+
+/**
+ * rtp_fec_xor:
+ * @dst: destination data
+ * @src: source data
+ * @length: number of bytes
+ *
+ * XORs @length bytes of @src into @dst.
+ */
+void
+rtp_fec_xor (guint8 * dst, const guint8 * src, gsize length)
+{
+  gsize i = 0;
+
+#if defined (RTP_FEC_SSE2)
+  for (; i + 64 <= length; i += 64) {
+    __m128i a0 = _mm_loadu_si128 ((const __m128i *) (dst + i));
+    __m128i a1 = _mm_loadu_si128 ((const __m128i *) (dst + i + 16));
+    __m128i a2 = _mm_loadu_si128 ((const __m128i *) (dst + i + 32));
+    __m128i a3 = _mm_loadu_si128 ((const __m128i *) (dst + i + 48));
+
+    a0 = _mm_xor_si128 (a0, _mm_loadu_si128 ((const __m128i *) (src + i)));
+    a1 = _mm_xor_si128 (a1,
+        _mm_loadu_si128 ((const __m128i *) (src + i + 16)));
+    a2 = _mm_xor_si128 (a2,
+        _mm_loadu_si128 ((const __m128i *) (src + i + 32)));
+    a3 = _mm_xor_si128 (a3,
+        _mm_loadu_si128 ((const __m128i *) (src + i + 48)));
+
+    _mm_storeu_si128 ((__m128i *) (dst + i), a0);
+    _mm_storeu_si128 ((__m128i *) (dst + i + 16), a1);
+    _mm_storeu_si128 ((__m128i *) (dst + i + 32), a2);
+    _mm_storeu_si128 ((__m128i *) (dst + i + 48), a3);
+  }
+  for (; i + 16 <= length; i += 16) {
+    __m128i a = _mm_loadu_si128 ((const __m128i *) (dst + i));
+
+    a = _mm_xor_si128 (a, _mm_loadu_si128 ((const __m128i *) (src + i)));
+    _mm_storeu_si128 ((__m128i *) (dst + i), a);
+  }
+#elif defined (RTP_FEC_NEON)
+  for (; i + 16 <= length; i += 16)
+    vst1q_u8 (dst + i, veorq_u8 (vld1q_u8 (dst + i), vld1q_u8 (src + i)));
+#else
+  for (; i + 8 <= length; i += 8)
+    GST_WRITE_UINT64_LE (dst + i,
+        GST_READ_UINT64_LE (dst + i) ^ GST_READ_UINT64_LE (src + i));
+#endif
+
+  for (; i < length; i++)
+    dst[i] ^= src[i];
+}
+
+/**
+ * rtp_fec_gf256_mul:
+ *
+ * Returns: the product of @a and @b in GF(2^8)
+ */
+guint8
+rtp_fec_gf256_mul (guint8 a, guint8 b)
+{
+  if (a == 0 || b == 0)
+    return 0;
+
+  rtp_fec_init_tables ();
+
+  return gf_exp[gf_log[a] + gf_log[b]];
+}
+
+/**
+ * rtp_fec_gf256_inv:
+ *
+ * Returns: the multiplicative inverse of @a in GF(2^8), @a must not be 0
+ */
+guint8
+rtp_fec_gf256_inv (guint8 a)
+{
+  g_return_val_if_fail (a != 0, 0);
+
+  rtp_fec_init_tables ();
+
+  return gf_exp[255 - gf_log[a]];
+}
+
+/**
+ * rtp_fec_gf256_mul_add:
+ * @dst: destination data
+ * @src: source data
+ * @c: the constant to multiply @src with
+ * @length: number of bytes
+ *
+ * Adds @c times @src to @dst in GF(2^8), byte by byte.
+ */
+void
+rtp_fec_gf256_mul_add (guint8 * dst, const guint8 * src, guint8 c,
+    gsize length)
+{
+  gsize i = 0;
+  guint lc;
+
+  if (c == 0)
+    return;
+
+  if (c == 1) {
+    rtp_fec_xor (dst, src, length);
+    return;
+  }
+
+  rtp_fec_init_tables ();
+
+#if defined (RTP_FEC_SHUFFLE)
+  if (length >= 16) {
+    guint8 lo[16], hi[16];
+    guint x;
+
+    for (x = 0; x < 16; x++) {
+      lo[x] = rtp_fec_gf256_mul (c, x);
+      hi[x] = rtp_fec_gf256_mul (c, x << 4);
+    }
+
+#if defined (RTP_FEC_SSE2)
+    {
+      const __m128i tlo = _mm_loadu_si128 ((const __m128i *) lo);
+      const __m128i thi = _mm_loadu_si128 ((const __m128i *) hi);
+      const __m128i mask = _mm_set1_epi8 (0x0f);
+
+      for (; i + 16 <= length; i += 16) {
+        __m128i s = _mm_loadu_si128 ((const __m128i *) (src + i));
+        __m128i d = _mm_loadu_si128 ((const __m128i *) (dst + i));
+        __m128i l = _mm_and_si128 (s, mask);
+        __m128i h = _mm_and_si128 (_mm_srli_epi64 (s, 4), mask);
+
+        d = _mm_xor_si128 (d, _mm_shuffle_epi8 (tlo, l));
+        d = _mm_xor_si128 (d, _mm_shuffle_epi8 (thi, h));
+        _mm_storeu_si128 ((__m128i *) (dst + i), d);
+      }
+    }
+#else
+    {
+      const uint8x16_t tlo = vld1q_u8 (lo);
+      const uint8x16_t thi = vld1q_u8 (hi);
+      const uint8x16_t mask = vdupq_n_u8 (0x0f);
+
+      for (; i + 16 <= length; i += 16) {
+        uint8x16_t s = vld1q_u8 (src + i);
+        uint8x16_t d = vld1q_u8 (dst + i);
+
+        d = veorq_u8 (d, vqtbl1q_u8 (tlo, vandq_u8 (s, mask)));
+        d = veorq_u8 (d, vqtbl1q_u8 (thi, vshrq_n_u8 (s, 4)));
+        vst1q_u8 (dst + i, d);
+      }
+    }
+#endif
+  }
+#elif defined (RTP_FEC_SSE2)
+  {
+    const __m128i poly = _mm_set1_epi8 (GF_POLYNOMIAL & 0xff);
+    const __m128i zero = _mm_setzero_si128 ();
+
+    for (; i + 16 <= length; i += 16) {
+      __m128i s = _mm_loadu_si128 ((const __m128i *) (src + i));
+      __m128i d = _mm_loadu_si128 ((const __m128i *) (dst + i));
+      guint k = c;
+
+      while (TRUE) {
+        if (k & 1)
+          d = _mm_xor_si128 (d, s);
+        k >>= 1;
+        if (k == 0)
+          break;
+        /* multiply by x: shift each byte left and reduce the ones that
+         * overflowed */
+        s = _mm_xor_si128 (_mm_add_epi8 (s, s),
+            _mm_and_si128 (_mm_cmplt_epi8 (s, zero), poly));
+      }
+      _mm_storeu_si128 ((__m128i *) (dst + i), d);
+    }
+  }
+#endif
+
+  lc = gf_log[c];
+  for (; i < length; i++) {
+    if (src[i])
+      dst[i] ^= gf_exp[gf_log[src[i]] + lc];
+  }
+}
+
+/**
+ * rtp_fec_gf256_invert_matrix:
+ * @matrix: @n x @n matrix in row-major order
+ * @n: the dimension of @matrix, at most %RTP_FEC_RS_MAX_REPAIRS
+ *
+ * Inverts @matrix in place with Gauss-Jordan elimination in GF(2^8).
+ *
+ * Returns: %FALSE if @matrix is singular
+ */
+gboolean
+rtp_fec_gf256_invert_matrix (guint8 * matrix, guint n)
+{
+  guint8 aug[RTP_FEC_RS_MAX_REPAIRS][2 * RTP_FEC_RS_MAX_REPAIRS];
+  guint row, col, i;
+
+  g_return_val_if_fail (n <= RTP_FEC_RS_MAX_REPAIRS, FALSE);
+
+  for (row = 0; row < n; row++) {
+    memcpy (aug[row], &matrix[row * n], n);
+    memset (&aug[row][n], 0, n);
+    aug[row][n + row] = 1;
+  }
+
+  for (col = 0; col < n; col++) {
+    guint8 inv;
+
+    /* find a pivot */
+    for (row = col; row < n && aug[row][col] == 0; row++);
+    if (row == n)
+      return FALSE;
+
+    if (row != col) {
+      guint8 tmp[2 * RTP_FEC_RS_MAX_REPAIRS];
+
+      memcpy (tmp, aug[row], 2 * n);
+      memcpy (aug[row], aug[col], 2 * n);
+      memcpy (aug[col], tmp, 2 * n);
+    }
+
+    inv = rtp_fec_gf256_inv (aug[col][col]);
+    for (i = 0; i < 2 * n; i++)
+      aug[col][i] = rtp_fec_gf256_mul (aug[col][i], inv);
+
+    for (row = 0; row < n; row++) {
+      guint8 f = aug[row][col];
+
+      if (row == col || f == 0)
+        continue;
+
+      for (i = 0; i < 2 * n; i++)
+        aug[row][i] ^= rtp_fec_gf256_mul (f, aug[col][i]);
+    }
+  }
+
+  for (row = 0; row < n; row++)
+    memcpy (&matrix[row * n], &aug[row][n], n);
+
+  return TRUE;
+}
+
+/**
+ * rtp_fec_rs_coefficient:
+ * @repair: index of the repair packet in its block
+ * @source: index of the source packet in its block
+ *
+ * The coefficients form a Cauchy matrix with its columns scaled so that the
+ * first repair packet of a block is the plain XOR of the source packets.
+ * Every square sub-matrix of a Cauchy matrix can be inverted, so any
+ * combination of lost source packets can be recovered from as many repair
+ * packets.
+ *
+ * Returns: the coefficient of @source in the repair packet @repair
+ */
+guint8
+rtp_fec_rs_coefficient (guint repair, guint source)
+{
+  guint8 y;
+
+  g_return_val_if_fail (repair < RTP_FEC_RS_MAX_REPAIRS, 0);
+  g_return_val_if_fail (source < RTP_FEC_RS_MAX_SOURCES, 0);
+
+  y = RTP_FEC_RS_MAX_REPAIRS + source;
+
+  return rtp_fec_gf256_mul (y, rtp_fec_gf256_inv (repair ^ y));
+}
@@ -0,0 +1,57 @@
+/* GStreamer
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __RTP_FEC_H__
+#define __RTP_FEC_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* Reed-Solomon coefficients are defined for up to this many repair packets
+ * and RTP_FEC_RS_MAX_SOURCES source packets per block */
+#define RTP_FEC_RS_MAX_REPAIRS 16
+#define RTP_FEC_RS_MAX_SOURCES (256 - RTP_FEC_RS_MAX_REPAIRS)
+
+/* The FEC bit string of a media packet (RFC 8627 section 6.3.1) starts with
+ * this many bytes derived from the RTP header, followed by the packet data
+ * after the fixed 12 byte header */
+#define RTP_FEC_BITSTRING_HEADER_LEN 8
+
+/* Header of Reed-Solomon (R=1 F=1) repair packets: the bit string header,
+ * SN base, K, repair index and the combined first byte of the bit string,
+ * whose top bits are replaced with R and F in the bit string header */
+#define RTP_FEC_RS_HEADER_LEN (RTP_FEC_BITSTRING_HEADER_LEN + 5)
+
+void     rtp_fec_bitstring_header    (const guint8 * packet, gsize size,
+                                      guint8 header[RTP_FEC_BITSTRING_HEADER_LEN]);
+
+void     rtp_fec_xor                 (guint8 * dst, const guint8 * src, gsize length);
+
+void     rtp_fec_gf256_mul_add       (guint8 * dst, const guint8 * src, guint8 c,
+                                      gsize length);
+guint8   rtp_fec_gf256_mul           (guint8 a, guint8 b);
+guint8   rtp_fec_gf256_inv           (guint8 a);
+gboolean rtp_fec_gf256_invert_matrix (guint8 * matrix, guint n);
+
+guint8   rtp_fec_rs_coefficient      (guint repair, guint source);
+
+G_END_DECLS
+
+#endif /* __RTP_FEC_H__ */
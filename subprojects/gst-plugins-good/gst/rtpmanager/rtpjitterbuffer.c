@@ -30,6 +30,15 @@ GST_DEBUG_CATEGORY_STATIC (rtp_jitter_buffer_debug);
 #define MAX_WINDOW	RTP_JITTER_BUFFER_MAX_WINDOW
 #define MAX_TIME	(2 * GST_SECOND)
 
+/* the seqnum index is only used when there are enough packets for walking
+ * the queue to be noticeable, and covers at most half of the seqnum space so
+ * that the seqnum order is not ambiguous */
+#define INDEX_MIN_PACKETS	32
+#define INDEX_MIN_SIZE	512
+#define INDEX_MAX_SIZE	16384
+
+#define POOL_MAX_ITEMS	64
+
 /* signals and args */
 enum
 {
@@ -86,6 +95,7 @@ static void
 rtp_jitter_buffer_init (RTPJitterBuffer * jbuf)
 {
   g_mutex_init (&jbuf->clock_lock);
+  g_mutex_init (&jbuf->pool_lock);
 
   g_queue_init (&jbuf->packets);
   jbuf->mode = RTP_JITTER_BUFFER_MODE_SLAVE;
@@ -116,8 +126,17 @@ rtp_jitter_buffer_finalize (GObject * object)
    * g_slice_free() which may lead to data corruption in the slice allocator.
    */
   rtp_jitter_buffer_flush (jbuf, NULL, NULL);
+  g_free (jbuf->index);
+
+  while (jbuf->pool) {
+    RTPJitterBufferItem *item = jbuf->pool;
+
+    jbuf->pool = (RTPJitterBufferItem *) item->next;
+    g_slice_free (RTPJitterBufferItem, item);
+  }
 
   g_mutex_clear (&jbuf->clock_lock);
+  g_mutex_clear (&jbuf->pool_lock);
 
   G_OBJECT_CLASS (rtp_jitter_buffer_parent_class)->finalize (object);
 }
@@ -700,6 +719,142 @@ queue_do_insert (RTPJitterBuffer * jbuf, GList * list, GList * item)
   queue->length++;
 }
 
+static inline void
+index_add (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item)
+{
+  RTPJitterBufferItem **slot;
+
+  if (jbuf->index == NULL || item->seqnum == -1)
+    return;
+
+  slot = &jbuf->index[item->seqnum & (jbuf->index_size - 1)];
+
+  /* the packets span more than the index, the other packet is lost from the
+   * index until it is rebuilt */
+  if (*slot)
+    jbuf->index_stale = TRUE;
+
+  *slot = item;
+}
+
+static inline void
+index_remove (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item)
+{
+  RTPJitterBufferItem **slot;
+
+  if (jbuf->index == NULL || item->seqnum == -1)
+    return;
+
+  slot = &jbuf->index[item->seqnum & (jbuf->index_size - 1)];
+  if (*slot == item)
+    *slot = NULL;
+}
+
+static void
+index_rebuild (RTPJitterBuffer * jbuf, guint size)
+{
+  GList *list;
+
+  if (size != jbuf->index_size) {
+    g_free (jbuf->index);
+    jbuf->index = g_new0 (RTPJitterBufferItem *, size);
+    jbuf->index_size = size;
+  } else {
+    memset (jbuf->index, 0, size * sizeof (RTPJitterBufferItem *));
+  }
+  jbuf->index_stale = FALSE;
+
+  for (list = jbuf->packets.head; list; list = list->next)
+    index_add (jbuf, (RTPJitterBufferItem *) list);
+}
+
+/* Finds where the packet @seqnum goes with the index, this only handles
+ * packets that fill a gap between the first and the last packet, which are
+ * the ones that need a long walk of the queue. Returns %FALSE when the queue
+ * has to be walked instead. */
+static gboolean
+index_find_position (RTPJitterBuffer * jbuf, guint16 seqnum, GList ** list,
+    gboolean * duplicate)
+{
+  RTPJitterBufferItem *low, *high, *it;
+  guint span, mask, dist;
+
+  if (jbuf->index == NULL && jbuf->packets.length < INDEX_MIN_PACKETS)
+    return FALSE;
+
+  low = (RTPJitterBufferItem *) jbuf->packets.head;
+  while (low && low->seqnum == -1)
+    low = (RTPJitterBufferItem *) low->next;
+
+  high = (RTPJitterBufferItem *) jbuf->packets.tail;
+  while (high && high->seqnum == -1)
+    high = (RTPJitterBufferItem *) high->prev;
+
+  if (low == NULL || low == high)
+    return FALSE;
+
+  if (gst_rtp_buffer_compare_seqnum (low->seqnum, seqnum) <= 0 ||
+      gst_rtp_buffer_compare_seqnum (seqnum, high->seqnum) <= 0)
+    return FALSE;
+
+  span = (guint16) (high->seqnum - low->seqnum);
+  if (span >= INDEX_MAX_SIZE)
+    return FALSE;
+
+  if (span >= jbuf->index_size || jbuf->index_stale) {
+    guint size = MAX (jbuf->index_size, INDEX_MIN_SIZE);
+
+    while (size <= span)
+      size <<= 1;
+
+    GST_DEBUG ("rebuilding index of %u packets, size %u",
+        jbuf->packets.length, size);
+    index_rebuild (jbuf, size);
+  }
+
+  mask = jbuf->index_size - 1;
+
+  it = jbuf->index[seqnum & mask];
+  if (it) {
+    if (it->seqnum != seqnum)
+      return FALSE;
+
+    *duplicate = TRUE;
+    return TRUE;
+  }
+
+  /* look for the closest packet before or after, @low and @high bound the
+   * search */
+  for (dist = 1; dist <= span; dist++) {
+    it = jbuf->index[(seqnum - dist) & mask];
+    if (it) {
+      if (it->seqnum != ((seqnum - dist) & 0xffff))
+        return FALSE;
+
+      /* insert after the events that follow the previous packet */
+      *list = (GList *) it;
+      while ((*list)->next &&
+          ((RTPJitterBufferItem *) (*list)->next)->seqnum == -1)
+        *list = (*list)->next;
+      *duplicate = FALSE;
+      return TRUE;
+    }
+
+    it = jbuf->index[(seqnum + dist) & mask];
+    if (it) {
+      if (it->seqnum != ((seqnum + dist) & 0xffff))
+        return FALSE;
+
+      /* insert right before the next packet */
+      *list = it->prev;
+      *duplicate = FALSE;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
 GstClockTime
 rtp_jitter_buffer_calculate_pts (RTPJitterBuffer * jbuf, GstClockTime dts,
     gboolean estimated_dts, guint32 rtptime, GstClockTime base_time,
@@ -1036,6 +1191,10 @@ done:
  * packet will be used to sort the packets. This function takes ownerhip of
  * @buf when the function returns %TRUE.
  *
+ * Packets arriving in order are found at the tail, packets filling a gap
+ * are placed with the seqnum index of @jbuf, so that reordered and
+ * retransmitted packets do not walk the whole queue.
+ *
  * When @head is %TRUE, the new packet was added at the head of the queue and
  * will be available with the next call to rtp_jitter_buffer_pop() and
  * rtp_jitter_buffer_peek().
@@ -1047,6 +1206,7 @@ rtp_jitter_buffer_insert (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item,
     gboolean * head, gint * percent)
 {
   GList *list, *event = NULL;
+  gboolean duplicate;
   guint16 seqnum;
 
   g_return_val_if_fail (jbuf != NULL, FALSE);
@@ -1060,6 +1220,12 @@ rtp_jitter_buffer_insert (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item,
 
   seqnum = item->seqnum;
 
+  if (index_find_position (jbuf, seqnum, &list, &duplicate)) {
+    if (duplicate)
+      goto duplicate;
+    goto append;
+  }
+
   /* loop the list to skip strictly larger seqnum buffers */
   for (; list; list = g_list_previous (list)) {
     guint16 qseq;
@@ -1100,6 +1266,7 @@ rtp_jitter_buffer_insert (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item,
 
 append:
   queue_do_insert (jbuf, list, (GList *) item);
+  index_add (jbuf, item);
 
   /* buffering mode, update buffer stats */
   if (jbuf->mode == RTP_JITTER_BUFFER_MODE_BUFFER)
@@ -1137,18 +1304,28 @@ duplicate:
  * @rtptime: The RTP specific timestamp
  * @free_data: A function to free @data (optional)
  *
- * Create an item that can then be stored in the jitter buffer.
+ * Create an item that can then be stored in the jitter buffer. Items
+ * released with rtp_jitter_buffer_release_item() are reused first.
  *
  * Returns: a newly allocated RTPJitterbufferItem
  */
 static RTPJitterBufferItem *
-rtp_jitter_buffer_alloc_item (gpointer data, guint type, GstClockTime dts,
-    GstClockTime pts, guint seqnum, guint count, guint rtptime,
-    GDestroyNotify free_data)
+rtp_jitter_buffer_alloc_item (RTPJitterBuffer * jbuf, gpointer data,
+    guint type, GstClockTime dts, GstClockTime pts, guint seqnum, guint count,
+    guint rtptime, GDestroyNotify free_data)
 {
   RTPJitterBufferItem *item;
 
-  item = g_slice_new (RTPJitterBufferItem);
+  g_mutex_lock (&jbuf->pool_lock);
+  item = jbuf->pool;
+  if (item) {
+    jbuf->pool = (RTPJitterBufferItem *) item->next;
+    jbuf->pool_size--;
+  }
+  g_mutex_unlock (&jbuf->pool_lock);
+
+  if (item == NULL)
+    item = g_slice_new (RTPJitterBufferItem);
   item->data = data;
   item->next = NULL;
   item->prev = NULL;
@@ -1164,10 +1341,10 @@ rtp_jitter_buffer_alloc_item (gpointer data, guint type, GstClockTime dts,
 }
 
 static inline RTPJitterBufferItem *
-alloc_event_item (GstEvent * event)
+alloc_event_item (RTPJitterBuffer * jbuf, GstEvent * event)
 {
-  return rtp_jitter_buffer_alloc_item (event, ITEM_TYPE_EVENT, -1, -1, -1, 0,
-      -1, (GDestroyNotify) gst_mini_object_unref);
+  return rtp_jitter_buffer_alloc_item (jbuf, event, ITEM_TYPE_EVENT, -1, -1,
+      -1, 0, -1, (GDestroyNotify) gst_mini_object_unref);
 }
 
 /**
@@ -1182,7 +1359,7 @@ alloc_event_item (GstEvent * event)
 gboolean
 rtp_jitter_buffer_append_event (RTPJitterBuffer * jbuf, GstEvent * event)
 {
-  RTPJitterBufferItem *item = alloc_event_item (event);
+  RTPJitterBufferItem *item = alloc_event_item (jbuf, event);
   gboolean head;
   rtp_jitter_buffer_insert (jbuf, item, &head, NULL);
   return head;
@@ -1201,8 +1378,8 @@ gboolean
 rtp_jitter_buffer_append_query (RTPJitterBuffer * jbuf, GstQuery * query)
 {
   RTPJitterBufferItem *item =
-      rtp_jitter_buffer_alloc_item (query, ITEM_TYPE_QUERY, -1, -1, -1, 0, -1,
-      NULL);
+      rtp_jitter_buffer_alloc_item (jbuf, query, ITEM_TYPE_QUERY, -1, -1, -1,
+      0, -1, NULL);
   gboolean head;
   rtp_jitter_buffer_insert (jbuf, item, &head, NULL);
   return head;
@@ -1223,14 +1400,14 @@ gboolean
 rtp_jitter_buffer_append_lost_event (RTPJitterBuffer * jbuf, GstEvent * event,
     guint16 seqnum, guint lost_packets)
 {
-  RTPJitterBufferItem *item = rtp_jitter_buffer_alloc_item (event,
+  RTPJitterBufferItem *item = rtp_jitter_buffer_alloc_item (jbuf, event,
       ITEM_TYPE_LOST, -1, -1, seqnum, lost_packets, -1,
       (GDestroyNotify) gst_mini_object_unref);
   gboolean head;
 
   if (!rtp_jitter_buffer_insert (jbuf, item, &head, NULL)) {
     /* Duplicate */
-    rtp_jitter_buffer_free_item (item);
+    rtp_jitter_buffer_release_item (jbuf, item);
     head = FALSE;
   }
 
@@ -1254,7 +1431,7 @@ rtp_jitter_buffer_append_buffer (RTPJitterBuffer * jbuf, GstBuffer * buf,
     GstClockTime dts, GstClockTime pts, guint16 seqnum, guint rtptime,
     gboolean * duplicate, gint * percent)
 {
-  RTPJitterBufferItem *item = rtp_jitter_buffer_alloc_item (buf,
+  RTPJitterBufferItem *item = rtp_jitter_buffer_alloc_item (jbuf, buf,
       ITEM_TYPE_BUFFER, dts, pts, seqnum, 1, rtptime,
       (GDestroyNotify) gst_mini_object_unref);
   gboolean head;
@@ -1262,7 +1439,7 @@ rtp_jitter_buffer_append_buffer (RTPJitterBuffer * jbuf, GstBuffer * buf,
 
   inserted = rtp_jitter_buffer_insert (jbuf, item, &head, percent);
   if (!inserted)
-    rtp_jitter_buffer_free_item (item);
+    rtp_jitter_buffer_release_item (jbuf, item);
 
   if (duplicate)
     *duplicate = !inserted;
@@ -1293,6 +1470,7 @@ rtp_jitter_buffer_pop (RTPJitterBuffer * jbuf, gint * percent)
 
   item = queue->head;
   if (item) {
+    index_remove (jbuf, (RTPJitterBufferItem *) item);
     queue->head = item->next;
     if (queue->head)
       queue->head->prev = NULL;
@@ -1350,11 +1528,15 @@ rtp_jitter_buffer_flush (RTPJitterBuffer * jbuf, GFunc free_func,
 
   g_return_if_fail (jbuf != NULL);
 
-  if (free_func == NULL)
-    free_func = (GFunc) rtp_jitter_buffer_free_item;
+  while ((item = g_queue_pop_head_link (&jbuf->packets))) {
+    index_remove (jbuf, (RTPJitterBufferItem *) item);
 
-  while ((item = g_queue_pop_head_link (&jbuf->packets)))
-    free_func ((RTPJitterBufferItem *) item, user_data);
+    if (free_func)
+      free_func ((RTPJitterBufferItem *) item, user_data);
+    else
+      rtp_jitter_buffer_release_item (jbuf, (RTPJitterBufferItem *) item);
+  }
+  jbuf->index_stale = FALSE;
 }
 
 /**
@@ -1602,3 +1784,37 @@ rtp_jitter_buffer_free_item (RTPJitterBufferItem * item)
     item->free_data (item->data);
   g_slice_free (RTPJitterBufferItem, item);
 }
+
+/**
+ * rtp_jitter_buffer_release_item:
+ * @jbuf: the #RTPJitterBuffer that @item was popped from
+ * @item: the item to be released
+ *
+ * Free the data of the jitter buffer item and keep the item for the next
+ * packets of @jbuf. This can be called without holding the lock that protects
+ * @jbuf.
+ */
+void
+rtp_jitter_buffer_release_item (RTPJitterBuffer * jbuf,
+    RTPJitterBufferItem * item)
+{
+  g_return_if_fail (item != NULL);
+  /* needs to be unlinked first */
+  g_return_if_fail (item->next == NULL);
+  g_return_if_fail (item->prev == NULL);
+
+  if (item->data && item->free_data)
+    item->free_data (item->data);
+
+  g_mutex_lock (&jbuf->pool_lock);
+  if (jbuf->pool_size < POOL_MAX_ITEMS) {
+    item->next = (GList *) jbuf->pool;
+    jbuf->pool = item;
+    jbuf->pool_size++;
+    item = NULL;
+  }
+  g_mutex_unlock (&jbuf->pool_lock);
+
+  if (item)
+    g_slice_free (RTPJitterBufferItem, item);
+}
@@ -75,6 +75,16 @@ struct _RTPJitterBuffer {
 
   GQueue         packets;
 
+  /* the packets of @packets by seqnum, used to find where new packets go */
+  RTPJitterBufferItem **index;
+  guint          index_size;
+  gboolean       index_stale;
+
+  /* released items, reused for the next packets */
+  GMutex         pool_lock;
+  RTPJitterBufferItem *pool;
+  guint          pool_size;
+
   RTPJitterBufferMode mode;
 
   GstClockTime   delay;
@@ -217,5 +227,7 @@ gboolean              rtp_jitter_buffer_can_fast_start   (RTPJitterBuffer * jbuf
 gboolean              rtp_jitter_buffer_is_full          (RTPJitterBuffer * jbuf);
 
 void                  rtp_jitter_buffer_free_item        (RTPJitterBufferItem * item);
+void                  rtp_jitter_buffer_release_item     (RTPJitterBuffer * jbuf,
+                                                          RTPJitterBufferItem * item);
 
 #endif /* __RTP_JITTER_BUFFER_H__ */
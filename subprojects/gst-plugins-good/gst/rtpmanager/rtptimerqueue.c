@@ -24,12 +24,31 @@
 
 #include "rtptimerqueue.h"
 
+/* The timing wheel hashes timeouts into slots of ~1ms, one lap of the wheel
+ * covers ~4.3s. It is only allocated once a queue holds enough timers for
+ * the list walks to matter. */
+#define RTP_TIMER_WHEEL_SHIFT 20
+#define RTP_TIMER_WHEEL_SIZE 4096
+#define RTP_TIMER_WHEEL_MASK (RTP_TIMER_WHEEL_SIZE - 1)
+#define RTP_TIMER_WHEEL_WORDS (RTP_TIMER_WHEEL_SIZE / 64)
+#define RTP_TIMER_WHEEL_MIN_TIMERS 32
+
+#define RTP_TIMER_TICK(t) ((guint64) (t) >> RTP_TIMER_WHEEL_SHIFT)
+
 struct _RtpTimerQueue
 {
   GObject parent;
 
   GQueue timers;
   GHashTable *hashtable;
+
+  /* Index into @timers: each slot points to the latest timer of its tick, and
+   * the two level bitmap tracks the used slots so that the closest earlier
+   * slot is found in constant time. The list stays the reference, slots may
+   * go stale when a timeout is modified without rescheduling. */
+  RtpTimer **wheel;
+  guint64 wheel_bits[RTP_TIMER_WHEEL_WORDS];
+  guint64 wheel_summary;
 };
 
 G_DEFINE_TYPE (RtpTimerQueue, rtp_timer_queue, G_TYPE_OBJECT);
@@ -39,7 +58,9 @@ G_DEFINE_TYPE (RtpTimerQueue, rtp_timer_queue, G_TYPE_OBJECT);
 static RtpTimer *
 rtp_timer_new (void)
 {
-  return g_slice_new0 (RtpTimer);
+  RtpTimer *timer = g_slice_new0 (RtpTimer);
+  timer->wheel_slot = -1;
+  return timer;
 }
 
 static inline void
@@ -68,6 +89,8 @@ rtp_timer_is_later (RtpTimer * timer, RtpTimer * next)
 
     if (timer->timeout > next->timeout)
       return TRUE;
+  } else if (GST_CLOCK_TIME_IS_VALID (timer->timeout)) {
+    return TRUE;
   }
 
   if (timer->timeout == next->timeout &&
@@ -98,82 +121,6 @@ rtp_timer_is_sooner (RtpTimer * timer, RtpTimer * prev)
   return FALSE;
 }
 
-static inline gboolean
-rtp_timer_is_closer_to_head (RtpTimer * timer, RtpTimer * head)
-{
-  RtpTimer *prev = rtp_timer_get_prev (timer);
-  GstClockTimeDiff prev_delta = 0;
-  GstClockTimeDiff head_delta = 0;
-
-  if (prev == NULL)
-    return FALSE;
-
-  if (rtp_timer_is_sooner (timer, head))
-    return TRUE;
-
-  if (rtp_timer_is_later (timer, prev))
-    return FALSE;
-
-  if (prev->timeout == head->timeout) {
-    gint prev_gap, head_gap;
-
-    prev_gap = gst_rtp_buffer_compare_seqnum (timer->seqnum, prev->seqnum);
-    head_gap = gst_rtp_buffer_compare_seqnum (head->seqnum, timer->seqnum);
-
-    if (head_gap < prev_gap)
-      return TRUE;
-  }
-
-  if (GST_CLOCK_TIME_IS_VALID (timer->timeout) &&
-      GST_CLOCK_TIME_IS_VALID (head->timeout)) {
-    prev_delta = GST_CLOCK_DIFF (timer->timeout, prev->timeout);
-    head_delta = GST_CLOCK_DIFF (head->timeout, timer->timeout);
-
-    if (head_delta < prev_delta)
-      return TRUE;
-  }
-
-  return FALSE;
-}
-
-static inline gboolean
-rtp_timer_is_closer_to_tail (RtpTimer * timer, RtpTimer * tail)
-{
-  RtpTimer *next = rtp_timer_get_next (timer);
-  GstClockTimeDiff tail_delta = 0;
-  GstClockTimeDiff next_delta = 0;
-
-  if (next == NULL)
-    return FALSE;
-
-  if (rtp_timer_is_later (timer, tail))
-    return TRUE;
-
-  if (rtp_timer_is_sooner (timer, next))
-    return FALSE;
-
-  if (tail->timeout == next->timeout) {
-    gint tail_gap, next_gap;
-
-    tail_gap = gst_rtp_buffer_compare_seqnum (timer->seqnum, tail->seqnum);
-    next_gap = gst_rtp_buffer_compare_seqnum (next->seqnum, timer->seqnum);
-
-    if (tail_gap < next_gap)
-      return TRUE;
-  }
-
-  if (GST_CLOCK_TIME_IS_VALID (timer->timeout) &&
-      GST_CLOCK_TIME_IS_VALID (next->timeout)) {
-    tail_delta = GST_CLOCK_DIFF (timer->timeout, tail->timeout);
-    next_delta = GST_CLOCK_DIFF (next->timeout, timer->timeout);
-
-    if (tail_delta < next_delta)
-      return TRUE;
-  }
-
-  return FALSE;
-}
-
 static inline RtpTimer *
 rtp_timer_queue_get_tail (RtpTimerQueue * queue)
 {
@@ -288,6 +235,197 @@ rtp_timer_queue_insert_head (RtpTimerQueue * queue, RtpTimer * timer)
     rtp_timer_queue_insert_before (queue, it, timer);
 }
 
+static inline gint
+rtp_timer_wheel_msb (guint64 bits)
+{
+#if defined(__GNUC__)
+  return 63 - __builtin_clzll (bits);
+#else
+  gint msb = 0;
+
+  while (bits >>= 1)
+    msb++;
+
+  return msb;
+#endif
+}
+
+static void
+rtp_timer_queue_wheel_set (RtpTimerQueue * queue, guint slot, RtpTimer * timer)
+{
+  RtpTimer *old = queue->wheel[slot];
+
+  if (old)
+    old->wheel_slot = -1;
+
+  queue->wheel[slot] = timer;
+  timer->wheel_slot = slot;
+  queue->wheel_bits[slot / 64] |= G_GUINT64_CONSTANT (1) << (slot % 64);
+  queue->wheel_summary |= G_GUINT64_CONSTANT (1) << (slot / 64);
+}
+
+static void
+rtp_timer_queue_wheel_clear (RtpTimerQueue * queue, guint slot)
+{
+  guint word = slot / 64;
+
+  queue->wheel[slot]->wheel_slot = -1;
+  queue->wheel[slot] = NULL;
+
+  queue->wheel_bits[word] &= ~(G_GUINT64_CONSTANT (1) << (slot % 64));
+  if (queue->wheel_bits[word] == 0)
+    queue->wheel_summary &= ~(G_GUINT64_CONSTANT (1) << word);
+}
+
+/* finds the used slot closest to @slot, going backward and wrapping around
+ * the wheel, or -1 if the wheel is empty */
+static gint
+rtp_timer_queue_wheel_find (RtpTimerQueue * queue, guint slot)
+{
+  guint word = slot / 64;
+  guint64 bits;
+
+  bits = queue->wheel_bits[word] &
+      ((G_GUINT64_CONSTANT (2) << (slot % 64)) - 1);
+  if (bits)
+    return word * 64 + rtp_timer_wheel_msb (bits);
+
+  bits = queue->wheel_summary & ((G_GUINT64_CONSTANT (1) << word) - 1);
+  if (bits == 0)
+    bits = queue->wheel_summary;
+  if (bits == 0)
+    return -1;
+
+  word = rtp_timer_wheel_msb (bits);
+  return word * 64 + rtp_timer_wheel_msb (queue->wheel_bits[word]);
+}
+
+/* Returns a queued timer that is close to, and most likely sooner than
+ * @timeout, or %NULL if there is no such timer in the current lap. */
+static RtpTimer *
+rtp_timer_queue_wheel_lookup (RtpTimerQueue * queue, GstClockTime timeout)
+{
+  guint64 tick = RTP_TIMER_TICK (timeout);
+  guint slot = tick & RTP_TIMER_WHEEL_MASK;
+  gint found;
+
+  if (queue->wheel == NULL)
+    return NULL;
+
+  while ((found = rtp_timer_queue_wheel_find (queue, slot)) >= 0) {
+    RtpTimer *timer = queue->wheel[found];
+    guint64 expected = tick - ((slot - found) & RTP_TIMER_WHEEL_MASK);
+
+    /* the timeout was modified in place, this slot is no longer valid */
+    if (!GST_CLOCK_TIME_IS_VALID (timer->timeout) ||
+        (RTP_TIMER_TICK (timer->timeout) & RTP_TIMER_WHEEL_MASK) != found) {
+      rtp_timer_queue_wheel_clear (queue, found);
+      continue;
+    }
+
+    if (RTP_TIMER_TICK (timer->timeout) != expected)
+      return NULL;
+
+    return timer;
+  }
+
+  return NULL;
+}
+
+static void
+rtp_timer_queue_wheel_add (RtpTimerQueue * queue, RtpTimer * timer)
+{
+  RtpTimer *last;
+  guint64 tick;
+  guint slot;
+
+  if (queue->wheel == NULL || !GST_CLOCK_TIME_IS_VALID (timer->timeout))
+    return;
+
+  tick = RTP_TIMER_TICK (timer->timeout);
+  slot = tick & RTP_TIMER_WHEEL_MASK;
+  last = queue->wheel[slot];
+
+  if (last && GST_CLOCK_TIME_IS_VALID (last->timeout) &&
+      (RTP_TIMER_TICK (last->timeout) & RTP_TIMER_WHEEL_MASK) == slot) {
+    guint64 last_tick = RTP_TIMER_TICK (last->timeout);
+
+    /* keep the earliest lap, and the latest timer within a tick */
+    if (last_tick < tick)
+      return;
+    if (last_tick == tick && !rtp_timer_is_later (timer, last))
+      return;
+  }
+
+  rtp_timer_queue_wheel_set (queue, slot, timer);
+}
+
+/* must be called before @timer is unlinked */
+static void
+rtp_timer_queue_wheel_remove (RtpTimerQueue * queue, RtpTimer * timer)
+{
+  RtpTimer *prev;
+  guint slot;
+
+  if (timer->wheel_slot < 0)
+    return;
+
+  slot = timer->wheel_slot;
+  prev = rtp_timer_get_prev (timer);
+
+  /* hand the slot over to the previous timer if it has the same tick */
+  if (prev && prev->wheel_slot < 0 &&
+      GST_CLOCK_TIME_IS_VALID (prev->timeout) &&
+      GST_CLOCK_TIME_IS_VALID (timer->timeout) &&
+      RTP_TIMER_TICK (prev->timeout) == RTP_TIMER_TICK (timer->timeout) &&
+      (RTP_TIMER_TICK (prev->timeout) & RTP_TIMER_WHEEL_MASK) == slot)
+    rtp_timer_queue_wheel_set (queue, slot, prev);
+  else
+    rtp_timer_queue_wheel_clear (queue, slot);
+}
+
+static void
+rtp_timer_queue_wheel_enable (RtpTimerQueue * queue)
+{
+  GList *l;
+
+  queue->wheel = g_new0 (RtpTimer *, RTP_TIMER_WHEEL_SIZE);
+
+  for (l = queue->timers.head; l; l = l->next)
+    rtp_timer_queue_wheel_add (queue, (RtpTimer *) l);
+}
+
+/* Inserts @timer at its place, starting the search from the wheel slot
+ * closest to its timeout when possible */
+static void
+rtp_timer_queue_insert_indexed (RtpTimerQueue * queue, RtpTimer * timer)
+{
+  RtpTimer *it;
+
+  if (!GST_CLOCK_TIME_IS_VALID (timer->timeout)) {
+    rtp_timer_queue_insert_head (queue, timer);
+    return;
+  }
+
+  it = rtp_timer_queue_wheel_lookup (queue, timer->timeout);
+  if (it == NULL) {
+    rtp_timer_queue_insert_tail (queue, timer);
+  } else {
+    while (it && rtp_timer_is_later (it, timer))
+      it = rtp_timer_get_prev (it);
+
+    if (it == NULL) {
+      rtp_timer_queue_insert_head (queue, timer);
+    } else {
+      while (rtp_timer_is_later (timer, rtp_timer_get_next (it)))
+        it = rtp_timer_get_next (it);
+      rtp_timer_queue_insert_after (queue, it, timer);
+    }
+  }
+
+  rtp_timer_queue_wheel_add (queue, timer);
+}
+
 static void
 rtp_timer_queue_init (RtpTimerQueue * queue)
 {
@@ -303,6 +441,7 @@ rtp_timer_queue_finalize (GObject * object)
   while ((timer = rtp_timer_queue_pop_until (queue, GST_CLOCK_TIME_NONE)))
     rtp_timer_free (timer);
   g_hash_table_unref (queue->hashtable);
+  g_free (queue->wheel);
   g_assert (queue->timers.length == 0);
 }
 
@@ -345,6 +484,7 @@ rtp_timer_dup (const RtpTimer * timer)
   memcpy (copy, timer, sizeof (RtpTimer));
   memset (&copy->list, 0, sizeof (GList));
   copy->queued = FALSE;
+  copy->wheel_slot = -1;
   return copy;
 }
 
@@ -394,9 +534,9 @@ rtp_timer_queue_new (void)
  * @timer: (transfer full): the #RtpTimer to insert
  *
  * Insert a timer into the queue. Earliest timer are at the head and then
- * timer are sorted by seqnum (smaller seqnum first). This function is o(n)
- * but it is expected that most timers added are schedule later, in which case
- * the insertion will be faster.
+ * timer are sorted by seqnum (smaller seqnum first). Once the queue is large
+ * enough the insertion point is found through a hashed timing wheel, which
+ * makes this function o(1) for timeouts within a few seconds of each other.
  *
  * Returns: %FALSE if a timer with the same seqnum already existed
  */
@@ -411,10 +551,11 @@ rtp_timer_queue_insert (RtpTimerQueue * queue, RtpTimer * timer)
     return FALSE;
   }
 
-  if (timer->timeout == -1)
-    rtp_timer_queue_insert_head (queue, timer);
-  else
-    rtp_timer_queue_insert_tail (queue, timer);
+  if (queue->wheel == NULL &&
+      queue->timers.length >= RTP_TIMER_WHEEL_MIN_TIMERS)
+    rtp_timer_queue_wheel_enable (queue);
+
+  rtp_timer_queue_insert_indexed (queue, timer);
 
   g_hash_table_insert (queue->hashtable,
       GINT_TO_POINTER (timer->seqnum), timer);
@@ -429,49 +570,28 @@ rtp_timer_queue_insert (RtpTimerQueue * queue, RtpTimer * timer)
  * @timer: the #RtpTimer to reschedule
  *
  * This function moves @timer inside the queue to put it back to it's new
- * location. This function is o(n) but it is assumed that nearby modification
- * of the timeout will occure.
+ * location. Like rtp_timer_queue_insert() this is o(1) once the timing
+ * wheel is in use.
  *
  * Returns: %TRUE if the timer was moved
  */
 gboolean
 rtp_timer_queue_reschedule (RtpTimerQueue * queue, RtpTimer * timer)
 {
-  RtpTimer *it = timer;
-
   g_return_val_if_fail (timer->queued == TRUE, FALSE);
 
-  if (rtp_timer_is_closer_to_head (timer, rtp_timer_queue_get_head (queue))) {
-    g_queue_unlink (&queue->timers, (GList *) timer);
-    rtp_timer_queue_insert_head (queue, timer);
-    return TRUE;
-  }
-
-  while (rtp_timer_is_sooner (timer, rtp_timer_get_prev (it)))
-    it = rtp_timer_get_prev (it);
+  rtp_timer_queue_wheel_remove (queue, timer);
 
-  if (it != timer) {
-    g_queue_unlink (&queue->timers, (GList *) timer);
-    rtp_timer_queue_insert_before (queue, it, timer);
-    return TRUE;
-  }
-
-  if (rtp_timer_is_closer_to_tail (timer, rtp_timer_queue_get_tail (queue))) {
-    g_queue_unlink (&queue->timers, (GList *) timer);
-    rtp_timer_queue_insert_tail (queue, timer);
-    return TRUE;
+  if (!rtp_timer_is_sooner (timer, rtp_timer_get_prev (timer)) &&
+      !rtp_timer_is_later (timer, rtp_timer_get_next (timer))) {
+    rtp_timer_queue_wheel_add (queue, timer);
+    return FALSE;
   }
 
-  while (rtp_timer_is_later (timer, rtp_timer_get_next (it)))
-    it = rtp_timer_get_next (it);
-
-  if (it != timer) {
-    g_queue_unlink (&queue->timers, (GList *) timer);
-    rtp_timer_queue_insert_after (queue, it, timer);
-    return TRUE;
-  }
+  g_queue_unlink (&queue->timers, (GList *) timer);
+  rtp_timer_queue_insert_indexed (queue, timer);
 
-  return FALSE;
+  return TRUE;
 }
 
 /**
@@ -487,6 +607,7 @@ rtp_timer_queue_unschedule (RtpTimerQueue * queue, RtpTimer * timer)
 {
   g_return_if_fail (timer->queued == TRUE);
 
+  rtp_timer_queue_wheel_remove (queue, timer);
   g_queue_unlink (&queue->timers, (GList *) timer);
   g_hash_table_remove (queue->hashtable, GINT_TO_POINTER (timer->seqnum));
   timer->queued = FALSE;
@@ -564,8 +685,8 @@ rtp_timer_queue_remove_all (RtpTimerQueue * queue)
  * @offset: offset that can be used to convert the timeout to timestamp
  *
  * If there exist a timer with this seqnum it will be updated other a new
- * timer is created and inserted into the queue. This function is o(n) except
- * that it's optimized for later timer insertion.
+ * timer is created and inserted into the queue, see rtp_timer_queue_insert()
+ * and rtp_timer_queue_reschedule().
  */
 void
 rtp_timer_queue_set_timer (RtpTimerQueue * queue, RtpTimerType type,
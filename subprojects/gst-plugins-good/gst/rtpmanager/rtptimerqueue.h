@@ -58,6 +58,8 @@ typedef struct
 {
   GList list;
   gboolean queued;
+  /* slot of the timing wheel that points to this timer, or -1 */
+  gint wheel_slot;
 
   guint16 seqnum;
   RtpTimerType type;
@@ -2372,6 +2372,7 @@ copy_yuy2_yuy2 (guint i_alpha, GstVideoFrame * dest_frame,
 #define DEFAULT_FILL_TYPE VIDEO_BOX_FILL_BLACK
 #define DEFAULT_ALPHA     1.0
 #define DEFAULT_BORDER_ALPHA 1.0
+#define DEFAULT_N_THREADS 1
 
 enum
 {
@@ -2383,7 +2384,8 @@ enum
   PROP_FILL_TYPE,
   PROP_ALPHA,
   PROP_BORDER_ALPHA,
-  PROP_AUTOCROP
+  PROP_AUTOCROP,
+  PROP_N_THREADS
       /* FILL ME */
 };
 
@@ -2428,8 +2430,9 @@ static gboolean gst_video_box_src_event (GstBaseTransform * trans,
 
 static gboolean gst_video_box_set_info (GstVideoFilter * vfilter, GstCaps * in,
     GstVideoInfo * in_info, GstCaps * out, GstVideoInfo * out_info);
-static GstFlowReturn gst_video_box_transform_frame (GstVideoFilter * vfilter,
-    GstVideoFrame * in_frame, GstVideoFrame * out_frame);
+static GstFlowReturn gst_video_box_transform_frame_slice (GstVideoFilter *
+    vfilter, GstVideoFrame * in_frame, GstVideoFrame * out_frame,
+    guint start_line, guint end_line);
 
 #define GST_TYPE_VIDEO_BOX_FILL (gst_video_box_fill_get_type())
 static GType
@@ -2516,6 +2519,19 @@ gst_video_box_class_init (GstVideoBoxClass * klass)
   g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_AUTOCROP,
       g_param_spec_boolean ("autocrop", "Auto crop",
           "Auto crop", FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstVideoBox:n-threads:
+   *
+   * Maximum number of threads used to fill and copy each output frame in
+   * slices. 0 uses the number of CPUs.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use (0 = number of CPUs)", 0,
+          G_MAXUINT, DEFAULT_N_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   trans_class->before_transform =
       GST_DEBUG_FUNCPTR (gst_video_box_before_transform);
@@ -2524,8 +2540,8 @@ gst_video_box_class_init (GstVideoBoxClass * klass)
   trans_class->src_event = GST_DEBUG_FUNCPTR (gst_video_box_src_event);
 
   vfilter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_box_set_info);
-  vfilter_class->transform_frame =
-      GST_DEBUG_FUNCPTR (gst_video_box_transform_frame);
+  vfilter_class->transform_frame_slice =
+      GST_DEBUG_FUNCPTR (gst_video_box_transform_frame_slice);
 
   gst_element_class_set_static_metadata (element_class, "Video box filter",
       "Filter/Effect/Video",
@@ -2556,6 +2572,8 @@ gst_video_box_init (GstVideoBox * video_box)
   video_box->border_alpha = DEFAULT_BORDER_ALPHA;
   video_box->autocrop = FALSE;
 
+  video_box->line_align = 1;
+
   g_mutex_init (&video_box->mutex);
 }
 
@@ -2565,6 +2583,13 @@ gst_video_box_set_property (GObject * object, guint prop_id,
 {
   GstVideoBox *video_box = GST_VIDEO_BOX (object);
 
+  /* doesn't change the transformation, the base class stores it */
+  if (prop_id == PROP_N_THREADS) {
+    gst_video_filter_set_n_threads (GST_VIDEO_FILTER (video_box),
+        g_value_get_uint (value));
+    return;
+  }
+
   g_mutex_lock (&video_box->mutex);
   switch (prop_id) {
     case PROP_LEFT:
@@ -2717,6 +2742,10 @@ gst_video_box_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_AUTOCROP:
       g_value_set_boolean (value, video_box->autocrop);
       break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value,
+          gst_video_filter_get_n_threads (GST_VIDEO_FILTER (video_box)));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3165,6 +3194,9 @@ gst_video_box_set_info (GstVideoFilter * vfilter, GstCaps * in,
   video_box->out_sdtv =
       out_info->colorimetry.matrix == GST_VIDEO_COLOR_MATRIX_BT601;
 
+  video_box->line_align = MAX (gst_video_filter_get_line_alignment (in_info),
+      gst_video_filter_get_line_alignment (out_info));
+
   GST_DEBUG_OBJECT (video_box, "Input w: %d h: %d", video_box->in_width,
       video_box->in_height);
   GST_DEBUG_OBJECT (video_box, "Output w: %d h: %d", video_box->out_width,
@@ -3216,14 +3248,14 @@ gst_video_box_src_event (GstBaseTransform * trans, GstEvent * event)
   return GST_BASE_TRANSFORM_CLASS (parent_class)->src_event (trans, event);
 }
 
+/* Sets up @params for the next frame. Called with the lock */
 static void
-gst_video_box_process (GstVideoBox * video_box, GstVideoFrame * in,
-    GstVideoFrame * out)
+gst_video_box_prepare_frame (GstVideoBox * video_box,
+    GstVideoBoxFrameParams * params)
 {
-  guint b_alpha = CLAMP (video_box->border_alpha * 256, 0, 255);
-  guint i_alpha = CLAMP (video_box->alpha * 256, 0, 255);
-  GstVideoBoxFill fill_type = video_box->fill_type;
   gint br, bl, bt, bb, crop_w, crop_h;
+  gint src_x = 0, src_y = 0;
+  gint dest_x = 0, dest_y = 0;
 
   crop_h = 0;
   crop_w = 0;
@@ -3253,44 +3285,88 @@ gst_video_box_process (GstVideoBox * video_box, GstVideoFrame * in,
     crop_h = video_box->in_height;
   }
 
+  /* Top border */
+  if (bt < 0) {
+    dest_y += -bt;
+  } else {
+    src_y += bt;
+  }
+
+  /* Left border */
+  if (bl < 0) {
+    dest_x += -bl;
+  } else {
+    src_x += bl;
+  }
+
+  params->fill = video_box->fill;
+  params->copy = video_box->copy;
+  params->fill_type = video_box->fill_type;
+  params->b_alpha = CLAMP (video_box->border_alpha * 256, 0, 255);
+  params->i_alpha = CLAMP (video_box->alpha * 256, 0, 255);
+  params->in_sdtv = video_box->in_sdtv;
+  params->out_sdtv = video_box->out_sdtv;
+  params->crop_w = crop_w;
+  params->crop_h = crop_h;
+  params->src_x = src_x;
+  params->src_y = src_y;
+  params->dest_x = dest_x;
+  params->dest_y = dest_y;
+  params->add_border = bt < 0 || bb < 0 || br < 0 || bl < 0;
+
+  /* The copy functions blend the first and last line of the frame with the
+   * border if they only cover part of a chroma line and expect to be called
+   * with all lines of the frame then. Let the first slice do everything. */
+  params->whole_frame = crop_h >= 0 && crop_w >= 0 &&
+      (dest_y % video_box->line_align || src_y % video_box->line_align);
+
   GST_DEBUG_OBJECT (video_box, "Borders are: L:%d, R:%d, T:%d, B:%d", bl, br,
       bt, bb);
   GST_DEBUG_OBJECT (video_box, "Alpha value is: %u (frame) %u (border)",
-      i_alpha, b_alpha);
+      params->i_alpha, params->b_alpha);
+}
 
-  if (crop_h < 0 || crop_w < 0) {
-    video_box->fill (fill_type, b_alpha, out, video_box->out_sdtv);
-  } else if (bb == 0 && bt == 0 && br == 0 && bl == 0) {
-    video_box->copy (i_alpha, out, video_box->out_sdtv, 0, 0, in,
-        video_box->in_sdtv, 0, 0, crop_w, crop_h);
-  } else {
-    gint src_x = 0, src_y = 0;
-    gint dest_x = 0, dest_y = 0;
+/* Processes lines @start_line to @end_line of @out. Slices are aligned to the
+ * chroma subsampling, so the lines of a slice can be filled and then copied
+ * into without depending on any other slice. */
+static void
+gst_video_box_process (GstVideoBox * video_box,
+    const GstVideoBoxFrameParams * params, GstVideoFrame * in,
+    GstVideoFrame * out, guint start_line, guint end_line)
+{
+  gint first, last;
+  GstVideoFrame out_slice;
 
-    /* Fill everything if a border should be added somewhere */
-    if (bt < 0 || bb < 0 || br < 0 || bl < 0)
-      video_box->fill (fill_type, b_alpha, out, video_box->out_sdtv);
+  if (params->whole_frame) {
+    if (start_line > 0)
+      return;
+    end_line = GST_VIDEO_FRAME_HEIGHT (out);
+  }
 
-    /* Top border */
-    if (bt < 0) {
-      dest_y += -bt;
-    } else {
-      src_y += bt;
-    }
+  gst_video_filter_get_frame_slice (out, &out_slice, start_line, end_line);
 
-    /* Left border */
-    if (bl < 0) {
-      dest_x += -bl;
-    } else {
-      src_x += bl;
-    }
+  if (params->crop_h < 0 || params->crop_w < 0) {
+    params->fill (params->fill_type, params->b_alpha, &out_slice,
+        params->out_sdtv);
+    return;
+  }
 
-    /* Frame */
-    video_box->copy (i_alpha, out, video_box->out_sdtv, dest_x, dest_y,
-        in, video_box->in_sdtv, src_x, src_y, crop_w, crop_h);
+  /* Fill everything if a border should be added somewhere */
+  if (params->add_border)
+    params->fill (params->fill_type, params->b_alpha, &out_slice,
+        params->out_sdtv);
+
+  /* Frame, only the lines that are part of this slice */
+  first = MAX (params->dest_y, (gint) start_line);
+  last = MIN (params->dest_y + params->crop_h, (gint) end_line);
+  if (first < last) {
+    params->copy (params->i_alpha, &out_slice, params->out_sdtv,
+        params->dest_x, first - start_line, in, params->in_sdtv,
+        params->src_x, params->src_y + (first - params->dest_y),
+        params->crop_w, last - first);
   }
 
-  GST_LOG_OBJECT (video_box, "image created");
+  GST_LOG_OBJECT (video_box, "lines %u-%u created", start_line, end_line);
 }
 
 static void
@@ -3308,17 +3384,22 @@ gst_video_box_before_transform (GstBaseTransform * trans, GstBuffer * in)
 
   if (GST_CLOCK_TIME_IS_VALID (stream_time))
     gst_object_sync_values (GST_OBJECT (video_box), stream_time);
+
+  /* the slices of the frame all use this and don't need the lock */
+  g_mutex_lock (&video_box->mutex);
+  gst_video_box_prepare_frame (video_box, &video_box->frame_params);
+  g_mutex_unlock (&video_box->mutex);
 }
 
 static GstFlowReturn
-gst_video_box_transform_frame (GstVideoFilter * vfilter,
-    GstVideoFrame * in_frame, GstVideoFrame * out_frame)
+gst_video_box_transform_frame_slice (GstVideoFilter * vfilter,
+    GstVideoFrame * in_frame, GstVideoFrame * out_frame, guint start_line,
+    guint end_line)
 {
   GstVideoBox *video_box = GST_VIDEO_BOX (vfilter);
 
-  g_mutex_lock (&video_box->mutex);
-  gst_video_box_process (video_box, in_frame, out_frame);
-  g_mutex_unlock (&video_box->mutex);
+  gst_video_box_process (video_box, &video_box->frame_params, in_frame,
+      out_frame, start_line, end_line);
   return GST_FLOW_OK;
 }
 
@@ -50,6 +50,27 @@ typedef enum
 }
 GstVideoBoxFill;
 
+typedef struct _GstVideoBoxFrameParams GstVideoBoxFrameParams;
+
+/* How a frame is processed, set up from the properties and caps before each
+ * frame so that its slices don't need the lock */
+struct _GstVideoBoxFrameParams
+{
+  void (*fill) (GstVideoBoxFill fill_type, guint b_alpha, GstVideoFrame *dest, gboolean sdtv);
+  void (*copy) (guint i_alpha, GstVideoFrame * dest, gboolean dest_sdtv, gint dest_x, gint dest_y, GstVideoFrame * src, gboolean src_sdtv, gint src_x, gint src_y, gint w, gint h);
+
+  GstVideoBoxFill fill_type;
+  guint b_alpha, i_alpha;
+  gboolean in_sdtv, out_sdtv;
+
+  gint crop_w, crop_h;
+  gint src_x, src_y;
+  gint dest_x, dest_y;
+  gboolean add_border;
+  /* the first slice processes the whole frame */
+  gboolean whole_frame;
+};
+
 struct _GstVideoBox
 {
   GstVideoFilter element;
@@ -65,6 +86,8 @@ struct _GstVideoBox
   GstVideoFormat out_format;
   gint out_width, out_height;
   gboolean out_sdtv;
+  /* lines sharing chroma samples in the input or output */
+  guint line_align;
 
   gint box_left, box_right, box_top, box_bottom;
 
@@ -80,6 +103,9 @@ struct _GstVideoBox
 
   void (*fill) (GstVideoBoxFill fill_type, guint b_alpha, GstVideoFrame *dest, gboolean sdtv);
   void (*copy) (guint i_alpha, GstVideoFrame * dest, gboolean dest_sdtv, gint dest_x, gint dest_y, GstVideoFrame * src, gboolean src_sdtv, gint src_x, gint src_y, gint w, gint h);
+
+  /* only accessed from the streaming thread */
+  GstVideoBoxFrameParams frame_params;
 };
 
 struct _GstVideoBoxClass
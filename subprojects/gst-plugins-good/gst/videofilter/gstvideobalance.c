@@ -57,6 +57,7 @@ GST_DEBUG_CATEGORY_STATIC (videobalance_debug);
 #define DEFAULT_PROP_BRIGHTNESS		0.0
 #define DEFAULT_PROP_HUE		0.0
 #define DEFAULT_PROP_SATURATION		1.0
+#define DEFAULT_PROP_N_THREADS		1
 
 enum
 {
@@ -64,7 +65,8 @@ enum
   PROP_CONTRAST,
   PROP_BRIGHTNESS,
   PROP_HUE,
-  PROP_SATURATION
+  PROP_SATURATION,
+  PROP_N_THREADS
 };
 
 #define PROCESSING_CAPS \
@@ -162,8 +164,10 @@ gst_video_balance_update_properties (GstVideoBalance * videobalance)
 
   GST_OBJECT_LOCK (videobalance);
   passthrough = gst_video_balance_is_passthrough (videobalance);
+  /* the tables are only updated from the streaming thread as the slices of
+   * a frame read them without locking */
   if (!passthrough)
-    gst_video_balance_update_tables (videobalance);
+    videobalance->tables_dirty = TRUE;
   GST_OBJECT_UNLOCK (videobalance);
 
   gst_base_transform_set_passthrough (base, passthrough);
@@ -486,6 +490,13 @@ gst_video_balance_before_transform (GstBaseTransform * base, GstBuffer * buf)
 
   if (GST_CLOCK_TIME_IS_VALID (stream_time))
     gst_object_sync_values (GST_OBJECT (balance), stream_time);
+
+  GST_OBJECT_LOCK (balance);
+  if (balance->tables_dirty) {
+    gst_video_balance_update_tables (balance);
+    balance->tables_dirty = FALSE;
+  }
+  GST_OBJECT_UNLOCK (balance);
 }
 
 static GstCaps *
@@ -519,17 +530,17 @@ gst_video_balance_transform_caps (GstBaseTransform * trans,
 }
 
 static GstFlowReturn
-gst_video_balance_transform_frame_ip (GstVideoFilter * vfilter,
-    GstVideoFrame * frame)
+gst_video_balance_transform_frame_ip_slice (GstVideoFilter * vfilter,
+    GstVideoFrame * frame, guint start_line, guint end_line)
 {
   GstVideoBalance *videobalance = GST_VIDEO_BALANCE (vfilter);
+  GstVideoFrame slice;
 
   if (!videobalance->process)
     goto not_negotiated;
 
-  GST_OBJECT_LOCK (videobalance);
-  videobalance->process (videobalance, frame);
-  GST_OBJECT_UNLOCK (videobalance);
+  gst_video_filter_get_frame_slice (frame, &slice, start_line, end_line);
+  videobalance->process (videobalance, &slice);
 
   return GST_FLOW_OK;
 
@@ -595,6 +606,20 @@ gst_video_balance_class_init (GstVideoBalanceClass * klass)
           DEFAULT_PROP_SATURATION,
           GST_PARAM_CONTROLLABLE | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoBalance:n-threads:
+   *
+   * Maximum number of threads used to process each frame. 0 uses the number
+   * of CPUs.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use (0 = number of CPUs)", 0,
+          G_MAXUINT, DEFAULT_PROP_N_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class, "Video balance",
       "Filter/Effect/Video",
       "Adjusts brightness, contrast, hue, saturation on a video stream",
@@ -612,8 +637,8 @@ gst_video_balance_class_init (GstVideoBalanceClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_balance_transform_caps);
 
   vfilter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_balance_set_info);
-  vfilter_class->transform_frame_ip =
-      GST_DEBUG_FUNCPTR (gst_video_balance_transform_frame_ip);
+  vfilter_class->transform_frame_ip_slice =
+      GST_DEBUG_FUNCPTR (gst_video_balance_transform_frame_ip_slice);
 }
 
 static void
@@ -629,6 +654,7 @@ gst_video_balance_init (GstVideoBalance * videobalance)
   videobalance->brightness = DEFAULT_PROP_BRIGHTNESS;
   videobalance->hue = DEFAULT_PROP_HUE;
   videobalance->saturation = DEFAULT_PROP_SATURATION;
+  videobalance->tables_dirty = TRUE;
 
   videobalance->tableu[0] = g_new (guint8, 256 * 256 * 2);
   for (i = 0; i < 256; i++) {
@@ -768,6 +794,13 @@ gst_video_balance_set_property (GObject * object, guint prop_id,
   gdouble d;
   const gchar *label = NULL;
 
+  /* takes the object lock itself and doesn't affect the tables */
+  if (prop_id == PROP_N_THREADS) {
+    gst_video_filter_set_n_threads (GST_VIDEO_FILTER (balance),
+        g_value_get_uint (value));
+    return;
+  }
+
   GST_OBJECT_LOCK (balance);
   switch (prop_id) {
     case PROP_CONTRAST:
@@ -837,6 +870,10 @@ gst_video_balance_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_SATURATION:
       g_value_set_double (value, balance->saturation);
       break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value,
+          gst_video_filter_get_n_threads (GST_VIDEO_FILTER (balance)));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -60,7 +60,8 @@ struct _GstVideoBalance {
   gdouble hue;
   gdouble saturation;
 
-  /* tables */
+  /* tables, only written from the streaming thread */
+  gboolean tables_dirty;
   guint8 tabley[256];
   guint8 *tableu[256];
   guint8 *tablev[256];
@@ -19,6 +19,7 @@
  */
 
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 #include <gst/video/video.h>
 
 
@@ -255,6 +256,72 @@ GST_START_TEST (test_alpha)
 
 GST_END_TEST;
 
+static GstBuffer *
+alpha_run (const gchar * format, const gchar * method, guint n_threads)
+{
+  GstHarness *h;
+  GstVideoInfo info;
+  GstBuffer *buf;
+  GstMapInfo map;
+  GstCaps *caps;
+  gsize i;
+
+  h = gst_harness_new ("alpha");
+  gst_util_set_object_arg (G_OBJECT (h->element), "method", method);
+  g_object_set (h->element, "alpha", 0.75, "n-threads", n_threads, NULL);
+
+  caps = gst_caps_new_simple ("video/x-raw", "format", G_TYPE_STRING, format,
+      "width", G_TYPE_INT, 64, "height", G_TYPE_INT, 999,
+      "framerate", GST_TYPE_FRACTION, 25, 1, NULL);
+  fail_unless (gst_video_info_from_caps (&info, caps));
+  gst_harness_set_src_caps (h, caps);
+  gst_harness_set_sink_caps_str (h, "video/x-raw, format=(string)AYUV");
+
+  buf = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&info));
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = (i * 11) ^ (i >> 6);
+  gst_buffer_unmap (buf, &map);
+
+  buf = gst_harness_push_and_pull (h, buf);
+  fail_unless (buf != NULL);
+
+  gst_harness_teardown (h);
+
+  return buf;
+}
+
+GST_START_TEST (test_n_threads)
+{
+  const gchar *formats[] = { "I420", "Y41B", "YUY2", "AYUV", "RGB" };
+  const gchar *methods[] = { "set", "green" };
+  gint i, j;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    for (j = 0; j < G_N_ELEMENTS (methods); j++) {
+      GstBuffer *single, *threaded;
+      GstMapInfo map1, map2;
+
+      GST_INFO ("checking format %s, method %s", formats[i], methods[j]);
+
+      single = alpha_run (formats[i], methods[j], 1);
+      threaded = alpha_run (formats[i], methods[j], 4);
+
+      gst_buffer_map (single, &map1, GST_MAP_READ);
+      gst_buffer_map (threaded, &map2, GST_MAP_READ);
+      fail_unless_equals_int (map1.size, map2.size);
+      fail_unless (memcmp (map1.data, map2.data, map1.size) == 0);
+      gst_buffer_unmap (threaded, &map2);
+      gst_buffer_unmap (single, &map1);
+
+      gst_buffer_unref (single);
+      gst_buffer_unref (threaded);
+    }
+  }
+}
+
+GST_END_TEST;
+
 
 static Suite *
 alpha_suite (void)
@@ -265,6 +332,7 @@ alpha_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_alpha);
   tcase_add_test (tc_chain, test_chromakeying);
+  tcase_add_test (tc_chain, test_n_threads);
 
   return s;
 }
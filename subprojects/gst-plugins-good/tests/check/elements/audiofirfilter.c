@@ -22,8 +22,12 @@
  * with newer GLib versions (>= 2.31.0) */
 #define GLIB_DISABLE_DEPRECATION_WARNINGS
 
+#include <math.h>
+
 #include <gst/gst.h>
+#include <gst/audio/audio.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 
 static gboolean have_eos = FALSE;
 
@@ -178,6 +182,81 @@ GST_START_TEST (test_pipeline)
 
 GST_END_TEST;
 
+/* A kernel that only delays by 40 samples, compensated by the latency
+ * property, has to reproduce the input exactly in all FFT modes */
+#define DELAY_KERNEL_LENGTH 64
+#define DELAY_KERNEL_DELAY 40
+#define DELAY_N_SAMPLES 1000
+
+static void
+check_delay_kernel (guint partition_length)
+{
+  GstHarness *h;
+  GValueArray *va;
+  GValue v = { 0, };
+  GstBuffer *buffer;
+  GstMapInfo map;
+  gdouble *data;
+  guint i, n = 0;
+
+  h = gst_harness_new ("audiofirfilter");
+  g_object_set (h->element, "partition-length", partition_length,
+      "latency", (guint64) DELAY_KERNEL_DELAY, NULL);
+
+  va = g_value_array_new (DELAY_KERNEL_LENGTH);
+  g_value_init (&v, G_TYPE_DOUBLE);
+  for (i = 0; i < DELAY_KERNEL_LENGTH; i++) {
+    g_value_set_double (&v, i == DELAY_KERNEL_DELAY ? 1.0 : 0.0);
+    g_value_array_append (va, &v);
+  }
+  g_value_unset (&v);
+  g_object_set (h->element, "kernel", va, NULL);
+  g_value_array_free (va);
+
+  gst_harness_set_src_caps_str (h, "audio/x-raw, format=(string)"
+      GST_AUDIO_NE (F64) ", rate=(int)48000, channels=(int)1, "
+      "layout=(string)interleaved");
+
+  buffer = gst_harness_create_buffer (h, DELAY_N_SAMPLES * sizeof (gdouble));
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  data = (gdouble *) map.data;
+  for (i = 0; i < DELAY_N_SAMPLES; i++)
+    data[i] = sin (i * 0.1);
+  gst_buffer_unmap (buffer, &map);
+  GST_BUFFER_PTS (buffer) = 0;
+  GST_BUFFER_DURATION (buffer) =
+      gst_util_uint64_scale_int (DELAY_N_SAMPLES, GST_SECOND, 48000);
+
+  fail_unless_equals_int (gst_harness_push (h, buffer), GST_FLOW_OK);
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  while ((buffer = gst_harness_try_pull (h))) {
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    data = (gdouble *) map.data;
+    for (i = 0; i < map.size / sizeof (gdouble) && n < DELAY_N_SAMPLES;
+        i++, n++)
+      fail_unless (fabs (data[i] - sin (n * 0.1)) < 1e-9,
+          "partition length %u: sample %u is %f, expected %f",
+          partition_length, n, data[i], sin (n * 0.1));
+    gst_buffer_unmap (buffer, &map);
+    gst_buffer_unref (buffer);
+  }
+  fail_unless_equals_int (n, DELAY_N_SAMPLES);
+
+  gst_harness_teardown (h);
+}
+
+GST_START_TEST (test_partitioned)
+{
+  /* unpartitioned, power of two and non power of two partitions */
+  check_delay_kernel (0);
+  check_delay_kernel (16);
+  check_delay_kernel (20);
+  check_delay_kernel (100);
+}
+
+GST_END_TEST;
+
 static Suite *
 audiofirfilter_suite (void)
 {
@@ -186,6 +265,7 @@ audiofirfilter_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_pipeline);
+  tcase_add_test (tc_chain, test_partitioned);
 
   return s;
 }
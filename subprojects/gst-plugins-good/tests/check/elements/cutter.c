@@ -0,0 +1,173 @@
+/* GStreamer unit tests for cutter
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+#include <gst/audio/audio.h>
+
+#define CAPS "audio/x-raw, format=" GST_AUDIO_NE (S16) ", rate=(int)8000, " \
+    "channels=(int)1, layout=interleaved"
+/* 50ms */
+#define SAMPLES_PER_BUFFER 400
+#define N_BUFFERS 8
+
+/* Buffers 2 to 6 are silent, either zeros or GAP buffers with loud samples
+ * in them, the others are loud */
+static gboolean
+is_silent (guint i)
+{
+  return i >= 2 && i < 7;
+}
+
+/* Returns the PTS and flags of the output buffers and the cutter messages */
+static GList *
+run_cutter (gboolean gap, GArray * out_pts, GArray * out_gap)
+{
+  GstHarness *h;
+  GstBus *bus;
+  GstBuffer *buf;
+  GstMessage *msg;
+  GList *messages = NULL;
+  guint i, j;
+
+  h = gst_harness_new ("cutter");
+  g_object_set (h->element, "run-length", 100 * GST_MSECOND, NULL);
+  bus = gst_bus_new ();
+  gst_element_set_bus (h->element, bus);
+  gst_harness_set_src_caps_str (h, CAPS);
+
+  for (i = 0; i < N_BUFFERS; i++) {
+    GstMapInfo map;
+    gint16 *samples;
+
+    buf = gst_buffer_new_allocate (NULL, SAMPLES_PER_BUFFER * 2, NULL);
+    fail_unless (gst_buffer_map (buf, &map, GST_MAP_WRITE));
+    samples = (gint16 *) map.data;
+    /* the samples of GAP buffers are not looked at */
+    for (j = 0; j < SAMPLES_PER_BUFFER; j++)
+      samples[j] = (is_silent (i) && !gap) ? 0 : (j % 2 ? 16000 : -16000);
+    gst_buffer_unmap (buf, &map);
+
+    if (is_silent (i) && gap)
+      GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_GAP);
+    GST_BUFFER_PTS (buf) = i * 50 * GST_MSECOND;
+    GST_BUFFER_DURATION (buf) = 50 * GST_MSECOND;
+
+    fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  }
+
+  while ((buf = gst_harness_try_pull (h))) {
+    gboolean is_gap = GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_GAP);
+
+    g_array_append_val (out_pts, GST_BUFFER_PTS (buf));
+    g_array_append_val (out_gap, is_gap);
+    gst_buffer_unref (buf);
+  }
+
+  while ((msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT)))
+    messages = g_list_append (messages, msg);
+
+  gst_element_set_bus (h->element, NULL);
+  gst_object_unref (bus);
+  gst_harness_teardown (h);
+
+  return messages;
+}
+
+static void
+check_message (GstMessage * msg, gboolean above, GstClockTime timestamp)
+{
+  const GstStructure *s = gst_message_get_structure (msg);
+  gboolean msg_above;
+  GstClockTime msg_timestamp;
+
+  fail_unless (gst_structure_has_name (s, "cutter"));
+  fail_unless (gst_structure_get_boolean (s, "above", &msg_above));
+  fail_unless (gst_structure_get_clock_time (s, "timestamp", &msg_timestamp));
+  fail_unless_equals_int (msg_above, above);
+  fail_unless_equals_uint64 (msg_timestamp, timestamp);
+}
+
+/* Above at the first buffer, below once the silence lasted longer than the
+ * run length, i.e. at the third silent buffer, and above again at the next
+ * loud buffer */
+static void
+check_messages (GList * messages)
+{
+  fail_unless_equals_int (g_list_length (messages), 3);
+  check_message (g_list_nth_data (messages, 0), TRUE, 0);
+  check_message (g_list_nth_data (messages, 1), FALSE, 200 * GST_MSECOND);
+  check_message (g_list_nth_data (messages, 2), TRUE, 350 * GST_MSECOND);
+}
+
+/* GAP buffers count as silence whatever their content, exactly like buffers
+ * of zeros, and are passed on as GAP buffers */
+GST_START_TEST (test_gap_is_silence)
+{
+  GArray *zero_pts, *zero_gap, *gap_pts, *gap_gap;
+  GList *zero_msgs, *gap_msgs;
+  guint i;
+
+  zero_pts = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+  zero_gap = g_array_new (FALSE, FALSE, sizeof (gboolean));
+  gap_pts = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+  gap_gap = g_array_new (FALSE, FALSE, sizeof (gboolean));
+
+  zero_msgs = run_cutter (FALSE, zero_pts, zero_gap);
+  gap_msgs = run_cutter (TRUE, gap_pts, gap_gap);
+
+  check_messages (zero_msgs);
+  check_messages (gap_msgs);
+
+  /* nothing is leaked, the silent buffers held back in the pre-recording
+   * buffer come out in order before the next loud one */
+  fail_unless_equals_int (zero_pts->len, N_BUFFERS);
+  fail_unless_equals_int (gap_pts->len, N_BUFFERS);
+  for (i = 0; i < N_BUFFERS; i++) {
+    fail_unless_equals_uint64 (g_array_index (zero_pts, GstClockTime, i),
+        i * 50 * GST_MSECOND);
+    fail_unless_equals_uint64 (g_array_index (gap_pts, GstClockTime, i),
+        i * 50 * GST_MSECOND);
+    fail_if (g_array_index (zero_gap, gboolean, i));
+    fail_unless_equals_int (g_array_index (gap_gap, gboolean, i),
+        is_silent (i));
+  }
+
+  g_list_free_full (zero_msgs, (GDestroyNotify) gst_message_unref);
+  g_list_free_full (gap_msgs, (GDestroyNotify) gst_message_unref);
+  g_array_free (zero_pts, TRUE);
+  g_array_free (zero_gap, TRUE);
+  g_array_free (gap_pts, TRUE);
+  g_array_free (gap_gap, TRUE);
+}
+
+GST_END_TEST;
+
+static Suite *
+cutter_suite (void)
+{
+  Suite *s = suite_create ("cutter");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_gap_is_silence);
+
+  return s;
+}
+
+GST_CHECK_MAIN (cutter);
@@ -23,6 +23,7 @@
 
 #include <stdio.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 #include <gst/video/video.h>
 
 static gboolean
@@ -1018,6 +1019,90 @@ GST_END_TEST;
 
 
 
+static GList *
+deinterlace_run_yadif (const gchar * format, guint n_threads)
+{
+  GstHarness *h;
+  GstVideoInfo info;
+  GList *outputs = NULL;
+  GstBuffer *buf;
+  GstCaps *caps;
+  gint i;
+
+  h = gst_harness_new ("deinterlace");
+  gst_util_set_object_arg (G_OBJECT (h->element), "method", "yadif");
+  g_object_set (h->element, "n-threads", n_threads, NULL);
+
+  caps = gst_caps_new_simple ("video/x-raw", "format", G_TYPE_STRING, format,
+      "width", G_TYPE_INT, 320, "height", G_TYPE_INT, 240,
+      "framerate", GST_TYPE_FRACTION, 25, 1,
+      "interlace-mode", G_TYPE_STRING, "interleaved", NULL);
+  fail_unless (gst_video_info_from_caps (&info, caps));
+  gst_harness_set_src_caps (h, caps);
+
+  for (i = 0; i < 5; i++) {
+    GstMapInfo map;
+    gsize j;
+
+    buf = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&info));
+    gst_buffer_map (buf, &map, GST_MAP_WRITE);
+    /* keep the high byte of 16 bit samples within the 10 bit range */
+    for (j = 0; j < map.size; j++)
+      map.data[j] = ((j * 7 + i * 13) ^ (j >> 9)) & ((j & 1) ? 0x03 : 0xff);
+    gst_buffer_unmap (buf, &map);
+
+    GST_BUFFER_PTS (buf) = i * 40 * GST_MSECOND;
+    GST_BUFFER_DURATION (buf) = 40 * GST_MSECOND;
+    fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  }
+
+  gst_harness_push_event (h, gst_event_new_eos ());
+  while ((buf = gst_harness_try_pull (h)))
+    outputs = g_list_append (outputs, buf);
+
+  gst_harness_teardown (h);
+
+  return outputs;
+}
+
+GST_START_TEST (test_yadif_n_threads)
+{
+  const gchar *formats[] = { "I420", "NV12", "Y42B", "Y444", "AYUV",
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+    "P010_10LE", "I420_10LE", "I422_10LE", "Y444_10LE",
+#endif
+  };
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    GList *single, *threaded, *l1, *l2;
+
+    GST_INFO ("checking format %s", formats[i]);
+
+    single = deinterlace_run_yadif (formats[i], 1);
+    threaded = deinterlace_run_yadif (formats[i], 4);
+
+    fail_unless (single != NULL);
+    fail_unless_equals_int (g_list_length (single), g_list_length (threaded));
+
+    for (l1 = single, l2 = threaded; l1; l1 = l1->next, l2 = l2->next) {
+      GstMapInfo map1, map2;
+
+      gst_buffer_map (l1->data, &map1, GST_MAP_READ);
+      gst_buffer_map (l2->data, &map2, GST_MAP_READ);
+      fail_unless_equals_int (map1.size, map2.size);
+      fail_unless (memcmp (map1.data, map2.data, map1.size) == 0);
+      gst_buffer_unmap (l2->data, &map2);
+      gst_buffer_unmap (l1->data, &map1);
+    }
+
+    g_list_free_full (single, (GDestroyNotify) gst_buffer_unref);
+    g_list_free_full (threaded, (GDestroyNotify) gst_buffer_unref);
+  }
+}
+
+GST_END_TEST;
+
 static Suite *
 deinterlace_suite (void)
 {
@@ -1045,6 +1130,7 @@ deinterlace_suite (void)
   tcase_add_test (tc_chain, test_mode_auto_expected_caps);
   tcase_add_test (tc_chain, test_mode_auto_strict_expected_caps);
   tcase_add_test (tc_chain, test_fields_auto_expected_caps);
+  tcase_add_test (tc_chain, test_yadif_n_threads);
 
   return s;
 }
@@ -24,6 +24,7 @@
 #include <gst/audio/audio.h>
 #include <gst/base/gstbasetransform.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 
 #include <math.h>
 
@@ -310,6 +311,113 @@ GST_START_TEST (test_equalizer_band_number_changing)
 
 GST_END_TEST;
 
+#define MULTICHANNEL_CHANNELS 11
+#define MULTICHANNEL_FRAMES 1000
+
+static gfloat *
+run_equalizer_multichannel (gboolean single_precision, const gfloat * in,
+    gint channels)
+{
+  GstHarness *h;
+  GstElement *equalizer;
+  GstBuffer *buf;
+  GstMapInfo map;
+  gfloat *res;
+  gchar *caps;
+
+  h = gst_harness_new ("equalizer-10bands");
+  equalizer = gst_harness_find_element (h, "equalizer-10bands");
+  g_object_set (equalizer, "single-precision", single_precision,
+      "band0", 12.0, "band3", -12.0, "band6", 6.0, "band9", -6.0, NULL);
+  gst_object_unref (equalizer);
+
+  caps = g_strdup_printf ("audio/x-raw, "
+      "format = (string) " GST_AUDIO_NE (F32) ", "
+      "layout = (string) interleaved, "
+      "channels = (int) %d, rate = (int) 48000", channels);
+  gst_harness_set_src_caps_str (h, caps);
+  g_free (caps);
+
+  buf = gst_buffer_new_allocate (NULL,
+      channels * MULTICHANNEL_FRAMES * sizeof (gfloat), NULL);
+  gst_buffer_fill (buf, 0, in,
+      channels * MULTICHANNEL_FRAMES * sizeof (gfloat));
+  buf = gst_harness_push_and_pull (h, buf);
+  fail_unless (buf != NULL);
+
+  gst_buffer_map (buf, &map, GST_MAP_READ);
+  fail_unless_equals_int (map.size,
+      channels * MULTICHANNEL_FRAMES * sizeof (gfloat));
+  res = g_memdup2 (map.data, map.size);
+  gst_buffer_unmap (buf, &map);
+  gst_buffer_unref (buf);
+  gst_harness_teardown (h);
+
+  return res;
+}
+
+/* Channels are filtered in parallel in blocks, so use a channel count that
+ * is not a multiple of the block size. Each channel gets its own input and
+ * has to give the same output as when it is filtered alone, so that a
+ * channel mixed up with another one or with the history of another one is
+ * caught */
+GST_START_TEST (test_equalizer_multichannel)
+{
+  gfloat *in, *mono_in, *res_double, *res_single;
+  gint i, c;
+
+  in = g_new (gfloat, MULTICHANNEL_CHANNELS * MULTICHANNEL_FRAMES);
+  for (c = 0; c < MULTICHANNEL_CHANNELS; c++) {
+    /* a different level and frequency content per channel */
+    gdouble amplitude = 0.05 * (c + 1);
+    gdouble freq = 100.0 * (c + 1);
+
+    for (i = 0; i < MULTICHANNEL_FRAMES; i++)
+      in[i * MULTICHANNEL_CHANNELS + c] =
+          amplitude * (sin (2.0 * G_PI * freq * i / 48000.0) +
+          g_random_double_range (-0.5, 0.5));
+  }
+
+  res_double = run_equalizer_multichannel (FALSE, in, MULTICHANNEL_CHANNELS);
+  res_single = run_equalizer_multichannel (TRUE, in, MULTICHANNEL_CHANNELS);
+
+  for (i = 0; i < MULTICHANNEL_CHANNELS * MULTICHANNEL_FRAMES; i++)
+    fail_unless (fabs (res_double[i] - res_single[i]) < 1e-3,
+        "sample %d: %f != %f", i, res_double[i], res_single[i]);
+
+  mono_in = g_new (gfloat, MULTICHANNEL_FRAMES);
+  for (c = 0; c < MULTICHANNEL_CHANNELS; c++) {
+    gfloat *mono_double, *mono_single;
+
+    for (i = 0; i < MULTICHANNEL_FRAMES; i++)
+      mono_in[i] = in[i * MULTICHANNEL_CHANNELS + c];
+
+    mono_double = run_equalizer_multichannel (FALSE, mono_in, 1);
+    mono_single = run_equalizer_multichannel (TRUE, mono_in, 1);
+
+    for (i = 0; i < MULTICHANNEL_FRAMES; i++) {
+      gint idx = i * MULTICHANNEL_CHANNELS + c;
+
+      fail_unless (fabs (res_double[idx] - mono_double[i]) < 1e-5,
+          "channel %d, frame %d: %f != %f", c, i, res_double[idx],
+          mono_double[i]);
+      fail_unless (fabs (res_single[idx] - mono_single[i]) < 1e-5,
+          "channel %d, frame %d: %f != %f", c, i, res_single[idx],
+          mono_single[i]);
+    }
+
+    g_free (mono_double);
+    g_free (mono_single);
+  }
+
+  g_free (mono_in);
+  g_free (in);
+  g_free (res_double);
+  g_free (res_single);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_equalizer_presets)
 {
   GstElement *eq1, *eq2;
@@ -372,6 +480,7 @@ equalizer_suite (void)
   tcase_add_test (tc_chain, test_equalizer_5bands_minus_24);
   tcase_add_test (tc_chain, test_equalizer_5bands_plus_12);
   tcase_add_test (tc_chain, test_equalizer_band_number_changing);
+  tcase_add_test (tc_chain, test_equalizer_multichannel);
   tcase_add_test (tc_chain, test_equalizer_presets);
 
   return s;
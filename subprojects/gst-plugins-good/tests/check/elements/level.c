@@ -27,6 +27,8 @@
 #include <gst/audio/audio.h>
 #include <gst/check/gstcheck.h>
 
+#include <math.h>
+
 /* For ease of programming we use globals to keep refs for our floating
  * src and sink pads we create; otherwise we always have to do get_pad,
  * get_peer, and then remove references in every test function */
@@ -56,6 +58,14 @@ static GstPad *mysrcpad, *mysinkpad;
     "channels = (int) 2, "  \
     "channel-mask = (bitmask) 3"
 
+#define LEVEL_F32_48K_CAPS_STRING \
+  "audio/x-raw, " \
+    "format = (string) "GST_AUDIO_NE(F32)", " \
+    "layout = (string) interleaved, " \
+    "rate = (int) 48000, " \
+    "channels = (int) 2, "  \
+    "channel-mask = (bitmask) 3"
+
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -140,6 +150,44 @@ create_f32_buffer (gfloat val_l, gfloat val_r)
   return buf;
 }
 
+/* create a 0.1 sec 48kHz stereo buffer with a 1kHz sine of the given peak
+ * amplitudes */
+static GstBuffer *
+create_f32_sine_buffer (gint index, gdouble amp_l, gdouble amp_r)
+{
+  GstBuffer *buf = gst_buffer_new_and_alloc (2 * 4800 * sizeof (gfloat));
+  GstMapInfo map;
+  gint j;
+  gfloat *data;
+
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  data = (gfloat *) map.data;
+  for (j = 0; j < 4800; ++j) {
+    gdouble v = sin (2.0 * G_PI * 1000.0 * (index * 4800 + j) / 48000.0);
+
+    *(data++) = amp_l * v;
+    *(data++) = amp_r * v;
+  }
+  gst_buffer_unmap (buf, &map);
+  GST_BUFFER_TIMESTAMP (buf) = index * GST_SECOND / 10;
+  GST_BUFFER_DURATION (buf) = GST_SECOND / 10;
+  return buf;
+}
+
+static gdouble
+get_array_double (const GstStructure * s, const gchar * field, guint index)
+{
+  const GValue *list;
+  GValueArray *arr;
+
+  list = gst_structure_get_value (s, field);
+  fail_unless (list != NULL);
+  arr = g_value_get_boxed (list);
+  fail_unless (index < arr->n_values);
+
+  return g_value_get_double (g_value_array_get_nth (arr, index));
+}
+
 /* tests */
 
 GST_START_TEST (test_ref_counts)
@@ -635,6 +683,127 @@ GST_START_TEST (test_rtp_audio_level_meta)
 
 GST_END_TEST;
 
+/* the levels are not measured in the loudness modes, but the audio level
+ * meta still is */
+GST_START_TEST (test_loudness_audio_level_meta)
+{
+  GstElement *level;
+  GstBuffer *inbuffer, *outbuffer;
+  GstAudioLevelMeta *meta;
+
+  level = setup_level (LEVEL_S16_CAPS_STRING);
+  g_object_set (level, "post-messages", FALSE, "audio-level-meta", TRUE, NULL);
+  gst_util_set_object_arg (G_OBJECT (level), "mode", "loudness");
+  gst_element_set_state (level, GST_STATE_PLAYING);
+
+  inbuffer = create_s16_buffer (16536, 16536);
+
+  fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  fail_if ((outbuffer = (GstBuffer *) buffers->data) == NULL);
+
+  meta = gst_buffer_get_audio_level_meta (outbuffer);
+  fail_unless (meta);
+  fail_unless_equals_int (meta->level, 5);
+
+  gst_element_set_state (level, GST_STATE_NULL);
+  cleanup_level (level);
+}
+
+GST_END_TEST;
+
+/* EBU Tech 3341 case 1: a stereo 1kHz sine at -23 dBFS has a loudness of
+ * -23 LUFS */
+GST_START_TEST (test_loudness)
+{
+  GstElement *level;
+  GstBus *bus;
+  GstMessage *message, *last = NULL;
+  const GstStructure *structure;
+  gdouble amp = pow (10, -23.0 / 20.0);
+  gint i;
+
+  level = setup_level (LEVEL_F32_48K_CAPS_STRING);
+  g_object_set (level, "post-messages", TRUE,
+      "interval", (guint64) GST_SECOND, NULL);
+  gst_util_set_object_arg (G_OBJECT (level), "mode", "loudness");
+  gst_element_set_state (level, GST_STATE_PLAYING);
+  bus = gst_bus_new ();
+  gst_element_set_bus (level, bus);
+
+  for (i = 0; i < 50; i++)
+    fail_unless (gst_pad_push (mysrcpad,
+            create_f32_sine_buffer (i, amp, amp)) == GST_FLOW_OK);
+
+  while ((message = gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT))) {
+    gst_clear_message (&last);
+    last = message;
+  }
+  fail_unless (last != NULL);
+
+  structure = gst_message_get_structure (last);
+  fail_unless_equals_string (gst_structure_get_name (structure), "loudness");
+  fail_unless (fabs (get_array_double (structure, "momentary", 0) + 23) < 0.1);
+  fail_unless (fabs (get_array_double (structure, "short-term", 0) + 23) < 0.1);
+  fail_unless (fabs (get_array_double (structure, "integrated", 0) + 23) < 0.1);
+  fail_unless (fabs (get_array_double (structure, "true-peak", 0) + 23) < 0.2);
+  fail_unless (fabs (get_array_double (structure, "true-peak", 1) + 23) < 0.2);
+  gst_message_unref (last);
+
+  gst_element_set_bus (level, NULL);
+  gst_object_unref (bus);
+  gst_element_set_state (level, GST_STATE_NULL);
+  cleanup_level (level);
+}
+
+GST_END_TEST;
+
+/* each channel is measured as a mono programme, so a -23 dBFS sine is
+ * 3 LU lower than in stereo */
+GST_START_TEST (test_channel_loudness)
+{
+  GstElement *level;
+  GstBus *bus;
+  GstMessage *message, *last = NULL;
+  const GstStructure *structure;
+  gdouble amp = pow (10, -23.0 / 20.0);
+  gint i;
+
+  level = setup_level (LEVEL_F32_48K_CAPS_STRING);
+  g_object_set (level, "post-messages", TRUE,
+      "interval", (guint64) GST_SECOND, NULL);
+  gst_util_set_object_arg (G_OBJECT (level), "mode", "channel-loudness");
+  gst_element_set_state (level, GST_STATE_PLAYING);
+  bus = gst_bus_new ();
+  gst_element_set_bus (level, bus);
+
+  for (i = 0; i < 50; i++)
+    fail_unless (gst_pad_push (mysrcpad,
+            create_f32_sine_buffer (i, amp, 0.0)) == GST_FLOW_OK);
+
+  while ((message = gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT))) {
+    gst_clear_message (&last);
+    last = message;
+  }
+  fail_unless (last != NULL);
+
+  structure = gst_message_get_structure (last);
+  fail_unless_equals_string (gst_structure_get_name (structure), "loudness");
+  fail_unless (fabs (get_array_double (structure, "integrated", 0) + 26.01) <
+      0.1);
+  fail_unless (get_array_double (structure, "integrated", 1) < -70);
+  fail_unless (fabs (get_array_double (structure, "true-peak", 0) + 23) < 0.2);
+  fail_unless (get_array_double (structure, "true-peak", 1) < -100);
+  gst_message_unref (last);
+
+  gst_element_set_bus (level, NULL);
+  gst_object_unref (bus);
+  gst_element_set_state (level, GST_STATE_NULL);
+  cleanup_level (level);
+}
+
+GST_END_TEST;
+
 static Suite *
 level_suite (void)
 {
@@ -651,6 +820,9 @@ level_suite (void)
   tcase_add_test (tc_chain, test_message_count);
   tcase_add_test (tc_chain, test_message_timestamps);
   tcase_add_test (tc_chain, test_rtp_audio_level_meta);
+  tcase_add_test (tc_chain, test_loudness);
+  tcase_add_test (tc_chain, test_channel_loudness);
+  tcase_add_test (tc_chain, test_loudness_audio_level_meta);
 
   return s;
 }
@@ -0,0 +1,365 @@
+/* GStreamer
+ *
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/rtp/gstrtpbuffer.h>
+
+#include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+
+#define TEST_SSRC 0x01BADBAD
+#define TEST_PT 33
+
+typedef struct
+{
+  GstBuffer *buffer;
+  gboolean repair;
+} Packet;
+
+static GstBuffer *
+make_media_packet (guint16 seq, guint size)
+{
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstBuffer *buffer;
+  guint8 *payload;
+  guint i;
+
+  buffer = gst_rtp_buffer_new_allocate (size, 0, 0);
+
+  gst_rtp_buffer_map (buffer, GST_MAP_WRITE, &rtp);
+  gst_rtp_buffer_set_payload_type (&rtp, TEST_PT);
+  gst_rtp_buffer_set_seq (&rtp, seq);
+  gst_rtp_buffer_set_timestamp (&rtp, seq * 3000);
+  gst_rtp_buffer_set_ssrc (&rtp, TEST_SSRC);
+  gst_rtp_buffer_set_marker (&rtp, seq % 5 == 0);
+  payload = gst_rtp_buffer_get_payload (&rtp);
+  for (i = 0; i < size; i++)
+    payload[i] = seq * 7 + i;
+  gst_rtp_buffer_unmap (&rtp);
+
+  return buffer;
+}
+
+/* Variable sizes so that the length recovery is exercised */
+#define PACKET_SIZE(seq) (50 + ((seq) * 37) % 200)
+
+static GArray *
+encode (GstElement * enc, guint n_packets)
+{
+  GstHarness *h, *h_fec;
+  GArray *packets = g_array_new (FALSE, FALSE, sizeof (Packet));
+  guint i;
+
+  h = gst_harness_new_with_element (enc, "sink", "src");
+  h_fec = gst_harness_new_with_element (h->element, NULL, "fec_0");
+  gst_harness_set_src_caps_str (h, "application/x-rtp, clock-rate=90000");
+
+  for (i = 0; i < n_packets; i++) {
+    Packet packet;
+
+    fail_unless_equals_int (gst_harness_push (h, make_media_packet (i,
+                PACKET_SIZE (i))), GST_FLOW_OK);
+
+    packet.buffer = gst_harness_pull (h);
+    packet.repair = FALSE;
+    g_array_append_val (packets, packet);
+
+    while (gst_harness_buffers_in_queue (h_fec) > 0) {
+      packet.buffer = gst_harness_pull (h_fec);
+      packet.repair = TRUE;
+      g_array_append_val (packets, packet);
+    }
+  }
+
+  gst_harness_teardown (h);
+  gst_harness_teardown (h_fec);
+
+  return packets;
+}
+
+static void
+free_packets (GArray * packets)
+{
+  guint i;
+
+  for (i = 0; i < packets->len; i++)
+    gst_buffer_unref (g_array_index (packets, Packet, i).buffer);
+  g_array_free (packets, TRUE);
+}
+
+static gboolean
+is_dropped (guint16 seq, const guint16 * dropped, guint n_dropped)
+{
+  guint i;
+
+  for (i = 0; i < n_dropped; i++) {
+    if (dropped[i] == seq)
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* Pushes @packets minus @dropped through a decoder and checks that
+ * @n_expected packets, identical to the original ones, come out */
+static void
+decode_and_check (GArray * packets, const guint16 * dropped, guint n_dropped,
+    guint n_expected, guint n_recovered)
+{
+  GstHarness *h, *h_media, *h_fec;
+  GstBuffer *received[256] = { NULL, };
+  guint i, n_received = 0, recovered;
+
+  h = gst_harness_new_with_padnames ("rtpflexfecdec", NULL, "src");
+  h_media = gst_harness_new_with_element (h->element, "sink", NULL);
+  h_fec = gst_harness_new_with_element (h->element, "fec_0", NULL);
+  gst_harness_set_src_caps_str (h_media, "application/x-rtp");
+  gst_harness_set_src_caps_str (h_fec, "application/x-rtp");
+
+  for (i = 0; i < packets->len; i++) {
+    Packet *packet = &g_array_index (packets, Packet, i);
+    GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+    guint16 seq;
+
+    if (packet->repair) {
+      gst_harness_push (h_fec, gst_buffer_ref (packet->buffer));
+      continue;
+    }
+
+    gst_rtp_buffer_map (packet->buffer, GST_MAP_READ, &rtp);
+    seq = gst_rtp_buffer_get_seq (&rtp);
+    gst_rtp_buffer_unmap (&rtp);
+
+    if (!is_dropped (seq, dropped, n_dropped))
+      gst_harness_push (h_media, gst_buffer_ref (packet->buffer));
+  }
+
+  while (gst_harness_buffers_in_queue (h) > 0) {
+    GstBuffer *buffer = gst_harness_pull (h);
+    GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+    guint16 seq;
+
+    fail_unless (gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp));
+    seq = gst_rtp_buffer_get_seq (&rtp);
+    gst_rtp_buffer_unmap (&rtp);
+
+    fail_unless (seq < G_N_ELEMENTS (received));
+    fail_unless (received[seq] == NULL, "seqnum %u received twice", seq);
+    received[seq] = buffer;
+    n_received++;
+  }
+
+  fail_unless_equals_int (n_received, n_expected);
+
+  for (i = 0; i < packets->len; i++) {
+    Packet *packet = &g_array_index (packets, Packet, i);
+    GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+    GstMapInfo expected, actual;
+    guint16 seq;
+
+    if (packet->repair)
+      continue;
+
+    gst_rtp_buffer_map (packet->buffer, GST_MAP_READ, &rtp);
+    seq = gst_rtp_buffer_get_seq (&rtp);
+    gst_rtp_buffer_unmap (&rtp);
+
+    if (!received[seq])
+      continue;
+
+    gst_buffer_map (packet->buffer, &expected, GST_MAP_READ);
+    gst_buffer_map (received[seq], &actual, GST_MAP_READ);
+    fail_unless_equals_int (actual.size, expected.size);
+    fail_unless (memcmp (actual.data, expected.data, expected.size) == 0,
+        "recovered packet %u differs", seq);
+    gst_buffer_unmap (packet->buffer, &expected);
+    gst_buffer_unmap (received[seq], &actual);
+  }
+
+  g_object_get (h->element, "recovered", &recovered, NULL);
+  fail_unless_equals_int (recovered, n_recovered);
+
+  for (i = 0; i < G_N_ELEMENTS (received); i++)
+    gst_clear_buffer (&received[i]);
+
+  gst_harness_teardown (h);
+  gst_harness_teardown (h_media);
+  gst_harness_teardown (h_fec);
+}
+
+GST_START_TEST (test_row_header)
+{
+  GstElement *enc = gst_element_factory_make ("rtpflexfecenc", NULL);
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstHarness *h, *h_fec;
+  GstBuffer *buffer;
+  guint8 *payload;
+  guint i;
+
+  g_object_set (enc, "columns", 3, "pt", 100, "ssrc", 0x1234, NULL);
+  h = gst_harness_new_with_element (enc, "sink", "src");
+  h_fec = gst_harness_new_with_element (h->element, NULL, "fec_0");
+  gst_harness_set_src_caps_str (h, "application/x-rtp");
+
+  for (i = 0; i < 3; i++) {
+    fail_unless_equals_int (gst_harness_buffers_in_queue (h_fec), 0);
+    gst_harness_push (h, make_media_packet (10 + i, 1));
+  }
+
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 3);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h_fec), 1);
+  buffer = gst_harness_pull (h_fec);
+
+  fail_unless (gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp));
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_type (&rtp), 100);
+  fail_unless_equals_int (gst_rtp_buffer_get_ssrc (&rtp), 0x1234);
+  fail_unless_equals_int (gst_rtp_buffer_get_csrc_count (&rtp), 1);
+  fail_unless_equals_int (gst_rtp_buffer_get_csrc (&rtp, 0), TEST_SSRC);
+  fail_unless_equals_int (gst_rtp_buffer_get_timestamp (&rtp), 12 * 3000);
+
+  /* 8 bytes bit string header, SN base, short mask and 1 byte payload */
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_len (&rtp), 13);
+  payload = gst_rtp_buffer_get_payload (&rtp);
+  /* R=0 F=0 */
+  fail_unless_equals_int (payload[0] >> 6, 0);
+  /* Marker on packet 10 only */
+  fail_unless_equals_int (payload[1], (0x80 | TEST_PT) ^ TEST_PT ^ TEST_PT);
+  /* Length recovery */
+  fail_unless_equals_int (GST_READ_UINT16_BE (payload + 2), 1 ^ 1 ^ 1);
+  fail_unless_equals_int (GST_READ_UINT32_BE (payload + 4),
+      (10 * 3000) ^ (11 * 3000) ^ (12 * 3000));
+  /* SN base, k=1 and the first three mask bits set */
+  fail_unless_equals_int (GST_READ_UINT16_BE (payload + 8), 10);
+  fail_unless_equals_int (GST_READ_UINT16_BE (payload + 10), 0xf000);
+  fail_unless_equals_int (payload[12], (guint8) (70 ^ 77 ^ 84));
+  gst_rtp_buffer_unmap (&rtp);
+
+  gst_buffer_unref (buffer);
+  gst_harness_teardown (h);
+  gst_harness_teardown (h_fec);  gst_object_unref (enc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_xor_2d_recovery)
+{
+  GstElement *enc = gst_element_factory_make ("rtpflexfecenc", NULL);
+  /* Only seqnum 2 can be recovered right away, the others can be once
+   * recovered packets are used to complete other repair packets */
+  const guint16 dropped[] = { 2, 5, 6, 8, 9 };
+  GArray *packets;
+
+  g_object_set (enc, "columns", 4, "rows", 4, NULL);
+  packets = encode (enc, 32);
+
+  /* 8 row and 8 column repair packets */
+  fail_unless_equals_int (packets->len, 32 + 16);
+
+  decode_and_check (packets, dropped, G_N_ELEMENTS (dropped), 32,
+      G_N_ELEMENTS (dropped));
+
+  free_packets (packets);
+  gst_object_unref (enc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_xor_unrecoverable)
+{
+  GstElement *enc = gst_element_factory_make ("rtpflexfecenc", NULL);
+  /* Two losses in a row, without column protection */
+  const guint16 dropped[] = { 4, 6, 9 };
+  GArray *packets;
+
+  g_object_set (enc, "columns", 4, NULL);
+  packets = encode (enc, 16);
+
+  fail_unless_equals_int (packets->len, 16 + 4);
+
+  decode_and_check (packets, dropped, G_N_ELEMENTS (dropped), 16 - 2, 1);
+
+  free_packets (packets);
+  gst_object_unref (enc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_reed_solomon_burst)
+{
+  GstElement *enc = gst_element_factory_make ("rtpflexfecenc", NULL);
+  /* A burst of 4 in the first block and 3 scattered in the second */
+  const guint16 dropped[] = { 3, 4, 5, 6, 25, 30, 31 };
+  GArray *packets;
+
+  gst_util_set_object_arg (G_OBJECT (enc), "mode", "reed-solomon");
+  g_object_set (enc, "columns", 10, "rows", 2, "repair-packets", 4, NULL);
+  packets = encode (enc, 40);
+
+  fail_unless_equals_int (packets->len, 40 + 8);
+
+  decode_and_check (packets, dropped, G_N_ELEMENTS (dropped), 40,
+      G_N_ELEMENTS (dropped));
+
+  free_packets (packets);
+  gst_object_unref (enc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_reed_solomon_too_many_lost)
+{
+  GstElement *enc = gst_element_factory_make ("rtpflexfecenc", NULL);
+  const guint16 dropped[] = { 0, 1, 2, 3, 17 };
+  GArray *packets;
+
+  gst_util_set_object_arg (G_OBJECT (enc), "mode", "reed-solomon");
+  g_object_set (enc, "columns", 8, "repair-packets", 3, NULL);
+  packets = encode (enc, 24);
+
+  /* The first block can't be recovered, the third one can */
+  decode_and_check (packets, dropped, G_N_ELEMENTS (dropped), 24 - 4, 1);
+
+  free_packets (packets);
+  gst_object_unref (enc);
+}
+
+GST_END_TEST;
+
+static Suite *
+rtpflexfec_suite (void)
+{
+  Suite *s = suite_create ("rtpflexfec");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_row_header);
+  tcase_add_test (tc_chain, test_xor_2d_recovery);
+  tcase_add_test (tc_chain, test_xor_unrecoverable);
+  tcase_add_test (tc_chain, test_reed_solomon_burst);
+  tcase_add_test (tc_chain, test_reed_solomon_too_many_lost);
+
+  return s;
+}
+
+GST_CHECK_MAIN (rtpflexfec);
@@ -2859,6 +2859,54 @@ GST_START_TEST (test_fill_queue)
 
 GST_END_TEST;
 
+GST_START_TEST (test_fill_reordered_gaps)
+{
+  GstHarness *h = gst_harness_new ("rtpjitterbuffer");
+  const guint block = 64, num_blocks = 16;
+  GstStructure *stats;
+  guint64 duplicates;
+  guint next_seqnum, b, i;
+
+  next_seqnum = construct_deterministic_initial_state (h, 100);
+
+  /* in each block the odd packets arrive first, then the gaps are filled
+   * backwards so that every packet lands in the middle of the queue */
+  for (b = 0; b < num_blocks; b++) {
+    guint first = next_seqnum + b * block;
+
+    for (i = 1; i < block; i += 2)
+      fail_unless_equals_int (GST_FLOW_OK,
+          gst_harness_push (h, generate_test_buffer (first + i)));
+    for (i = block; i >= 2; i -= 2)
+      fail_unless_equals_int (GST_FLOW_OK,
+          gst_harness_push (h, generate_test_buffer (first + i - 2)));
+  }
+
+  for (i = 0; i < block * num_blocks; i++) {
+    GstBuffer *buf = gst_harness_pull (h);
+    fail_unless_equals_int (next_seqnum + i, get_rtp_seq_num (buf));
+    gst_buffer_unref (buf);
+  }
+
+  /* the duplicates are still found */
+  for (i = 1; i < block; i += 2)
+    gst_harness_push (h, generate_test_buffer (next_seqnum +
+            block * num_blocks + i));
+  gst_harness_push (h, generate_test_buffer (next_seqnum +
+          block * num_blocks + 5));
+  gst_harness_push (h, generate_test_buffer (next_seqnum +
+          block * num_blocks + 31));
+  g_object_get (h->element, "stats", &stats, NULL);
+  gst_structure_get (stats, "num-duplicates", G_TYPE_UINT64, &duplicates,
+      NULL);
+  fail_unless_equals_uint64 (2, duplicates);
+  gst_structure_free (stats);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 typedef struct
 {
   gint64 dts_skew;
@@ -3427,6 +3475,7 @@ rtpjitterbuffer_suite (void)
   tcase_add_test (tc_chain, test_big_gap_seqnum);
   tcase_add_test (tc_chain, test_big_gap_arrival_time);
   tcase_add_test (tc_chain, test_fill_queue);
+  tcase_add_test (tc_chain, test_fill_reordered_gaps);
 
   tcase_add_loop_test (tc_chain,
       test_considered_lost_packet_in_large_gap_arrives, 0,
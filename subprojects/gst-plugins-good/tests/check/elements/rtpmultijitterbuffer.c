@@ -0,0 +1,383 @@
+/* GStreamer
+ *
+ * Copyright (C) 2022 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/rtp/gstrtpbuffer.h>
+
+#include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+
+#define TEST_BUF_CLOCK_RATE 8000
+#define TEST_BUF_PT 0
+#define TEST_BUF_SSRC 0x01BADBAD
+#define TEST_BUF_MS  20
+#define TEST_BUF_DURATION (TEST_BUF_MS * GST_MSECOND)
+#define TEST_BUF_SIZE (64000 * TEST_BUF_MS / 1000)
+#define TEST_RTP_TS_DURATION (TEST_BUF_CLOCK_RATE * TEST_BUF_MS / 1000)
+#define TEST_LATENCY_MS 100
+
+#define MAX_TEST_SSRCS 4
+
+static GstCaps *
+generate_caps (void)
+{
+  return gst_caps_new_simple ("application/x-rtp",
+      "media", G_TYPE_STRING, "audio",
+      "clock-rate", G_TYPE_INT, TEST_BUF_CLOCK_RATE, NULL);
+}
+
+static GstBuffer *
+create_buffer (guint seq_num, guint32 ssrc)
+{
+  GstBuffer *buf;
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+
+  buf = gst_rtp_buffer_new_allocate (TEST_BUF_SIZE, 0, 0);
+  GST_BUFFER_DTS (buf) = seq_num * TEST_BUF_DURATION;
+
+  gst_rtp_buffer_map (buf, GST_MAP_READWRITE, &rtp);
+  gst_rtp_buffer_set_payload_type (&rtp, TEST_BUF_PT);
+  gst_rtp_buffer_set_seq (&rtp, seq_num);
+  gst_rtp_buffer_set_timestamp (&rtp, seq_num * TEST_RTP_TS_DURATION);
+  gst_rtp_buffer_set_ssrc (&rtp, ssrc);
+  memset (gst_rtp_buffer_get_payload (&rtp), 0xff, TEST_BUF_SIZE);
+  gst_rtp_buffer_unmap (&rtp);
+
+  return buf;
+}
+
+static void
+push_buffer (GstHarness * h, guint seq_num, guint32 ssrc)
+{
+  fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (h,
+          create_buffer (seq_num, ssrc)));
+}
+
+static void
+check_buffer (GstBuffer * buf, guint seq_num, guint32 ssrc)
+{
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+
+  fail_unless (buf != NULL);
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp));
+  fail_unless_equals_int (gst_rtp_buffer_get_seq (&rtp), seq_num);
+  fail_unless_equals_int (gst_rtp_buffer_get_ssrc (&rtp), ssrc);
+  gst_rtp_buffer_unmap (&rtp);
+}
+
+typedef struct
+{
+  GstHarness *h;
+  GstHarness *src[MAX_TEST_SSRCS];
+  guint32 ssrc[MAX_TEST_SSRCS];
+  guint n_src;
+} TestContext;
+
+static void
+new_ssrc_pad_cb (G_GNUC_UNUSED GstElement * element, guint ssrc,
+    GstPad * pad, TestContext * ctx)
+{
+  g_assert (ctx->n_src < MAX_TEST_SSRCS);
+
+  ctx->ssrc[ctx->n_src] = ssrc;
+  ctx->src[ctx->n_src] = gst_harness_new_with_element (ctx->h->element, NULL,
+      GST_PAD_NAME (pad));
+  ctx->n_src++;
+}
+
+static GstHarness *
+get_src_harness (TestContext * ctx, guint32 ssrc)
+{
+  guint i;
+
+  for (i = 0; i < ctx->n_src; i++) {
+    if (ctx->ssrc[i] == ssrc)
+      return ctx->src[i];
+  }
+  return NULL;
+}
+
+static void
+test_context_init (TestContext * ctx)
+{
+  memset (ctx, 0, sizeof (TestContext));
+
+  ctx->h = gst_harness_new_with_padnames ("rtpmultijitterbuffer", "sink",
+      NULL);
+  g_object_set (ctx->h->element, "latency", TEST_LATENCY_MS, NULL);
+  g_signal_connect (ctx->h->element, "new-ssrc-pad",
+      G_CALLBACK (new_ssrc_pad_cb), ctx);
+
+  gst_harness_use_testclock (ctx->h);
+  gst_harness_set_src_caps (ctx->h, generate_caps ());
+}
+
+static void
+test_context_clear (TestContext * ctx)
+{
+  guint i;
+
+  for (i = 0; i < ctx->n_src; i++)
+    gst_harness_teardown (ctx->src[i]);
+  gst_harness_teardown (ctx->h);
+}
+
+static guint64
+get_stat (GstElement * element, const gchar * field)
+{
+  GstStructure *stats;
+  guint64 val = 0;
+  guint uval;
+
+  g_object_get (element, "stats", &stats, NULL);
+  if (!gst_structure_get_uint64 (stats, field, &val)) {
+    fail_unless (gst_structure_get_uint (stats, field, &uval));
+    val = uval;
+  }
+  gst_structure_free (stats);
+
+  return val;
+}
+
+GST_START_TEST (test_reorder_ssrcs)
+{
+  TestContext ctx;
+  guint32 ssrcs[3] = { TEST_BUF_SSRC, 0xdeadbeef, 0x12345678 };
+  guint i, seq;
+
+  test_context_init (&ctx);
+
+  /* the first packet of every SSRC waits for the latency */
+  gst_harness_set_time (ctx.h, 0);
+  for (i = 0; i < 3; i++)
+    push_buffer (ctx.h, 0, ssrcs[i]);
+  fail_unless_equals_int (ctx.n_src, 3);
+
+  gst_harness_set_time (ctx.h, 2 * TEST_BUF_DURATION);
+  for (i = 0; i < 3; i++)
+    push_buffer (ctx.h, 2, ssrcs[i]);
+  gst_harness_set_time (ctx.h, 2 * TEST_BUF_DURATION + GST_MSECOND);
+  for (i = 0; i < 3; i++)
+    push_buffer (ctx.h, 1, ssrcs[i]);
+
+  for (i = 0; i < 3; i++)
+    fail_unless_equals_int (gst_harness_buffers_in_queue (ctx.src[i]), 0);
+
+  /* a single timer wakes up all of them */
+  fail_unless (gst_harness_crank_single_clock_wait (ctx.h));
+
+  for (i = 0; i < 3; i++) {
+    GstHarness *src = get_src_harness (&ctx, ssrcs[i]);
+
+    fail_unless (src != NULL);
+    for (seq = 0; seq < 3; seq++) {
+      GstBuffer *buf = gst_harness_pull (src);
+
+      check_buffer (buf, seq, ssrcs[i]);
+      fail_unless_equals_int (GST_BUFFER_FLAG_IS_SET (buf,
+              GST_BUFFER_FLAG_DISCONT), seq == 0);
+      gst_buffer_unref (buf);
+    }
+  }
+
+  fail_unless_equals_uint64 (get_stat (ctx.h->element, "num-streams"), 3);
+  fail_unless_equals_uint64 (get_stat (ctx.h->element, "num-pushed"), 9);
+  fail_unless_equals_uint64 (get_stat (ctx.h->element, "num-lost"), 0);
+
+  test_context_clear (&ctx);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_lost_event)
+{
+  TestContext ctx;
+  GstBuffer *buf;
+  GstEvent *event;
+  const GstStructure *s;
+  guint seqnum;
+
+  test_context_init (&ctx);
+  g_object_set (ctx.h->element, "do-lost", TRUE, NULL);
+
+  gst_harness_set_time (ctx.h, 0);
+  push_buffer (ctx.h, 0, TEST_BUF_SSRC);
+  fail_unless (gst_harness_crank_single_clock_wait (ctx.h));
+  buf = gst_harness_pull (ctx.src[0]);
+  check_buffer (buf, 0, TEST_BUF_SSRC);
+  gst_buffer_unref (buf);
+
+  /* in order, pushed right away */
+  push_buffer (ctx.h, 1, TEST_BUF_SSRC);
+  buf = gst_harness_pull (ctx.src[0]);
+  check_buffer (buf, 1, TEST_BUF_SSRC);
+  fail_if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DISCONT));
+  gst_buffer_unref (buf);
+
+  /* #2 never arrives, #3 waits for it until its deadline */
+  push_buffer (ctx.h, 3, TEST_BUF_SSRC);
+  fail_unless (gst_harness_crank_single_clock_wait (ctx.h));
+
+  buf = gst_harness_pull (ctx.src[0]);
+  check_buffer (buf, 3, TEST_BUF_SSRC);
+  fail_unless (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DISCONT));
+  gst_buffer_unref (buf);
+
+  /* the lost event went out before #3 */
+  do {
+    event = gst_harness_try_pull_event (ctx.src[0]);
+    fail_unless (event != NULL);
+    if (GST_EVENT_TYPE (event) == GST_EVENT_CUSTOM_DOWNSTREAM)
+      break;
+    gst_event_unref (event);
+  } while (TRUE);
+
+  s = gst_event_get_structure (event);
+  fail_unless (gst_structure_has_name (s, "GstRTPPacketLost"));
+  fail_unless (gst_structure_get_uint (s, "seqnum", &seqnum));
+  fail_unless_equals_int (seqnum, 2);
+  gst_event_unref (event);
+
+  fail_unless_equals_uint64 (get_stat (ctx.h->element, "num-lost"), 1);
+
+  test_context_clear (&ctx);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_late_and_duplicates)
+{
+  TestContext ctx;
+  GstBuffer *buf;
+
+  test_context_init (&ctx);
+
+  gst_harness_set_time (ctx.h, 0);
+  push_buffer (ctx.h, 0, TEST_BUF_SSRC);
+  fail_unless (gst_harness_crank_single_clock_wait (ctx.h));
+  buf = gst_harness_pull (ctx.src[0]);
+  check_buffer (buf, 0, TEST_BUF_SSRC);
+  gst_buffer_unref (buf);
+
+  /* #0 was already pushed */
+  push_buffer (ctx.h, 0, TEST_BUF_SSRC);
+  fail_unless_equals_uint64 (get_stat (ctx.h->element, "num-late"), 1);
+
+  /* the second #2 is dropped while #2 waits for #1 */
+  push_buffer (ctx.h, 2, TEST_BUF_SSRC);
+  push_buffer (ctx.h, 2, TEST_BUF_SSRC);
+  fail_unless_equals_uint64 (get_stat (ctx.h->element, "num-duplicates"), 1);
+
+  push_buffer (ctx.h, 1, TEST_BUF_SSRC);
+  buf = gst_harness_pull (ctx.src[0]);
+  check_buffer (buf, 1, TEST_BUF_SSRC);
+  gst_buffer_unref (buf);
+  buf = gst_harness_pull (ctx.src[0]);
+  check_buffer (buf, 2, TEST_BUF_SSRC);
+  gst_buffer_unref (buf);
+
+  fail_unless_equals_uint64 (get_stat (ctx.h->element, "num-pushed"), 3);
+
+  test_context_clear (&ctx);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_many_ssrcs)
+{
+  GstHarness *h;
+  guint i, n_ssrcs = 2000;
+
+  h = gst_harness_new_with_padnames ("rtpmultijitterbuffer", "sink", NULL);
+  g_object_set (h->element, "max-streams", n_ssrcs - 500, "output-threads", 2,
+      NULL);
+  gst_harness_use_testclock (h);
+  gst_harness_set_src_caps (h, generate_caps ());
+
+  /* the pads are not linked, which is not an error */
+  for (i = 0; i < n_ssrcs; i++) {
+    push_buffer (h, 0, i);
+    push_buffer (h, 1, i);
+  }
+  fail_unless_equals_uint64 (get_stat (h->element, "num-streams"),
+      n_ssrcs - 500);
+
+  /* EOS pushes out everything that was waiting */
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+  fail_unless_equals_uint64 (get_stat (h->element, "num-pushed"),
+      2 * (n_ssrcs - 500));
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_clear_ssrc)
+{
+  GstHarness *h;
+  GstPad *pad;
+  gchar *name;
+
+  h = gst_harness_new_with_padnames ("rtpmultijitterbuffer", "sink", NULL);
+  gst_harness_use_testclock (h);
+  gst_harness_set_src_caps (h, generate_caps ());
+
+  push_buffer (h, 0, TEST_BUF_SSRC);
+  push_buffer (h, 0, 0xdeadbeef);
+  fail_unless_equals_uint64 (get_stat (h->element, "num-streams"), 2);
+
+  g_signal_emit_by_name (h->element, "clear-ssrc", TEST_BUF_SSRC);
+  fail_unless_equals_uint64 (get_stat (h->element, "num-streams"), 1);
+
+  name = g_strdup_printf ("src_%u", TEST_BUF_SSRC);
+  pad = gst_element_get_static_pad (h->element, name);
+  fail_unless (pad == NULL);
+  g_free (name);
+
+  /* the SSRC comes back with a new pad */
+  push_buffer (h, 1, TEST_BUF_SSRC);
+  fail_unless_equals_uint64 (get_stat (h->element, "num-streams"), 2);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+static Suite *
+rtpmultijitterbuffer_suite (void)
+{
+  Suite *s = suite_create ("rtpmultijitterbuffer");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_reorder_ssrcs);
+  tcase_add_test (tc_chain, test_lost_event);
+  tcase_add_test (tc_chain, test_late_and_duplicates);
+  tcase_add_test (tc_chain, test_many_ssrcs);
+  tcase_add_test (tc_chain, test_clear_ssrc);
+
+  return s;
+}
+
+GST_CHECK_MAIN (rtpmultijitterbuffer);
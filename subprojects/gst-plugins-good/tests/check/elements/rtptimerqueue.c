@@ -20,8 +20,35 @@
  */
 
 #include <gst/check/gstcheck.h>
+#include <gst/rtp/gstrtpbuffer.h>
 #include "gst/rtpmanager/rtptimerqueue.h"
 
+static void
+check_timer_queue_order (RtpTimerQueue * queue)
+{
+  RtpTimer *timer, *next;
+  guint length = 0;
+
+  for (timer = rtp_timer_queue_peek_earliest (queue); timer; timer = next) {
+    next = rtp_timer_get_next (timer);
+    length++;
+
+    if (next == NULL)
+      break;
+
+    fail_unless (rtp_timer_get_prev (next) == timer);
+
+    if (timer->timeout == next->timeout)
+      fail_unless (gst_rtp_buffer_compare_seqnum (timer->seqnum,
+              next->seqnum) > 0);
+    else if (GST_CLOCK_TIME_IS_VALID (timer->timeout))
+      fail_unless (GST_CLOCK_TIME_IS_VALID (next->timeout) &&
+          timer->timeout < next->timeout);
+  }
+
+  fail_unless_equals_int (length, rtp_timer_queue_length (queue));
+}
+
 GST_START_TEST (test_timer_queue_set_timer)
 {
   RtpTimerQueue *queue = rtp_timer_queue_new ();
@@ -305,6 +332,71 @@ GST_START_TEST (test_timer_queue_timer_offset)
 
 GST_END_TEST;
 
+GST_START_TEST (test_timer_queue_many_timers)
+{
+  RtpTimerQueue *queue = rtp_timer_queue_new ();
+  GRand *rand = g_rand_new_with_seed (1);
+  GstClockTime last = 0;
+  RtpTimer *timer;
+  guint i;
+
+  for (i = 0; i < 5000; i++) {
+    guint16 seqnum = g_rand_int_range (rand, 0, 1000);
+    GstClockTime timeout;
+
+    /* timeouts close to each other, and spread over several wheel laps */
+    if (g_rand_boolean (rand))
+      timeout = g_rand_int_range (rand, 0, 10000) * GST_MSECOND;
+    else
+      timeout = 5 * GST_SECOND + g_rand_int_range (rand, 0, 20000) *
+          GST_USECOND;
+
+    switch (g_rand_int_range (rand, 0, 8)) {
+      case 0:
+        rtp_timer_queue_set_deadline (queue, seqnum, -1, 0);
+        break;
+      case 1:
+        timer = rtp_timer_queue_find (queue, seqnum);
+        if (timer) {
+          rtp_timer_queue_unschedule (queue, timer);
+          rtp_timer_free (timer);
+        }
+        break;
+      case 2:
+        /* shift all timers in place, like the jitterbuffer does when the
+         * timestamp offset changes */
+        for (timer = rtp_timer_queue_peek_earliest (queue); timer;
+            timer = rtp_timer_get_next (timer)) {
+          if (GST_CLOCK_TIME_IS_VALID (timer->timeout))
+            timer->timeout += 37 * GST_MSECOND;
+        }
+        break;
+      default:
+        rtp_timer_queue_set_expected (queue, seqnum, timeout, 0, 0);
+        break;
+    }
+
+    check_timer_queue_order (queue);
+  }
+
+  fail_unless (rtp_timer_queue_length (queue) > 100);
+
+  while ((timer = rtp_timer_queue_pop_until (queue, GST_CLOCK_TIME_NONE))) {
+    if (GST_CLOCK_TIME_IS_VALID (timer->timeout)) {
+      fail_unless (timer->timeout >= last);
+      last = timer->timeout;
+    } else {
+      fail_unless (last == 0);
+    }
+    rtp_timer_free (timer);
+  }
+
+  g_rand_free (rand);
+  g_object_unref (queue);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtptimerqueue_suite (void)
 {
@@ -319,6 +411,7 @@ rtptimerqueue_suite (void)
   tcase_add_test (tc_chain, test_timer_queue_update_timer_seqnum);
   tcase_add_test (tc_chain, test_timer_queue_dup_timer);
   tcase_add_test (tc_chain, test_timer_queue_timer_offset);
+  tcase_add_test (tc_chain, test_timer_queue_many_timers);
 
   return s;
 }
@@ -0,0 +1,268 @@
+/* GStreamer unit tests for the scaletempo overlap search
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <math.h>
+
+/* the search functions are static, test them directly */
+#include "../../../gst/audiofx/gstscaletempo.c"
+
+#define RATE 48000
+/* where a copy of the overlap is hidden in the search window, in frames */
+#define MATCH_OFFSET 377
+
+static gdouble
+reference_dot_product (const gdouble * a, const gdouble * b, guint n)
+{
+  gdouble corr = 0;
+  guint i;
+
+  for (i = 0; i < n; i++)
+    corr += a[i] * b[i];
+
+  return corr;
+}
+
+GST_START_TEST (test_dot_product)
+{
+  GRand *rand = g_rand_new_with_seed (42);
+  gdouble da[67], db[67];
+  gfloat fa[67], fb[67];
+  guint i, n;
+
+  for (i = 0; i < G_N_ELEMENTS (da); i++) {
+    da[i] = g_rand_double_range (rand, -1.0, 1.0);
+    db[i] = g_rand_double_range (rand, -1.0, 1.0);
+    fa[i] = da[i];
+    fb[i] = db[i];
+  }
+
+  /* all lengths, so that the vector loop and the scalar tail are both hit
+   * and combined. Only the order of the additions differs from the scalar
+   * loop, so the results agree up to rounding. */
+  for (n = 0; n <= G_N_ELEMENTS (da); n++) {
+    gdouble ref = reference_dot_product (da, db, n);
+    gdouble sum_abs = 0;
+
+    for (i = 0; i < n; i++)
+      sum_abs += fabs (da[i] * db[i]);
+
+    fail_unless (fabs (dot_product_double (da, db, n) - ref) <=
+        1e-12 * sum_abs);
+    fail_unless (fabs (dot_product_float (fa, fb, n) - ref) <=
+        1e-5 * sum_abs + 1e-6);
+  }
+
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+/* Smooth noise, so that the correlation peak is wider than the coarse step
+ * of the fast search */
+static void
+generate_signal (GRand * rand, gdouble * dst, guint n, gdouble amplitude)
+{
+  gdouble s1 = 0, s2 = 0, s3 = 0;
+  guint i;
+
+  for (i = 0; i < n; i++) {
+    s1 += 0.05 * (g_rand_double_range (rand, -1.0, 1.0) - s1);
+    s2 += 0.05 * (s1 - s2);
+    s3 += 0.05 * (s2 - s3);
+    dst[i] = amplitude * 8.0 * s3;
+  }
+}
+
+static void
+store_samples (GstAudioFormat format, const gdouble * src, gpointer dst,
+    guint n)
+{
+  guint i;
+
+  for (i = 0; i < n; i++) {
+    if (format == GST_AUDIO_FORMAT_S16)
+      ((gint16 *) dst)[i] = CLAMP (src[i] * 32767, -32768, 32767);
+    else if (format == GST_AUDIO_FORMAT_F32)
+      ((gfloat *) dst)[i] = src[i];
+    else
+      ((gdouble *) dst)[i] = src[i];
+  }
+}
+
+static GstScaletempo *
+setup_scaletempo (GstAudioFormat format, guint channels, gboolean fast_search)
+{
+  GstScaletempo *st = g_object_new (GST_TYPE_SCALETEMPO, NULL);
+
+  st->format = format;
+  st->sample_rate = RATE;
+  st->samples_per_frame = channels;
+  st->bytes_per_sample = format == GST_AUDIO_FORMAT_S16 ? 2 :
+      format == GST_AUDIO_FORMAT_F32 ? 4 : 8;
+  st->bytes_per_frame = channels * st->bytes_per_sample;
+  st->scale = 1.5;
+  st->fast_search = fast_search;
+  reinit_buffers (st);
+
+  fail_unless (st->best_overlap_offset != NULL);
+
+  return st;
+}
+
+static void
+cleanup_scaletempo (GstScaletempo * st)
+{
+  gst_scaletempo_stop (GST_BASE_TRANSFORM (st));
+  gst_object_unref (st);
+}
+
+/* Fills the search window with a quieter unrelated signal and hides a copy of
+ * the overlap at MATCH_OFFSET in it, then returns the offset found in
+ * frames */
+static guint
+run_search (GstScaletempo * st)
+{
+  GRand *rand = g_rand_new_with_seed (1234);
+  guint frames_overlap = st->bytes_overlap / st->bytes_per_frame;
+  guint samples_queue = st->bytes_queue_max / st->bytes_per_sample;
+  guint channels = st->samples_per_frame;
+  gdouble *overlap, *queue;
+  guint off;
+
+  fail_unless (MATCH_OFFSET < st->frames_search);
+  fail_unless ((MATCH_OFFSET + frames_overlap) * channels <= samples_queue);
+
+  overlap = g_new (gdouble, st->samples_overlap);
+  queue = g_new (gdouble, samples_queue);
+  generate_signal (rand, overlap, st->samples_overlap, 0.5);
+  generate_signal (rand, queue, samples_queue, 0.15);
+  memcpy (queue + MATCH_OFFSET * channels, overlap,
+      st->samples_overlap * sizeof (gdouble));
+
+  store_samples (st->format, overlap, st->buf_overlap, st->samples_overlap);
+  store_samples (st->format, queue, st->buf_queue, samples_queue);
+
+  off = st->best_overlap_offset (st);
+  fail_unless_equals_int (off % st->bytes_per_frame, 0);
+
+  g_free (queue);
+  g_free (overlap);
+  g_rand_free (rand);
+
+  return off / st->bytes_per_frame;
+}
+
+/* The exhaustive search as it was before it was vectorized */
+static guint
+reference_search (GstScaletempo * st)
+{
+  guint n = st->samples_overlap - st->samples_per_frame;
+  gdouble best_corr = -G_MAXDOUBLE;
+  guint best_off = 0, off, i;
+
+  for (off = 0; off < st->frames_search; off++) {
+    gdouble corr = 0;
+
+    for (i = 0; i < n; i++) {
+      gdouble pc, s;
+
+      if (st->format == GST_AUDIO_FORMAT_F32) {
+        pc = ((gfloat *) st->buf_pre_corr)[i];
+        s = ((gfloat *) st->buf_queue)[(off + 1) * st->samples_per_frame + i];
+      } else {
+        pc = ((gdouble *) st->buf_pre_corr)[i];
+        s = ((gdouble *) st->buf_queue)[(off + 1) * st->samples_per_frame + i];
+      }
+      corr += pc * s;
+    }
+    if (corr > best_corr) {
+      best_corr = corr;
+      best_off = off;
+    }
+  }
+
+  return best_off;
+}
+
+static void
+check_search (GstAudioFormat format, guint channels)
+{
+  GstScaletempo *st;
+  guint off, fast_off;
+
+  /* the vectorized exhaustive search picks the same position as the scalar
+   * loop on the same pre-correlation */
+  st = setup_scaletempo (format, channels, FALSE);
+  off = run_search (st);
+  if (format != GST_AUDIO_FORMAT_S16)
+    fail_unless_equals_int (reference_search (st), off);
+  cleanup_scaletempo (st);
+
+  /* the fast search refines the coarse position at full resolution, so it
+   * ends up next to the exhaustive one and not a coarse step away */
+  st = setup_scaletempo (format, channels, TRUE);
+  fail_unless_equals_int (st->frames_search_step, RATE / 8000);
+  fast_off = run_search (st);
+  fail_unless (ABS ((gint) fast_off - (gint) off) <= 2,
+      "fast search found %u, exhaustive search %u", fast_off, off);
+  cleanup_scaletempo (st);
+}
+
+GST_START_TEST (test_search_s16)
+{
+  check_search (GST_AUDIO_FORMAT_S16, 2);
+  check_search (GST_AUDIO_FORMAT_S16, 6);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_search_f32)
+{
+  check_search (GST_AUDIO_FORMAT_F32, 1);
+  check_search (GST_AUDIO_FORMAT_F32, 2);
+  check_search (GST_AUDIO_FORMAT_F32, 6);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_search_f64)
+{
+  check_search (GST_AUDIO_FORMAT_F64, 1);
+  check_search (GST_AUDIO_FORMAT_F64, 2);
+  check_search (GST_AUDIO_FORMAT_F64, 6);
+}
+
+GST_END_TEST;
+
+static Suite *
+scaletempo_suite (void)
+{
+  Suite *s = suite_create ("scaletempo");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_dot_product);
+  tcase_add_test (tc_chain, test_search_s16);
+  tcase_add_test (tc_chain, test_search_f32);
+  tcase_add_test (tc_chain, test_search_f64);
+
+  return s;
+}
+
+GST_CHECK_MAIN (scaletempo);
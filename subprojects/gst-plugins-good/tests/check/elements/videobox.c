@@ -24,6 +24,8 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+#include <gst/video/video.h>
 
 typedef struct _GstVideoBoxTestContext
 {
@@ -206,6 +208,87 @@ GST_START_TEST (test_caps_transform)
 
 GST_END_TEST;
 
+static GstBuffer *
+videobox_run (const gchar * in_format, const gchar * out_format, gint top,
+    gint bottom, gint left, guint n_threads)
+{
+  GstHarness *h;
+  GstVideoInfo info;
+  GstBuffer *buf;
+  GstMapInfo map;
+  GstCaps *caps;
+  gsize i;
+
+  h = gst_harness_new ("videobox");
+  g_object_set (h->element, "top", top, "bottom", bottom, "left", left,
+      "alpha", 0.5, "n-threads", n_threads, NULL);
+
+  caps = gst_caps_new_simple ("video/x-raw", "format", G_TYPE_STRING,
+      in_format, "width", G_TYPE_INT, 64, "height", G_TYPE_INT, 1000,
+      "framerate", GST_TYPE_FRACTION, 25, 1, NULL);
+  fail_unless (gst_video_info_from_caps (&info, caps));
+  gst_harness_set_src_caps (h, caps);
+  gst_harness_set_sink_caps (h, gst_caps_new_simple ("video/x-raw",
+          "format", G_TYPE_STRING, out_format, NULL));
+
+  buf = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&info));
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = (i * 13) ^ (i >> 7);
+  gst_buffer_unmap (buf, &map);
+
+  buf = gst_harness_push_and_pull (h, buf);
+  fail_unless (buf != NULL);
+
+  gst_harness_teardown (h);
+
+  return buf;
+}
+
+GST_START_TEST (test_n_threads)
+{
+  static const struct
+  {
+    const gchar *in_format, *out_format;
+    gint top, bottom, left;
+  } configs[] = {
+    {"I420", "I420", -20, 30, -6},
+    /* odd offsets are blended with the border */
+    {"I420", "I420", -17, 0, 3},
+    {"I420", "AYUV", 11, -40, 0},
+    {"AYUV", "I420", -100, -100, -2},
+    {"xRGB", "AYUV", -33, 7, 5},
+    {"YUY2", "YUY2", 25, -25, -4},
+  };
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (configs); i++) {
+    GstBuffer *single, *threaded;
+    GstMapInfo map1, map2;
+
+    GST_INFO ("checking %s -> %s, top %d bottom %d left %d",
+        configs[i].in_format, configs[i].out_format, configs[i].top,
+        configs[i].bottom, configs[i].left);
+
+    single = videobox_run (configs[i].in_format, configs[i].out_format,
+        configs[i].top, configs[i].bottom, configs[i].left, 1);
+    threaded = videobox_run (configs[i].in_format, configs[i].out_format,
+        configs[i].top, configs[i].bottom, configs[i].left, 4);
+
+    gst_buffer_map (single, &map1, GST_MAP_READ);
+    gst_buffer_map (threaded, &map2, GST_MAP_READ);
+    fail_unless_equals_int (map1.size, map2.size);
+    fail_unless (memcmp (map1.data, map2.data, map1.size) == 0);
+    gst_buffer_unmap (threaded, &map2);
+    gst_buffer_unmap (single, &map1);
+
+    gst_buffer_unref (single);
+    gst_buffer_unref (threaded);
+  }
+}
+
+GST_END_TEST;
+
 
 static Suite *
 videobox_suite (void)
@@ -215,6 +298,7 @@ videobox_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_caps_transform);
+  tcase_add_test (tc_chain, test_n_threads);
 
   return s;
 }
@@ -24,6 +24,7 @@
 
 #include <gst/video/video.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 
 gboolean have_eos = FALSE;
 
@@ -214,6 +215,69 @@ GST_START_TEST (test_videobalance)
 
 GST_END_TEST;
 
+static GstBuffer *
+run_videobalance (const gchar * format, guint n_threads)
+{
+  GstHarness *h;
+  GstVideoInfo info;
+  GstBuffer *buf;
+  GstMapInfo map;
+  GstCaps *caps;
+  gsize i;
+
+  h = gst_harness_new ("videobalance");
+  g_object_set (h->element, "saturation", 0.5, "hue", 0.3, "contrast", 1.2,
+      "n-threads", n_threads, NULL);
+
+  /* odd height to check the handling of the last chroma line */
+  caps = gst_caps_new_simple ("video/x-raw", "format", G_TYPE_STRING, format,
+      "width", G_TYPE_INT, 64, "height", G_TYPE_INT, 1001,
+      "framerate", GST_TYPE_FRACTION, 25, 1, NULL);
+  fail_unless (gst_video_info_from_caps (&info, caps));
+  gst_harness_set_src_caps (h, caps);
+
+  buf = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&info));
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = (i * 7) ^ (i >> 8);
+  gst_buffer_unmap (buf, &map);
+
+  buf = gst_harness_push_and_pull (h, buf);
+  fail_unless (buf != NULL);
+
+  gst_harness_teardown (h);
+
+  return buf;
+}
+
+GST_START_TEST (test_videobalance_n_threads)
+{
+  const gchar *formats[] = { "I420", "NV12", "Y41B", "YUY2", "xRGB" };
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    GstBuffer *single, *threaded;
+    GstMapInfo map1, map2;
+
+    GST_INFO ("checking format %s", formats[i]);
+
+    single = run_videobalance (formats[i], 1);
+    threaded = run_videobalance (formats[i], 4);
+
+    gst_buffer_map (single, &map1, GST_MAP_READ);
+    gst_buffer_map (threaded, &map2, GST_MAP_READ);
+    fail_unless_equals_int (map1.size, map2.size);
+    fail_unless (memcmp (map1.data, map2.data, map1.size) == 0);
+    gst_buffer_unmap (threaded, &map2);
+    gst_buffer_unmap (single, &map1);
+
+    gst_buffer_unref (single);
+    gst_buffer_unref (threaded);
+  }
+}
+
+GST_END_TEST;
+
 
 GST_START_TEST (test_videoflip)
 {
@@ -256,6 +320,7 @@ videofilter_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_videobalance);
+  tcase_add_test (tc_chain, test_videobalance_n_threads);
   tcase_add_test (tc_chain, test_videoflip);
   tcase_add_test (tc_chain, test_gamma);
 
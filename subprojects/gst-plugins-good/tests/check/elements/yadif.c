@@ -0,0 +1,209 @@
+/* GStreamer unit tests for the yadif SIMD line filters
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+/* Only the C and the intrinsics line filters are needed, not the assembly
+ * versions or orc */
+#undef HAVE_CONFIG_H
+#undef HAVE_NASM
+#undef HAVE_ORC
+#include "../../../gst/deinterlace/yadif.c"
+
+/* odd, so that the SIMD loop leaves a tail for the C version */
+#define WIDTH 203
+/* t0, b0, m1, mp, t2, b2, tp2, bp2, tt1, ttp, bb1, bbp */
+#define N_LINES 12
+
+typedef struct
+{
+  const gchar *name;
+  GstYadifFilterLineFunc filter_line;
+  guint bpp;
+  gint colors;
+} SimdFilter;
+
+static const SimdFilter simd_filters[] = {
+#if defined HAVE_AVX2
+  {"avx2 8 bit", gst_yadif_filter_line_8_c1_avx2, 1, 1},
+  {"avx2 8 bit semiplanar", gst_yadif_filter_line_8_c2_avx2, 1, 2},
+  {"avx2 16 bit", gst_yadif_filter_line_16_c1_avx2, 2, 1},
+  {"avx2 16 bit semiplanar", gst_yadif_filter_line_16_c2_avx2, 2, 2},
+#elif defined HAVE_NEON
+  {"neon 8 bit", gst_yadif_filter_line_8_c1_neon, 1, 1},
+  {"neon 8 bit semiplanar", gst_yadif_filter_line_8_c2_neon, 1, 2},
+  {"neon 16 bit", gst_yadif_filter_line_16_c1_neon, 2, 1},
+  {"neon 16 bit semiplanar", gst_yadif_filter_line_16_c2_neon, 2, 2},
+#endif
+  {NULL,}
+};
+
+static gboolean
+have_simd (void)
+{
+#if defined HAVE_AVX2 && (defined __GNUC__ || defined __clang__)
+  return __builtin_cpu_supports ("avx2");
+#elif defined HAVE_NEON
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+/* Runs the C filter on @lines into @dst for the samples from @start to @end,
+ * as filter_scanline_yadif() and filter_scanline_yadif_16() do */
+static void
+filter_line_ref (const SimdFilter * f, gpointer dst, gpointer * l, gint w,
+    gint start, gint end, gint mode)
+{
+  if (f->bpp == 1)
+    filter_line_c (dst, l[0], l[1], l[2], l[3], l[4], l[5], l[6], l[7],
+        l[8], l[9], l[10], l[11], w, f->colors, 0, start, end, mode);
+  else
+    filter_line_c_16 (dst, l[0], l[1], l[2], l[3], l[4], l[5], l[6], l[7],
+        l[8], l[9], l[10], l[11], w, f->colors, start, end, mode);
+}
+
+/* Random samples with runs of extreme values, so that the clamping of the
+ * prediction and the spatial checks are exercised as well */
+static void
+fill_line (GRand * rand, gpointer line, guint bpp, guint max, gint w)
+{
+  gint x;
+
+  for (x = 0; x < w; x++) {
+    guint v;
+
+    switch (g_rand_int_range (rand, 0, 8)) {
+      case 0:
+        v = 0;
+        break;
+      case 1:
+        v = max;
+        break;
+      default:
+        v = g_rand_int_range (rand, 0, max + 1);
+        break;
+    }
+    if (bpp == 1)
+      ((guint8 *) line)[x] = v;
+    else
+      ((guint16 *) line)[x] = v;
+  }
+}
+
+static void
+check_filter (const SimdFilter * f, guint max, gint mode, GRand * rand)
+{
+  gint w = WIDTH * f->colors;
+  gint edge = f->colors * MAX_ALIGN / f->bpp;
+  gint start = 3 * f->colors;
+  gint end = w - edge;
+  gpointer lines[N_LINES];
+  guint8 *dst, *ref;
+  gint i, x;
+
+  /* 16 samples of padding on both sides for the reads around x */
+  for (i = 0; i < N_LINES; i++) {
+    lines[i] = g_malloc ((w + 32) * f->bpp);
+    fill_line (rand, lines[i], f->bpp, max, w + 32);
+    lines[i] = (guint8 *) lines[i] + 16 * f->bpp;
+  }
+  dst = g_malloc0 (w * f->bpp);
+  ref = g_malloc0 (w * f->bpp);
+
+  filter_line_ref (f, ref, lines, w, start, end, mode);
+
+  x = f->filter_line (dst, lines[0], lines[1], lines[2], lines[3], lines[4],
+      lines[5], lines[6], lines[7], lines[8], lines[9], lines[10], lines[11],
+      start, end, mode);
+  fail_unless (x > start, "%s did not filter anything", f->name);
+  fail_unless (x <= end);
+  filter_line_ref (f, dst, lines, w, x, end, mode);
+
+  for (i = start; i < end; i++) {
+    guint v, r;
+
+    if (f->bpp == 1) {
+      v = dst[i];
+      r = ref[i];
+    } else {
+      v = ((guint16 *) dst)[i];
+      r = ((guint16 *) ref)[i];
+    }
+    fail_unless (v == r, "%s, max %u, mode %d: sample %d is %u, C gives %u",
+        f->name, max, mode, i, v, r);
+  }
+
+  for (i = 0; i < N_LINES; i++)
+    g_free ((guint8 *) lines[i] - 16 * f->bpp);
+  g_free (dst);
+  g_free (ref);
+}
+
+GST_START_TEST (test_simd_matches_c)
+{
+  GRand *rand;
+  guint i, n;
+
+  if (!have_simd () || simd_filters[0].name == NULL) {
+    GST_INFO ("no SIMD line filters on this CPU");
+    return;
+  }
+
+  rand = g_rand_new_with_seed (0xdeadbeef);
+
+  for (i = 0; simd_filters[i].name; i++) {
+    const SimdFilter *f = &simd_filters[i];
+
+    for (n = 0; n < 20; n++) {
+      /* 8 bit, 10 bit and full range 16 bit samples */
+      if (f->bpp == 1) {
+        check_filter (f, 255, 0, rand);
+        check_filter (f, 255, 2, rand);
+      } else {
+        check_filter (f, 1023, 0, rand);
+        check_filter (f, 1023, 2, rand);
+        check_filter (f, 65535, 0, rand);
+        check_filter (f, 65535, 2, rand);
+      }
+    }
+  }
+
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+static Suite *
+yadif_suite (void)
+{
+  Suite *s = suite_create ("yadif");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_simd_matches_c);
+
+  return s;
+}
+
+GST_CHECK_MAIN (yadif);
@@ -85,6 +85,11 @@ struct _GstRTSPClientPrivate
   gpointer send_messages_data;
   GDestroyNotify send_messages_notify;
   GArray *data_seqs;
+  /* interleaved data statistics */
+  guint64 backlog_bytes;
+  guint64 sent_bytes;
+  guint64 sent_messages;
+  guint64 dropped_messages;
 
   GstRTSPSessionPool *session_pool;
   gulong session_removed_id;
@@ -121,6 +126,9 @@ typedef struct
 {
   guint8 channel;
   guint seq;
+  /* payload queued in the watch until seq is sent */
+  guint64 bytes;
+  guint n_messages;
 } DataSeq;
 
 static GMutex tunnels_lock;
@@ -1184,6 +1192,7 @@ do_send_data (GstBuffer * buffer, guint8 channel, GstRTSPClient * client)
   g_mutex_lock (&priv->send_lock);
   if (get_data_seq (client, channel) != 0) {
     GST_WARNING ("already a queued data message for channel %d", channel);
+    priv->dropped_messages++;
     g_mutex_unlock (&priv->send_lock);
     return FALSE;
   }
@@ -1193,6 +1202,8 @@ do_send_data (GstBuffer * buffer, guint8 channel, GstRTSPClient * client)
   } else if (priv->send_func) {
     ret = priv->send_func (client, &message, FALSE, priv->send_data);
   }
+  if (!ret)
+    priv->dropped_messages++;
   g_mutex_unlock (&priv->send_lock);
 
   gst_rtsp_message_unset (&message);
@@ -1223,11 +1234,13 @@ do_send_data_list (GstBufferList * buffer_list, guint8 channel,
   GstRTSPClientPrivate *priv = client->priv;
   gboolean ret = TRUE;
   guint i, n = gst_buffer_list_length (buffer_list);
+  guint n_dropped = n;
   GstRTSPMessage *messages;
 
   g_mutex_lock (&priv->send_lock);
   if (get_data_seq (client, channel) != 0) {
     GST_WARNING ("already a queued data message for channel %d", channel);
+    priv->dropped_messages += n;
     g_mutex_unlock (&priv->send_lock);
     return FALSE;
   }
@@ -1246,10 +1259,14 @@ do_send_data_list (GstBufferList * buffer_list, guint8 channel,
   } else if (priv->send_func) {
     for (i = 0; i < n; i++) {
       ret = priv->send_func (client, &messages[i], FALSE, priv->send_data);
-      if (!ret)
+      if (!ret) {
+        n_dropped = n - i;
         break;
+      }
     }
   }
+  if (!ret)
+    priv->dropped_messages += n_dropped;
   g_mutex_unlock (&priv->send_lock);
 
   for (i = 0; i < n; i++) {
@@ -4871,6 +4888,68 @@ gst_rtsp_client_get_stream_transport (GstRTSPClient * self, guint8 channel)
       GINT_TO_POINTER ((gint) channel));
 }
 
+/**
+ * gst_rtsp_client_get_stats:
+ * @client: a #GstRTSPClient
+ *
+ * Get statistics about the interleaved data sent to @client over its RTSP
+ * connection. The returned structure contains the following fields:
+ *
+ *  * "backlog-bytes" (guint64): payload bytes queued on the connection
+ *    that were not written to the socket yet
+ *  * "sent-messages" (guint64): number of data messages written
+ *  * "sent-bytes" (guint64): payload bytes written
+ *  * "dropped-messages" (guint64): number of data messages that could not
+ *    be sent, for example because the connection backlog was full
+ *
+ * Returns: (transfer full): a #GstStructure with the statistics
+ *
+ * Since: 1.22
+ */
+GstStructure *
+gst_rtsp_client_get_stats (GstRTSPClient * client)
+{
+  GstRTSPClientPrivate *priv;
+  GstStructure *s;
+
+  g_return_val_if_fail (GST_IS_RTSP_CLIENT (client), NULL);
+
+  priv = client->priv;
+
+  g_mutex_lock (&priv->send_lock);
+  s = gst_structure_new ("application/x-rtsp-client-stats",
+      "backlog-bytes", G_TYPE_UINT64, priv->backlog_bytes,
+      "sent-messages", G_TYPE_UINT64, priv->sent_messages,
+      "sent-bytes", G_TYPE_UINT64, priv->sent_bytes,
+      "dropped-messages", G_TYPE_UINT64, priv->dropped_messages, NULL);
+  g_mutex_unlock (&priv->send_lock);
+
+  return s;
+}
+
+/* Returns the payload size of the data messages in @messages */
+static guint64
+get_data_messages_size (GstRTSPMessage * messages, guint n_messages,
+    guint * n_data)
+{
+  guint64 bytes = 0;
+  guint i;
+
+  *n_data = 0;
+  for (i = 0; i < n_messages; i++) {
+    if (gst_rtsp_message_get_type (&messages[i]) != GST_RTSP_MESSAGE_DATA)
+      continue;
+
+    if (messages[i].body_buffer)
+      bytes += gst_buffer_get_size (messages[i].body_buffer);
+    else
+      bytes += messages[i].body_size;
+    (*n_data)++;
+  }
+
+  return bytes;
+}
+
 static gboolean
 do_send_messages (GstRTSPClient * client, GstRTSPMessage * messages,
     guint n_messages, gboolean close, gpointer user_data)
@@ -4892,6 +4971,8 @@ do_send_messages (GstRTSPClient * client, GstRTSPMessage * messages,
     if (gst_rtsp_message_get_type (&messages[i]) == GST_RTSP_MESSAGE_DATA) {
       guint8 channel = 0;
       GstRTSPResult r;
+      guint64 bytes;
+      guint n_data;
 
       /* We assume that all data messages in the list are for the
        * same channel */
@@ -4901,15 +4982,27 @@ do_send_messages (GstRTSPClient * client, GstRTSPMessage * messages,
         goto error;
       }
 
+      bytes = get_data_messages_size (&messages[i], n_messages - i, &n_data);
+
       /* check if the message has been queued for transmission in watch */
       if (id) {
+        DataSeq *data_seq;
+
         /* store the seq number so we can wait until it has been sent */
         GST_DEBUG_OBJECT (client, "wait for message %d, channel %d", id,
             channel);
         set_data_seq (client, channel, id);
+
+        data_seq = get_data_seq_element (client, channel);
+        data_seq->bytes = bytes;
+        data_seq->n_messages = n_data;
+        priv->backlog_bytes += bytes;
       } else {
         GstRTSPStreamTransport *trans;
 
+        priv->sent_bytes += bytes;
+        priv->sent_messages += n_data;
+
         trans =
             g_hash_table_lookup (priv->transports,
             GINT_TO_POINTER ((gint) channel));
@@ -4952,8 +5045,16 @@ message_sent (GstRTSPWatch * watch, guint cseq, gpointer user_data)
   g_mutex_lock (&priv->send_lock);
 
   if (get_data_channel (client, cseq, &channel)) {
+    DataSeq *data_seq = get_data_seq_element (client, channel);
+
     trans = g_hash_table_lookup (priv->transports, GINT_TO_POINTER (channel));
     set_data_seq (client, channel, 0);
+
+    priv->backlog_bytes -= data_seq->bytes;
+    priv->sent_bytes += data_seq->bytes;
+    priv->sent_messages += data_seq->n_messages;
+    data_seq->bytes = 0;
+    data_seq->n_messages = 0;
   }
   g_mutex_unlock (&priv->send_lock);
 
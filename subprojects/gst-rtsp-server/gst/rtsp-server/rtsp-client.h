@@ -284,6 +284,9 @@ GST_RTSP_SERVER_API
 GstRTSPStreamTransport * gst_rtsp_client_get_stream_transport (GstRTSPClient *client,
                                                                guint8 channel);
 
+GST_RTSP_SERVER_API
+GstStructure *         gst_rtsp_client_get_stats         (GstRTSPClient *client);
+
 
 #ifdef G_DEFINE_AUTOPTR_CLEANUP_FUNC
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstRTSPClient, gst_object_unref)
@@ -66,6 +66,10 @@ struct _GstRTSPMediaFactoryPrivate
   gchar *multicast_iface;
   guint max_mcast_ttl;
   gboolean bind_mcast_address;
+  gboolean gop_cache;
+  GstClockTime max_tcp_backlog_duration;
+  guint max_tcp_backlog_size;
+  gboolean drop_tcp_backlog;
   gboolean enable_rtcp;
 
   GstClockTime rtx_time;
@@ -93,6 +97,8 @@ struct _GstRTSPMediaFactoryPrivate
 #define DEFAULT_LATENCY         200
 #define DEFAULT_MAX_MCAST_TTL   255
 #define DEFAULT_BIND_MCAST_ADDRESS FALSE
+#define DEFAULT_GOP_CACHE       FALSE
+#define DEFAULT_DROP_TCP_BACKLOG FALSE
 #define DEFAULT_TRANSPORT_MODE  GST_RTSP_TRANSPORT_MODE_PLAY
 #define DEFAULT_STOP_ON_DISCONNECT TRUE
 #define DEFAULT_DO_RETRANSMISSION FALSE
@@ -117,6 +123,10 @@ enum
   PROP_BIND_MCAST_ADDRESS,
   PROP_DSCP_QOS,
   PROP_ENABLE_RTCP,
+  PROP_GOP_CACHE,
+  PROP_MAX_TCP_BACKLOG_DURATION,
+  PROP_MAX_TCP_BACKLOG_SIZE,
+  PROP_DROP_TCP_BACKLOG,
   PROP_LAST
 };
 
@@ -268,6 +278,64 @@ gst_rtsp_media_factory_class_init (GstRTSPMediaFactoryClass * klass)
           "The IP DSCP field to use", -1, 63,
           DEFAULT_DSCP_QOS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRTSPMediaFactory:gop-cache:
+   *
+   * Whether the created media send the packets since the last keyframe to
+   * new RTP-over-TCP clients first.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_GOP_CACHE,
+      g_param_spec_boolean ("gop-cache", "GOP cache",
+          "Whether to send the packets since the last keyframe to new "
+          "RTP-over-TCP clients", DEFAULT_GOP_CACHE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRTSPMediaFactory:max-tcp-backlog-duration:
+   *
+   * The maximum duration of the backlog of RTP-over-TCP clients of the
+   * created media, see gst_rtsp_media_factory_set_tcp_backlog_limits().
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_MAX_TCP_BACKLOG_DURATION,
+      g_param_spec_uint64 ("max-tcp-backlog-duration",
+          "Max TCP backlog duration",
+          "The maximum duration of the backlog of slow RTP-over-TCP clients",
+          0, G_MAXUINT64, DEFAULT_MAX_TCP_BACKLOG_DURATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRTSPMediaFactory:max-tcp-backlog-size:
+   *
+   * The maximum number of samples in the backlog of RTP-over-TCP clients of
+   * the created media, see gst_rtsp_media_factory_set_tcp_backlog_limits().
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_TCP_BACKLOG_SIZE,
+      g_param_spec_uint ("max-tcp-backlog-size", "Max TCP backlog size",
+          "The maximum number of samples in the backlog of slow RTP-over-TCP "
+          "clients", 0, G_MAXUINT, DEFAULT_MAX_TCP_BACKLOG_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRTSPMediaFactory:drop-tcp-backlog:
+   *
+   * Whether the created media drop the oldest backlogged samples of
+   * RTP-over-TCP clients that can not keep up instead of removing them.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_DROP_TCP_BACKLOG,
+      g_param_spec_boolean ("drop-tcp-backlog", "Drop TCP backlog",
+          "Whether to drop backlogged samples of slow RTP-over-TCP clients "
+          "instead of removing them", DEFAULT_DROP_TCP_BACKLOG,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONSTRUCTED] =
       g_signal_new ("media-constructed", G_TYPE_FROM_CLASS (klass),
       G_SIGNAL_RUN_LAST, G_STRUCT_OFFSET (GstRTSPMediaFactoryClass,
@@ -311,6 +379,10 @@ gst_rtsp_media_factory_init (GstRTSPMediaFactory * factory)
   priv->do_retransmission = DEFAULT_DO_RETRANSMISSION;
   priv->max_mcast_ttl = DEFAULT_MAX_MCAST_TTL;
   priv->bind_mcast_address = DEFAULT_BIND_MCAST_ADDRESS;
+  priv->gop_cache = DEFAULT_GOP_CACHE;
+  priv->max_tcp_backlog_duration = DEFAULT_MAX_TCP_BACKLOG_DURATION;
+  priv->max_tcp_backlog_size = DEFAULT_MAX_TCP_BACKLOG_SIZE;
+  priv->drop_tcp_backlog = DEFAULT_DROP_TCP_BACKLOG;
   priv->enable_rtcp = DEFAULT_ENABLE_RTCP;
   priv->dscp_qos = DEFAULT_DSCP_QOS;
 
@@ -402,6 +474,32 @@ gst_rtsp_media_factory_get_property (GObject * object, guint propid,
       g_value_set_boolean (value,
           gst_rtsp_media_factory_is_enable_rtcp (factory));
       break;
+    case PROP_GOP_CACHE:
+      g_value_set_boolean (value,
+          gst_rtsp_media_factory_get_gop_cache (factory));
+      break;
+    case PROP_MAX_TCP_BACKLOG_DURATION:
+    {
+      GstClockTime max_duration;
+
+      gst_rtsp_media_factory_get_tcp_backlog_limits (factory, &max_duration,
+          NULL);
+      g_value_set_uint64 (value, max_duration);
+      break;
+    }
+    case PROP_MAX_TCP_BACKLOG_SIZE:
+    {
+      guint max_size;
+
+      gst_rtsp_media_factory_get_tcp_backlog_limits (factory, NULL,
+          &max_size);
+      g_value_set_uint (value, max_size);
+      break;
+    }
+    case PROP_DROP_TCP_BACKLOG:
+      g_value_set_boolean (value,
+          gst_rtsp_media_factory_get_drop_tcp_backlog (factory));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -467,6 +565,34 @@ gst_rtsp_media_factory_set_property (GObject * object, guint propid,
       gst_rtsp_media_factory_set_enable_rtcp (factory,
           g_value_get_boolean (value));
       break;
+    case PROP_GOP_CACHE:
+      gst_rtsp_media_factory_set_gop_cache (factory,
+          g_value_get_boolean (value));
+      break;
+    case PROP_MAX_TCP_BACKLOG_DURATION:
+    {
+      guint max_size;
+
+      gst_rtsp_media_factory_get_tcp_backlog_limits (factory, NULL,
+          &max_size);
+      gst_rtsp_media_factory_set_tcp_backlog_limits (factory,
+          g_value_get_uint64 (value), max_size);
+      break;
+    }
+    case PROP_MAX_TCP_BACKLOG_SIZE:
+    {
+      GstClockTime max_duration;
+
+      gst_rtsp_media_factory_get_tcp_backlog_limits (factory, &max_duration,
+          NULL);
+      gst_rtsp_media_factory_set_tcp_backlog_limits (factory, max_duration,
+          g_value_get_uint (value));
+      break;
+    }
+    case PROP_DROP_TCP_BACKLOG:
+      gst_rtsp_media_factory_set_drop_tcp_backlog (factory,
+          g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -1711,6 +1837,169 @@ gst_rtsp_media_factory_is_bind_mcast_address (GstRTSPMediaFactory * factory)
   return result;
 }
 
+/**
+ * gst_rtsp_media_factory_set_gop_cache:
+ * @factory: a #GstRTSPMediaFactory
+ * @enable: whether to enable the GOP cache
+ *
+ * Configure whether the created media keep the packets since the last
+ * keyframe and send them to new RTP-over-TCP clients first, see
+ * gst_rtsp_media_set_gop_cache().
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_media_factory_set_gop_cache (GstRTSPMediaFactory * factory,
+    gboolean enable)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory));
+
+  priv = factory->priv;
+
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  priv->gop_cache = enable;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+}
+
+/**
+ * gst_rtsp_media_factory_get_gop_cache:
+ * @factory: a #GstRTSPMediaFactory
+ *
+ * Check if the created media have the GOP cache enabled.
+ *
+ * Returns: %TRUE if the GOP cache is enabled
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_rtsp_media_factory_get_gop_cache (GstRTSPMediaFactory * factory)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+  gboolean result;
+
+  g_return_val_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory), FALSE);
+
+  priv = factory->priv;
+
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  result = priv->gop_cache;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+
+  return result;
+}
+
+/**
+ * gst_rtsp_media_factory_set_tcp_backlog_limits:
+ * @factory: a #GstRTSPMediaFactory
+ * @max_duration: maximum duration of the backlog
+ * @max_size: maximum number of samples in the backlog
+ *
+ * Configure the limits of the backlog of RTP-over-TCP clients of the created
+ * media, see gst_rtsp_media_set_tcp_backlog_limits().
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_media_factory_set_tcp_backlog_limits (GstRTSPMediaFactory * factory,
+    GstClockTime max_duration, guint max_size)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory));
+  g_return_if_fail (GST_CLOCK_TIME_IS_VALID (max_duration));
+
+  priv = factory->priv;
+
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  priv->max_tcp_backlog_duration = max_duration;
+  priv->max_tcp_backlog_size = max_size;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+}
+
+/**
+ * gst_rtsp_media_factory_get_tcp_backlog_limits:
+ * @factory: a #GstRTSPMediaFactory
+ * @max_duration: (out) (optional): the maximum duration of the backlog
+ * @max_size: (out) (optional): the maximum number of samples in the backlog
+ *
+ * Get the limits of the backlog of RTP-over-TCP clients of the created media.
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_media_factory_get_tcp_backlog_limits (GstRTSPMediaFactory * factory,
+    GstClockTime * max_duration, guint * max_size)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory));
+
+  priv = factory->priv;
+
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  if (max_duration)
+    *max_duration = priv->max_tcp_backlog_duration;
+  if (max_size)
+    *max_size = priv->max_tcp_backlog_size;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+}
+
+/**
+ * gst_rtsp_media_factory_set_drop_tcp_backlog:
+ * @factory: a #GstRTSPMediaFactory
+ * @drop: whether to drop backlogged samples of slow clients
+ *
+ * Configure whether the created media drop the backlogged samples of slow
+ * RTP-over-TCP clients instead of removing them, see
+ * gst_rtsp_media_set_drop_tcp_backlog().
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_media_factory_set_drop_tcp_backlog (GstRTSPMediaFactory * factory,
+    gboolean drop)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory));
+
+  priv = factory->priv;
+
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  priv->drop_tcp_backlog = drop;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+}
+
+/**
+ * gst_rtsp_media_factory_get_drop_tcp_backlog:
+ * @factory: a #GstRTSPMediaFactory
+ *
+ * Check if the created media drop the backlogged samples of slow
+ * RTP-over-TCP clients instead of removing them.
+ *
+ * Returns: %TRUE if backlogged samples are dropped
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_rtsp_media_factory_get_drop_tcp_backlog (GstRTSPMediaFactory * factory)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+  gboolean result;
+
+  g_return_val_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory), FALSE);
+
+  priv = factory->priv;
+
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  result = priv->drop_tcp_backlog;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+
+  return result;
+}
+
 /**
  * gst_rtsp_media_factory_set_enable_rtcp:
  * @factory: a #GstRTSPMediaFactory
@@ -1920,6 +2209,10 @@ default_configure (GstRTSPMediaFactory * factory, GstRTSPMedia * media)
   GstRTSPPublishClockMode publish_clock_mode;
   guint ttl;
   gboolean bind_mcast;
+  gboolean gop_cache;
+  GstClockTime max_tcp_backlog_duration;
+  guint max_tcp_backlog_size;
+  gboolean drop_tcp_backlog;
 
   /* configure the sharedness */
   GST_RTSP_MEDIA_FACTORY_LOCK (factory);
@@ -1938,6 +2231,10 @@ default_configure (GstRTSPMediaFactory * factory, GstRTSPMedia * media)
   publish_clock_mode = priv->publish_clock_mode;
   ttl = priv->max_mcast_ttl;
   bind_mcast = priv->bind_mcast_address;
+  gop_cache = priv->gop_cache;
+  max_tcp_backlog_duration = priv->max_tcp_backlog_duration;
+  max_tcp_backlog_size = priv->max_tcp_backlog_size;
+  drop_tcp_backlog = priv->drop_tcp_backlog;
   GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
 
   gst_rtsp_media_set_suspend_mode (media, suspend_mode);
@@ -1955,6 +2252,10 @@ default_configure (GstRTSPMediaFactory * factory, GstRTSPMedia * media)
   gst_rtsp_media_set_publish_clock_mode (media, publish_clock_mode);
   gst_rtsp_media_set_max_mcast_ttl (media, ttl);
   gst_rtsp_media_set_bind_mcast_address (media, bind_mcast);
+  gst_rtsp_media_set_gop_cache (media, gop_cache);
+  gst_rtsp_media_set_tcp_backlog_limits (media, max_tcp_backlog_duration,
+      max_tcp_backlog_size);
+  gst_rtsp_media_set_drop_tcp_backlog (media, drop_tcp_backlog);
 
   if (clock) {
     gst_rtsp_media_set_clock (media, clock);
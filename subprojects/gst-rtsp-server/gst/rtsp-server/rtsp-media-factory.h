@@ -252,6 +252,27 @@ void                  gst_rtsp_media_factory_set_bind_mcast_address (GstRTSPMedi
 GST_RTSP_SERVER_API
 gboolean              gst_rtsp_media_factory_is_bind_mcast_address (GstRTSPMediaFactory * factory);
 
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_factory_set_gop_cache (GstRTSPMediaFactory * factory,
+                                                            gboolean enable);
+GST_RTSP_SERVER_API
+gboolean              gst_rtsp_media_factory_get_gop_cache (GstRTSPMediaFactory * factory);
+
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_factory_set_tcp_backlog_limits (GstRTSPMediaFactory * factory,
+                                                                     GstClockTime max_duration,
+                                                                     guint max_size);
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_factory_get_tcp_backlog_limits (GstRTSPMediaFactory * factory,
+                                                                     GstClockTime * max_duration,
+                                                                     guint * max_size);
+
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_factory_set_drop_tcp_backlog (GstRTSPMediaFactory * factory,
+                                                                   gboolean drop);
+GST_RTSP_SERVER_API
+gboolean              gst_rtsp_media_factory_get_drop_tcp_backlog (GstRTSPMediaFactory * factory);
+
 GST_RTSP_SERVER_API
 void                  gst_rtsp_media_factory_set_dscp_qos (GstRTSPMediaFactory * factory,
                                                            gint dscp_qos);
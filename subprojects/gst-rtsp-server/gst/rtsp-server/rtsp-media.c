@@ -112,6 +112,10 @@ struct _GstRTSPMediaPrivate
   gchar *multicast_iface;
   guint max_mcast_ttl;
   gboolean bind_mcast_address;
+  gboolean gop_cache;
+  GstClockTime max_tcp_backlog_duration;
+  guint max_tcp_backlog_size;
+  gboolean drop_tcp_backlog;
   gboolean enable_rtcp;
   gboolean blocked;
   GstRTSPTransportMode transport_mode;
@@ -179,6 +183,8 @@ struct _GstRTSPMediaPrivate
 #define DEFAULT_STOP_ON_DISCONNECT TRUE
 #define DEFAULT_MAX_MCAST_TTL   255
 #define DEFAULT_BIND_MCAST_ADDRESS FALSE
+#define DEFAULT_GOP_CACHE       FALSE
+#define DEFAULT_DROP_TCP_BACKLOG FALSE
 #define DEFAULT_DO_RATE_CONTROL TRUE
 #define DEFAULT_ENABLE_RTCP     TRUE
 
@@ -206,6 +212,10 @@ enum
   PROP_MAX_MCAST_TTL,
   PROP_BIND_MCAST_ADDRESS,
   PROP_DSCP_QOS,
+  PROP_GOP_CACHE,
+  PROP_MAX_TCP_BACKLOG_DURATION,
+  PROP_MAX_TCP_BACKLOG_SIZE,
+  PROP_DROP_TCP_BACKLOG,
   PROP_LAST
 };
 
@@ -421,6 +431,65 @@ gst_rtsp_media_class_init (GstRTSPMediaClass * klass)
           "The IP DSCP field to use for each related stream", -1, 63,
           DEFAULT_DSCP_QOS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRTSPMedia:gop-cache:
+   *
+   * Whether the streams keep the packets since the last keyframe and send
+   * them to new RTP-over-TCP clients first.
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_GOP_CACHE,
+      g_param_spec_boolean ("gop-cache", "GOP cache",
+          "Whether to send the packets since the last keyframe to new "
+          "RTP-over-TCP clients", DEFAULT_GOP_CACHE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRTSPMedia:max-tcp-backlog-duration:
+   *
+   * The maximum duration of the backlog of RTP-over-TCP clients that can not
+   * keep up, see gst_rtsp_media_set_tcp_backlog_limits().
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_MAX_TCP_BACKLOG_DURATION,
+      g_param_spec_uint64 ("max-tcp-backlog-duration",
+          "Max TCP backlog duration",
+          "The maximum duration of the backlog of slow RTP-over-TCP clients",
+          0, G_MAXUINT64, DEFAULT_MAX_TCP_BACKLOG_DURATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRTSPMedia:max-tcp-backlog-size:
+   *
+   * The maximum number of samples in the backlog of RTP-over-TCP clients
+   * that can not keep up, see gst_rtsp_media_set_tcp_backlog_limits().
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_TCP_BACKLOG_SIZE,
+      g_param_spec_uint ("max-tcp-backlog-size", "Max TCP backlog size",
+          "The maximum number of samples in the backlog of slow RTP-over-TCP "
+          "clients", 0, G_MAXUINT, DEFAULT_MAX_TCP_BACKLOG_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRTSPMedia:drop-tcp-backlog:
+   *
+   * Whether to drop the oldest backlogged samples of RTP-over-TCP clients
+   * that can not keep up instead of removing them, see
+   * gst_rtsp_media_set_drop_tcp_backlog().
+   *
+   * Since: 1.22
+   */
+  g_object_class_install_property (gobject_class, PROP_DROP_TCP_BACKLOG,
+      g_param_spec_boolean ("drop-tcp-backlog", "Drop TCP backlog",
+          "Whether to drop backlogged samples of slow RTP-over-TCP clients "
+          "instead of removing them", DEFAULT_DROP_TCP_BACKLOG,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_rtsp_media_signals[SIGNAL_NEW_STREAM] =
       g_signal_new ("new-stream", G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
       G_STRUCT_OFFSET (GstRTSPMediaClass, new_stream), NULL, NULL, NULL,
@@ -493,6 +562,10 @@ gst_rtsp_media_init (GstRTSPMedia * media)
   priv->do_retransmission = DEFAULT_DO_RETRANSMISSION;
   priv->max_mcast_ttl = DEFAULT_MAX_MCAST_TTL;
   priv->bind_mcast_address = DEFAULT_BIND_MCAST_ADDRESS;
+  priv->gop_cache = DEFAULT_GOP_CACHE;
+  priv->max_tcp_backlog_duration = DEFAULT_MAX_TCP_BACKLOG_DURATION;
+  priv->max_tcp_backlog_size = DEFAULT_MAX_TCP_BACKLOG_SIZE;
+  priv->drop_tcp_backlog = DEFAULT_DROP_TCP_BACKLOG;
   priv->enable_rtcp = DEFAULT_ENABLE_RTCP;
   priv->do_rate_control = DEFAULT_DO_RATE_CONTROL;
   priv->dscp_qos = DEFAULT_DSCP_QOS;
@@ -594,6 +667,28 @@ gst_rtsp_media_get_property (GObject * object, guint propid,
     case PROP_DSCP_QOS:
       g_value_set_int (value, gst_rtsp_media_get_dscp_qos (media));
       break;
+    case PROP_GOP_CACHE:
+      g_value_set_boolean (value, gst_rtsp_media_get_gop_cache (media));
+      break;
+    case PROP_MAX_TCP_BACKLOG_DURATION:
+    {
+      GstClockTime max_duration;
+
+      gst_rtsp_media_get_tcp_backlog_limits (media, &max_duration, NULL);
+      g_value_set_uint64 (value, max_duration);
+      break;
+    }
+    case PROP_MAX_TCP_BACKLOG_SIZE:
+    {
+      guint max_size;
+
+      gst_rtsp_media_get_tcp_backlog_limits (media, NULL, &max_size);
+      g_value_set_uint (value, max_size);
+      break;
+    }
+    case PROP_DROP_TCP_BACKLOG:
+      g_value_set_boolean (value, gst_rtsp_media_get_drop_tcp_backlog (media));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -657,6 +752,30 @@ gst_rtsp_media_set_property (GObject * object, guint propid,
     case PROP_DSCP_QOS:
       gst_rtsp_media_set_dscp_qos (media, g_value_get_int (value));
       break;
+    case PROP_GOP_CACHE:
+      gst_rtsp_media_set_gop_cache (media, g_value_get_boolean (value));
+      break;
+    case PROP_MAX_TCP_BACKLOG_DURATION:
+    {
+      guint max_size;
+
+      gst_rtsp_media_get_tcp_backlog_limits (media, NULL, &max_size);
+      gst_rtsp_media_set_tcp_backlog_limits (media,
+          g_value_get_uint64 (value), max_size);
+      break;
+    }
+    case PROP_MAX_TCP_BACKLOG_SIZE:
+    {
+      GstClockTime max_duration;
+
+      gst_rtsp_media_get_tcp_backlog_limits (media, &max_duration, NULL);
+      gst_rtsp_media_set_tcp_backlog_limits (media, max_duration,
+          g_value_get_uint (value));
+      break;
+    }
+    case PROP_DROP_TCP_BACKLOG:
+      gst_rtsp_media_set_drop_tcp_backlog (media, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -2106,6 +2225,182 @@ gst_rtsp_media_is_bind_mcast_address (GstRTSPMedia * media)
   return result;
 }
 
+/**
+ * gst_rtsp_media_set_gop_cache:
+ * @media: a #GstRTSPMedia
+ * @enable: whether to enable the GOP cache
+ *
+ * Enable or disable the GOP cache of the streams of @media, see
+ * gst_rtsp_stream_set_gop_cache(). This is mostly useful for shared live
+ * media, where clients joining later would otherwise have to wait for the
+ * next keyframe.
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_media_set_gop_cache (GstRTSPMedia * media, gboolean enable)
+{
+  GstRTSPMediaPrivate *priv;
+  guint i;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA (media));
+
+  priv = media->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->gop_cache = enable;
+  for (i = 0; i < priv->streams->len; i++) {
+    GstRTSPStream *stream = g_ptr_array_index (priv->streams, i);
+    gst_rtsp_stream_set_gop_cache (stream, enable);
+  }
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_rtsp_media_get_gop_cache:
+ * @media: a #GstRTSPMedia
+ *
+ * Check if the GOP cache is enabled for the streams of @media.
+ *
+ * Returns: %TRUE if the GOP cache is enabled
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_rtsp_media_get_gop_cache (GstRTSPMedia * media)
+{
+  GstRTSPMediaPrivate *priv;
+  gboolean result;
+
+  g_return_val_if_fail (GST_IS_RTSP_MEDIA (media), FALSE);
+
+  priv = media->priv;
+
+  g_mutex_lock (&priv->lock);
+  result = priv->gop_cache;
+  g_mutex_unlock (&priv->lock);
+
+  return result;
+}
+
+/**
+ * gst_rtsp_media_set_tcp_backlog_limits:
+ * @media: a #GstRTSPMedia
+ * @max_duration: maximum duration of the backlog
+ * @max_size: maximum number of samples in the backlog
+ *
+ * Set the limits of the backlog of RTP-over-TCP clients that can not keep
+ * up with the streams of @media, see gst_rtsp_stream_set_tcp_backlog_limits().
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_media_set_tcp_backlog_limits (GstRTSPMedia * media,
+    GstClockTime max_duration, guint max_size)
+{
+  GstRTSPMediaPrivate *priv;
+  guint i;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA (media));
+  g_return_if_fail (GST_CLOCK_TIME_IS_VALID (max_duration));
+
+  priv = media->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->max_tcp_backlog_duration = max_duration;
+  priv->max_tcp_backlog_size = max_size;
+  for (i = 0; i < priv->streams->len; i++) {
+    GstRTSPStream *stream = g_ptr_array_index (priv->streams, i);
+    gst_rtsp_stream_set_tcp_backlog_limits (stream, max_duration, max_size);
+  }
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_rtsp_media_get_tcp_backlog_limits:
+ * @media: a #GstRTSPMedia
+ * @max_duration: (out) (optional): the maximum duration of the backlog
+ * @max_size: (out) (optional): the maximum number of samples in the backlog
+ *
+ * Get the limits of the backlog of RTP-over-TCP clients of @media.
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_media_get_tcp_backlog_limits (GstRTSPMedia * media,
+    GstClockTime * max_duration, guint * max_size)
+{
+  GstRTSPMediaPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA (media));
+
+  priv = media->priv;
+
+  g_mutex_lock (&priv->lock);
+  if (max_duration)
+    *max_duration = priv->max_tcp_backlog_duration;
+  if (max_size)
+    *max_size = priv->max_tcp_backlog_size;
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_rtsp_media_set_drop_tcp_backlog:
+ * @media: a #GstRTSPMedia
+ * @drop: whether to drop backlogged samples of slow clients
+ *
+ * Configure what happens to RTP-over-TCP clients of @media whose backlog
+ * exceeds its limits, see gst_rtsp_stream_set_drop_tcp_backlog().
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_media_set_drop_tcp_backlog (GstRTSPMedia * media, gboolean drop)
+{
+  GstRTSPMediaPrivate *priv;
+  guint i;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA (media));
+
+  priv = media->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->drop_tcp_backlog = drop;
+  for (i = 0; i < priv->streams->len; i++) {
+    GstRTSPStream *stream = g_ptr_array_index (priv->streams, i);
+    gst_rtsp_stream_set_drop_tcp_backlog (stream, drop);
+  }
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_rtsp_media_get_drop_tcp_backlog:
+ * @media: a #GstRTSPMedia
+ *
+ * Check if the backlogged samples of slow RTP-over-TCP clients of @media are
+ * dropped instead of removing the clients.
+ *
+ * Returns: %TRUE if backlogged samples are dropped
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_rtsp_media_get_drop_tcp_backlog (GstRTSPMedia * media)
+{
+  GstRTSPMediaPrivate *priv;
+  gboolean result;
+
+  g_return_val_if_fail (GST_IS_RTSP_MEDIA (media), FALSE);
+
+  priv = media->priv;
+
+  g_mutex_lock (&priv->lock);
+  result = priv->drop_tcp_backlog;
+  g_mutex_unlock (&priv->lock);
+
+  return result;
+}
+
 void
 gst_rtsp_media_set_enable_rtcp (GstRTSPMedia * media, gboolean enable)
 {
@@ -2441,6 +2736,10 @@ gst_rtsp_media_create_stream (GstRTSPMedia * media, GstElement * payloader,
   gst_rtsp_stream_set_multicast_iface (stream, priv->multicast_iface);
   gst_rtsp_stream_set_max_mcast_ttl (stream, priv->max_mcast_ttl);
   gst_rtsp_stream_set_bind_mcast_address (stream, priv->bind_mcast_address);
+  gst_rtsp_stream_set_gop_cache (stream, priv->gop_cache);
+  gst_rtsp_stream_set_tcp_backlog_limits (stream,
+      priv->max_tcp_backlog_duration, priv->max_tcp_backlog_size);
+  gst_rtsp_stream_set_drop_tcp_backlog (stream, priv->drop_tcp_backlog);
   gst_rtsp_stream_set_enable_rtcp (stream, priv->enable_rtcp);
   gst_rtsp_stream_set_profiles (stream, priv->profiles);
   gst_rtsp_stream_set_protocols (stream, priv->protocols);
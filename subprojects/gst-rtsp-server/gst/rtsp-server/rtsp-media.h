@@ -324,6 +324,25 @@ void                  gst_rtsp_media_set_bind_mcast_address  (GstRTSPMedia *medi
 GST_RTSP_SERVER_API
 gboolean              gst_rtsp_media_is_bind_mcast_address  (GstRTSPMedia *media);
 
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_set_gop_cache    (GstRTSPMedia *media, gboolean enable);
+GST_RTSP_SERVER_API
+gboolean              gst_rtsp_media_get_gop_cache    (GstRTSPMedia *media);
+
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_set_tcp_backlog_limits (GstRTSPMedia *media,
+                                                             GstClockTime max_duration,
+                                                             guint max_size);
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_get_tcp_backlog_limits (GstRTSPMedia *media,
+                                                             GstClockTime *max_duration,
+                                                             guint *max_size);
+
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_set_drop_tcp_backlog (GstRTSPMedia *media, gboolean drop);
+GST_RTSP_SERVER_API
+gboolean              gst_rtsp_media_get_drop_tcp_backlog (GstRTSPMedia *media);
+
 GST_RTSP_SERVER_API
 void                  gst_rtsp_media_set_dscp_qos (GstRTSPMedia * media, gint dscp_qos);
 GST_RTSP_SERVER_API
@@ -30,6 +30,10 @@ G_BEGIN_DECLS
 
 typedef gboolean (*GstRTSPBackPressureFunc) (guint8 channel, gpointer user_data);
 
+/* default limits after which a TCP transport is considered too slow */
+#define DEFAULT_MAX_TCP_BACKLOG_DURATION (10 * GST_SECOND)
+#define DEFAULT_MAX_TCP_BACKLOG_SIZE 100
+
 gboolean                 gst_rtsp_stream_transport_backlog_push  (GstRTSPStreamTransport *trans,
                                                                   GstBuffer *buffer,
                                                                   GstBufferList *buffer_list,
@@ -40,8 +44,22 @@ gboolean                 gst_rtsp_stream_transport_backlog_pop   (GstRTSPStreamT
                                                                   GstBufferList **buffer_list,
                                                                   gboolean *is_rtp);
 
+gboolean                 gst_rtsp_stream_transport_backlog_pop_batch (GstRTSPStreamTransport *trans,
+                                                                  guint max_buffers,
+                                                                  GstBuffer **buffer,
+                                                                  GstBufferList **buffer_list,
+                                                                  gboolean *is_rtp);
+
+guint                    gst_rtsp_stream_transport_backlog_drop  (GstRTSPStreamTransport *trans);
+
+gboolean                 gst_rtsp_stream_transport_backlog_peek_is_rtp (GstRTSPStreamTransport *trans);
+
 gboolean                 gst_rtsp_stream_transport_backlog_is_empty (GstRTSPStreamTransport *trans);
 
+void                     gst_rtsp_stream_transport_set_backlog_limits (GstRTSPStreamTransport *trans,
+                                                                  GstClockTime max_duration,
+                                                                  guint max_size);
+
 void                     gst_rtsp_stream_transport_clear_backlog (GstRTSPStreamTransport * trans);
 
 void                     gst_rtsp_stream_transport_lock_backlog  (GstRTSPStreamTransport * trans);
@@ -58,6 +76,13 @@ gboolean                 gst_rtsp_stream_transport_check_back_pressure (GstRTSPS
 
 gboolean                 gst_rtsp_stream_is_tcp_receiver (GstRTSPStream * stream);
 
+gboolean                 gst_rtsp_stream_get_transport_rtpinfo (GstRTSPStream * stream,
+                                                                  GstRTSPStreamTransport * trans,
+                                                                  guint * rtptime,
+                                                                  guint * seq,
+                                                                  guint * clock_rate,
+                                                                  GstClockTime * running_time);
+
 void                     gst_rtsp_media_set_enable_rtcp (GstRTSPMedia *media, gboolean enable);
 void                     gst_rtsp_stream_set_enable_rtcp (GstRTSPStream *stream, gboolean enable);
 
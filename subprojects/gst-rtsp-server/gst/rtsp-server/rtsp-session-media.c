@@ -41,6 +41,7 @@
 #include <string.h>
 
 #include "rtsp-session.h"
+#include "rtsp-server-internal.h"
 
 struct _GstRTSPSessionMediaPrivate
 {
@@ -288,7 +289,8 @@ gst_rtsp_session_media_get_rtpinfo (GstRTSPSessionMedia * media)
     stream = gst_rtsp_stream_transport_get_stream (transport);
     if (!gst_rtsp_stream_is_sender (stream))
       continue;
-    if (!gst_rtsp_stream_get_rtpinfo (stream, NULL, NULL, NULL, &running_time))
+    if (!gst_rtsp_stream_get_transport_rtpinfo (stream, transport, NULL, NULL,
+            NULL, &running_time))
       continue;
 
     GST_LOG_OBJECT (media, "running time of %d stream: %" GST_TIME_FORMAT, i,
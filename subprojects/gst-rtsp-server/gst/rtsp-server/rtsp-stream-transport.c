@@ -88,13 +88,13 @@ struct _GstRTSPStreamTransportPrivate
 
   /* TCP backlog */
   GstClockTime first_rtp_timestamp;
+  GstClockTime last_rtp_timestamp;
   GstQueueArray *items;
   GRecMutex backlog_lock;
+  GstClockTime max_backlog_duration;
+  guint max_backlog_size;
 };
 
-#define MAX_BACKLOG_DURATION (10 * GST_SECOND)
-#define MAX_BACKLOG_SIZE 100
-
 typedef struct
 {
   GstBuffer *buffer;
@@ -143,6 +143,9 @@ gst_rtsp_stream_transport_init (GstRTSPStreamTransport * trans)
   trans->priv = gst_rtsp_stream_transport_get_instance_private (trans);
   trans->priv->items = gst_queue_array_new_for_struct (sizeof (BackLogItem), 0);
   trans->priv->first_rtp_timestamp = GST_CLOCK_TIME_NONE;
+  trans->priv->last_rtp_timestamp = GST_CLOCK_TIME_NONE;
+  trans->priv->max_backlog_duration = DEFAULT_MAX_TCP_BACKLOG_DURATION;
+  trans->priv->max_backlog_size = DEFAULT_MAX_TCP_BACKLOG_SIZE;
   gst_queue_array_set_clear_func (trans->priv->items,
       (GDestroyNotify) clear_backlog_item);
   g_rec_mutex_init (&trans->priv->backlog_lock);
@@ -515,8 +518,8 @@ gst_rtsp_stream_transport_get_rtpinfo (GstRTSPStreamTransport * trans,
 
   if (!gst_rtsp_stream_is_sender (priv->stream))
     return NULL;
-  if (!gst_rtsp_stream_get_rtpinfo (priv->stream, &rtptime, &seq, &clock_rate,
-          &running_time))
+  if (!gst_rtsp_stream_get_transport_rtpinfo (priv->stream, trans, &rtptime,
+          &seq, &clock_rate, &running_time))
     return NULL;
 
   GST_DEBUG ("RTP time %u, seq %u, rate %u, running-time %" GST_TIME_FORMAT,
@@ -870,14 +873,31 @@ get_first_backlog_timestamp (GstRTSPStreamTransport * trans)
   return ret;
 }
 
+static gboolean
+backlog_is_full (GstRTSPStreamTransportPrivate * priv)
+{
+  GstClockTimeDiff queue_duration;
+
+  if (priv->first_rtp_timestamp == GST_CLOCK_TIME_NONE)
+    return FALSE;
+
+  queue_duration =
+      GST_CLOCK_DIFF (priv->first_rtp_timestamp, priv->last_rtp_timestamp);
+
+  g_assert (queue_duration >= 0);
+
+  return queue_duration > priv->max_backlog_duration &&
+      gst_queue_array_get_length (priv->items) > priv->max_backlog_size;
+}
+
 /* Not MT-safe, caller should ensure consistent locking (see
  * gst_rtsp_stream_transport_lock_backlog()). Ownership
- * of @buffer and @buffer_list is transfered to the transport */
+ * of @buffer and @buffer_list is transfered to the transport.
+ * Returns %FALSE when the backlog exceeds its limits after adding the item */
 gboolean
 gst_rtsp_stream_transport_backlog_push (GstRTSPStreamTransport * trans,
     GstBuffer * buffer, GstBufferList * buffer_list, gboolean is_rtp)
 {
-  gboolean ret = TRUE;
   BackLogItem item = { 0, };
   GstClockTime item_timestamp;
   GstRTSPStreamTransportPrivate *priv;
@@ -892,26 +912,60 @@ gst_rtsp_stream_transport_backlog_push (GstRTSPStreamTransport * trans,
 
   gst_queue_array_push_tail_struct (priv->items, &item);
 
-  item_timestamp = get_backlog_item_timestamp (&item);
+  if (!is_rtp)
+    return TRUE;
 
-  if (is_rtp && priv->first_rtp_timestamp != GST_CLOCK_TIME_NONE) {
-    GstClockTimeDiff queue_duration;
+  item_timestamp = get_backlog_item_timestamp (&item);
 
+  if (priv->first_rtp_timestamp != GST_CLOCK_TIME_NONE) {
     g_assert (GST_CLOCK_TIME_IS_VALID (item_timestamp));
+  } else {
+    priv->first_rtp_timestamp = item_timestamp;
+  }
+  priv->last_rtp_timestamp = item_timestamp;
 
-    queue_duration = GST_CLOCK_DIFF (priv->first_rtp_timestamp, item_timestamp);
+  return !backlog_is_full (priv);
+}
 
-    g_assert (queue_duration >= 0);
+/* Not MT-safe, caller should ensure consistent locking (see
+ * gst_rtsp_stream_transport_lock_backlog()). Drops the oldest items until
+ * the backlog is within its limits again and returns how many were dropped */
+guint
+gst_rtsp_stream_transport_backlog_drop (GstRTSPStreamTransport * trans)
+{
+  guint dropped = 0;
 
-    if (queue_duration > MAX_BACKLOG_DURATION &&
-        gst_queue_array_get_length (priv->items) > MAX_BACKLOG_SIZE) {
-      ret = FALSE;
-    }
-  } else if (is_rtp) {
-    priv->first_rtp_timestamp = item_timestamp;
+  while (backlog_is_full (trans->priv)) {
+    gst_rtsp_stream_transport_backlog_pop (trans, NULL, NULL, NULL);
+    dropped++;
   }
 
-  return ret;
+  return dropped;
+}
+
+/* Not MT-safe, caller should ensure consistent locking.
+ * See gst_rtsp_stream_transport_lock_backlog() */
+gboolean
+gst_rtsp_stream_transport_backlog_peek_is_rtp (GstRTSPStreamTransport * trans)
+{
+  BackLogItem *item;
+
+  g_return_val_if_fail (!gst_rtsp_stream_transport_backlog_is_empty (trans),
+      FALSE);
+
+  item = (BackLogItem *) gst_queue_array_peek_head_struct (trans->priv->items);
+
+  return item->is_rtp;
+}
+
+/* Not MT-safe, caller should ensure consistent locking.
+ * See gst_rtsp_stream_transport_lock_backlog() */
+void
+gst_rtsp_stream_transport_set_backlog_limits (GstRTSPStreamTransport * trans,
+    GstClockTime max_duration, guint max_size)
+{
+  trans->priv->max_backlog_duration = max_duration;
+  trans->priv->max_backlog_size = max_size;
 }
 
 /* Not MT-safe, caller should ensure consistent locking (see
@@ -950,6 +1004,75 @@ gst_rtsp_stream_transport_backlog_pop (GstRTSPStreamTransport * trans,
   return TRUE;
 }
 
+/* Not MT-safe, caller should ensure consistent locking (see
+ * gst_rtsp_stream_transport_lock_backlog()). Like
+ * gst_rtsp_stream_transport_backlog_pop(), but also pops the following items
+ * of the same kind, as long as the total stays below @max_buffers, and
+ * returns them all in @buffer_list so they can be sent as one batch */
+gboolean
+gst_rtsp_stream_transport_backlog_pop_batch (GstRTSPStreamTransport * trans,
+    guint max_buffers, GstBuffer ** buffer, GstBufferList ** buffer_list,
+    gboolean * is_rtp)
+{
+  GstRTSPStreamTransportPrivate *priv;
+  GstBufferList *batch = NULL;
+  guint n_buffers;
+
+  g_return_val_if_fail (buffer != NULL && buffer_list != NULL
+      && is_rtp != NULL, FALSE);
+
+  if (!gst_rtsp_stream_transport_backlog_pop (trans, buffer, buffer_list,
+          is_rtp))
+    return FALSE;
+
+  priv = trans->priv;
+  n_buffers = *buffer ? 1 : gst_buffer_list_length (*buffer_list);
+
+  while (!gst_rtsp_stream_transport_backlog_is_empty (trans)) {
+    BackLogItem *item;
+    guint i, n;
+
+    item = (BackLogItem *) gst_queue_array_peek_head_struct (priv->items);
+    if (item->is_rtp != *is_rtp)
+      break;
+
+    n = item->buffer ? 1 : gst_buffer_list_length (item->buffer_list);
+    if (n_buffers + n > max_buffers)
+      break;
+
+    if (batch == NULL) {
+      if (*buffer) {
+        batch = gst_buffer_list_new_sized (max_buffers);
+        gst_buffer_list_add (batch, *buffer);
+        *buffer = NULL;
+      } else {
+        /* the list is usually shared with the other transports */
+        batch = gst_buffer_list_make_writable (*buffer_list);
+        *buffer_list = NULL;
+      }
+    }
+
+    item = (BackLogItem *) gst_queue_array_pop_head_struct (priv->items);
+    if (item->buffer) {
+      gst_buffer_list_add (batch, item->buffer);
+    } else {
+      for (i = 0; i < n; i++)
+        gst_buffer_list_add (batch,
+            gst_buffer_ref (gst_buffer_list_get (item->buffer_list, i)));
+      gst_buffer_list_unref (item->buffer_list);
+    }
+    n_buffers += n;
+  }
+
+  if (batch) {
+    GST_LOG_OBJECT (trans, "batched %u buffers from the backlog", n_buffers);
+    *buffer_list = batch;
+    priv->first_rtp_timestamp = get_first_backlog_timestamp (trans);
+  }
+
+  return TRUE;
+}
+
 /* Not MT-safe, caller should ensure consistent locking.
  * See gst_rtsp_stream_transport_lock_backlog() */
 gboolean
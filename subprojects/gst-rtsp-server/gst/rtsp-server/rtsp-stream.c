@@ -184,10 +184,24 @@ struct _GstRTSPStreamPrivate
   GList *transports;
   guint transports_cookie;
   GPtrArray *tr_cache;
+  /* TCP transports of tr_cache that a sample can be sent to directly */
+  GPtrArray *tr_ready;
   guint tr_cache_cookie;
   guint n_tcp_transports;
   gboolean have_buffer[2];
 
+  /* limits of the TCP transports backlog */
+  GstClockTime max_tcp_backlog_duration;
+  guint max_tcp_backlog_size;
+  gboolean drop_tcp_backlog;
+
+  /* GOP cache: the RTP samples since the last keyframe, sent to new TCP
+   * transports so that they can start decoding right away */
+  gboolean gop_cache_enabled;
+  GQueue gop_cache;
+  /* GopBurst of the TCP transports that still have to get the GOP cache */
+  GList *gop_burst;
+
   gint dscp_qos;
 
   /* Sending logic for TCP */
@@ -240,6 +254,11 @@ struct _GstRTSPStreamPrivate
 #define DEFAULT_BIND_MCAST_ADDRESS FALSE
 #define DEFAULT_DO_RATE_CONTROL TRUE
 #define DEFAULT_ENABLE_RTCP TRUE
+#define DEFAULT_DROP_TCP_BACKLOG FALSE
+#define DEFAULT_GOP_CACHE       FALSE
+
+/* maximum number of backlogged packets sent to a TCP client in one go */
+#define MAX_TCP_BATCH_BUFFERS 64
 
 enum
 {
@@ -340,6 +359,11 @@ gst_rtsp_stream_init (GstRTSPStream * stream)
   priv->bind_mcast_address = DEFAULT_BIND_MCAST_ADDRESS;
   priv->do_rate_control = DEFAULT_DO_RATE_CONTROL;
   priv->enable_rtcp = DEFAULT_ENABLE_RTCP;
+  priv->max_tcp_backlog_duration = DEFAULT_MAX_TCP_BACKLOG_DURATION;
+  priv->max_tcp_backlog_size = DEFAULT_MAX_TCP_BACKLOG_SIZE;
+  priv->drop_tcp_backlog = DEFAULT_DROP_TCP_BACKLOG;
+  priv->gop_cache_enabled = DEFAULT_GOP_CACHE;
+  g_queue_init (&priv->gop_cache);
 
   g_mutex_init (&priv->lock);
 
@@ -377,6 +401,58 @@ free_mcast_client (gpointer data)
   g_free (client);
 }
 
+/* The samples a new TCP transport gets before the live ones. They are the
+ * GOP cache at the time the RTP-Info for the transport was determined, and
+ * all RTP samples after it until the transport is added */
+typedef struct
+{
+  GstRTSPStreamTransport *trans;
+  GQueue samples;
+  gboolean added;
+} GopBurst;
+
+static void
+gop_burst_free (GopBurst * burst)
+{
+  GstSample *sample;
+
+  while ((sample = g_queue_pop_head (&burst->samples)))
+    gst_sample_unref (sample);
+  g_object_unref (burst->trans);
+  g_free (burst);
+}
+
+static void
+clear_gop_cache (GstRTSPStreamPrivate * priv)
+{
+  GstSample *sample;
+
+  while ((sample = g_queue_pop_head (&priv->gop_cache)))
+    gst_sample_unref (sample);
+}
+
+static void
+clear_gop_bursts (GstRTSPStreamPrivate * priv)
+{
+  g_list_free_full (priv->gop_burst, (GDestroyNotify) gop_burst_free);
+  priv->gop_burst = NULL;
+}
+
+static GList *
+find_gop_burst (GstRTSPStreamPrivate * priv, GstRTSPStreamTransport * trans)
+{
+  GList *walk;
+
+  for (walk = priv->gop_burst; walk; walk = g_list_next (walk)) {
+    GopBurst *burst = walk->data;
+
+    if (burst->trans == trans)
+      return walk;
+  }
+
+  return NULL;
+}
+
 static void
 gst_rtsp_stream_finalize (GObject * obj)
 {
@@ -427,6 +503,9 @@ gst_rtsp_stream_finalize (GObject * obj)
   g_free (priv->multicast_iface);
   g_list_free_full (priv->mcast_clients, (GDestroyNotify) free_mcast_client);
 
+  clear_gop_cache (priv);
+  clear_gop_bursts (priv);
+
   gst_object_unref (priv->payloader);
   if (priv->srcpad)
     gst_object_unref (priv->srcpad);
@@ -2237,6 +2316,186 @@ gst_rtsp_stream_get_max_mcast_ttl (GstRTSPStream * stream)
   return ttl;
 }
 
+/**
+ * gst_rtsp_stream_set_tcp_backlog_limits:
+ * @stream: a #GstRTSPStream
+ * @max_duration: maximum duration of the backlog
+ * @max_size: maximum number of samples in the backlog
+ *
+ * Set the limits of the backlog of RTP-over-TCP clients that can not keep
+ * up with the stream. A client is considered too slow when its backlog
+ * holds more than @max_size samples spanning more than @max_duration.
+ * What happens then is configured with gst_rtsp_stream_set_drop_tcp_backlog().
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_stream_set_tcp_backlog_limits (GstRTSPStream * stream,
+    GstClockTime max_duration, guint max_size)
+{
+  GstRTSPStreamPrivate *priv;
+  GList *walk;
+
+  g_return_if_fail (GST_IS_RTSP_STREAM (stream));
+  g_return_if_fail (GST_CLOCK_TIME_IS_VALID (max_duration));
+
+  priv = stream->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->max_tcp_backlog_duration = max_duration;
+  priv->max_tcp_backlog_size = max_size;
+
+  for (walk = priv->transports; walk; walk = g_list_next (walk)) {
+    GstRTSPStreamTransport *tr = (GstRTSPStreamTransport *) walk->data;
+    const GstRTSPTransport *t = gst_rtsp_stream_transport_get_transport (tr);
+
+    if (t->lower_transport != GST_RTSP_LOWER_TRANS_TCP)
+      continue;
+
+    gst_rtsp_stream_transport_lock_backlog (tr);
+    gst_rtsp_stream_transport_set_backlog_limits (tr, max_duration, max_size);
+    gst_rtsp_stream_transport_unlock_backlog (tr);
+  }
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_rtsp_stream_get_tcp_backlog_limits:
+ * @stream: a #GstRTSPStream
+ * @max_duration: (out) (optional): the maximum duration of the backlog
+ * @max_size: (out) (optional): the maximum number of samples in the backlog
+ *
+ * Get the limits of the backlog of RTP-over-TCP clients.
+ * See gst_rtsp_stream_set_tcp_backlog_limits().
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_stream_get_tcp_backlog_limits (GstRTSPStream * stream,
+    GstClockTime * max_duration, guint * max_size)
+{
+  GstRTSPStreamPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_STREAM (stream));
+
+  priv = stream->priv;
+
+  g_mutex_lock (&priv->lock);
+  if (max_duration)
+    *max_duration = priv->max_tcp_backlog_duration;
+  if (max_size)
+    *max_size = priv->max_tcp_backlog_size;
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_rtsp_stream_set_drop_tcp_backlog:
+ * @stream: a #GstRTSPStream
+ * @drop: whether to drop backlogged samples of slow clients
+ *
+ * Configure what happens to an RTP-over-TCP client whose backlog exceeds the
+ * limits set with gst_rtsp_stream_set_tcp_backlog_limits(). When @drop is
+ * %TRUE, its oldest backlogged samples are dropped until the backlog is
+ * within the limits again. Otherwise, which is the default, the client's
+ * transport is removed from the stream.
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_stream_set_drop_tcp_backlog (GstRTSPStream * stream, gboolean drop)
+{
+  g_return_if_fail (GST_IS_RTSP_STREAM (stream));
+
+  g_mutex_lock (&stream->priv->lock);
+  stream->priv->drop_tcp_backlog = drop;
+  g_mutex_unlock (&stream->priv->lock);
+}
+
+/**
+ * gst_rtsp_stream_get_drop_tcp_backlog:
+ * @stream: a #GstRTSPStream
+ *
+ * Get whether the backlogged samples of slow RTP-over-TCP clients are dropped
+ * instead of removing their transport.
+ *
+ * Returns: %TRUE if backlogged samples are dropped
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_rtsp_stream_get_drop_tcp_backlog (GstRTSPStream * stream)
+{
+  gboolean drop;
+
+  g_return_val_if_fail (GST_IS_RTSP_STREAM (stream), FALSE);
+
+  g_mutex_lock (&stream->priv->lock);
+  drop = stream->priv->drop_tcp_backlog;
+  g_mutex_unlock (&stream->priv->lock);
+
+  return drop;
+}
+
+/**
+ * gst_rtsp_stream_set_gop_cache:
+ * @stream: a #GstRTSPStream
+ * @enable: whether to enable the GOP cache
+ *
+ * Enable or disable the GOP cache of @stream. When enabled, the stream keeps
+ * the RTP packets from the last keyframe onwards and sends them to a new
+ * RTP-over-TCP client before the live packets, so that the client does not
+ * have to wait for the next keyframe to start decoding. The RTP-Info of
+ * the PLAY response of such a client then starts with the first cached
+ * packet. UDP and multicast clients are not affected.
+ *
+ * A keyframe is a packet without the %GST_BUFFER_FLAG_DELTA_UNIT flag. GOPs
+ * that are longer than the maximum duration set with
+ * gst_rtsp_stream_set_tcp_backlog_limits() are not cached.
+ *
+ * Since: 1.22
+ */
+void
+gst_rtsp_stream_set_gop_cache (GstRTSPStream * stream, gboolean enable)
+{
+  GstRTSPStreamPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_STREAM (stream));
+
+  priv = stream->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->gop_cache_enabled = enable;
+  if (!enable) {
+    clear_gop_cache (priv);
+    clear_gop_bursts (priv);
+  }
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_rtsp_stream_get_gop_cache:
+ * @stream: a #GstRTSPStream
+ *
+ * Check if the GOP cache of @stream is enabled.
+ *
+ * Returns: %TRUE if the GOP cache is enabled
+ *
+ * Since: 1.22
+ */
+gboolean
+gst_rtsp_stream_get_gop_cache (GstRTSPStream * stream)
+{
+  gboolean enabled;
+
+  g_return_val_if_fail (GST_IS_RTSP_STREAM (stream), FALSE);
+
+  g_mutex_lock (&stream->priv->lock);
+  enabled = stream->priv->gop_cache_enabled;
+  g_mutex_unlock (&stream->priv->lock);
+
+  return enabled;
+}
+
 /**
  * gst_rtsp_stream_verify_mcast_ttl:
  * @stream: a #GstRTSPStream
@@ -2544,6 +2803,9 @@ clear_tr_cache (GstRTSPStreamPrivate * priv)
   if (priv->tr_cache)
     g_ptr_array_unref (priv->tr_cache);
   priv->tr_cache = NULL;
+  if (priv->tr_ready)
+    g_ptr_array_unref (priv->tr_ready);
+  priv->tr_ready = NULL;
 }
 
 /* With lock taken */
@@ -2617,6 +2879,7 @@ ensure_cached_transports (GstRTSPStream * stream)
 
       g_ptr_array_add (priv->tr_cache, g_object_ref (tr));
     }
+    priv->tr_ready = g_ptr_array_sized_new (priv->tr_cache->len);
     priv->tr_cache_cookie = priv->transports_cookie;
   }
 }
@@ -2630,15 +2893,21 @@ check_transport_backlog (GstRTSPStream * stream, GstRTSPStreamTransport * trans)
 
   gst_rtsp_stream_transport_lock_backlog (trans);
 
-  if (!gst_rtsp_stream_transport_backlog_is_empty (trans)) {
+  /* only send when the connection is done with the previous message of the
+   * same kind, it would be refused otherwise */
+  if (!gst_rtsp_stream_transport_backlog_is_empty (trans) &&
+      !gst_rtsp_stream_transport_check_back_pressure (trans,
+          gst_rtsp_stream_transport_backlog_peek_is_rtp (trans))) {
     GstBuffer *buffer;
     GstBufferList *buffer_list;
     gboolean is_rtp;
     gboolean popped;
 
+    /* send everything that piled up while the client was busy at once, so
+     * that the connection can write it with a single writev() */
     popped =
-        gst_rtsp_stream_transport_backlog_pop (trans, &buffer, &buffer_list,
-        &is_rtp);
+        gst_rtsp_stream_transport_backlog_pop_batch (trans,
+        MAX_TCP_BATCH_BUFFERS, &buffer, &buffer_list, &is_rtp);
 
     g_assert (popped == TRUE);
 
@@ -2658,6 +2927,230 @@ check_transport_backlog (GstRTSPStream * stream, GstRTSPStreamTransport * trans)
   }
 }
 
+/* Must be called with priv->lock and the backlog lock of @trans. Returns
+ * %FALSE if @trans was removed because it was too slow */
+static gboolean
+push_to_backlog (GstRTSPStream * stream, GstRTSPStreamTransport * trans,
+    GstBuffer * buffer, GstBufferList * buffer_list, gboolean is_rtp)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+  guint dropped;
+
+  if (buffer)
+    gst_buffer_ref (buffer);
+  if (buffer_list)
+    gst_buffer_list_ref (buffer_list);
+
+  if (gst_rtsp_stream_transport_backlog_push (trans, buffer, buffer_list,
+          is_rtp))
+    return TRUE;
+
+  if (priv->drop_tcp_backlog) {
+    dropped = gst_rtsp_stream_transport_backlog_drop (trans);
+    GST_WARNING_OBJECT (stream, "Dropped %u samples for slow transport %"
+        GST_PTR_FORMAT, dropped, trans);
+    return TRUE;
+  }
+
+  GST_ERROR_OBJECT (stream, "Dropping slow transport %" GST_PTR_FORMAT,
+      trans);
+  update_transport (stream, trans, FALSE);
+
+  return FALSE;
+}
+
+static GstBuffer *
+get_sample_first_buffer (GstSample * sample)
+{
+  GstBuffer *buffer;
+  GstBufferList *buffer_list;
+
+  buffer = gst_sample_get_buffer (sample);
+  if (buffer)
+    return buffer;
+
+  buffer_list = gst_sample_get_buffer_list (sample);
+  if (buffer_list && gst_buffer_list_length (buffer_list) > 0)
+    return gst_buffer_list_get (buffer_list, 0);
+
+  return NULL;
+}
+
+static gboolean
+sample_has_keyframe (GstSample * sample)
+{
+  GstBuffer *buffer;
+  GstBufferList *buffer_list;
+  guint i, len;
+
+  buffer = gst_sample_get_buffer (sample);
+  if (buffer)
+    return !GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+
+  buffer_list = gst_sample_get_buffer_list (sample);
+  if (!buffer_list)
+    return FALSE;
+
+  len = gst_buffer_list_length (buffer_list);
+  for (i = 0; i < len; i++) {
+    buffer = gst_buffer_list_get (buffer_list, i);
+    if (!GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT))
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* a new client would be dropped as too slow right away when getting more
+ * than fits in its backlog */
+static gboolean
+samples_exceed_duration (GstSample * first_sample, GstSample * last_sample,
+    GstClockTime max_duration)
+{
+  GstBuffer *first, *last;
+  GstClockTime first_ts, last_ts;
+
+  first = get_sample_first_buffer (first_sample);
+  last = get_sample_first_buffer (last_sample);
+  if (!first || !last)
+    return FALSE;
+
+  first_ts = GST_BUFFER_DTS_OR_PTS (first);
+  last_ts = GST_BUFFER_DTS_OR_PTS (last);
+
+  return GST_CLOCK_TIME_IS_VALID (first_ts) && GST_CLOCK_TIME_IS_VALID (last_ts)
+      && GST_CLOCK_DIFF (first_ts, last_ts) > (GstClockTimeDiff) max_duration;
+}
+
+/* With priv->lock */
+static void
+update_gop_cache (GstRTSPStream * stream, GstSample * sample)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+
+  if (sample_has_keyframe (sample)) {
+    clear_gop_cache (priv);
+  } else if (g_queue_is_empty (&priv->gop_cache)) {
+    /* wait for the next keyframe */
+    return;
+  }
+
+  g_queue_push_tail (&priv->gop_cache, gst_sample_ref (sample));
+
+  if (samples_exceed_duration (g_queue_peek_head (&priv->gop_cache), sample,
+          priv->max_tcp_backlog_duration)) {
+    GST_DEBUG_OBJECT (stream, "GOP longer than %" GST_TIME_FORMAT
+        ", not caching it", GST_TIME_ARGS (priv->max_tcp_backlog_duration));
+    clear_gop_cache (priv);
+  }
+}
+
+/* With priv->lock. The transports that got their RTP-Info from the GOP
+ * cache but are not added yet must not miss any sample until they are */
+static void
+update_gop_bursts (GstRTSPStream * stream, GstSample * sample)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+  GList *walk, *next;
+
+  for (walk = priv->gop_burst; walk; walk = next) {
+    GopBurst *burst = walk->data;
+
+    next = g_list_next (walk);
+
+    if (burst->added)
+      continue;
+
+    g_queue_push_tail (&burst->samples, gst_sample_ref (sample));
+
+    if (samples_exceed_duration (g_queue_peek_head (&burst->samples), sample,
+            priv->max_tcp_backlog_duration)) {
+      GST_DEBUG_OBJECT (stream, "%" GST_PTR_FORMAT " not added in time, "
+          "dropping its cached samples", burst->trans);
+      priv->gop_burst = g_list_delete_link (priv->gop_burst, walk);
+      gop_burst_free (burst);
+    }
+  }
+}
+
+/* With priv->lock. Returns a new GopBurst for @trans holding the current
+ * GOP cache, or the one it already has, or %NULL when @trans does not get
+ * any burst */
+static GopBurst *
+ensure_gop_burst (GstRTSPStream * stream, GstRTSPStreamTransport * trans)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+  const GstRTSPTransport *tr;
+  GopBurst *burst;
+  GList *item;
+
+  if ((item = find_gop_burst (priv, trans)))
+    return item->data;
+
+  tr = gst_rtsp_stream_transport_get_transport (trans);
+  if (!priv->gop_cache_enabled ||
+      tr->lower_transport != GST_RTSP_LOWER_TRANS_TCP ||
+      g_queue_is_empty (&priv->gop_cache))
+    return NULL;
+
+  burst = g_new0 (GopBurst, 1);
+  burst->trans = g_object_ref (trans);
+  g_queue_init (&burst->samples);
+  for (item = priv->gop_cache.head; item; item = item->next)
+    g_queue_push_tail (&burst->samples, gst_sample_ref (item->data));
+
+  priv->gop_burst = g_list_prepend (priv->gop_burst, burst);
+
+  return burst;
+}
+
+/* With priv->lock. Queues the cached samples in the backlog of the added TCP
+ * transports and returns them, their backlog has to be checked once the
+ * lock is released */
+static GList *
+queue_gop_bursts (GstRTSPStream * stream)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+  GList *walk, *next, *transports = NULL;
+
+  for (walk = priv->gop_burst; walk; walk = next) {
+    GopBurst *burst = walk->data;
+    GstRTSPStreamTransport *tr = burst->trans;
+    gboolean removed = FALSE;
+    GList *item;
+
+    next = g_list_next (walk);
+
+    if (!burst->added)
+      continue;
+
+    /* Unlinked first, removing the transport when it is too slow for the
+     * burst frees the burst it still has */
+    priv->gop_burst = g_list_delete_link (priv->gop_burst, walk);
+
+    GST_DEBUG_OBJECT (stream, "sending %u cached samples to %" GST_PTR_FORMAT,
+        g_queue_get_length (&burst->samples), tr);
+
+    gst_rtsp_stream_transport_lock_backlog (tr);
+    for (item = burst->samples.head; item; item = item->next) {
+      GstSample *sample = item->data;
+
+      if (!push_to_backlog (stream, tr, gst_sample_get_buffer (sample),
+              gst_sample_get_buffer_list (sample), TRUE)) {
+        removed = TRUE;
+        break;
+      }
+    }
+    gst_rtsp_stream_transport_unlock_backlog (tr);
+
+    if (!removed)
+      transports = g_list_prepend (transports, g_object_ref (tr));
+    gop_burst_free (burst);
+  }
+
+  return transports;
+}
+
 /* Must be called with priv->lock */
 static void
 send_tcp_message (GstRTSPStream * stream, gint idx)
@@ -2669,6 +3162,7 @@ send_tcp_message (GstRTSPStream * stream, gint idx)
   GstBufferList *buffer_list;
   gboolean is_rtp;
   GPtrArray *transports;
+  GPtrArray *ready;
 
   if (!priv->have_buffer[idx])
     return;
@@ -2696,53 +3190,76 @@ send_tcp_message (GstRTSPStream * stream, gint idx)
   buffer = gst_sample_get_buffer (sample);
   buffer_list = gst_sample_get_buffer_list (sample);
 
+  if (is_rtp && priv->gop_cache_enabled) {
+    update_gop_cache (stream, sample);
+    update_gop_bursts (stream, sample);
+  }
+
   /* We will get one message-sent notification per buffer or
    * complete buffer-list. We handle each buffer-list as a unit */
 
   transports = priv->tr_cache;
   if (transports)
     g_ptr_array_ref (transports);
+  ready = priv->tr_ready;
+  if (ready) {
+    g_ptr_array_ref (ready);
+    g_ptr_array_set_size (ready, 0);
+  }
 
   if (transports) {
     gint index;
 
     for (index = 0; index < transports->len; index++) {
       GstRTSPStreamTransport *tr = g_ptr_array_index (transports, index);
-      GstBuffer *buf_ref = NULL;
-      GstBufferList *buflist_ref = NULL;
 
       gst_rtsp_stream_transport_lock_backlog (tr);
 
-      if (buffer)
-        buf_ref = gst_buffer_ref (buffer);
-      if (buffer_list)
-        buflist_ref = gst_buffer_list_ref (buffer_list);
-
-      if (!gst_rtsp_stream_transport_backlog_push (tr,
-              buf_ref, buflist_ref, is_rtp)) {
-        GST_ERROR_OBJECT (stream,
-            "Dropping slow transport %" GST_PTR_FORMAT, tr);
-        update_transport (stream, tr, FALSE);
+      /* Clients that keep up have nothing backlogged and get the sample
+       * directly once the lock is released, only the slow ones get a
+       * reference to it in their backlog */
+      if (gst_rtsp_stream_transport_backlog_is_empty (tr) &&
+          !gst_rtsp_stream_transport_check_back_pressure (tr, is_rtp)) {
+        g_ptr_array_add (ready, tr);
+      } else {
+        push_to_backlog (stream, tr, buffer, buffer_list, is_rtp);
       }
 
       gst_rtsp_stream_transport_unlock_backlog (tr);
     }
   }
-  gst_sample_unref (sample);
 
   g_mutex_unlock (&priv->lock);
 
-  if (transports) {
+  if (ready) {
     gint index;
 
-    for (index = 0; index < transports->len; index++) {
-      GstRTSPStreamTransport *tr = g_ptr_array_index (transports, index);
+    for (index = 0; index < ready->len; index++) {
+      GstRTSPStreamTransport *tr = g_ptr_array_index (ready, index);
+      gboolean send_ret;
+
+      /* The buffers are shared by all transports, the payload is never
+       * copied for a client */
+      gst_rtsp_stream_transport_lock_backlog (tr);
+      send_ret = push_data (stream, tr, buffer, buffer_list, is_rtp);
+      gst_rtsp_stream_transport_unlock_backlog (tr);
 
-      check_transport_backlog (stream, tr);
+      if (!send_ret) {
+        /* remove transport on send error */
+        g_mutex_lock (&priv->lock);
+        update_transport (stream, tr, FALSE);
+        g_mutex_unlock (&priv->lock);
+      }
     }
-    g_ptr_array_unref (transports);
+    g_ptr_array_set_size (ready, 0);
+    g_ptr_array_unref (ready);
   }
 
+  if (transports)
+    g_ptr_array_unref (transports);
+
+  gst_sample_unref (sample);
+
   g_mutex_lock (&priv->lock);
 }
 
@@ -2757,12 +3274,16 @@ send_func (GstRTSPStream * stream)
     int i;
     int idx = -1;
     guint cookie;
+    GList *bursts, *walk;
 
     cookie = priv->send_cookie;
     g_mutex_unlock (&priv->send_lock);
 
     g_mutex_lock (&priv->lock);
 
+    /* new clients get the cached GOP before any live sample */
+    bursts = queue_gop_bursts (stream);
+
     /* iterate from 1 and down, so we prioritize RTCP over RTP */
     for (i = 1; i >= 0; i--) {
       if (priv->have_buffer[i]) {
@@ -2778,6 +3299,10 @@ send_func (GstRTSPStream * stream)
 
     g_mutex_unlock (&priv->lock);
 
+    for (walk = bursts; walk; walk = g_list_next (walk))
+      check_transport_backlog (stream, walk->data);
+    g_list_free_full (bursts, g_object_unref);
+
     g_mutex_lock (&priv->send_lock);
     while (cookie == priv->send_cookie && priv->continue_sending) {
       g_cond_wait (&priv->send_cond, &priv->send_lock);
@@ -4137,6 +4662,8 @@ gst_rtsp_stream_leave_bin (GstRTSPStream * stream, GstBin * bin,
   }
 
   clear_tr_cache (priv);
+  clear_gop_cache (priv);
+  clear_gop_bursts (priv);
 
   GST_INFO ("stream %p leaving bin", stream);
 
@@ -4278,6 +4805,17 @@ gboolean
 gst_rtsp_stream_get_rtpinfo (GstRTSPStream * stream,
     guint * rtptime, guint * seq, guint * clock_rate,
     GstClockTime * running_time)
+{
+  return gst_rtsp_stream_get_transport_rtpinfo (stream, NULL, rtptime, seq,
+      clock_rate, running_time);
+}
+
+/* Like gst_rtsp_stream_get_rtpinfo() but for what @trans is going to
+ * receive first, which for a new TCP transport is the GOP cache */
+gboolean
+gst_rtsp_stream_get_transport_rtpinfo (GstRTSPStream * stream,
+    GstRTSPStreamTransport * trans, guint * rtptime, guint * seq,
+    guint * clock_rate, GstClockTime * running_time)
 {
   GstRTSPStreamPrivate *priv;
   GstStructure *stats;
@@ -4297,8 +4835,16 @@ gst_rtsp_stream_get_rtpinfo (GstRTSPStream * stream,
    */
   if (priv->udpsink[0] || priv->mcast_udpsink[0] || priv->appsink[0]) {
     GstSample *last_sample;
+    GopBurst *burst = NULL;
+
+    /* a new TCP transport gets the cached GOP first, so start from there.
+     * From now on the samples it would miss are kept for it as well */
+    if (trans && !g_list_find (priv->transports, trans))
+      burst = ensure_gop_burst (stream, trans);
 
-    if (priv->udpsink[0])
+    if (burst)
+      last_sample = gst_sample_ref (g_queue_peek_head (&burst->samples));
+    else if (priv->udpsink[0])
       g_object_get (priv->udpsink[0], "last-sample", &last_sample, NULL);
     else if (priv->mcast_udpsink[0])
       g_object_get (priv->mcast_udpsink[0], "last-sample", &last_sample, NULL);
@@ -4313,11 +4859,11 @@ gst_rtsp_stream_get_rtpinfo (GstRTSPStream * stream,
       GstRTPBuffer rtp_buffer = GST_RTP_BUFFER_INIT;
 
       caps = gst_sample_get_caps (last_sample);
-      buffer = gst_sample_get_buffer (last_sample);
+      buffer = get_sample_first_buffer (last_sample);
       segment = gst_sample_get_segment (last_sample);
       s = gst_caps_get_structure (caps, 0);
 
-      if (gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp_buffer)) {
+      if (buffer && gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp_buffer)) {
         guint ssrc_buf = gst_rtp_buffer_get_ssrc (&rtp_buffer);
         guint ssrc_stream = 0;
         if (gst_structure_has_field_typed (s, "ssrc", G_TYPE_UINT) &&
@@ -4767,14 +5313,37 @@ update_transport (GstRTSPStream * stream, GstRTSPStreamTransport * trans,
       break;
     }
     case GST_RTSP_LOWER_TRANS_TCP:
+    {
+      GList *burst;
+
       if (add) {
         GST_INFO ("adding TCP %s", tr->destination);
+        gst_rtsp_stream_transport_lock_backlog (trans);
+        gst_rtsp_stream_transport_set_backlog_limits (trans,
+            priv->max_tcp_backlog_duration, priv->max_tcp_backlog_size);
+        gst_rtsp_stream_transport_unlock_backlog (trans);
         priv->transports = g_list_prepend (priv->transports, trans);
         priv->n_tcp_transports++;
+
+        /* only the transports whose RTP-Info was taken from the GOP cache
+         * get it */
+        if ((burst = find_gop_burst (priv, trans))) {
+          ((GopBurst *) burst->data)->added = TRUE;
+
+          g_mutex_lock (&priv->send_lock);
+          priv->send_cookie++;
+          g_cond_signal (&priv->send_cond);
+          g_mutex_unlock (&priv->send_lock);
+        }
       } else {
         GST_INFO ("removing TCP %s", tr->destination);
         priv->transports = g_list_delete_link (priv->transports, tr_element);
 
+        if ((burst = find_gop_burst (priv, trans))) {
+          gop_burst_free (burst->data);
+          priv->gop_burst = g_list_delete_link (priv->gop_burst, burst);
+        }
+
         gst_rtsp_stream_transport_lock_backlog (trans);
         gst_rtsp_stream_transport_clear_backlog (trans);
         gst_rtsp_stream_transport_unlock_backlog (trans);
@@ -4783,6 +5352,7 @@ update_transport (GstRTSPStream * stream, GstRTSPStreamTransport * trans,
       }
       priv->transports_cookie++;
       break;
+    }
     default:
       goto unknown_transport;
   }
@@ -316,6 +316,28 @@ guint             gst_rtsp_stream_get_max_mcast_ttl  (GstRTSPStream *stream);
 GST_RTSP_SERVER_API
 gboolean          gst_rtsp_stream_verify_mcast_ttl  (GstRTSPStream *stream, guint ttl);
 
+GST_RTSP_SERVER_API
+void              gst_rtsp_stream_set_tcp_backlog_limits (GstRTSPStream * stream,
+                                                          GstClockTime max_duration,
+                                                          guint max_size);
+
+GST_RTSP_SERVER_API
+void              gst_rtsp_stream_get_tcp_backlog_limits (GstRTSPStream * stream,
+                                                          GstClockTime * max_duration,
+                                                          guint * max_size);
+
+GST_RTSP_SERVER_API
+void              gst_rtsp_stream_set_drop_tcp_backlog (GstRTSPStream * stream, gboolean drop);
+
+GST_RTSP_SERVER_API
+gboolean          gst_rtsp_stream_get_drop_tcp_backlog (GstRTSPStream * stream);
+
+GST_RTSP_SERVER_API
+void              gst_rtsp_stream_set_gop_cache (GstRTSPStream * stream, gboolean enable);
+
+GST_RTSP_SERVER_API
+gboolean          gst_rtsp_stream_get_gop_cache (GstRTSPStream * stream);
+
 GST_RTSP_SERVER_API
 void              gst_rtsp_stream_set_bind_mcast_address  (GstRTSPStream * stream, gboolean bind_mcast_addr);
 
@@ -27,7 +27,9 @@
  * Threads of type #GST_RTSP_THREAD_TYPE_CLIENT are used to handle requests from
  * a connected client. With gst_rtsp_thread_pool_get_max_threads() a maximum
  * number of threads can be set after which the pool will start to reuse the
- * same thread for multiple clients.
+ * same thread for multiple clients. New clients are then given the thread
+ * that currently serves the fewest clients, so that they are spread evenly
+ * over the shared mainloops.
  *
  * Threads of type #GST_RTSP_THREAD_TYPE_MEDIA will be used to perform the state
  * changes of the media pipelines and handle its bus messages.
@@ -430,6 +432,34 @@ make_thread (GstRTSPThreadPool * pool, GstRTSPThreadType type,
   return thread;
 }
 
+/* with priv->lock, removes and returns the thread that is used the least */
+static GstRTSPThread *
+pop_least_used_thread (GstRTSPThreadPool * pool)
+{
+  GstRTSPThreadPoolPrivate *priv = pool->priv;
+  GstRTSPThread *thread;
+  GList *walk, *best = NULL;
+  gint best_reused = G_MAXINT;
+
+  for (walk = priv->threads.head; walk; walk = walk->next) {
+    GstRTSPThreadImpl *impl = walk->data;
+    gint reused = g_atomic_int_get (&impl->reused);
+
+    if (reused < best_reused) {
+      best = walk;
+      best_reused = reused;
+    }
+  }
+
+  if (best == NULL)
+    return NULL;
+
+  thread = best->data;
+  g_queue_delete_link (&priv->threads, best);
+
+  return thread;
+}
+
 static GstRTSPThread *
 default_get_thread (GstRTSPThreadPool * pool,
     GstRTSPThreadType type, GstRTSPContext * ctx)
@@ -452,8 +482,8 @@ default_get_thread (GstRTSPThreadPool * pool,
       retry:
         if (priv->max_threads > 0 &&
             g_queue_get_length (&priv->threads) >= priv->max_threads) {
-          /* max threads reached, recycle from queue */
-          thread = g_queue_pop_head (&priv->threads);
+          /* max threads reached, recycle the least busy thread */
+          thread = pop_least_used_thread (pool);
           GST_DEBUG_OBJECT (pool, "recycle client thread %p", thread);
           if (!gst_rtsp_thread_reuse (thread)) {
             GST_DEBUG_OBJECT (pool, "thread %p stopping, retry", thread);
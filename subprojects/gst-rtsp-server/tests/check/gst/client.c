@@ -18,6 +18,7 @@
  */
 
 #include <gst/check/gstcheck.h>
+#include <gio/gnetworking.h>
 
 #include <rtsp-client.h>
 
@@ -27,6 +28,10 @@
 #define AUDIO_PIPELINE "audiotestsrc ! " \
   "audio/x-raw,rate=8000 ! " \
   "rtpgstpay name=pay1 pt=97"
+/* live and with packets of the same size, 100 per second */
+#define LIVE_AUDIO_PIPELINE "( audiotestsrc is-live=true " \
+  "samplesperbuffer=480 ! audio/x-raw,rate=48000,channels=1 ! " \
+  "rtpL16pay name=pay0 pt=96 )"
 
 static gchar *session_id;
 static gint cseq;
@@ -2123,6 +2128,318 @@ GST_START_TEST (test_client_play)
 
 GST_END_TEST;
 
+GST_START_TEST (test_client_stats)
+{
+  GstRTSPClient *client;
+  GstStructure *stats;
+  guint64 value;
+
+  client = gst_rtsp_client_new ();
+
+  stats = gst_rtsp_client_get_stats (client);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "backlog-bytes", &value));
+  fail_unless_equals_uint64 (value, 0);
+  fail_unless (gst_structure_get_uint64 (stats, "sent-messages", &value));
+  fail_unless_equals_uint64 (value, 0);
+  fail_unless (gst_structure_get_uint64 (stats, "sent-bytes", &value));
+  fail_unless_equals_uint64 (value, 0);
+  fail_unless (gst_structure_get_uint64 (stats, "dropped-messages", &value));
+  fail_unless_equals_uint64 (value, 0);
+  gst_structure_free (stats);
+
+  g_object_unref (client);
+}
+
+GST_END_TEST;
+
+static guint64
+get_client_stat (GstRTSPClient * client, const gchar * name)
+{
+  GstStructure *stats;
+  guint64 value = 0;
+
+  stats = gst_rtsp_client_get_stats (client);
+  fail_unless (gst_structure_get_uint64 (stats, name, &value));
+  gst_structure_free (stats);
+
+  return value;
+}
+
+static gpointer
+run_loop (GMainLoop * loop)
+{
+  g_main_loop_run (loop);
+
+  return NULL;
+}
+
+/* Creates a connected pair of TCP sockets with small buffers, so that the
+ * server side stops being writable after a few packets */
+static void
+create_socket_pair (GSocket ** server, GSocket ** peer)
+{
+  GSocket *listener;
+  GInetAddress *inet_addr;
+  GSocketAddress *addr, *bound_addr;
+  GError *error = NULL;
+
+  listener = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_STREAM,
+      G_SOCKET_PROTOCOL_TCP, &error);
+  g_assert_no_error (error);
+  inet_addr = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+  addr = g_inet_socket_address_new (inet_addr, 0);
+  fail_unless (g_socket_bind (listener, addr, TRUE, &error));
+  g_assert_no_error (error);
+  fail_unless (g_socket_listen (listener, &error));
+  bound_addr = g_socket_get_local_address (listener, &error);
+  g_assert_no_error (error);
+
+  *peer = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_STREAM,
+      G_SOCKET_PROTOCOL_TCP, &error);
+  g_assert_no_error (error);
+  fail_unless (g_socket_set_option (*peer, SOL_SOCKET, SO_RCVBUF, 4096,
+          &error));
+  fail_unless (g_socket_connect (*peer, bound_addr, NULL, &error));
+  g_assert_no_error (error);
+
+  *server = g_socket_accept (listener, NULL, &error);
+  g_assert_no_error (error);
+  fail_unless (g_socket_set_option (*server, SOL_SOCKET, SO_SNDBUF, 4096,
+          &error));
+
+  g_object_unref (bound_addr);
+  g_object_unref (addr);
+  g_object_unref (inet_addr);
+  g_object_unref (listener);
+}
+
+/* Sends a request from the peer and returns the response, skipping the
+ * interleaved data that arrives in between */
+static void
+peer_request (GstRTSPConnection * conn, GstRTSPMethod method,
+    const gchar * url, const gchar * transport, gchar ** session)
+{
+  GstRTSPMessage request = { 0, };
+  GstRTSPMessage response = { 0, };
+  GstRTSPStatusCode code;
+  static gint peer_cseq = 1;
+  gchar *str;
+
+  fail_unless (gst_rtsp_message_init_request (&request, method,
+          url) == GST_RTSP_OK);
+  str = g_strdup_printf ("%d", peer_cseq++);
+  gst_rtsp_message_take_header (&request, GST_RTSP_HDR_CSEQ, str);
+  if (transport)
+    gst_rtsp_message_add_header (&request, GST_RTSP_HDR_TRANSPORT, transport);
+  if (*session)
+    gst_rtsp_message_add_header (&request, GST_RTSP_HDR_SESSION, *session);
+  fail_unless (gst_rtsp_connection_send_usec (conn, &request,
+          5 * G_USEC_PER_SEC) == GST_RTSP_OK);
+  gst_rtsp_message_unset (&request);
+
+  do {
+    gst_rtsp_message_unset (&response);
+    fail_unless (gst_rtsp_connection_receive_usec (conn, &response,
+            5 * G_USEC_PER_SEC) == GST_RTSP_OK);
+  } while (gst_rtsp_message_get_type (&response) != GST_RTSP_MESSAGE_RESPONSE);
+
+  fail_unless (gst_rtsp_message_parse_response (&response, &code, NULL,
+          NULL) == GST_RTSP_OK);
+  fail_unless_equals_int (code, GST_RTSP_STS_OK);
+
+  if (*session == NULL) {
+    gchar **params;
+
+    fail_unless (gst_rtsp_message_get_header (&response, GST_RTSP_HDR_SESSION,
+            &str, 0) == GST_RTSP_OK);
+    params = g_strsplit (str, ";", -1);
+    *session = g_strdup (params[0]);
+    g_strfreev (params);
+  }
+  gst_rtsp_message_unset (&response);
+}
+
+/* Accepts everything, like a client that always keeps up, and remembers the
+ * session of the first response that has one */
+static gboolean
+accept_messages (GstRTSPClient * client, GstRTSPMessage * messages,
+    guint n_messages, gboolean close, gpointer user_data)
+{
+  gchar **session = user_data;
+  gchar *str;
+  guint i;
+
+  for (i = 0; i < n_messages && *session == NULL; i++) {
+    if (gst_rtsp_message_get_type (&messages[i]) == GST_RTSP_MESSAGE_RESPONSE
+        && gst_rtsp_message_get_header (&messages[i], GST_RTSP_HDR_SESSION,
+            &str, 0) == GST_RTSP_OK) {
+      gchar **params = g_strsplit (str, ";", -1);
+
+      *session = g_strdup (params[0]);
+      g_strfreev (params);
+    }
+  }
+
+  return TRUE;
+}
+
+static void
+client_request (GstRTSPClient * client, GstRTSPMethod method,
+    const gchar * url, const gchar * transport, const gchar * session)
+{
+  GstRTSPMessage request = { 0, };
+
+  fail_unless (gst_rtsp_message_init_request (&request, method,
+          url) == GST_RTSP_OK);
+  gst_rtsp_message_take_header (&request, GST_RTSP_HDR_CSEQ,
+      g_strdup_printf ("%d", cseq++));
+  if (transport)
+    gst_rtsp_message_add_header (&request, GST_RTSP_HDR_TRANSPORT, transport);
+  if (session)
+    gst_rtsp_message_add_header (&request, GST_RTSP_HDR_SESSION, session);
+  fail_unless (gst_rtsp_client_handle_message (client,
+          &request) == GST_RTSP_OK);
+  gst_rtsp_message_unset (&request);
+}
+
+/* Two TCP clients share a media. While the second one keeps up, the packets
+ * for the first one, which stops reading, pile up in its transport backlog.
+ * Once it reads again, the backlog is sent as batches of several packets,
+ * and the statistics follow what was queued and sent. */
+GST_START_TEST (test_client_tcp_backlog_batch)
+{
+  GstRTSPClient *client, *fast_client;
+  GstRTSPConnection *conn, *peer_conn;
+  GstRTSPSessionPool *session_pool;
+  GstRTSPMountPoints *mount_points;
+  GstRTSPMediaFactory *factory;
+  GstRTSPThreadPool *thread_pool;
+  GSocket *server_sock, *peer_sock;
+  GMainContext *context;
+  GMainLoop *loop;
+  GThread *thread;
+  GstRTSPMessage message = { 0, };
+  gchar *session = NULL, *fast_session = NULL;
+  guint64 sent_messages, sent_bytes, backlog_bytes, max_backlog_bytes = 0;
+  guint max_packet_size = 0, n_packets = 0;
+  guint8 *data;
+  guint size;
+  gint i;
+
+  client = setup_client (NULL, "/test", FALSE);
+  mount_points = gst_rtsp_client_get_mount_points (client);
+  factory = gst_rtsp_media_factory_new ();
+  gst_rtsp_media_factory_set_launch (factory, LIVE_AUDIO_PIPELINE);
+  gst_rtsp_media_factory_set_shared (factory, TRUE);
+  gst_rtsp_media_factory_set_enable_rtcp (factory, FALSE);
+  gst_rtsp_mount_points_add_factory (mount_points, "/live", factory);
+
+  /* the client that is slow, connected to a peer that stops reading */
+  create_socket_pair (&server_sock, &peer_sock);
+  fail_unless (gst_rtsp_connection_create_from_socket (server_sock,
+          "127.0.0.1", 554, NULL, &conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_client_set_connection (client, conn));
+  fail_unless (gst_rtsp_connection_create_from_socket (peer_sock,
+          "127.0.0.1", 554, NULL, &peer_conn) == GST_RTSP_OK);
+
+  context = g_main_context_new ();
+  loop = g_main_loop_new (context, FALSE);
+  fail_unless (gst_rtsp_client_attach (client, context) != 0);
+  thread = g_thread_new ("client-context", (GThreadFunc) run_loop, loop);
+
+  peer_request (peer_conn, GST_RTSP_SETUP, "rtsp://localhost/live/stream=0",
+      "RTP/AVP/TCP;unicast;interleaved=0-1", &session);
+  peer_request (peer_conn, GST_RTSP_PLAY, "rtsp://localhost/live", NULL,
+      &session);
+
+  /* the client that keeps up on the same media */
+  fast_client = gst_rtsp_client_new ();
+  session_pool = gst_rtsp_client_get_session_pool (client);
+  thread_pool = gst_rtsp_client_get_thread_pool (client);
+  gst_rtsp_client_set_session_pool (fast_client, session_pool);
+  gst_rtsp_client_set_mount_points (fast_client, mount_points);
+  gst_rtsp_client_set_thread_pool (fast_client, thread_pool);
+  create_connection (&conn);
+  fail_unless (gst_rtsp_client_set_connection (fast_client, conn));
+  gst_rtsp_client_set_send_messages_func (fast_client, accept_messages,
+      &fast_session, NULL);
+  client_request (fast_client, GST_RTSP_SETUP,
+      "rtsp://localhost/live/stream=0", "RTP/AVP/TCP;unicast", NULL);
+  fail_unless (fast_session != NULL);
+  client_request (fast_client, GST_RTSP_PLAY, "rtsp://localhost/live", NULL,
+      fast_session);
+
+  /* don't read, until the connection holds back a data message */
+  for (i = 0; i < 500; i++) {
+    if (get_client_stat (client, "backlog-bytes") > 0)
+      break;
+    g_usleep (10 * 1000);
+  }
+  fail_unless (get_client_stat (client, "backlog-bytes") > 0);
+  sent_messages = get_client_stat (client, "sent-messages");
+  sent_bytes = get_client_stat (client, "sent-bytes");
+  fail_unless (sent_messages > 0);
+  fail_unless (sent_bytes > 0);
+
+  /* meanwhile about 30 more packets go to the transport backlog */
+  g_usleep (300 * 1000);
+
+  /* now catch up, the backlog goes out in batches, so the connection holds
+   * back more than a single packet at once */
+  while (n_packets < 200) {
+    gst_rtsp_message_unset (&message);
+    fail_unless (gst_rtsp_connection_receive_usec (peer_conn, &message,
+            5 * G_USEC_PER_SEC) == GST_RTSP_OK);
+    if (gst_rtsp_message_get_type (&message) != GST_RTSP_MESSAGE_DATA)
+      continue;
+
+    fail_unless (gst_rtsp_message_get_body (&message, &data,
+            &size) == GST_RTSP_OK);
+    max_packet_size = MAX (max_packet_size, size);
+    n_packets++;
+
+    backlog_bytes = get_client_stat (client, "backlog-bytes");
+    max_backlog_bytes = MAX (max_backlog_bytes, backlog_bytes);
+  }
+  gst_rtsp_message_unset (&message);
+
+  fail_unless (max_packet_size > 0);
+  fail_unless (max_backlog_bytes > 2 * max_packet_size,
+      "at most %" G_GUINT64_FORMAT " bytes were queued at once, "
+      "packets are %u bytes", max_backlog_bytes, max_packet_size);
+
+  /* the packets read were counted as sent and none was dropped */
+  fail_unless (get_client_stat (client, "sent-messages") >
+      sent_messages + n_packets / 2);
+  fail_unless (get_client_stat (client, "sent-bytes") > sent_bytes);
+  fail_unless_equals_uint64 (get_client_stat (client, "dropped-messages"), 0);
+
+  client_request (fast_client, GST_RTSP_TEARDOWN, "rtsp://localhost/live",
+      NULL, fast_session);
+  g_free (fast_session);
+  peer_request (peer_conn, GST_RTSP_TEARDOWN, "rtsp://localhost/live", NULL,
+      &session);
+  g_free (session);
+
+  gst_rtsp_client_close (client);
+  g_main_loop_quit (loop);
+  g_thread_join (thread);
+  g_main_loop_unref (loop);
+  g_main_context_unref (context);
+
+  gst_rtsp_connection_free (peer_conn);
+  g_object_unref (peer_sock);
+  g_object_unref (server_sock);
+  teardown_client (fast_client);
+  teardown_client (client);
+  g_object_unref (thread_pool);
+  g_object_unref (session_pool);
+  g_object_unref (mount_points);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_client_play_root_mount_point)
 {
   test_client_play_sub ("/", "rtsp://localhost/stream=0", "rtsp://localhost");
@@ -2188,6 +2505,8 @@ rtspclient_suite (void)
   tcase_add_test (tc, test_scale_and_speed);
   tcase_add_test (tc, test_client_play);
   tcase_add_test (tc, test_client_play_root_mount_point);
+  tcase_add_test (tc, test_client_stats);
+  tcase_add_test (tc, test_client_tcp_backlog_batch);
 
   return s;
 }
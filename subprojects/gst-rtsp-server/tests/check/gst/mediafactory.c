@@ -20,6 +20,12 @@
 #include <gst/check/gstcheck.h>
 
 #include <rtsp-media-factory.h>
+#include <rtsp-client.h>
+
+/* live, 100 packets per second, numbered from 0 */
+#define GOP_PIPELINE "( audiotestsrc is-live=true samplesperbuffer=480 ! " \
+  "audio/x-raw,rate=48000,channels=1 ! " \
+  "rtpL16pay name=pay0 pt=96 seqnum-offset=0 )"
 
 GST_START_TEST (test_parse_error)
 {
@@ -420,6 +426,429 @@ GST_START_TEST (test_allow_bind_mcast)
 
 GST_END_TEST;
 
+GST_START_TEST (test_gop_cache)
+{
+  GstRTSPMediaFactory *factory;
+  GstRTSPMedia *media;
+  GstRTSPUrl *url;
+  GstRTSPStream *stream;
+
+  factory = gst_rtsp_media_factory_new ();
+  gst_rtsp_media_factory_set_shared (factory, TRUE);
+  fail_unless (gst_rtsp_url_parse ("rtsp://localhost:8554/test",
+          &url) == GST_RTSP_OK);
+
+  gst_rtsp_media_factory_set_launch (factory,
+      "( videotestsrc ! rtpvrawpay pt=96 name=pay0 "
+      " audiotestsrc ! audioconvert ! rtpL16pay name=pay1 )");
+
+  /* the GOP cache is disabled by default */
+  fail_unless (gst_rtsp_media_factory_get_gop_cache (factory) == FALSE);
+
+  gst_rtsp_media_factory_set_gop_cache (factory, TRUE);
+  fail_unless (gst_rtsp_media_factory_get_gop_cache (factory) == TRUE);
+
+  media = gst_rtsp_media_factory_construct (factory, url);
+  fail_unless (GST_IS_RTSP_MEDIA (media));
+  fail_unless (gst_rtsp_media_get_gop_cache (media) == TRUE);
+
+  fail_unless (gst_rtsp_media_n_streams (media) == 2);
+
+  stream = gst_rtsp_media_get_stream (media, 0);
+  fail_unless (stream != NULL);
+  fail_unless (gst_rtsp_stream_get_gop_cache (stream) == TRUE);
+
+  /* disabling it on the media disables it on all streams */
+  gst_rtsp_media_set_gop_cache (media, FALSE);
+  fail_unless (gst_rtsp_stream_get_gop_cache (stream) == FALSE);
+  stream = gst_rtsp_media_get_stream (media, 1);
+  fail_unless (stream != NULL);
+  fail_unless (gst_rtsp_stream_get_gop_cache (stream) == FALSE);
+
+  g_object_unref (media);
+  gst_rtsp_url_free (url);
+  g_object_unref (factory);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_tcp_backlog)
+{
+  GstRTSPMediaFactory *factory;
+  GstRTSPMedia *media;
+  GstRTSPUrl *url;
+  GstRTSPStream *stream;
+  GstClockTime max_duration;
+  guint max_size, i;
+
+  factory = gst_rtsp_media_factory_new ();
+  fail_unless (gst_rtsp_url_parse ("rtsp://localhost:8554/test",
+          &url) == GST_RTSP_OK);
+
+  gst_rtsp_media_factory_set_launch (factory,
+      "( videotestsrc ! rtpvrawpay pt=96 name=pay0 "
+      " audiotestsrc ! audioconvert ! rtpL16pay name=pay1 )");
+
+  /* slow clients are removed by default */
+  fail_unless (gst_rtsp_media_factory_get_drop_tcp_backlog (factory) == FALSE);
+
+  gst_rtsp_media_factory_set_tcp_backlog_limits (factory, GST_SECOND, 20);
+  gst_rtsp_media_factory_set_drop_tcp_backlog (factory, TRUE);
+  gst_rtsp_media_factory_get_tcp_backlog_limits (factory, &max_duration,
+      &max_size);
+  fail_unless_equals_uint64 (max_duration, GST_SECOND);
+  fail_unless_equals_int (max_size, 20);
+  fail_unless (gst_rtsp_media_factory_get_drop_tcp_backlog (factory) == TRUE);
+
+  media = gst_rtsp_media_factory_construct (factory, url);
+  fail_unless (GST_IS_RTSP_MEDIA (media));
+  gst_rtsp_media_get_tcp_backlog_limits (media, &max_duration, &max_size);
+  fail_unless_equals_uint64 (max_duration, GST_SECOND);
+  fail_unless_equals_int (max_size, 20);
+  fail_unless (gst_rtsp_media_get_drop_tcp_backlog (media) == TRUE);
+
+  fail_unless (gst_rtsp_media_n_streams (media) == 2);
+  for (i = 0; i < 2; i++) {
+    stream = gst_rtsp_media_get_stream (media, i);
+    gst_rtsp_stream_get_tcp_backlog_limits (stream, &max_duration, &max_size);
+    fail_unless_equals_uint64 (max_duration, GST_SECOND);
+    fail_unless_equals_int (max_size, 20);
+    fail_unless (gst_rtsp_stream_get_drop_tcp_backlog (stream) == TRUE);
+  }
+
+  /* changing them on the media changes them on all streams */
+  g_object_set (media, "max-tcp-backlog-duration", 2 * GST_SECOND,
+      "max-tcp-backlog-size", 30, "drop-tcp-backlog", FALSE, NULL);
+  for (i = 0; i < 2; i++) {
+    stream = gst_rtsp_media_get_stream (media, i);
+    gst_rtsp_stream_get_tcp_backlog_limits (stream, &max_duration, &max_size);
+    fail_unless_equals_uint64 (max_duration, 2 * GST_SECOND);
+    fail_unless_equals_int (max_size, 30);
+    fail_unless (gst_rtsp_stream_get_drop_tcp_backlog (stream) == FALSE);
+  }
+
+  g_object_unref (media);
+  gst_rtsp_url_free (url);
+  g_object_unref (factory);
+}
+
+GST_END_TEST;
+
+typedef struct _GopFixture GopFixture;
+
+/* A client that accepts everything, noting the first and last sequence
+ * numbers it got and whether they were contiguous */
+typedef struct
+{
+  GopFixture *fixture;
+  GstRTSPClient *client;
+  gchar *session;
+  gint packets;
+  gint first_seqnum;
+  gint last_seqnum;
+  gint gaps;
+} GopClient;
+
+/* A shared media with the GOP cache, where the packets with a sequence number
+ * that is a multiple of gop_size are the keyframes */
+struct _GopFixture
+{
+  GstRTSPSessionPool *session_pool;
+  GstRTSPMountPoints *mount_points;
+  GstRTSPThreadPool *thread_pool;
+  GstRTSPStream *stream;
+  guint gop_size;
+  GstClockTime max_duration;
+  gint cseq;
+  /* lower the backlog limits below the size of a GOP once the RTP-Info of a
+   * PLAY response was determined, i.e. while the burst of the client is
+   * pending */
+  gboolean lower_limits_on_play;
+};
+
+static GstPadProbeReturn
+mark_keyframes (GstPad * pad, GstPadProbeInfo * info, GopFixture * f)
+{
+  GstBuffer *buffer;
+  guint16 seqnum;
+
+  buffer = gst_buffer_make_writable (GST_PAD_PROBE_INFO_BUFFER (info));
+  fail_unless (gst_buffer_extract (buffer, 2, &seqnum, 2) == 2);
+  if (GUINT16_FROM_BE (seqnum) % f->gop_size == 0)
+    GST_BUFFER_FLAG_UNSET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+  else
+    GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+  GST_PAD_PROBE_INFO_DATA (info) = buffer;
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+gop_media_configure_cb (GstRTSPMediaFactory * factory, GstRTSPMedia * media,
+    GopFixture * f)
+{
+  GstElement *element, *pay;
+  GstPad *pad;
+
+  f->stream = gst_rtsp_media_get_stream (media, 0);
+
+  element = gst_rtsp_media_get_element (media);
+  pay = gst_bin_get_by_name (GST_BIN (element), "pay0");
+  pad = gst_element_get_static_pad (pay, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) mark_keyframes, f, NULL);
+  gst_object_unref (pad);
+  gst_object_unref (pay);
+  gst_object_unref (element);
+}
+
+static gboolean
+gop_client_send (GstRTSPClient * client, GstRTSPMessage * messages,
+    guint n_messages, gboolean close, gpointer user_data)
+{
+  GopClient *c = user_data;
+  guint8 *data;
+  guint size, i;
+  gchar *str;
+
+  for (i = 0; i < n_messages; i++) {
+    if (gst_rtsp_message_get_type (&messages[i]) == GST_RTSP_MESSAGE_DATA) {
+      gint seqnum, last;
+
+      fail_unless (gst_rtsp_message_get_body (&messages[i], &data,
+              &size) == GST_RTSP_OK);
+      fail_unless (size >= 12);
+      seqnum = GST_READ_UINT16_BE (data + 2);
+
+      last = g_atomic_int_get (&c->last_seqnum);
+      if (last == -1)
+        g_atomic_int_set (&c->first_seqnum, seqnum);
+      else if (seqnum != last + 1)
+        g_atomic_int_inc (&c->gaps);
+      g_atomic_int_set (&c->last_seqnum, seqnum);
+      g_atomic_int_inc (&c->packets);
+    } else if (c->session == NULL &&
+        gst_rtsp_message_get_type (&messages[i]) == GST_RTSP_MESSAGE_RESPONSE
+        && gst_rtsp_message_get_header (&messages[i], GST_RTSP_HDR_SESSION,
+            &str, 0) == GST_RTSP_OK) {
+      gchar **params = g_strsplit (str, ";", -1);
+
+      c->session = g_strdup (params[0]);
+      g_strfreev (params);
+    } else if (c->fixture->lower_limits_on_play &&
+        gst_rtsp_message_get_type (&messages[i]) == GST_RTSP_MESSAGE_RESPONSE
+        && gst_rtsp_message_get_header (&messages[i], GST_RTSP_HDR_RTP_INFO,
+            &str, 0) == GST_RTSP_OK) {
+      gst_rtsp_stream_set_tcp_backlog_limits (c->fixture->stream, 0, 5);
+    }
+  }
+
+  return TRUE;
+}
+
+static void
+gop_client_request (GopFixture * f, GopClient * c, GstRTSPMethod method,
+    const gchar * url, const gchar * transport)
+{
+  GstRTSPMessage request = { 0, };
+
+  fail_unless (gst_rtsp_message_init_request (&request, method,
+          url) == GST_RTSP_OK);
+  gst_rtsp_message_take_header (&request, GST_RTSP_HDR_CSEQ,
+      g_strdup_printf ("%d", f->cseq++));
+  if (transport)
+    gst_rtsp_message_add_header (&request, GST_RTSP_HDR_TRANSPORT, transport);
+  if (c->session)
+    gst_rtsp_message_add_header (&request, GST_RTSP_HDR_SESSION, c->session);
+  fail_unless (gst_rtsp_client_handle_message (c->client,
+          &request) == GST_RTSP_OK);
+  gst_rtsp_message_unset (&request);
+}
+
+static void
+gop_fixture_setup (GopFixture * f, guint gop_size, GstClockTime max_duration)
+{
+  GstRTSPMediaFactory *factory;
+
+  memset (f, 0, sizeof (GopFixture));
+  f->cseq = 1;
+  f->gop_size = gop_size;
+  f->max_duration = max_duration;
+
+  f->session_pool = gst_rtsp_session_pool_new ();
+  f->mount_points = gst_rtsp_mount_points_new ();
+  f->thread_pool = gst_rtsp_thread_pool_new ();
+  factory = gst_rtsp_media_factory_new ();
+  gst_rtsp_media_factory_set_launch (factory, GOP_PIPELINE);
+  gst_rtsp_media_factory_set_shared (factory, TRUE);
+  gst_rtsp_media_factory_set_enable_rtcp (factory, FALSE);
+  gst_rtsp_media_factory_set_gop_cache (factory, TRUE);
+  gst_rtsp_media_factory_set_tcp_backlog_limits (factory, max_duration, 1000);
+  g_signal_connect (factory, "media-configure",
+      G_CALLBACK (gop_media_configure_cb), f);
+  gst_rtsp_mount_points_add_factory (f->mount_points, "/test", factory);
+}
+
+static void
+gop_fixture_teardown (GopFixture * f)
+{
+  g_object_unref (f->thread_pool);
+  g_object_unref (f->mount_points);
+  g_object_unref (f->session_pool);
+}
+
+/* Sets up and plays the stream over TCP on a new client */
+static void
+gop_client_start (GopFixture * f, GopClient * c)
+{
+  GstRTSPConnection *conn;
+  GSocket *sock;
+  GError *error = NULL;
+
+  memset (c, 0, sizeof (GopClient));
+  c->fixture = f;
+  c->first_seqnum = -1;
+  c->last_seqnum = -1;
+
+  c->client = gst_rtsp_client_new ();
+  gst_rtsp_client_set_session_pool (c->client, f->session_pool);
+  gst_rtsp_client_set_mount_points (c->client, f->mount_points);
+  gst_rtsp_client_set_thread_pool (c->client, f->thread_pool);
+  sock = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_STREAM,
+      G_SOCKET_PROTOCOL_TCP, &error);
+  g_assert_no_error (error);
+  fail_unless (gst_rtsp_connection_create_from_socket (sock, "127.0.0.1",
+          444, NULL, &conn) == GST_RTSP_OK);
+  g_object_unref (sock);
+  fail_unless (gst_rtsp_client_set_connection (c->client, conn));
+  gst_rtsp_client_set_send_messages_func (c->client, gop_client_send, c,
+      NULL);
+
+  gop_client_request (f, c, GST_RTSP_SETUP, "rtsp://localhost/test/stream=0",
+      "RTP/AVP/TCP;unicast");
+  fail_unless (c->session != NULL);
+  gop_client_request (f, c, GST_RTSP_PLAY, "rtsp://localhost/test", NULL);
+}
+
+static void
+gop_client_stop (GopFixture * f, GopClient * c)
+{
+  gop_client_request (f, c, GST_RTSP_TEARDOWN, "rtsp://localhost/test", NULL);
+  gst_rtsp_client_set_thread_pool (c->client, NULL);
+  g_object_unref (c->client);
+  g_free (c->session);
+}
+
+static void
+gop_client_wait_packets (GopClient * c, gint packets)
+{
+  gint i;
+
+  for (i = 0; i < 500; i++) {
+    if (g_atomic_int_get (&c->packets) >= packets)
+      return;
+    g_usleep (10 * 1000);
+  }
+  fail ("only %d packets", g_atomic_int_get (&c->packets));
+}
+
+/* A new TCP client first gets the cached packets from the last keyframe on,
+ * then the live ones without a gap or a duplicate */
+GST_START_TEST (test_gop_cache_burst)
+{
+  GopFixture f;
+  GopClient first, second;
+  gint last_seqnum, first_seqnum;
+
+  gop_fixture_setup (&f, 50, 10 * GST_SECOND);
+
+  gop_client_start (&f, &first);
+  /* in the middle of the third GOP */
+  gop_client_wait_packets (&first, 125);
+  last_seqnum = g_atomic_int_get (&first.last_seqnum);
+
+  gop_client_start (&f, &second);
+  gop_client_wait_packets (&second, 100);
+
+  first_seqnum = g_atomic_int_get (&second.first_seqnum);
+  /* the cache was reset at the keyframes, it holds the last GOP only */
+  fail_unless_equals_int (first_seqnum % 50, 0);
+  fail_unless (first_seqnum >= 100, "burst starts at %d", first_seqnum);
+  fail_unless (first_seqnum <= last_seqnum, "burst starts at %d after %d",
+      first_seqnum, last_seqnum);
+  fail_unless_equals_int (g_atomic_int_get (&second.gaps), 0);
+  fail_unless_equals_int (g_atomic_int_get (&first.gaps), 0);
+
+  gop_client_stop (&f, &second);
+  gop_client_stop (&f, &first);
+  gop_fixture_teardown (&f);
+}
+
+GST_END_TEST;
+
+/* A GOP longer than the TCP backlog is not cached, a new client would be
+ * dropped right away as too slow, so it starts with the live packets */
+GST_START_TEST (test_gop_cache_too_long)
+{
+  GopFixture f;
+  GopClient first, second;
+  gint last_seqnum, first_seqnum;
+
+  gop_fixture_setup (&f, 50, 100 * GST_MSECOND);
+
+  gop_client_start (&f, &first);
+  gop_client_wait_packets (&first, 125);
+  last_seqnum = g_atomic_int_get (&first.last_seqnum);
+
+  gop_client_start (&f, &second);
+  gop_client_wait_packets (&second, 20);
+
+  /* a burst would start at the keyframe 100, at least 25 packets back */
+  first_seqnum = g_atomic_int_get (&second.first_seqnum);
+  fail_unless (first_seqnum > last_seqnum - 10, "started at %d after %d",
+      first_seqnum, last_seqnum);
+  fail_unless_equals_int (g_atomic_int_get (&second.gaps), 0);
+
+  gop_client_stop (&f, &second);
+  gop_client_stop (&f, &first);
+  gop_fixture_teardown (&f);
+}
+
+GST_END_TEST;
+
+/* A client whose burst does not fit in the backlog limits lowered while it
+ * was pending is removed without its burst being sent */
+GST_START_TEST (test_gop_cache_lower_limits)
+{
+  GopFixture f;
+  GopClient first, second;
+  gint last_seqnum, first_seqnum, packets;
+
+  gop_fixture_setup (&f, 50, 10 * GST_SECOND);
+
+  gop_client_start (&f, &first);
+  gop_client_wait_packets (&first, 125);
+  last_seqnum = g_atomic_int_get (&first.last_seqnum);
+
+  f.lower_limits_on_play = TRUE;
+  gop_client_start (&f, &second);
+  packets = g_atomic_int_get (&first.packets);
+  gop_client_wait_packets (&first, packets + 50);
+
+  /* no cached packet was sent, the keyframe 100 is at least 25 packets
+   * back */
+  first_seqnum = g_atomic_int_get (&second.first_seqnum);
+  fail_unless (first_seqnum == -1 || first_seqnum > last_seqnum - 10,
+      "started at %d after %d", first_seqnum, last_seqnum);
+  fail_unless_equals_int (g_atomic_int_get (&first.gaps), 0);
+
+  gop_client_stop (&f, &second);
+  gop_client_stop (&f, &first);
+  gop_fixture_teardown (&f);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtspmediafactory_suite (void)
 {
@@ -437,6 +866,11 @@ rtspmediafactory_suite (void)
   tcase_add_test (tc, test_reset);
   tcase_add_test (tc, test_mcast_ttl);
   tcase_add_test (tc, test_allow_bind_mcast);
+  tcase_add_test (tc, test_gop_cache);
+  tcase_add_test (tc, test_tcp_backlog);
+  tcase_add_test (tc, test_gop_cache_burst);
+  tcase_add_test (tc, test_gop_cache_too_long);
+  tcase_add_test (tc, test_gop_cache_lower_limits);
 
   return s;
 }
@@ -18,9 +18,16 @@
  */
 
 #include <gst/check/gstcheck.h>
+#include <gio/gnetworking.h>
 
 #include <rtsp-stream.h>
 #include <rtsp-address-pool.h>
+#include <rtsp-client.h>
+
+/* live and with packets of the same size, 100 per second */
+#define LIVE_AUDIO_PIPELINE "( audiotestsrc is-live=true " \
+  "samplesperbuffer=480 ! audio/x-raw,rate=48000,channels=1 ! " \
+  "rtpL16pay name=pay0 pt=96 )"
 
 static void
 get_sockets (GstRTSPLowerTrans lower_transport, GSocketFamily socket_family)
@@ -498,6 +505,42 @@ GST_START_TEST (test_tcp_transport)
 
 GST_END_TEST;
 
+GST_START_TEST (test_tcp_backlog_limits)
+{
+  GstPad *srcpad;
+  GstElement *pay;
+  GstRTSPStream *stream;
+  GstClockTime max_duration;
+  guint max_size;
+
+  srcpad = gst_pad_new ("testsrcpad", GST_PAD_SRC);
+  fail_unless (srcpad != NULL);
+  pay = gst_element_factory_make ("rtpgstpay", "testpayloader");
+  fail_unless (pay != NULL);
+  stream = gst_rtsp_stream_new (0, pay, srcpad);
+  fail_unless (stream != NULL);
+  gst_object_unref (pay);
+  gst_object_unref (srcpad);
+
+  gst_rtsp_stream_get_tcp_backlog_limits (stream, &max_duration, &max_size);
+  fail_unless_equals_uint64 (max_duration, 10 * GST_SECOND);
+  fail_unless_equals_int (max_size, 100);
+  fail_if (gst_rtsp_stream_get_drop_tcp_backlog (stream));
+
+  gst_rtsp_stream_set_tcp_backlog_limits (stream, 2 * GST_SECOND, 20);
+  gst_rtsp_stream_set_drop_tcp_backlog (stream, TRUE);
+
+  gst_rtsp_stream_get_tcp_backlog_limits (stream, &max_duration, NULL);
+  fail_unless_equals_uint64 (max_duration, 2 * GST_SECOND);
+  gst_rtsp_stream_get_tcp_backlog_limits (stream, NULL, &max_size);
+  fail_unless_equals_int (max_size, 20);
+  fail_unless (gst_rtsp_stream_get_drop_tcp_backlog (stream));
+
+  gst_object_unref (stream);
+}
+
+GST_END_TEST;
+
 static void
 check_multicast_client_address (const gchar * destination, guint port,
     const gchar * expected_addr_str, gboolean expected_res)
@@ -653,6 +696,428 @@ GST_START_TEST (test_remove_transport_twice)
 
 GST_END_TEST;
 
+/* Two TCP clients on a shared live media: a slow one, connected to a peer
+ * that only reads when the test does, and one that always keeps up, so that
+ * the stream keeps pulling samples while the slow one is backlogged */
+typedef struct
+{
+  GstRTSPClient *client;
+  GstRTSPClient *fast_client;
+  GstRTSPConnection *peer_conn;
+  GSocket *server_sock;
+  GSocket *peer_sock;
+  GMainContext *context;
+  GMainLoop *loop;
+  GThread *thread;
+  gchar *session;
+  gchar *fast_session;
+  gint fast_packets;
+  gint cseq;
+
+  GstClockTime max_duration;
+  guint max_size;
+  gboolean drop;
+} TcpFixture;
+
+static gpointer
+run_loop (GMainLoop * loop)
+{
+  g_main_loop_run (loop);
+
+  return NULL;
+}
+
+static void
+media_configure_cb (GstRTSPMediaFactory * factory, GstRTSPMedia * media,
+    TcpFixture * f)
+{
+  GstRTSPStream *stream = gst_rtsp_media_get_stream (media, 0);
+
+  gst_rtsp_stream_set_tcp_backlog_limits (stream, f->max_duration,
+      f->max_size);
+  gst_rtsp_stream_set_drop_tcp_backlog (stream, f->drop);
+}
+
+static gboolean
+accept_messages (GstRTSPClient * client, GstRTSPMessage * messages,
+    guint n_messages, gboolean close, gpointer user_data)
+{
+  TcpFixture *f = user_data;
+  gchar *str;
+  guint i;
+
+  for (i = 0; i < n_messages; i++) {
+    if (gst_rtsp_message_get_type (&messages[i]) == GST_RTSP_MESSAGE_DATA) {
+      g_atomic_int_inc (&f->fast_packets);
+    } else if (f->fast_session == NULL &&
+        gst_rtsp_message_get_type (&messages[i]) == GST_RTSP_MESSAGE_RESPONSE
+        && gst_rtsp_message_get_header (&messages[i], GST_RTSP_HDR_SESSION,
+            &str, 0) == GST_RTSP_OK) {
+      gchar **params = g_strsplit (str, ";", -1);
+
+      f->fast_session = g_strdup (params[0]);
+      g_strfreev (params);
+    }
+  }
+
+  return TRUE;
+}
+
+static void
+fast_request (TcpFixture * f, GstRTSPMethod method, const gchar * url,
+    const gchar * transport)
+{
+  GstRTSPMessage request = { 0, };
+
+  fail_unless (gst_rtsp_message_init_request (&request, method,
+          url) == GST_RTSP_OK);
+  gst_rtsp_message_take_header (&request, GST_RTSP_HDR_CSEQ,
+      g_strdup_printf ("%d", f->cseq++));
+  if (transport)
+    gst_rtsp_message_add_header (&request, GST_RTSP_HDR_TRANSPORT, transport);
+  if (f->fast_session)
+    gst_rtsp_message_add_header (&request, GST_RTSP_HDR_SESSION,
+        f->fast_session);
+  fail_unless (gst_rtsp_client_handle_message (f->fast_client,
+          &request) == GST_RTSP_OK);
+  gst_rtsp_message_unset (&request);
+}
+
+/* Sends a request from the peer of the slow client and waits for the
+ * response, skipping the interleaved data that arrives in between */
+static void
+peer_request (TcpFixture * f, GstRTSPMethod method, const gchar * url,
+    const gchar * transport)
+{
+  GstRTSPMessage request = { 0, };
+  GstRTSPMessage response = { 0, };
+  GstRTSPStatusCode code;
+  gchar *str;
+
+  fail_unless (gst_rtsp_message_init_request (&request, method,
+          url) == GST_RTSP_OK);
+  gst_rtsp_message_take_header (&request, GST_RTSP_HDR_CSEQ,
+      g_strdup_printf ("%d", f->cseq++));
+  if (transport)
+    gst_rtsp_message_add_header (&request, GST_RTSP_HDR_TRANSPORT, transport);
+  if (f->session)
+    gst_rtsp_message_add_header (&request, GST_RTSP_HDR_SESSION, f->session);
+  fail_unless (gst_rtsp_connection_send_usec (f->peer_conn, &request,
+          5 * G_USEC_PER_SEC) == GST_RTSP_OK);
+  gst_rtsp_message_unset (&request);
+
+  do {
+    gst_rtsp_message_unset (&response);
+    fail_unless (gst_rtsp_connection_receive_usec (f->peer_conn, &response,
+            5 * G_USEC_PER_SEC) == GST_RTSP_OK);
+  } while (gst_rtsp_message_get_type (&response) != GST_RTSP_MESSAGE_RESPONSE);
+
+  fail_unless (gst_rtsp_message_parse_response (&response, &code, NULL,
+          NULL) == GST_RTSP_OK);
+  fail_unless_equals_int (code, GST_RTSP_STS_OK);
+
+  if (f->session == NULL) {
+    gchar **params;
+
+    fail_unless (gst_rtsp_message_get_header (&response, GST_RTSP_HDR_SESSION,
+            &str, 0) == GST_RTSP_OK);
+    params = g_strsplit (str, ";", -1);
+    f->session = g_strdup (params[0]);
+    g_strfreev (params);
+  }
+  gst_rtsp_message_unset (&response);
+}
+
+/* Reads the next RTP packet for the slow client, returns %FALSE if none
+ * arrives within @timeout */
+static gboolean
+peer_read_packet (TcpFixture * f, gint64 timeout, guint16 * seqnum)
+{
+  GstRTSPMessage message = { 0, };
+  GstRTSPResult res;
+  guint8 *data;
+  guint size;
+
+  do {
+    gst_rtsp_message_unset (&message);
+    res = gst_rtsp_connection_receive_usec (f->peer_conn, &message, timeout);
+    if (res == GST_RTSP_ETIMEOUT)
+      return FALSE;
+    fail_unless_equals_int (res, GST_RTSP_OK);
+  } while (gst_rtsp_message_get_type (&message) != GST_RTSP_MESSAGE_DATA);
+
+  fail_unless (gst_rtsp_message_get_body (&message, &data,
+          &size) == GST_RTSP_OK);
+  fail_unless (size >= 12);
+  *seqnum = GST_READ_UINT16_BE (data + 2);
+  gst_rtsp_message_unset (&message);
+
+  return TRUE;
+}
+
+static guint64
+get_client_stat (GstRTSPClient * client, const gchar * name)
+{
+  GstStructure *stats;
+  guint64 value = 0;
+
+  stats = gst_rtsp_client_get_stats (client);
+  fail_unless (gst_structure_get_uint64 (stats, name, &value));
+  gst_structure_free (stats);
+
+  return value;
+}
+
+/* Creates a connected pair of TCP sockets with small buffers, so that the
+ * server side stops being writable after a few packets */
+static void
+create_socket_pair (GSocket ** server, GSocket ** peer)
+{
+  GSocket *listener;
+  GInetAddress *inet_addr;
+  GSocketAddress *addr, *bound_addr;
+  GError *error = NULL;
+
+  listener = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_STREAM,
+      G_SOCKET_PROTOCOL_TCP, &error);
+  g_assert_no_error (error);
+  inet_addr = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+  addr = g_inet_socket_address_new (inet_addr, 0);
+  fail_unless (g_socket_bind (listener, addr, TRUE, &error));
+  fail_unless (g_socket_listen (listener, &error));
+  bound_addr = g_socket_get_local_address (listener, &error);
+  g_assert_no_error (error);
+
+  *peer = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_STREAM,
+      G_SOCKET_PROTOCOL_TCP, &error);
+  g_assert_no_error (error);
+  fail_unless (g_socket_set_option (*peer, SOL_SOCKET, SO_RCVBUF, 4096,
+          &error));
+  fail_unless (g_socket_connect (*peer, bound_addr, NULL, &error));
+
+  *server = g_socket_accept (listener, NULL, &error);
+  g_assert_no_error (error);
+  fail_unless (g_socket_set_option (*server, SOL_SOCKET, SO_SNDBUF, 4096,
+          &error));
+
+  g_object_unref (bound_addr);
+  g_object_unref (addr);
+  g_object_unref (inet_addr);
+  g_object_unref (listener);
+}
+
+static void
+tcp_fixture_setup (TcpFixture * f, GstClockTime max_duration, guint max_size,
+    gboolean drop)
+{
+  GstRTSPSessionPool *session_pool;
+  GstRTSPMountPoints *mount_points;
+  GstRTSPMediaFactory *factory;
+  GstRTSPThreadPool *thread_pool;
+  GstRTSPConnection *conn;
+  GSocket *sock;
+  GError *error = NULL;
+
+  memset (f, 0, sizeof (TcpFixture));
+  f->cseq = 1;
+  f->max_duration = max_duration;
+  f->max_size = max_size;
+  f->drop = drop;
+
+  session_pool = gst_rtsp_session_pool_new ();
+  mount_points = gst_rtsp_mount_points_new ();
+  thread_pool = gst_rtsp_thread_pool_new ();
+  factory = gst_rtsp_media_factory_new ();
+  gst_rtsp_media_factory_set_launch (factory, LIVE_AUDIO_PIPELINE);
+  gst_rtsp_media_factory_set_shared (factory, TRUE);
+  gst_rtsp_media_factory_set_enable_rtcp (factory, FALSE);
+  g_signal_connect (factory, "media-configure",
+      G_CALLBACK (media_configure_cb), f);
+  gst_rtsp_mount_points_add_factory (mount_points, "/test", factory);
+
+  f->client = gst_rtsp_client_new ();
+  gst_rtsp_client_set_session_pool (f->client, session_pool);
+  gst_rtsp_client_set_mount_points (f->client, mount_points);
+  gst_rtsp_client_set_thread_pool (f->client, thread_pool);
+  create_socket_pair (&f->server_sock, &f->peer_sock);
+  fail_unless (gst_rtsp_connection_create_from_socket (f->server_sock,
+          "127.0.0.1", 554, NULL, &conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_client_set_connection (f->client, conn));
+  fail_unless (gst_rtsp_connection_create_from_socket (f->peer_sock,
+          "127.0.0.1", 554, NULL, &f->peer_conn) == GST_RTSP_OK);
+
+  f->context = g_main_context_new ();
+  f->loop = g_main_loop_new (f->context, FALSE);
+  fail_unless (gst_rtsp_client_attach (f->client, f->context) != 0);
+  f->thread = g_thread_new ("client-context", (GThreadFunc) run_loop,
+      f->loop);
+
+  f->fast_client = gst_rtsp_client_new ();
+  gst_rtsp_client_set_session_pool (f->fast_client, session_pool);
+  gst_rtsp_client_set_mount_points (f->fast_client, mount_points);
+  gst_rtsp_client_set_thread_pool (f->fast_client, thread_pool);
+  sock = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_STREAM,
+      G_SOCKET_PROTOCOL_TCP, &error);
+  g_assert_no_error (error);
+  fail_unless (gst_rtsp_connection_create_from_socket (sock, "127.0.0.1",
+          444, NULL, &conn) == GST_RTSP_OK);
+  g_object_unref (sock);
+  fail_unless (gst_rtsp_client_set_connection (f->fast_client, conn));
+  gst_rtsp_client_set_send_messages_func (f->fast_client, accept_messages, f,
+      NULL);
+
+  g_object_unref (thread_pool);
+  g_object_unref (mount_points);
+  g_object_unref (session_pool);
+
+  peer_request (f, GST_RTSP_SETUP, "rtsp://localhost/test/stream=0",
+      "RTP/AVP/TCP;unicast;interleaved=0-1");
+  peer_request (f, GST_RTSP_PLAY, "rtsp://localhost/test", NULL);
+
+  fast_request (f, GST_RTSP_SETUP, "rtsp://localhost/test/stream=0",
+      "RTP/AVP/TCP;unicast");
+  fail_unless (f->fast_session != NULL);
+  fast_request (f, GST_RTSP_PLAY, "rtsp://localhost/test", NULL);
+}
+
+static void
+tcp_fixture_teardown (TcpFixture * f)
+{
+  fast_request (f, GST_RTSP_TEARDOWN, "rtsp://localhost/test", NULL);
+  peer_request (f, GST_RTSP_TEARDOWN, "rtsp://localhost/test", NULL);
+
+  gst_rtsp_client_close (f->client);
+  g_main_loop_quit (f->loop);
+  g_thread_join (f->thread);
+  g_main_loop_unref (f->loop);
+  g_main_context_unref (f->context);
+
+  gst_rtsp_connection_free (f->peer_conn);
+  g_object_unref (f->peer_sock);
+  g_object_unref (f->server_sock);
+  gst_rtsp_client_set_thread_pool (f->fast_client, NULL);
+  gst_rtsp_client_set_thread_pool (f->client, NULL);
+  g_object_unref (f->fast_client);
+  g_object_unref (f->client);
+  g_free (f->fast_session);
+  g_free (f->session);
+}
+
+/* Stops reading for the slow client until its connection holds back a data
+ * message, then for @stall_ms more */
+static void
+stall_slow_client (TcpFixture * f, guint stall_ms)
+{
+  gint i;
+
+  for (i = 0; i < 500; i++) {
+    if (get_client_stat (f->client, "backlog-bytes") > 0)
+      break;
+    g_usleep (10 * 1000);
+  }
+  fail_unless (get_client_stat (f->client, "backlog-bytes") > 0);
+
+  g_usleep (stall_ms * 1000);
+}
+
+/* A client that keeps up is served while another one is backlogged */
+GST_START_TEST (test_tcp_idle_transport_not_held_back)
+{
+  TcpFixture f;
+  gint before, after;
+
+  tcp_fixture_setup (&f, 10 * GST_SECOND, 100, FALSE);
+
+  stall_slow_client (&f, 0);
+  before = g_atomic_int_get (&f.fast_packets);
+  g_usleep (500 * 1000);
+  after = g_atomic_int_get (&f.fast_packets);
+
+  /* 50 packets were produced meanwhile */
+  fail_unless (after - before >= 25, "only %d packets in 500ms",
+      after - before);
+
+  tcp_fixture_teardown (&f);
+}
+
+GST_END_TEST;
+
+/* Nothing is popped from the backlog while the connection still holds back
+ * the previous message, so a slow client gets every packet in order */
+GST_START_TEST (test_tcp_backlog_no_loss)
+{
+  TcpFixture f;
+  guint16 seqnum, prev_seqnum;
+  gint i;
+
+  tcp_fixture_setup (&f, 10 * GST_SECOND, 100, FALSE);
+
+  fail_unless (peer_read_packet (&f, 5 * G_USEC_PER_SEC, &prev_seqnum));
+  stall_slow_client (&f, 300);
+
+  for (i = 0; i < 150; i++) {
+    fail_unless (peer_read_packet (&f, 5 * G_USEC_PER_SEC, &seqnum));
+    fail_unless_equals_int (seqnum, (guint16) (prev_seqnum + 1));
+    prev_seqnum = seqnum;
+  }
+  fail_unless_equals_uint64 (get_client_stat (f.client, "dropped-messages"),
+      0);
+
+  tcp_fixture_teardown (&f);
+}
+
+GST_END_TEST;
+
+/* With drop-tcp-backlog, a client that is too slow loses its oldest packets
+ * but keeps its transport */
+GST_START_TEST (test_tcp_backlog_drop_oldest)
+{
+  TcpFixture f;
+  guint16 seqnum, prev_seqnum;
+  gboolean have_gap = FALSE;
+  gint i;
+
+  tcp_fixture_setup (&f, 100 * GST_MSECOND, 5, TRUE);
+
+  fail_unless (peer_read_packet (&f, 5 * G_USEC_PER_SEC, &prev_seqnum));
+  stall_slow_client (&f, 500);
+
+  for (i = 0; i < 150; i++) {
+    fail_unless (peer_read_packet (&f, 5 * G_USEC_PER_SEC, &seqnum));
+    if (seqnum != (guint16) (prev_seqnum + 1))
+      have_gap = TRUE;
+    prev_seqnum = seqnum;
+  }
+  fail_unless (have_gap);
+
+  tcp_fixture_teardown (&f);
+}
+
+GST_END_TEST;
+
+/* Without drop-tcp-backlog, a client that is too slow loses its transport */
+GST_START_TEST (test_tcp_backlog_remove_slow)
+{
+  TcpFixture f;
+  guint16 seqnum;
+  gint i;
+
+  tcp_fixture_setup (&f, 100 * GST_MSECOND, 5, FALSE);
+
+  stall_slow_client (&f, 500);
+
+  /* whatever was queued before still arrives, then nothing */
+  for (i = 0; i < 500; i++) {
+    if (!peer_read_packet (&f, G_USEC_PER_SEC, &seqnum))
+      break;
+  }
+  fail_unless (i < 500);
+
+  tcp_fixture_teardown (&f);
+}
+
+GST_END_TEST;
+
 static gboolean
 is_ipv6_supported (void)
 {
@@ -695,10 +1160,15 @@ rtspstream_suite (void)
   tcase_add_test (tc, test_allocate_udp_ports_multicast);
   tcase_add_test (tc, test_allocate_udp_ports_client_settings);
   tcase_add_test (tc, test_tcp_transport);
+  tcase_add_test (tc, test_tcp_backlog_limits);
   tcase_add_test (tc, test_multicast_client_address);
   tcase_add_test (tc, test_multicast_client_address_invalid);
   tcase_add_test (tc, test_add_transport_twice);
   tcase_add_test (tc, test_remove_transport_twice);
+  tcase_add_test (tc, test_tcp_idle_transport_not_held_back);
+  tcase_add_test (tc, test_tcp_backlog_no_loss);
+  tcase_add_test (tc, test_tcp_backlog_drop_oldest);
+  tcase_add_test (tc, test_tcp_backlog_remove_slow);
 
   return s;
 }
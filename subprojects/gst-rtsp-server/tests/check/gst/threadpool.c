@@ -189,6 +189,54 @@ GST_START_TEST (test_pool_max_threads_property)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pool_least_used_thread)
+{
+  GstRTSPThreadPool *pool;
+  GstRTSPThread *thread1;
+  GstRTSPThread *thread2;
+  GstRTSPThread *thread3;
+  GstRTSPThread *thread4;
+  GstRTSPThread *thread5;
+
+  pool = gst_rtsp_thread_pool_new ();
+  fail_unless (GST_IS_RTSP_THREAD_POOL (pool));
+
+  gst_rtsp_thread_pool_set_max_threads (pool, 2);
+
+  thread1 = gst_rtsp_thread_pool_get_thread (pool, GST_RTSP_THREAD_TYPE_CLIENT,
+      NULL);
+  thread2 = gst_rtsp_thread_pool_get_thread (pool, GST_RTSP_THREAD_TYPE_CLIENT,
+      NULL);
+  fail_unless (thread1 != thread2);
+
+  /* both threads are used once, the first one is picked */
+  thread3 = gst_rtsp_thread_pool_get_thread (pool, GST_RTSP_THREAD_TYPE_CLIENT,
+      NULL);
+  fail_unless (thread3 == thread1);
+
+  /* the second thread is used less now */
+  thread4 = gst_rtsp_thread_pool_get_thread (pool, GST_RTSP_THREAD_TYPE_CLIENT,
+      NULL);
+  fail_unless (thread4 == thread2);
+
+  /* after this the second thread serves one client and the first one two */
+  gst_rtsp_thread_stop (thread4);
+
+  thread5 = gst_rtsp_thread_pool_get_thread (pool, GST_RTSP_THREAD_TYPE_CLIENT,
+      NULL);
+  fail_unless (thread5 == thread2);
+
+  gst_rtsp_thread_stop (thread1);
+  gst_rtsp_thread_stop (thread2);
+  gst_rtsp_thread_stop (thread3);
+  gst_rtsp_thread_stop (thread5);
+  g_object_unref (pool);
+
+  gst_rtsp_thread_pool_cleanup ();
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_pool_thread_copy)
 {
   GstRTSPThreadPool *pool;
@@ -228,6 +276,7 @@ rtspthreadpool_suite (void)
   tcase_add_test (tc, test_pool_get_thread_reuse);
   tcase_add_test (tc, test_pool_max_threads);
   tcase_add_test (tc, test_pool_max_threads_property);
+  tcase_add_test (tc, test_pool_least_used_thread);
   tcase_add_test (tc, test_pool_thread_copy);
 
   return s;